@@ -18,6 +18,7 @@
 #include "bolt/Core/Relocation.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/CodeGen/TargetOpcodes.h"
 #include "llvm/MC/MCAsmBackend.h"
@@ -68,7 +69,10 @@ private:
   /// A struct that represents a single annotation allocator
   struct AnnotationAllocator {
     BumpPtrAllocator ValueAllocator;
-    std::unordered_set<MCPlus::MCAnnotation *> AnnotationPool;
+    /// Non-trivial annotations that need their destructor run when the
+    /// allocator is reset. Each annotation is added exactly once, so a vector
+    /// avoids the per-node overhead of a hash set.
+    SmallVector<MCPlus::MCAnnotation *, 0> AnnotationPool;
   };
 
   /// A set of annotation allocators
@@ -501,10 +505,12 @@ public:
     return 0;
   }
 
-  /// Create increment contents of target by 1 for Instrumentation
+  /// Create increment contents of target by 1 for Instrumentation. If
+  /// \p Atomic is false, the target may use a cheaper non-atomic increment
+  /// that can lose updates when several threads hit the same counter.
   virtual InstructionListType
   createInstrIncMemory(const MCSymbol *Target, MCContext *Ctx, bool IsLeaf,
-                       unsigned CodePointerSize) const {
+                       unsigned CodePointerSize, bool Atomic) const {
     llvm_unreachable("not implemented");
     return InstructionListType();
   }
@@ -1833,7 +1839,7 @@ public:
         MCPlus::MCSimpleAnnotation<ValueType>(Val);
 
     if (!std::is_trivial<ValueType>::value)
-      Allocator.AnnotationPool.insert(A);
+      Allocator.AnnotationPool.push_back(A);
     setAnnotationOpValue(Inst, Index, reinterpret_cast<int64_t>(A));
     return A->getValue();
   }
@@ -35,6 +35,11 @@ private:
   sortedByFunc(BinaryContext &BC, const BinarySection &Section,
                std::map<uint64_t, BinaryFunction> &BFs) const;
 
+  /// Cluster symbols that are accessed by the same hot functions.
+  std::pair<DataOrder, unsigned>
+  sortedByAffinity(BinaryContext &BC, const BinarySection &Section,
+                   std::map<uint64_t, BinaryFunction> &BFs) const;
+
   void printOrder(BinaryContext &BC, const BinarySection &Section,
                   DataOrder::const_iterator Begin,
                   DataOrder::const_iterator End) const;
@@ -17,6 +17,7 @@
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include <mutex>
+#include <vector>
 
 #define DEBUG_TYPE "par-utils"
 
@@ -51,7 +52,7 @@ namespace {
 /// A single thread pool that is used to run parallel tasks
 std::unique_ptr<DefaultThreadPool> ThreadPoolPtr;
 
-unsigned computeCostFor(const BinaryFunction &BF,
+uint64_t computeCostFor(const BinaryFunction &BF,
                         const PredicateTy &SkipPredicate,
                         const SchedulingPolicy &SchedPolicy) {
   if (SchedPolicy == SchedulingPolicy::SP_TRIVIAL)
@@ -66,23 +67,23 @@ unsigned computeCostFor(const BinaryFunction &BF,
   case SchedulingPolicy::SP_INST_LINEAR:
     return BF.getSize();
   case SchedulingPolicy::SP_INST_QUADRATIC:
-    return BF.getSize() * BF.getSize();
+    return static_cast<uint64_t>(BF.getSize()) * BF.getSize();
   case SchedulingPolicy::SP_BB_LINEAR:
     return BF.size();
   case SchedulingPolicy::SP_BB_QUADRATIC:
-    return BF.size() * BF.size();
+    return static_cast<uint64_t>(BF.size()) * BF.size();
   default:
     llvm_unreachable("unsupported scheduling policy");
   }
 }
 
-inline unsigned estimateTotalCost(const BinaryContext &BC,
+inline uint64_t estimateTotalCost(const BinaryContext &BC,
                                   const PredicateTy &SkipPredicate,
                                   SchedulingPolicy &SchedPolicy) {
   if (SchedPolicy == SchedulingPolicy::SP_TRIVIAL)
     return BC.getBinaryFunctions().size();
 
-  unsigned TotalCost = 0;
+  uint64_t TotalCost = 0;
   for (auto &BFI : BC.getBinaryFunctions()) {
     const BinaryFunction &BF = BFI.second;
     TotalCost += computeCostFor(BF, SkipPredicate, SchedPolicy);
@@ -100,6 +101,58 @@ inline unsigned estimateTotalCost(const BinaryContext &BC,
   return TotalCost;
 }
 
+using FunctionIterator = std::map<uint64_t, BinaryFunction>::iterator;
+
+/// A contiguous range of functions that is processed by a single task.
+struct Block {
+  FunctionIterator Begin;
+  FunctionIterator End;
+  uint64_t Cost;
+};
+
+/// Divide the functions into blocks of roughly equal estimated cost. A
+/// function that alone reaches the block cost gets a block of its own. The
+/// blocks are returned most expensive first: the thread pool starts tasks in
+/// the order they are submitted, so this starts the largest functions early
+/// instead of leaving one of them running after everything else is done.
+std::vector<Block> divideIntoBlocks(BinaryContext &BC,
+                                    const PredicateTy &SkipPredicate,
+                                    SchedulingPolicy SchedPolicy,
+                                    unsigned TasksPerThread) {
+  // Estimate the overall runtime cost using the scheduling policy
+  const uint64_t TotalCost = estimateTotalCost(BC, SkipPredicate, SchedPolicy);
+  const uint64_t BlocksCount = TasksPerThread * opts::ThreadCount;
+  const uint64_t BlockCost =
+      TotalCost > BlocksCount ? TotalCost / BlocksCount : 1;
+
+  std::vector<Block> Blocks;
+  FunctionIterator BlockBegin = BC.getBinaryFunctions().begin();
+  uint64_t CurrentCost = 0;
+  for (auto It = BC.getBinaryFunctions().begin();
+       It != BC.getBinaryFunctions().end(); ++It) {
+    const uint64_t Cost =
+        computeCostFor(It->second, SkipPredicate, SchedPolicy);
+    if (Cost >= BlockCost && CurrentCost) {
+      Blocks.push_back({BlockBegin, It, CurrentCost});
+      BlockBegin = It;
+      CurrentCost = 0;
+    }
+    CurrentCost += Cost;
+
+    if (CurrentCost >= BlockCost) {
+      Blocks.push_back({BlockBegin, std::next(It), CurrentCost});
+      BlockBegin = std::next(It);
+      CurrentCost = 0;
+    }
+  }
+  Blocks.push_back({BlockBegin, BC.getBinaryFunctions().end(), CurrentCost});
+
+  llvm::stable_sort(Blocks, [](const Block &A, const Block &B) {
+    return A.Cost > B.Cost;
+  });
+  return Blocks;
+}
+
 } // namespace
 
 ThreadPoolInterface &getThreadPool() {
@@ -138,29 +191,11 @@ void runOnEachFunction(BinaryContext &BC, SchedulingPolicy SchedPolicy,
     return;
   }
 
-  // Estimate the overall runtime cost using the scheduling policy
-  const unsigned TotalCost = estimateTotalCost(BC, SkipPredicate, SchedPolicy);
-  const unsigned BlocksCount = TasksPerThread * opts::ThreadCount;
-  const unsigned BlockCost =
-      TotalCost > BlocksCount ? TotalCost / BlocksCount : 1;
-
   // Divide work into blocks of equal cost
   ThreadPoolInterface &Pool = getThreadPool();
-  auto BlockBegin = BC.getBinaryFunctions().begin();
-  unsigned CurrentCost = 0;
-
-  for (auto It = BC.getBinaryFunctions().begin();
-       It != BC.getBinaryFunctions().end(); ++It) {
-    BinaryFunction &BF = It->second;
-    CurrentCost += computeCostFor(BF, SkipPredicate, SchedPolicy);
-
-    if (CurrentCost >= BlockCost) {
-      Pool.async(runBlock, BlockBegin, std::next(It));
-      BlockBegin = std::next(It);
-      CurrentCost = 0;
-    }
-  }
-  Pool.async(runBlock, BlockBegin, BC.getBinaryFunctions().end());
+  for (const Block &B :
+       divideIntoBlocks(BC, SkipPredicate, SchedPolicy, TasksPerThread))
+    Pool.async(runBlock, B.Begin, B.End);
   Pool.wait();
 }
 
@@ -207,33 +242,14 @@ void runOnEachFunctionWithUniqueAllocId(
   // This lock is used to postpone task execution
   std::unique_lock<llvm::sys::RWMutex> Lock(MainLock);
 
-  // Estimate the overall runtime cost using the scheduling policy
-  const unsigned TotalCost = estimateTotalCost(BC, SkipPredicate, SchedPolicy);
-  const unsigned BlocksCount = TasksPerThread * opts::ThreadCount;
-  const unsigned BlockCost =
-      TotalCost > BlocksCount ? TotalCost / BlocksCount : 1;
-
   // Divide work into blocks of equal cost
   ThreadPoolInterface &Pool = getThreadPool();
-  auto BlockBegin = BC.getBinaryFunctions().begin();
-  unsigned CurrentCost = 0;
-  for (auto It = BC.getBinaryFunctions().begin();
-       It != BC.getBinaryFunctions().end(); ++It) {
-    BinaryFunction &BF = It->second;
-    CurrentCost += computeCostFor(BF, SkipPredicate, SchedPolicy);
-
-    if (CurrentCost >= BlockCost) {
-      EnsureAllocatorExists(AllocId);
-      Pool.async(runBlock, BlockBegin, std::next(It), AllocId);
-      AllocId++;
-      BlockBegin = std::next(It);
-      CurrentCost = 0;
-    }
+  for (const Block &B :
+       divideIntoBlocks(BC, SkipPredicate, SchedPolicy, TasksPerThread)) {
+    EnsureAllocatorExists(AllocId);
+    Pool.async(runBlock, B.Begin, B.End, AllocId);
+    AllocId++;
   }
-
-  EnsureAllocatorExists(AllocId);
-
-  Pool.async(runBlock, BlockBegin, BC.getBinaryFunctions().end(), AllocId);
   Lock.unlock();
   Pool.wait();
 }
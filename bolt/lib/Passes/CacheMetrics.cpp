@@ -15,6 +15,7 @@
 #include "bolt/Core/BinaryBasicBlock.h"
 #include "bolt/Core/BinaryFunction.h"
 #include <unordered_map>
+#include <unordered_set>
 
 using namespace llvm;
 using namespace bolt;
@@ -270,6 +271,28 @@ void CacheMetrics::printAll(raw_ostream &OS,
   std::unordered_map<BinaryBasicBlock *, uint64_t> BBSize;
   extractBasicBlockInfo(BFs, BBAddr, BBSize);
 
+  // The i-TLB footprint of the profiled code: the number of distinct pages
+  // that contain at least one executed basic block.
+  std::unordered_set<uint64_t> ExecutedPages;
+  std::unordered_set<uint64_t> ExecutedHugePages;
+  for (BinaryFunction *BF : BFs) {
+    for (BinaryBasicBlock &BB : *BF) {
+      const uint64_t Size = BBSize[&BB];
+      if (!BB.getKnownExecutionCount() || !Size)
+        continue;
+      const uint64_t Start = BBAddr[&BB];
+      for (uint64_t Page = Start / ITLBPageSize;
+           Page <= (Start + Size - 1) / ITLBPageSize; ++Page)
+        ExecutedPages.insert(Page);
+      for (uint64_t Page = Start / HugePage2MB;
+           Page <= (Start + Size - 1) / HugePage2MB; ++Page)
+        ExecutedHugePages.insert(Page);
+    }
+  }
+  OS << format("  Executed code touches %zu 4KB pages and %zu 2MB huge "
+               "pages\n",
+               ExecutedPages.size(), ExecutedHugePages.size());
+
   OS << "  Expected i-TLB cache hit ratio: "
      << format("%.2lf%%\n", expectedCacheHitRatio(BFs, BBAddr, BBSize));
 
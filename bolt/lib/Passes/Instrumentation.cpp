@@ -59,6 +59,13 @@ cl::opt<uint32_t> InstrumentationSleepTime(
              "program and the profile is not being dumped at the end."),
     cl::init(0), cl::Optional, cl::cat(BoltInstrCategory));
 
+static cl::opt<bool> InstrumentationAtomicCounters(
+    "instrumentation-atomic-counters",
+    cl::desc("increment counters atomically (default: true). Non-atomic "
+             "increments may lose counts in multi-threaded programs but avoid "
+             "serializing threads on shared counters (x86 only)"),
+    cl::init(true), cl::Optional, cl::cat(BoltInstrCategory));
+
 cl::opt<bool> InstrumentationNoCountersClear(
     "instrumentation-no-counters-clear",
     cl::desc("Don't clear counters across dumps "
@@ -266,7 +273,8 @@ Instrumentation::createInstrumentationSnippet(BinaryContext &BC, bool IsLeaf) {
   MCSymbol *Label = BC.Ctx->createNamedTempSymbol("InstrEntry");
   Summary->Counters.emplace_back(Label);
   return BC.MIB->createInstrIncMemory(Label, BC.Ctx.get(), IsLeaf,
-                                      BC.AsmInfo->getCodePointerSize());
+                                      BC.AsmInfo->getCodePointerSize(),
+                                      opts::InstrumentationAtomicCounters);
 }
 
 // Helper instruction sequence insertion function
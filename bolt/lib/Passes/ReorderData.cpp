@@ -16,6 +16,7 @@
 // - estimate temporal locality by looking at CFG?
 
 #include "bolt/Passes/ReorderData.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include <algorithm>
 
@@ -44,7 +45,8 @@ ReorderData("reorder-data",
 
 enum ReorderAlgo : char {
   REORDER_COUNT         = 0,
-  REORDER_FUNCS         = 1
+  REORDER_FUNCS         = 1,
+  REORDER_AFFINITY      = 2
 };
 
 static cl::opt<ReorderAlgo>
@@ -57,7 +59,10 @@ ReorderAlgorithm("reorder-data-algo",
       "sort hot data by read counts"),
     clEnumValN(REORDER_FUNCS,
       "funcs",
-      "sort hot data by hot function usage and count")),
+      "sort hot data by hot function usage and count"),
+    clEnumValN(REORDER_AFFINITY,
+      "affinity",
+      "cluster hot data accessed by the same hot functions")),
   cl::ZeroOrMore,
   cl::cat(BoltOptCategory));
 
@@ -133,6 +138,23 @@ bool filterSymbol(const BinaryData *BD) {
 
 using DataOrder = ReorderData::DataOrder;
 
+// Weight by number of loads/data size.
+static double getWeight(const DataOrder::value_type &Entry) {
+  return double(Entry.second) / Entry.first->getSize();
+}
+
+// Order by decreasing weight, then by increasing size and address.
+static bool compareByWeight(const DataOrder::value_type &A,
+                            const DataOrder::value_type &B) {
+  const double AWeight = getWeight(A);
+  const double BWeight = getWeight(B);
+  return (AWeight > BWeight ||
+          (AWeight == BWeight &&
+           (A.first->getSize() < B.first->getSize() ||
+            (A.first->getSize() == B.first->getSize() &&
+             A.first->getAddress() < B.first->getAddress()))));
+}
+
 void ReorderData::printOrder(BinaryContext &BC, const BinarySection &Section,
                              DataOrder::const_iterator Begin,
                              DataOrder::const_iterator End) const {
@@ -148,8 +170,7 @@ void ReorderData::printOrder(BinaryContext &BC, const BinarySection &Section,
     }
 
     BC.outs() << "BOLT-INFO: " << *BD << ", moveable=" << BD->isMoveable()
-              << format(", weight=%.5f\n",
-                        double(Begin->second) / BD->getSize());
+              << format(", weight=%.5f\n", getWeight(*Begin));
 
     TotalSize += BD->getSize();
     ++Begin;
@@ -279,9 +300,8 @@ ReorderData::sortedByFunc(BinaryContext &BC, const BinarySection &Section,
         // Total execution counts of functions referencing BD.
         const uint64_t ACount = BDtoFuncCount[A.first];
         const uint64_t BCount = BDtoFuncCount[B.first];
-        // Weight by number of loads/data size.
-        const double AWeight = double(A.second) / A.first->getSize();
-        const double BWeight = double(B.second) / B.first->getSize();
+        const double AWeight = getWeight(A);
+        const double BWeight = getWeight(B);
         return (ACount > BCount ||
                 (ACount == BCount &&
                  (AWeight > BWeight ||
@@ -305,17 +325,7 @@ ReorderData::sortedByCount(BinaryContext &BC,
   DataOrder Order = baseOrder(BC, Section);
   unsigned SplitPoint = Order.size();
 
-  llvm::sort(Order, [](const DataOrder::value_type &A,
-                       const DataOrder::value_type &B) {
-    // Weight by number of loads/data size.
-    const double AWeight = double(A.second) / A.first->getSize();
-    const double BWeight = double(B.second) / B.first->getSize();
-    return (AWeight > BWeight ||
-            (AWeight == BWeight &&
-             (A.first->getSize() < B.first->getSize() ||
-              (A.first->getSize() == B.first->getSize() &&
-               A.first->getAddress() < B.first->getAddress()))));
-  });
+  llvm::sort(Order, compareByWeight);
 
   for (unsigned Idx = 0; Idx < Order.size(); ++Idx) {
     if (!Order[Idx].second) {
@@ -327,6 +337,91 @@ ReorderData::sortedByCount(BinaryContext &BC,
   return std::make_pair(Order, SplitPoint);
 }
 
+/// Place data that is accessed by the same hot function next to each other,
+/// so that it shares cache lines and pages. Functions are visited hottest
+/// first and each function's data is placed by decreasing access count; data
+/// that was already placed for a hotter function keeps its position.
+std::pair<DataOrder, unsigned>
+ReorderData::sortedByAffinity(BinaryContext &BC, const BinarySection &Section,
+                              std::map<uint64_t, BinaryFunction> &BFs) const {
+  using DataUses = MapVector<BinaryData *, uint64_t>;
+  std::vector<std::pair<const BinaryFunction *, DataUses>> FuncUses;
+  for (auto &Entry : BFs) {
+    const BinaryFunction &BF = Entry.second;
+    if (!BF.hasValidProfile() || !BF.hasMemoryProfile())
+      continue;
+
+    DataUses Uses;
+    for (const BinaryBasicBlock &BB : BF) {
+      if (BB.isCold())
+        continue;
+
+      for (const MCInst &Inst : BB) {
+        auto ErrorOrMemAccessProfile =
+            BC.MIB->tryGetAnnotationAs<MemoryAccessProfile>(
+                Inst, "MemoryAccessProfile");
+        if (!ErrorOrMemAccessProfile)
+          continue;
+
+        for (const AddressAccess &AccessInfo :
+             ErrorOrMemAccessProfile->AddressAccessInfo) {
+          if (!AccessInfo.MemoryObject)
+            continue;
+          BinaryData *BD = AccessInfo.MemoryObject->getAtomicRoot();
+          if (&BD->getSection() != &Section ||
+              BC.getFunctionForSymbol(BD->getSymbol()))
+            continue;
+          Uses[BD] += AccessInfo.Count;
+        }
+      }
+    }
+    if (!Uses.empty())
+      FuncUses.emplace_back(&BF, std::move(Uses));
+  }
+
+  llvm::stable_sort(FuncUses, [](const auto &A, const auto &B) {
+    return A.first->getKnownExecutionCount() >
+           B.first->getKnownExecutionCount();
+  });
+
+  // Position of each clustered symbol in the new order.
+  DenseMap<const BinaryData *, unsigned> Rank;
+  for (auto &FuncUse : FuncUses) {
+    auto Uses = FuncUse.second.takeVector();
+    llvm::stable_sort(Uses, [](const auto &A, const auto &B) {
+      return A.second > B.second;
+    });
+    for (const auto &Use : Uses)
+      Rank.try_emplace(Use.first, Rank.size());
+  }
+
+  DataOrder Order = baseOrder(BC, Section);
+  unsigned SplitPoint = Order.size();
+
+  // Clustered data goes first. Hot data that is not accessed from a hot
+  // function follows, ordered as in sortedByCount().
+  llvm::stable_sort(Order, [&](const DataOrder::value_type &A,
+                               const DataOrder::value_type &B) {
+    auto ARank = Rank.find(A.first);
+    auto BRank = Rank.find(B.first);
+    if (ARank != Rank.end() || BRank != Rank.end()) {
+      if (ARank == Rank.end() || BRank == Rank.end())
+        return ARank != Rank.end();
+      return ARank->second < BRank->second;
+    }
+    return compareByWeight(A, B);
+  });
+
+  for (unsigned Idx = 0; Idx < Order.size(); ++Idx) {
+    if (!Rank.count(Order[Idx].first) && !Order[Idx].second) {
+      SplitPoint = Idx;
+      break;
+    }
+  }
+
+  return std::make_pair(Order, SplitPoint);
+}
+
 // TODO
 // add option for cache-line alignment (or just use cache-line when section
 // is writable)?
@@ -486,10 +581,14 @@ Error ReorderData::runOnFunctions(BinaryContext &BC) {
     if (opts::ReorderAlgorithm == opts::ReorderAlgo::REORDER_COUNT) {
       BC.outs() << "BOLT-INFO: reorder-sections: ordering data by count\n";
       std::tie(Order, SplitPointIdx) = sortedByCount(BC, *Section);
-    } else {
+    } else if (opts::ReorderAlgorithm == opts::ReorderAlgo::REORDER_FUNCS) {
       BC.outs() << "BOLT-INFO: reorder-sections: ordering data by funcs\n";
       std::tie(Order, SplitPointIdx) =
           sortedByFunc(BC, *Section, BC.getBinaryFunctions());
+    } else {
+      BC.outs() << "BOLT-INFO: reorder-sections: ordering data by affinity\n";
+      std::tie(Order, SplitPointIdx) =
+          sortedByAffinity(BC, *Section, BC.getBinaryFunctions());
     }
     auto SplitPoint = Order.begin() + SplitPointIdx;
 
@@ -1409,6 +1409,11 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
   // LBRs are stored in reverse execution order. NextPC refers to the next
   // recorded executed PC.
   uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
+  // Function lookups dominate the cost of aggregation. NextPC is the previous
+  // entry's source, so remember the function containing it instead of looking
+  // it up again.
+  const BinaryFunction *NextBF = nullptr;
+  bool HasNextBF = false;
   uint32_t NumEntry = 0;
   for (const LBREntry &LBR : Sample.LBR) {
     ++NumEntry;
@@ -1420,12 +1425,13 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
     // chronological order)
     if (NeedsSkylakeFix && NumEntry <= 2)
       continue;
+    const BinaryFunction *FromBF = getBinaryFunctionContainingAddress(LBR.From);
+    const BinaryFunction *ToBF = getBinaryFunctionContainingAddress(LBR.To);
     if (NextPC) {
       // Record fall-through trace.
       const uint64_t TraceFrom = LBR.To;
       const uint64_t TraceTo = NextPC;
-      const BinaryFunction *TraceBF =
-          getBinaryFunctionContainingAddress(TraceFrom);
+      const BinaryFunction *TraceBF = ToBF;
       if (TraceBF && TraceBF->containsAddress(TraceTo)) {
         FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
         if (TraceBF->containsAddress(LBR.From))
@@ -1434,7 +1440,7 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
           ++Info.ExternCount;
       } else {
         const BinaryFunction *ToFunc =
-            getBinaryFunctionContainingAddress(TraceTo);
+            HasNextBF ? NextBF : getBinaryFunctionContainingAddress(TraceTo);
         if (TraceBF && ToFunc) {
           LLVM_DEBUG({
             dbgs() << "Invalid trace starting in " << TraceBF->getPrintName()
@@ -1459,9 +1465,11 @@ uint64_t DataAggregator::parseLBRSample(const PerfBranchSample &Sample,
       ++NumTraces;
     }
     NextPC = LBR.From;
+    NextBF = FromBF;
+    HasNextBF = true;
 
-    uint64_t From = getBinaryFunctionContainingAddress(LBR.From) ? LBR.From : 0;
-    uint64_t To = getBinaryFunctionContainingAddress(LBR.To) ? LBR.To : 0;
+    uint64_t From = FromBF ? LBR.From : 0;
+    uint64_t To = ToBF ? LBR.To : 0;
     if (!From && !To)
       continue;
     TakenBranchInfo &Info = BranchLBRs[Trace(From, To)];
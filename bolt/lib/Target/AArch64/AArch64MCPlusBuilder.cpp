@@ -1598,7 +1598,9 @@ public:
 
   InstructionListType
   createInstrIncMemory(const MCSymbol *Target, MCContext *Ctx, bool IsLeaf,
-                       unsigned CodePointerSize) const override {
+                       unsigned CodePointerSize, bool Atomic) const override {
+    // Counters are always incremented with an atomic add: a non-atomic
+    // load/add/store sequence would need another scratch register.
     unsigned int I = 0;
     InstructionListType Instrs(IsLeaf ? 12 : 10);
 
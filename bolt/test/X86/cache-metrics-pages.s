@@ -0,0 +1,41 @@
+## Check that -print-cache-metrics reports the number of 4KB and 2MB pages
+## that contain executed code. The hot code is _start plus the 5000 bytes of
+## f1, which span two or three 4KB pages depending on where f1 starts. The
+## larger f2 is never executed and must not add any pages.
+
+# REQUIRES: system-linux
+
+# RUN: split-file %s %t
+# RUN: llvm-mc -filetype=obj -triple x86_64-unknown-unknown %t/main.s -o %t.o
+# RUN: %clang %cflags -no-pie %t.o -o %t.exe -Wl,-q -nostdlib
+# RUN: llvm-bolt %t.exe -o %t.bolt -data %t/fdata -print-cache-metrics | \
+# RUN:   FileCheck %s
+
+# CHECK: BOLT-INFO: cache metrics after emitting functions:
+# CHECK: Executed code touches {{[23]}} 4KB pages and 1 2MB huge pages
+
+#--- main.s
+  .text
+  .globl _start
+  .type _start, @function
+_start:
+  call f1
+  ret
+  .size _start, .-_start
+
+  .globl f1
+  .type f1, @function
+f1:
+  .fill 5000, 1, 0x90
+  ret
+  .size f1, .-f1
+
+  .globl f2
+  .type f2, @function
+f2:
+  .fill 20000, 1, 0x90
+  ret
+  .size f2, .-f2
+
+#--- fdata
+1 _start 0 1 f1 0 0 100
@@ -0,0 +1,86 @@
+## Check that -reorder-data-algo=affinity places the data accessed by the
+## hottest function first, in order of decreasing access count, followed by
+## the data of colder functions. The count algorithm orders the same data by
+## access count per byte alone.
+
+# REQUIRES: system-linux
+
+# RUN: split-file %s %t
+# RUN: llvm-mc -filetype=obj -triple x86_64-unknown-unknown %t/main.s -o %t.o
+# RUN: %clang %cflags -no-pie %t.o -o %t.exe -Wl,-q -nostdlib
+# RUN: llvm-bolt %t.exe -o %t.affinity -data %t/fdata -reorder-data=.data \
+# RUN:   -reorder-data-algo=affinity -print-reordered-data | \
+# RUN:   FileCheck %s --check-prefix=AFFINITY
+# RUN: llvm-bolt %t.exe -o %t.count -data %t/fdata -reorder-data=.data \
+# RUN:   -reorder-data-algo=count -print-reordered-data | \
+# RUN:   FileCheck %s --check-prefix=COUNT
+
+# AFFINITY:      BOLT-INFO: reorder-sections: ordering data by affinity
+# AFFINITY:      BOLT-INFO: Hot global symbols for .data:
+# AFFINITY-NEXT: BOLT-INFO: (object: c,
+# AFFINITY-NEXT: BOLT-INFO: (object: a,
+# AFFINITY-NEXT: BOLT-INFO: (object: d,
+# AFFINITY-NEXT: BOLT-INFO: Total hot symbol size = 24
+
+# COUNT:      BOLT-INFO: Hot global symbols for .data:
+# COUNT-NEXT: BOLT-INFO: (object: c,
+# COUNT-NEXT: BOLT-INFO: (object: d,
+# COUNT-NEXT: BOLT-INFO: (object: a,
+# COUNT-NEXT: BOLT-INFO: Total hot symbol size = 24
+
+#--- main.s
+  .text
+  .globl _start
+  .type _start, @function
+_start:
+  call f1
+  call f2
+  ret
+  .size _start, .-_start
+
+  .globl f1
+  .type f1, @function
+f1:
+  movq c(%rip), %rax
+  addq a(%rip), %rax
+  ret
+  .size f1, .-f1
+
+  .globl f2
+  .type f2, @function
+f2:
+  movq d(%rip), %rax
+  ret
+  .size f2, .-f2
+
+  .data
+  .globl a
+  .type a, @object
+a:
+  .quad 1
+  .size a, 8
+
+  .globl b
+  .type b, @object
+b:
+  .quad 2
+  .size b, 8
+
+  .globl c
+  .type c, @object
+c:
+  .quad 3
+  .size c, 8
+
+  .globl d
+  .type d, @object
+d:
+  .quad 4
+  .size d, 8
+
+#--- fdata
+1 _start 0 1 f1 0 0 1000
+1 _start 5 1 f2 0 0 10
+4 f1 0 4 c 0 50
+4 f1 7 4 a 0 20
+4 f2 0 4 d 0 40
@@ -0,0 +1,51 @@
+## Check that -instrumentation-atomic-counters=false makes the counter
+## increments non-atomic, and that the collected profile is still correct
+## for a single-threaded program. By default the increments are locked.
+
+# REQUIRES: system-linux,bolt-runtime
+
+# RUN: llvm-mc -filetype=obj -triple x86_64-unknown-unknown %s -o %t.o
+# RUN: %clang %cflags -no-pie %t.o -o %t.exe -Wl,-q
+
+# RUN: llvm-bolt %t.exe --instrument --instrumentation-file=%t.atomic.fdata \
+# RUN:   -o %t.atomic
+# RUN: llvm-objdump -d %t.atomic --disassemble-symbols=main | \
+# RUN:   FileCheck %s --check-prefix=ATOMIC
+
+# ATOMIC: lock incq
+
+# RUN: llvm-bolt %t.exe --instrument --instrumentation-file=%t.fdata \
+# RUN:   -instrumentation-atomic-counters=false -o %t.instrumented
+# RUN: llvm-objdump -d %t.instrumented --disassemble-symbols=main | \
+# RUN:   FileCheck %s --check-prefix=PLAIN
+
+# PLAIN-NOT: lock
+# PLAIN:     incq
+# PLAIN-NOT: lock
+
+# RUN: %t.instrumented
+# RUN: FileCheck %s --input-file %t.fdata --check-prefix=CHECK-FDATA
+# CHECK-FDATA: 1 main {{.*}} 1 targetFunc 0 0 10
+
+  .text
+  .globl  main
+  .type main, %function
+  .p2align  4
+main:
+  pushq %rbx
+  movl  $10, %ebx
+.Lloop:
+  callq targetFunc
+  subl  $1, %ebx
+  jne   .Lloop
+  popq  %rbx
+  xorl  %eax, %eax
+  retq
+  .size main, .-main
+
+  .globl  targetFunc
+  .type targetFunc, %function
+  .p2align  4
+targetFunc:
+  retq
+  .size targetFunc, .-targetFunc
@@ -22,6 +22,7 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/ThreadPool.h"
 #include <algorithm>
+#include <cmath>
 #include <mutex>
 #include <unordered_map>
 
@@ -68,6 +69,22 @@ SuppressMergedDataOutput("q",
   cl::Optional,
   cl::cat(MergeFdataCategory));
 
+static cl::list<double>
+InputWeights("weights",
+  cl::CommaSeparated,
+  cl::desc("weights to scale the counts of each input by, in the order of "
+           "the inputs (YAML profiles only)"),
+  cl::value_desc("w1,w2,..."),
+  cl::cat(MergeFdataCategory));
+
+static cl::opt<bool>
+ReplaceMismatched("replace-mismatched",
+  cl::desc("when a function does not match between inputs, keep the profile "
+           "from the later input instead of failing; inputs are expected "
+           "from oldest to newest (YAML profiles only)"),
+  cl::init(false),
+  cl::cat(MergeFdataCategory));
+
 static cl::opt<std::string>
 OutputFilePath("o",
   cl::value_desc("file"),
@@ -211,6 +228,16 @@ void mergeBasicBlockProfile(BinaryBasicBlockProfile &MergedBB,
 
 void mergeFunctionProfile(BinaryFunctionProfile &MergedBF,
                           BinaryFunctionProfile &&BF) {
+  // The function changed between the binaries the profiles were collected
+  // on. Keep the newer profile and let stale matching in BOLT take it from
+  // there.
+  if (opts::ReplaceMismatched &&
+      (BF.NumBasicBlocks != MergedBF.NumBasicBlocks || BF.Id != MergedBF.Id ||
+       BF.Hash != MergedBF.Hash)) {
+    MergedBF = std::move(BF);
+    return;
+  }
+
   // Validate that we are merging the correct function.
   if (BF.NumBasicBlocks != MergedBF.NumBasicBlocks)
     report_error(BF.Name, "number of basic blocks mismatch");
@@ -247,6 +274,26 @@ void mergeFunctionProfile(BinaryFunctionProfile &MergedBF,
       MergedBF.Blocks.emplace_back(std::move(*BB));
 }
 
+/// Scale all counts in \p BF by \p Weight.
+void scaleFunctionProfile(BinaryFunctionProfile &BF, double Weight) {
+  auto Scale = [Weight](uint64_t &Count) {
+    Count = static_cast<uint64_t>(Count * Weight + 0.5);
+  };
+  Scale(BF.ExecCount);
+  for (BinaryBasicBlockProfile &BB : BF.Blocks) {
+    Scale(BB.ExecCount);
+    Scale(BB.EventCount);
+    for (CallSiteInfo &CS : BB.CallSites) {
+      Scale(CS.Count);
+      Scale(CS.Mispreds);
+    }
+    for (SuccessorInfo &SI : BB.Successors) {
+      Scale(SI.Count);
+      Scale(SI.Mispreds);
+    }
+  }
+}
+
 bool isYAML(const StringRef Filename) {
   ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
       MemoryBuffer::getFileOrSTDIN(Filename);
@@ -354,9 +401,21 @@ int main(int argc, char **argv) {
 
   ToolName = argv[0];
 
-  // Recursively expand input directories into input file lists.
+  if (!opts::InputWeights.empty() &&
+      opts::InputWeights.size() != opts::InputDataFilenames.size())
+    report_error("-weights", "expected one weight per input");
+  for (double Weight : opts::InputWeights)
+    if (!std::isfinite(Weight) || Weight < 0)
+      report_error("-weights", "weights must be finite and non-negative");
+
+  // Recursively expand input directories into input file lists. All files in
+  // a directory share the directory's weight.
   SmallVector<std::string> Inputs;
-  for (std::string &InputDataFilename : opts::InputDataFilenames) {
+  SmallVector<double> Weights;
+  for (auto [Idx, InputDataFilename] :
+       llvm::enumerate(opts::InputDataFilenames)) {
+    const double Weight =
+        opts::InputWeights.empty() ? 1.0 : opts::InputWeights[Idx];
     if (!llvm::sys::fs::exists(InputDataFilename))
       report_error(InputDataFilename,
                    std::make_error_code(std::errc::no_such_file_or_directory));
@@ -372,9 +431,13 @@ int main(int argc, char **argv) {
       if (EC)
         report_error(InputDataFilename, EC);
     }
+    Weights.resize(Inputs.size(), Weight);
   }
 
   if (!isYAML(Inputs.front())) {
+    if (!opts::InputWeights.empty() || opts::ReplaceMismatched)
+      report_error(Inputs.front(),
+                   "-weights and -replace-mismatched require YAML profiles");
     mergeLegacyProfiles(Inputs);
     return 0;
   }
@@ -386,7 +449,7 @@ int main(int argc, char **argv) {
   // Merged information for all functions.
   StringMap<BinaryFunctionProfile> MergedBFs;
 
-  for (std::string &InputDataFilename : Inputs) {
+  for (auto [InputDataFilename, Weight] : llvm::zip_equal(Inputs, Weights)) {
     ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
         MemoryBuffer::getFileOrSTDIN(InputDataFilename);
     if (std::error_code EC = MB.getError())
@@ -412,6 +475,9 @@ int main(int argc, char **argv) {
 
     // Do the function merge.
     for (BinaryFunctionProfile &BF : BP.Functions) {
+      if (Weight != 1.0)
+        scaleFunctionProfile(BF, Weight);
+
       if (!MergedBFs.count(BF.Name)) {
         MergedBFs.insert(std::make_pair(BF.Name, BF));
         continue;
@@ -38,11 +38,13 @@ from __future__ import print_function
 
 import argparse
 import glob
+import hashlib
 import json
 import multiprocessing
 import os
 import queue
 import re
+import shlex
 import shutil
 import subprocess
 import sys
@@ -151,6 +153,124 @@ def get_tidy_invocation(
     return start
 
 
+def get_dependency_invocation(
+    clang_binary, command, extra_arg, extra_arg_before, depfile
+):
+    """Gets a command line that writes the files included by the translation
+    unit of a compile command to depfile. clang-tidy strips the dependency file
+    options from compile commands, so the preprocessor is run separately."""
+    if "arguments" in command:
+        arguments = list(command["arguments"])
+    else:
+        arguments = shlex.split(command["command"])
+    start = [clang_binary] + list(extra_arg_before)
+    skip_next = False
+    for arg in arguments[1:]:
+        if skip_next:
+            skip_next = False
+            continue
+        if arg in ("-o", "-MF", "-MT", "-MQ", "-MJ"):
+            skip_next = True
+            continue
+        if arg in ("-c", "-S", "-E", "-M", "-MM", "-MD", "-MMD", "-MG", "-MP"):
+            continue
+        if arg.startswith(("-MF", "-MT", "-MQ", "-MJ")) or (
+            arg.startswith("-o") and not arg.startswith("-obj")
+        ):
+            continue
+        start.append(arg)
+    start.extend(extra_arg)
+    start.extend(["-M", "-MF", depfile])
+    return start
+
+
+def get_file_hash(path):
+    """Returns the SHA-256 of the contents of a file, or None if it can't be
+    read."""
+    try:
+        with open(path, "rb") as f:
+            return hashlib.sha256(f.read()).hexdigest()
+    except OSError:
+        return None
+
+
+def parse_dependency_file(path):
+    """Returns the prerequisites listed in a Makefile-style dependency file."""
+    with open(path, "r") as f:
+        contents = f.read().replace("\\\n", " ")
+    deps = []
+    for line in contents.splitlines():
+        _, sep, prerequisites = line.partition(": ")
+        if not sep:
+            continue
+        for token in re.findall(r"(?:\\.|[^\s\\])+", prerequisites):
+            deps.append(token.replace("\\ ", " "))
+    return deps
+
+
+def get_cache_key(name, invocation, compile_commands):
+    """Computes the key under which the result of running clang-tidy on a file
+    is cached. The key covers the clang-tidy binary, its command line, the
+    compile commands of the file and any .clang-tidy configuration that applies
+    to it. The contents of the file and its includes are checked separately
+    when the cached result is read."""
+    key = hashlib.sha256()
+    key.update("\0".join(invocation).encode("utf-8"))
+    try:
+        st = os.stat(invocation[0])
+        key.update(("\0%d\0%d" % (st.st_size, st.st_mtime_ns)).encode("utf-8"))
+    except OSError:
+        pass
+    key.update(json.dumps(compile_commands, sort_keys=True).encode("utf-8"))
+    directory = os.path.dirname(name)
+    while True:
+        config_hash = get_file_hash(os.path.join(directory, ".clang-tidy"))
+        if config_hash is not None:
+            key.update(("\0" + directory + "\0" + config_hash).encode("utf-8"))
+        parent = os.path.dirname(directory)
+        if parent == directory:
+            break
+        directory = parent
+    return key.hexdigest()
+
+
+def read_cache_entry(cache_file):
+    """Returns the cached clang-tidy output stored in cache_file, or None if
+    there is none or one of the files it was computed from has changed."""
+    try:
+        with open(cache_file, "r") as f:
+            entry = json.load(f)
+    except (OSError, ValueError):
+        return None
+    for dep, dep_hash in entry["deps"].items():
+        if get_file_hash(dep) != dep_hash:
+            return None
+    return entry
+
+
+def write_cache_entry(cache_file, depfile, directory, output, err):
+    """Stores the output of a successful clang-tidy run in cache_file, along
+    with the hashes of the files listed in depfile. Relative paths in depfile
+    are relative to the compilation directory."""
+    try:
+        deps = parse_dependency_file(depfile)
+    except OSError:
+        # Without the list of included files, we can't tell when the entry
+        # goes stale, so don't cache anything.
+        return
+    entry = {"deps": {}, "output": output, "err": err}
+    for dep in deps:
+        dep = make_absolute(dep, directory)
+        dep_hash = get_file_hash(dep)
+        if dep_hash is None:
+            return
+        entry["deps"][dep] = dep_hash
+    (handle, name) = tempfile.mkstemp(suffix=".json", dir=os.path.dirname(cache_file))
+    with os.fdopen(handle, "w") as f:
+        json.dump(entry, f)
+    os.replace(name, cache_file)
+
+
 def merge_replacement_files(tmpdir, mergefile):
     """Merge all replacement files in a directory into a single file"""
     # The fixes suggested by clang-tidy >= 4.0.0 are given under
@@ -210,7 +330,17 @@ def apply_fixes(args, clang_apply_replacements_binary, tmpdir):
     subprocess.call(invocation)
 
 
-def run_tidy(args, clang_tidy_binary, tmpdir, build_path, queue, lock, failed_files):
+def run_tidy(
+    args,
+    clang_tidy_binary,
+    tmpdir,
+    build_path,
+    queue,
+    lock,
+    failed_files,
+    compile_commands,
+    clang_binary,
+):
     """Takes filenames out of queue and runs clang-tidy on them."""
     while True:
         name = queue.get()
@@ -234,6 +364,19 @@ def run_tidy(args, clang_tidy_binary, tmpdir, build_path, queue, lock, failed_fi
             args.exclude_header_filter,
         )
 
+        if args.cache_dir:
+            key = get_cache_key(name, invocation, compile_commands.get(name, []))
+            cache_file = os.path.join(args.cache_dir, key + ".json")
+            entry = read_cache_entry(cache_file)
+            if entry is not None:
+                with lock:
+                    sys.stdout.write(" ".join(invocation) + "\n" + entry["output"])
+                    if len(entry["err"]) > 0:
+                        sys.stdout.flush()
+                        sys.stderr.write(entry["err"])
+                queue.task_done()
+                continue
+
         proc = subprocess.Popen(
             invocation, stdout=subprocess.PIPE, stderr=subprocess.PIPE
         )
@@ -243,6 +386,36 @@ def run_tidy(args, clang_tidy_binary, tmpdir, build_path, queue, lock, failed_fi
                 msg = "%s: terminated by signal %d\n" % (name, -proc.returncode)
                 err += msg.encode("utf-8")
             failed_files.append(name)
+        elif args.cache_dir and compile_commands.get(name):
+            # Have the compiler list the files the translation unit includes,
+            # so that the cached result can be invalidated when one changes.
+            command = compile_commands[name][0]
+            depfile = cache_file + ".d"
+            dependency_invocation = get_dependency_invocation(
+                clang_binary,
+                command,
+                args.extra_arg,
+                args.extra_arg_before,
+                depfile,
+            )
+            if (
+                subprocess.call(
+                    dependency_invocation,
+                    cwd=command["directory"],
+                    stdout=subprocess.DEVNULL,
+                    stderr=subprocess.DEVNULL,
+                )
+                == 0
+            ):
+                write_cache_entry(
+                    cache_file,
+                    depfile,
+                    command["directory"],
+                    output.decode("utf-8"),
+                    err.decode("utf-8"),
+                )
+            if os.path.exists(depfile):
+                os.remove(depfile)
         with lock:
             sys.stdout.write(" ".join(invocation) + "\n" + output.decode("utf-8"))
             if len(err) > 0:
@@ -343,6 +516,22 @@ def main():
             "with clang-apply-replacements. The fixes of each compilation unit are "
             "stored in individual yaml files in the directory.",
         )
+    parser.add_argument(
+        "-cache-dir",
+        metavar="directory",
+        dest="cache_dir",
+        default=None,
+        help="A directory in which to cache the output of clang-tidy for each "
+        "file. Files whose contents, includes, compile command and "
+        "configuration haven't changed since a successful run are not "
+        "analyzed again. Can't be combined with -fix or -export-fixes.",
+    )
+    parser.add_argument(
+        "-clang-binary",
+        metavar="PATH",
+        help="Path to the clang binary used to list the includes of each file "
+        "for -cache-dir.",
+    )
     parser.add_argument(
         "-j",
         type=int,
@@ -444,6 +633,21 @@ def main():
         export_fixes_dir = tempfile.mkdtemp()
         delete_fixes_dir = True
 
+    clang_binary = None
+    if args.cache_dir is not None:
+        if export_fixes_dir is not None:
+            print(
+                "Error: -cache-dir can't be combined with -fix or -export-fixes.",
+                file=sys.stderr,
+            )
+            sys.exit(1)
+        # Dependency files are written from the directory of each compile
+        # command, so the cache must not be found relative to it.
+        args.cache_dir = os.path.abspath(args.cache_dir)
+        if not os.path.isdir(args.cache_dir):
+            os.makedirs(args.cache_dir)
+        clang_binary = find_binary(args.clang_binary, "clang", build_path)
+
     try:
         invocation = get_tidy_invocation(
             "",
@@ -481,6 +685,11 @@ def main():
     files = set(
         [make_absolute(entry["file"], entry["directory"]) for entry in database]
     )
+    compile_commands = {}
+    if args.cache_dir is not None:
+        for entry in database:
+            name = make_absolute(entry["file"], entry["directory"])
+            compile_commands.setdefault(name, []).append(entry)
 
     # Filter source files from compilation database.
     if args.source_filter:
@@ -520,6 +729,8 @@ def main():
                     task_queue,
                     lock,
                     failed_files,
+                    compile_commands,
+                    clang_binary,
                 ),
             )
             t.daemon = True
@@ -115,6 +115,10 @@ constexpr trace::Metric PreambleBuildSize("preamble_build_size",
                                           trace::Metric::Distribution);
 constexpr trace::Metric PreambleSerializedSize("preamble_serialized_size",
                                                trace::Metric::Distribution);
+// Counts preamble builds that produced the same preamble as another open file,
+// i.e. builds that could have been avoided by sharing preambles.
+constexpr trace::Metric PreambleDuplicateBuilds("preamble_duplicate_builds",
+                                                trace::Metric::Counter);
 
 void reportPreambleBuild(const PreambleBuildStats &Stats,
                          bool IsFirstPreamble) {
@@ -343,6 +347,62 @@ public:
   }
 };
 
+/// A fingerprint of the latest preamble of each open file.
+///
+/// A preamble only depends on the text within its bounds, the compile command
+/// and the directory of the main file (for quoted includes). Two open files
+/// with the same fingerprint hold equivalent preambles, which we count to
+/// measure how much sharing preambles between files would save.
+/// All methods are threadsafe.
+class TUScheduler::PreambleFingerprints {
+  llvm::StringMap<uint64_t> ByFile;
+  llvm::DenseMap<uint64_t, unsigned> NumFiles;
+  std::mutex Mu;
+
+  void forget(llvm::StringMap<uint64_t>::iterator It) {
+    auto Count = NumFiles.find(It->second);
+    if (--Count->second == 0)
+      NumFiles.erase(Count);
+  }
+
+public:
+  static uint64_t compute(PathRef MainFile, const ParseInputs &Inputs,
+                          const PreambleData &Preamble) {
+    llvm::StringRef Text = llvm::StringRef(Inputs.Contents)
+                               .take_front(Preamble.Preamble.getBounds().Size);
+    llvm::hash_code Hash = llvm::hash_combine(
+        llvm::sys::path::parent_path(MainFile), Text,
+        Inputs.CompileCommand.Directory);
+    for (llvm::StringRef Arg : Inputs.CompileCommand.CommandLine)
+      if (Arg != MainFile && Arg != Inputs.CompileCommand.Filename)
+        Hash = llvm::hash_combine(Hash, Arg);
+    return Hash;
+  }
+
+  /// Records the fingerprint of MainFile's latest preamble. Returns true if
+  /// another open file currently has a preamble with the same fingerprint.
+  bool update(PathRef MainFile, uint64_t Fingerprint) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto It = ByFile.try_emplace(MainFile, Fingerprint);
+    if (!It.second) {
+      if (It.first->second == Fingerprint)
+        return NumFiles[Fingerprint] > 1;
+      forget(It.first);
+      It.first->second = Fingerprint;
+    }
+    return ++NumFiles[Fingerprint] > 1;
+  }
+
+  void remove(PathRef MainFile) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto It = ByFile.find(MainFile);
+    if (It == ByFile.end())
+      return;
+    forget(It);
+    ByFile.erase(It);
+  }
+};
+
 namespace {
 
 bool isReliable(const tooling::CompileCommand &Cmd) {
@@ -428,11 +488,14 @@ public:
                  bool StorePreambleInMemory, bool RunSync,
                  PreambleThrottler *Throttler, SynchronizedTUStatus &Status,
                  TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                 TUScheduler::PreambleFingerprints &Fingerprints,
                  ASTWorker &AW)
       : FileName(FileName), Callbacks(Callbacks),
         StoreInMemory(StorePreambleInMemory), RunSync(RunSync),
         Throttler(Throttler), Status(Status), ASTPeer(AW),
-        HeaderIncluders(HeaderIncluders) {}
+        HeaderIncluders(HeaderIncluders), Fingerprints(Fingerprints) {}
+
+  ~PreambleThread() { Fingerprints.remove(FileName); }
 
   /// It isn't guaranteed that each requested version will be built. If there
   /// are multiple update requests while building a preamble, only the last one
@@ -586,6 +649,7 @@ private:
   SynchronizedTUStatus &Status;
   ASTWorker &ASTPeer;
   TUScheduler::HeaderIncluderCache &HeaderIncluders;
+  TUScheduler::PreambleFingerprints &Fingerprints;
 };
 
 class ASTWorkerHandle;
@@ -605,6 +669,7 @@ class ASTWorker {
   ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
             TUScheduler::ASTCache &LRUCache,
             TUScheduler::HeaderIncluderCache &HeaderIncluders,
+            TUScheduler::PreambleFingerprints &Fingerprints,
             Semaphore &Barrier, bool RunSync, const TUScheduler::Options &Opts,
             ParsingCallbacks &Callbacks);
 
@@ -618,6 +683,7 @@ public:
   create(PathRef FileName, const GlobalCompilationDatabase &CDB,
          TUScheduler::ASTCache &IdleASTs,
          TUScheduler::HeaderIncluderCache &HeaderIncluders,
+         TUScheduler::PreambleFingerprints &Fingerprints,
          AsyncTaskRunner *Tasks, Semaphore &Barrier,
          const TUScheduler::Options &Opts, ParsingCallbacks &Callbacks);
   ~ASTWorker();
@@ -811,12 +877,13 @@ ASTWorkerHandle
 ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
                   TUScheduler::ASTCache &IdleASTs,
                   TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                  TUScheduler::PreambleFingerprints &Fingerprints,
                   AsyncTaskRunner *Tasks, Semaphore &Barrier,
                   const TUScheduler::Options &Opts,
                   ParsingCallbacks &Callbacks) {
   std::shared_ptr<ASTWorker> Worker(
-      new ASTWorker(FileName, CDB, IdleASTs, HeaderIncluders, Barrier,
-                    /*RunSync=*/!Tasks, Opts, Callbacks));
+      new ASTWorker(FileName, CDB, IdleASTs, HeaderIncluders, Fingerprints,
+                    Barrier, /*RunSync=*/!Tasks, Opts, Callbacks));
   if (Tasks) {
     Tasks->runAsync("ASTWorker:" + llvm::sys::path::filename(FileName),
                     [Worker]() { Worker->run(); });
@@ -830,6 +897,7 @@ ASTWorker::create(PathRef FileName, const GlobalCompilationDatabase &CDB,
 ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
                      TUScheduler::ASTCache &LRUCache,
                      TUScheduler::HeaderIncluderCache &HeaderIncluders,
+                     TUScheduler::PreambleFingerprints &Fingerprints,
                      Semaphore &Barrier, bool RunSync,
                      const TUScheduler::Options &Opts,
                      ParsingCallbacks &Callbacks)
@@ -838,7 +906,8 @@ ASTWorker::ASTWorker(PathRef FileName, const GlobalCompilationDatabase &CDB,
       ContextProvider(Opts.ContextProvider), CDB(CDB), Callbacks(Callbacks),
       Barrier(Barrier), Done(false), Status(FileName, Callbacks),
       PreamblePeer(FileName, Callbacks, Opts.StorePreamblesInMemory, RunSync,
-                   Opts.PreambleThrottler, Status, HeaderIncluders, *this) {
+                   Opts.PreambleThrottler, Status, HeaderIncluders,
+                   Fingerprints, *this) {
   // Set a fallback command because compile command can be accessed before
   // `Inputs` is initialized. Other fields are only used after initialization
   // from client inputs.
@@ -1093,6 +1162,13 @@ void PreambleThread::build(Request Req) {
   if (!LatestBuild)
     return;
   reportPreambleBuild(Stats, IsFirstPreamble);
+  uint64_t Fingerprint = TUScheduler::PreambleFingerprints::compute(
+      FileName, Inputs, *LatestBuild);
+  if (Fingerprints.update(FileName, Fingerprint)) {
+    vlog("Preamble for {0} is identical to that of another open file",
+         FileName);
+    PreambleDuplicateBuilds.record(1);
+  }
   if (isReliable(LatestBuild->CompileCommand))
     HeaderIncluders.update(FileName, LatestBuild->Includes.allHeaders());
 }
@@ -1633,7 +1709,8 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
       Barrier(Opts.AsyncThreadsCount), QuickRunBarrier(Opts.AsyncThreadsCount),
       IdleASTs(
           std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
-      HeaderIncluders(std::make_unique<HeaderIncluderCache>()) {
+      HeaderIncluders(std::make_unique<HeaderIncluderCache>()),
+      Fingerprints(std::make_unique<PreambleFingerprints>()) {
   // Avoid null checks everywhere.
   if (!Opts.ContextProvider) {
     this->Opts.ContextProvider = [](llvm::StringRef) {
@@ -1675,7 +1752,7 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
   if (!FD) {
     // Create a new worker to process the AST-related tasks.
     ASTWorkerHandle Worker = ASTWorker::create(
-        File, CDB, *IdleASTs, *HeaderIncluders,
+        File, CDB, *IdleASTs, *HeaderIncluders, *Fingerprints,
         WorkerThreads ? &*WorkerThreads : nullptr, Barrier, Opts, *Callbacks);
     FD = std::unique_ptr<FileData>(
         new FileData{Inputs.Contents, std::move(Worker)});
@@ -345,6 +345,8 @@ public:
   class ASTCache;
   /// Tracks headers included by open files, to get known-good compile commands.
   class HeaderIncluderCache;
+  /// Tracks which open files have built identical preambles.
+  class PreambleFingerprints;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -368,6 +370,7 @@ private:
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
   std::unique_ptr<HeaderIncluderCache> HeaderIncluders;
+  std::unique_ptr<PreambleFingerprints> Fingerprints;
   // std::nullopt when running tasks synchronously and non-std::nullopt when
   // running tasks asynchronously.
   std::optional<AsyncTaskRunner> PreambleTasks;
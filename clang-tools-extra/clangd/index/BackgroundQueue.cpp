@@ -83,6 +83,8 @@ bool BackgroundQueue::adjust(Task &T) {
   if (T.Key && !SeenKeys.insert(T.Key).second)
     return false;
   T.QueuePri = std::max(T.QueuePri, Boosts.lookup(T.Tag));
+  if (!T.Directory.empty())
+    T.QueuePri = std::max(T.QueuePri, DirectoryBoosts.lookup(T.Directory));
   return true;
 }
 
@@ -116,7 +118,20 @@ void BackgroundQueue::append(std::vector<Task> Tasks) {
 
 void BackgroundQueue::boost(llvm::StringRef Tag, unsigned NewPriority) {
   std::lock_guard<std::mutex> Lock(Mu);
-  unsigned &Boost = Boosts[Tag];
+  boostMatching(Boosts, &Task::Tag, Tag, NewPriority);
+}
+
+void BackgroundQueue::boostDirectory(llvm::StringRef Directory,
+                                     unsigned NewPriority) {
+  std::lock_guard<std::mutex> Lock(Mu);
+  boostMatching(DirectoryBoosts, &Task::Directory, Directory, NewPriority);
+}
+
+void BackgroundQueue::boostMatching(llvm::StringMap<unsigned> &BoostMap,
+                                    std::string Task::*Field,
+                                    llvm::StringRef Value,
+                                    unsigned NewPriority) {
+  unsigned &Boost = BoostMap[Value];
   bool Increase = NewPriority > Boost;
   Boost = NewPriority;
   if (!Increase)
@@ -124,7 +139,7 @@ void BackgroundQueue::boost(llvm::StringRef Tag, unsigned NewPriority) {
 
   unsigned Changes = 0;
   for (Task &T : Queue)
-    if (Tag == T.Tag && NewPriority > T.QueuePri) {
+    if (Value == T.*Field && NewPriority > T.QueuePri) {
       T.QueuePri = NewPriority;
       ++Changes;
     }
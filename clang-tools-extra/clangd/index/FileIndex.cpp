@@ -340,24 +340,36 @@ FileSymbols::buildIndex(IndexType Type, DuplicateHandling DuplicateHandle,
   std::vector<Ref> RefsStorage; // Contiguous ranges for each SymbolID.
   llvm::DenseMap<SymbolID, llvm::ArrayRef<Ref>> AllRefs;
   {
-    llvm::DenseMap<SymbolID, llvm::SmallVector<Ref, 4>> MergedRefs;
+    // Lay out each symbol's range up front, so that refs are copied straight
+    // into RefsStorage instead of being gathered per symbol first. This keeps
+    // the peak memory of a rebuild close to the size of the final index.
+    llvm::DenseMap<SymbolID, std::pair<size_t, size_t>> Ranges; // Begin, End.
     size_t Count = 0;
     for (const auto &RefSlab : RefSlabs)
       for (const auto &Sym : *RefSlab) {
-        MergedRefs[Sym.first].append(Sym.second.begin(), Sym.second.end());
+        Ranges[Sym.first].second += Sym.second.size();
         Count += Sym.second.size();
       }
-    RefsStorage.reserve(Count);
-    AllRefs.reserve(MergedRefs.size());
-    for (auto &Sym : MergedRefs) {
-      auto &SymRefs = Sym.second;
+    size_t Begin = 0;
+    for (auto &Sym : Ranges) {
+      size_t Size = Sym.second.second;
+      Sym.second = {Begin, Begin};
+      Begin += Size;
+    }
+    RefsStorage.resize(Count);
+    for (const auto &RefSlab : RefSlabs)
+      for (const auto &Sym : *RefSlab) {
+        size_t &End = Ranges.find(Sym.first)->second.second;
+        llvm::copy(Sym.second, RefsStorage.begin() + End);
+        End += Sym.second.size();
+      }
+    AllRefs.reserve(Ranges.size());
+    for (const auto &Sym : Ranges) {
+      llvm::MutableArrayRef<Ref> SymRefs(RefsStorage.data() + Sym.second.first,
+                                         RefsStorage.data() + Sym.second.second);
       // Sorting isn't required, but yields more stable results over rebuilds.
       llvm::sort(SymRefs);
-      llvm::copy(SymRefs, back_inserter(RefsStorage));
-      AllRefs.try_emplace(
-          Sym.first,
-          llvm::ArrayRef<Ref>(&RefsStorage[RefsStorage.size() - SymRefs.size()],
-                              SymRefs.size()));
+      AllRefs.try_emplace(Sym.first, SymRefs);
     }
   }
 
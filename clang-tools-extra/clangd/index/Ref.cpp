@@ -39,6 +39,22 @@ void RefSlab::Builder::insert(const SymbolID &ID, const Ref &S) {
   Entries.insert(std::move(E));
 }
 
+void RefSlab::Builder::insert(const SymbolID &ID, llvm::ArrayRef<Ref> Refs) {
+  // Refs read from one file usually point into the same string table entry,
+  // so only intern a FileURI when it differs from the previous one.
+  const char *LastURI = nullptr;
+  const char *SavedURI = nullptr;
+  for (const Ref &R : Refs) {
+    if (R.Location.FileURI != LastURI) {
+      LastURI = R.Location.FileURI;
+      SavedURI = UniqueStrings.save(LastURI).data();
+    }
+    Entry E = {ID, R};
+    E.Reference.Location.FileURI = SavedURI;
+    Entries.insert(std::move(E));
+  }
+}
+
 RefSlab RefSlab::Builder::build() && {
   std::vector<std::pair<SymbolID, llvm::ArrayRef<Ref>>> Result;
   // We'll reuse the arena, as it only has unique strings and we need them all.
@@ -134,6 +134,9 @@ public:
     Builder() : UniqueStrings(Arena) {}
     /// Adds a ref to the slab. Deep copy: Strings will be owned by the slab.
     void insert(const SymbolID &ID, const Ref &S);
+    /// Adds several refs of the same symbol to the slab. Cheaper than inserting
+    /// them one by one when consecutive refs share a FileURI.
+    void insert(const SymbolID &ID, llvm::ArrayRef<Ref> Refs);
     /// Consumes the builder to finalize the slab.
     RefSlab build() &&;
 
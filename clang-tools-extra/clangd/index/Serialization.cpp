@@ -519,8 +519,7 @@ llvm::Expected<IndexFileIn> readRIFF(llvm::StringRef Data,
     RefSlab::Builder Refs;
     while (!RefsReader.eof()) {
       auto RefsBundle = readRefs(RefsReader, Strings->Strings);
-      for (const auto &Ref : RefsBundle.second) // FIXME: bulk insert?
-        Refs.insert(RefsBundle.first, Ref);
+      Refs.insert(RefsBundle.first, RefsBundle.second);
     }
     if (RefsReader.err())
       return error("malformed or truncated refs");
@@ -706,16 +705,18 @@ llvm::Expected<IndexFileIn> readIndexFile(llvm::StringRef Data,
 std::unique_ptr<SymbolIndex> loadIndex(llvm::StringRef SymbolFilename,
                                        SymbolOrigin Origin, bool UseDex) {
   trace::Span OverallTracer("LoadIndex");
-  auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename);
-  if (!Buffer) {
-    elog("Can't open {0}: {1}", SymbolFilename, Buffer.getError().message());
-    return nullptr;
-  }
-
   SymbolSlab Symbols;
   RefSlab Refs;
   RelationSlab Relations;
   {
+    // The slabs own copies of everything they need, so the file contents are
+    // released before the index is built rather than kept alive alongside it.
+    auto Buffer = llvm::MemoryBuffer::getFile(SymbolFilename);
+    if (!Buffer) {
+      elog("Can't open {0}: {1}", SymbolFilename, Buffer.getError().message());
+      return nullptr;
+    }
+
     trace::Span Tracer("ParseIndex");
     if (auto I = readIndexFile(Buffer->get()->getBuffer(), Origin)) {
       if (I->Symbols)
@@ -10,7 +10,6 @@
 #include "index/dex/Iterator.h"
 #include "index/dex/Token.h"
 #include "llvm/Support/MathExtras.h"
-#include <optional>
 
 namespace clang {
 namespace clangd {
@@ -99,15 +98,25 @@ private:
 
   /// Advances CurrentChunk to the chunk which might contain ID.
   void advanceToChunk(DocID ID) {
-    if ((CurrentChunk != Chunks.end() - 1) &&
-        ((CurrentChunk + 1)->Head <= ID)) {
-      CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
-      CurrentID = DecompressedChunk.begin();
+    auto Low = CurrentChunk + 1;
+    if (Low == Chunks.end() || Low->Head > ID)
+      return;
+    // Gallop before binary searching: during AND intersections the target is
+    // usually only a few chunks ahead, so this touches far fewer chunks than
+    // searching the whole remainder of the list.
+    size_t Step = 1;
+    while (Step < static_cast<size_t>(Chunks.end() - Low) &&
+           Low[Step].Head <= ID) {
+      Low += Step;
+      Step *= 2;
     }
+    auto High = Low + std::min(Step, static_cast<size_t>(Chunks.end() - Low));
+    CurrentChunk = std::partition_point(
+                       Low + 1, High,
+                       [&](const Chunk &C) { return C.Head <= ID; }) -
+                   1;
+    DecompressedChunk = CurrentChunk->decompress();
+    CurrentID = DecompressedChunk.begin();
   }
 
   const Token *Tok;
@@ -181,38 +190,31 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return std::nullopt.
-std::optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return std::nullopt;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
-    // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
-  }
-  return Result;
-}
-
 } // namespace
 
 llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
   llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
+  // Decode the VByte stream in a single pass over the payload. Only the first
+  // byte of an encoding can be zero, which marks the end of the stream.
+  DocID Current = Head;
+  DocID Delta = 0;
+  unsigned Shift = 0;
+  for (uint8_t Byte : Payload) {
+    if (Shift == 0 && Byte == 0)
       break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
+    // Write meaningful bits to the correct place in the document decoding.
+    Delta |= static_cast<DocID>(Byte & 0x7f) << Shift;
+    if (Byte & 0x80) {
+      Shift += BitsPerEncodingByte;
+      assert(Shift <= 28 && "Malformed VByte encoding sequence.");
+      continue;
+    }
+    Current += Delta;
+    Result.push_back(Current);
+    Delta = 0;
+    Shift = 0;
   }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  return Result;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
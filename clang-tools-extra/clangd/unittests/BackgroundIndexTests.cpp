@@ -824,6 +824,34 @@ TEST(BackgroundQueueTest, Boost) {
   }
 }
 
+TEST(BackgroundQueueTest, BoostDirectory) {
+  std::string Sequence;
+
+  BackgroundQueue::Task A([&] { Sequence.push_back('A'); });
+  A.Directory = "/near";
+  A.QueuePri = 1;
+
+  BackgroundQueue::Task B([&] { Sequence.push_back('B'); });
+  B.Directory = "/far";
+  B.QueuePri = 2;
+
+  {
+    BackgroundQueue Q;
+    Q.boostDirectory("/near", 3);
+    Q.append({A, B});
+    Q.work([&] { Q.stop(); });
+    EXPECT_EQ("AB", Sequence) << "A was boosted before enqueueing";
+  }
+  Sequence.clear();
+  {
+    BackgroundQueue Q;
+    Q.append({A, B});
+    Q.boostDirectory("/near", 3);
+    Q.work([&] { Q.stop(); });
+    EXPECT_EQ("AB", Sequence) << "A was boosted after enqueueing";
+  }
+}
+
 TEST(BackgroundQueueTest, Duplicates) {
   std::string Sequence;
   BackgroundQueue::Task A([&] { Sequence.push_back('A'); });
@@ -0,0 +1,32 @@
+// RUN: rm -rf %t
+// RUN: mkdir %t
+// RUN: echo "[{\"directory\":\"%/t\",\"command\":\"clang++ -c test.cpp -o test.o\",\"file\":\"test.cpp\"}]" | sed -e 's/\\/\\\\/g' > %t/compile_commands.json
+// RUN: echo "Checks: '-*,modernize-use-auto'" > %t/.clang-tidy
+// RUN: echo "#define VALUE 1" > %t/value.h
+// RUN: cp "%s" "%t/test.cpp"
+// RUN: cd "%t"
+
+// The first run records the output and the files the translation unit
+// includes, in a cache directory relative to the working directory.
+// RUN: %run_clang_tidy -clang-binary %clang -cache-dir cache "test.cpp" | FileCheck %s
+// RUN: cat cache/*.json | FileCheck %s --check-prefix=ENTRY
+// CHECK: warning: use auto when initializing with new
+// ENTRY: value.h
+
+// Mark the cached output to tell a replay from a run.
+// RUN: %python -c "import glob, pathlib; [p.write_text(p.read_text().replace('\"output\": \"', '\"output\": \"CACHED ')) for p in map(pathlib.Path, glob.glob('cache/*.json'))]"
+// RUN: %run_clang_tidy -clang-binary %clang -cache-dir cache "test.cpp" | FileCheck %s --check-prefix=HIT
+// HIT: CACHED
+
+// Changing an included header invalidates the entry.
+// RUN: echo "#define VALUE 2" > value.h
+// RUN: %run_clang_tidy -clang-binary %clang -cache-dir cache "test.cpp" | FileCheck %s --check-prefix=MISS
+// MISS-NOT: CACHED
+// MISS: warning: use auto when initializing with new
+
+#include "value.h"
+
+int *f() {
+  int *p = new int(VALUE);
+  return p;
+}
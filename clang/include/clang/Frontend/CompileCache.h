@@ -0,0 +1,79 @@
+//===--- CompileCache.h - Local cache of compilation results ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Implements -fcompile-cache=<dir>, which lets the frontend reuse the outputs
+// of an earlier identical compilation instead of running it again.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_FRONTEND_COMPILECACHE_H
+#define LLVM_CLANG_FRONTEND_COMPILECACHE_H
+
+#include "clang/Basic/LLVM.h"
+#include <memory>
+#include <string>
+
+namespace clang {
+
+class CompilerInstance;
+class DependencyCollector;
+
+/// A cache of compilation results stored in a local directory.
+///
+/// Lookups do not need to preprocess the input. The cache key is computed
+/// from the canonical -cc1 command line (without the output paths), the
+/// working directory, the compiler version and the contents of the main file.
+/// It selects a manifest that records the content hash of every file the
+/// compilation read. If all of those files are unchanged, the cached object
+/// file, dependency file and diagnostics are replayed.
+///
+/// Compilations whose results depend on inputs the manifest cannot describe
+/// are not cached. This includes modules, precompiled headers, offloading,
+/// plugins, extra output files, and sources that expand __DATE__ or
+/// __TIME__. Like other direct-mode caches, this cache does not notice when a
+/// new header shadows one that was found later in the include path.
+/// __has_include probes and failed header lookups are not recorded either, so
+/// adding a header that an earlier compilation probed for or failed to find
+/// does not invalidate its entry.
+class CompileCache {
+public:
+  ~CompileCache();
+
+  /// Returns a cache for the compilation described by \p CI, or null if
+  /// -fcompile-cache was not given or the compilation cannot be cached.
+  static std::unique_ptr<CompileCache> create(CompilerInstance &CI);
+
+  /// Tries to satisfy the compilation from the cache. Returns true if the
+  /// cached outputs were written and the cached diagnostics were replayed.
+  bool replay();
+
+  /// Prepares \p CI to record the files read and the diagnostics emitted by
+  /// the compilation. Must be called before the frontend action runs.
+  void startRecording();
+
+  /// Adds the outputs of a successful compilation to the cache. Failures to
+  /// update the cache are silently ignored.
+  void store();
+
+private:
+  class DiagnosticRecorder;
+
+  CompileCache(CompilerInstance &CI, std::string Dir, std::string Key);
+
+  std::string getPath(StringRef FileName) const;
+
+  CompilerInstance &CI;
+  std::string Dir;
+  std::string Key;
+  std::shared_ptr<DependencyCollector> Dependencies;
+  DiagnosticRecorder *Recorder = nullptr;
+};
+
+} // namespace clang
+
+#endif // LLVM_CLANG_FRONTEND_COMPILECACHE_H
@@ -582,6 +582,10 @@ public:
   /// Output Path for module output file.
   std::string ModuleOutputPath;
 
+  /// Directory used to cache the outputs of compilations
+  /// (-fcompile-cache=).
+  std::string CompileCacheDir;
+
 public:
   FrontendOptions()
       : DisableFree(false), RelocatablePCH(false), ShowHelp(false),
@@ -271,6 +271,18 @@ public:
   LLVM_PREFERRED_TYPE(bool)
   unsigned ModulesIncludeVFSUsage : 1;
 
+  /// Whether identifiers of C++ AST files are only brought into the identifier
+  /// table when they are first referenced, as is done for C. Name lookups that
+  /// miss the identifier table then go through the on-disk hash tables of the
+  /// loaded AST files.
+  LLVM_PREFERRED_TYPE(bool)
+  unsigned ModulesLazyLoadIdentifiers : 1;
+
+  /// Whether the embedded source buffers of written AST files are compressed
+  /// on multiple threads.
+  LLVM_PREFERRED_TYPE(bool)
+  unsigned ModulesParallelWrite : 1;
+
   HeaderSearchOptions(StringRef _Sysroot = "/")
       : Sysroot(_Sysroot), ModuleFormat("raw"), DisableModuleHash(false),
         ImplicitModuleMaps(false), ModuleMapFileHomeIsCwd(false),
@@ -286,7 +298,8 @@ public:
         ModulesSkipHeaderSearchPaths(false),
         ModulesSkipPragmaDiagnosticMappings(false),
         ModulesPruneNonAffectingModuleMaps(true), ModulesHashContent(false),
-        ModulesStrictContextHash(false), ModulesIncludeVFSUsage(false) {}
+        ModulesStrictContextHash(false), ModulesIncludeVFSUsage(false),
+        ModulesLazyLoadIdentifiers(false), ModulesParallelWrite(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
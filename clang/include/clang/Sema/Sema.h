@@ -8798,6 +8798,22 @@ public:
   /// The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// The number of SFINAE traps that are currently active.
+  unsigned NumActiveSFINAETraps = 0;
+
+  /// The number of outermost SFINAE traps that trapped an error, and the
+  /// number of bytes allocated in the AST context while they were active.
+  /// Nodes created for a failed substitution cannot be released since they may
+  /// already be uniqued or referenced elsewhere, so this measures how much of
+  /// the AST is likely dead.
+  unsigned NumFailedSFINAETraps = 0;
+  uint64_t NumBytesAllocatedInFailedSFINAE = 0;
+
+  /// The number of function and variable definitions instantiated by
+  /// \c PerformPendingInstantiations.
+  unsigned NumPendingFunctionInstantiations = 0;
+  unsigned NumPendingVariableInstantiations = 0;
+
   ArrayRef<sema::FunctionScopeInfo *> getFunctionScopes() const {
     return llvm::ArrayRef(FunctionScopes.begin() + FunctionScopesStart,
                           FunctionScopes.end());
@@ -9509,6 +9525,7 @@ public:
     bool PrevInNonInstantiationSFINAEContext;
     bool PrevAccessCheckingSFINAE;
     bool PrevLastDiagnosticIgnored;
+    size_t PrevASTBytesAllocated;
 
   public:
     explicit SFINAETrap(Sema &SemaRef, bool AccessCheckingSFINAE = false)
@@ -9517,13 +9534,22 @@ public:
               SemaRef.InNonInstantiationSFINAEContext),
           PrevAccessCheckingSFINAE(SemaRef.AccessCheckingSFINAE),
           PrevLastDiagnosticIgnored(
-              SemaRef.getDiagnostics().isLastDiagnosticIgnored()) {
+              SemaRef.getDiagnostics().isLastDiagnosticIgnored()),
+          PrevASTBytesAllocated(
+              SemaRef.Context.getAllocator().getBytesAllocated()) {
       if (!SemaRef.isSFINAEContext())
         SemaRef.InNonInstantiationSFINAEContext = true;
       SemaRef.AccessCheckingSFINAE = AccessCheckingSFINAE;
+      ++SemaRef.NumActiveSFINAETraps;
     }
 
     ~SFINAETrap() {
+      if (--SemaRef.NumActiveSFINAETraps == 0 && hasErrorOccurred()) {
+        ++SemaRef.NumFailedSFINAETraps;
+        SemaRef.NumBytesAllocatedInFailedSFINAE +=
+            SemaRef.Context.getAllocator().getBytesAllocated() -
+            PrevASTBytesAllocated;
+      }
       SemaRef.NumSFINAEErrors = PrevSFINAEErrors;
       SemaRef.InNonInstantiationSFINAEContext =
           PrevInNonInstantiationSFINAEContext;
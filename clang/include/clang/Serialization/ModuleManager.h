@@ -25,6 +25,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/iterator.h"
 #include "llvm/ADT/iterator_range.h"
+#include "llvm/Support/ErrorOr.h"
 #include <cstdint>
 #include <ctime>
 #include <memory>
@@ -77,6 +78,10 @@ class ModuleManager {
   llvm::DenseMap<const FileEntry *, std::unique_ptr<llvm::MemoryBuffer>>
       InMemoryBuffers;
 
+  /// Content hashes of the input files validated so far, so that an input
+  /// listed by many module files is only read and hashed once.
+  llvm::DenseMap<const FileEntry *, uint64_t> InputFileContentHashes;
+
   /// The visitation order.
   SmallVector<ModuleFile *, 4> VisitOrder;
 
@@ -254,6 +259,10 @@ public:
   void addInMemoryBuffer(StringRef FileName,
                          std::unique_ptr<llvm::MemoryBuffer> Buffer);
 
+  /// Returns the hash of the contents of \p File as stored for the input
+  /// files of AST files.
+  llvm::ErrorOr<uint64_t> getInputFileContentHash(FileEntryRef File);
+
   /// Set the global module index.
   void setGlobalIndex(GlobalModuleIndex *Index);
 
@@ -16,6 +16,7 @@
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include <atomic>
 #include <mutex>
 #include <optional>
 
@@ -144,6 +145,84 @@ private:
 
 using CachedRealPath = llvm::ErrorOr<std::string>;
 
+/// An on-disk cache of scanned preprocessor directives that outlives a single
+/// scanning process.
+///
+/// Entries are keyed by the unique ID, modification time and size of the file,
+/// so a file only needs to be stat'ed to reuse its directive tokens. The cache
+/// file is memory mapped when the cache is created and rewritten with the newly
+/// recorded entries when it is destroyed.
+///
+/// When the file is rewritten, entries of files that were recorded again with a
+/// different modification time or size are dropped, since they can no longer
+/// match. If more than \c MaxEntries entries remain, the entries that were not
+/// looked up by this process are dropped first.
+class DependencyDirectivesPersistentCache {
+public:
+  /// The default limit on the number of entries kept in the cache file.
+  static constexpr size_t DefaultMaxEntries = 1 << 16;
+
+  /// Maps the cache file at \p Path if it exists. Missing or malformed cache
+  /// files are treated as empty.
+  explicit DependencyDirectivesPersistentCache(
+      StringRef Path, size_t MaxEntries = DefaultMaxEntries);
+
+  /// Writes the cache back to disk if any entries were recorded.
+  ~DependencyDirectivesPersistentCache();
+
+  /// Fills \p Tokens and \p Directives from the cache entry matching \p Stat.
+  /// The directives refer to the tokens in \p Tokens.
+  ///
+  /// \returns True if a matching and well-formed entry was found.
+  bool lookup(const llvm::vfs::Status &Stat,
+              SmallVectorImpl<dependency_directives_scan::Token> &Tokens,
+              SmallVectorImpl<dependency_directives_scan::Directive>
+                  &Directives) const;
+
+  /// Records the scanned directives of the file with the status \p Stat.
+  void insert(const llvm::vfs::Status &Stat,
+              ArrayRef<dependency_directives_scan::Directive> Directives);
+
+private:
+  /// Device, inode, modification time and size of a file.
+  using KeyTy = std::tuple<uint64_t, uint64_t, uint64_t, uint64_t>;
+
+  static KeyTy getKey(const llvm::vfs::Status &Stat);
+
+  /// Parses the entry table of \c Buffer and fills \c MappedEntries.
+  bool readMappedEntries();
+
+  /// Writes all mapped and recorded entries to \c Path.
+  void write() const;
+
+  std::string Path;
+
+  /// The number of entries \c write() keeps at most.
+  size_t MaxEntries;
+
+  /// The mapped contents of the cache file, if it existed.
+  std::unique_ptr<llvm::MemoryBuffer> Buffer;
+
+  struct MappedEntry {
+    /// The serialized entry in \c Buffer.
+    StringRef Data;
+    /// The index of the entry in \c MappedEntryUsed.
+    unsigned Index;
+  };
+
+  /// Entries found in \c Buffer. Immutable after construction.
+  llvm::DenseMap<KeyTy, MappedEntry> MappedEntries;
+
+  /// Whether each of \c MappedEntries was looked up by this process.
+  std::unique_ptr<std::atomic<bool>[]> MappedEntryUsed;
+
+  /// The mutex that must be locked before accessing \c NewEntries.
+  mutable std::mutex Lock;
+
+  /// Serialized entries recorded by this process.
+  llvm::DenseMap<KeyTy, std::string> NewEntries;
+};
+
 /// This class is a shared cache, that caches the 'stat' and 'open' calls to the
 /// underlying real file system, and the scanned preprocessor directives of
 /// files.
@@ -220,9 +299,34 @@ public:
   CacheShard &getShardForFilename(StringRef Filename) const;
   CacheShard &getShardForUID(llvm::sys::fs::UniqueID UID) const;
 
+  /// Forgets the cached entry and real path of \p Filename, so that the next
+  /// lookup goes to the underlying filesystem again. Other filenames that share
+  /// the entry (e.g. symlinks) keep referring to the old one.
+  ///
+  /// The storage of the dropped entry is only reclaimed with the cache, so this
+  /// is safe to call while worker filesystems still refer to the entry.
+  void invalidateFilename(StringRef Filename);
+
+  /// Forgets every cached entry and real path.
+  ///
+  /// Must not be called while any worker filesystem uses this cache.
+  void invalidateAll();
+
+  /// Backs the scanned directives with the on-disk cache at \p Path.
+  void enablePersistentCache(StringRef Path) {
+    PersistentCache =
+        std::make_unique<DependencyDirectivesPersistentCache>(Path);
+  }
+
+  /// Returns the on-disk directives cache or nullptr if none is enabled.
+  DependencyDirectivesPersistentCache *getPersistentCache() const {
+    return PersistentCache.get();
+  }
+
 private:
   std::unique_ptr<CacheShard[]> CacheShards;
   unsigned NumShards;
+  std::unique_ptr<DependencyDirectivesPersistentCache> PersistentCache;
 };
 
 /// This class is a local cache, that caches the 'stat' and 'open' calls to the
@@ -61,6 +61,7 @@
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/ModuleSlotTracker.h"
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/ProfileData/SampleProf.h"
@@ -1393,6 +1394,41 @@ void CodeGenModule::Release() {
   // that might affect the DLL storage class or the visibility, and
   // before anything that might act on these.
   setVisibilityFromDLLStorageClass(LangOpts, getModule());
+
+  // This has to see the final IR of every function, so it comes last.
+  if (CodeGenOpts.EmitFunctionBodyHashes)
+    EmitFunctionBodyHashes();
+}
+
+void CodeGenModule::EmitFunctionBodyHashes() {
+  // Hash the printed IR of each definition, which covers everything codegen
+  // decided for it, including the layout of the types it uses. Attribute
+  // groups are only printed as #N, so their contents are added separately.
+  llvm::ModuleSlotTracker MST(&getModule());
+  SmallVector<std::pair<llvm::Function *, uint64_t>, 0> Hashes;
+  for (llvm::Function &F : getModule()) {
+    if (F.isDeclaration())
+      continue;
+    std::string Text;
+    llvm::raw_string_ostream OS(Text);
+    static_cast<const llvm::Value &>(F).print(OS, MST);
+    auto PrintAttrs = [&](const llvm::AttributeList &Attrs) {
+      for (unsigned Index : Attrs.indexes())
+        OS << ' ' << Index << '=' << Attrs.getAsString(Index);
+      OS << '\n';
+    };
+    PrintAttrs(F.getAttributes());
+    for (const llvm::BasicBlock &BB : F)
+      for (const llvm::Instruction &I : BB)
+        if (const auto *CB = dyn_cast<llvm::CallBase>(&I))
+          PrintAttrs(CB->getAttributes());
+    Hashes.emplace_back(&F, llvm::xxh3_64bits(Text));
+  }
+  // Only add the attributes once all functions are hashed, so that no hash
+  // depends on the order of the functions in the module.
+  for (auto [F, Hash] : Hashes)
+    F->addFnAttr("clang-body-hash", llvm::utohexstr(Hash, /*LowerCase=*/true,
+                                                    /*Width=*/16));
 }
 
 void CodeGenModule::EmitOpenCLMetadata() {
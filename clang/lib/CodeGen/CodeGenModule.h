@@ -1747,6 +1747,10 @@ private:
   /// the backend to LLVM.
   void EmitBackendOptionsMetadata(const CodeGenOptions &CodeGenOpts);
 
+  /// Attach a hash of its emitted IR to each function definition, for
+  /// -emit-function-body-hashes.
+  void EmitFunctionBodyHashes();
+
   /// Emits OpenCL specific Metadata e.g. OpenCL version.
   void EmitOpenCLMetadata();
 
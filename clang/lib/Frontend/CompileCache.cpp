@@ -0,0 +1,398 @@
+//===--- CompileCache.cpp - Local cache of compilation results ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The cache directory holds two kinds of entries. A manifest, named after the
+// key computed from the invocation, lists the content hash and path of every
+// file read by the compilation. The results of the compilation are named after
+// a second key that combines the first one with the manifest. They are an
+// object file, an optional dependency file, and the rendered diagnostics
+// together with the number of warnings.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/CompileCache.h"
+#include "clang/Basic/Version.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendDiagnostic.h"
+#include "clang/Frontend/TextDiagnosticPrinter.h"
+#include "clang/Frontend/Utils.h"
+#include "clang/Lex/PreprocessorOptions.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+/// Forwards diagnostics to the consumer that was installed before, and also
+/// renders them into a buffer the way a text diagnostic printer would.
+class CompileCache::DiagnosticRecorder : public DiagnosticConsumer {
+public:
+  DiagnosticRecorder(DiagnosticConsumer *Primary,
+                     std::unique_ptr<DiagnosticConsumer> OwningPrimary,
+                     DiagnosticOptions &DiagOpts)
+      : OwningPrimary(std::move(OwningPrimary)), Primary(Primary), OS(Text),
+        Printer(OS, &DiagOpts) {
+    // Keep counting where the previous consumer left off, so that the summary
+    // printed at the end of the compilation stays the same.
+    NumWarnings = InitialNumWarnings = Primary->getNumWarnings();
+    NumErrors = Primary->getNumErrors();
+    OS.enable_colors(DiagOpts.ShowColors);
+  }
+
+  void BeginSourceFile(const LangOptions &LangOpts,
+                       const Preprocessor *PP) override {
+    Primary->BeginSourceFile(LangOpts, PP);
+    Printer.BeginSourceFile(LangOpts, PP);
+  }
+
+  void EndSourceFile() override {
+    Printer.EndSourceFile();
+    Primary->EndSourceFile();
+  }
+
+  void finish() override {
+    Printer.finish();
+    Primary->finish();
+  }
+
+  bool IncludeInDiagnosticCounts() const override {
+    return Primary->IncludeInDiagnosticCounts();
+  }
+
+  void HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
+                        const Diagnostic &Info) override {
+    DiagnosticConsumer::HandleDiagnostic(DiagLevel, Info);
+    Primary->HandleDiagnostic(DiagLevel, Info);
+    Printer.HandleDiagnostic(DiagLevel, Info);
+  }
+
+  StringRef getText() const { return Text; }
+
+  unsigned getNumRecordedWarnings() const {
+    return NumWarnings - InitialNumWarnings;
+  }
+
+private:
+  std::unique_ptr<DiagnosticConsumer> OwningPrimary;
+  DiagnosticConsumer *Primary;
+  std::string Text;
+  llvm::raw_string_ostream OS;
+  TextDiagnosticPrinter Printer;
+  unsigned InitialNumWarnings;
+};
+
+namespace {
+/// Records every file read by the compilation, including system headers.
+class CacheDependencyCollector : public DependencyCollector {
+  bool needSystemDependencies() override { return true; }
+
+  bool sawDependency(StringRef Filename, bool FromModule, bool IsSystem,
+                     bool IsModuleFile, bool IsMissing) override {
+    return !IsMissing &&
+           DependencyCollector::sawDependency(Filename, FromModule, IsSystem,
+                                              IsModuleFile, IsMissing);
+  }
+};
+} // namespace
+
+static bool isCacheable(const CompilerInvocation &Invocation) {
+  const FrontendOptions &FEOpts = Invocation.getFrontendOpts();
+  switch (FEOpts.ProgramAction) {
+  case frontend::EmitAssembly:
+  case frontend::EmitBC:
+  case frontend::EmitLLVM:
+  case frontend::EmitObj:
+    break;
+  default:
+    return false;
+  }
+  if (FEOpts.Inputs.size() != 1 || !FEOpts.Inputs[0].isFile() ||
+      FEOpts.Inputs[0].getFile() == "-" || FEOpts.OutputFile.empty() ||
+      FEOpts.OutputFile == "-")
+    return false;
+  if (!FEOpts.Plugins.empty() || !FEOpts.AddPluginActions.empty() ||
+      !FEOpts.ASTMergeFiles.empty() || !FEOpts.ModuleFiles.empty() ||
+      !FEOpts.ModuleMapFiles.empty() || !FEOpts.ModuleOutputPath.empty() ||
+      FEOpts.ShowStats || !FEOpts.StatsFile.empty() ||
+      !FEOpts.TimeTracePath.empty())
+    return false;
+
+  const LangOptions &LangOpts = Invocation.getLangOpts();
+  if (LangOpts.Modules || LangOpts.CUDA || LangOpts.HIP ||
+      LangOpts.OpenMPIsTargetDevice)
+    return false;
+
+  const HeaderSearchOptions &HSOpts = Invocation.getHeaderSearchOpts();
+  if (!Invocation.getPreprocessorOpts().ImplicitPCHInclude.empty() ||
+      !HSOpts.PrebuiltModuleFiles.empty() || !HSOpts.VFSOverlayFiles.empty() ||
+      !Invocation.getFileSystemOpts().WorkingDir.empty())
+    return false;
+
+  const CodeGenOptions &CGOpts = Invocation.getCodeGenOpts();
+  if (CGOpts.TimePasses || !CGOpts.SplitDwarfFile.empty() ||
+      !CGOpts.OptRecordFile.empty() || !CGOpts.CoverageNotesFile.empty() ||
+      !CGOpts.StackUsageOutput.empty() || !CGOpts.OffloadObjects.empty())
+    return false;
+
+  const DependencyOutputOptions &DepOpts =
+      Invocation.getDependencyOutputOpts();
+  if (DepOpts.ShowHeaderIncludes || !DepOpts.HeaderIncludeOutputFile.empty() ||
+      !DepOpts.DOTOutputFile.empty())
+    return false;
+
+  const DiagnosticOptions &DiagOpts = Invocation.getDiagnosticOpts();
+  return !DiagOpts.VerifyDiagnostics &&
+         DiagOpts.getFormat() != DiagnosticOptions::SARIF &&
+         DiagOpts.DiagnosticLogFile.empty() &&
+         DiagOpts.DiagnosticSerializationFile.empty();
+}
+
+/// Returns the files that affect the output of the compilation but are not
+/// read through the preprocessor.
+static std::vector<std::string>
+getExtraInputs(const CompilerInvocation &Invocation) {
+  std::vector<std::string> Inputs;
+  for (const auto &Dep : Invocation.getDependencyOutputOpts().ExtraDeps)
+    Inputs.push_back(Dep.first);
+
+  const LangOptions &LangOpts = Invocation.getLangOpts();
+  for (const std::vector<std::string> *Files :
+       {&LangOpts.NoSanitizeFiles, &LangOpts.XRayAlwaysInstrumentFiles,
+        &LangOpts.XRayNeverInstrumentFiles, &LangOpts.XRayAttrListFiles,
+        &LangOpts.ProfileListFiles})
+    llvm::append_range(Inputs, *Files);
+
+  const CodeGenOptions &CGOpts = Invocation.getCodeGenOpts();
+  for (const std::string *File :
+       {&CGOpts.SampleProfileFile, &CGOpts.MemoryProfileUsePath,
+        &CGOpts.ProfileInstrumentUsePath, &CGOpts.ProfileRemappingFile,
+        &CGOpts.ThinLTOIndexFile})
+    if (!File->empty())
+      Inputs.push_back(*File);
+  for (const CodeGenOptions::BitcodeFileToLink &F : CGOpts.LinkBitcodeFiles)
+    Inputs.push_back(F.Filename);
+  return Inputs;
+}
+
+/// Returns whether \p Text may use one of the macros that expand differently
+/// every time a file is compiled.
+static bool mentionsTimestampMacro(StringRef Text) {
+  return Text.contains("__DATE__") || Text.contains("__TIME__") ||
+         Text.contains("__TIMESTAMP__");
+}
+
+static std::string toKey(llvm::BLAKE3 &Hasher) {
+  return llvm::toHex(Hasher.final<16>(), /*LowerCase=*/true);
+}
+
+static std::string hashContents(StringRef Contents) {
+  llvm::BLAKE3 Hasher;
+  Hasher.update(Contents);
+  return toKey(Hasher);
+}
+
+static std::string getResultKey(StringRef Key, StringRef Manifest) {
+  llvm::BLAKE3 Hasher;
+  Hasher.update(Key);
+  Hasher.update(Manifest);
+  return toKey(Hasher);
+}
+
+static std::unique_ptr<llvm::MemoryBuffer> readFile(const Twine &Path) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+      llvm::MemoryBuffer::getFile(Path, /*IsText=*/false,
+                                  /*RequiresNullTerminator=*/false);
+  return Buffer ? std::move(*Buffer) : nullptr;
+}
+
+/// Atomically replaces \p Path with \p Contents. Returns false on failure.
+static bool writeFile(StringRef Path, StringRef Contents) {
+  if (llvm::Error E = llvm::writeToOutput(Path, [&](raw_ostream &OS) {
+        OS << Contents;
+        return llvm::Error::success();
+      })) {
+    llvm::consumeError(std::move(E));
+    return false;
+  }
+  return true;
+}
+
+CompileCache::CompileCache(CompilerInstance &CI, std::string Dir,
+                           std::string Key)
+    : CI(CI), Dir(std::move(Dir)), Key(std::move(Key)) {}
+
+CompileCache::~CompileCache() = default;
+
+std::unique_ptr<CompileCache> CompileCache::create(CompilerInstance &CI) {
+  const CompilerInvocation &Invocation = CI.getInvocation();
+  StringRef Dir = Invocation.getFrontendOpts().CompileCacheDir;
+  if (Dir.empty() || !isCacheable(Invocation))
+    return nullptr;
+
+  std::unique_ptr<llvm::MemoryBuffer> MainFile =
+      readFile(Invocation.getFrontendOpts().Inputs[0].getFile());
+  SmallString<256> WorkingDir;
+  if (!MainFile || llvm::sys::fs::current_path(WorkingDir))
+    return nullptr;
+
+  // Paths of the output files are not part of the key, but options that embed
+  // them, such as the targets of the dependency file, still are.
+  CompilerInvocation Canonical(Invocation);
+  Canonical.getFrontendOpts().OutputFile.clear();
+  Canonical.getFrontendOpts().CompileCacheDir.clear();
+  Canonical.getDependencyOutputOpts().OutputFile.clear();
+
+  // Every field is terminated so that adjacent fields cannot be confused.
+  llvm::BLAKE3 Hasher;
+  auto AddField = [&Hasher](StringRef Field) {
+    Hasher.update(Field);
+    Hasher.update(StringRef("\0", 1));
+  };
+  AddField(getClangFullVersion());
+  AddField(WorkingDir);
+  for (const std::string &Arg : Canonical.getCC1CommandLine()) {
+    if (mentionsTimestampMacro(Arg))
+      return nullptr;
+    AddField(Arg);
+  }
+  AddField(MainFile->getBuffer());
+
+  return std::unique_ptr<CompileCache>(
+      new CompileCache(CI, Dir.str(), toKey(Hasher)));
+}
+
+std::string CompileCache::getPath(StringRef FileName) const {
+  SmallString<256> Path(Dir);
+  llvm::sys::path::append(Path, FileName);
+  return std::string(Path);
+}
+
+bool CompileCache::replay() {
+  std::unique_ptr<llvm::MemoryBuffer> Manifest =
+      readFile(getPath(Key + ".manifest"));
+  if (!Manifest)
+    return false;
+
+  // Each line holds the hash of a file's contents followed by its path.
+  SmallVector<StringRef, 64> Lines;
+  Manifest->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                              /*KeepEmpty=*/false);
+  if (Lines.empty())
+    return false;
+  for (StringRef Line : Lines) {
+    auto [Hash, Path] = Line.split(' ');
+    std::unique_ptr<llvm::MemoryBuffer> Buffer = readFile(Path);
+    if (!Buffer || hashContents(Buffer->getBuffer()) != Hash)
+      return false;
+  }
+
+  std::string ResultKey = getResultKey(Key, Manifest->getBuffer());
+  std::unique_ptr<llvm::MemoryBuffer> Object =
+      readFile(getPath(ResultKey + ".out"));
+  std::unique_ptr<llvm::MemoryBuffer> Diagnostics =
+      readFile(getPath(ResultKey + ".diag"));
+  if (!Object || !Diagnostics)
+    return false;
+  const std::string &DepFile = CI.getDependencyOutputOpts().OutputFile;
+  std::unique_ptr<llvm::MemoryBuffer> Deps;
+  if (!DepFile.empty() && !(Deps = readFile(getPath(ResultKey + ".d"))))
+    return false;
+
+  auto [Count, Text] = Diagnostics->getBuffer().split('\n');
+  unsigned NumWarnings;
+  if (Count.getAsInteger(10, NumWarnings))
+    return false;
+
+  if (!writeFile(CI.getFrontendOpts().OutputFile, Object->getBuffer()) ||
+      (Deps && !writeFile(DepFile, Deps->getBuffer())))
+    return false;
+
+  DiagnosticsEngine &Diags = CI.getDiagnostics();
+  Diags.Report(diag::remark_compile_cache_hit)
+      << CI.getFrontendOpts().Inputs[0].getFile();
+  llvm::errs() << Text;
+
+  // Mirror the summary that CompilerInstance prints after the compilation.
+  NumWarnings += Diags.getClient()->getNumWarnings();
+  if (NumWarnings && CI.getDiagnosticOpts().ShowCarets)
+    CI.getVerboseOutputStream() << NumWarnings << " warning"
+                                << (NumWarnings == 1 ? "" : "s")
+                                << " generated.\n";
+  return true;
+}
+
+void CompileCache::startRecording() {
+  DiagnosticsEngine &Diags = CI.getDiagnostics();
+  Diags.Report(diag::remark_compile_cache_miss)
+      << CI.getFrontendOpts().Inputs[0].getFile();
+
+  Dependencies = std::make_shared<CacheDependencyCollector>();
+  CI.addDependencyCollector(Dependencies);
+
+  DiagnosticConsumer *Client = Diags.getClient();
+  std::unique_ptr<DiagnosticConsumer> Owner = Diags.takeClient();
+  Recorder =
+      new DiagnosticRecorder(Client, std::move(Owner), CI.getDiagnosticOpts());
+  Diags.setClient(Recorder, /*ShouldOwnClient=*/true);
+}
+
+void CompileCache::store() {
+  if (!Recorder || Recorder->getNumErrors())
+    return;
+
+  std::vector<std::string> Inputs(Dependencies->getDependencies().begin(),
+                                  Dependencies->getDependencies().end());
+  llvm::append_range(Inputs, getExtraInputs(CI.getInvocation()));
+
+  std::string Manifest;
+  llvm::StringSet<> Seen;
+  for (const std::string &Input : Inputs) {
+    if (!Seen.insert(Input).second)
+      continue;
+    if (StringRef(Input).contains('\n'))
+      return;
+    std::unique_ptr<llvm::MemoryBuffer> Buffer = readFile(Input);
+    if (!Buffer)
+      return;
+    StringRef Contents = Buffer->getBuffer();
+    if (mentionsTimestampMacro(Contents))
+      return;
+    Manifest += hashContents(Contents);
+    Manifest += ' ';
+    Manifest += Input;
+    Manifest += '\n';
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> Object =
+      readFile(CI.getFrontendOpts().OutputFile);
+  if (!Object)
+    return;
+  const std::string &DepFile = CI.getDependencyOutputOpts().OutputFile;
+  std::unique_ptr<llvm::MemoryBuffer> Deps;
+  if (!DepFile.empty() && !(Deps = readFile(DepFile)))
+    return;
+
+  if (llvm::sys::fs::create_directories(Dir))
+    return;
+
+  // Write the manifest last, so that concurrent lookups never find a manifest
+  // whose results are incomplete.
+  std::string ResultKey = getResultKey(Key, Manifest);
+  std::string Diagnostics =
+      (Twine(Recorder->getNumRecordedWarnings()) + "\n" + Recorder->getText())
+          .str();
+  if (!writeFile(getPath(ResultKey + ".out"), Object->getBuffer()) ||
+      (Deps && !writeFile(getPath(ResultKey + ".d"), Deps->getBuffer())) ||
+      !writeFile(getPath(ResultKey + ".diag"), Diagnostics))
+    return;
+  writeFile(getPath(Key + ".manifest"), Manifest);
+}
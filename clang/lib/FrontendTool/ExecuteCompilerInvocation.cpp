@@ -16,6 +16,7 @@
 #include "clang/Config/config.h"
 #include "clang/Driver/Options.h"
 #include "clang/ExtractAPI/FrontendActions.h"
+#include "clang/Frontend/CompileCache.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/CompilerInvocation.h"
 #include "clang/Frontend/FrontendActions.h"
@@ -273,11 +274,22 @@ bool ExecuteCompilerInvocation(CompilerInstance *Clang) {
   // If there were errors in processing arguments, don't do anything else.
   if (Clang->getDiagnostics().hasErrorOccurred())
     return false;
+
+  // Honor -fcompile-cache.
+  std::unique_ptr<CompileCache> Cache = CompileCache::create(*Clang);
+  if (Cache) {
+    if (Cache->replay())
+      return true;
+    Cache->startRecording();
+  }
+
   // Create and execute the frontend action.
   std::unique_ptr<FrontendAction> Act(CreateFrontendAction(*Clang));
   if (!Act)
     return false;
   bool Success = Clang->ExecuteAction(*Act);
+  if (Success && Cache)
+    Cache->store();
   if (Clang->getFrontendOpts().DisableFree)
     llvm::BuryPointer(std::move(Act));
   return Success;
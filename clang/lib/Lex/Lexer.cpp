@@ -47,6 +47,10 @@
 #include <tuple>
 #include <utility>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #ifdef __SSE4_2__
 #include <nmmintrin.h>
 #endif
@@ -1924,6 +1928,29 @@ fastParseASCIIIdentifier(const char *CurPtr,
       continue;
     return CurPtr;
   }
+#elif defined(__SSE2__)
+  constexpr ssize_t BytesPerRegister = 16;
+
+  while (LLVM_LIKELY(BufferEnd - CurPtr >= BytesPerRegister)) {
+    __m128i Cv = _mm_loadu_si128((const __m128i *)(CurPtr));
+
+    // Setting bit 5 maps 'A'-'Z' onto 'a'-'z' and nothing else onto them.
+    // Non-ASCII bytes are negative and fail the signed range checks.
+    __m128i Lower = _mm_or_si128(Cv, _mm_set1_epi8(0x20));
+    __m128i IsAlpha =
+        _mm_and_si128(_mm_cmpgt_epi8(Lower, _mm_set1_epi8('a' - 1)),
+                      _mm_cmplt_epi8(Lower, _mm_set1_epi8('z' + 1)));
+    __m128i IsDigit = _mm_and_si128(_mm_cmpgt_epi8(Cv, _mm_set1_epi8('0' - 1)),
+                                    _mm_cmplt_epi8(Cv, _mm_set1_epi8('9' + 1)));
+    __m128i IsUnderscore = _mm_cmpeq_epi8(Cv, _mm_set1_epi8('_'));
+    unsigned Mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_or_si128(IsAlpha, IsDigit), IsUnderscore));
+    if (Mask == 0xFFFF) {
+      CurPtr += BytesPerRegister;
+      continue;
+    }
+    return CurPtr + llvm::countr_one(Mask);
+  }
 #endif
 
   unsigned char C = *CurPtr;
@@ -2186,6 +2213,53 @@ const char *Lexer::LexUDSuffix(Token &Result, const char *CurPtr,
   return CurPtr;
 }
 
+/// Skips the characters of a string literal body that need no special
+/// handling, i.e. everything except the closing quote, escapes, newlines, nul
+/// characters and '?' (which may start a trigraph).
+static const char *
+fastSkipStringLiteralBody(const char *CurPtr,
+                          [[maybe_unused]] const char *BufferEnd) {
+#ifdef __SSE2__
+  constexpr ssize_t BytesPerRegister = 16;
+
+  while (LLVM_LIKELY(BufferEnd - CurPtr >= BytesPerRegister)) {
+    __m128i Cv = _mm_loadu_si128((const __m128i *)(CurPtr));
+    __m128i Special =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Cv, _mm_set1_epi8('"')),
+                                  _mm_cmpeq_epi8(Cv, _mm_set1_epi8('\\'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(Cv, _mm_set1_epi8('\n')),
+                                  _mm_cmpeq_epi8(Cv, _mm_set1_epi8('\r'))));
+    Special = _mm_or_si128(
+        Special, _mm_or_si128(_mm_cmpeq_epi8(Cv, _mm_setzero_si128()),
+                              _mm_cmpeq_epi8(Cv, _mm_set1_epi8('?'))));
+    if (unsigned Mask = _mm_movemask_epi8(Special))
+      return CurPtr + llvm::countr_zero(Mask);
+    CurPtr += BytesPerRegister;
+  }
+#endif
+  return CurPtr;
+}
+
+/// Skips the characters of a raw string literal body up to the next ')' or
+/// nul character.
+static const char *
+fastSkipRawStringLiteralBody(const char *CurPtr,
+                             [[maybe_unused]] const char *BufferEnd) {
+#ifdef __SSE2__
+  constexpr ssize_t BytesPerRegister = 16;
+
+  while (LLVM_LIKELY(BufferEnd - CurPtr >= BytesPerRegister)) {
+    __m128i Cv = _mm_loadu_si128((const __m128i *)(CurPtr));
+    __m128i Special = _mm_or_si128(_mm_cmpeq_epi8(Cv, _mm_set1_epi8(')')),
+                                   _mm_cmpeq_epi8(Cv, _mm_setzero_si128()));
+    if (unsigned Mask = _mm_movemask_epi8(Special))
+      return CurPtr + llvm::countr_zero(Mask);
+    CurPtr += BytesPerRegister;
+  }
+#endif
+  return CurPtr;
+}
+
 /// LexStringLiteral - Lex the remainder of a string literal, after having lexed
 /// either " or L" or u8" or u" or U".
 bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
@@ -2201,6 +2275,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
     Diag(BufferPtr, LangOpts.CPlusPlus ? diag::warn_cxx98_compat_unicode_literal
                                        : diag::warn_c99_compat_unicode_literal);
 
+  CurPtr = fastSkipStringLiteralBody(CurPtr, BufferEnd);
   char C = getAndAdvanceChar(CurPtr, Result);
   while (C != '"') {
     // Skip escaped characters.  Escaped newlines will already be processed by
@@ -2229,6 +2304,7 @@ bool Lexer::LexStringLiteral(Token &Result, const char *CurPtr,
 
       NulCharacter = CurPtr-1;
     }
+    CurPtr = fastSkipStringLiteralBody(CurPtr, BufferEnd);
     C = getAndAdvanceChar(CurPtr, Result);
   }
 
@@ -2310,6 +2386,7 @@ bool Lexer::LexRawStringLiteral(Token &Result, const char *CurPtr,
   CurPtr += PrefixLen + 1; // skip over prefix and '('
 
   while (true) {
+    CurPtr = fastSkipRawStringLiteralBody(CurPtr, BufferEnd);
     char C = *CurPtr++;
 
     if (C == ')') {
@@ -2480,6 +2557,30 @@ bool Lexer::LexCharConstant(Token &Result, const char *CurPtr,
   return true;
 }
 
+/// Skips a run of horizontal whitespace, 16 characters at a time. The caller
+/// handles the remainder of the run.
+static const char *
+fastSkipHorizontalWhitespace(const char *CurPtr,
+                             [[maybe_unused]] const char *BufferEnd) {
+#ifdef __SSE2__
+  constexpr ssize_t BytesPerRegister = 16;
+
+  while (LLVM_LIKELY(BufferEnd - CurPtr >= BytesPerRegister)) {
+    __m128i Cv = _mm_loadu_si128((const __m128i *)(CurPtr));
+    __m128i Space =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Cv, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(Cv, _mm_set1_epi8('\t'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(Cv, _mm_set1_epi8('\f')),
+                                  _mm_cmpeq_epi8(Cv, _mm_set1_epi8('\v'))));
+    unsigned Mask = _mm_movemask_epi8(Space);
+    if (Mask != 0xFFFF)
+      return CurPtr + llvm::countr_one(Mask);
+    CurPtr += BytesPerRegister;
+  }
+#endif
+  return CurPtr;
+}
+
 /// SkipWhitespace - Efficiently skip over a series of whitespace characters.
 /// Update BufferPtr to point to the next non-whitespace character and return.
 ///
@@ -2503,6 +2604,10 @@ bool Lexer::SkipWhitespace(Token &Result, const char *CurPtr,
   // Skip consecutive spaces efficiently.
   while (true) {
     // Skip horizontal whitespace very aggressively.
+    if (isHorizontalWhitespace(Char) && isHorizontalWhitespace(CurPtr[1])) {
+      CurPtr = fastSkipHorizontalWhitespace(CurPtr, BufferEnd);
+      Char = *CurPtr;
+    }
     while (isHorizontalWhitespace(Char))
       Char = *++CurPtr;
 
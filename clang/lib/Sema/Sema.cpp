@@ -610,6 +610,13 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumFailedSFINAETraps << " failed SFINAE contexts, "
+               << NumBytesAllocatedInFailedSFINAE
+               << " bytes of AST allocated in them.\n";
+  llvm::errs() << NumPendingFunctionInstantiations
+               << " pending function instantiations performed.\n";
+  llvm::errs() << NumPendingVariableInstantiations
+               << " pending variable instantiations performed.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -6458,6 +6458,7 @@ void Sema::PerformPendingInstantiations(bool LocalOnly) {
 
     // Instantiate function definitions
     if (FunctionDecl *Function = dyn_cast<FunctionDecl>(Inst.first)) {
+      ++NumPendingFunctionInstantiations;
       bool DefinitionRequired = Function->getTemplateSpecializationKind() ==
                                 TSK_ExplicitInstantiationDefinition;
       if (Function->isMultiVersion()) {
@@ -6520,6 +6521,7 @@ void Sema::PerformPendingInstantiations(bool LocalOnly) {
 
     // Instantiate static data member definitions or variable template
     // specializations.
+    ++NumPendingVariableInstantiations;
     InstantiateVariableDefinition(/*FIXME:*/ Inst.second, Var, true,
                                   DefinitionRequired, true);
   }
@@ -2587,8 +2587,9 @@ InputFile ASTReader::getInputFile(ModuleFile &F, unsigned ID, bool Complain) {
     if (StoredContentHash == static_cast<uint64_t>(llvm::hash_code(-1)))
       return OriginalChange;
 
-    auto MemBuffOrError = FileMgr.getBufferForFile(*File);
-    if (!MemBuffOrError) {
+    llvm::ErrorOr<uint64_t> ContentHash =
+        ModuleMgr.getInputFileContentHash(*File);
+    if (!ContentHash) {
       if (!Complain)
         return OriginalChange;
       std::string ErrorStr = "could not get buffer for file '";
@@ -2598,9 +2599,7 @@ InputFile ASTReader::getInputFile(ModuleFile &F, unsigned ID, bool Complain) {
       return OriginalChange;
     }
 
-    // FIXME: hash_value is not guaranteed to be stable!
-    auto ContentHash = hash_value(MemBuffOrError.get()->getBuffer());
-    if (StoredContentHash == static_cast<uint64_t>(ContentHash))
+    if (StoredContentHash == *ContentHash)
       return Change{Change::None};
 
     return Change{Change::Content};
@@ -4495,6 +4494,9 @@ ASTReader::ASTReadResult ASTReader::ReadAST(StringRef FileName, ModuleKind Type,
   }
 
   // Preload source locations and interesting indentifiers.
+  bool LazyLoadIdentifiers =
+      !PP.getLangOpts().CPlusPlus ||
+      PP.getHeaderSearchInfo().getHeaderSearchOpts().ModulesLazyLoadIdentifiers;
   for (ImportedModule &M : Loaded) {
     ModuleFile &F = *M.Mod;
 
@@ -4511,13 +4513,15 @@ ASTReader::ASTReadResult ASTReader::ReadAST(StringRef FileName, ModuleKind Type,
       auto Key = Trait.ReadKey(Data, KeyDataLen.first);
 
       IdentifierInfo *II;
-      if (!PP.getLangOpts().CPlusPlus) {
+      if (LazyLoadIdentifiers) {
         // Identifiers present in both the module file and the importing
         // instance are marked out-of-date so that they can be deserialized
         // on next use via ASTReader::updateOutOfDateIdentifier().
         // Identifiers present in the module file but not in the importing
         // instance are ignored for now, preventing growth of the identifier
         // table. They will be deserialized on first use via ASTReader::get().
+        // This is the default for C, and opt-in for C++ where it trades the
+        // upfront cost for a lookup in every module file on identifier misses.
         auto It = PP.getIdentifierTable().find(Key);
         if (It == PP.getIdentifierTable().end())
           continue;
@@ -101,6 +101,7 @@
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/OnDiskHashTable.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -2208,33 +2209,71 @@ void ASTWriter::WriteHeaderSearch(const HeaderSearch &HS) {
     free(const_cast<char *>(SavedStrings[I]));
 }
 
-static void emitBlob(llvm::BitstreamWriter &Stream, StringRef Blob,
-                     unsigned SLocBufferBlobCompressedAbbrv,
-                     unsigned SLocBufferBlobAbbrv) {
-  using RecordDataType = ASTWriter::RecordData::value_type;
-
-  // Compress the buffer if possible. We expect that almost all PCM
-  // consumers will not want its contents.
+namespace {
+/// The contents of a source buffer embedded into the AST file.
+struct SLocBufferBlob {
+  /// The buffer, including the implicit terminating null character.
+  StringRef Blob;
+  /// The compressed buffer, without the terminating null character.
   SmallVector<uint8_t, 0> CompressedBuffer;
+  bool IsCompressed = false;
+};
+} // namespace
+
+/// Compresses the buffer if possible. We expect that almost all PCM consumers
+/// will not want its contents.
+static void compressBlob(SLocBufferBlob &Blob) {
   if (llvm::compression::zstd::isAvailable()) {
     llvm::compression::zstd::compress(
-        llvm::arrayRefFromStringRef(Blob.drop_back(1)), CompressedBuffer, 9);
-    RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB_COMPRESSED, Blob.size() - 1};
-    Stream.EmitRecordWithBlob(SLocBufferBlobCompressedAbbrv, Record,
-                              llvm::toStringRef(CompressedBuffer));
+        llvm::arrayRefFromStringRef(Blob.Blob.drop_back(1)),
+        Blob.CompressedBuffer, 9);
+    Blob.IsCompressed = true;
     return;
   }
   if (llvm::compression::zlib::isAvailable()) {
     llvm::compression::zlib::compress(
-        llvm::arrayRefFromStringRef(Blob.drop_back(1)), CompressedBuffer);
-    RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB_COMPRESSED, Blob.size() - 1};
+        llvm::arrayRefFromStringRef(Blob.Blob.drop_back(1)),
+        Blob.CompressedBuffer);
+    Blob.IsCompressed = true;
+  }
+}
+
+static void emitBlob(llvm::BitstreamWriter &Stream, const SLocBufferBlob &Blob,
+                     unsigned SLocBufferBlobCompressedAbbrv,
+                     unsigned SLocBufferBlobAbbrv) {
+  using RecordDataType = ASTWriter::RecordData::value_type;
+
+  if (Blob.IsCompressed) {
+    RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB_COMPRESSED,
+                               Blob.Blob.size() - 1};
     Stream.EmitRecordWithBlob(SLocBufferBlobCompressedAbbrv, Record,
-                              llvm::toStringRef(CompressedBuffer));
+                              llvm::toStringRef(Blob.CompressedBuffer));
     return;
   }
 
   RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB};
-  Stream.EmitRecordWithBlob(SLocBufferBlobAbbrv, Record, Blob);
+  Stream.EmitRecordWithBlob(SLocBufferBlobAbbrv, Record, Blob.Blob);
+}
+
+/// Returns the buffer blob of the local source location entry \p I if it gets
+/// embedded into the AST file.
+static std::optional<StringRef>
+getEmbeddedBufferBlob(SourceManager &SourceMgr, const Preprocessor &PP,
+                      unsigned I) {
+  const SrcMgr::SLocEntry &SLoc = SourceMgr.getLocalSLocEntry(I);
+  if (!SLoc.isFile())
+    return std::nullopt;
+  const SrcMgr::ContentCache &Content = SLoc.getFile().getContentCache();
+  if (Content.OrigEntry && !Content.BufferOverridden && !Content.IsTransient)
+    return std::nullopt;
+
+  // Include the implicit terminating null character in the on-disk buffer
+  // if we're writing it uncompressed.
+  std::optional<llvm::MemoryBufferRef> Buffer =
+      Content.getBufferOrNone(PP.getDiagnostics(), PP.getFileManager());
+  if (!Buffer)
+    Buffer = llvm::MemoryBufferRef("<<<INVALID BUFFER>>>", "");
+  return StringRef(Buffer->getBufferStart(), Buffer->getBufferSize() + 1);
 }
 
 /// Writes the block containing the serialized form of the
@@ -2261,6 +2300,26 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
       CreateSLocBufferBlobAbbrev(Stream, true);
   unsigned SLocExpansionAbbrv = CreateSLocExpansionAbbrev(Stream);
 
+  // Collect the embedded buffers and compress them up front, which can be
+  // done in parallel. The buffers are loaded on this thread since that may
+  // emit diagnostics.
+  std::vector<SLocBufferBlob> Blobs;
+  for (unsigned I = 1, N = SourceMgr.local_sloc_entry_size(); I != N; ++I) {
+    if (!IsSLocAffecting[I])
+      continue;
+    if (std::optional<StringRef> Blob =
+            getEmbeddedBufferBlob(SourceMgr, PP, I)) {
+      Blobs.emplace_back();
+      Blobs.back().Blob = *Blob;
+    }
+  }
+  if (PP.getHeaderSearchInfo().getHeaderSearchOpts().ModulesParallelWrite)
+    llvm::parallelFor(0, Blobs.size(),
+                      [&](size_t I) { compressBlob(Blobs[I]); });
+  else
+    llvm::for_each(Blobs, compressBlob);
+  auto NextBlob = Blobs.begin();
+
   // Write out the source location entry table. We skip the first
   // entry, which is always the same dummy entry.
   std::vector<uint32_t> SLocEntryOffsets;
@@ -2343,14 +2402,8 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
       }
 
       if (EmitBlob) {
-        // Include the implicit terminating null character in the on-disk buffer
-        // if we're writing it uncompressed.
-        std::optional<llvm::MemoryBufferRef> Buffer =
-            Content->getBufferOrNone(PP.getDiagnostics(), PP.getFileManager());
-        if (!Buffer)
-          Buffer = llvm::MemoryBufferRef("<<<INVALID BUFFER>>>", "");
-        StringRef Blob(Buffer->getBufferStart(), Buffer->getBufferSize() + 1);
-        emitBlob(Stream, Blob, SLocBufferBlobCompressedAbbrv,
+        assert(NextBlob != Blobs.end() && "Missed embedded buffer");
+        emitBlob(Stream, *NextBlob++, SLocBufferBlobCompressedAbbrv,
                  SLocBufferBlobAbbrv);
       }
     } else {
@@ -20,6 +20,7 @@
 #include "clang/Serialization/InMemoryModuleCache.h"
 #include "clang/Serialization/ModuleFile.h"
 #include "clang/Serialization/PCHContainerOperations.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
@@ -284,6 +285,22 @@ ModuleManager::addInMemoryBuffer(StringRef FileName,
   InMemoryBuffers[Entry] = std::move(Buffer);
 }
 
+llvm::ErrorOr<uint64_t>
+ModuleManager::getInputFileContentHash(FileEntryRef File) {
+  auto Known = InputFileContentHashes.find(File);
+  if (Known != InputFileContentHashes.end())
+    return Known->second;
+
+  auto MemBuffOrError = FileMgr.getBufferForFile(File);
+  if (!MemBuffOrError)
+    return MemBuffOrError.getError();
+
+  // FIXME: hash_value is not guaranteed to be stable!
+  uint64_t ContentHash = hash_value(MemBuffOrError.get()->getBuffer());
+  InputFileContentHashes[File] = ContentHash;
+  return ContentHash;
+}
+
 std::unique_ptr<ModuleManager::VisitState> ModuleManager::allocateVisitState() {
   // Fast path: if we have a cached state, use it.
   if (FirstVisitState) {
@@ -7,6 +7,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/Threading.h"
@@ -62,6 +65,17 @@ bool DependencyScanningWorkerFilesystem::ensureDirectiveTokensArePopulated(
     return true;
 
   SmallVector<dependency_directives_scan::Directive, 64> Directives;
+  // Reuse the directives scanned by an earlier process if the file did not
+  // change since then.
+  auto *PersistentCache = SharedCache.getPersistentCache();
+  if (PersistentCache &&
+      PersistentCache->lookup(Entry.getStatus(), Contents->DepDirectiveTokens,
+                              Directives)) {
+    Contents->DepDirectives.store(
+        new std::optional<DependencyDirectivesTy>(std::move(Directives)));
+    return true;
+  }
+
   // Scan the file for preprocessor directives that might affect the
   // dependencies.
   if (scanSourceForDependencyDirectives(Contents->Original->getBuffer(),
@@ -73,6 +87,9 @@ bool DependencyScanningWorkerFilesystem::ensureDirectiveTokensArePopulated(
     return false;
   }
 
+  if (PersistentCache)
+    PersistentCache->insert(Entry.getStatus(), Directives);
+
   // This function performed double-checked locking using `DepDirectives`.
   // Assigning it must be the last thing this function does, otherwise other
   // threads may skip the critical section (`DepDirectives != nullptr`), leading
@@ -82,6 +99,239 @@ bool DependencyScanningWorkerFilesystem::ensureDirectiveTokensArePopulated(
   return true;
 }
 
+/// Identifies the on-disk format of the persistent directives cache. Bump the
+/// version whenever the layout or the scanner output changes.
+static constexpr char PersistentCacheMagic[4] = {'C', 'S', 'D', 'C'};
+static constexpr uint32_t PersistentCacheVersion = 1;
+
+/// Sizes of the serialized key, entry header, token and directive.
+static constexpr size_t PersistentKeySize = 4 * sizeof(uint64_t);
+static constexpr size_t PersistentEntryHeaderSize = 2 * sizeof(uint32_t);
+static constexpr size_t PersistentTokenSize =
+    2 * sizeof(uint32_t) + 2 * sizeof(uint16_t);
+static constexpr size_t PersistentDirectiveSize = 2 * sizeof(uint32_t);
+
+DependencyDirectivesPersistentCache::DependencyDirectivesPersistentCache(
+    StringRef Path, size_t MaxEntries)
+    : Path(Path.str()), MaxEntries(MaxEntries) {
+  auto MaybeBuffer = llvm::MemoryBuffer::getFile(
+      Path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!MaybeBuffer)
+    return;
+  Buffer = std::move(*MaybeBuffer);
+  if (!readMappedEntries()) {
+    MappedEntries.clear();
+    Buffer.reset();
+    return;
+  }
+  MappedEntryUsed =
+      std::make_unique<std::atomic<bool>[]>(MappedEntries.size());
+}
+
+DependencyDirectivesPersistentCache::~DependencyDirectivesPersistentCache() {
+  if (!NewEntries.empty())
+    write();
+}
+
+DependencyDirectivesPersistentCache::KeyTy
+DependencyDirectivesPersistentCache::getKey(const llvm::vfs::Status &Stat) {
+  llvm::sys::fs::UniqueID UID = Stat.getUniqueID();
+  uint64_t MTime = Stat.getLastModificationTime().time_since_epoch().count();
+  return KeyTy(UID.getDevice(), UID.getFile(), MTime, Stat.getSize());
+}
+
+bool DependencyDirectivesPersistentCache::readMappedEntries() {
+  using namespace llvm::support;
+  StringRef Data = Buffer->getBuffer();
+  size_t HeaderSize = sizeof(PersistentCacheMagic) + 2 * sizeof(uint32_t);
+  if (Data.size() < HeaderSize ||
+      !Data.starts_with(StringRef(PersistentCacheMagic,
+                                  sizeof(PersistentCacheMagic))))
+    return false;
+  const char *Ptr = Data.data() + sizeof(PersistentCacheMagic);
+  if (endian::readNext<uint32_t, llvm::endianness::little>(Ptr) !=
+      PersistentCacheVersion)
+    return false;
+  uint32_t NumEntries =
+      endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+
+  const char *End = Data.data() + Data.size();
+  MappedEntries.reserve(NumEntries);
+  for (uint32_t I = 0; I != NumEntries; ++I) {
+    if (size_t(End - Ptr) < PersistentKeySize + PersistentEntryHeaderSize)
+      return false;
+    uint64_t Device = endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+    uint64_t File = endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+    uint64_t MTime = endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+    uint64_t Size = endian::readNext<uint64_t, llvm::endianness::little>(Ptr);
+
+    const char *EntryStart = Ptr;
+    uint64_t NumTokens =
+        endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint64_t NumDirectives =
+        endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint64_t PayloadSize = NumTokens * PersistentTokenSize +
+                           NumDirectives * PersistentDirectiveSize;
+    if (uint64_t(End - Ptr) < PayloadSize)
+      return false;
+    Ptr += PayloadSize;
+    MappedEntries.try_emplace(
+        KeyTy(Device, File, MTime, Size),
+        MappedEntry{StringRef(EntryStart, Ptr - EntryStart),
+                    unsigned(MappedEntries.size())});
+  }
+  return true;
+}
+
+bool DependencyDirectivesPersistentCache::lookup(
+    const llvm::vfs::Status &Stat,
+    SmallVectorImpl<dependency_directives_scan::Token> &Tokens,
+    SmallVectorImpl<dependency_directives_scan::Directive> &Directives) const {
+  using namespace llvm::support;
+  KeyTy Key = getKey(Stat);
+  StringRef Entry;
+  if (auto It = MappedEntries.find(Key); It != MappedEntries.end()) {
+    Entry = It->second.Data;
+    MappedEntryUsed[It->second.Index].store(true, std::memory_order_relaxed);
+  } else {
+    std::lock_guard<std::mutex> LockGuard(Lock);
+    auto NewIt = NewEntries.find(Key);
+    if (NewIt == NewEntries.end())
+      return false;
+    Entry = NewIt->second;
+  }
+
+  const char *Ptr = Entry.data();
+  uint32_t NumTokens =
+      endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+  uint32_t NumDirectives =
+      endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+
+  Tokens.clear();
+  Tokens.reserve(NumTokens);
+  for (uint32_t I = 0; I != NumTokens; ++I) {
+    uint32_t Offset = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint32_t Length = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint16_t Kind = endian::readNext<uint16_t, llvm::endianness::little>(Ptr);
+    uint16_t Flags = endian::readNext<uint16_t, llvm::endianness::little>(Ptr);
+    // Entries whose tokens do not fit the file are stale or corrupted.
+    if (uint64_t(Offset) + Length > Stat.getSize() || Kind >= tok::NUM_TOKENS) {
+      Tokens.clear();
+      return false;
+    }
+    Tokens.emplace_back(Offset, Length, tok::TokenKind(Kind), Flags);
+  }
+
+  Directives.clear();
+  ArrayRef<dependency_directives_scan::Token> Remaining = Tokens;
+  for (uint32_t I = 0; I != NumDirectives; ++I) {
+    uint32_t Kind = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    uint32_t Count = endian::readNext<uint32_t, llvm::endianness::little>(Ptr);
+    if (Kind > dependency_directives_scan::pp_eof || Count > Remaining.size()) {
+      Tokens.clear();
+      Directives.clear();
+      return false;
+    }
+    Directives.emplace_back(dependency_directives_scan::DirectiveKind(Kind),
+                            Remaining.take_front(Count));
+    Remaining = Remaining.drop_front(Count);
+  }
+  // Every token belongs to a directive.
+  if (!Remaining.empty()) {
+    Tokens.clear();
+    Directives.clear();
+    return false;
+  }
+  return true;
+}
+
+void DependencyDirectivesPersistentCache::insert(
+    const llvm::vfs::Status &Stat,
+    ArrayRef<dependency_directives_scan::Directive> Directives) {
+  size_t NumTokens = 0;
+  for (const auto &Directive : Directives)
+    NumTokens += Directive.Tokens.size();
+
+  std::string Entry;
+  Entry.reserve(PersistentEntryHeaderSize + NumTokens * PersistentTokenSize +
+                Directives.size() * PersistentDirectiveSize);
+  llvm::raw_string_ostream OS(Entry);
+  llvm::support::endian::Writer W(OS, llvm::endianness::little);
+  W.write<uint32_t>(NumTokens);
+  W.write<uint32_t>(Directives.size());
+  for (const auto &Directive : Directives) {
+    for (const auto &Tok : Directive.Tokens) {
+      W.write<uint32_t>(Tok.Offset);
+      W.write<uint32_t>(Tok.Length);
+      W.write<uint16_t>(Tok.Kind);
+      W.write<uint16_t>(Tok.Flags);
+    }
+  }
+  for (const auto &Directive : Directives) {
+    W.write<uint32_t>(Directive.Kind);
+    W.write<uint32_t>(Directive.Tokens.size());
+  }
+
+  std::lock_guard<std::mutex> LockGuard(Lock);
+  NewEntries[getKey(Stat)] = std::move(Entry);
+}
+
+void DependencyDirectivesPersistentCache::write() const {
+  // Write to a temporary file and rename it over the cache so that concurrent
+  // scanning processes never observe a partially written cache.
+  int FD;
+  SmallString<128> TempPath;
+  if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%", FD, TempPath))
+    return;
+
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    llvm::support::endian::Writer W(OS, llvm::endianness::little);
+    auto WriteEntry = [&](const KeyTy &Key, StringRef Entry) {
+      W.write<uint64_t>(std::get<0>(Key));
+      W.write<uint64_t>(std::get<1>(Key));
+      W.write<uint64_t>(std::get<2>(Key));
+      W.write<uint64_t>(std::get<3>(Key));
+      OS << Entry;
+    };
+
+    // Keep the entries recorded by this process, then the mapped ones it
+    // looked up, then the remaining mapped ones, up to MaxEntries. A mapped
+    // entry of a file that was recorded again is stale: the file has a new
+    // modification time or size, so the entry can never match again.
+    llvm::DenseSet<std::pair<uint64_t, uint64_t>> RecordedFiles;
+    std::vector<std::pair<KeyTy, StringRef>> Kept;
+    for (const auto &[Key, Entry] : NewEntries) {
+      RecordedFiles.insert({std::get<0>(Key), std::get<1>(Key)});
+      Kept.emplace_back(Key, Entry);
+    }
+    for (bool Used : {true, false})
+      for (const auto &[Key, Entry] : MappedEntries)
+        if (MappedEntryUsed[Entry.Index].load(std::memory_order_relaxed) ==
+                Used &&
+            !RecordedFiles.count({std::get<0>(Key), std::get<1>(Key)}))
+          Kept.emplace_back(Key, Entry.Data);
+    if (Kept.size() > MaxEntries)
+      Kept.resize(MaxEntries);
+
+    OS.write(PersistentCacheMagic, sizeof(PersistentCacheMagic));
+    W.write<uint32_t>(PersistentCacheVersion);
+    W.write<uint32_t>(Kept.size());
+    for (const auto &[Key, Entry] : Kept)
+      WriteEntry(Key, Entry);
+
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return;
+    }
+  }
+
+  if (llvm::sys::fs::rename(TempPath, Path))
+    llvm::sys::fs::remove(TempPath);
+}
+
 DependencyScanningFilesystemSharedCache::
     DependencyScanningFilesystemSharedCache() {
   // This heuristic was chosen using a empirical testing on a
@@ -108,6 +358,36 @@ DependencyScanningFilesystemSharedCache::getShardForUID(
   return CacheShards[Hash % NumShards];
 }
 
+void DependencyScanningFilesystemSharedCache::invalidateFilename(
+    StringRef Filename) {
+  const CachedFileSystemEntry *Entry = nullptr;
+  {
+    CacheShard &Shard = getShardForFilename(Filename);
+    std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+    auto It = Shard.CacheByFilename.find(Filename);
+    if (It == Shard.CacheByFilename.end())
+      return;
+    Entry = It->getValue().first;
+    Shard.CacheByFilename.erase(It);
+  }
+
+  // The unique ID of a file modified in place stays the same, so the entry has
+  // to be dropped from the UID map too. The filename shard lock is released at
+  // this point since both maps may live in the same shard.
+  if (!Entry || Entry->isError())
+    return;
+  llvm::sys::fs::UniqueID UID = Entry->getUniqueID();
+  CacheShard &Shard = getShardForUID(UID);
+  std::lock_guard<std::mutex> LockGuard(Shard.CacheLock);
+  auto It = Shard.EntriesByUID.find(UID);
+  if (It != Shard.EntriesByUID.end() && It->getSecond() == Entry)
+    Shard.EntriesByUID.erase(It);
+}
+
+void DependencyScanningFilesystemSharedCache::invalidateAll() {
+  CacheShards = std::make_unique<CacheShard[]>(NumShards);
+}
+
 const CachedFileSystemEntry *
 DependencyScanningFilesystemSharedCache::CacheShard::findEntryByFilename(
     StringRef Filename) const {
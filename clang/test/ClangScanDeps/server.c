@@ -0,0 +1,67 @@
+// Check that --server rescans a translation unit whose header changed
+// between two requests.
+
+// RUN: rm -rf %t
+// RUN: split-file %s %t
+// RUN: sed "s|DIR|%/t|g" %t/cdb.json.template > %t/cdb.json
+// RUN: %python %t/driver.py %t/a.h clang-scan-deps \
+// RUN:   -compilation-database %t/cdb.json -format experimental-full --server \
+// RUN:   | FileCheck %s -DPREFIX=%/t
+
+// CHECK:      "file-deps": [
+// CHECK-NEXT:   "[[PREFIX]]/tu.c",
+// CHECK-NEXT:   "[[PREFIX]]/a.h",
+// CHECK-NEXT:   "[[PREFIX]]/b.h"
+// CHECK-NEXT: ]
+// CHECK:      --- rescan ---
+// CHECK:      "file-deps": [
+// CHECK-NEXT:   "[[PREFIX]]/tu.c",
+// CHECK-NEXT:   "[[PREFIX]]/a.h",
+// CHECK-NEXT:   "[[PREFIX]]/c.h"
+// CHECK-NEXT: ]
+
+//--- cdb.json.template
+[{
+  "directory": "DIR",
+  "command": "clang -fsyntax-only DIR/tu.c",
+  "file": "DIR/tu.c"
+}]
+
+//--- tu.c
+#include "a.h"
+
+//--- a.h
+#include "b.h"
+
+//--- b.h
+
+//--- c.h
+
+//--- driver.py
+# Sends two scan requests to the server, rewriting the header given as the
+# first argument in between, and prints both responses.
+import subprocess
+import sys
+
+header = sys.argv[1]
+server = subprocess.Popen(
+    sys.argv[2:], stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True
+)
+
+
+def scan():
+    server.stdin.write("\n")
+    server.stdin.flush()
+    for line in server.stdout:
+        if not line.strip():
+            return
+        sys.stdout.write(line)
+
+
+scan()
+with open(header, "w") as f:
+    f.write('#include "c.h"\n')
+print("--- rescan ---")
+scan()
+server.stdin.close()
+sys.exit(server.wait())
@@ -0,0 +1,35 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-llvm \
+// RUN:   -emit-function-body-hashes %s -o %t.ll
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-llvm \
+// RUN:   -emit-function-body-hashes -DCHANGE_LAYOUT %s -o %t.layout.ll
+// RUN: cat %t.ll %t.layout.ll | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -emit-llvm %s -o - \
+// RUN:   | FileCheck %s --check-prefix=OFF
+
+// Definitions get a 64-bit hash of their emitted IR. Functions with the same
+// body but different names hash differently, and a change to the layout of a
+// type a function uses changes its hash even though its source does not.
+
+struct S {
+#ifdef CHANGE_LAYOUT
+  char Pad;
+#endif
+  int X;
+};
+
+int get(struct S *P) { return P->X; }
+int one(void) { return 1; }
+int uno(void) { return 1; }
+
+// CHECK: define{{.*}} i32 @get(ptr {{.*}}) #[[GET1:[0-9]+]]
+// CHECK: define{{.*}} i32 @one() #[[ONE1:[0-9]+]]
+// CHECK: attributes #[[GET1]] = {{{.*}}"clang-body-hash"="[[GETHASH:[0-9a-f]{16}]]"
+// CHECK: attributes #[[ONE1]] = {{{.*}}"clang-body-hash"="[[ONEHASH:[0-9a-f]{16}]]"
+// CHECK-NOT: "clang-body-hash"="[[ONEHASH]]"
+
+// CHECK: define{{.*}} i32 @get(ptr {{.*}}) #[[GET2:[0-9]+]]
+// CHECK: define{{.*}} i32 @one() #[[ONE2:[0-9]+]]
+// CHECK-NOT: "clang-body-hash"="[[GETHASH]]"
+// CHECK: attributes #[[ONE2]] = {{{.*}}"clang-body-hash"="[[ONEHASH]]"
+
+// OFF-NOT: clang-body-hash
@@ -0,0 +1,6 @@
+// RUN: %clang -### -c -fcompile-cache=%t.cache %s 2>&1 | FileCheck %s
+// CHECK: "-cc1"
+// CHECK-SAME: "-fcompile-cache={{.*}}.cache"
+
+// RUN: %clang -### -c %s 2>&1 | FileCheck %s --check-prefix=NONE
+// NONE-NOT: "-fcompile-cache
@@ -0,0 +1,47 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: echo '#define VALUE 1' > %t/value.h
+
+// The first compilation populates the cache.
+// RUN: %clang_cc1 -emit-llvm -Wunused-variable -Rcompile-cache \
+// RUN:   -fcompile-cache=%t/cache -I %t %s -o %t/out.ll \
+// RUN:   -dependency-file %t/out.d -MT out.o 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=MISS
+// RUN: cp %t/out.ll %t/first.ll
+// RUN: cp %t/out.d %t/first.d
+// MISS: remark: compile cache miss for '{{.*}}compile-cache.c'
+// MISS: warning: unused variable 'unused'
+// MISS: 1 warning generated.
+
+// The second one replays the outputs and the diagnostics.
+// RUN: rm %t/out.ll %t/out.d
+// RUN: %clang_cc1 -emit-llvm -Wunused-variable -Rcompile-cache \
+// RUN:   -fcompile-cache=%t/cache -I %t %s -o %t/out.ll \
+// RUN:   -dependency-file %t/out.d -MT out.o 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=HIT
+// RUN: cmp %t/first.ll %t/out.ll
+// RUN: cmp %t/first.d %t/out.d
+// HIT: remark: compile cache hit for '{{.*}}compile-cache.c'
+// HIT: warning: unused variable 'unused'
+// HIT: 1 warning generated.
+
+// Changing an included file invalidates the entry.
+// RUN: echo '#define VALUE 2' > %t/value.h
+// RUN: %clang_cc1 -emit-llvm -Wunused-variable -Rcompile-cache \
+// RUN:   -fcompile-cache=%t/cache -I %t %s -o %t/out.ll \
+// RUN:   -dependency-file %t/out.d -MT out.o 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=MISS
+// RUN: FileCheck %s --check-prefix=IR < %t/out.ll
+// IR: ret i32 2
+
+// Compilations that expand __DATE__ are never cached.
+// RUN: %clang_cc1 -emit-llvm -Rcompile-cache -fcompile-cache=%t/cache \
+// RUN:   -I %t %s -o %t/date.ll -DSTAMP=__DATE__ 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=UNCACHED --allow-empty
+// UNCACHED-NOT: remark: compile cache
+
+#include "value.h"
+
+int f(void) {
+  int unused;
+  return VALUE;
+}
@@ -0,0 +1,52 @@
+// Test that -fmodules-lazy-load-identifiers still finds declarations, macros
+// and overloads from C++ AST files, both for identifiers that the importer
+// already knows and for ones it only sees after the import.
+//
+// RUN: rm -rf %t
+// RUN: split-file %s %t
+//
+// RUN: %clang_cc1 -std=c++20 -x c++-header -emit-pch %t/a.h -o %t/a.pch
+// RUN: %clang_cc1 -std=c++20 -include-pch %t/a.pch %t/use.cpp \
+// RUN:   -fsyntax-only -verify
+// RUN: %clang_cc1 -std=c++20 -include-pch %t/a.pch %t/use.cpp \
+// RUN:   -fmodules-lazy-load-identifiers -fsyntax-only -verify
+//
+// RUN: %clang_cc1 -std=c++20 -fmodules -fimplicit-module-maps \
+// RUN:   -fmodules-cache-path=%t/cache -I %t %t/import.cpp \
+// RUN:   -fmodules-lazy-load-identifiers -fsyntax-only -verify
+
+//--- a.h
+#define TWICE(x) ((x) * 2)
+
+namespace ns {
+template <typename T> struct box { T value; };
+int known(int);
+double known(double);
+enum class color { red, green };
+} // namespace ns
+
+inline int unknown_until_used() { return TWICE(21); }
+
+//--- module.modulemap
+module a { header "a.h" export * }
+
+//--- use.cpp
+// expected-no-diagnostics
+static_assert(TWICE(2) == 4);
+ns::box<int> b{unknown_until_used()};
+auto c = ns::color::green;
+double d = ns::known(1.0);
+
+//--- import.cpp
+// The importer declares 'known' before importing, so the identifier is known
+// to it and is marked out of date rather than skipped.
+namespace other {
+int known;
+}
+
+#include "a.h"
+
+static_assert(TWICE(3) == 6);
+ns::box<int> b{ns::known(1) + unknown_until_used()};
+auto c = ns::color::red;
+int e = not_in_module; // expected-error {{use of undeclared identifier 'not_in_module'}}
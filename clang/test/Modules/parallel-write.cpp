@@ -0,0 +1,39 @@
+// Compressing the embedded source buffers on several threads with
+// -fmodules-parallel-write must produce the same PCM as doing it serially.
+
+// RUN: rm -rf %t && split-file %s %t && cd %t
+// RUN: %clang_cc1 -std=c++20 -fmodules -fmodule-name=M -emit-module \
+// RUN:   -fmodules-embed-all-files -x c++ module.modulemap -o serial.pcm
+// RUN: %clang_cc1 -std=c++20 -fmodules -fmodule-name=M -emit-module \
+// RUN:   -fmodules-embed-all-files -fmodules-parallel-write -x c++ \
+// RUN:   module.modulemap -o parallel.pcm
+// RUN: diff serial.pcm parallel.pcm
+
+// RUN: %clang_cc1 -std=c++20 -fmodules -fmodule-file=M=parallel.pcm \
+// RUN:   -fmodule-map-file=module.modulemap -fsyntax-only -verify use.cpp
+
+//--- module.modulemap
+module M {
+  header "a.h"
+  header "b.h"
+  header "c.h"
+  header "d.h"
+}
+
+//--- a.h
+inline int a() { return 1; }
+
+//--- b.h
+inline int b() { return 2; }
+
+//--- c.h
+inline int c() { return 3; }
+
+//--- d.h
+inline int d() { return 4; }
+
+//--- use.cpp
+// expected-no-diagnostics
+#include "a.h"
+#include "d.h"
+int x = a() + d();
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "clang/DirectoryWatcher/DirectoryWatcher.h"
 #include "clang/Driver/Compilation.h"
 #include "clang/Driver/Driver.h"
 #include "clang/Frontend/CompilerInstance.h"
@@ -16,7 +17,9 @@
 #include "clang/Tooling/DependencyScanning/DependencyScanningWorker.h"
 #include "clang/Tooling/JSONCompilationDatabase.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/Support/Chrono.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/Format.h"
@@ -78,6 +81,7 @@ static ScanningOutputFormat Format = ScanningOutputFormat::Make;
 static ScanningOptimizations OptimizeArgs;
 static std::string ModuleFilesDir;
 static bool EagerLoadModules;
+static std::string PersistentCachePath;
 static unsigned NumThreads = 0;
 static std::string CompilationDB;
 static std::string ModuleName;
@@ -86,6 +90,7 @@ static bool DeprecatedDriverCommand;
 static ResourceDirRecipeKind ResourceDirRecipe;
 static bool Verbose;
 static bool PrintTiming;
+static bool ServerMode;
 static llvm::BumpPtrAllocator Alloc;
 static llvm::StringSaver Saver{Alloc};
 static std::vector<const char *> CommandLine;
@@ -181,6 +186,9 @@ static void ParseArgs(int argc, char **argv) {
 
   EagerLoadModules = Args.hasArg(OPT_eager_load_pcm);
 
+  if (const llvm::opt::Arg *A = Args.getLastArg(OPT_persistent_cache_path_EQ))
+    PersistentCachePath = A->getValue();
+
   if (const llvm::opt::Arg *A = Args.getLastArg(OPT_j)) {
     StringRef S{A->getValue()};
     if (!llvm::to_integer(S, NumThreads, 0)) {
@@ -219,6 +227,15 @@ static void ParseArgs(int argc, char **argv) {
 
   PrintTiming = Args.hasArg(OPT_print_timing);
 
+  ServerMode = Args.hasArg(OPT_server);
+  if (ServerMode &&
+      (Format != ScanningOutputFormat::Full || !ModuleName.empty())) {
+    llvm::errs() << ToolName
+                 << ": the --server option requires -format=experimental-full "
+                    "and no -module-name\n";
+    std::exit(1);
+  }
+
   Verbose = Args.hasArg(OPT_verbose);
 
   RoundTripArgs = Args.hasArg(OPT_round_trip_args);
@@ -587,6 +604,165 @@ static bool handleModuleResult(
   return false;
 }
 
+/// Keeps the results of translation units scanned in --server mode and drops
+/// the ones whose files changed since, as reported by directory watchers on
+/// the directories of their dependencies.
+///
+/// Files created in directories that no scanned dependency lives in (e.g. a
+/// header that starts shadowing another one) are not noticed.
+class IncrementalScanState {
+public:
+  IncrementalScanState(DependencyScanningFilesystemSharedCache &SharedCache,
+                       size_t NumInputs)
+      : SharedCache(SharedCache), Results(NumInputs) {}
+
+  /// Returns the result of the input if none of its dependencies changed
+  /// since it was recorded.
+  std::optional<TranslationUnitDeps> getResult(size_t InputIndex) {
+    std::unique_lock<std::mutex> LockGuard(Lock);
+    return Results[InputIndex];
+  }
+
+  /// Records the result of the input and starts watching its dependencies.
+  ///
+  /// A dependency modified since the scan started may have changed before
+  /// its directory was watched. The result is not kept in that case, and the
+  /// file is dropped from the shared cache.
+  void setResult(size_t InputIndex, const TranslationUnitDeps &TUDeps) {
+    std::unique_lock<std::mutex> LockGuard(Lock);
+    bool UpToDate = true;
+    auto AddDependency = [&](StringRef File) {
+      addDependency(File, InputIndex);
+      if (isModifiedSinceScanStart(File)) {
+        SharedCache.invalidateFilename(File);
+        UpToDate = false;
+      }
+    };
+    for (const std::string &File : TUDeps.FileDeps)
+      AddDependency(File);
+    for (const ModuleDeps &MD : TUDeps.ModuleGraph) {
+      for (const auto &File : MD.FileDeps)
+        AddDependency(File.getKey());
+      for (const std::string &File : MD.ModuleMapFileDeps)
+        AddDependency(File);
+    }
+    if (UpToDate)
+      Results[InputIndex] = TUDeps;
+  }
+
+  /// Applies the filesystem changes reported since the last call: forgets
+  /// the changed files in the shared cache and the results that depend on
+  /// them. Must be called before each scan and not while one is in progress.
+  void applyChanges() {
+    // Truncate to seconds so that coarse file time stamps compare as
+    // modified rather than unchanged.
+    ScanStart = std::chrono::time_point_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now());
+
+    llvm::StringSet<> Changed;
+    bool Invalidated;
+    {
+      std::unique_lock<std::mutex> LockGuard(ChangesLock);
+      std::swap(Changed, ChangedFiles);
+      Invalidated = WatchersInvalidated;
+      WatchersInvalidated = false;
+    }
+
+    std::unique_lock<std::mutex> LockGuard(Lock);
+    if (Invalidated) {
+      // Some changes may have been lost, so start over.
+      SharedCache.invalidateAll();
+      for (auto &Result : Results)
+        Result.reset();
+      Dependents.clear();
+      Watchers.clear();
+      return;
+    }
+
+    for (const auto &File : Changed) {
+      SharedCache.invalidateFilename(File.getKey());
+      auto It = Dependents.find(File.getKey());
+      if (It == Dependents.end())
+        continue;
+      for (size_t InputIndex : It->second)
+        Results[InputIndex].reset();
+      Dependents.erase(It);
+    }
+  }
+
+private:
+  void addDependency(StringRef File, size_t InputIndex) {
+    auto &Inputs = Dependents[File];
+    if (Inputs.empty() || Inputs.back() != InputIndex)
+      Inputs.push_back(InputIndex);
+    watchDirectory(llvm::sys::path::parent_path(File));
+  }
+
+  void watchDirectory(StringRef Dir) {
+    if (Dir.empty() || Watchers.contains(Dir))
+      return;
+    std::string DirPath = Dir.str();
+    auto MaybeWatcher = DirectoryWatcher::create(
+        Dir,
+        [this, DirPath](ArrayRef<DirectoryWatcher::Event> Events,
+                        bool IsInitial) {
+          if (!IsInitial)
+            recordEvents(DirPath, Events);
+        },
+        /*WaitForInitialSync=*/true);
+    if (!MaybeWatcher) {
+      // Without a watcher changes cannot be tracked, so never reuse results.
+      llvm::consumeError(MaybeWatcher.takeError());
+      std::unique_lock<std::mutex> LockGuard(ChangesLock);
+      WatchersInvalidated = true;
+      return;
+    }
+    Watchers[Dir] = std::move(*MaybeWatcher);
+  }
+
+  bool isModifiedSinceScanStart(StringRef File) const {
+    llvm::sys::fs::file_status Status;
+    if (llvm::sys::fs::status(File, Status))
+      return true;
+    return Status.getLastModificationTime() >= ScanStart;
+  }
+
+  void recordEvents(StringRef Dir, ArrayRef<DirectoryWatcher::Event> Events) {
+    std::unique_lock<std::mutex> LockGuard(ChangesLock);
+    for (const DirectoryWatcher::Event &Event : Events) {
+      switch (Event.Kind) {
+      case DirectoryWatcher::Event::EventKind::Removed:
+      case DirectoryWatcher::Event::EventKind::Modified: {
+        SmallString<256> Path(Dir);
+        llvm::sys::path::append(Path, Event.Filename);
+        ChangedFiles.insert(Path);
+        break;
+      }
+      case DirectoryWatcher::Event::EventKind::WatchedDirRemoved:
+      case DirectoryWatcher::Event::EventKind::WatcherGotInvalidated:
+        WatchersInvalidated = true;
+        break;
+      }
+    }
+  }
+
+  DependencyScanningFilesystemSharedCache &SharedCache;
+
+  /// The mutex that must be locked before accessing the members below.
+  std::mutex Lock;
+  std::vector<std::optional<TranslationUnitDeps>> Results;
+  /// Map from dependency paths to the inputs that depend on them.
+  llvm::StringMap<SmallVector<size_t, 1>> Dependents;
+  llvm::StringMap<std::unique_ptr<DirectoryWatcher>> Watchers;
+  llvm::sys::TimePoint<> ScanStart;
+
+  /// The mutex that must be locked before accessing the members below. The
+  /// watchers report changes on their own threads.
+  std::mutex ChangesLock;
+  llvm::StringSet<> ChangedFiles;
+  bool WatchersInvalidated = false;
+};
+
 class P1689Deps {
 public:
   void printDependencies(raw_ostream &OS) {
@@ -912,8 +1088,8 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
     return {};
   };
 
-  if (Format == ScanningOutputFormat::Full)
-    FD.emplace(ModuleName.empty() ? Inputs.size() : 0);
+  // Results reused across scans in --server mode.
+  std::optional<IncrementalScanState> Incremental;
 
   auto ScanningTask = [&](DependencyScanningService &Service) {
     DependencyScanningTool WorkerTool(Service);
@@ -991,6 +1167,22 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
         if (handleModuleResult(*MaybeModuleName, MaybeModuleDepsGraph, *FD,
                                LocalIndex, DependencyOS, Errs))
           HadErrors = true;
+      } else if (Incremental) {
+        // Report the whole module graph of every translation unit, since the
+        // ones that reported a shared module first may not get rescanned.
+        AlreadySeenModules.clear();
+        std::optional<TranslationUnitDeps> Cached =
+            Incremental->getResult(LocalIndex);
+        llvm::Expected<TranslationUnitDeps> MaybeTUDeps =
+            Cached ? std::move(*Cached)
+                   : WorkerTool.getTranslationUnitDependencies(
+                         Input->CommandLine, CWD, AlreadySeenModules,
+                         LookupOutput);
+        if (!Cached && MaybeTUDeps)
+          Incremental->setResult(LocalIndex, *MaybeTUDeps);
+        if (handleTranslationUnitResult(Filename, MaybeTUDeps, *FD, LocalIndex,
+                                        DependencyOS, Errs))
+          HadErrors = true;
       } else {
         auto MaybeTUDeps = WorkerTool.getTranslationUnitDependencies(
             Input->CommandLine, CWD, AlreadySeenModules, LookupOutput);
@@ -1002,42 +1194,76 @@ int clang_scan_deps_main(int argc, char **argv, const llvm::ToolContext &) {
   };
 
   DependencyScanningService Service(ScanMode, Format, OptimizeArgs,
-                                    EagerLoadModules);
+                                    EagerLoadModules, PersistentCachePath);
 
-  llvm::Timer T;
-  T.startTimer();
+  auto RunScan = [&]() {
+    Index = 0;
+    if (Format == ScanningOutputFormat::Full)
+      FD.emplace(ModuleName.empty() ? Inputs.size() : 0);
 
-  if (Inputs.size() == 1) {
-    ScanningTask(Service);
-  } else {
-    llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(NumThreads));
+    llvm::Timer T;
+    T.startTimer();
 
-    if (Verbose) {
-      llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
-                   << " files using " << Pool.getMaxConcurrency()
-                   << " workers\n";
-    }
+    if (Inputs.size() == 1) {
+      ScanningTask(Service);
+    } else {
+      llvm::DefaultThreadPool Pool(llvm::hardware_concurrency(NumThreads));
 
-    for (unsigned I = 0; I < Pool.getMaxConcurrency(); ++I)
-      Pool.async([ScanningTask, &Service]() { ScanningTask(Service); });
+      if (Verbose) {
+        llvm::outs() << "Running clang-scan-deps on " << Inputs.size()
+                     << " files using " << Pool.getMaxConcurrency()
+                     << " workers\n";
+      }
 
-    Pool.wait();
-  }
+      for (unsigned I = 0; I < Pool.getMaxConcurrency(); ++I)
+        Pool.async([ScanningTask, &Service]() { ScanningTask(Service); });
+
+      Pool.wait();
+    }
+
+    T.stopTimer();
+    if (PrintTiming)
+      llvm::errs() << llvm::format(
+          "clang-scan-deps timing: %0.2fs wall, %0.2fs process\n",
+          T.getTotalTime().getWallTime(), T.getTotalTime().getProcessTime());
 
-  T.stopTimer();
-  if (PrintTiming)
-    llvm::errs() << llvm::format(
-        "clang-scan-deps timing: %0.2fs wall, %0.2fs process\n",
-        T.getTotalTime().getWallTime(), T.getTotalTime().getProcessTime());
+    if (RoundTripArgs)
+      if (FD && FD->roundTripCommands(llvm::errs()))
+        HadErrors = true;
 
-  if (RoundTripArgs)
-    if (FD && FD->roundTripCommands(llvm::errs()))
-      HadErrors = true;
+    if (Format == ScanningOutputFormat::Full)
+      FD->printFullOutput(ThreadUnsafeDependencyOS);
+    else if (Format == ScanningOutputFormat::P1689)
+      PD.printDependencies(ThreadUnsafeDependencyOS);
+  };
 
-  if (Format == ScanningOutputFormat::Full)
-    FD->printFullOutput(ThreadUnsafeDependencyOS);
-  else if (Format == ScanningOutputFormat::P1689)
-    PD.printDependencies(ThreadUnsafeDependencyOS);
+  if (!ServerMode) {
+    RunScan();
+    return HadErrors;
+  }
 
-  return HadErrors;
+  // Every line read from stdin requests a scan of all inputs. Each response is
+  // the full dependency output followed by an empty line. Scanning errors are
+  // reported on stderr and do not stop the server.
+  Incremental.emplace(Service.getSharedCache(), Inputs.size());
+  char Buffer[256];
+  while (true) {
+    llvm::Expected<size_t> BytesRead = llvm::sys::fs::readNativeFile(
+        llvm::sys::fs::getStdinHandle(), Buffer);
+    if (!BytesRead) {
+      llvm::consumeError(BytesRead.takeError());
+      return 1;
+    }
+    if (*BytesRead == 0)
+      return 0;
+    for (char C : StringRef(Buffer, *BytesRead)) {
+      if (C != '\n')
+        continue;
+      Incremental->applyChanges();
+      HadErrors = false;
+      RunScan();
+      ThreadUnsafeDependencyOS << '\n';
+      ThreadUnsafeDependencyOS.flush();
+    }
+  }
 }
@@ -0,0 +1,94 @@
+//===- unittests/Serialization/InputFileContentHashTest.cpp ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/Diagnostic.h"
+#include "clang/Basic/DiagnosticOptions.h"
+#include "clang/Basic/FileManager.h"
+#include "clang/Basic/LangOptions.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/HeaderSearchOptions.h"
+#include "clang/Serialization/InMemoryModuleCache.h"
+#include "clang/Serialization/ModuleManager.h"
+#include "clang/Serialization/PCHContainerOperations.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace clang;
+
+namespace {
+
+// One compilation's view of the file system, with its own ModuleManager.
+struct Compilation {
+  Compilation()
+      : VFS(new vfs::InMemoryFileSystem), FileMgr(FileSystemOptions(), VFS),
+        Diags(new DiagnosticIDs(), new DiagnosticOptions,
+              new IgnoringDiagConsumer()),
+        SourceMgr(Diags, FileMgr),
+        Search(std::make_shared<HeaderSearchOptions>(), SourceMgr, Diags,
+               LangOpts, /*Target=*/nullptr),
+        ModuleMgr(FileMgr, ModuleCache, PCHContainerRdr, Search) {}
+
+  FileEntryRef addFile(StringRef Path, StringRef Contents) {
+    // The same modification time for every file, so that files can only be
+    // told apart by their contents.
+    VFS->addFile(Path, /*ModificationTime=*/0,
+                 MemoryBuffer::getMemBufferCopy(Contents, Path));
+    return cantFail(FileMgr.getFileRef(Path));
+  }
+
+  IntrusiveRefCntPtr<vfs::InMemoryFileSystem> VFS;
+  FileManager FileMgr;
+  DiagnosticsEngine Diags;
+  SourceManager SourceMgr;
+  LangOptions LangOpts;
+  HeaderSearch Search;
+  InMemoryModuleCache ModuleCache;
+  RawPCHContainerReader PCHContainerRdr;
+  ModuleManager ModuleMgr;
+};
+
+TEST(InputFileContentHashTest, HashesContents) {
+  Compilation C;
+  FileEntryRef A = C.addFile("/a.h", "int a;");
+  FileEntryRef B = C.addFile("/b.h", "int b;");
+
+  ErrorOr<uint64_t> HashA = C.ModuleMgr.getInputFileContentHash(A);
+  ASSERT_TRUE(HashA);
+  EXPECT_EQ(*HashA, uint64_t(hash_value(StringRef("int a;"))));
+
+  ErrorOr<uint64_t> HashB = C.ModuleMgr.getInputFileContentHash(B);
+  ASSERT_TRUE(HashB);
+  EXPECT_NE(*HashA, *HashB);
+
+  // Asking again returns the recorded hash.
+  ErrorOr<uint64_t> HashAAgain = C.ModuleMgr.getInputFileContentHash(A);
+  ASSERT_TRUE(HashAAgain);
+  EXPECT_EQ(*HashA, *HashAAgain);
+}
+
+TEST(InputFileContentHashTest, NotSharedAcrossCompilations) {
+  // The same path with the same size and modification time, but different
+  // contents. Each compilation must hash the file it sees.
+  Compilation First;
+  Compilation Second;
+  FileEntryRef Old = First.addFile("/a.h", "int a;");
+  FileEntryRef New = Second.addFile("/a.h", "int b;");
+
+  ErrorOr<uint64_t> OldHash = First.ModuleMgr.getInputFileContentHash(Old);
+  ErrorOr<uint64_t> NewHash = Second.ModuleMgr.getInputFileContentHash(New);
+  ASSERT_TRUE(OldHash);
+  ASSERT_TRUE(NewHash);
+  EXPECT_EQ(*NewHash, uint64_t(hash_value(StringRef("int b;"))));
+  EXPECT_NE(*OldHash, *NewHash);
+}
+
+} // namespace
@@ -7,8 +7,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningFilesystem.h"
+#include "clang/Lex/DependencyDirectivesScanner.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
 using namespace clang::tooling::dependencies;
@@ -174,3 +178,260 @@ TEST(DependencyScanningFilesystem, CacheStatOnExists) {
   EXPECT_EQ(InstrumentingFS->NumStatusCalls, 2u);
   EXPECT_EQ(InstrumentingFS->NumExistsCalls, 0u);
 }
+
+TEST(DependencyScanningFilesystem, SharedCacheInvalidation) {
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  auto InstrumentingFS =
+      llvm::makeIntrusiveRefCnt<InstrumentingFilesystem>(InMemoryFS);
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo", 0, llvm::MemoryBuffer::getMemBuffer(""));
+  InMemoryFS->addFile("/bar", 0, llvm::MemoryBuffer::getMemBuffer(""));
+  DependencyScanningFilesystemSharedCache SharedCache;
+
+  {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InstrumentingFS);
+    DepFS.status("/foo");
+    DepFS.status("/bar");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 2u);
+  }
+
+  // Only the invalidated file goes to the underlying filesystem again.
+  SharedCache.invalidateFilename("/foo");
+  {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InstrumentingFS);
+    DepFS.status("/foo");
+    DepFS.status("/bar");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 3u);
+  }
+
+  SharedCache.invalidateAll();
+  {
+    DependencyScanningWorkerFilesystem DepFS(SharedCache, InstrumentingFS);
+    DepFS.status("/foo");
+    DepFS.status("/bar");
+    EXPECT_EQ(InstrumentingFS->NumStatusCalls, 5u);
+  }
+}
+
+namespace {
+using clang::dependency_directives_scan::Directive;
+using clang::dependency_directives_scan::Token;
+
+/// Returns \p Stat with its modification time and size replaced.
+llvm::vfs::Status withTimeAndSize(const llvm::vfs::Status &Stat,
+                                  llvm::sys::TimePoint<> MTime, uint64_t Size) {
+  return llvm::vfs::Status(Stat.getName(), Stat.getUniqueID(), MTime,
+                           Stat.getUser(), Stat.getGroup(), Size,
+                           Stat.getType(), Stat.getPermissions());
+}
+
+void expectSameDirectives(llvm::ArrayRef<Directive> LHS,
+                          llvm::ArrayRef<Directive> RHS) {
+  ASSERT_EQ(LHS.size(), RHS.size());
+  for (size_t I = 0; I != LHS.size(); ++I) {
+    EXPECT_EQ(LHS[I].Kind, RHS[I].Kind);
+    ASSERT_EQ(LHS[I].Tokens.size(), RHS[I].Tokens.size());
+    for (size_t J = 0; J != LHS[I].Tokens.size(); ++J) {
+      EXPECT_EQ(LHS[I].Tokens[J].Offset, RHS[I].Tokens[J].Offset);
+      EXPECT_EQ(LHS[I].Tokens[J].Length, RHS[I].Tokens[J].Length);
+      EXPECT_EQ(LHS[I].Tokens[J].Kind, RHS[I].Tokens[J].Kind);
+      EXPECT_EQ(LHS[I].Tokens[J].Flags, RHS[I].Tokens[J].Flags);
+    }
+  }
+}
+
+/// Scans "/foo.h" through a shared cache that persists its directives to
+/// \p CachePath.
+void populatePersistentCache(
+    llvm::StringRef CachePath,
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS) {
+  DependencyScanningFilesystemSharedCache SharedCache;
+  SharedCache.enablePersistentCache(CachePath);
+  DependencyScanningWorkerFilesystem DepFS(SharedCache, FS);
+  auto Entry = DepFS.getOrCreateFileSystemEntry("/foo.h");
+  ASSERT_TRUE(Entry);
+  ASSERT_TRUE(DepFS.ensureDirectiveTokensArePopulated(*Entry));
+}
+} // namespace
+
+TEST(DependencyScanningFilesystem, PersistentCacheRoundTrip) {
+  llvm::SmallString<128> Dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("scan-deps-cache", Dir));
+  llvm::SmallString<128> CachePath(Dir);
+  llvm::sys::path::append(CachePath, "directives");
+
+  llvm::StringRef Source = "#include \"bar.h\"\n#define X 1\nint x;\n";
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo.h", 0, llvm::MemoryBuffer::getMemBuffer(Source));
+  populatePersistentCache(CachePath, InMemoryFS);
+  ASSERT_TRUE(llvm::sys::fs::exists(CachePath));
+
+  llvm::SmallVector<Token> ExpectedTokens;
+  llvm::SmallVector<Directive> Expected;
+  ASSERT_FALSE(clang::scanSourceForDependencyDirectives(Source, ExpectedTokens,
+                                                        Expected));
+
+  // A new cache reads the entry back from disk.
+  DependencyDirectivesPersistentCache Cache(CachePath);
+  llvm::SmallVector<Token> Tokens;
+  llvm::SmallVector<Directive> Directives;
+  ASSERT_TRUE(Cache.lookup(*InMemoryFS->status("/foo.h"), Tokens, Directives));
+  expectSameDirectives(Directives, Expected);
+
+  // The worker filesystem hands out the same directives on a cache hit.
+  DependencyScanningFilesystemSharedCache SharedCache;
+  SharedCache.enablePersistentCache(CachePath);
+  DependencyScanningWorkerFilesystem DepFS(SharedCache, InMemoryFS);
+  auto Entry = DepFS.getOrCreateFileSystemEntry("/foo.h");
+  ASSERT_TRUE(Entry);
+  ASSERT_TRUE(DepFS.ensureDirectiveTokensArePopulated(*Entry));
+  expectSameDirectives(*Entry->getDirectiveTokens(), Expected);
+
+  llvm::sys::fs::remove_directories(Dir);
+}
+
+TEST(DependencyScanningFilesystem, PersistentCacheInvalidation) {
+  llvm::SmallString<128> Dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("scan-deps-cache", Dir));
+  llvm::SmallString<128> CachePath(Dir);
+  llvm::sys::path::append(CachePath, "directives");
+
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define X 1\n"));
+  populatePersistentCache(CachePath, InMemoryFS);
+
+  llvm::vfs::Status Stat = *InMemoryFS->status("/foo.h");
+  DependencyDirectivesPersistentCache Cache(CachePath);
+  llvm::SmallVector<Token> Tokens;
+  llvm::SmallVector<Directive> Directives;
+  EXPECT_TRUE(Cache.lookup(Stat, Tokens, Directives));
+
+  // A file that was modified, or changed size, no longer matches its entry.
+  auto Later = Stat.getLastModificationTime() + std::chrono::seconds(1);
+  EXPECT_FALSE(Cache.lookup(withTimeAndSize(Stat, Later, Stat.getSize()),
+                            Tokens, Directives));
+  EXPECT_FALSE(Cache.lookup(
+      withTimeAndSize(Stat, Stat.getLastModificationTime(), Stat.getSize() + 1),
+      Tokens, Directives));
+
+  // A corrupted cache file is treated as empty.
+  {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(CachePath, EC);
+    ASSERT_FALSE(EC);
+    OS << "garbage";
+  }
+  DependencyDirectivesPersistentCache Corrupted(CachePath);
+  EXPECT_FALSE(Corrupted.lookup(Stat, Tokens, Directives));
+
+  llvm::sys::fs::remove_directories(Dir);
+}
+
+TEST(DependencyScanningFilesystem, PersistentCacheInvalidKind) {
+  llvm::SmallString<128> Dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("scan-deps-cache", Dir));
+  llvm::SmallString<128> CachePath(Dir);
+  llvm::sys::path::append(CachePath, "directives");
+
+  llvm::StringRef Source = "#define X 1\n";
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo.h", 0, llvm::MemoryBuffer::getMemBuffer(Source));
+  populatePersistentCache(CachePath, InMemoryFS);
+
+  // Overwrite the kind of the first directive, which follows the file header,
+  // the key and entry header of the only entry, and its tokens.
+  llvm::SmallVector<Token> Tokens;
+  llvm::SmallVector<Directive> Directives;
+  ASSERT_FALSE(
+      clang::scanSourceForDependencyDirectives(Source, Tokens, Directives));
+  auto Buffer = llvm::MemoryBuffer::getFile(CachePath);
+  ASSERT_TRUE(Buffer);
+  std::string Data = (*Buffer)->getBuffer().str();
+  Buffer->reset();
+  size_t KindOffset = 12 + 32 + 8 + Tokens.size() * 12;
+  ASSERT_LE(KindOffset + 4, Data.size());
+  Data[KindOffset] = '\x7f';
+  {
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(CachePath, EC);
+    ASSERT_FALSE(EC);
+    OS << Data;
+  }
+
+  // The entry is rejected rather than producing an invalid directive kind.
+  DependencyDirectivesPersistentCache Cache(CachePath);
+  EXPECT_FALSE(Cache.lookup(*InMemoryFS->status("/foo.h"), Tokens, Directives));
+  EXPECT_TRUE(Tokens.empty());
+  EXPECT_TRUE(Directives.empty());
+
+  llvm::sys::fs::remove_directories(Dir);
+}
+
+TEST(DependencyScanningFilesystem, PersistentCacheEviction) {
+  llvm::SmallString<128> Dir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("scan-deps-cache", Dir));
+  llvm::SmallString<128> CachePath(Dir);
+  llvm::sys::path::append(CachePath, "directives");
+
+  auto InMemoryFS = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+  InMemoryFS->setCurrentWorkingDirectory("/");
+  InMemoryFS->addFile("/foo.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define X 1\n"));
+  InMemoryFS->addFile("/bar.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define Y 1\n"));
+  InMemoryFS->addFile("/baz.h", 0,
+                      llvm::MemoryBuffer::getMemBuffer("#define Z 1\n"));
+  llvm::vfs::Status Foo = *InMemoryFS->status("/foo.h");
+  llvm::vfs::Status Bar = *InMemoryFS->status("/bar.h");
+  llvm::vfs::Status Baz = *InMemoryFS->status("/baz.h");
+  llvm::SmallVector<Token> Tokens;
+  llvm::SmallVector<Directive> Directives;
+  ASSERT_FALSE(clang::scanSourceForDependencyDirectives("#define X 1\n",
+                                                        Tokens, Directives));
+
+  {
+    DependencyDirectivesPersistentCache Cache(CachePath);
+    Cache.insert(Foo, Directives);
+    Cache.insert(Bar, Directives);
+  }
+
+  // Recording a modified version of foo.h drops the entry of the old one.
+  llvm::vfs::Status NewFoo = withTimeAndSize(
+      Foo, Foo.getLastModificationTime() + std::chrono::seconds(1),
+      Foo.getSize());
+  {
+    DependencyDirectivesPersistentCache Cache(CachePath);
+    Cache.insert(NewFoo, Directives);
+  }
+  {
+    DependencyDirectivesPersistentCache Cache(CachePath);
+    llvm::SmallVector<Token> LookupTokens;
+    llvm::SmallVector<Directive> LookupDirectives;
+    EXPECT_FALSE(Cache.lookup(Foo, LookupTokens, LookupDirectives));
+    EXPECT_TRUE(Cache.lookup(NewFoo, LookupTokens, LookupDirectives));
+    EXPECT_TRUE(Cache.lookup(Bar, LookupTokens, LookupDirectives));
+  }
+
+  // Over the limit, the entries that were not looked up are dropped first.
+  {
+    DependencyDirectivesPersistentCache Cache(CachePath, /*MaxEntries=*/2);
+    llvm::SmallVector<Token> LookupTokens;
+    llvm::SmallVector<Directive> LookupDirectives;
+    EXPECT_TRUE(Cache.lookup(Bar, LookupTokens, LookupDirectives));
+    Cache.insert(Baz, Directives);
+  }
+  {
+    DependencyDirectivesPersistentCache Cache(CachePath);
+    llvm::SmallVector<Token> LookupTokens;
+    llvm::SmallVector<Directive> LookupDirectives;
+    EXPECT_FALSE(Cache.lookup(NewFoo, LookupTokens, LookupDirectives));
+    EXPECT_TRUE(Cache.lookup(Bar, LookupTokens, LookupDirectives));
+    EXPECT_TRUE(Cache.lookup(Baz, LookupTokens, LookupDirectives));
+  }
+
+  llvm::sys::fs::remove_directories(Dir);
+}
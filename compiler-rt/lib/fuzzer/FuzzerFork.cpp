@@ -101,6 +101,7 @@ struct GlobalEnv {
   int Verbosity = 0;
   int Group = 0;
   int NumCorpuses = 8;
+  bool IncrementalMerge = false;
 
   size_t NumTimeouts = 0;
   size_t NumOOMs = 0;
@@ -201,6 +202,8 @@ struct GlobalEnv {
     NumRuns += Stats.number_of_executed_units;
 
     std::vector<SizedFile> TempFiles, MergeCandidates;
+    // Feature sets of MergeCandidates, only kept for incremental merges.
+    std::vector<std::vector<uint32_t>> CandidateFeatures;
     // Read all newly created inputs and their feature sets.
     // Choose only those inputs that have new features.
     GetSizedFilesFromDir(Job->CorpusDir, &TempFiles);
@@ -212,12 +215,18 @@ struct GlobalEnv {
       assert((FeatureBytes.size() % sizeof(uint32_t)) == 0);
       std::vector<uint32_t> NewFeatures(FeatureBytes.size() / sizeof(uint32_t));
       memcpy(NewFeatures.data(), FeatureBytes.data(), FeatureBytes.size());
+      bool HasNewFeatures = false;
       for (auto Ft : NewFeatures) {
         if (!Features.count(Ft)) {
-          MergeCandidates.push_back(F);
+          HasNewFeatures = true;
           break;
         }
       }
+      if (!HasNewFeatures)
+        continue;
+      MergeCandidates.push_back(F);
+      if (IncrementalMerge)
+        CandidateFeatures.push_back(std::move(NewFeatures));
     }
     // if (!FilesToAdd.empty() || Job->ExitCode != 0)
     Printf("#%zd: cov: %zd ft: %zd corp: %zd exec/s: %zd "
@@ -230,11 +239,25 @@ struct GlobalEnv {
 
     std::vector<std::string> FilesToAdd;
     std::set<uint32_t> NewFeatures, NewCov;
-    bool IsSetCoverMerge =
-        !Job->Cmd.getFlagValue("set_cover_merge").compare("1");
-    CrashResistantMerge(Args, {}, MergeCandidates, &FilesToAdd, Features,
-                        &NewFeatures, Cov, &NewCov, Job->CFPath, false,
-                        IsSetCoverMerge);
+    if (IncrementalMerge) {
+      // The job has already recorded the features of its inputs, trust them
+      // rather than running the inputs again. Candidates are sorted by size,
+      // so smaller inputs are preferred.
+      for (size_t i = 0; i < MergeCandidates.size(); i++) {
+        bool Added = false;
+        for (auto Ft : CandidateFeatures[i])
+          if (!Features.count(Ft) && NewFeatures.insert(Ft).second)
+            Added = true;
+        if (Added)
+          FilesToAdd.push_back(MergeCandidates[i].File);
+      }
+    } else {
+      bool IsSetCoverMerge =
+          !Job->Cmd.getFlagValue("set_cover_merge").compare("1");
+      CrashResistantMerge(Args, {}, MergeCandidates, &FilesToAdd, Features,
+                          &NewFeatures, Cov, &NewCov, Job->CFPath, false,
+                          IsSetCoverMerge);
+    }
     for (auto &Path : FilesToAdd) {
       auto U = FileToVector(Path);
       auto NewPath = DirPlusFile(MainCorpusDir, Hash(U));
@@ -322,6 +345,7 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
   Env.ProcessStartTime = std::chrono::system_clock::now();
   Env.DataFlowBinary = Options.CollectDataFlow;
   Env.Group = Options.ForkCorpusGroups;
+  Env.IncrementalMerge = Options.ForkIncrementalMerge;
 
   std::vector<SizedFile> SeedFiles;
   for (auto &Dir : CorpusDirs)
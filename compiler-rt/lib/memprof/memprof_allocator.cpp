@@ -140,6 +140,10 @@ COMPILER_CHECK(kChunkHeaderSize == 32);
 
 struct MemprofChunk : ChunkHeader {
   uptr Beg() { return reinterpret_cast<uptr>(this) + kChunkHeaderSize; }
+  // With allocation sampling, chunks that were not sampled have no stack.
+  bool IsProfiled() const {
+    return alloc_context_id || flags()->allocation_sample_rate <= 1;
+  }
   uptr UsedSize() {
     return atomic_load(&user_requested_size, memory_order_relaxed);
   }
@@ -316,7 +320,7 @@ struct Allocator {
           Allocator *A = (Allocator *)alloc;
           MemprofChunk *m =
               A->GetMemprofChunk((void *)chunk, user_requested_size);
-          if (!m)
+          if (!m || !m->IsProfiled())
             return;
           uptr user_beg = ((uptr)m) + kChunkHeaderSize;
           u64 c = GetShadowCount(user_beg, user_requested_size);
@@ -414,7 +418,7 @@ struct Allocator {
 
     uptr size_rounded_down_to_granularity =
         RoundDownTo(size, SHADOW_GRANULARITY);
-    if (size_rounded_down_to_granularity)
+    if (size_rounded_down_to_granularity && m->IsProfiled())
       ClearShadow(user_beg, size_rounded_down_to_granularity);
 
     MemprofStats &thread_stats = GetCurrentThreadStats();
@@ -450,7 +454,7 @@ struct Allocator {
     u64 user_requested_size =
         atomic_exchange(&m->user_requested_size, 0, memory_order_acquire);
     if (memprof_inited && atomic_load_relaxed(&constructed) &&
-        !atomic_load_relaxed(&destructing)) {
+        !atomic_load_relaxed(&destructing) && m->IsProfiled()) {
       u64 c = GetShadowCount(p, user_requested_size);
       long curtime = GetTimestamp();
 
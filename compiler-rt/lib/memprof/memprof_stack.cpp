@@ -11,7 +11,9 @@
 // Code for MemProf stack trace.
 //===----------------------------------------------------------------------===//
 #include "memprof_stack.h"
+#include "memprof_flags.h"
 #include "memprof_internal.h"
+#include "memprof_thread.h"
 #include "sanitizer_common/sanitizer_atomic.h"
 
 namespace __memprof {
@@ -26,6 +28,17 @@ u32 GetMallocContextSize() {
   return atomic_load(&malloc_context_size, memory_order_acquire);
 }
 
+bool ShouldSampleAllocation() {
+  int rate = flags()->allocation_sample_rate;
+  if (LIKELY(rate <= 1))
+    return true;
+  // Allocations made before the thread is set up are always profiled.
+  MemprofThread *t = GetCurrentThread();
+  if (!t)
+    return true;
+  return t->ShouldSampleAllocation(static_cast<u32>(rate));
+}
+
 } // namespace __memprof
 
 void __sanitizer::BufferedStackTrace::UnwindImpl(uptr pc, uptr bp,
@@ -26,6 +26,10 @@ static const u32 kDefaultMallocContextSize = 30;
 void SetMallocContextSize(u32 size);
 u32 GetMallocContextSize();
 
+// Returns whether the allocation about to be made by the current thread should
+// be profiled, according to the allocation_sample_rate flag.
+bool ShouldSampleAllocation();
+
 } // namespace __memprof
 
 // NOTE: A Rule of thumb is to retrieve stack trace in the interceptors
@@ -52,10 +56,14 @@ u32 GetMallocContextSize();
 
 #define GET_STACK_TRACE_THREAD GET_STACK_TRACE(kStackTraceMax, true)
 
+// Allocations that are not sampled get an empty stack, which also tells the
+// allocator not to profile them.
 #define GET_STACK_TRACE_MALLOC                                                 \
-  GET_STACK_TRACE(GetMallocContextSize(), common_flags()->fast_unwind_on_malloc)
+  GET_STACK_TRACE(ShouldSampleAllocation() ? GetMallocContextSize() : 0,      \
+                  common_flags()->fast_unwind_on_malloc)
 
-#define GET_STACK_TRACE_FREE GET_STACK_TRACE_MALLOC
+#define GET_STACK_TRACE_FREE                                                   \
+  GET_STACK_TRACE(GetMallocContextSize(), common_flags()->fast_unwind_on_malloc)
 
 #define PRINT_CURRENT_STACK()                                                  \
   {                                                                            \
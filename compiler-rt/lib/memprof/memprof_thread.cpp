@@ -133,6 +133,24 @@ void MemprofThread::Init(const InitOptions *options) {
           (void *)&local);
 }
 
+bool MemprofThread::ShouldSampleAllocation(u32 rate) {
+  if (LIKELY(sample_countdown_ > 1)) {
+    sample_countdown_--;
+    return false;
+  }
+  u32 state = sample_rand_state_;
+  if (UNLIKELY(!state))
+    state = (static_cast<u32>(MonotonicNanoTime()) ^ (tid() << 16)) | 1;
+  // xorshift32.
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  sample_rand_state_ = state;
+  // Uniform in [1, 2 * rate - 1], so one in rate allocations on average.
+  sample_countdown_ = state % (2 * rate - 1) + 1;
+  return true;
+}
+
 thread_return_t
 MemprofThread::ThreadStart(tid_t os_id,
                            atomic_uintptr_t *signal_thread_is_registered) {
@@ -89,6 +89,11 @@ public:
   MemprofThreadLocalMallocStorage &malloc_storage() { return malloc_storage_; }
   MemprofStats &stats() { return stats_; }
 
+  // Returns true for about one in rate allocations made by this thread. The
+  // gaps between sampled allocations are random, so that periodic allocation
+  // patterns are not systematically missed.
+  bool ShouldSampleAllocation(u32 rate);
+
 private:
   // NOTE: There is no MemprofThread constructor. It is allocated
   // via mmap() and *must* be valid in zero-initialized state.
@@ -115,6 +120,10 @@ private:
   MemprofThreadLocalMallocStorage malloc_storage_;
   MemprofStats stats_;
   bool unwinding_;
+  // Allocations left until the next sampled one, and the state of the random
+  // generator used to pick that distance.
+  u32 sample_countdown_;
+  u32 sample_rand_state_;
 };
 
 // Returns a single instance of registry.
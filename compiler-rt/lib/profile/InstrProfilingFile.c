@@ -276,6 +276,15 @@ static int mmapForContinuousMode(uint64_t CurrentFileOffset, FILE *File) {
 }
 #endif
 
+/* Return the counters that continuous mode keeps in sync with the file. */
+static char *getContinuousModeCounters(void) {
+  char *Counters = __llvm_profile_begin_counters();
+#if !defined(__APPLE__) && (defined(__ELF__) || defined(_WIN32))
+  Counters += INSTR_PROF_PROFILE_COUNTER_BIAS_VAR;
+#endif
+  return Counters;
+}
+
 static int isProfileMergeRequested(void) { return ProfileMergeRequested; }
 static void setProfileMergeRequested(int EnableMerge) {
   ProfileMergeRequested = EnableMerge;
@@ -1097,6 +1106,11 @@ int __llvm_profile_write_file(void) {
   // Temporarily suspend getting SIGKILL when the parent exits.
   int PDeathSig = lprofSuspendSigKill();
 
+  /* The file is updated in place in continuous mode, except for the counts
+   * still held in per-thread counter copies. */
+  if (__llvm_profile_is_continuous_mode_enabled())
+    lprofFoldThreadCounters(getContinuousModeCounters());
+
   if (lprofProfileDumped() || __llvm_profile_is_continuous_mode_enabled()) {
     PROF_NOTE("Profile data not written to file: %s.\n", "already written");
     if (PDeathSig == 1)
@@ -189,6 +189,14 @@ uint64_t lprofGetLoadModuleSignature();
 unsigned lprofProfileDumped(void);
 void lprofSetProfileDumped(unsigned);
 
+/*
+ * Add the per-thread counter copies of -instrprof-thread-local-counters
+ * to the counter section starting at \p Dst, emptying the copies.
+ */
+void lprofFoldThreadCounters(char *Dst);
+/* Reset the per-thread counter copies. */
+void lprofResetThreadCounters(void);
+
 COMPILER_RT_VISIBILITY extern void (*FreeHook)(void *);
 COMPILER_RT_VISIBILITY extern uint8_t *DynamicBufferIOBuffer;
 COMPILER_RT_VISIBILITY extern uint32_t VPBufferSize;
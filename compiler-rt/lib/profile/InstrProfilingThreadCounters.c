@@ -0,0 +1,127 @@
+/*===- InstrProfilingThreadCounters.c - Per-thread profile counters -------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+|*===----------------------------------------------------------------------===*
+|* Code built with -instrprof-thread-local-counters addresses its counters
+|* relative to a thread-local bias, so that every thread increments a private
+|* copy of the counter section instead of contending on the shared one. The
+|* copies are folded into the shared counters before the profile is written.
+\*===----------------------------------------------------------------------===*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+
+typedef struct ThreadCounters {
+  struct ThreadCounters *Next;
+  /* The counts of the copy as of the last fold. Only the owning thread writes
+   * to Counters, so folding adds the difference and leaves the live counters
+   * untouched. Not used for byte coverage. */
+  uint64_t *Folded;
+  /* Keep the counters 8-byte aligned on 32-bit hosts too. */
+  uint64_t Counters[];
+} ThreadCounters;
+
+/* All the counter copies ever created. Copies are never freed, since the
+ * runtime has no portable way to learn about thread exit; their counts are
+ * still folded in when the profile is written. */
+static ThreadCounters *ThreadCountersList;
+static int ThreadCountersAllocFailed;
+
+/* The instrumented code loads this as a 64-bit integer. */
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL int64_t
+    INSTR_PROF_PROFILE_THREAD_COUNTER_BIAS_VAR;
+
+/* Set while the current thread allocates its copy. malloc may itself be
+ * instrumented and call back into the initialization before the bias is set;
+ * those calls use the shared counters. */
+static COMPILER_RT_THREAD_LOCAL int InInitThreadCounters;
+
+static int isByteCoverage(void) {
+  return (__llvm_profile_get_version() & VARIANT_MASK_BYTE_COVERAGE) != 0;
+}
+
+/* Called by instrumented code when the bias of the current thread is zero. */
+COMPILER_RT_VISIBILITY int64_t
+INSTR_PROF_PROFILE_INIT_THREAD_COUNTERS_FUNC(void) {
+  char *CountersBegin = __llvm_profile_begin_counters();
+  char *CountersEnd = __llvm_profile_end_counters();
+  size_t Size = CountersEnd - CountersBegin;
+  size_t AllocSize = sizeof(ThreadCounters) + Size;
+  ThreadCounters *TC;
+
+  /* Fall back to the shared counters, which is still correct, just slower. */
+  if (ThreadCountersAllocFailed || InInitThreadCounters)
+    return 0;
+  if (!isByteCoverage())
+    AllocSize += Size;
+  InInitThreadCounters = 1;
+  TC = (ThreadCounters *)malloc(AllocSize);
+  InInitThreadCounters = 0;
+  if (!TC) {
+    ThreadCountersAllocFailed = 1;
+    PROF_WARN("%s\n", "unable to allocate thread-local profile counters, "
+                      "falling back to shared counters");
+    return 0;
+  }
+  memset(TC->Counters, isByteCoverage() ? 0xFF : 0, Size);
+  TC->Folded = 0;
+  if (!isByteCoverage()) {
+    TC->Folded = (uint64_t *)((char *)TC->Counters + Size);
+    memset(TC->Folded, 0, Size);
+  }
+
+  do {
+    TC->Next = ThreadCountersList;
+  } while (!COMPILER_RT_BOOL_CMPXCHG(&ThreadCountersList, TC->Next, TC));
+
+  INSTR_PROF_PROFILE_THREAD_COUNTER_BIAS_VAR =
+      (int64_t)((intptr_t)TC->Counters - (intptr_t)CountersBegin);
+  return INSTR_PROF_PROFILE_THREAD_COUNTER_BIAS_VAR;
+}
+
+COMPILER_RT_VISIBILITY void lprofFoldThreadCounters(char *Dst) {
+  size_t Size =
+      __llvm_profile_end_counters() - __llvm_profile_begin_counters();
+  int ByteCoverage = isByteCoverage();
+  ThreadCounters *TC;
+  size_t I;
+
+  for (TC = ThreadCountersList; TC; TC = TC->Next) {
+    char *Src = (char *)TC->Counters;
+    if (ByteCoverage) {
+      /* A zero byte marks a block covered by any of the threads. */
+      for (I = 0; I < Size; ++I)
+        Dst[I] &= Src[I];
+      continue;
+    }
+    /* The owning thread may keep incrementing its copy with plain stores, so
+     * only read it: add what was counted since the last fold and remember
+     * the value that was added up to. Folds are serialized by the writers. */
+    for (I = 0; I < Size / sizeof(uint64_t); ++I) {
+#if COMPILER_RT_HAS_ATOMICS == 1 && !defined(_MSC_VER)
+      uint64_t Count = __atomic_load_n(&TC->Counters[I], __ATOMIC_RELAXED);
+#else
+      uint64_t Count = TC->Counters[I];
+#endif
+      ((uint64_t *)Dst)[I] += Count - TC->Folded[I];
+      TC->Folded[I] = Count;
+    }
+  }
+}
+
+COMPILER_RT_VISIBILITY void lprofResetThreadCounters(void) {
+  size_t Size =
+      __llvm_profile_end_counters() - __llvm_profile_begin_counters();
+  ThreadCounters *TC;
+  for (TC = ThreadCountersList; TC; TC = TC->Next) {
+    memset(TC->Counters, isByteCoverage() ? 0xFF : 0, Size);
+    if (TC->Folded)
+      memset(TC->Folded, 0, Size);
+  }
+}
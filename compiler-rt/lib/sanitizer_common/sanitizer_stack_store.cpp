@@ -67,6 +67,23 @@ StackTrace StackStore::Load(Id id) {
   return StackTrace(stack_trace + 1, h.size, h.tag);
 }
 
+bool StackStore::Equals(Id id, const StackTrace &trace) const {
+  if (!id)
+    return false;
+  uptr idx = IdToOffset(id);
+  uptr block_idx = GetBlockIdx(idx);
+  CHECK_LT(block_idx, ARRAY_SIZE(blocks_));
+  const BlockInfo &block = blocks_[block_idx];
+  const uptr *stack_trace = block.Get();
+  if (!stack_trace || block.IsPackedRelaxed())
+    return false;
+  stack_trace += GetInBlockIdx(idx);
+  StackTraceHeader h(*stack_trace);
+  return h.size == trace.size && h.tag == trace.tag &&
+         internal_memcmp(stack_trace + 1, trace.trace,
+                         trace.size * sizeof(uptr)) == 0;
+}
+
 uptr StackStore::Allocated() const {
   return atomic_load_relaxed(&allocated_) + sizeof(*this);
 }
@@ -38,6 +38,9 @@ class StackStore {
   Id Store(const StackTrace &trace,
            uptr *pack /* number of blocks completed by this call */);
   StackTrace Load(Id id);
+  // Returns whether the trace stored under id is the same as trace. Unlike
+  // Load, it never unpacks a block, and must not race with Pack().
+  bool Equals(Id id, const StackTrace &trace) const;
   uptr Allocated() const;
 
   // Packs all blocks which don't expect any more writes. A block is going to be
@@ -103,6 +106,9 @@ class StackStore {
 
    public:
     uptr *Get() const;
+    bool IsPackedRelaxed() const SANITIZER_NO_THREAD_SAFETY_ANALYSIS {
+      return state == State::Packed;
+    }
     uptr *GetOrCreate(StackStore *store);
     uptr *GetOrUnpack(StackStore *store);
     uptr Pack(Compression type, StackStore *store);
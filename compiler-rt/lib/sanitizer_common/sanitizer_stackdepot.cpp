@@ -46,6 +46,7 @@ struct StackDepotNode {
   void store(u32 id, const args_type &args, hash_type hash);
   args_type load(u32 id) const;
   static StackDepotHandle get_handle(u32 id);
+  static bool stored_equals(u32 id, const args_type &args);
 
   typedef StackDepotHandle handle_type;
 };
@@ -205,10 +206,62 @@ StackDepotNode::args_type StackDepotNode::load(u32 id) const {
 
 StackDepotStats StackDepotGetStats() { return theDepot.GetStats(); }
 
-u32 StackDepotPut(StackTrace stack) { return theDepot.Put(stack); }
+// Programs tend to allocate repeatedly from the same few call sites. Each
+// thread remembers the ids of the stacks it put last, so that such stacks are
+// found with a comparison against the stored frames instead of hashing them
+// and probing the depot. Stored frames can only be compared in place while the
+// depot is never compressed.
+#if SANITIZER_SUPPORTS_THREADLOCAL && !SANITIZER_GO && !SANITIZER_APPLE && \
+    !SANITIZER_WINDOWS
+#  define SANITIZER_STACKDEPOT_THREAD_CACHE 1
+#else
+#  define SANITIZER_STACKDEPOT_THREAD_CACHE 0
+#endif
+
+#if SANITIZER_STACKDEPOT_THREAD_CACHE
+static constexpr uptr kThreadCacheSize = 8;
+// Bumped when the depot is reset, which invalidates all the thread caches.
+static atomic_uint32_t depotGeneration;
+
+struct StackDepotThreadCache {
+  u32 generation;
+  u32 ids[kThreadCacheSize];
+};
+// Accessed from malloc, so cannot use the global-dynamic TLS model.
+__attribute__((tls_model("initial-exec"))) static THREADLOCAL
+    StackDepotThreadCache threadCache;
+
+static uptr ThreadCacheSlot(const StackTrace &stack) {
+  uptr key = stack.trace[0] ^ (stack.trace[stack.size - 1] >> 2) ^ stack.size;
+  return (key ^ (key >> 16)) % kThreadCacheSize;
+}
+#endif
+
+static u32 PutCached(StackTrace stack) {
+#if SANITIZER_STACKDEPOT_THREAD_CACHE
+  if (common_flags()->compress_stack_depot || !StackDepotNode::is_valid(stack))
+    return theDepot.Put(stack);
+  StackDepotThreadCache &cache = threadCache;
+  u32 generation = atomic_load_relaxed(&depotGeneration);
+  if (UNLIKELY(cache.generation != generation)) {
+    internal_memset(cache.ids, 0, sizeof(cache.ids));
+    cache.generation = generation;
+  }
+  u32 &cached = cache.ids[ThreadCacheSlot(stack)];
+  if (cached && StackDepotNode::stored_equals(cached, stack))
+    return cached;
+  u32 id = theDepot.Put(stack);
+  cached = id;
+  return id;
+#else
+  return theDepot.Put(stack);
+#endif
+}
+
+u32 StackDepotPut(StackTrace stack) { return PutCached(stack); }
 
 StackDepotHandle StackDepotPut_WithHandle(StackTrace stack) {
-  return StackDepotNode::get_handle(theDepot.Put(stack));
+  return StackDepotNode::get_handle(PutCached(stack));
 }
 
 StackTrace StackDepotGet(u32 id) {
@@ -239,9 +292,16 @@ StackDepotHandle StackDepotNode::get_handle(u32 id) {
   return StackDepotHandle(&theDepot.nodes[id], id);
 }
 
+bool StackDepotNode::stored_equals(u32 id, const args_type &args) {
+  return stackStore.Equals(theDepot.nodes[id].store_id, args);
+}
+
 void StackDepotTestOnlyUnmap() {
   theDepot.TestOnlyUnmap();
   stackStore.TestOnlyUnmap();
+#if SANITIZER_STACKDEPOT_THREAD_CACHE
+  atomic_fetch_add(&depotGeneration, 1, memory_order_relaxed);
+#endif
 }
 
 } // namespace __sanitizer
@@ -84,6 +84,27 @@ TEST_F(StackDepotTest, Several) {
   EXPECT_NE(i1, i2);
 }
 
+TEST_F(StackDepotTest, SameEnds) {
+  // These stacks only differ in the middle and by tag, and are remembered in
+  // the same slot of the thread cache.
+  uptr array1[] = {1, 2, 3, 4, 7};
+  uptr array2[] = {1, 2, 5, 4, 7};
+  StackTrace s1(array1, ARRAY_SIZE(array1));
+  StackTrace s2(array2, ARRAY_SIZE(array2));
+  StackTrace s3(array1, ARRAY_SIZE(array1), /*tag=*/1);
+  u32 i1 = StackDepotPut(s1);
+  u32 i2 = StackDepotPut(s2);
+  u32 i3 = StackDepotPut(s3);
+  EXPECT_NE(i1, i2);
+  EXPECT_NE(i1, i3);
+  EXPECT_NE(i2, i3);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(i1, StackDepotPut(s1));
+    EXPECT_EQ(i2, StackDepotPut(s2));
+    EXPECT_EQ(i3, StackDepotPut(s3));
+  }
+}
+
 TEST_F(StackDepotTest, Print) {
   uptr array1[] = {0x111, 0x222, 0x333, 0x444, 0x777};
   StackTrace s1(array1, ARRAY_SIZE(array1));
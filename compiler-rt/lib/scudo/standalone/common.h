@@ -157,6 +157,9 @@ u64 getMonotonicTimeFast();
 
 u32 getThreadID();
 
+// Returns the CPU the calling thread is running on, or -1 if unknown.
+s32 getCurrentCPU();
+
 // Our randomness gathering function is limited to 256 bytes to ensure we get
 // as many bytes as requested, and avoid interruptions (on Linux).
 constexpr uptr MaxRandomLength = 256U;
@@ -169,6 +172,8 @@ bool getRandom(void *Buffer, uptr Length, bool Blocking = false);
 #define MAP_RESIZABLE (1U << 2)
 #define MAP_MEMTAG (1U << 3)
 #define MAP_PRECOMMIT (1U << 4)
+// Hint that the mapping should be backed by transparent huge pages.
+#define MAP_HUGEPAGES (1U << 5)
 
 // Our platform memory mapping use is restricted to 3 scenarios:
 // - reserve memory at a random address (MAP_NOACCESS);
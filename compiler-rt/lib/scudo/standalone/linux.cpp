@@ -167,6 +167,12 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+s32 getCurrentCPU() {
+  // With a recent libc this reads the CPU number from the restartable
+  // sequences area registered for the thread, or falls back to the vDSO.
+  return static_cast<s32>(sched_getcpu());
+}
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
@@ -68,6 +68,11 @@ static void *mmapWrapper(uptr Addr, uptr Size, const char *Name, uptr Flags) {
       reportMapError(errno == ENOMEM ? Size : 0);
     return nullptr;
   }
+#ifdef MADV_HUGEPAGE
+  // This is only a hint, keep going with base pages if it is refused.
+  if (Flags & MAP_HUGEPAGES)
+    madvise(P, Size, MADV_HUGEPAGE);
+#endif
 #if SCUDO_ANDROID
   if (Name)
     prctl(ANDROID_PR_SET_VMA, ANDROID_PR_SET_VMA_ANON_NAME, P, Size, Name);
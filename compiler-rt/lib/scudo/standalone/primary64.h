@@ -1053,7 +1053,9 @@ private:
               RegionBeg + MappedUser, MapSize, "scudo:primary",
               MAP_ALLOWNOMEM | MAP_RESIZABLE |
                   (useMemoryTagging<Config>(Options.load()) ? MAP_MEMTAG
-                                                            : 0)))) {
+                                                            : 0) |
+                  (Config::getEnableTransparentHugePages() ? MAP_HUGEPAGES
+                                                           : 0)))) {
         return 0U;
       }
       Region->MemMapInfo.MappedUser += MapSize;
@@ -493,6 +493,104 @@ private:
       Quarantine GUARDED_BY(Mutex) = {};
 };
 
+// A secondary cache split into several independently locked shards, so that
+// threads allocating and freeing large blocks concurrently don't all contend
+// on a single cache mutex. Each thread prefers one shard, derived from its
+// stack address, and only looks into the other shards when its own shard
+// can't satisfy a request. The configured maximum entries count is split
+// evenly between the shards.
+template <typename Config> class MapAllocatorShardedCache {
+public:
+  static constexpr u32 NumShards = Config::getShardCount();
+  static_assert(NumShards > 0, "");
+
+  void getStats(ScopedString *Str) {
+    for (u32 I = 0; I < NumShards; I++) {
+      Str->append("Stats: MapAllocatorShardedCache: Shard %u\n", I);
+      Shards[I].getStats(Str);
+    }
+  }
+
+  void init(s32 ReleaseToOsInterval) {
+    for (u32 I = 0; I < NumShards; I++)
+      Shards[I].init(ReleaseToOsInterval);
+    setOption(Option::MaxCacheEntriesCount,
+              static_cast<sptr>(Config::getDefaultMaxEntriesCount()));
+  }
+
+  void store(const Options &Options, LargeBlock::Header *H) {
+    Shards[getPreferredShard()].store(Options, H);
+  }
+
+  bool retrieve(Options Options, uptr Size, uptr Alignment, uptr HeadersSize,
+                LargeBlock::Header **H, bool *Zeroed) {
+    const u32 Preferred = getPreferredShard();
+    for (u32 I = 0; I < NumShards; I++) {
+      if (Shards[(Preferred + I) % NumShards].retrieve(
+              Options, Size, Alignment, HeadersSize, H, Zeroed))
+        return true;
+    }
+    return false;
+  }
+
+  bool canCache(uptr Size) { return Shards[0].canCache(Size); }
+
+  bool setOption(Option O, sptr Value) {
+    if (O == Option::MaxCacheEntriesCount) {
+      // Round up so that a non-zero total never disables any shard.
+      const sptr PerShard =
+          (Value + static_cast<sptr>(NumShards) - 1) / NumShards;
+      if (PerShard > static_cast<sptr>(Config::getEntriesArraySize()))
+        return false;
+      Value = PerShard;
+    }
+    bool Result = true;
+    for (u32 I = 0; I < NumShards; I++)
+      Result &= Shards[I].setOption(O, Value);
+    return Result;
+  }
+
+  void releaseToOS() {
+    for (u32 I = 0; I < NumShards; I++)
+      Shards[I].releaseToOS();
+  }
+
+  void disableMemoryTagging() {
+    for (u32 I = 0; I < NumShards; I++)
+      Shards[I].disableMemoryTagging();
+  }
+
+  void disable() {
+    for (u32 I = 0; I < NumShards; I++)
+      Shards[I].disable();
+  }
+
+  void enable() {
+    for (u32 I = NumShards; I > 0; I--)
+      Shards[I - 1].enable();
+  }
+
+  void unmapTestOnly() {
+    for (u32 I = 0; I < NumShards; I++)
+      Shards[I].unmapTestOnly();
+  }
+
+private:
+  static u32 getPreferredShard() {
+    if (NumShards == 1)
+      return 0;
+    // Thread stacks live in distinct mappings, so the upper bits of a stack
+    // address are stable for a thread and differ between threads. This is
+    // much cheaper than querying the thread or CPU id.
+    uptr StackAddress = reinterpret_cast<uptr>(&StackAddress);
+    return static_cast<u32>(((StackAddress >> 16) * 0x9E3779B97F4A7C15ULL) >>
+                            32) %
+           NumShards;
+  }
+
+  MapAllocatorCache<Config> Shards[NumShards];
+};
+
 template <typename Config> class MapAllocator {
 public:
   void init(GlobalStats *S,
@@ -117,10 +117,48 @@ struct TestConfig {
   };
 };
 
+struct TestShardedConfig {
+  static const bool MaySupportMemoryTagging = false;
+  template <typename> using TSDRegistryT = void;
+  template <typename> using PrimaryT = void;
+  template <typename> using SecondaryT = void;
+
+  struct Secondary {
+    struct Cache {
+      static const scudo::u32 EntriesArraySize = 32U;
+      static const scudo::u32 QuarantineSize = 0U;
+      static const scudo::u32 DefaultMaxEntriesCount = 32U;
+      static const scudo::uptr DefaultMaxEntrySize = 1UL << 20;
+      static const scudo::s32 MinReleaseToOsIntervalMs = INT32_MIN;
+      static const scudo::s32 MaxReleaseToOsIntervalMs = INT32_MAX;
+      static const scudo::u32 ShardCount = 4U;
+    };
+
+    template <typename Config>
+    using CacheT = scudo::MapAllocatorShardedCache<Config>;
+  };
+};
+
 TEST(ScudoSecondaryTest, SecondaryBasic) {
   testSecondaryBasic<NoCacheConfig>();
   testSecondaryBasic<scudo::DefaultConfig>();
   testSecondaryBasic<TestConfig>();
+  testSecondaryBasic<TestShardedConfig>();
+}
+
+TEST(ScudoSecondaryTest, SecondaryShardedCacheOptions) {
+  using SecondaryT =
+      scudo::MapAllocator<scudo::SecondaryConfig<TestShardedConfig>>;
+  std::unique_ptr<SecondaryT> L(new SecondaryT);
+  L->init(nullptr);
+  // The entries count is split between the 4 shards of 32 entries each.
+  EXPECT_TRUE(L->setOption(scudo::Option::MaxCacheEntriesCount, 128));
+  EXPECT_FALSE(L->setOption(scudo::Option::MaxCacheEntriesCount, 129));
+  EXPECT_TRUE(L->setOption(scudo::Option::MaxCacheEntriesCount, 1));
+  EXPECT_TRUE(L->canCache(1UL << 16));
+  EXPECT_TRUE(L->setOption(scudo::Option::MaxCacheEntriesCount, 0));
+  EXPECT_FALSE(L->canCache(1UL << 16));
+  L->unmapTestOnly();
 }
 
 struct MapAllocatorTest : public Test {
@@ -0,0 +1,199 @@
+//===-- tsd_percpu.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_TSD_PERCPU_H_
+#define SCUDO_TSD_PERCPU_H_
+
+#include "tsd.h"
+
+#include "string_utils.h"
+
+#if SCUDO_HAS_PLATFORM_TLS_SLOT
+// See tsd_shared.h for the requirements on this header.
+#include "scudo_platform_tls_slot.h"
+#endif
+
+namespace scudo {
+
+// A TSD registry that associates each CPU with its own TSD, rather than each
+// thread (TSDRegistryExT) or a pool of TSDs shared based on contention
+// (TSDRegistrySharedT). The memory used by the caches scales with the number
+// of CPUs instead of the number of threads, and since only the threads that
+// are currently running on a given CPU compete for its TSD, the lock is almost
+// always uncontended. The current CPU is queried on every access, which on
+// Linux is backed by the restartable sequences area or the vDSO.
+//
+// A thread can be preempted or migrated while holding a TSD, so TSDs are still
+// locked; the lock only protects against those rare cases. If the current CPU
+// can't be determined, threads are spread over the TSDs in a round-robin
+// fashion.
+template <class Allocator, u32 TSDsArraySize>
+struct TSDRegistryPerCPUT {
+  using ThisT = TSDRegistryPerCPUT<Allocator, TSDsArraySize>;
+
+  struct ScopedTSD {
+    ALWAYS_INLINE ScopedTSD(ThisT &TSDRegistry) {
+      CurrentTSD = TSDRegistry.getTSDAndLock();
+      DCHECK_NE(CurrentTSD, nullptr);
+    }
+
+    ~ScopedTSD() { CurrentTSD->unlock(); }
+
+    TSD<Allocator> &operator*() { return *CurrentTSD; }
+
+    TSD<Allocator> *operator->() {
+      CurrentTSD->assertLocked(/*BypassCheck=*/false);
+      return CurrentTSD;
+    }
+
+  private:
+    TSD<Allocator> *CurrentTSD;
+  };
+
+  void init(Allocator *Instance) REQUIRES(Mutex) {
+    DCHECK(!Initialized);
+    Instance->init();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].init(Instance);
+    const u32 NumberOfCPUs = getNumberOfCPUs();
+    const u32 N =
+        (NumberOfCPUs == 0) ? TSDsArraySize : Min(NumberOfCPUs, TSDsArraySize);
+    atomic_store_relaxed(&NumberOfTSDs, N);
+    Initialized = true;
+  }
+
+  void initOnceMaybe(Allocator *Instance) EXCLUDES(Mutex) {
+    ScopedLock L(Mutex);
+    if (LIKELY(Initialized))
+      return;
+    init(Instance); // Sets Initialized.
+  }
+
+  void unmapTestOnly(Allocator *Instance) EXCLUDES(Mutex) {
+    for (u32 I = 0; I < TSDsArraySize; I++) {
+      TSDs[I].commitBack(Instance);
+      TSDs[I] = {};
+    }
+    *getTlsPtr() = 0;
+    ScopedLock L(Mutex);
+    Initialized = false;
+  }
+
+  void drainCaches(Allocator *Instance) {
+    for (u32 I = 0; I < getNumberOfTSDs(); ++I) {
+      TSDs[I].lock();
+      Instance->drainCache(&TSDs[I]);
+      TSDs[I].unlock();
+    }
+  }
+
+  ALWAYS_INLINE void initThreadMaybe(Allocator *Instance,
+                                     UNUSED bool MinimalInit) {
+    if (LIKELY(*getTlsPtr() & ThreadInitializedBit))
+      return;
+    initThread(Instance);
+  }
+
+  void disable() NO_THREAD_SAFETY_ANALYSIS {
+    Mutex.lock();
+    for (u32 I = 0; I < TSDsArraySize; I++)
+      TSDs[I].lock();
+  }
+
+  void enable() NO_THREAD_SAFETY_ANALYSIS {
+    for (s32 I = static_cast<s32>(TSDsArraySize - 1); I >= 0; I--)
+      TSDs[I].unlock();
+    Mutex.unlock();
+  }
+
+  bool setOption(Option O, sptr Value) {
+    if (O == Option::ThreadDisableMemInit)
+      setDisableMemInit(Value);
+    // The number of TSDs is tied to the number of CPUs, so MaxTSDsCount is
+    // not supported by the TSD Registry, but not an error either.
+    return true;
+  }
+
+  bool getDisableMemInit() const { return *getTlsPtr() & DisableMemInitBit; }
+
+  void getStats(ScopedString *Str) {
+    const u32 N = getNumberOfTSDs();
+    Str->append("Stats: PerCPUTSDs: %u available; total %u\n", N,
+                TSDsArraySize);
+    for (uptr I = 0; I < N; ++I) {
+      TSDs[I].lock();
+      // See the comment in TSDRegistrySharedT::getStats.
+      TSDs[I].assertLocked(/*BypassCheck=*/true);
+      Str->append("  PerCPU TSD[%zu]:\n", I);
+      TSDs[I].getCache().getStats(Str);
+      TSDs[I].unlock();
+    }
+  }
+
+private:
+  static constexpr uptr DisableMemInitBit = 1U << 0;
+  static constexpr uptr ThreadInitializedBit = 1U << 1;
+  // The remaining bits hold the fallback index of the thread.
+  static constexpr uptr FallbackIndexShift = 2U;
+
+  ALWAYS_INLINE TSD<Allocator> *getTSDAndLock() NO_THREAD_SAFETY_ANALYSIS {
+    TSD<Allocator> *TSD = &TSDs[getCurrentIndex()];
+    // The lock is only contended if the previous owner was preempted or
+    // migrated while holding it, so spin on the TSD rather than looking for
+    // another one.
+    TSD->lock();
+    return TSD;
+  }
+
+  ALWAYS_INLINE u32 getCurrentIndex() {
+    const u32 N = getNumberOfTSDs();
+    if (N == 1U)
+      return 0U;
+    const s32 CPU = getCurrentCPU();
+    if (LIKELY(CPU >= 0))
+      return static_cast<u32>(CPU) % N;
+    return static_cast<u32>(*getTlsPtr() >> FallbackIndexShift) % N;
+  }
+
+  ALWAYS_INLINE u32 getNumberOfTSDs() const {
+    return atomic_load_relaxed(&NumberOfTSDs);
+  }
+
+  ALWAYS_INLINE uptr *getTlsPtr() const {
+#if SCUDO_HAS_PLATFORM_TLS_SLOT
+    return reinterpret_cast<uptr *>(getPlatformAllocatorTlsSlot());
+#else
+    static thread_local uptr ThreadState;
+    return &ThreadState;
+#endif
+  }
+
+  void setDisableMemInit(bool B) {
+    *getTlsPtr() &= ~DisableMemInitBit;
+    *getTlsPtr() |= B ? DisableMemInitBit : 0U;
+  }
+
+  NOINLINE void initThread(Allocator *Instance) NO_THREAD_SAFETY_ANALYSIS {
+    initOnceMaybe(Instance);
+    const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
+    *getTlsPtr() |= ThreadInitializedBit |
+                    (static_cast<uptr>(Index) << FallbackIndexShift);
+    Instance->callPostInitCallback();
+  }
+
+  atomic_u32 CurrentIndex = {};
+  // Only written once at initialization, read on the fast path.
+  atomic_u32 NumberOfTSDs = {};
+  bool Initialized GUARDED_BY(Mutex) = false;
+  HybridMutex Mutex;
+  TSD<Allocator> TSDs[TSDsArraySize];
+};
+
+} // namespace scudo
+
+#endif // SCUDO_TSD_PERCPU_H_
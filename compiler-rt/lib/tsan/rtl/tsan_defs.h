@@ -36,6 +36,24 @@ typedef __m128i m128;
 #  define VECTOR_ALIGNED
 #endif
 
+// With AVX2 the shadow of two adjacent cells is checked at once. This is a
+// compile-time choice: the runtime is built for the baseline ISA by default,
+// so the AVX2 path is only used when the runtime itself is compiled with
+// -mavx2 (e.g. added to CMAKE_CXX_FLAGS), and a runtime built that way
+// requires a CPU with AVX2. There is no runtime dispatch.
+#ifndef TSAN_VECTORIZE_AVX2
+#  if TSAN_VECTORIZE && defined(__AVX2__)
+#    define TSAN_VECTORIZE_AVX2 1
+#  else
+#    define TSAN_VECTORIZE_AVX2 0
+#  endif
+#endif
+
+#if TSAN_VECTORIZE_AVX2
+#  include <immintrin.h>
+typedef __m256i m256;
+#endif
+
 // Setup defaults for compile definitions.
 #ifndef TSAN_NO_HISTORY
 # define TSAN_NO_HISTORY 0
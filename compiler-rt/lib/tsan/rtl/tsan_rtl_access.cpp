@@ -386,6 +386,32 @@ SHARED:
     const m128 shadow = _mm_load_si128(reinterpret_cast<m128*>(shadow_mem))
 #endif
 
+#if TSAN_VECTORIZE_AVX2
+// Same as ContainsSameAccess, but for the two adjacent shadow cells starting
+// at shadow_mem. Returns true only if both cells contain the access.
+ALWAYS_INLINE
+bool ContainsSameAccess2(RawShadow* shadow_mem, Shadow cur, AccessType typ) {
+  const m256 access = _mm256_set1_epi32(static_cast<u32>(cur.raw()));
+  // Two cells are 32 bytes, but are only guaranteed to be 16-byte aligned.
+  const m256 shadow =
+      _mm256_loadu_si256(reinterpret_cast<const m256*>(shadow_mem));
+  m256 same;
+  if (!(typ & kAccessRead)) {
+    same = _mm256_cmpeq_epi32(shadow, access);
+  } else {
+    const m256 read_mask =
+        _mm256_set1_epi32(static_cast<u32>(Shadow::kRodata));
+    same = _mm256_cmpeq_epi32(_mm256_or_si256(shadow, read_mask), access);
+    if (!(typ & kAccessNoRodata) && !SANITIZER_GO)
+      same = _mm256_or_si256(same, _mm256_cmpeq_epi32(shadow, read_mask));
+  }
+  // The low 16 bits of the mask cover the first cell, the high 16 bits cover
+  // the second one.
+  const u32 mask = static_cast<u32>(_mm256_movemask_epi8(same));
+  return (mask & 0xffff) && (mask >> 16);
+}
+#endif
+
 char* DumpShadow(char* buf, RawShadow raw) {
   if (raw == Shadow::kEmpty) {
     internal_snprintf(buf, 64, "0");
@@ -459,6 +485,10 @@ ALWAYS_INLINE USED void MemoryAccess16(ThreadState* thr, uptr pc, uptr addr,
     return;
   Shadow cur(fast_state, 0, 8, typ);
   RawShadow* shadow_mem = MemToShadow(addr);
+#if TSAN_VECTORIZE_AVX2
+  if (LIKELY(ContainsSameAccess2(shadow_mem, cur, typ)))
+    return;
+#endif
   bool traced = false;
   {
     LOAD_CURRENT_SHADOW(cur, shadow_mem);
@@ -719,6 +749,22 @@ void MemoryAccessRangeT(ThreadState* thr, uptr pc, uptr addr, uptr size) {
   }
   // Handle middle part, if any.
   Shadow cur(fast_state, 0, kShadowCell, typ);
+#if TSAN_VECTORIZE_AVX2
+  // Skip pairs of cells that already contain the access; the common case for
+  // repeated copies of the same memory.
+  for (; size >= 2 * kShadowCell; size -= 2 * kShadowCell) {
+    if (LIKELY(ContainsSameAccess2(shadow_mem, cur, typ))) {
+      shadow_mem += 2 * kShadowCnt;
+      continue;
+    }
+    if (UNLIKELY(MemoryAccessRangeOne(thr, shadow_mem, cur, typ)))
+      return;
+    shadow_mem += kShadowCnt;
+    if (UNLIKELY(MemoryAccessRangeOne(thr, shadow_mem, cur, typ)))
+      return;
+    shadow_mem += kShadowCnt;
+  }
+#endif
   for (; size >= kShadowCell; size -= kShadowCell, shadow_mem += kShadowCnt) {
     if (UNLIKELY(MemoryAccessRangeOne(thr, shadow_mem, cur, typ)))
       return;
@@ -106,8 +106,13 @@ void __xray_init() XRAY_NEVER_INSTRUMENT {
   atomic_store(&XRayInitialized, true, memory_order_release);
 
 #ifndef XRAY_NO_PREINIT
-  if (flags()->patch_premain)
-    __xray_patch();
+  if (flags()->patch_premain) {
+    const char *Ids = flags()->patch_premain_function_ids;
+    if (Ids != nullptr && Ids[0] != '\0')
+      controlPatchingFunctionIds(Ids, true);
+    else
+      __xray_patch();
+  }
 #endif
 }
 
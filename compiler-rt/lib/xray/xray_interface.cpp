@@ -403,6 +403,57 @@ XRayPatchingStatus mprotectAndPatchFunction(int32_t FuncId,
 
 } // namespace
 
+XRayPatchingStatus
+controlPatchingFunctionIds(const char *Spec,
+                           bool Enable) XRAY_NEVER_INSTRUMENT {
+  if (!atomic_load(&XRayInitialized, memory_order_acquire))
+    return XRayPatchingStatus::NOT_INITIALIZED;
+
+  // Spec is a comma-separated list of function ids or inclusive ranges of
+  // function ids, e.g. "1,4-10,42". Every listed function is patched (or
+  // unpatched) individually; the first failure stops the walk.
+  const char *P = Spec;
+  while (*P != '\0') {
+    if (*P == ',') {
+      ++P;
+      continue;
+    }
+    char *End = nullptr;
+    s64 From = internal_simple_strtoll(P, &End, 10);
+    if (End == P) {
+      Report("Invalid function id list: '%s'\n", Spec);
+      return XRayPatchingStatus::FAILED;
+    }
+    s64 To = From;
+    P = End;
+    if (*P == '-') {
+      ++P;
+      To = internal_simple_strtoll(P, &End, 10);
+      if (End == P || To < From) {
+        Report("Invalid function id range in list: '%s'\n", Spec);
+        return XRayPatchingStatus::FAILED;
+      }
+      P = End;
+    }
+    if (*P != '\0' && *P != ',') {
+      Report("Invalid function id list: '%s'\n", Spec);
+      return XRayPatchingStatus::FAILED;
+    }
+    if (From <= 0 || To > std::numeric_limits<int32_t>::max()) {
+      Report("Invalid function id provided: %lld\n",
+             static_cast<long long>(From <= 0 ? From : To));
+      return XRayPatchingStatus::FAILED;
+    }
+    for (s64 FuncId = From; FuncId <= To; ++FuncId) {
+      XRayPatchingStatus Status =
+          mprotectAndPatchFunction(static_cast<int32_t>(FuncId), Enable);
+      if (Status != XRayPatchingStatus::SUCCESS)
+        return Status;
+    }
+  }
+  return XRayPatchingStatus::SUCCESS;
+}
+
 } // namespace __xray
 
 using namespace __xray;
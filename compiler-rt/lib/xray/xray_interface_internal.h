@@ -86,6 +86,11 @@ bool patchFunctionTailExit(bool Enable, uint32_t FuncId,
 bool patchCustomEvent(bool Enable, uint32_t FuncId, const XRaySledEntry &Sled);
 bool patchTypedEvent(bool Enable, uint32_t FuncId, const XRaySledEntry &Sled);
 
+// Patches (or unpatches, if |Enable| is false) only the functions listed in
+// |Spec|, a comma-separated list of function ids and inclusive ranges of
+// function ids such as "1,4-10,42".
+XRayPatchingStatus controlPatchingFunctionIds(const char *Spec, bool Enable);
+
 } // namespace __xray
 
 extern "C" {
@@ -0,0 +1,31 @@
+// Check that allocation_sample_rate only profiles about one in N allocations,
+// and that all of them are profiled by default.
+
+// RUN: %clangxx_memprof -O0 %s -o %t
+// RUN: %env_memprof_opts=print_text=true:log_path=stderr:print_terse=1 %run %t 2>&1 | FileCheck %s --check-prefix=ALL
+// RUN: %env_memprof_opts=print_text=true:log_path=stderr:print_terse=1:allocation_sample_rate=100 %run %t 2>&1 | FileCheck %s --check-prefix=SAMPLED
+
+// The gaps between sampled allocations are uniform in [1, 199], so about 100
+// of the 10000 allocations are profiled.
+// ALL: MIB:[[STACKID:[0-9]+]]/10000/40.00/40/40/
+// ALL: Stack for id [[STACKID]]:
+// SAMPLED: MIB:[[STACKID:[0-9]+]]/{{[5-9][0-9]|1[0-9][0-9]}}/40.00/40/40/
+// SAMPLED: Stack for id [[STACKID]]:
+// SAMPLED-NEXT: #0 {{.*}} in operator new
+// SAMPLED-NEXT: #1 {{.*}} in main {{.*}}:[[@LINE+8]]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int main() {
+  int sum = 0;
+  for (int j = 0; j < 10000; j++) {
+    int *p = new int[10];
+    for (int i = 0; i < 10; i++)
+      p[i] = i;
+    for (int i = 0; i < 10; i++)
+      sum += p[i];
+    delete[] p;
+  }
+  return sum == 0;
+}
@@ -0,0 +1,48 @@
+// Only the first BurstDuration profile updates of every Period are counted.
+// RUN: %clang_profgen -O0 -mllvm -sampled-instrumentation \
+// RUN:   -mllvm -sampled-instr-period=100 \
+// RUN:   -mllvm -sampled-instr-burst-duration=10 -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --function=work %t.profraw | FileCheck %s
+
+// With a power of two period the counter is wrapped with a mask.
+// RUN: %clang_profgen -O0 -mllvm -sampled-instrumentation \
+// RUN:   -mllvm -sampled-instr-period=128 \
+// RUN:   -mllvm -sampled-instr-burst-duration=16 -o %t.pow2 %s
+// RUN: env LLVM_PROFILE_FILE=%t.pow2.profraw %run %t.pow2
+// RUN: llvm-profdata show --counts --function=work %t.pow2.profraw \
+// RUN:   | FileCheck %s --check-prefix=POW2
+
+// MC/DC test vector bitmap updates are sampled like counter updates, and the
+// sampling variable has the same type whatever the period.
+// RUN: %clang_profgen -O0 -fcoverage-mapping -fcoverage-mcdc \
+// RUN:   -mllvm -sampled-instrumentation -S -emit-llvm -o - %s \
+// RUN:   | FileCheck %s --check-prefix=IR
+// RUN: %clang_profgen -O0 -fcoverage-mapping -fcoverage-mcdc \
+// RUN:   -mllvm -sampled-instrumentation -mllvm -sampled-instr-period=100000 \
+// RUN:   -S -emit-llvm -o - %s | FileCheck %s --check-prefix=IR
+
+// CHECK:      work:
+// CHECK:        Function count: 100
+// POW2:       work:
+// POW2:         Function count: 128
+
+// IR: @__llvm_profile_sampling = linkonce_odr hidden thread_local global i32 0
+// IR-LABEL: define {{.*}}i32 @both(
+// IR:         load i32, ptr @__llvm_profile_sampling
+// IR:         br i1 %{{.*}}, label %{{.*}}, label %{{.*}}, !prof
+// IR:         %mcdc.bits{{[0-9]*}} = load i8
+// IR:         store i32 %{{.*}}, ptr @__llvm_profile_sampling
+// IR:         ret i32
+
+// The loop in main is not instrumented, so the only profile update is the
+// entry counter of work.
+__attribute__((noinline)) void work(void) {}
+
+__attribute__((noinline)) int both(int A, int B) { return A && B; }
+
+__attribute__((no_profile_instrument_function)) int main(void) {
+  for (int I = 0; I < 1000; ++I)
+    work();
+  return 0;
+}
@@ -0,0 +1,26 @@
+// An instrumented malloc is called while the thread's counter copy is being
+// allocated. It must not recurse into the initialization.
+// RUN: %clang_profgen -O0 -pthread -mllvm -instrprof-thread-local-counters -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --function=work %t.profraw | FileCheck %s
+
+// CHECK:      work:
+// CHECK:        Function count: 2
+
+#include <pthread.h>
+#include <stddef.h>
+
+extern void *__libc_malloc(size_t);
+
+void *malloc(size_t Size) { return __libc_malloc(Size); }
+
+void *work(void *Arg) { return Arg; }
+
+int main(void) {
+  pthread_t Threads[2];
+  for (int I = 0; I < 2; ++I)
+    pthread_create(&Threads[I], 0, work, 0);
+  for (int I = 0; I < 2; ++I)
+    pthread_join(Threads[I], 0);
+  return 0;
+}
@@ -0,0 +1,28 @@
+// Every thread increments its own copy of the counters, which the runtime
+// adds up when the profile is written.
+// RUN: %clang_profgen -O0 -pthread -mllvm -instrprof-thread-local-counters -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --function=work %t.profraw | FileCheck %s
+
+// CHECK:      work:
+// CHECK:        Function count: 4
+// CHECK-NEXT:   Block counts: [4000]
+
+#include <pthread.h>
+
+volatile int Sink;
+
+void *work(void *Arg) {
+  for (int I = 0; I < 1000; ++I)
+    Sink += I;
+  return 0;
+}
+
+int main(void) {
+  pthread_t Threads[4];
+  for (int I = 0; I < 4; ++I)
+    pthread_create(&Threads[I], 0, work, 0);
+  for (int I = 0; I < 4; ++I)
+    pthread_join(Threads[I], 0);
+  return 0;
+}
@@ -0,0 +1,56 @@
+// RUN: %clangxx_tsan -O1 -mllvm -tsan-merge-adjacent-accesses %s -S \
+// RUN:   -emit-llvm -o - | FileCheck %s --check-prefix=IR
+// RUN: %clangxx_tsan -O1 -mllvm -tsan-merge-adjacent-accesses %s -o %t && \
+// RUN:   %deflake %run %t 2>&1 | FileCheck %s
+// Races on accesses whose instrumentation was merged into a single range
+// check are still reported.
+#include "test.h"
+
+struct Pair {
+  long first;
+  long second;
+};
+
+Pair Global;
+
+// IR-LABEL: define {{.*}}write_pair
+// IR-NOT: call void @__tsan_write8
+// IR: call void @__tsan_write_range(ptr {{.*}}, i64 16)
+// IR-NOT: call void @__tsan_write8
+// IR: ret void
+__attribute__((noinline)) void write_pair(Pair *p) {
+  p->first = 1;
+  p->second = 2;
+}
+
+// IR-LABEL: define {{.*}}read_pair
+// IR: call void @__tsan_read_range(ptr {{.*}}, i64 16)
+// IR-NOT: call void @__tsan_read8
+// IR: ret
+__attribute__((noinline)) long read_pair(Pair *p) {
+  return p->first + p->second;
+}
+
+void *Thread1(void *x) {
+  write_pair(&Global);
+  barrier_wait(&barrier);
+  return NULL;
+}
+
+void *Thread2(void *x) {
+  barrier_wait(&barrier);
+  return (void *)read_pair(&Global);
+}
+
+int main() {
+  barrier_init(&barrier, 2);
+  pthread_t t[2];
+  pthread_create(&t[0], NULL, Thread1, NULL);
+  pthread_create(&t[1], NULL, Thread2, NULL);
+  pthread_join(t[0], NULL);
+  pthread_join(t[1], NULL);
+  fprintf(stderr, "Pass\n");
+  // CHECK: ThreadSanitizer: data race
+  // CHECK: Pass
+  return 0;
+}
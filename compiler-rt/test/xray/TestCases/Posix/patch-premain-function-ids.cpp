@@ -0,0 +1,61 @@
+// Check that patch_premain_function_ids limits the functions patched before
+// main to the listed function ids.
+//
+// RUN: %clangxx_xray -fxray-instrument -std=c++11 %s -o %t
+// RUN: XRAY_OPTIONS="patch_premain=true patch_premain_function_ids=1" \
+// RUN:   %run %t 2>&1 | FileCheck %s --check-prefix=FIRST
+// RUN: XRAY_OPTIONS="patch_premain=true patch_premain_function_ids=2" \
+// RUN:   %run %t 2>&1 | FileCheck %s --check-prefix=SECOND
+// RUN: XRAY_OPTIONS="patch_premain=true patch_premain_function_ids=1-2" \
+// RUN:   %run %t 2>&1 | FileCheck %s --check-prefix=BOTH
+// RUN: XRAY_OPTIONS="patch_premain=true patch_premain_function_ids=2-1" \
+// RUN:   %run %t 2>&1 | FileCheck %s --check-prefix=INVALID
+
+// UNSUPPORTED: target-is-mips64,target-is-mips64el
+
+#include "xray/xray_interface.h"
+
+#include <cstdint>
+#include <cstdio>
+
+[[clang::xray_always_instrument]] void first() { printf("first called\n"); }
+
+[[clang::xray_always_instrument]] void second() { printf("second called\n"); }
+
+void test_handler(int32_t fid, XRayEntryType type) {
+  if (type == XRayEntryType::ENTRY)
+    printf("entered %d\n", fid);
+}
+
+[[clang::xray_never_instrument]] int main() {
+  // Function ids follow the order of the functions in the object file.
+  printf("ids: %d %d\n",
+         __xray_function_address(1) == reinterpret_cast<uintptr_t>(&first),
+         __xray_function_address(2) == reinterpret_cast<uintptr_t>(&second));
+  __xray_set_handler(test_handler);
+  first();
+  second();
+  __xray_remove_handler();
+  return 0;
+}
+
+// FIRST: ids: 1 1
+// FIRST-NEXT: entered 1
+// FIRST-NEXT: first called
+// FIRST-NEXT: second called
+
+// SECOND: ids: 1 1
+// SECOND-NEXT: first called
+// SECOND-NEXT: entered 2
+// SECOND-NEXT: second called
+
+// BOTH: ids: 1 1
+// BOTH-NEXT: entered 1
+// BOTH-NEXT: first called
+// BOTH-NEXT: entered 2
+// BOTH-NEXT: second called
+
+// INVALID: Invalid function id range in list: '2-1'
+// INVALID: ids: 1 1
+// INVALID-NEXT: first called
+// INVALID-NEXT: second called
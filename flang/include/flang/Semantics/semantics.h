@@ -113,6 +113,10 @@ public:
   std::map<const Symbol *, SourceName> &moduleFileOutputRenamings() {
     return moduleFileOutputRenamings_;
   }
+  // Whether a module file name was found on the non-intrinsic search path
+  std::map<std::string, bool> &nonIntrinsicModuleFileFound() {
+    return nonIntrinsicModuleFileFound_;
+  }
 
   SemanticsContext &set_location(
       const std::optional<parser::CharBlock> &location) {
@@ -303,6 +307,7 @@ private:
   std::unique_ptr<CommonBlockMap> commonBlockMap_;
   ModuleDependences moduleDependences_;
   std::map<const Symbol *, SourceName> moduleFileOutputRenamings_;
+  std::map<std::string, bool> nonIntrinsicModuleFileFound_;
 };
 
 class Semantics {
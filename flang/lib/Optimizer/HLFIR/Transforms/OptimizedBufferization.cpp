@@ -29,7 +29,9 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/MathExtras.h"
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <mlir/Analysis/AliasAnalysis.h>
 #include <optional>
@@ -238,37 +240,95 @@ static bool areIdenticalOrDisjointSlices(mlir::Value ref1, mlir::Value ref2) {
   // of the array sections, e.g. for any positive constant C:
   //   X:Y does not overlap with (Y+C):Z
   //   X:Y does not overlap with Z:(X-C)
-  auto displacedByConstant = [](mlir::Value v1, mlir::Value v2) {
-    auto removeConvert = [](mlir::Value v) -> mlir::Operation * {
-      auto *op = v.getDefiningOp();
-      while (auto conv = mlir::dyn_cast_or_null<fir::ConvertOp>(op))
-        op = conv.getValue().getDefiningOp();
-      return op;
-    };
-
-    auto isPositiveConstant = [](mlir::Value v) -> bool {
-      if (auto conOp =
-              mlir::dyn_cast<mlir::arith::ConstantOp>(v.getDefiningOp()))
-        if (auto iattr = mlir::dyn_cast<mlir::IntegerAttr>(conOp.getValue()))
-          return iattr.getInt() > 0;
+  // Scalar subscripts that are provably different make the slices
+  // disjoint as well, which is the common case for stencils that
+  // update one plane of an array from its neighbors:
+  //   A(X1:Y1, J) does not overlap with A(X2:Y2, J+C)
+  //   A(X1:Y1, C1) does not overlap with A(X2:Y2, C2) if C1 != C2
+  //
+  // Subscripts are compared as a base value plus a constant offset. Bases
+  // match if they are the same SSA value, or loads of the same variable
+  // with no write to it in between, since lowering loads a variable such as
+  // J once for every subscript that uses it.
+  auto isSameValue = [](mlir::Value v1, mlir::Value v2) {
+    if (v1 == v2)
+      return true;
+    auto load1 = v1.getDefiningOp<fir::LoadOp>();
+    auto load2 = v2.getDefiningOp<fir::LoadOp>();
+    if (!load1 || !load2 || load1.getMemref() != load2.getMemref() ||
+        load1->getBlock() != load2->getBlock())
       return false;
-    };
-
-    auto *op1 = removeConvert(v1);
-    auto *op2 = removeConvert(v2);
-    if (!op1 || !op2)
+    if (load2->isBeforeInBlock(load1))
+      std::swap(load1, load2);
+    std::optional<mlir::SmallVector<mlir::MemoryEffects::EffectInstance>>
+        effects = getEffectsBetween(load1, load2);
+    if (!effects)
       return false;
-    if (auto addi = mlir::dyn_cast<mlir::arith::AddIOp>(op2))
-      if ((addi.getLhs().getDefiningOp() == op1 &&
-           isPositiveConstant(addi.getRhs())) ||
-          (addi.getRhs().getDefiningOp() == op1 &&
-           isPositiveConstant(addi.getLhs())))
-        return true;
-    if (auto subi = mlir::dyn_cast<mlir::arith::SubIOp>(op1))
-      if (subi.getLhs().getDefiningOp() == op2 &&
-          isPositiveConstant(subi.getRhs()))
-        return true;
-    return false;
+    for (const mlir::MemoryEffects::EffectInstance &effect : *effects)
+      if (mlir::isa<mlir::MemoryEffects::Write>(effect.getEffect()) &&
+          !containsReadOrWriteEffectOn(effect, load1.getMemref()).isNo())
+        return false;
+    return true;
+  };
+
+  // Returns the base and the constant offset of v, so that v is base+offset,
+  // looking through converts and additions or subtractions of constants.
+  // The base of a constant is null.
+  auto decompose = [](mlir::Value v)
+      -> std::optional<std::pair<mlir::Value, std::int64_t>> {
+    std::int64_t offset = 0;
+    while (true) {
+      if (std::optional<std::int64_t> cst = fir::getIntIfConstant(v)) {
+        if (llvm::AddOverflow(offset, *cst, offset))
+          return std::nullopt;
+        return std::make_pair(mlir::Value{}, offset);
+      }
+      mlir::Operation *op = v.getDefiningOp();
+      std::optional<std::int64_t> cst;
+      if (auto conv = mlir::dyn_cast_or_null<fir::ConvertOp>(op)) {
+        v = conv.getValue();
+        continue;
+      }
+      if (auto addi = mlir::dyn_cast_or_null<mlir::arith::AddIOp>(op)) {
+        if ((cst = fir::getIntIfConstant(addi.getRhs())))
+          v = addi.getLhs();
+        else if ((cst = fir::getIntIfConstant(addi.getLhs())))
+          v = addi.getRhs();
+      } else if (auto subi = mlir::dyn_cast_or_null<mlir::arith::SubIOp>(op)) {
+        if ((cst = fir::getIntIfConstant(subi.getRhs()))) {
+          if (*cst == std::numeric_limits<std::int64_t>::min())
+            return std::nullopt;
+          *cst = -*cst;
+          v = subi.getLhs();
+        }
+      }
+      if (!cst)
+        return std::make_pair(v, offset);
+      if (llvm::AddOverflow(offset, *cst, offset))
+        return std::nullopt;
+    }
+  };
+
+  // Returns the constant difference v2 - v1, if there is one.
+  auto getDifference = [&](mlir::Value v1,
+                           mlir::Value v2) -> std::optional<std::int64_t> {
+    auto d1 = decompose(v1);
+    auto d2 = decompose(v2);
+    if (!d1 || !d2)
+      return std::nullopt;
+    if (d1->first != d2->first &&
+        (!d1->first || !d2->first || !isSameValue(d1->first, d2->first)))
+      return std::nullopt;
+    std::int64_t diff;
+    if (llvm::SubOverflow(d2->second, d1->second, diff))
+      return std::nullopt;
+    return diff;
+  };
+
+  // Returns true if v2 is v1 plus a positive constant.
+  auto displacedByConstant = [&](mlir::Value v1, mlir::Value v2) {
+    std::optional<std::int64_t> diff = getDifference(v1, v2);
+    return diff && *diff > 0;
   };
 
   des1It = des1.getIndices().begin();
@@ -286,8 +346,11 @@ static bool areIdenticalOrDisjointSlices(mlir::Value ref1, mlir::Value ref2) {
           displacedByConstant(des2Ub, des1Lb))
         return true;
     } else {
-      ++des1It;
-      ++des2It;
+      mlir::Value des1Idx = *des1It++;
+      mlir::Value des2Idx = *des2It++;
+      std::optional<std::int64_t> diff = getDifference(des1Idx, des2Idx);
+      if (diff && *diff != 0)
+        return true;
     }
   }
 
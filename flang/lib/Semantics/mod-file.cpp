@@ -1393,12 +1393,28 @@ Scope *ModFileReader::Read(SourceName name, std::optional<bool> isIntrinsic,
   }
   bool foundNonIntrinsicModuleFile{false};
   if (!isIntrinsic) {
-    std::list<std::string> searchDirs;
-    for (const auto &d : options.searchDirectories) {
-      searchDirs.push_back(d);
+    // USE of an intrinsic module without INTRINSIC, e.g. ISO_C_BINDING,
+    // gets here again for every program unit that has it, so remember
+    // the result rather than probing every search directory each time.
+    // Module files are only written after semantics, so the result
+    // can't change during a compilation.
+    auto cached{notAModule
+            ? context_.nonIntrinsicModuleFileFound().end()
+            : context_.nonIntrinsicModuleFileFound().find(path)};
+    if (cached != context_.nonIntrinsicModuleFileFound().end()) {
+      foundNonIntrinsicModuleFile = cached->second;
+    } else {
+      std::list<std::string> searchDirs;
+      for (const auto &d : options.searchDirectories) {
+        searchDirs.push_back(d);
+      }
+      foundNonIntrinsicModuleFile =
+          parser::LocateSourceFile(path, searchDirs).has_value();
+      if (!notAModule) {
+        context_.nonIntrinsicModuleFileFound().emplace(
+            path, foundNonIntrinsicModuleFile);
+      }
     }
-    foundNonIntrinsicModuleFile =
-        parser::LocateSourceFile(path, searchDirs).has_value();
   }
   if (isIntrinsic.value_or(!foundNonIntrinsicModuleFile)) {
     // Explicitly intrinsic, or not specified and not found in the search
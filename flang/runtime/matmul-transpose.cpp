@@ -67,26 +67,31 @@ inline static RT_API_ATTRS void MatrixTransposedTimesMatrix(
     std::size_t yColumnByteStride = 0) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
 
-  std::memset(product, 0, rows * cols * sizeof *product);
+  // Both operands are read along their columns, so each element of the
+  // result is a dot product of two contiguous vectors.  It is accumulated
+  // in a local so that the product is not reloaded and stored on every
+  // iteration, which would also keep the loop from being vectorized.
   for (SubscriptValue j{0}; j < cols; ++j) {
+    const YT *RESTRICT yp;
+    if constexpr (!Y_HAS_STRIDED_COLUMNS) {
+      yp = y + j * n;
+    } else {
+      yp = reinterpret_cast<const YT *>(
+          reinterpret_cast<const char *>(y) + j * yColumnByteStride);
+    }
     for (SubscriptValue i{0}; i < rows; ++i) {
+      const XT *RESTRICT xp;
+      if constexpr (!X_HAS_STRIDED_COLUMNS) {
+        xp = x + i * n;
+      } else {
+        xp = reinterpret_cast<const XT *>(
+            reinterpret_cast<const char *>(x) + i * xColumnByteStride);
+      }
+      ResultType sum{};
       for (SubscriptValue k{0}; k < n; ++k) {
-        ResultType x_ki;
-        if constexpr (!X_HAS_STRIDED_COLUMNS) {
-          x_ki = static_cast<ResultType>(x[i * n + k]);
-        } else {
-          x_ki = static_cast<ResultType>(reinterpret_cast<const XT *>(
-              reinterpret_cast<const char *>(x) + i * xColumnByteStride)[k]);
-        }
-        ResultType y_kj;
-        if constexpr (!Y_HAS_STRIDED_COLUMNS) {
-          y_kj = static_cast<ResultType>(y[j * n + k]);
-        } else {
-          y_kj = static_cast<ResultType>(reinterpret_cast<const YT *>(
-              reinterpret_cast<const char *>(y) + j * yColumnByteStride)[k]);
-        }
-        product[j * rows + i] += x_ki * y_kj;
+        sum += static_cast<ResultType>(xp[k]) * static_cast<ResultType>(yp[k]);
       }
+      product[j * rows + i] = sum;
     }
   }
 }
@@ -142,19 +147,19 @@ inline static RT_API_ATTRS void MatrixTransposedTimesVector(
     SubscriptValue n, const XT *RESTRICT x, const YT *RESTRICT y,
     std::size_t xColumnByteStride = 0) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
-  std::memset(product, 0, rows * sizeof *product);
   for (SubscriptValue i{0}; i < rows; ++i) {
+    const XT *RESTRICT xp;
+    if constexpr (!X_HAS_STRIDED_COLUMNS) {
+      xp = x + i * n;
+    } else {
+      xp = reinterpret_cast<const XT *>(
+          reinterpret_cast<const char *>(x) + i * xColumnByteStride);
+    }
+    ResultType sum{};
     for (SubscriptValue k{0}; k < n; ++k) {
-      ResultType x_ki;
-      if constexpr (!X_HAS_STRIDED_COLUMNS) {
-        x_ki = static_cast<ResultType>(x[i * n + k]);
-      } else {
-        x_ki = static_cast<ResultType>(reinterpret_cast<const XT *>(
-            reinterpret_cast<const char *>(x) + i * xColumnByteStride)[k]);
-      }
-      ResultType y_k = static_cast<ResultType>(y[k]);
-      product[i] += x_ki * y_k;
+      sum += static_cast<ResultType>(xp[k]) * static_cast<ResultType>(y[k]);
     }
+    product[i] = sum;
   }
 }
 
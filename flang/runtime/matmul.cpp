@@ -60,6 +60,19 @@ private:
   Result sum_{};
 };
 
+// Returns the address of column j of a matrix whose columns are either
+// adjacent (columnElements apart) or separated by a byte stride.
+template <typename T, bool HAS_STRIDED_COLUMNS>
+inline RT_API_ATTRS const T *MatrixColumn(const T *base, SubscriptValue j,
+    SubscriptValue columnElements, std::size_t columnByteStride) {
+  if constexpr (HAS_STRIDED_COLUMNS) {
+    return reinterpret_cast<const T *>(
+        reinterpret_cast<const char *>(base) + j * columnByteStride);
+  } else {
+    return base + j * columnElements;
+  }
+}
+
 // Contiguous numeric matrix*matrix multiplication
 //   matrix(rows,n) * matrix(n,cols) -> matrix(rows,cols)
 // Straightforward algorithm:
@@ -77,6 +90,12 @@ private:
 //    DO 2 J = 1, NCOLS
 //     DO 2 I = 1, NROWS
 //   2  RES(I,J) = RES(I,J) + X(I,K)*Y(K,J) ! loop-invariant last term
+// The loops over K and I are then blocked so that a panel of X stays in
+// cache while it is applied to all columns of the result, and four columns
+// of the result are updated at once so that every element of X that is
+// loaded is used four times.  Each element of the result still accumulates
+// its terms in increasing order of K, so the result is the same as with the
+// straightforward loops.
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT,
     bool X_HAS_STRIDED_COLUMNS, bool Y_HAS_STRIDED_COLUMNS>
 inline RT_API_ATTRS void MatrixTimesMatrix(
@@ -85,29 +104,60 @@ inline RT_API_ATTRS void MatrixTimesMatrix(
     SubscriptValue n, std::size_t xColumnByteStride = 0,
     std::size_t yColumnByteStride = 0) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
+  // A block of X is at most kBlock * rowBlock elements, e.g. 256KiB
+  // for REAL(8); four partial result columns are 8KiB.
+  constexpr SubscriptValue rowBlock{256}, kBlock{128};
   std::memset(product, 0, rows * cols * sizeof *product);
-  const XT *RESTRICT xp0{x};
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      const XT *RESTRICT xp{xp0};
-      ResultType yv;
-      if constexpr (!Y_HAS_STRIDED_COLUMNS) {
-        yv = static_cast<ResultType>(y[k + j * n]);
-      } else {
-        yv = static_cast<ResultType>(reinterpret_cast<const YT *>(
-            reinterpret_cast<const char *>(y) + j * yColumnByteStride)[k]);
+  for (SubscriptValue k0{0}; k0 < n; k0 += kBlock) {
+    SubscriptValue kEnd{n - k0 < kBlock ? n : k0 + kBlock};
+    for (SubscriptValue i0{0}; i0 < rows; i0 += rowBlock) {
+      SubscriptValue iCount{rows - i0 < rowBlock ? rows - i0 : rowBlock};
+      SubscriptValue j{0};
+      for (; j + 4 <= cols; j += 4) {
+        ResultType *RESTRICT p0{product + j * rows + i0};
+        ResultType *RESTRICT p1{p0 + rows};
+        ResultType *RESTRICT p2{p1 + rows};
+        ResultType *RESTRICT p3{p2 + rows};
+        const YT *y0{MatrixColumn<YT, Y_HAS_STRIDED_COLUMNS>(
+            y, j, n, yColumnByteStride)};
+        const YT *y1{MatrixColumn<YT, Y_HAS_STRIDED_COLUMNS>(
+            y, j + 1, n, yColumnByteStride)};
+        const YT *y2{MatrixColumn<YT, Y_HAS_STRIDED_COLUMNS>(
+            y, j + 2, n, yColumnByteStride)};
+        const YT *y3{MatrixColumn<YT, Y_HAS_STRIDED_COLUMNS>(
+            y, j + 3, n, yColumnByteStride)};
+        for (SubscriptValue k{k0}; k < kEnd; ++k) {
+          const XT *RESTRICT xp{MatrixColumn<XT, X_HAS_STRIDED_COLUMNS>(
+                                    x, k, rows, xColumnByteStride) +
+              i0};
+          auto yv0{static_cast<ResultType>(y0[k])};
+          auto yv1{static_cast<ResultType>(y1[k])};
+          auto yv2{static_cast<ResultType>(y2[k])};
+          auto yv3{static_cast<ResultType>(y3[k])};
+          for (SubscriptValue i{0}; i < iCount; ++i) {
+            auto xv{static_cast<ResultType>(xp[i])};
+            p0[i] += xv * yv0;
+            p1[i] += xv * yv1;
+            p2[i] += xv * yv2;
+            p3[i] += xv * yv3;
+          }
+        }
       }
-      for (SubscriptValue i{0}; i < rows; ++i) {
-        *p++ += static_cast<ResultType>(*xp++) * yv;
+      for (; j < cols; ++j) {
+        ResultType *RESTRICT p{product + j * rows + i0};
+        const YT *yj{MatrixColumn<YT, Y_HAS_STRIDED_COLUMNS>(
+            y, j, n, yColumnByteStride)};
+        for (SubscriptValue k{k0}; k < kEnd; ++k) {
+          const XT *RESTRICT xp{MatrixColumn<XT, X_HAS_STRIDED_COLUMNS>(
+                                    x, k, rows, xColumnByteStride) +
+              i0};
+          auto yv{static_cast<ResultType>(yj[k])};
+          for (SubscriptValue i{0}; i < iCount; ++i) {
+            p[i] += static_cast<ResultType>(xp[i]) * yv;
+          }
+        }
       }
     }
-    if constexpr (!X_HAS_STRIDED_COLUMNS) {
-      xp0 += rows;
-    } else {
-      xp0 = reinterpret_cast<const XT *>(
-          reinterpret_cast<const char *>(xp0) + xColumnByteStride);
-    }
   }
 }
 
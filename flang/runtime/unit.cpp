@@ -88,6 +88,11 @@ bool ExternalFileUnit::Emit(const char *data, std::size_t bytes,
     return false;
   }
   CheckDirectAccess(handler);
+  if (access == Access::Stream && isUnformatted.value_or(false) &&
+      !swapEndianness_ && bytes >= minDirectStreamWriteBytes &&
+      positionInRecord == furthestPositionInRecord) {
+    return EmitDirectly(data, bytes, handler);
+  }
   WriteFrame(frameOffsetInFile_, recordOffsetInFrame_ + furthestAfter, handler);
   if (positionInRecord > furthestPositionInRecord) {
     std::memset(Frame() + recordOffsetInFrame_ + furthestPositionInRecord, ' ',
@@ -104,6 +109,31 @@ bool ExternalFileUnit::Emit(const char *data, std::size_t bytes,
   return true;
 }
 
+// Writes a large unformatted stream transfer, such as a whole array being
+// checkpointed, straight from the caller's memory.  Copying it through the
+// buffer would cost an extra pass over the data and grow the buffer to
+// the size of the whole transfer.  Sequential records can't do this, since
+// their headers are patched in the buffer when the record is complete.
+bool ExternalFileUnit::EmitDirectly(
+    const char *data, std::size_t bytes, IoErrorHandler &handler) {
+  std::int64_t at{frameOffsetInFile_ +
+      static_cast<std::int64_t>(recordOffsetInFrame_) + positionInRecord};
+  Flush(handler);
+  if (handler.InError()) {
+    return false;
+  }
+  // Drop any buffered data that the direct write will make stale.
+  TruncateFrame(at, handler);
+  if (Write(at, data, bytes, handler) < bytes) {
+    return false;
+  }
+  frameOffsetInFile_ = at + static_cast<std::int64_t>(bytes);
+  recordOffsetInFrame_ = 0;
+  positionInRecord = furthestPositionInRecord = 0;
+  anyWriteSinceLastPositioning_ = true;
+  return true;
+}
+
 bool ExternalFileUnit::Receive(char *data, std::size_t bytes,
     std::size_t elementBytes, IoErrorHandler &handler) {
   RUNTIME_CHECK(handler, direction_ == Direction::Input);
@@ -98,6 +98,8 @@ class ExternalFileUnit : public ConnectionState,
                          public FileFrameClass {
 public:
   static constexpr int maxAsyncIds{64 * 16};
+  // Unformatted stream transfers at least this large bypass the buffer.
+  static constexpr std::size_t minDirectStreamWriteBytes{1024 * 1024};
 
   explicit RT_API_ATTRS ExternalFileUnit(int unitNumber)
       : unitNumber_{unitNumber} {
@@ -208,6 +210,7 @@ private:
   RT_API_ATTRS void DoEndfile(IoErrorHandler &);
   RT_API_ATTRS void CommitWrites();
   RT_API_ATTRS bool CheckDirectAccess(IoErrorHandler &);
+  RT_API_ATTRS bool EmitDirectly(const char *, std::size_t, IoErrorHandler &);
   RT_API_ATTRS void HitEndOnRead(IoErrorHandler &);
   RT_API_ATTRS std::int32_t ReadHeaderOrFooter(std::int64_t frameOffset);
 
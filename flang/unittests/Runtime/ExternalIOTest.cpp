@@ -19,6 +19,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include <cstring>
 #include <string_view>
+#include <vector>
 
 using namespace Fortran::runtime;
 using namespace Fortran::runtime::io;
@@ -331,6 +332,92 @@ TEST(ExternalIOTests, TestSequentialVariableUnformatted) {
       << "EndIoStatement() for Close";
 }
 
+TEST(ExternalIOTests, TestStreamUnformattedLarge) {
+  // OPEN(NEWUNIT=unit,ACCESS='STREAM',ACTION='READWRITE',&
+  //   FORM='UNFORMATTED',STATUS='SCRATCH')
+  Cookie io{IONAME(BeginOpenNewUnit)(__FILE__, __LINE__)};
+  ASSERT_TRUE(IONAME(SetAccess)(io, "STREAM", 6)) << "SetAccess(STREAM)";
+  ASSERT_TRUE(IONAME(SetAction)(io, "READWRITE", 9)) << "SetAction(READWRITE)";
+  ASSERT_TRUE(IONAME(SetForm)(io, "UNFORMATTED", 11)) << "SetForm(UNFORMATTED)";
+  ASSERT_TRUE(IONAME(SetStatus)(io, "SCRATCH", 7)) << "SetStatus(SCRATCH)";
+  int unit{-1};
+  ASSERT_TRUE(IONAME(GetNewUnit)(io, unit)) << "GetNewUnit()";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for OpenNewUnit";
+
+  // Large enough to be written around the unit's buffer
+  static constexpr SubscriptValue bytes{3 * 1024 * 1024 + 5};
+  std::vector<std::int8_t> array(bytes);
+  for (SubscriptValue j{0}; j < bytes; ++j) {
+    array[j] = static_cast<std::int8_t>(j * 7);
+  }
+  StaticDescriptor<1> arrayStaticDescriptor;
+  Descriptor &arrayDesc{arrayStaticDescriptor.descriptor()};
+  arrayDesc.Establish(TypeCode{CFI_type_int8_t}, 1, array.data(), 1, &bytes);
+  arrayDesc.Check();
+  std::int64_t scalar;
+  StaticDescriptor<0> scalarStaticDescriptor;
+  Descriptor &scalarDesc{scalarStaticDescriptor.descriptor()};
+  scalarDesc.Establish(TypeCode{CFI_type_int64_t}, sizeof scalar, &scalar, 0);
+  scalarDesc.Check();
+
+  // WRITE(UNIT=unit) 1, array, 2
+  io = IONAME(BeginUnformattedOutput)(unit, __FILE__, __LINE__);
+  scalar = 1;
+  ASSERT_TRUE(IONAME(OutputDescriptor)(io, scalarDesc))
+      << "OutputDescriptor() for first scalar";
+  ASSERT_TRUE(IONAME(OutputDescriptor)(io, arrayDesc))
+      << "OutputDescriptor() for array";
+  scalar = 2;
+  ASSERT_TRUE(IONAME(OutputDescriptor)(io, scalarDesc))
+      << "OutputDescriptor() for second scalar";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Write";
+
+  // INQUIRE(UNIT=unit,POS=pos)
+  io = IONAME(BeginInquireUnit)(unit, __FILE__, __LINE__);
+  std::int64_t pos{0};
+  ASSERT_TRUE(IONAME(InquireInteger64)(io, HashInquiryKeyword("POS"), pos))
+      << "InquireInteger64(POS)";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Inquire";
+  ASSERT_EQ(pos, static_cast<std::int64_t>(1 + 2 * sizeof scalar + bytes));
+
+  // WRITE(UNIT=unit,POS=1) 3
+  io = IONAME(BeginUnformattedOutput)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetPos)(io, 1)) << "SetPos(1)";
+  scalar = 3;
+  ASSERT_TRUE(IONAME(OutputDescriptor)(io, scalarDesc))
+      << "OutputDescriptor() for rewrite";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for rewrite";
+
+  // READ(UNIT=unit,POS=1) first, array, second
+  std::fill(array.begin(), array.end(), 0);
+  io = IONAME(BeginUnformattedInput)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetPos)(io, 1)) << "SetPos(1)";
+  ASSERT_TRUE(IONAME(InputDescriptor)(io, scalarDesc))
+      << "InputDescriptor() for first scalar";
+  EXPECT_EQ(scalar, 3);
+  ASSERT_TRUE(IONAME(InputDescriptor)(io, arrayDesc))
+      << "InputDescriptor() for array";
+  ASSERT_TRUE(IONAME(InputDescriptor)(io, scalarDesc))
+      << "InputDescriptor() for second scalar";
+  EXPECT_EQ(scalar, 2);
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Read";
+  for (SubscriptValue j{0}; j < bytes; ++j) {
+    ASSERT_EQ(array[j], static_cast<std::int8_t>(j * 7))
+        << "array[" << j << ']';
+  }
+
+  // CLOSE(UNIT=unit,STATUS='DELETE')
+  io = IONAME(BeginClose)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetStatus)(io, "DELETE", 6)) << "SetStatus(DELETE)";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Close";
+}
+
 TEST(ExternalIOTests, TestDirectFormatted) {
   // OPEN(NEWUNIT=unit,ACCESS='DIRECT',ACTION='READWRITE',&
   //   FORM='FORMATTED',RECL=8,STATUS='SCRATCH')
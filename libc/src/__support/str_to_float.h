@@ -831,6 +831,31 @@ LIBC_INLINE bool is_float_hex_start(const char *__restrict src,
   return isalnum(src[first_digit]) && b36_char_to_int(src[first_digit]) < 16;
 }
 
+// Returns true if the eight characters starting at src are all decimal digits.
+// The characters are checked one by one, so this never reads past the end of
+// a shorter null-terminated string.
+LIBC_INLINE bool has_eight_digits(const char *__restrict src) {
+  for (size_t i = 0; i < 8; ++i)
+    if (!isdigit(src[i]))
+      return false;
+  return true;
+}
+
+// Converts eight decimal digits to their value using SWAR: the digits are
+// combined pairwise, then into groups of four, then into the final value, in
+// three multiplications instead of eight dependent multiply-adds.
+LIBC_INLINE uint64_t parse_eight_digits(const char *__restrict src) {
+  uint64_t val = 0;
+  for (size_t i = 0; i < 8; ++i)
+    val |= static_cast<uint64_t>(static_cast<unsigned char>(src[i])) << (8 * i);
+  val -= 0x3030303030303030;
+  val = (val * 10) + (val >> 8);
+  val = (((val & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+         (((val >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+        32;
+  return static_cast<uint32_t>(val);
+}
+
 // Takes the start of a string representing a decimal float, as well as the
 // local decimalPoint. It returns if it suceeded in parsing any digits, and if
 // the return value is true then the outputs are pointer to the end of the
@@ -863,7 +888,22 @@ decimal_string_to_float(const char *__restrict src, const char DECIMAL_POINT,
   // The loop fills the mantissa with as many digits as it can hold
   const StorageType bitstype_max_div_by_base =
       cpp::numeric_limits<StorageType>::max() / BASE;
+  const StorageType bitstype_max_div_by_base_pow8 =
+      cpp::numeric_limits<StorageType>::max() / 100000000;
   while (true) {
+    // Take eight digits at once while the mantissa is guaranteed to have room
+    // for them. This produces the same mantissa as the digit-by-digit loop
+    // below, which handles whatever is left.
+    if (mantissa < bitstype_max_div_by_base_pow8 &&
+        has_eight_digits(src + index)) {
+      mantissa = (mantissa * 100000000) +
+                 static_cast<StorageType>(parse_eight_digits(src + index));
+      if (after_decimal)
+        exponent -= 8;
+      seen_digit = true;
+      index += 8;
+      continue;
+    }
     if (isdigit(src[index])) {
       uint32_t digit = src[index] - '0';
       seen_digit = true;
@@ -7,6 +7,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "freelist_heap.h"
+#include "src/__support/CPP/atomic.h"
+#include "src/__support/CPP/mutex.h"
 #include "src/stdlib/calloc.h"
 #include "src/stdlib/free.h"
 #include "src/stdlib/malloc.h"
@@ -27,21 +29,54 @@ constexpr size_t SIZE = LIBC_FREELIST_MALLOC_SIZE;
 constexpr size_t SIZE = 0x40000000ULL; // 1GB
 #endif
 LIBC_CONSTINIT FreeListHeapBuffer<SIZE> freelist_heap_buffer;
+
+// The heap itself is not thread safe. This lock serializes the entrypoints
+// below. It only needs atomics, so it works on every target this allocator is
+// built for, including the baremetal ones without a threads library. Threads
+// spin on a plain load while the lock is held so that waiting does not keep
+// stealing the cache line from the owner.
+class HeapLock {
+  cpp::Atomic<int> locked = 0;
+
+public:
+  constexpr HeapLock() = default;
+
+  void lock() {
+    for (;;) {
+      int expected = 0;
+      if (locked.compare_exchange_strong(expected, 1, cpp::MemoryOrder::ACQUIRE,
+                                         cpp::MemoryOrder::RELAXED))
+        return;
+      while (locked.load(cpp::MemoryOrder::RELAXED) != 0)
+        ;
+    }
+  }
+
+  void unlock() { locked.store(0, cpp::MemoryOrder::RELEASE); }
+};
+
+LIBC_CONSTINIT HeapLock freelist_heap_lock;
 } // namespace
 
 FreeListHeap<> *freelist_heap = &freelist_heap_buffer;
 
 LLVM_LIBC_FUNCTION(void *, malloc, (size_t size)) {
+  cpp::lock_guard lock(freelist_heap_lock);
   return freelist_heap->allocate(size);
 }
 
-LLVM_LIBC_FUNCTION(void, free, (void *ptr)) { return freelist_heap->free(ptr); }
+LLVM_LIBC_FUNCTION(void, free, (void *ptr)) {
+  cpp::lock_guard lock(freelist_heap_lock);
+  return freelist_heap->free(ptr);
+}
 
 LLVM_LIBC_FUNCTION(void *, calloc, (size_t num, size_t size)) {
+  cpp::lock_guard lock(freelist_heap_lock);
   return freelist_heap->calloc(num, size);
 }
 
 LLVM_LIBC_FUNCTION(void *, realloc, (void *ptr, size_t size)) {
+  cpp::lock_guard lock(freelist_heap_lock);
   return freelist_heap->realloc(ptr, size);
 }
 
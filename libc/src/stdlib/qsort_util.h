@@ -15,7 +15,9 @@
 
 namespace LIBC_NAMESPACE::internal {
 
-// A simple quicksort implementation using the Hoare partition scheme.
+// An introsort implementation: quicksort using the Hoare partition scheme with
+// a median-of-three pivot, falling back to heapsort when the recursion gets too
+// deep and to insertion sort for small ranges.
 
 using Compare = int(const void *, const void *);
 using CompareWithState = int(const void *, const void *, void *);
@@ -27,7 +29,7 @@ struct Comparator {
     Compare *comp_func;
     CompareWithState *comp_func_r;
   };
-  const CompType comp_type;
+  CompType comp_type;
 
   void *arg;
 
@@ -56,6 +58,13 @@ struct Comparator {
   }
 };
 
+template <size_t N> LIBC_INLINE void swap_fixed(uint8_t *a, uint8_t *b) {
+  uint8_t temp[N];
+  __builtin_memcpy(temp, a, N);
+  __builtin_memcpy(a, b, N);
+  __builtin_memcpy(b, temp, N);
+}
+
 class Array {
   uint8_t *array;
   size_t array_size;
@@ -71,7 +80,22 @@ public:
   void swap(size_t i, size_t j) const {
     uint8_t *elem_i = get(i);
     uint8_t *elem_j = get(j);
-    for (size_t b = 0; b < elem_size; ++b) {
+    // Most arrays hold ints, pointers, doubles or small structs, for which a
+    // fixed-size swap compiles down to a couple of register moves.
+    switch (elem_size) {
+    case 4:
+      return swap_fixed<4>(elem_i, elem_j);
+    case 8:
+      return swap_fixed<8>(elem_i, elem_j);
+    case 16:
+      return swap_fixed<16>(elem_i, elem_j);
+    default:
+      break;
+    }
+    size_t b = 0;
+    for (; b + sizeof(uint64_t) <= elem_size; b += sizeof(uint64_t))
+      swap_fixed<sizeof(uint64_t)>(elem_i + b, elem_j + b);
+    for (; b < elem_size; ++b) {
       uint8_t temp = elem_i[b];
       elem_i[b] = elem_j[b];
       elem_j[b] = temp;
@@ -134,17 +158,94 @@ static size_t partition(const Array &array) {
   }
 }
 
+// Ranges of at most this many elements are sorted with insertion sort, which
+// does fewer comparisons than partitioning them further.
+constexpr size_t INSERTION_SORT_THRESHOLD = 16;
+
+LIBC_INLINE void insertion_sort(const Array &array) {
+  const size_t array_size = array.size();
+  for (size_t i = 1; i < array_size; ++i)
+    for (size_t j = i; j > 0 && array.elem_compare(j - 1, array.get(j)) > 0;
+         --j)
+      array.swap(j - 1, j);
+}
+
+LIBC_INLINE void sift_down(const Array &array, size_t root, size_t size) {
+  while (true) {
+    size_t child = 2 * root + 1;
+    if (child >= size)
+      return;
+    if (child + 1 < size && array.elem_compare(child, array.get(child + 1)) < 0)
+      ++child;
+    if (array.elem_compare(root, array.get(child)) >= 0)
+      return;
+    array.swap(root, child);
+    root = child;
+  }
+}
+
+LIBC_INLINE void heap_sort(const Array &array) {
+  const size_t array_size = array.size();
+  for (size_t i = array_size / 2; i > 0; --i)
+    sift_down(array, i - 1, array_size);
+  for (size_t end = array_size - 1; end > 0; --end) {
+    array.swap(0, end);
+    sift_down(array, 0, end);
+  }
+}
+
+// Orders the first, middle and last elements, which leaves their median in the
+// middle where partition() takes its pivot from. This avoids the quadratic
+// behavior of a fixed pivot on sorted and reverse sorted inputs.
+LIBC_INLINE void move_median_to_middle(const Array &array) {
+  const size_t lo = 0;
+  const size_t mid = array.size() / 2;
+  const size_t hi = array.size() - 1;
+  if (array.elem_compare(mid, array.get(lo)) < 0)
+    array.swap(mid, lo);
+  if (array.elem_compare(hi, array.get(mid)) < 0) {
+    array.swap(hi, mid);
+    if (array.elem_compare(mid, array.get(lo)) < 0)
+      array.swap(mid, lo);
+  }
+}
+
+LIBC_INLINE void introsort(Array array, size_t depth_limit) {
+  while (array.size() > INSERTION_SORT_THRESHOLD) {
+    if (depth_limit == 0) {
+      heap_sort(array);
+      return;
+    }
+    --depth_limit;
+
+    move_median_to_middle(array);
+    size_t split_index = partition(array);
+    Array left = array.make_array(0, split_index);
+    Array right = array.make_array(split_index, array.size() - split_index);
+
+    // Recurse into the smaller part and loop on the larger one, so that the
+    // stack depth stays logarithmic in the size of the array.
+    if (left.size() < right.size()) {
+      introsort(left, depth_limit);
+      array = right;
+    } else {
+      introsort(right, depth_limit);
+      array = left;
+    }
+  }
+  insertion_sort(array);
+}
+
 LIBC_INLINE void quicksort(const Array &array) {
   const size_t array_size = array.size();
   if (array_size <= 1)
     return;
-  size_t split_index = partition(array);
-  if (array_size <= 2) {
-    // The partition operation sorts the two element array.
-    return;
-  }
-  quicksort(array.make_array(0, split_index));
-  quicksort(array.make_array(split_index, array.size() - split_index));
+  // Allow twice the depth of a perfectly balanced quicksort before switching
+  // to heapsort.
+  size_t depth_limit = 0;
+  for (size_t n = array_size; n > 1; n >>= 1)
+    depth_limit += 2;
+  introsort(array, depth_limit);
 }
 
 } // namespace LIBC_NAMESPACE::internal
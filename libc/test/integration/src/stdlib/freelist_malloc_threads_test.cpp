@@ -0,0 +1,118 @@
+//===-- Tests for freelist_malloc from multiple threads -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/CPP/atomic.h"
+#include "src/pthread/pthread_create.h"
+#include "src/pthread/pthread_join.h"
+#include "src/stdlib/calloc.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/malloc.h"
+#include "src/stdlib/realloc.h"
+
+#include "test/IntegrationTest/test.h"
+
+#include <pthread.h>
+#include <stdint.h> // uintptr_t
+
+constexpr int THREAD_COUNT = 8;
+constexpr int ITERATIONS = 2000;
+constexpr int LIVE_COUNT = 16;
+
+static LIBC_NAMESPACE::cpp::Atomic<int> ready_count = 0;
+static LIBC_NAMESPACE::cpp::Atomic<int> error_count = 0;
+
+static void fill(uint8_t *ptr, size_t size, uint8_t value) {
+  for (size_t i = 0; i < size; ++i)
+    ptr[i] = value;
+}
+
+static bool check(const uint8_t *ptr, size_t size, uint8_t value) {
+  for (size_t i = 0; i < size; ++i)
+    if (ptr[i] != value)
+      return false;
+  return true;
+}
+
+// Each thread keeps a few live allocations filled with its own pattern and
+// keeps replacing them. If two threads ever got overlapping blocks, or the
+// freelist got corrupted, one of the patterns would be overwritten.
+void *worker(void *arg) {
+  const uint8_t value = static_cast<uint8_t>(uintptr_t(arg));
+  uint8_t *live[LIVE_COUNT] = {};
+  size_t sizes[LIVE_COUNT] = {};
+
+  // Start all threads at the same time to maximize contention.
+  ready_count.fetch_add(1);
+  while (ready_count.load() != THREAD_COUNT)
+    ;
+
+  for (int i = 0; i < ITERATIONS; ++i) {
+    const int slot = i % LIVE_COUNT;
+    if (live[slot]) {
+      if (!check(live[slot], sizes[slot], value))
+        error_count.fetch_add(1);
+      LIBC_NAMESPACE::free(live[slot]);
+    }
+
+    sizes[slot] = 16 + ((i * 37 + value * 11) % 512);
+    switch (i % 3) {
+    case 0:
+      live[slot] =
+          reinterpret_cast<uint8_t *>(LIBC_NAMESPACE::malloc(sizes[slot]));
+      break;
+    case 1:
+      live[slot] =
+          reinterpret_cast<uint8_t *>(LIBC_NAMESPACE::calloc(1, sizes[slot]));
+      if (live[slot] && !check(live[slot], sizes[slot], 0))
+        error_count.fetch_add(1);
+      break;
+    case 2:
+      live[slot] =
+          reinterpret_cast<uint8_t *>(LIBC_NAMESPACE::malloc(sizes[slot] / 2));
+      if (live[slot])
+        live[slot] = reinterpret_cast<uint8_t *>(
+            LIBC_NAMESPACE::realloc(live[slot], sizes[slot]));
+      break;
+    }
+    if (!live[slot]) {
+      error_count.fetch_add(1);
+      continue;
+    }
+    fill(live[slot], sizes[slot], value);
+  }
+
+  for (int slot = 0; slot < LIVE_COUNT; ++slot) {
+    if (!live[slot])
+      continue;
+    if (!check(live[slot], sizes[slot], value))
+      error_count.fetch_add(1);
+    LIBC_NAMESPACE::free(live[slot]);
+  }
+  return nullptr;
+}
+
+void concurrent_allocations() {
+  pthread_t threads[THREAD_COUNT];
+  for (int i = 0; i < THREAD_COUNT; ++i)
+    ASSERT_EQ(LIBC_NAMESPACE::pthread_create(
+                  &threads[i], nullptr, worker,
+                  reinterpret_cast<void *>(uintptr_t(i + 1))),
+              0);
+
+  for (int i = 0; i < THREAD_COUNT; ++i) {
+    void *retval;
+    ASSERT_EQ(LIBC_NAMESPACE::pthread_join(threads[i], &retval), 0);
+  }
+
+  ASSERT_EQ(error_count.load(), 0);
+}
+
+TEST_MAIN() {
+  concurrent_allocations();
+  return 0;
+}
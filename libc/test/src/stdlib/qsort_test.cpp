@@ -23,7 +23,7 @@ static int int_compare(const void *l, const void *r) {
     return -1;
 }
 
-TEST(LlvmLibcQsortTest, SortedArray) {
+TEST(LlvmLibcQSortTest, SortedArray) {
   int array[25] = {10,   23,   33,   35,   55,   70,    71,   100,  110,
                    123,  133,  135,  155,  170,  171,   1100, 1110, 1123,
                    1133, 1135, 1155, 1170, 1171, 11100, 12310};
@@ -58,7 +58,7 @@ TEST(LlvmLibcQsortTest, SortedArray) {
   ASSERT_LE(array[24], 12310);
 }
 
-TEST(LlvmLibcQsortTest, ReverseSortedArray) {
+TEST(LlvmLibcQSortTest, ReverseSortedArray) {
   int array[25] = {25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13,
                    12, 11, 10, 9,  8,  7,  6,  5,  4,  3,  2,  1};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
@@ -69,7 +69,7 @@ TEST(LlvmLibcQsortTest, ReverseSortedArray) {
     ASSERT_LE(array[i], i + 1);
 }
 
-TEST(LlvmLibcQsortTest, AllEqualElements) {
+TEST(LlvmLibcQSortTest, AllEqualElements) {
   int array[25] = {100, 100, 100, 100, 100, 100, 100, 100, 100,
                    100, 100, 100, 100, 100, 100, 100, 100, 100,
                    100, 100, 100, 100, 100, 100, 100};
@@ -81,7 +81,7 @@ TEST(LlvmLibcQsortTest, AllEqualElements) {
     ASSERT_LE(array[i], 100);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedArray1) {
+TEST(LlvmLibcQSortTest, UnsortedArray1) {
   int array[25] = {10, 23,  8,  35, 55, 45, 40,  100,  110,  123,  90, 80,  70,
                    60, 171, 11, 1,  -1, -5, -10, 1155, 1170, 1171, 12, -100};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
@@ -115,7 +115,7 @@ TEST(LlvmLibcQsortTest, UnsortedArray1) {
   ASSERT_LE(array[24], 1171);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedArray2) {
+TEST(LlvmLibcQSortTest, UnsortedArray2) {
   int array[7] = {10, 40, 45, 55, 35, 23, 60};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -130,7 +130,7 @@ TEST(LlvmLibcQsortTest, UnsortedArray2) {
   ASSERT_LE(array[6], 60);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedArrayDuplicateElements1) {
+TEST(LlvmLibcQSortTest, UnsortedArrayDuplicateElements1) {
   int array[6] = {10, 10, 20, 20, 5, 5};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -144,7 +144,7 @@ TEST(LlvmLibcQsortTest, UnsortedArrayDuplicateElements1) {
   ASSERT_LE(array[5], 20);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedArrayDuplicateElements2) {
+TEST(LlvmLibcQSortTest, UnsortedArrayDuplicateElements2) {
   int array[10] = {20, 10, 10, 10, 10, 20, 21, 21, 21, 21};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -162,7 +162,7 @@ TEST(LlvmLibcQsortTest, UnsortedArrayDuplicateElements2) {
   ASSERT_LE(array[9], 21);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedArrayDuplicateElements3) {
+TEST(LlvmLibcQSortTest, UnsortedArrayDuplicateElements3) {
   int array[10] = {20, 30, 30, 30, 30, 20, 21, 21, 21, 21};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -180,7 +180,7 @@ TEST(LlvmLibcQsortTest, UnsortedArrayDuplicateElements3) {
   ASSERT_LE(array[9], 30);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedThreeElementArray1) {
+TEST(LlvmLibcQSortTest, UnsortedThreeElementArray1) {
   int array[3] = {14999024, 0, 3};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -191,7 +191,7 @@ TEST(LlvmLibcQsortTest, UnsortedThreeElementArray1) {
   ASSERT_LE(array[2], 14999024);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedThreeElementArray2) {
+TEST(LlvmLibcQSortTest, UnsortedThreeElementArray2) {
   int array[3] = {3, 14999024, 0};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -202,7 +202,7 @@ TEST(LlvmLibcQsortTest, UnsortedThreeElementArray2) {
   ASSERT_LE(array[2], 14999024);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedThreeElementArray3) {
+TEST(LlvmLibcQSortTest, UnsortedThreeElementArray3) {
   int array[3] = {3, 0, 14999024};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -213,7 +213,7 @@ TEST(LlvmLibcQsortTest, UnsortedThreeElementArray3) {
   ASSERT_LE(array[2], 14999024);
 }
 
-TEST(LlvmLibcQsortTest, SameElementThreeElementArray) {
+TEST(LlvmLibcQSortTest, SameElementThreeElementArray) {
   int array[3] = {12345, 12345, 12345};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -224,7 +224,7 @@ TEST(LlvmLibcQsortTest, SameElementThreeElementArray) {
   ASSERT_LE(array[2], 12345);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedTwoElementArray1) {
+TEST(LlvmLibcQSortTest, UnsortedTwoElementArray1) {
   int array[2] = {14999024, 0};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -234,7 +234,7 @@ TEST(LlvmLibcQsortTest, UnsortedTwoElementArray1) {
   ASSERT_LE(array[1], 14999024);
 }
 
-TEST(LlvmLibcQsortTest, UnsortedTwoElementArray2) {
+TEST(LlvmLibcQSortTest, UnsortedTwoElementArray2) {
   int array[2] = {0, 14999024};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -244,7 +244,7 @@ TEST(LlvmLibcQsortTest, UnsortedTwoElementArray2) {
   ASSERT_LE(array[1], 14999024);
 }
 
-TEST(LlvmLibcQsortTest, SameElementTwoElementArray) {
+TEST(LlvmLibcQSortTest, SameElementTwoElementArray) {
   int array[2] = {12345, 12345};
   constexpr size_t ARRAY_SIZE = sizeof(array) / sizeof(int);
 
@@ -263,3 +263,50 @@ TEST(LlvmLibcQSortTest, SingleElementArray) {
 
   ASSERT_LE(array[0], ELEM);
 }
+
+TEST(LlvmLibcQSortTest, LargeOrganPipeArray) {
+  // Ascending then descending values, a classic bad case for median-of-three
+  // pivots. With 1000 elements, several ranges exceed the depth limit and are
+  // finished with heapsort.
+  constexpr size_t ARRAY_SIZE = 1000;
+  int array[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE / 2; ++i) {
+    array[i] = static_cast<int>(i);
+    array[ARRAY_SIZE - 1 - i] = static_cast<int>(i);
+  }
+
+  LIBC_NAMESPACE::qsort(array, ARRAY_SIZE, sizeof(int), int_compare);
+
+  for (size_t i = 1; i < ARRAY_SIZE; ++i)
+    ASSERT_LE(array[i - 1], array[i]);
+}
+
+struct TwelveByteElem {
+  int key;
+  int payload[2];
+};
+
+static int twelve_byte_compare(const void *l, const void *r) {
+  return int_compare(&reinterpret_cast<const TwelveByteElem *>(l)->key,
+                     &reinterpret_cast<const TwelveByteElem *>(r)->key);
+}
+
+TEST(LlvmLibcQSortTest, UnsortedArrayOfStructs) {
+  // Exercises the generic swap path for an element size without a dedicated
+  // fast path.
+  constexpr size_t ARRAY_SIZE = 100;
+  TwelveByteElem array[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    int key = static_cast<int>((i * 37) % ARRAY_SIZE);
+    array[i] = {key, {key, -key}};
+  }
+
+  LIBC_NAMESPACE::qsort(array, ARRAY_SIZE, sizeof(TwelveByteElem),
+                        twelve_byte_compare);
+
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    ASSERT_EQ(array[i].key, static_cast<int>(i));
+    ASSERT_EQ(array[i].payload[0], static_cast<int>(i));
+    ASSERT_EQ(array[i].payload[1], -static_cast<int>(i));
+  }
+}
@@ -70,6 +70,17 @@ TEST_F(LlvmLibcStrToDTest, SimpleTest) {
   run_test("0x123", 5, uint64_t(0x4072300000000000));
 }
 
+TEST_F(LlvmLibcStrToDTest, EightDigitBlocks) {
+  // Mantissas are consumed eight digits at a time when possible. Check runs
+  // that end on, before and after a block boundary and around the decimal
+  // point.
+  run_test("1234567", 7, uint64_t(0x4132d68700000000));
+  run_test("12345678.87654321", 17, uint64_t(0x41678c29dc0ca459));
+  run_test("1234567.812345678", 17, uint64_t(0x4132d687cff5e2e8));
+  run_test("0.1234567890123456789", 21, uint64_t(0x3fbf9add3746f65f));
+  run_test("123456781234567812345678e-20", 28, uint64_t(0x40934a4570997bcf));
+}
+
 // These are tests that have caused problems in the past.
 TEST_F(LlvmLibcStrToDTest, SpecificFailures) {
   run_test("3E70000000000000", 16, uint64_t(0x7FF0000000000000), ERANGE);
@@ -0,0 +1 @@
+set(LIBCXX_PSTL_BACKEND work_stealing CACHE STRING "")
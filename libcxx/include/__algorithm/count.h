@@ -12,6 +12,8 @@
 
 #include <__algorithm/iterator_operations.h>
 #include <__algorithm/min.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__bit/invert_if.h>
 #include <__bit/popcount.h>
 #include <__config>
@@ -19,6 +21,13 @@
 #include <__functional/invoke.h>
 #include <__fwd/bit_reference.h>
 #include <__iterator/iterator_traits.h>
+#include <__type_traits/enable_if.h>
+#include <__type_traits/is_constant_evaluated.h>
+#include <__type_traits/is_integral.h>
+#include <__type_traits/is_same.h>
+#include <__type_traits/remove_cv.h>
+#include <cstddef>
+#include <cstdint>
 
 #if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
 #  pragma GCC system_header
@@ -40,6 +49,64 @@ __count(_Iter __first, _Sent __last, const _Tp& __value, _Proj& __proj) {
   return __r;
 }
 
+// The kernel reduces the lane counters with __builtin_reduce_add, which not every compiler that can use simd_utils.h
+// provides.
+#if _LIBCPP_VECTORIZE_ALGORITHMS && __has_builtin(__builtin_reduce_add)
+#  define _LIBCPP_VECTORIZE_COUNT 1
+#else
+#  define _LIBCPP_VECTORIZE_COUNT 0
+#endif
+
+#if _LIBCPP_VECTORIZE_COUNT
+
+template <class _Tp>
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 ptrdiff_t
+__count_vectorized(_Tp* __first, _Tp* __last, const __remove_cv_t<_Tp>& __value) {
+  ptrdiff_t __r = 0;
+
+  if (!__libcpp_is_constant_evaluated()) {
+    using __value_type          = __remove_cv_t<_Tp>;
+    constexpr size_t __vec_size = __native_vector_size<__value_type>;
+    using __vec                 = __simd_vector<__value_type, __vec_size>;
+    using __mask_vec            = decltype(__vec() == __vec());
+    using __lane_type           = __simd_vector_underlying_type_t<__mask_vec>;
+
+    // Every comparison yields -1 in the matching lanes, so subtracting it counts the matches per lane. The lanes are
+    // only as wide as the elements, so they are folded into __r before they can overflow.
+    constexpr size_t __max_block_size = (size_t(1) << (sizeof(__lane_type) * 8 - 1)) - 1;
+
+    const __vec __needle = __value;
+    while (static_cast<size_t>(__last - __first) >= __vec_size) {
+      size_t __block_size = std::min(__max_block_size, static_cast<size_t>(__last - __first) / __vec_size);
+      __mask_vec __counts{};
+      for (size_t __i = 0; __i != __block_size; ++__i) {
+        __counts -= std::__load_vector<__vec>(__first) == __needle;
+        __first += __vec_size;
+      }
+      __r += __builtin_reduce_add(__builtin_convertvector(__counts, __simd_vector<int64_t, __vec_size>));
+    }
+  }
+
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      ++__r;
+  return __r;
+}
+
+template <class _AlgPolicy,
+          class _Tp,
+          class _Up,
+          class _Proj,
+          __enable_if_t<is_integral<_Tp>::value && !is_same<__remove_cv_t<_Tp>, bool>::value &&
+                            is_same<__remove_cv_t<_Tp>, _Up>::value && __is_identity<_Proj>::value,
+                        int> = 0>
+_LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 ptrdiff_t
+__count(_Tp* __first, _Tp* __last, const _Up& __value, _Proj&) {
+  return std::__count_vectorized(__first, __last, __value);
+}
+
+#endif // _LIBCPP_VECTORIZE_COUNT
+
 // __bit_iterator implementation
 template <bool _ToCount, class _Cp, bool _IsConst>
 _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 typename __bit_iterator<_Cp, _IsConst>::difference_type
@@ -82,7 +149,7 @@ template <class _InputIterator, class _Tp>
 _LIBCPP_NODISCARD inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_SINCE_CXX20 __iter_diff_t<_InputIterator>
 count(_InputIterator __first, _InputIterator __last, const _Tp& __value) {
   __identity __proj;
-  return std::__count<_ClassicAlgPolicy>(__first, __last, __value, __proj);
+  return std::__count<_ClassicAlgPolicy>(std::__unwrap_iter(__first), std::__unwrap_iter(__last), __value, __proj);
 }
 
 _LIBCPP_END_NAMESPACE_STD
@@ -28,6 +28,7 @@
 #include <__format/formatter_char.h>
 #include <__format/formatter_floating_point.h>
 #include <__format/formatter_integer.h>
+#include <__format/formatter_output.h>
 #include <__format/formatter_pointer.h>
 #include <__format/formatter_string.h>
 #include <__format/parser_std_format_spec.h>
@@ -331,7 +332,17 @@ _LIBCPP_HIDE_FROM_ABI constexpr typename _Ctx::iterator __vformat_to(_ParseCtx&&
     }
 
     // Copy the character to the output verbatim.
-    *__out_it++ = *__begin++;
+    if constexpr (same_as<typename _Ctx::iterator, back_insert_iterator<__output_buffer<_CharT>>>) {
+      // Copy the whole run of literal text up to the next replacement field
+      // or escape sequence at once. This lets the buffer check its capacity
+      // once per run instead of once per character.
+      auto __run_end = __begin + 1;
+      while (__run_end != __end && *__run_end != _CharT('{') && *__run_end != _CharT('}'))
+        ++__run_end;
+      __out_it = __formatter::__copy(__begin, __run_end, std::move(__out_it));
+      __begin  = __run_end;
+    } else
+      *__out_it++ = *__begin++;
   }
   return __out_it;
 }
@@ -28,6 +28,9 @@ _LIBCPP_PUSH_MACROS
 #elif defined(_LIBCPP_PSTL_BACKEND_LIBDISPATCH)
 #  include <__pstl/backends/default.h>
 #  include <__pstl/backends/libdispatch.h>
+#elif defined(_LIBCPP_PSTL_BACKEND_WORK_STEALING)
+#  include <__pstl/backends/default.h>
+#  include <__pstl/backends/work_stealing.h>
 #endif
 
 _LIBCPP_POP_MACROS
@@ -0,0 +1,292 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___PSTL_BACKENDS_WORK_STEALING_H
+#define _LIBCPP___PSTL_BACKENDS_WORK_STEALING_H
+
+#include <__algorithm/inplace_merge.h>
+#include <__algorithm/lower_bound.h>
+#include <__algorithm/max.h>
+#include <__algorithm/upper_bound.h>
+#include <__config>
+#include <__iterator/move_iterator.h>
+#include <__memory/construct_at.h>
+#include <__numeric/reduce.h>
+#include <__pstl/backend_fwd.h>
+#include <__pstl/cpu_algos/any_of.h>
+#include <__pstl/cpu_algos/cpu_traits.h>
+#include <__pstl/cpu_algos/fill.h>
+#include <__pstl/cpu_algos/find_if.h>
+#include <__pstl/cpu_algos/for_each.h>
+#include <__pstl/cpu_algos/merge.h>
+#include <__pstl/cpu_algos/stable_sort.h>
+#include <__pstl/cpu_algos/transform.h>
+#include <__pstl/cpu_algos/transform_reduce.h>
+#include <__utility/empty.h>
+#include <__utility/move.h>
+#include <cstddef>
+#include <new>
+#include <optional>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#  pragma GCC system_header
+#endif
+
+_LIBCPP_PUSH_MACROS
+#include <__undef_macros>
+
+#if _LIBCPP_STD_VER >= 17
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+namespace __pstl {
+
+namespace __work_stealing {
+// Runs __func(__context, __chunk) for every __chunk in [0, __chunk_count) on a persistent pool of threads, and
+// returns once all of them have completed. The calling thread takes part in the execution. Calls may be nested: a
+// chunk can itself call __parallel_apply, in which case the calling worker keeps executing (or stealing) work while
+// it waits.
+_LIBCPP_EXPORTED_FROM_ABI void
+__parallel_apply(size_t __chunk_count, void* __context, void (*__func)(void* __context, size_t __chunk)) noexcept;
+
+template <class _Func>
+_LIBCPP_HIDE_FROM_ABI void __parallel_apply(size_t __chunk_count, _Func __func) noexcept {
+  __work_stealing::__parallel_apply(__chunk_count, &__func, [](void* __context, size_t __chunk) {
+    (*static_cast<_Func*>(__context))(__chunk);
+  });
+}
+
+struct __chunk_partitions {
+  ptrdiff_t __chunk_count_; // includes the first chunk
+  ptrdiff_t __chunk_size_;
+  ptrdiff_t __first_chunk_size_;
+
+  _LIBCPP_HIDE_FROM_ABI ptrdiff_t __chunk_begin(size_t __chunk) const {
+    return __chunk == 0 ? 0 : __first_chunk_size_ + (static_cast<ptrdiff_t>(__chunk) - 1) * __chunk_size_;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI ptrdiff_t __chunk_length(size_t __chunk) const {
+    return __chunk == 0 ? __first_chunk_size_ : __chunk_size_;
+  }
+};
+
+// Splits __element_count elements into chunks sized for the current pool. There are usually several chunks per
+// thread, so that threads which finish early can steal work from the others.
+_LIBCPP_EXPORTED_FROM_ABI __chunk_partitions __partition_chunks(ptrdiff_t __element_count) noexcept;
+
+template <class _Tp>
+struct __temporary_array {
+  _Tp* __data_ = nullptr;
+  size_t __constructed_ = 0;
+
+  _LIBCPP_HIDE_FROM_ABI explicit __temporary_array(size_t __size) noexcept
+      : __data_(static_cast<_Tp*>(::operator new(__size * sizeof(_Tp), align_val_t(alignof(_Tp)), nothrow))) {}
+
+  __temporary_array(const __temporary_array&)            = delete;
+  __temporary_array& operator=(const __temporary_array&) = delete;
+
+  _LIBCPP_HIDE_FROM_ABI ~__temporary_array() {
+    if (__data_ == nullptr)
+      return;
+    for (size_t __i = 0; __i != __constructed_; ++__i)
+      std::__destroy_at(__data_ + __i);
+    ::operator delete(__data_, align_val_t(alignof(_Tp)));
+  }
+};
+} // namespace __work_stealing
+
+template <>
+struct __cpu_traits<__work_stealing_backend_tag> {
+  template <class _RandomAccessIterator, class _Functor>
+  _LIBCPP_HIDE_FROM_ABI static optional<__empty>
+  __for_each(_RandomAccessIterator __first, _RandomAccessIterator __last, _Functor __func) {
+    auto __partitions = __work_stealing::__partition_chunks(__last - __first);
+    __work_stealing::__parallel_apply(__partitions.__chunk_count_, [&](size_t __chunk) {
+      auto __chunk_first = __first + __partitions.__chunk_begin(__chunk);
+      __func(__chunk_first, __chunk_first + __partitions.__chunk_length(__chunk));
+    });
+    return __empty{};
+  }
+
+  template <class _RandomAccessIterator1,
+            class _RandomAccessIterator2,
+            class _RandomAccessIterator3,
+            class _Compare,
+            class _LeafMerge>
+  _LIBCPP_HIDE_FROM_ABI static optional<__empty>
+  __merge(_RandomAccessIterator1 __first1,
+          _RandomAccessIterator1 __last1,
+          _RandomAccessIterator2 __first2,
+          _RandomAccessIterator2 __last2,
+          _RandomAccessIterator3 __result,
+          _Compare __comp,
+          _LeafMerge __leaf_merge) noexcept {
+    // The larger range is split into chunks, and the matching split points in the smaller range are found by binary
+    // search. Equal elements from the first range must come before those from the second one, hence lower_bound when
+    // splitting the second range and upper_bound when splitting the first.
+    const bool __split_first = (__last1 - __first1) >= (__last2 - __first2);
+    auto __partitions =
+        __work_stealing::__partition_chunks(__split_first ? __last1 - __first1 : __last2 - __first2);
+    if (__partitions.__chunk_count_ == 1) {
+      __leaf_merge(__first1, __last1, __first2, __last2, __result, __comp);
+      return __empty{};
+    }
+
+    auto __split = [&](size_t __chunk, _RandomAccessIterator1& __it1, _RandomAccessIterator2& __it2) {
+      if (static_cast<ptrdiff_t>(__chunk) == __partitions.__chunk_count_) {
+        __it1 = __last1;
+        __it2 = __last2;
+      } else if (__split_first) {
+        __it1 = __first1 + __partitions.__chunk_begin(__chunk);
+        __it2 = __chunk == 0 ? __first2 : std::lower_bound(__first2, __last2, *__it1, __comp);
+      } else {
+        __it2 = __first2 + __partitions.__chunk_begin(__chunk);
+        __it1 = __chunk == 0 ? __first1 : std::upper_bound(__first1, __last1, *__it2, __comp);
+      }
+    };
+
+    __work_stealing::__parallel_apply(__partitions.__chunk_count_, [&](size_t __chunk) {
+      _RandomAccessIterator1 __chunk_first1, __chunk_last1;
+      _RandomAccessIterator2 __chunk_first2, __chunk_last2;
+      __split(__chunk, __chunk_first1, __chunk_first2);
+      __split(__chunk + 1, __chunk_last1, __chunk_last2);
+      __leaf_merge(__chunk_first1,
+                   __chunk_last1,
+                   __chunk_first2,
+                   __chunk_last2,
+                   __result + (__chunk_first1 - __first1) + (__chunk_first2 - __first2),
+                   __comp);
+    });
+    return __empty{};
+  }
+
+  template <class _RandomAccessIterator, class _Transform, class _Value, class _Combiner, class _Reduction>
+  _LIBCPP_HIDE_FROM_ABI static optional<_Value> __transform_reduce(
+      _RandomAccessIterator __first,
+      _RandomAccessIterator __last,
+      _Transform __transform,
+      _Value __init,
+      _Combiner __combiner,
+      _Reduction __reduction) {
+    if (__first == __last)
+      return __init;
+
+    auto __partitions = __work_stealing::__partition_chunks(__last - __first);
+    __work_stealing::__temporary_array<_Value> __values(__partitions.__chunk_count_);
+    if (__values.__data_ == nullptr)
+      return nullopt;
+
+    // Each chunk writes its partial result to its own slot, which is then reduced serially. Chunks are claimed in
+    // index order, but they may complete in any order, so only count the slots once everything is done.
+    __work_stealing::__parallel_apply(__partitions.__chunk_count_, [&](size_t __chunk) {
+      auto __chunk_first = __first + __partitions.__chunk_begin(__chunk);
+      auto __chunk_size  = __partitions.__chunk_length(__chunk);
+      if (__chunk_size != 1) {
+        std::__construct_at(
+            __values.__data_ + __chunk,
+            __reduction(__chunk_first + 2,
+                        __chunk_first + __chunk_size,
+                        __combiner(__transform(__chunk_first), __transform(__chunk_first + 1))));
+      } else {
+        std::__construct_at(__values.__data_ + __chunk, __transform(__chunk_first));
+      }
+    });
+    __values.__constructed_ = __partitions.__chunk_count_;
+
+    return std::reduce(std::make_move_iterator(__values.__data_),
+                       std::make_move_iterator(__values.__data_ + __partitions.__chunk_count_),
+                       std::move(__init),
+                       __combiner);
+  }
+
+  template <class _RandomAccessIterator, class _Comp, class _LeafSort>
+  _LIBCPP_HIDE_FROM_ABI static optional<__empty>
+  __stable_sort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Comp __comp, _LeafSort __leaf_sort) {
+    auto __partitions = __work_stealing::__partition_chunks(__last - __first);
+    if (__partitions.__chunk_count_ == 1) {
+      __leaf_sort(__first, __last, __comp);
+      return __empty{};
+    }
+
+    __work_stealing::__parallel_apply(__partitions.__chunk_count_, [&](size_t __chunk) {
+      auto __chunk_first = __first + __partitions.__chunk_begin(__chunk);
+      __leaf_sort(__chunk_first, __chunk_first + __partitions.__chunk_length(__chunk), __comp);
+    });
+
+    // Merge adjacent sorted runs pairwise until a single run is left. Every round halves the number of runs, and the
+    // merges within a round are independent of each other.
+    auto __run_begin = [&](ptrdiff_t __run) {
+      return __run >= __partitions.__chunk_count_ ? __last : __first + __partitions.__chunk_begin(__run);
+    };
+    for (ptrdiff_t __width = 1; __width < __partitions.__chunk_count_; __width *= 2) {
+      ptrdiff_t __merges = (__partitions.__chunk_count_ + 2 * __width - 1) / (2 * __width);
+      __work_stealing::__parallel_apply(__merges, [&](size_t __merge) {
+        ptrdiff_t __left = static_cast<ptrdiff_t>(__merge) * 2 * __width;
+        auto __middle    = __run_begin(__left + __width);
+        auto __end       = __run_begin(__left + 2 * __width);
+        if (__middle != __end)
+          std::inplace_merge(__run_begin(__left), __middle, __end, __comp);
+      });
+    }
+    return __empty{};
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static void __cancel_execution() {}
+
+  static constexpr size_t __lane_size = 64;
+};
+
+// Mandatory implementations of the computational basis
+template <class _ExecutionPolicy>
+struct __find_if<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_find_if<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __for_each<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_for_each<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __merge<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_merge<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __stable_sort<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_stable_sort<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform_binary<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform_binary<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform_reduce<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform_reduce<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __transform_reduce_binary<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_transform_reduce_binary<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+// Not mandatory, but better optimized
+template <class _ExecutionPolicy>
+struct __any_of<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_any_of<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+template <class _ExecutionPolicy>
+struct __fill<__work_stealing_backend_tag, _ExecutionPolicy>
+    : __cpu_parallel_fill<__work_stealing_backend_tag, _ExecutionPolicy> {};
+
+} // namespace __pstl
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP_STD_VER >= 17
+
+_LIBCPP_POP_MACROS
+
+#endif // _LIBCPP___PSTL_BACKENDS_WORK_STEALING_H
@@ -6,6 +6,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <__bit/countl.h>
+#include <limits>
 #include <memory>
 #include <memory_resource>
 
@@ -280,15 +282,16 @@ int unsynchronized_pool_resource::__pool_index(size_t bytes, size_t align) const
   if (align > alignof(std::max_align_t) || bytes > (size_t(1) << __num_fixed_pools_))
     return __num_fixed_pools_;
   else {
-    int i = 0;
+    // The pool index is the number of significant bits above the smallest
+    // block size. This runs on every allocation and deallocation, which in
+    // synchronized_pool_resource happens with the lock held, so compute it
+    // directly instead of shifting one bit at a time.
     bytes = (bytes > align) ? bytes : align;
     bytes -= 1;
     bytes >>= __log2_smallest_block_size;
-    while (bytes != 0) {
-      bytes >>= 1;
-      i += 1;
-    }
-    return i;
+    if (bytes == 0)
+      return 0;
+    return numeric_limits<size_t>::digits - std::__countl_zero(bytes);
   }
 }
 
@@ -0,0 +1,282 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <__algorithm/max.h>
+#include <__algorithm/min.h>
+#include <__config>
+#include <__pstl/backends/work_stealing.h>
+#include <__utility/no_destroy.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+namespace __pstl::__work_stealing {
+namespace {
+
+// A job is a set of chunks submitted by a single call to __parallel_apply. Chunks are claimed one at a time through
+// an atomic counter, so any number of threads can cooperate on the same job without splitting it up front. This
+// keeps the load balanced even when chunks take very different amounts of time.
+struct __job {
+  void* __context_;
+  void (*__func_)(void*, size_t);
+  size_t __chunk_count_;
+  atomic<size_t> __next_chunk_{0};
+  atomic<size_t> __finished_chunks_{0};
+  // Number of threads other than the submitter that are currently executing chunks of this job. The submitter must
+  // wait for this to drop to zero before the job can go out of scope.
+  atomic<size_t> __helpers_{0};
+
+  __job(void* __context, void (*__func)(void*, size_t), size_t __chunk_count)
+      : __context_(__context), __func_(__func), __chunk_count_(__chunk_count) {}
+
+  bool __exhausted() const { return __next_chunk_.load(memory_order_relaxed) >= __chunk_count_; }
+
+  // Runs chunks until none are left to claim. Returns whether at least one chunk was run.
+  bool __run_chunks() {
+    bool __ran = false;
+    for (;;) {
+      size_t __chunk = __next_chunk_.fetch_add(1, memory_order_relaxed);
+      if (__chunk >= __chunk_count_)
+        return __ran;
+      __func_(__context_, __chunk);
+      __finished_chunks_.fetch_add(1, memory_order_release);
+      __ran = true;
+    }
+  }
+
+  bool __done() const {
+    return __finished_chunks_.load(memory_order_acquire) == __chunk_count_ &&
+           __helpers_.load(memory_order_acquire) == 0;
+  }
+
+  // Called by a helper once it stops running chunks of this job. The count is decremented under the mutex, so that
+  // the submitter cannot observe zero helpers and destroy the job while the notification is still in flight.
+  void __release_helper() {
+    lock_guard<mutex> __lock(__helpers_mutex_);
+    if (__helpers_.fetch_sub(1, memory_order_release) == 1)
+      __helpers_cv_.notify_all();
+  }
+
+  // Blocks until every helper has released the job.
+  void __wait_for_helpers() {
+    unique_lock<mutex> __lock(__helpers_mutex_);
+    __helpers_cv_.wait(__lock, [this] { return __helpers_.load(memory_order_acquire) == 0; });
+  }
+
+private:
+  mutex __helpers_mutex_;
+  condition_variable __helpers_cv_;
+};
+
+// Every pool thread owns a deque of jobs. The owner pushes and pops nested jobs at the back, which keeps the most
+// recently split (and cache-hot) work local, while idle threads steal the oldest, and usually largest, jobs from the
+// front. Threads outside of the pool submit their jobs to a shared injection queue instead.
+struct __job_queue {
+  mutex __mutex_;
+  deque<__job*> __jobs_;
+
+  void __push(__job* __j) {
+    lock_guard<mutex> __lock(__mutex_);
+    __jobs_.push_back(__j);
+  }
+
+  void __remove(__job* __j) {
+    lock_guard<mutex> __lock(__mutex_);
+    for (auto __it = __jobs_.begin(); __it != __jobs_.end(); ++__it) {
+      if (*__it == __j) {
+        __jobs_.erase(__it);
+        return;
+      }
+    }
+  }
+
+  // Finds a job that still has chunks to claim and registers the calling thread as a helper of that job. Registering
+  // under the lock guarantees that the submitter, which removes the job under the same lock, waits for us.
+  __job* __acquire(bool __from_back) {
+    lock_guard<mutex> __lock(__mutex_);
+    if (__from_back) {
+      for (auto __it = __jobs_.rbegin(); __it != __jobs_.rend(); ++__it)
+        if (!(*__it)->__exhausted())
+          return __register(*__it);
+    } else {
+      for (auto __it = __jobs_.begin(); __it != __jobs_.end(); ++__it)
+        if (!(*__it)->__exhausted())
+          return __register(*__it);
+    }
+    return nullptr;
+  }
+
+private:
+  static __job* __register(__job* __j) {
+    __j->__helpers_.fetch_add(1, memory_order_relaxed);
+    return __j;
+  }
+};
+
+class __thread_pool {
+public:
+  __thread_pool() {
+    unsigned __hw = thread::hardware_concurrency();
+    // The submitting thread always participates, so one worker fewer than the number of hardware threads is enough
+    // to saturate the machine.
+    size_t __worker_count = __hw > 1 ? __hw - 1 : 0;
+    __queues_ = unique_ptr<__job_queue[]>(new __job_queue[__worker_count]);
+    for (size_t __i = 0; __i != __worker_count; ++__i) {
+#ifndef _LIBCPP_HAS_NO_EXCEPTIONS
+      try {
+#endif // _LIBCPP_HAS_NO_EXCEPTIONS
+        thread(&__thread_pool::__worker_main, this, __i).detach();
+        ++__worker_count_;
+#ifndef _LIBCPP_HAS_NO_EXCEPTIONS
+      } catch (...) {
+        // Run with however many workers we managed to start.
+        break;
+      }
+#endif // _LIBCPP_HAS_NO_EXCEPTIONS
+    }
+  }
+
+  size_t __concurrency() const { return __worker_count_ + 1; }
+
+  void __apply(size_t __chunk_count, void* __context, void (*__func)(void*, size_t)) {
+    if (__chunk_count == 0)
+      return;
+    if (__chunk_count == 1 || __worker_count_ == 0) {
+      for (size_t __i = 0; __i != __chunk_count; ++__i)
+        __func(__context, __i);
+      return;
+    }
+
+    __job __j(__context, __func, __chunk_count);
+    __job_queue& __queue = __current_worker_ != nullptr ? *__current_worker_ : __injection_queue_;
+    __queue.__push(&__j);
+    __wake_workers(__chunk_count - 1);
+
+    __j.__run_chunks();
+    // Nobody can start helping with this job once it is out of the queue.
+    __queue.__remove(&__j);
+
+    // Other threads may still be running the last chunks. Help with whatever other work is available first; this is
+    // what makes nested parallelism from inside a chunk safe, since a pool thread never waits for work that may be
+    // sitting in its own deque. Once there is nothing left to run, no new work can appear in our own deque, so it is
+    // safe to block until the helpers are done.
+    while (!__j.__done()) {
+      if (!__try_run_one()) {
+        __j.__wait_for_helpers();
+        break;
+      }
+    }
+  }
+
+private:
+  void __wake_workers(size_t __count) {
+    {
+      lock_guard<mutex> __lock(__sleep_mutex_);
+      ++__epoch_;
+    }
+    if (__count >= __worker_count_)
+      __sleep_cv_.notify_all();
+    else
+      for (size_t __i = 0; __i != __count; ++__i)
+        __sleep_cv_.notify_one();
+  }
+
+  // Looks for a job on the calling thread's own deque, then on the injection queue, then on the other workers'
+  // deques, and runs chunks of the first one found.
+  bool __try_run_one() {
+    __job* __j = nullptr;
+    size_t __self = __worker_count_;
+    if (__current_worker_ != nullptr) {
+      __self = static_cast<size_t>(__current_worker_ - __queues_.get());
+      __j = __current_worker_->__acquire(/*__from_back=*/true);
+    }
+    if (__j == nullptr)
+      __j = __injection_queue_.__acquire(/*__from_back=*/false);
+    for (size_t __i = 1; __j == nullptr && __i <= __worker_count_; ++__i) {
+      size_t __victim = (__self + __i) % __worker_count_;
+      if (__victim != __self)
+        __j = __queues_[__victim].__acquire(/*__from_back=*/false);
+    }
+    if (__j == nullptr)
+      return false;
+    __j->__run_chunks();
+    __j->__release_helper();
+    return true;
+  }
+
+  void __worker_main(size_t __index) {
+    __current_worker_ = &__queues_[__index];
+    for (;;) {
+      unsigned long long __epoch;
+      {
+        lock_guard<mutex> __lock(__sleep_mutex_);
+        __epoch = __epoch_;
+      }
+      // Spin for a little while before going to sleep, since parallel algorithms are often called back-to-back.
+      bool __found = false;
+      for (int __spin = 0; __spin != 64; ++__spin) {
+        if (__try_run_one()) {
+          __found = true;
+          break;
+        }
+        this_thread::yield();
+      }
+      if (__found)
+        continue;
+      unique_lock<mutex> __lock(__sleep_mutex_);
+      __sleep_cv_.wait(__lock, [&] { return __epoch_ != __epoch; });
+    }
+  }
+
+  static thread_local __job_queue* __current_worker_;
+
+  size_t __worker_count_ = 0;
+  unique_ptr<__job_queue[]> __queues_;
+  __job_queue __injection_queue_;
+
+  mutex __sleep_mutex_;
+  condition_variable __sleep_cv_;
+  unsigned long long __epoch_ = 0;
+};
+
+thread_local __job_queue* __thread_pool::__current_worker_ = nullptr;
+
+// The workers are detached and never joined, so the pool must outlive every static destructor that could still run a
+// parallel algorithm.
+__thread_pool& __get_pool() {
+  static __no_destroy<__thread_pool> __pool;
+  return __pool.__get();
+}
+
+} // namespace
+
+void __parallel_apply(size_t __chunk_count, void* __context, void (*__func)(void* __context, size_t __chunk)) noexcept {
+  __get_pool().__apply(__chunk_count, __context, __func);
+}
+
+__chunk_partitions __partition_chunks(ptrdiff_t __element_count) noexcept {
+  __chunk_partitions __partitions;
+  // Aim for several chunks per thread so that stealing can even out imbalances, but don't make chunks so small that
+  // claiming them dominates the work.
+  const ptrdiff_t __target_chunks = static_cast<ptrdiff_t>(__get_pool().__concurrency()) * 8;
+  const ptrdiff_t __min_chunk_size = 2048;
+  __partitions.__chunk_count_ =
+      std::max<ptrdiff_t>(1, std::min(__target_chunks, __element_count / __min_chunk_size));
+  __partitions.__chunk_size_   = __element_count / __partitions.__chunk_count_;
+  __partitions.__first_chunk_size_ =
+      __element_count - (__partitions.__chunk_count_ - 1) * __partitions.__chunk_size_;
+  return __partitions;
+}
+
+} // namespace __pstl::__work_stealing
+_LIBCPP_END_NAMESPACE_STD
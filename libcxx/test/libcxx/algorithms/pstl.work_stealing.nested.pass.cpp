@@ -0,0 +1,57 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// UNSUPPORTED: c++03, c++11, c++14
+
+// UNSUPPORTED: libcpp-has-no-incomplete-pstl
+// REQUIRES: libcpp-pstl-backend-work-stealing
+
+// Parallel algorithms may be called from inside the element functions of other parallel algorithms. Every chunk must
+// run exactly once, and the outer call must not return before the nested ones are done.
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+int main(int, char**) {
+  std::vector<int> outer(64);
+  std::iota(outer.begin(), outer.end(), 0);
+  std::vector<std::vector<int>> inner(outer.size(), std::vector<int>(100000));
+
+  for (int iteration = 0; iteration != 10; ++iteration) {
+    std::atomic<long long> visited{0};
+    std::for_each(std::execution::par, outer.begin(), outer.end(), [&](int i) {
+      std::vector<int>& v = inner[i];
+      std::fill(std::execution::par, v.begin(), v.end(), i);
+      std::for_each(std::execution::par, v.begin(), v.end(), [&](int& x) {
+        ++x;
+        visited.fetch_add(1, std::memory_order_relaxed);
+      });
+    });
+    assert(visited.load() == static_cast<long long>(outer.size() * inner[0].size()));
+    for (int i : outer)
+      assert(std::all_of(inner[i].begin(), inner[i].end(), [&](int x) { return x == i + 1; }));
+  }
+
+  {
+    std::vector<int> v(1 << 20);
+    for (std::size_t i = 0; i != v.size(); ++i)
+      v[i] = static_cast<int>((i * 7919) % v.size());
+    std::sort(std::execution::par, v.begin(), v.end());
+    assert(std::is_sorted(v.begin(), v.end()));
+    long long sum = std::reduce(std::execution::par, v.begin(), v.end(), 0ll);
+    assert(sum == static_cast<long long>(v.size()) * (v.size() - 1) / 2);
+  }
+  return 0;
+}
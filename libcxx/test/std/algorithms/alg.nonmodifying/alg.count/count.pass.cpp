@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <vector>
 
 #include "test_macros.h"
@@ -35,6 +36,29 @@ struct Test {
   }
 };
 
+// Contiguous ranges of integers may be counted with vector instructions, whose per-lane counters are folded into the
+// result before they overflow. Check the sizes around those folds, with every element matching.
+template <class T>
+void test_vectorized_boundaries() {
+  const size_t lane_limit = (size_t(1) << (sizeof(T) * 8 - 1)) - 1;
+  const size_t sizes[]    = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65};
+  for (size_t vec_size : {16 / sizeof(T), 32 / sizeof(T)}) {
+    const size_t fold = lane_limit * vec_size;
+    for (size_t n : {fold - 1, fold, fold + 1, fold + vec_size - 1, 2 * fold + vec_size + 1}) {
+      std::vector<T> vec(n, T(1));
+      assert(std::count(vec.begin(), vec.end(), T(1)) == static_cast<std::ptrdiff_t>(n));
+      assert(std::count(vec.begin(), vec.end(), T(0)) == 0);
+    }
+  }
+  for (size_t n : sizes) {
+    std::vector<T> vec(n, T(0));
+    for (size_t i = 0; i < n; i += 3)
+      vec[i] = T(-1);
+    assert(std::count(vec.data(), vec.data() + n, T(-1)) == static_cast<std::ptrdiff_t>((n + 2) / 3));
+    assert(std::count(vec.data(), vec.data() + n, T(0)) == static_cast<std::ptrdiff_t>(n - (n + 2) / 3));
+  }
+}
+
 TEST_CONSTEXPR_CXX20 bool test() {
   types::for_each(types::cpp17_input_iterator_list<const int*>(), Test());
 
@@ -55,6 +79,10 @@ TEST_CONSTEXPR_CXX20 bool test() {
 
 int main(int, char**) {
   test();
+  test_vectorized_boundaries<signed char>();
+  test_vectorized_boundaries<unsigned char>();
+  test_vectorized_boundaries<short>();
+  test_vectorized_boundaries<unsigned short>();
 #if TEST_STD_VER >= 20
   static_assert(test());
 #endif
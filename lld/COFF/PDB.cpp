@@ -55,6 +55,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FormatAdapters.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -102,7 +103,7 @@ public:
   /// Link info for each import file in the symbol table into the PDB.
   void addImportFilesToPDB();
 
-  void createModuleDBI(ObjFile *file);
+  void createModuleDBI(ObjFile *file, StringRef objName);
 
   /// Link CodeView from a single object file into the target (output) PDB.
   /// When a precompiled headers object is linked, its TPI map might be provided
@@ -1069,16 +1070,13 @@ void PDBLinker::addDebugSymbols(TpiSource *source) {
 // Add a module descriptor for every object file. We need to put an absolute
 // path to the object into the PDB. If this is a plain object, we make its
 // path absolute. If it's an object in an archive, we make the archive path
-// absolute.
-void PDBLinker::createModuleDBI(ObjFile *file) {
+// absolute. The caller computes the absolute path in 'objName'.
+void PDBLinker::createModuleDBI(ObjFile *file, StringRef objName) {
   pdb::DbiStreamBuilder &dbiBuilder = builder.getDbiBuilder();
-  SmallString<128> objName;
   ExitOnError exitOnErr;
 
   bool inArchive = !file->parentName.empty();
-  objName = inArchive ? file->parentName : file->getName();
-  pdbMakeAbsolute(objName);
-  StringRef modName = inArchive ? file->getName() : objName.str();
+  StringRef modName = inArchive ? file->getName() : objName;
 
   file->moduleDBI = &exitOnErr(dbiBuilder.addModuleInfo(modName));
   file->moduleDBI->setObjFileName(objName);
@@ -1153,9 +1151,17 @@ void PDBLinker::addObjectsToPDB() {
     llvm::TimeTraceScope timeScope("Add objects to PDB");
     ScopedTimer t1(ctx.addObjectsTimer);
 
-    // Create module descriptors
-    for (ObjFile *obj : ctx.objFileInstances)
-      createModuleDBI(obj);
+    // Create module descriptors. Making the object paths absolute may query
+    // the current directory, so do that in parallel up front and only add
+    // the modules themselves serially, which keeps module indices stable.
+    std::vector<SmallString<128>> objNames(ctx.objFileInstances.size());
+    parallelFor(0, objNames.size(), [&](size_t i) {
+      ObjFile *obj = ctx.objFileInstances[i];
+      objNames[i] = obj->parentName.empty() ? obj->getName() : obj->parentName;
+      pdbMakeAbsolute(objNames[i]);
+    });
+    for (size_t i = 0, e = objNames.size(); i != e; ++i)
+      createModuleDBI(ctx.objFileInstances[i], objNames[i]);
 
     // Reorder dependency type sources to come first.
     tMerger.sortDependencies();
@@ -0,0 +1,356 @@
+//===- BPSectionOrderer.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// This file orders input sections with Balanced Partitioning, see
+/// llvm/Support/BalancedPartitioning.h. There are two objectives.
+///
+/// Startup: functions that appear in temporal profile traces (collected with
+/// -pgo-temporal-instrumentation and read from --irpgo-profile) are placed so
+/// that functions executed close in time during startup are close in the
+/// output, which reduces the number of pages touched during startup. Each
+/// trace is split into exponentially growing prefixes, and every function
+/// gets a utility node for each prefix it is in.
+///
+/// Compression: sections that share many 4-byte windows of content are placed
+/// next to each other, which helps general-purpose compressors that work with
+/// a limited window size, e.g. for compressed APKs.
+///
+/// Startup functions come first, followed by the remaining functions and then
+/// data, each group ordered for compression if requested.
+///
+//===----------------------------------------------------------------------===//
+
+#include "BPSectionOrderer.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "OutputSections.h"
+#include "Symbols.h"
+#include "lld/Common/ErrorHandler.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ProfileData/InstrProfReader.h"
+#include "llvm/Support/BalancedPartitioning.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/VirtualFileSystem.h"
+
+using namespace llvm;
+using namespace lld;
+using namespace lld::elf;
+
+using UtilityNodes = SmallVector<BPFunctionNode::UtilityNodeT>;
+
+// Strip the suffixes that are appended to local and promoted symbols so that
+// they match the function names in the profile.
+static StringRef getRootSymbol(StringRef name) {
+  auto [p0, s0] = name.rsplit(".llvm.");
+  auto [p1, s1] = p0.rsplit(".__uniq.");
+  return p1;
+}
+
+static bool isCodeSection(const InputSectionBase *sec) {
+  return sec->flags & ELF::SHF_EXECINSTR;
+}
+
+// Compute utility nodes for sections to be ordered for compression. Sections
+// with identical hashes are likely identical, and only the first one of them
+// is ordered directly. The others are recorded in duplicateSectionIdxs and
+// placed right after it.
+static SmallVector<std::pair<unsigned, UtilityNodes>> getUnsForCompression(
+    ArrayRef<const InputSectionBase *> sections, ArrayRef<unsigned> sectionIdxs,
+    DenseMap<unsigned, SmallVector<unsigned>> *duplicateSectionIdxs,
+    BPFunctionNode::UtilityNodeT &maxUN) {
+  TimeTraceScope timeScope("Build nodes for compression");
+
+  // Hash every 4-byte window and the last three bytes.
+  SmallVector<std::pair<unsigned, SmallVector<uint64_t>>> sectionHashes;
+  sectionHashes.reserve(sectionIdxs.size());
+  SmallVector<uint64_t> hashes;
+  for (unsigned sectionIdx : sectionIdxs) {
+    constexpr unsigned windowSize = 4;
+    ArrayRef<uint8_t> data = sections[sectionIdx]->content();
+    if (data.size() >= windowSize)
+      for (size_t i = 0; i <= data.size() - windowSize; ++i)
+        hashes.push_back(support::endian::read32le(data.data() + i));
+    for (uint8_t byte : data.take_back(windowSize - 1))
+      hashes.push_back(byte);
+
+    llvm::sort(hashes);
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    sectionHashes.emplace_back(sectionIdx, hashes);
+    hashes.clear();
+  }
+
+  DenseMap<uint64_t, unsigned> hashFrequency;
+  for (auto &[sectionIdx, hashes] : sectionHashes)
+    for (uint64_t hash : hashes)
+      ++hashFrequency[hash];
+
+  if (duplicateSectionIdxs) {
+    // Merge sections that are nearly identical.
+    SmallVector<std::pair<unsigned, SmallVector<uint64_t>>> newSectionHashes;
+    DenseMap<uint64_t, unsigned> wholeHashToSectionIdx;
+    for (auto &[sectionIdx, hashes] : sectionHashes) {
+      uint64_t wholeHash = 0;
+      for (uint64_t hash : hashes)
+        if (hashFrequency[hash] > 5)
+          wholeHash ^= hash;
+      auto [it, wasInserted] =
+          wholeHashToSectionIdx.insert(std::make_pair(wholeHash, sectionIdx));
+      if (wasInserted)
+        newSectionHashes.emplace_back(sectionIdx, hashes);
+      else
+        (*duplicateSectionIdxs)[it->second].push_back(sectionIdx);
+    }
+    sectionHashes = newSectionHashes;
+
+    // Recompute hash frequencies.
+    hashFrequency.clear();
+    for (auto &[sectionIdx, hashes] : sectionHashes)
+      for (uint64_t hash : hashes)
+        ++hashFrequency[hash];
+  }
+
+  // Filter rare and common hashes and assign each a unique utility node that
+  // doesn't conflict with the trace utility nodes.
+  DenseMap<uint64_t, BPFunctionNode::UtilityNodeT> hashToUN;
+  for (auto &[hash, frequency] : hashFrequency) {
+    if (frequency <= 1 || frequency * 2 > sectionHashes.size())
+      continue;
+    hashToUN[hash] = ++maxUN;
+  }
+
+  SmallVector<std::pair<unsigned, UtilityNodes>> sectionUns;
+  for (auto &[sectionIdx, hashes] : sectionHashes) {
+    UtilityNodes uns;
+    for (uint64_t hash : hashes) {
+      auto it = hashToUN.find(hash);
+      if (it != hashToUN.end())
+        uns.push_back(it->second);
+    }
+    sectionUns.emplace_back(sectionIdx, uns);
+  }
+  return sectionUns;
+}
+
+DenseMap<const InputSectionBase *, int> elf::runBalancedPartitioning(
+    StringRef profilePath, bool forFunctionCompression,
+    bool forDataCompression, bool compressionSortStartupFunctions,
+    bool verbose) {
+  // Collect live, non-empty sections that are part of the image, and map the
+  // root names of their symbols to them.
+  SmallVector<const InputSectionBase *, 0> sections;
+  DenseMap<const InputSectionBase *, unsigned> sectionToIdx;
+  StringMap<DenseSet<unsigned>> rootSymbolToSectionIdxs;
+  for (ELFFileBase *file : ctx.objectFiles) {
+    for (InputSectionBase *sec : file->getSections()) {
+      auto *isec = dyn_cast_or_null<InputSection>(sec);
+      if (!isec || isec->content().empty() || !isec->isLive() ||
+          isec->repl != isec || !isec->getParent() ||
+          !(isec->getParent()->flags & ELF::SHF_ALLOC))
+        continue;
+      sectionToIdx.try_emplace(isec, sections.size());
+      sections.push_back(isec);
+    }
+    for (Symbol *sym : file->getSymbols()) {
+      auto *d = dyn_cast<Defined>(sym);
+      if (!d || d->file != file || d->isSection())
+        continue;
+      auto *sec = dyn_cast_or_null<InputSectionBase>(d->section);
+      auto it = sectionToIdx.find(sec);
+      if (it != sectionToIdx.end())
+        rootSymbolToSectionIdxs[getRootSymbol(sym->getName())].insert(
+            it->second);
+    }
+  }
+
+  BPFunctionNode::UtilityNodeT maxUN = 0;
+  DenseMap<unsigned, UtilityNodes> startupSectionIdxUNs;
+  // Used to define the initial order for startup functions.
+  DenseMap<unsigned, size_t> sectionIdxToTimestamp;
+  std::unique_ptr<InstrProfReader> reader;
+  if (!profilePath.empty()) {
+    auto fs = vfs::getRealFileSystem();
+    auto readerOrErr = InstrProfReader::create(profilePath, *fs);
+    checkError(readerOrErr.takeError());
+    reader = std::move(readerOrErr.get());
+    // Read all entries so that the symbol table is populated.
+    for (auto &entry : *reader)
+      (void)entry;
+    auto &traces = reader->getTemporalProfTraces();
+
+    DenseMap<unsigned, BPFunctionNode::UtilityNodeT> sectionIdxToFirstUN;
+    for (size_t traceIdx = 0; traceIdx < traces.size(); ++traceIdx) {
+      uint64_t currentSize = 0, cutoffSize = 1;
+      size_t cutoffTimestamp = 1;
+      auto &trace = traces[traceIdx].FunctionNameRefs;
+      for (size_t timestamp = 0; timestamp < trace.size(); ++timestamp) {
+        auto [filename, parsedFuncName] = getParsedIRPGOName(
+            reader->getSymtab().getFuncOrVarName(trace[timestamp]));
+        parsedFuncName = getRootSymbol(parsedFuncName);
+
+        auto sectionIdxsIt = rootSymbolToSectionIdxs.find(parsedFuncName);
+        if (sectionIdxsIt == rootSymbolToSectionIdxs.end())
+          continue;
+        auto &sectionIdxs = sectionIdxsIt->second;
+        // If the same symbol is found in multiple sections, they might be
+        // identical, so we arbitrarily use the size from the first section.
+        currentSize += sections[*sectionIdxs.begin()]->getSize();
+
+        // Since BalancedPartitioning is sensitive to the initial order, we
+        // need to explicitly define it to be ordered by earliest timestamp.
+        for (unsigned sectionIdx : sectionIdxs) {
+          auto [it, wasInserted] =
+              sectionIdxToTimestamp.try_emplace(sectionIdx, timestamp);
+          if (!wasInserted)
+            it->second = std::min<size_t>(it->second, timestamp);
+        }
+
+        if (timestamp >= cutoffTimestamp || currentSize >= cutoffSize) {
+          ++maxUN;
+          cutoffSize = 2 * currentSize;
+          cutoffTimestamp = 2 * cutoffTimestamp;
+        }
+        for (unsigned sectionIdx : sectionIdxs)
+          sectionIdxToFirstUN.try_emplace(sectionIdx, maxUN);
+      }
+      for (auto &[sectionIdx, firstUN] : sectionIdxToFirstUN)
+        for (auto un = firstUN; un <= maxUN; ++un)
+          startupSectionIdxUNs[sectionIdx].push_back(un);
+      ++maxUN;
+      sectionIdxToFirstUN.clear();
+    }
+  }
+
+  SmallVector<unsigned> sectionIdxsForFunctionCompression,
+      sectionIdxsForDataCompression;
+  for (unsigned sectionIdx = 0; sectionIdx < sections.size(); ++sectionIdx) {
+    if (startupSectionIdxUNs.count(sectionIdx))
+      continue;
+    if (isCodeSection(sections[sectionIdx])) {
+      if (forFunctionCompression)
+        sectionIdxsForFunctionCompression.push_back(sectionIdx);
+    } else {
+      if (forDataCompression)
+        sectionIdxsForDataCompression.push_back(sectionIdx);
+    }
+  }
+
+  if (compressionSortStartupFunctions) {
+    SmallVector<unsigned> startupIdxs;
+    for (auto &[sectionIdx, uns] : startupSectionIdxUNs)
+      startupIdxs.push_back(sectionIdx);
+    auto unsForStartupFunctionCompression =
+        getUnsForCompression(sections, startupIdxs,
+                             /*duplicateSectionIdxs=*/nullptr, maxUN);
+    for (auto &[sectionIdx, compressionUns] :
+         unsForStartupFunctionCompression) {
+      auto &uns = startupSectionIdxUNs[sectionIdx];
+      uns.append(compressionUns);
+      llvm::sort(uns);
+      uns.erase(std::unique(uns.begin(), uns.end()), uns.end());
+    }
+  }
+
+  // Map a section index (ordered directly) to a list of duplicate section
+  // indices (not ordered directly).
+  DenseMap<unsigned, SmallVector<unsigned>> duplicateSectionIdxs;
+  auto unsForFunctionCompression =
+      getUnsForCompression(sections, sectionIdxsForFunctionCompression,
+                           &duplicateSectionIdxs, maxUN);
+  auto unsForDataCompression =
+      getUnsForCompression(sections, sectionIdxsForDataCompression,
+                           &duplicateSectionIdxs, maxUN);
+
+  std::vector<BPFunctionNode> nodesForStartup, nodesForFunctionCompression,
+      nodesForDataCompression;
+  for (auto &[sectionIdx, uns] : startupSectionIdxUNs)
+    nodesForStartup.emplace_back(sectionIdx, uns);
+  for (auto &[sectionIdx, uns] : unsForFunctionCompression)
+    nodesForFunctionCompression.emplace_back(sectionIdx, uns);
+  for (auto &[sectionIdx, uns] : unsForDataCompression)
+    nodesForDataCompression.emplace_back(sectionIdx, uns);
+
+  // Use the first timestamp to define the initial order for startup nodes.
+  llvm::sort(nodesForStartup, [&](auto &l, auto &r) {
+    return std::make_pair(sectionIdxToTimestamp[l.Id], l.Id) <
+           std::make_pair(sectionIdxToTimestamp[r.Id], r.Id);
+  });
+  // Sort compression nodes by their Id (which is the section index) because
+  // the input linker order tends to be not bad.
+  llvm::sort(nodesForFunctionCompression,
+             [](auto &l, auto &r) { return l.Id < r.Id; });
+  llvm::sort(nodesForDataCompression,
+             [](auto &l, auto &r) { return l.Id < r.Id; });
+
+  {
+    TimeTraceScope timeScope("Balanced Partitioning");
+    BalancedPartitioningConfig config;
+    BalancedPartitioning bp(config);
+    bp.run(nodesForStartup);
+    bp.run(nodesForFunctionCompression);
+    bp.run(nodesForDataCompression);
+  }
+
+  unsigned numStartupSections = 0;
+  unsigned numCodeCompressionSections = 0;
+  unsigned numDuplicateCodeSections = 0;
+  unsigned numDataCompressionSections = 0;
+  unsigned numDuplicateDataSections = 0;
+  SetVector<const InputSectionBase *> orderedSections;
+  // Order startup functions,
+  for (auto &node : nodesForStartup)
+    if (orderedSections.insert(sections[node.Id]))
+      ++numStartupSections;
+  // then functions for compression,
+  for (auto &node : nodesForFunctionCompression) {
+    if (orderedSections.insert(sections[node.Id]))
+      ++numCodeCompressionSections;
+    auto it = duplicateSectionIdxs.find(node.Id);
+    if (it == duplicateSectionIdxs.end())
+      continue;
+    for (unsigned dupSecIdx : it->second)
+      if (orderedSections.insert(sections[dupSecIdx]))
+        ++numDuplicateCodeSections;
+  }
+  // then data for compression.
+  for (auto &node : nodesForDataCompression) {
+    if (orderedSections.insert(sections[node.Id]))
+      ++numDataCompressionSections;
+    auto it = duplicateSectionIdxs.find(node.Id);
+    if (it == duplicateSectionIdxs.end())
+      continue;
+    for (unsigned dupSecIdx : it->second)
+      if (orderedSections.insert(sections[dupSecIdx]))
+        ++numDuplicateDataSections;
+  }
+
+  if (verbose) {
+    unsigned numTotalOrderedSections =
+        numStartupSections + numCodeCompressionSections +
+        numDuplicateCodeSections + numDataCompressionSections +
+        numDuplicateDataSections;
+    message("Ordered " + Twine(numTotalOrderedSections) +
+            " sections using balanced partitioning:\n"
+            "  Functions for startup: " + Twine(numStartupSections) + "\n"
+            "  Functions for compression: " +
+            Twine(numCodeCompressionSections) + "\n"
+            "  Duplicate functions: " + Twine(numDuplicateCodeSections) + "\n"
+            "  Data for compression: " + Twine(numDataCompressionSections) +
+            "\n"
+            "  Duplicate data: " + Twine(numDuplicateDataSections));
+  }
+
+  // Ordered sections get negative priorities, like sections listed in
+  // --symbol-ordering-file.
+  DenseMap<const InputSectionBase *, int> sectionPriorities;
+  int prio = -orderedSections.size();
+  for (const InputSectionBase *sec : orderedSections)
+    sectionPriorities[sec] = prio++;
+  return sectionPriorities;
+}
@@ -165,6 +165,7 @@ struct Config {
   llvm::StringRef entry;
   llvm::StringRef emulation;
   llvm::StringRef fini;
+  llvm::StringRef incrementalCacheDir;
   llvm::StringRef init;
   llvm::StringRef ltoAAPipeline;
   llvm::StringRef ltoCSProfileFile;
@@ -184,6 +185,7 @@ struct Config {
   llvm::StringRef soName;
   llvm::StringRef sysroot;
   llvm::StringRef thinLTOCacheDir;
+  llvm::StringRef thinLTODistributor;
   llvm::StringRef thinLTOIndexOnlyArg;
   llvm::StringRef whyExtract;
   llvm::StringRef cmseInputLib;
@@ -205,6 +207,7 @@ struct Config {
   llvm::SmallVector<llvm::StringRef, 0> passPlugins;
   llvm::SmallVector<llvm::StringRef, 0> searchPaths;
   llvm::SmallVector<llvm::StringRef, 0> symbolOrderingFile;
+  llvm::SmallVector<llvm::StringRef, 0> thinLTODistributorArgs;
   llvm::SmallVector<llvm::StringRef, 0> thinLTOModulesToCompile;
   llvm::SmallVector<llvm::StringRef, 0> undefined;
   llvm::SmallVector<SymbolVersion, 0> dynamicList;
@@ -226,6 +229,12 @@ struct Config {
   bool armBe8 = false;
   BsymbolicKind bsymbolic = BsymbolicKind::None;
   CGProfileSortKind callGraphProfileSort;
+  llvm::StringRef irpgoProfilePath;
+  bool bpStartupFunctionSort = false;
+  bool bpCompressionSortStartupFunctions = false;
+  bool bpFunctionOrderForCompression = false;
+  bool bpDataOrderForCompression = false;
+  bool bpVerboseSectionOrderer = false;
   bool checkSections;
   bool checkDynamicRelocs;
   std::optional<llvm::DebugCompressionType> compressDebugSections;
@@ -257,8 +266,12 @@ struct Config {
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
   bool ignoreFunctionAddressEquality;
+  bool lazyArchiveIndex;
+  bool ltoCachePartitions;
+  bool ltoCostBalancedPartitions;
   bool ltoCSProfileGenerate;
   bool ltoPGOWarnMismatch;
+  bool ltoStreamLinking;
   bool ltoDebugPassManager;
   bool ltoEmitAsm;
   bool ltoUniqueBasicBlockSectionNames;
@@ -298,6 +311,7 @@ struct Config {
   bool sysvHash = false;
   bool target1Rel;
   bool trace;
+  bool thinLTOCacheKeyBodyHashes;
   bool thinLTOEmitImportsFiles;
   bool thinLTOEmitIndexFiles;
   bool thinLTOIndexOnly;
@@ -319,6 +333,7 @@ struct Config {
   bool zForceIbt;
   bool zGlobal;
   bool zHazardplt;
+  bool zHugepageHotText;
   bool zIfuncNoplt;
   bool zInitfirst;
   bool zInterpose;
@@ -358,6 +373,7 @@ struct Config {
   uint64_t commonPageSize;
   uint64_t maxPageSize;
   uint64_t mipsGotSize;
+  uint64_t thinLTOMemoryBudget;
   uint64_t zStackSize;
   unsigned ltoPartitions;
   unsigned ltoo;
@@ -244,6 +244,32 @@ std::vector<std::pair<MemoryBufferRef, uint64_t>> static getArchiveMembers(
   return v;
 }
 
+// Returns the names in the archive symbol table grouped by the offset of the
+// member defining them. Returns an empty map if the archive has no symbol
+// table or if it cannot be read, in which case callers fall back to scanning
+// the members' own symbol tables.
+static DenseMap<uint64_t, SmallVector<StringRef, 0>>
+getArchiveSymbols(MemoryBufferRef mb) {
+  DenseMap<uint64_t, SmallVector<StringRef, 0>> ret;
+  Expected<std::unique_ptr<Archive>> fileOrErr = Archive::create(mb);
+  if (!fileOrErr) {
+    consumeError(fileOrErr.takeError());
+    return ret;
+  }
+  std::unique_ptr<Archive> file = std::move(*fileOrErr);
+  if (!file->hasSymbolTable())
+    return ret;
+  for (const Archive::Symbol &sym : file->symbols()) {
+    Expected<Archive::Child> c = sym.getMember();
+    if (!c) {
+      consumeError(c.takeError());
+      return {};
+    }
+    ret[c->getChildOffset()].push_back(sym.getName());
+  }
+  return ret;
+}
+
 static bool isBitcode(MemoryBufferRef mb) {
   return identify_magic(mb.getBuffer()) == llvm::file_magic::bitcode;
 }
@@ -305,11 +331,23 @@ void LinkerDriver::addFile(StringRef path, bool withLOption) {
     //
     // All files within the archive get the same group ID to allow mutual
     // references for --warn-backrefs.
+    //
+    // With --lazy-archive-index, the names of ELF relocatable members are taken
+    // from the archive symbol table instead. Such members are not parsed until
+    // they are extracted, and members without index entries are not added at
+    // all.
+    DenseMap<uint64_t, SmallVector<StringRef, 0>> index;
+    if (config->lazyArchiveIndex && !config->fatLTOObjects)
+      index = getArchiveSymbols(mbref);
     bool saved = InputFile::isInGroup;
     InputFile::isInGroup = true;
     for (const std::pair<MemoryBufferRef, uint64_t> &p : members) {
       auto magic = identify_magic(p.first.getBuffer());
-      if (magic == file_magic::elf_relocatable) {
+      if (magic == file_magic::elf_relocatable && !index.empty()) {
+        auto it = index.find(p.second);
+        if (it != index.end())
+          files.push_back(createObjFile(p.first, path, true, it->second));
+      } else if (magic == file_magic::elf_relocatable) {
         if (!tryAddFatLTOFile(p.first, path, p.second, true))
           files.push_back(createObjFile(p.first, path, true));
       } else if (magic == file_magic::bitcode)
@@ -444,6 +482,8 @@ static void checkOptions() {
       error("-r and --export-dynamic may not be used together");
     if (config->debugNames)
       error("-r and --debug-names may not be used together");
+    if (!config->incrementalCacheDir.empty())
+      error("-r and --incremental-cache may not be used together");
   }
 
   if (config->executeOnly) {
@@ -1249,6 +1289,34 @@ static void readConfigs(opt::InputArgList &args) {
       config->bsymbolic = BsymbolicKind::All;
   }
   config->callGraphProfileSort = getCGProfileSortKind(args);
+  config->irpgoProfilePath = args.getLastArgValue(OPT_irpgo_profile);
+  config->bpCompressionSortStartupFunctions =
+      args.hasFlag(OPT_bp_compression_sort_startup_functions,
+                   OPT_no_bp_compression_sort_startup_functions, false);
+  if (auto *arg = args.getLastArg(OPT_bp_startup_sort)) {
+    StringRef s = arg->getValue();
+    if (s == "function")
+      config->bpStartupFunctionSort = true;
+    else if (s != "none")
+      error("unknown --bp-startup-sort= value: " + s);
+  }
+  if (auto *arg = args.getLastArg(OPT_bp_compression_sort)) {
+    StringRef s = arg->getValue();
+    if (s == "function" || s == "both")
+      config->bpFunctionOrderForCompression = true;
+    if (s == "data" || s == "both")
+      config->bpDataOrderForCompression = true;
+    if (s != "none" && s != "function" && s != "data" && s != "both")
+      error("unknown --bp-compression-sort= value: " + s);
+  }
+  config->bpVerboseSectionOrderer = args.hasArg(OPT_verbose_bp_section_orderer);
+  if (config->irpgoProfilePath.empty()) {
+    if (config->bpStartupFunctionSort)
+      error("--bp-startup-sort=function must be used with --irpgo-profile");
+    if (config->bpCompressionSortStartupFunctions)
+      error("--bp-compression-sort-startup-functions must be used with "
+            "--irpgo-profile");
+  }
   config->checkSections =
       args.hasFlag(OPT_check_sections, OPT_no_check_sections, true);
   config->chroot = args.getLastArgValue(OPT_chroot);
@@ -1298,6 +1366,7 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasFlag(OPT_fortran_common, OPT_no_fortran_common, false);
   config->gcSections = args.hasFlag(OPT_gc_sections, OPT_no_gc_sections, false);
   config->gnuUnique = args.hasFlag(OPT_gnu_unique, OPT_no_gnu_unique, true);
+  config->incrementalCacheDir = args.getLastArgValue(OPT_incremental_cache);
   config->gdbIndex = args.hasFlag(OPT_gdb_index, OPT_no_gdb_index, false);
   config->icf = getICF(args);
   config->ignoreDataAddressEquality =
@@ -1310,6 +1379,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->ltoCSProfileFile = args.getLastArgValue(OPT_lto_cs_profile_file);
   config->ltoPGOWarnMismatch = args.hasFlag(OPT_lto_pgo_warn_mismatch,
                                             OPT_no_lto_pgo_warn_mismatch, true);
+  config->lazyArchiveIndex = args.hasFlag(
+      OPT_lazy_archive_index, OPT_no_lazy_archive_index, false);
   config->ltoDebugPassManager = args.hasArg(OPT_lto_debug_pass_manager);
   config->ltoEmitAsm = args.hasArg(OPT_lto_emit_asm);
   config->ltoNewPmPasses = args.getLastArgValue(OPT_lto_newpm_passes);
@@ -1330,7 +1401,11 @@ static void readConfigs(opt::InputArgList &args) {
     error("invalid codegen optimization level for LTO: " + Twine(ltoCgo));
   config->ltoObjPath = args.getLastArgValue(OPT_lto_obj_path_eq);
   config->ltoPartitions = args::getInteger(args, OPT_lto_partitions, 1);
+  config->ltoCachePartitions = args.hasArg(OPT_lto_cache_partitions);
+  config->ltoCostBalancedPartitions =
+      args.hasArg(OPT_lto_cost_balanced_partitions);
   config->ltoSampleProfile = args.getLastArgValue(OPT_lto_sample_profile);
+  config->ltoStreamLinking = args.hasArg(OPT_lto_stream_linking);
   config->ltoBBAddrMap =
       args.hasFlag(OPT_lto_basic_block_address_map,
                    OPT_no_lto_basic_block_address_map, false);
@@ -1416,6 +1491,11 @@ static void readConfigs(opt::InputArgList &args) {
   config->thinLTOCachePolicy = CHECK(
       parseCachePruningPolicy(args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
+  config->thinLTOCacheKeyBodyHashes =
+      args.hasArg(OPT_thinlto_cache_key_body_hashes);
+  config->thinLTODistributor = args.getLastArgValue(OPT_thinlto_distributor_eq);
+  for (auto *arg : args.filtered(OPT_thinlto_distributor_arg_eq))
+    config->thinLTODistributorArgs.push_back(arg->getValue());
   config->thinLTOEmitImportsFiles = args.hasArg(OPT_thinlto_emit_imports_files);
   config->thinLTOEmitIndexFiles = args.hasArg(OPT_thinlto_emit_index_files) ||
                                   args.hasArg(OPT_thinlto_index_only) ||
@@ -1423,6 +1503,11 @@ static void readConfigs(opt::InputArgList &args) {
   config->thinLTOIndexOnly = args.hasArg(OPT_thinlto_index_only) ||
                              args.hasArg(OPT_thinlto_index_only_eq);
   config->thinLTOIndexOnlyArg = args.getLastArgValue(OPT_thinlto_index_only_eq);
+  if (int64_t budget = args::getInteger(args, OPT_thinlto_memory_budget_eq, 0);
+      budget >= 0)
+    config->thinLTOMemoryBudget = uint64_t(budget) << 20;
+  else
+    error("--thinlto-memory-budget=: expected a non-negative integer");
   config->thinLTOObjectSuffixReplace =
       getOldNewOptions(args, OPT_thinlto_object_suffix_replace_eq);
   std::tie(config->thinLTOPrefixReplaceOld, config->thinLTOPrefixReplaceNew,
@@ -1436,6 +1521,8 @@ static void readConfigs(opt::InputArgList &args) {
       error("--thinlto-prefix-replace is not supported with "
             "--thinlto-emit-index-files");
   }
+  if (!config->thinLTODistributor.empty() && config->thinLTOIndexOnly)
+    error("--thinlto-distributor= may not be used with --thinlto-index-only");
   if (!config->thinLTOPrefixReplaceNativeObject.empty() &&
       config->thinLTOIndexOnlyArg.empty()) {
     error("--thinlto-prefix-replace=old_dir;new_dir;obj_dir must be used with "
@@ -1468,6 +1555,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->zGnustack = getZGnuStack(args);
   config->zHazardplt = hasZOption(args, "hazardplt");
   config->zIfuncNoplt = hasZOption(args, "ifunc-noplt");
+  config->zHugepageHotText =
+      getZFlag(args, "hugepage-hot-text", "nohugepage-hot-text", false);
   config->zInitfirst = hasZOption(args, "initfirst");
   config->zInterpose = hasZOption(args, "interpose");
   config->zKeepTextSectionPrefix = getZFlag(
@@ -1725,6 +1814,10 @@ static void readConfigs(opt::InputArgList &args) {
     if (args.hasArg(OPT_call_graph_ordering_file))
       error("--symbol-ordering-file and --call-graph-order-file "
             "may not be used together");
+    if (config->bpStartupFunctionSort ||
+        config->bpFunctionOrderForCompression ||
+        config->bpDataOrderForCompression)
+      error("--symbol-ordering-file and --bp-*-sort may not be used together");
     if (std::optional<MemoryBufferRef> buffer = readFile(arg->getValue())) {
       config->symbolOrderingFile = getSymbolOrderingFile(*buffer);
       // Also need to disable CallGraphProfileSort to prevent
@@ -3132,6 +3225,16 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
         osd->osec.finalizeInputSections(&script.s);
   }
 
+  // The --incremental-cache directory is populated by ICF and the writer. The
+  // cache only speeds up later links, so link without it if it is unusable.
+  if (!config->incrementalCacheDir.empty())
+    if (std::error_code ec =
+            sys::fs::create_directories(config->incrementalCacheDir)) {
+      warn("cannot create incremental cache directory " +
+           config->incrementalCacheDir + ": " + ec.message());
+      config->incrementalCacheDir = "";
+    }
+
   // Two input sections with different output sections should not be folded.
   // ICF runs after processSectionCommands() so that we know the output sections.
   if (config->icf != ICFLevel::None) {
@@ -66,6 +66,18 @@
 // 2.8 GHz 40 core machine. Even without threading, LLD's ICF is still
 // faster than MSVC or gold though.
 //
+// With --incremental-cache, we save a summary of the result: for each
+// section, a signature covering everything compared by equalsConstant plus
+// the identities of relocation targets, along with the signature of the
+// section its class was folded into. On the next link, a section is "clean"
+// if its signature is in the summary and every section it transitively
+// refers to is clean. Whether two clean sections are identical depends only
+// on sections that did not change, so the previous result still holds, and
+// we use it to split the initial hash classes. Classes containing a changed
+// section are left as is. The refinement below then starts close to the
+// fixed point and converges in a couple of iterations. Because we only split
+// sections that are known to differ, the result is the same as from scratch.
+//
 // [1] Safe ICF: Pointer Safe and Unwinding aware Identical Code Folding
 // in the Gold Linker
 // http://static.googleusercontent.com/media/research.google.com/en//pubs/archive/36912.pdf
@@ -82,6 +94,8 @@
 #include "SyntheticSections.h"
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/ELF.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/xxhash.h"
@@ -91,6 +105,7 @@
 using namespace llvm;
 using namespace llvm::ELF;
 using namespace llvm::object;
+using namespace llvm::support::endian;
 using namespace lld;
 using namespace lld::elf;
 
@@ -120,8 +135,25 @@ private:
 
   void forEachClass(llvm::function_ref<void(size_t, size_t)> fn);
 
+  template <class RelTy>
+  uint64_t getSignature(const InputSection *s, ArrayRef<RelTy> rels,
+                        SmallVectorImpl<uint32_t> &targets);
+
+  void loadSummary();
+  void seedFromSummary();
+  void saveSummary();
+
   SmallVector<InputSection *, 0> sections;
 
+  // The following members are only used with --incremental-cache. They are
+  // indexed by the position of a section in `sections` before sorting.
+  DenseMap<const InputSection *, uint32_t> sectionIndex;
+  SmallVector<uint64_t, 0> signatures;
+
+  // The signature of the class leader from the previous link, or 0 if the
+  // section or a section it refers to has changed.
+  SmallVector<uint64_t, 0> prevClass;
+
   // We repeat the main loop while `Repeat` is true.
   std::atomic<bool> repeat;
 
@@ -453,6 +485,201 @@ static void combineRelocHashes(unsigned cnt, InputSection *isec,
   isec->eqClass[(cnt + 1) % 2] = hash | (1U << 31);
 }
 
+// Appends a description of sec that is stable across links. It does not cover
+// the contents of sec, only where it came from.
+static void addSectionId(SmallVectorImpl<uint64_t> &buf,
+                         const SectionBase *sec) {
+  buf.push_back(xxh3_64bits(sec->name));
+  auto *isec = dyn_cast<InputSectionBase>(sec);
+  if (!isec || !isec->file)
+    return;
+  const InputFile *file = isec->file;
+  buf.push_back(xxh3_64bits(file->mb.getBufferIdentifier()));
+  buf.push_back(xxh3_64bits(file->archiveName));
+  auto *start = reinterpret_cast<const uint8_t *>(file->mb.getBufferStart());
+  auto *end = start + file->mb.getBufferSize();
+  if (isec->content_ >= start && isec->content_ < end)
+    buf.push_back(isec->content_ - start);
+}
+
+// Returns a hash of everything that equalsConstant compares, and of the
+// identities of the sections that the relocations refer to. Indices of the
+// referenced sections that are subject to ICF are added to `targets`.
+template <class ELFT>
+template <class RelTy>
+uint64_t ICF<ELFT>::getSignature(const InputSection *s, ArrayRef<RelTy> rels,
+                                 SmallVectorImpl<uint32_t> &targets) {
+  SmallVector<uint64_t, 0> buf = {s->flags, s->getSize(),
+                                  xxh3_64bits(s->content()),
+                                  xxh3_64bits(s->getParent()->name),
+                                  rels.size()};
+  for (const RelTy &rel : rels) {
+    uint64_t addend = getAddend<ELFT>(rel);
+    buf.push_back(rel.r_offset);
+    buf.push_back(rel.getType(config->isMips64EL));
+    buf.push_back(addend);
+
+    // Relocations referring to such symbols are only equal if the symbols are
+    // the same.
+    Symbol &sym = s->file->getRelocTargetSym(rel);
+    auto *d = dyn_cast<Defined>(&sym);
+    if (!d || d->scriptDefined || d->isPreemptible) {
+      buf.push_back(0);
+      buf.push_back(xxh3_64bits(sym.getName()));
+      continue;
+    }
+    if (!d->section) {
+      buf.push_back(1);
+      buf.push_back(d->value);
+      continue;
+    }
+
+    buf.push_back(2 + d->section->kind());
+    if (auto *ms = dyn_cast<MergeInputSection>(d->section)) {
+      addSectionId(buf, ms->getParent());
+      buf.push_back(sym.isSection() ? ms->getOffset(addend)
+                                    : ms->getOffset(d->value) + addend);
+      continue;
+    }
+    addSectionId(buf, d->section);
+    buf.push_back(d->value);
+    if (auto *isec = dyn_cast<InputSection>(d->section)) {
+      auto it = sectionIndex.find(isec);
+      buf.push_back(it != sectionIndex.end());
+      if (it != sectionIndex.end())
+        targets.push_back(it->second);
+    }
+  }
+  return xxh3_64bits(ArrayRef(reinterpret_cast<const uint8_t *>(buf.data()),
+                              buf.size() * sizeof(uint64_t)));
+}
+
+// The summary consists of a header followed by (signature, class) pairs
+// sorted by signature.
+static constexpr uint64_t icfSummaryVersion = 1;
+
+static std::string getSummaryKey() {
+  StringRef output = config->outputFile;
+  return getIncrementalCacheKey(
+      "icf-", ArrayRef(output.bytes_begin(), output.bytes_end()));
+}
+
+static uint64_t getSummaryHeader() {
+  return icfSummaryVersion | uint64_t(config->emachine) << 8 |
+         uint64_t(config->is64) << 24 | uint64_t(config->isLE) << 25;
+}
+
+// Computes the signatures of the sections and finds the sections whose class
+// from the previous link is still valid.
+template <class ELFT> void ICF<ELFT>::loadSummary() {
+  llvm::TimeTraceScope timeScope("Load ICF summary");
+  for (size_t i = 0, e = sections.size(); i != e; ++i)
+    sectionIndex[sections[i]] = i;
+
+  signatures.resize(sections.size());
+  auto targets =
+      std::make_unique<SmallVector<uint32_t, 0>[]>(sections.size());
+  parallelFor(0, sections.size(), [&](size_t i) {
+    const RelsOrRelas<ELFT> rels = sections[i]->template relsOrRelas<ELFT>();
+    signatures[i] = rels.areRelocsRel()
+                        ? getSignature(sections[i], rels.rels, targets[i])
+                        : getSignature(sections[i], rels.relas, targets[i]);
+  });
+
+  std::unique_ptr<MemoryBuffer> mb = readIncrementalCacheEntry(getSummaryKey());
+  if (!mb || mb->getBufferSize() % 16 != 8 ||
+      read64le(mb->getBufferStart()) != getSummaryHeader())
+    return;
+  const char *entries = mb->getBufferStart() + 8;
+  size_t numEntries = mb->getBufferSize() / 16;
+  prevClass.assign(sections.size(), 0);
+  parallelFor(0, sections.size(), [&](size_t i) {
+    size_t lo = 0, hi = numEntries;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (read64le(entries + mid * 16) < signatures[i])
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo < numEntries && read64le(entries + lo * 16) == signatures[i])
+      prevClass[i] = read64le(entries + lo * 16 + 8);
+  });
+
+  // A section referring to a changed section is considered changed as well.
+  // Visit the referrers of changed sections until no more are found.
+  auto referrers =
+      std::make_unique<SmallVector<uint32_t, 0>[]>(sections.size());
+  SmallVector<uint32_t, 0> worklist;
+  for (size_t i = 0, e = sections.size(); i != e; ++i) {
+    for (uint32_t j : targets[i])
+      referrers[j].push_back(i);
+    if (!prevClass[i])
+      worklist.push_back(i);
+  }
+  while (!worklist.empty()) {
+    uint32_t i = worklist.pop_back_val();
+    for (uint32_t j : referrers[i]) {
+      if (prevClass[j]) {
+        prevClass[j] = 0;
+        worklist.push_back(j);
+      }
+    }
+  }
+
+  size_t numClean = llvm::count_if(prevClass, [](uint64_t c) { return c; });
+  log("ICF summary: reused classes of " + Twine(numClean) + " of " +
+      Twine(sections.size()) + " sections");
+}
+
+// Splits the initial classes by the classes from the previous link. This is
+// done for classes whose members are all clean. Clean sections that were
+// different in the previous link are still different, and folded sections are
+// kept together. Collisions of the new class IDs only make classes larger,
+// which the main loop will sort out.
+template <class ELFT> void ICF<ELFT>::seedFromSummary() {
+  forEachClassRange(0, sections.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      if (!prevClass[sectionIndex[sections[i]]])
+        return;
+    for (size_t i = begin; i < end; ++i) {
+      uint64_t words[] = {sections[i]->eqClass[0],
+                          prevClass[sectionIndex[sections[i]]]};
+      sections[i]->eqClass[0] =
+          xxh3_64bits(ArrayRef(reinterpret_cast<const uint8_t *>(words),
+                               sizeof(words))) |
+          (1U << 31);
+    }
+  });
+  llvm::stable_sort(sections, [](const InputSection *a, const InputSection *b) {
+    return a->eqClass[0] < b->eqClass[0];
+  });
+}
+
+// Saves the signature of each section and of the leader of its class.
+template <class ELFT> void ICF<ELFT>::saveSummary() {
+  SmallVector<std::pair<uint64_t, uint64_t>, 0> entries;
+  entries.reserve(sections.size());
+  forEachClassRange(0, sections.size(), [&](size_t begin, size_t end) {
+    uint64_t leader = signatures[sectionIndex[sections[begin]]];
+    for (size_t i = begin; i < end; ++i)
+      entries.emplace_back(signatures[sectionIndex[sections[i]]], leader);
+  });
+  llvm::sort(entries);
+  entries.erase(
+      std::unique(entries.begin(), entries.end(),
+                  [](auto &a, auto &b) { return a.first == b.first; }),
+      entries.end());
+
+  SmallVector<uint8_t, 0> buf(8 + entries.size() * 16);
+  write64le(buf.data(), getSummaryHeader());
+  for (size_t i = 0, e = entries.size(); i != e; ++i) {
+    write64le(buf.data() + 8 + i * 16, entries[i].first);
+    write64le(buf.data() + 16 + i * 16, entries[i].second);
+  }
+  writeIncrementalCacheEntry(getSummaryKey(), buf);
+}
+
 static void print(const Twine &s) {
   if (config->printIcfSections)
     message(s);
@@ -493,6 +720,9 @@ template <class ELFT> void ICF<ELFT>::run() {
     }
   }
 
+  if (!config->incrementalCacheDir.empty())
+    loadSummary();
+
   // Initially, we use hash values to partition sections.
   parallelForEach(sections, [&](InputSection *s) {
     // Set MSB to 1 to avoid collisions with unique IDs.
@@ -518,6 +748,9 @@ template <class ELFT> void ICF<ELFT>::run() {
     return a->eqClass[0] < b->eqClass[0];
   });
 
+  if (!prevClass.empty())
+    seedFromSummary();
+
   // Compare static contents and assign unique equivalence class IDs for each
   // static content. Use a base offset for these IDs to ensure no overlap with
   // the unique IDs already assigned.
@@ -536,6 +769,9 @@ template <class ELFT> void ICF<ELFT>::run() {
 
   log("ICF needed " + Twine(cnt) + " iterations");
 
+  if (!config->incrementalCacheDir.empty())
+    saveSummary();
+
   // Merge sections by the equivalence class.
   forEachClassRange(0, sections.size(), [&](size_t begin, size_t end) {
     if (end - begin == 1)
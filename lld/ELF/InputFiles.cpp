@@ -26,6 +26,7 @@
 #include "llvm/Support/ARMBuildAttributes.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/RISCVAttributeParser.h"
 #include "llvm/Support/TarWriter.h"
@@ -345,6 +346,23 @@ extern template void ObjFile<ELF64BE>::importCmseSymbols();
 template <class ELFT>
 static void doParseFiles(const std::vector<InputFile *> &files,
                          InputFile *armCmseImpLib) {
+  // Looking up the symbol names of relocatable object files dominates parsing.
+  // If we have multiple threads, create the symbol table entries for those
+  // names up front in parallel.
+  if (parallel::strategy.ThreadsRequested != 1) {
+    llvm::TimeTraceScope timeScope("Reserve symbols");
+    std::vector<ObjFile<ELFT> *> objs;
+    for (InputFile *file : files)
+      if (file->kind() == InputFile::ObjKind && file->ekind == config->ekind &&
+          cast<ObjFile<ELFT>>(file)->archiveIndexSymbols.empty())
+        objs.push_back(cast<ObjFile<ELFT>>(file));
+    std::vector<SmallVector<std::pair<StringRef, Symbol **>, 0>> lists(
+        objs.size());
+    parallelFor(0, objs.size(),
+                [&](size_t i) { lists[i] = objs[i]->getSymbolsToInsert(); });
+    symtab.reserveSymbols(lists);
+  }
+
   // Add all files to the symbol table. This will add almost all symbols that we
   // need to the symbol table. This process might add files to the link due to
   // addDependentLibrary.
@@ -1132,10 +1150,15 @@ void ObjFile<ELFT>::initializeSymbols(const object::ELFFile<ELFT> &obj) {
     symbols = std::make_unique<Symbol *[]>(numSymbols);
   }
 
-  // Some entries have been filled by LazyObjFile.
-  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i)
+  // Some entries have been filled by LazyObjFile. Others may have been
+  // reserved by SymbolTable::reserveSymbols, which leaves the partition zero.
+  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
     if (!symbols[i])
       symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+    else if (symbols[i]->partition == 0)
+      symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this),
+                                 symbols[i]);
+  }
 
   // Perform symbol resolution on non-local symbols.
   SmallVector<unsigned, 32> undefineds;
@@ -1859,7 +1882,8 @@ InputFile *elf::createInternalFile(StringRef name) {
 }
 
 ELFFileBase *elf::createObjFile(MemoryBufferRef mb, StringRef archiveName,
-                                bool lazy) {
+                                bool lazy,
+                                ArrayRef<StringRef> archiveIndexSymbols) {
   ELFFileBase *f;
   switch (getELFKind(mb, archiveName)) {
   case ELF32LEKind:
@@ -1879,21 +1903,61 @@ ELFFileBase *elf::createObjFile(MemoryBufferRef mb, StringRef archiveName,
   }
   f->init();
   f->lazy = lazy;
+  f->archiveIndexSymbols.assign(archiveIndexSymbols.begin(),
+                                archiveIndexSymbols.end());
   return f;
 }
 
-template <class ELFT> void ObjFile<ELFT>::parseLazy() {
+template <class ELFT>
+SmallVector<std::pair<StringRef, Symbol **>, 0>
+ObjFile<ELFT>::getSymbolsToInsert() {
   const ArrayRef<typename ELFT::Sym> eSyms = this->getELFSyms<ELFT>();
   numSymbols = eSyms.size();
   symbols = std::make_unique<Symbol *[]>(numSymbols);
 
+  SmallVector<std::pair<StringRef, Symbol **>, 0> ret;
+  for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
+    if (lazy && eSyms[i].st_shndx == SHN_UNDEF)
+      continue;
+    // Invalid names are reported when the file is parsed.
+    Expected<StringRef> name = eSyms[i].getName(stringTable);
+    if (!name) {
+      consumeError(name.takeError());
+      continue;
+    }
+    ret.emplace_back(*name, &symbols[i]);
+  }
+  return ret;
+}
+
+template <class ELFT> void ObjFile<ELFT>::parseLazy() {
+  // The archive symbol table already lists the names this member defines.
+  // Insert them without allocating the symbol array, which parse() creates
+  // if the member is extracted.
+  if (!archiveIndexSymbols.empty()) {
+    for (StringRef name : archiveIndexSymbols) {
+      symtab.insert(name)->resolve(LazySymbol{*this});
+      if (!lazy)
+        break;
+    }
+    return;
+  }
+
+  const ArrayRef<typename ELFT::Sym> eSyms = this->getELFSyms<ELFT>();
+  if (numSymbols == 0) {
+    numSymbols = eSyms.size();
+    symbols = std::make_unique<Symbol *[]>(numSymbols);
+  }
+
   // resolve() may trigger this->extract() if an existing symbol is an undefined
   // symbol. If that happens, this function has served its purpose, and we can
   // exit from the loop early.
   for (size_t i = firstGlobal, end = eSyms.size(); i != end; ++i) {
     if (eSyms[i].st_shndx == SHN_UNDEF)
       continue;
-    symbols[i] = symtab.insert(CHECK(eSyms[i].getName(stringTable), this));
+    StringRef name = CHECK(eSyms[i].getName(stringTable), this);
+    symbols[i] = symbols[i] ? symtab.insert(name, symbols[i])
+                            : symtab.insert(name);
     symbols[i]->resolve(LazySymbol{*this});
     if (!lazy)
       break;
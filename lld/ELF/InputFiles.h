@@ -228,6 +228,11 @@ protected:
   uint32_t firstGlobal = 0;
 
 public:
+  // For an archive member added with --lazy-archive-index, the names the
+  // archive symbol table lists for it. parseLazy() inserts these instead of
+  // reading the member's own symbol table.
+  SmallVector<StringRef, 0> archiveIndexSymbols;
+
   uint32_t andFeatures = 0;
   bool hasCommonSyms = false;
   ArrayRef<uint8_t> aarch64PauthAbiCoreInfo;
@@ -252,6 +257,12 @@ public:
   void parse(bool ignoreComdats = false);
   void parseLazy();
 
+  // Allocate the symbol array and return the global symbol names that parse()
+  // (or parseLazy() if the file is lazy) will insert into the symbol table,
+  // along with the array elements receiving them. Used by
+  // SymbolTable::reserveSymbols.
+  SmallVector<std::pair<StringRef, Symbol **>, 0> getSymbolsToInsert();
+
   StringRef getShtGroupSignature(ArrayRef<Elf_Shdr> sections,
                                  const Elf_Shdr &sec);
 
@@ -384,7 +395,8 @@ public:
 
 InputFile *createInternalFile(StringRef name);
 ELFFileBase *createObjFile(MemoryBufferRef mb, StringRef archiveName = "",
-                           bool lazy = false);
+                           bool lazy = false,
+                           ArrayRef<StringRef> archiveIndexSymbols = {});
 
 std::string replaceThinLTOSuffix(StringRef path);
 
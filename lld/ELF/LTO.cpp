@@ -135,9 +135,12 @@ static lto::Config createConfig() {
       config->ltoValidateAllVtablesHaveTypeInfos;
   c.AllVtablesHaveTypeInfos = ctx.ltoAllVtablesHaveTypeInfos;
   c.AlwaysEmitRegularLTOObj = !config->ltoObjPath.empty();
+  c.CacheKeyUseBodyHashes = config->thinLTOCacheKeyBodyHashes;
+  c.CacheRegularLTOPartitions = config->ltoCachePartitions;
 
   for (const llvm::StringRef &name : config->thinLTOModulesToCompile)
     c.ThinLTOModulesToCompile.emplace_back(name);
+  c.ThinLTOMemoryBudget = config->thinLTOMemoryBudget;
 
   c.TimeTraceEnabled = config->timeTraceEnabled;
   c.TimeTraceGranularity = config->timeTraceGranularity;
@@ -145,6 +148,8 @@ static lto::Config createConfig() {
   c.CSIRProfile = std::string(config->ltoCSProfileFile);
   c.RunCSIRInstr = config->ltoCSProfileGenerate;
   c.PGOWarnMismatch = config->ltoPGOWarnMismatch;
+  c.CostBalancedPartitions = config->ltoCostBalancedPartitions;
+  c.StreamRegularLTOLinking = config->ltoStreamLinking;
 
   if (config->emitLLVM) {
     c.PostInternalizeModuleHook = [](size_t task, const Module &m) {
@@ -181,6 +186,14 @@ BitcodeCompiler::BitcodeCompiler() {
         std::string(config->thinLTOPrefixReplaceNew),
         std::string(config->thinLTOPrefixReplaceNativeObject),
         config->thinLTOEmitImportsFiles, indexFile.get(), onIndexWrite);
+  } else if (!config->thinLTODistributor.empty()) {
+    StringRef workDir = sys::path::parent_path(config->outputFile);
+    backend = lto::createDistributedThinBackend(
+        lto::createExternalThinBackendExecutor(
+            std::string(config->thinLTODistributor),
+            {config->thinLTODistributorArgs.begin(),
+             config->thinLTODistributorArgs.end()}),
+        workDir.empty() ? "." : workDir.str(), onIndexWrite);
   } else {
     backend = lto::createInProcessThinBackend(
         llvm::heavyweight_hardware_concurrency(config->thinLTOJobs),
@@ -95,7 +95,11 @@ static StringRef getOutputSectionName(const InputSectionBase *s) {
   // cold parts in .text.split instead of .text.unlikely mitigates against poor
   // profile inaccuracy. Techniques such as hugepage remapping can make
   // conservative decisions at the section granularity.
+  // -z hugepage-hot-text needs .text.hot as a separate output section, see
+  // alignHotTextToHugePages().
   if (isSectionPrefix(".text", s->name)) {
+    if (config->zHugepageHotText && isSectionPrefix("hot", s->name.substr(6)))
+      return ".text.hot";
     if (config->zKeepTextSectionPrefix)
       for (StringRef v : {".text.hot", ".text.unknown", ".text.unlikely",
                           ".text.startup", ".text.exit", ".text.split"})
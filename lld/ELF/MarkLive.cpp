@@ -17,6 +17,13 @@
 // bits. Writer will then ignore sections whose Live bits are off, so that
 // such sections are not included into output.
 //
+// If there is only one partition and multiple threads are available, large
+// worklists are processed in parallel rounds. Each round scans every section
+// of the current worklist concurrently; the sections, section pieces, symbols
+// and shared files reached are recorded in per-thread buffers, which are then
+// applied serially to form the next worklist. Since shared state is only read
+// during the concurrent step, the result is identical to serial marking.
+//
 //===----------------------------------------------------------------------===//
 
 #include "MarkLive.h"
@@ -31,6 +38,7 @@
 #include "lld/Common/Strings.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Object/ELF.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/TimeProfiler.h"
 #include <vector>
 
@@ -42,20 +50,34 @@ using namespace lld;
 using namespace lld::elf;
 
 namespace {
+// Liveness updates found by one thread during a parallel marking round. They
+// are applied once all threads have finished scanning the round's worklist.
+struct MarkBuffer {
+  SmallVector<std::pair<InputSectionBase *, uint64_t>, 0> sections;
+  SmallVector<Symbol *, 0> usedSyms;
+  SmallVector<SharedFile *, 0> neededFiles;
+};
+
 template <class ELFT> class MarkLive {
 public:
-  MarkLive(unsigned partition) : partition(partition) {}
+  MarkLive(unsigned partition)
+      : partition(partition),
+        parallelMark(partitions.size() == 1 && config->threadCount > 1) {}
 
   void run();
   void moveToMain();
 
 private:
-  void enqueue(InputSectionBase *sec, uint64_t offset);
+  void enqueue(InputSectionBase *sec, uint64_t offset,
+               MarkBuffer *buf = nullptr);
   void markSymbol(Symbol *sym);
+  void scanSection(InputSectionBase &sec, MarkBuffer *buf);
   void mark();
+  void markParallel();
 
   template <class RelTy>
-  void resolveReloc(InputSectionBase &sec, RelTy &rel, bool fromFDE);
+  void resolveReloc(InputSectionBase &sec, RelTy &rel, bool fromFDE,
+                    MarkBuffer *buf = nullptr);
 
   template <class RelTy>
   void scanEhFrameSection(EhInputSection &eh, ArrayRef<RelTy> rels);
@@ -63,6 +85,9 @@ private:
   // The index of the partition that we are currently processing.
   unsigned partition;
 
+  // True if large worklists may be scanned by markParallel.
+  bool parallelMark;
+
   // A list of sections to visit.
   SmallVector<InputSection *, 0> queue;
 
@@ -88,10 +113,13 @@ static uint64_t getAddend(InputSectionBase &sec,
 template <class ELFT>
 template <class RelTy>
 void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
-                                  bool fromFDE) {
+                                  bool fromFDE, MarkBuffer *buf) {
   // If a symbol is referenced in a live section, it is used.
   Symbol &sym = sec.file->getRelocTargetSym(rel);
-  sym.used = true;
+  if (!buf)
+    sym.used = true;
+  else if (!sym.used)
+    buf->usedSyms.push_back(&sym);
 
   if (auto *d = dyn_cast<Defined>(&sym)) {
     auto *relSec = dyn_cast_or_null<InputSectionBase>(d->section);
@@ -112,16 +140,22 @@ void MarkLive<ELFT>::resolveReloc(InputSectionBase &sec, RelTy &rel,
     // discarded, marking the LSDA will unnecessarily retain the text section.
     if (!(fromFDE && ((relSec->flags & (SHF_EXECINSTR | SHF_LINK_ORDER)) ||
                       relSec->nextInSectionGroup)))
-      enqueue(relSec, offset);
+      enqueue(relSec, offset, buf);
     return;
   }
 
-  if (auto *ss = dyn_cast<SharedSymbol>(&sym))
-    if (!ss->isWeak())
-      cast<SharedFile>(ss->file)->isNeeded = true;
+  if (auto *ss = dyn_cast<SharedSymbol>(&sym)) {
+    if (!ss->isWeak()) {
+      auto *file = cast<SharedFile>(ss->file);
+      if (!buf)
+        file->isNeeded = true;
+      else if (!file->isNeeded)
+        buf->neededFiles.push_back(file);
+    }
+  }
 
   for (InputSectionBase *sec : cNamedSections.lookup(sym.getName()))
-    enqueue(sec, 0);
+    enqueue(sec, 0, buf);
 }
 
 // The .eh_frame section is an unfortunate special case.
@@ -179,7 +213,18 @@ static bool isReserved(InputSectionBase *sec) {
 }
 
 template <class ELFT>
-void MarkLive<ELFT>::enqueue(InputSectionBase *sec, uint64_t offset) {
+void MarkLive<ELFT>::enqueue(InputSectionBase *sec, uint64_t offset,
+                             MarkBuffer *buf) {
+  // During a parallel round, only record the sections and pieces that are not
+  // live yet; markParallel enqueues them once the round is over.
+  if (buf) {
+    auto *ms = dyn_cast<MergeInputSection>(sec);
+    if ((ms && !ms->getSectionPiece(offset).live) ||
+        (sec->partition != 1 && sec->partition != partition))
+      buf->sections.emplace_back(sec, offset);
+    return;
+  }
+
   // Usually, a whole section is marked as live or dead, but in mergeable
   // (splittable) sections, each piece of data has independent liveness bit.
   // So we explicitly tell it which offset is in use.
@@ -300,23 +345,55 @@ template <class ELFT> void MarkLive<ELFT>::run() {
   mark();
 }
 
+// Visit the sections referenced by a live section. If buf is non-null, the
+// updates are recorded in buf instead of being applied.
+template <class ELFT>
+void MarkLive<ELFT>::scanSection(InputSectionBase &sec, MarkBuffer *buf) {
+  const RelsOrRelas<ELFT> rels = sec.template relsOrRelas<ELFT>();
+  for (const typename ELFT::Rel &rel : rels.rels)
+    resolveReloc(sec, rel, false, buf);
+  for (const typename ELFT::Rela &rel : rels.relas)
+    resolveReloc(sec, rel, false, buf);
+
+  for (InputSectionBase *isec : sec.dependentSections)
+    enqueue(isec, 0, buf);
+
+  // Mark the next group member.
+  if (sec.nextInSectionGroup)
+    enqueue(sec.nextInSectionGroup, 0, buf);
+}
+
 template <class ELFT> void MarkLive<ELFT>::mark() {
   // Mark all reachable sections.
   while (!queue.empty()) {
-    InputSectionBase &sec = *queue.pop_back_val();
-
-    const RelsOrRelas<ELFT> rels = sec.template relsOrRelas<ELFT>();
-    for (const typename ELFT::Rel &rel : rels.rels)
-      resolveReloc(sec, rel, false);
-    for (const typename ELFT::Rela &rel : rels.relas)
-      resolveReloc(sec, rel, false);
-
-    for (InputSectionBase *isec : sec.dependentSections)
-      enqueue(isec, 0);
+    // Scanning a worklist concurrently only pays off if it is large. Small
+    // worklists are drained serially, which may grow them again.
+    if (parallelMark && queue.size() >= 1024) {
+      markParallel();
+      continue;
+    }
+    scanSection(*queue.pop_back_val(), nullptr);
+  }
+}
 
-    // Mark the next group member.
-    if (sec.nextInSectionGroup)
-      enqueue(sec.nextInSectionGroup, 0);
+// Scan all sections in the worklist in parallel, then apply the recorded
+// updates in thread order. The worklist is replaced by the newly live sections.
+template <class ELFT> void MarkLive<ELFT>::markParallel() {
+  SmallVector<InputSection *, 0> worklist = std::move(queue);
+  queue.clear();
+
+  std::vector<MarkBuffer> bufs(config->threadCount);
+  parallelForEach(worklist, [&](InputSection *sec) {
+    scanSection(*sec, &bufs[parallel::getThreadIndex()]);
+  });
+
+  for (MarkBuffer &buf : bufs) {
+    for (Symbol *sym : buf.usedSyms)
+      sym->used = true;
+    for (SharedFile *file : buf.neededFiles)
+      file->isNeeded = true;
+    for (auto [sec, offset] : buf.sections)
+      enqueue(sec, offset);
   }
 }
 
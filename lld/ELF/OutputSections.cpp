@@ -18,9 +18,11 @@
 #include "llvm/BinaryFormat/Dwarf.h"
 #include "llvm/Config/llvm-config.h" // LLVM_ENABLE_ZLIB
 #include "llvm/Support/Compression.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
 #if LLVM_ENABLE_ZLIB
 // Avoid introducing max as a macro from Windows headers.
 #define NOMINMAX
@@ -335,6 +337,35 @@ static SmallVector<uint8_t, 0> deflateShard(ArrayRef<uint8_t> in, int level,
 }
 #endif
 
+std::string elf::getIncrementalCacheKey(const Twine &prefix,
+                                        ArrayRef<uint8_t> data) {
+  return (prefix + utohexstr(xxh3_64bits(data), /*LowerCase=*/true) +
+          utohexstr(xxHash64(data), /*LowerCase=*/true))
+      .str();
+}
+
+std::unique_ptr<MemoryBuffer> elf::readIncrementalCacheEntry(StringRef key) {
+  SmallString<128> path(config->incrementalCacheDir);
+  sys::path::append(path, key);
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(path, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (!mbOrErr)
+    return nullptr;
+  return std::move(*mbOrErr);
+}
+
+void elf::writeIncrementalCacheEntry(StringRef key, ArrayRef<uint8_t> data) {
+  SmallString<128> path(config->incrementalCacheDir);
+  sys::path::append(path, key);
+  if (Error e = writeToOutput(path, [&](raw_ostream &os) {
+        os.write(reinterpret_cast<const char *>(data.data()), data.size());
+        return Error::success();
+      }))
+    warn("cannot write incremental cache entry " + path + ": " +
+         toString(std::move(e)));
+}
+
 // Compress certain non-SHF_ALLOC sections:
 //
 // * (if --compress-debug-sections is specified) non-empty .debug_* sections
@@ -380,32 +411,55 @@ template <class ELFT> void OutputSection::maybeCompress() {
   const size_t numShards = shardsIn.size();
   auto shardsOut = std::make_unique<SmallVector<uint8_t, 0>[]>(numShards);
 
+  // Each shard is compressed independently. The result only depends on the
+  // shard content, the compression type and level, and for zlib whether it is
+  // the last shard. With --incremental-cache, reuse the shards compressed by a
+  // previous link.
+  [[maybe_unused]] auto compressShard =
+      [&](size_t i, const Twine &prefix,
+          function_ref<SmallVector<uint8_t, 0>()> compress) {
+        if (config->incrementalCacheDir.empty()) {
+          shardsOut[i] = compress();
+          return;
+        }
+        std::string key = getIncrementalCacheKey(prefix, shardsIn[i]);
+        if (std::unique_ptr<MemoryBuffer> mb = readIncrementalCacheEntry(key)) {
+          shardsOut[i].assign(mb->getBufferStart(), mb->getBufferEnd());
+          return;
+        }
+        shardsOut[i] = compress();
+        writeIncrementalCacheEntry(key, shardsOut[i]);
+      };
+
 #if LLVM_ENABLE_ZSTD
   // Use ZSTD's streaming compression API. See
   // http://facebook.github.io/zstd/zstd_manual.html "Streaming compression -
   // HowTo".
   if (ctype == DebugCompressionType::Zstd) {
     parallelFor(0, numShards, [&](size_t i) {
-      SmallVector<uint8_t, 0> out;
-      ZSTD_CCtx *cctx = ZSTD_createCCtx();
-      ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
-      ZSTD_inBuffer zib = {shardsIn[i].data(), shardsIn[i].size(), 0};
-      ZSTD_outBuffer zob = {nullptr, 0, 0};
-      size_t size;
-      do {
-        // Allocate a buffer of half of the input size, and grow it by 1.5x if
-        // insufficient.
-        if (zob.pos == zob.size) {
-          out.resize_for_overwrite(
-              zob.size ? zob.size * 3 / 2 : std::max<size_t>(zib.size / 4, 64));
-          zob = {out.data(), out.size(), zob.pos};
-        }
-        size = ZSTD_compressStream2(cctx, &zob, &zib, ZSTD_e_end);
-        assert(!ZSTD_isError(size));
-      } while (size != 0);
-      out.truncate(zob.pos);
-      ZSTD_freeCCtx(cctx);
-      shardsOut[i] = std::move(out);
+      compressShard(i, "zstd-" + Twine(level) + "-", [&] {
+        SmallVector<uint8_t, 0> out;
+        ZSTD_CCtx *cctx = ZSTD_createCCtx();
+        ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+        ZSTD_inBuffer zib = {shardsIn[i].data(), shardsIn[i].size(), 0};
+        ZSTD_outBuffer zob = {nullptr, 0, 0};
+        size_t size;
+        do {
+          // Allocate a buffer of half of the input size, and grow it by 1.5x if
+          // insufficient.
+          if (zob.pos == zob.size) {
+            out.resize_for_overwrite(
+                zob.size ? zob.size * 3 / 2
+                         : std::max<size_t>(zib.size / 4, 64));
+            zob = {out.data(), out.size(), zob.pos};
+          }
+          size = ZSTD_compressStream2(cctx, &zob, &zib, ZSTD_e_end);
+          assert(!ZSTD_isError(size));
+        } while (size != 0);
+        out.truncate(zob.pos);
+        ZSTD_freeCCtx(cctx);
+        return out;
+      });
     });
     compressed.type = ELFCOMPRESS_ZSTD;
     for (size_t i = 0; i != numShards; ++i)
@@ -425,8 +479,9 @@ template <class ELFT> void OutputSection::maybeCompress() {
     // concatenated with the next shard.
     auto shardsAdler = std::make_unique<uint32_t[]>(numShards);
     parallelFor(0, numShards, [&](size_t i) {
-      shardsOut[i] = deflateShard(shardsIn[i], level,
-                                  i != numShards - 1 ? Z_SYNC_FLUSH : Z_FINISH);
+      int flush = i != numShards - 1 ? Z_SYNC_FLUSH : Z_FINISH;
+      compressShard(i, "zlib-" + Twine(level) + "-" + Twine(flush) + "-",
+                    [&] { return deflateShard(shardsIn[i], level, flush); });
       shardsAdler[i] = adler32(1, shardsIn[i].data(), shardsIn[i].size());
     });
 
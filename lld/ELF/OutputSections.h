@@ -121,10 +121,10 @@ public:
   // --compress-sections.
   CompressedData compressed;
 
+  std::array<uint8_t, 4> getFiller();
+
 private:
   SmallVector<InputSection *, 0> storage;
-
-  std::array<uint8_t, 4> getFiller();
 };
 
 struct OutputDesc final : SectionCommand {
@@ -159,6 +159,15 @@ struct Out {
 
 uint64_t getHeaderSize();
 
+// Returns a name for an --incremental-cache entry holding content derived from
+// data. The name combines two unrelated 64-bit hashes of data.
+std::string getIncrementalCacheKey(const Twine &prefix, ArrayRef<uint8_t> data);
+
+// Reads or writes an entry in the --incremental-cache directory. Reading
+// returns null if the entry does not exist.
+std::unique_ptr<MemoryBuffer> readIncrementalCacheEntry(StringRef key);
+void writeIncrementalCacheEntry(StringRef key, ArrayRef<uint8_t> data);
+
 LLVM_LIBRARY_VISIBILITY extern llvm::SmallVector<OutputSection *, 0>
     outputSections;
 } // namespace lld::elf
@@ -56,6 +56,7 @@
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/Parallel.h"
 #include <algorithm>
 
 using namespace llvm;
@@ -1618,21 +1619,12 @@ template <class ELFT> void elf::scanRelocations() {
   // for parallelism.
   bool serial = !config->zCombreloc || config->emachine == EM_MIPS ||
                 config->emachine == EM_PPC64;
-  parallel::TaskGroup tg;
-  for (ELFFileBase *f : ctx.objectFiles) {
-    auto fn = [f]() {
-      RelocationScanner scanner;
-      for (InputSectionBase *s : f->getSections()) {
-        if (s && s->kind() == SectionBase::Regular && s->isLive() &&
-            (s->flags & SHF_ALLOC) &&
-            !(s->type == SHT_ARM_EXIDX && config->emachine == EM_ARM))
-          scanner.template scanSection<ELFT>(*s);
-      }
-    };
-    tg.spawn(fn, serial);
-  }
-
-  tg.spawn([] {
+  auto needsScan = [](InputSectionBase *s) {
+    return s && s->kind() == SectionBase::Regular && s->isLive() &&
+           (s->flags & SHF_ALLOC) &&
+           !(s->type == SHT_ARM_EXIDX && config->emachine == EM_ARM);
+  };
+  auto scanSynthetic = [] {
     RelocationScanner scanner;
     for (Partition &part : partitions) {
       for (EhInputSection *sec : part.ehFrame->sections)
@@ -1642,7 +1634,60 @@ template <class ELFT> void elf::scanRelocations() {
           if (sec->isLive())
             scanner.template scanSection<ELFT>(*sec);
     }
+  };
+
+  if (serial) {
+    parallel::TaskGroup tg;
+    for (ELFFileBase *f : ctx.objectFiles) {
+      auto fn = [=]() {
+        RelocationScanner scanner;
+        for (InputSectionBase *s : f->getSections())
+          if (needsScan(s))
+            scanner.template scanSection<ELFT>(*s);
+      };
+      tg.spawn(fn, serial);
+    }
+    tg.spawn(scanSynthetic, serial);
+    return;
+  }
+
+  // The result does not depend on the scanning order. Split the sections into
+  // chunks of roughly equal numbers of relocations and scan the largest chunks
+  // and .eh_frame first, so that a few large input files, which typically come
+  // last, do not form the critical path.
+  struct ScanChunk {
+    SmallVector<InputSectionBase *, 0> sections;
+    size_t numRelocs = 0;
+  };
+  const size_t chunkSize = 1 << 14;
+  SmallVector<ScanChunk, 0> chunks;
+  for (ELFFileBase *f : ctx.objectFiles) {
+    ScanChunk chunk;
+    for (InputSectionBase *s : f->getSections()) {
+      if (!needsScan(s))
+        continue;
+      const RelsOrRelas<ELFT> rels = s->template relsOrRelas<ELFT>();
+      chunk.sections.push_back(s);
+      chunk.numRelocs += rels.rels.size() + rels.relas.size();
+      if (chunk.numRelocs >= chunkSize)
+        chunks.push_back(std::exchange(chunk, ScanChunk()));
+    }
+    if (!chunk.sections.empty())
+      chunks.push_back(std::move(chunk));
+  }
+  llvm::stable_sort(chunks, [](const ScanChunk &a, const ScanChunk &b) {
+    return a.numRelocs > b.numRelocs;
   });
+
+  parallel::TaskGroup tg;
+  tg.spawn(scanSynthetic);
+  for (const ScanChunk &chunk : chunks) {
+    tg.spawn([&chunk] {
+      RelocationScanner scanner;
+      for (InputSectionBase *s : chunk.sections)
+        scanner.template scanSection<ELFT>(*s);
+    });
+  }
 }
 
 static bool handleNonPreemptibleIfunc(Symbol &sym, uint16_t flags) {
@@ -2267,22 +2312,44 @@ bool ThunkCreator::createThunks(uint32_t pass,
   // We separate the creation of ThunkSections from the insertion of the
   // ThunkSections as ThunkSections are not always inserted into the same
   // InputSectionDescription as the caller.
+  //
+  // Finding the relocations that need a Thunk only reads addresses, which do
+  // not change until the ThunkSections of the InputSectionDescription are
+  // assigned offsets, so it is done in parallel over chunks of sections. The
+  // Thunks are then created serially in the original order so that the output
+  // does not depend on the number of threads.
   forEachInputSectionDescription(
       outputSections, [&](OutputSection *os, InputSectionDescription *isd) {
-        for (InputSection *isec : isd->sections)
-          for (Relocation &rel : isec->relocs()) {
-            uint64_t src = isec->getVA(rel.offset);
-
-            // If we are a relocation to an existing Thunk, check if it is
-            // still in range. If not then Rel will be altered to point to its
-            // original target so another Thunk can be generated.
-            if (pass > 0 && normalizeExistingThunk(rel, src))
-              continue;
-
-            if (!target->needsThunk(rel.expr, rel.type, isec->file, src,
-                                    *rel.sym, rel.addend))
-              continue;
+        constexpr size_t sectionsPerChunk = 256;
+        size_t numChunks = divideCeil(isd->sections.size(), sectionsPerChunk);
+        auto candidates = std::make_unique<
+            SmallVector<std::pair<InputSection *, Relocation *>, 0>[]>(
+            numChunks);
+        parallelFor(0, numChunks, [&](size_t i) {
+          ArrayRef<InputSection *> chunk =
+              ArrayRef(isd->sections)
+                  .slice(i * sectionsPerChunk)
+                  .take_front(sectionsPerChunk);
+          for (InputSection *isec : chunk)
+            for (Relocation &rel : isec->relocs()) {
+              uint64_t src = isec->getVA(rel.offset);
+
+              // If we are a relocation to an existing Thunk, check if it is
+              // still in range. If not then Rel will be altered to point to
+              // its original target so another Thunk can be generated.
+              if (pass > 0 && normalizeExistingThunk(rel, src))
+                continue;
+
+              if (target->needsThunk(rel.expr, rel.type, isec->file, src,
+                                     *rel.sym, rel.addend))
+                candidates[i].emplace_back(isec, &rel);
+            }
+        });
 
+        for (size_t i = 0; i != numChunks; ++i)
+          for (auto [isec, relPtr] : candidates[i]) {
+            Relocation &rel = *relPtr;
+            uint64_t src = isec->getVA(rel.offset);
             Thunk *t;
             bool isNew;
             std::tie(t, isNew) = getThunk(isec, rel, src);
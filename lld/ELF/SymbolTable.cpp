@@ -22,6 +22,7 @@
 #include "lld/Common/Strings.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Demangle/Demangle.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -33,12 +34,15 @@ SymbolTable elf::symtab;
 
 void SymbolTable::wrap(Symbol *sym, Symbol *real, Symbol *wrap) {
   // Redirect __real_foo to the original foo and foo to the original __wrap_foo.
-  int &idx1 = symMap[CachedHashStringRef(sym->getName())];
-  int &idx2 = symMap[CachedHashStringRef(real->getName())];
-  int &idx3 = symMap[CachedHashStringRef(wrap->getName())];
+  CachedHashStringRef name1(sym->getName());
+  CachedHashStringRef name2(real->getName());
+  CachedHashStringRef name3(wrap->getName());
+  Symbol *&entry1 = getSymMap(name1)[name1];
+  Symbol *&entry2 = getSymMap(name2)[name2];
+  Symbol *&entry3 = getSymMap(name3)[name3];
 
-  idx2 = idx1;
-  idx1 = idx3;
+  entry2 = entry1;
+  entry1 = entry3;
 
   // Propagate symbol usage information to the redirected symbols.
   if (sym->isUsedInRegularObj)
@@ -62,42 +66,91 @@ void SymbolTable::wrap(Symbol *sym, Symbol *real, Symbol *wrap) {
   real->isUsedInRegularObj = false;
 }
 
-// Find an existing symbol or create a new one.
-Symbol *SymbolTable::insert(StringRef name) {
-  // <name>@@<version> means the symbol is the default version. In that
-  // case <name>@@<version> will be used to resolve references to <name>.
-  //
-  // Since this is a hot path, the following string search code is
-  // optimized for speed. StringRef::find(char) is much faster than
-  // StringRef::find(StringRef).
-  StringRef stem = name;
+// <name>@@<version> means the symbol is the default version. In that
+// case <name>@@<version> will be used to resolve references to <name>.
+//
+// Since this is a hot path, the following string search code is
+// optimized for speed. StringRef::find(char) is much faster than
+// StringRef::find(StringRef).
+static StringRef getStem(StringRef name) {
   size_t pos = name.find('@');
   if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
-    stem = name.take_front(pos);
+    return name.take_front(pos);
+  return name;
+}
 
-  auto p = symMap.insert({CachedHashStringRef(stem), (int)symVector.size()});
-  if (!p.second) {
-    Symbol *sym = symVector[p.first->second];
-    if (stem.size() != name.size()) {
-      sym->setName(name);
+// Find an existing symbol or create a new one.
+Symbol *SymbolTable::insert(StringRef name) {
+  CachedHashStringRef key(getStem(name));
+  Symbol *&sym = getSymMap(key)[key];
+  if (!sym) {
+    sym = reinterpret_cast<Symbol *>(make<SymbolUnion>());
+    memset(sym, 0, sizeof(Symbol));
+  }
+  return insert(name, sym);
+}
+
+Symbol *SymbolTable::insert(StringRef name, Symbol *sym) {
+  // A new entry is added to symVector the first time its name is inserted.
+  size_t pos = name.find('@');
+  if (sym->partition == 0) {
+    symVector.push_back(sym);
+
+    // *sym was not initialized by a constructor. Initialize all Symbol fields
+    // other than those cleared when the entry was created.
+    sym->setName(name);
+    sym->partition = 1;
+    sym->versionId = VER_NDX_GLOBAL;
+    if (pos != StringRef::npos)
       sym->hasVersionSuffix = true;
-    }
     return sym;
   }
 
-  Symbol *sym = reinterpret_cast<Symbol *>(make<SymbolUnion>());
-  symVector.push_back(sym);
-
-  // *sym was not initialized by a constructor. Initialize all Symbol fields.
-  memset(sym, 0, sizeof(Symbol));
-  sym->setName(name);
-  sym->partition = 1;
-  sym->versionId = VER_NDX_GLOBAL;
-  if (pos != StringRef::npos)
+  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@') {
+    sym->setName(name);
     sym->hasVersionSuffix = true;
+  }
   return sym;
 }
 
+void SymbolTable::reserveSymbols(
+    ArrayRef<SmallVector<std::pair<StringRef, Symbol **>, 0>> lists) {
+  struct PendingSymbol {
+    CachedHashStringRef stem;
+    Symbol **slot;
+  };
+  auto getShard = [](const PendingSymbol &p) {
+    return p.stem.hash() >> (32 - symMapShardBits);
+  };
+
+  // Hash the names and group each list by shard, then let each thread fill
+  // its own shards.
+  std::vector<SmallVector<PendingSymbol, 0>> pending(lists.size());
+  parallelFor(0, lists.size(), [&](size_t i) {
+    pending[i].reserve(lists[i].size());
+    for (auto [name, slot] : lists[i])
+      pending[i].push_back({CachedHashStringRef(getStem(name)), slot});
+    llvm::sort(pending[i], [&](const PendingSymbol &a, const PendingSymbol &b) {
+      return getShard(a) < getShard(b);
+    });
+  });
+  parallelFor(0, std::size(symMaps), [&](size_t shard) {
+    SymMap &map = symMaps[shard];
+    for (ArrayRef<PendingSymbol> list : pending) {
+      auto *it = llvm::partition_point(
+          list, [&](const PendingSymbol &p) { return getShard(p) < shard; });
+      for (; it != list.end() && getShard(*it) == shard; ++it) {
+        Symbol *&sym = map[it->stem];
+        if (!sym) {
+          sym = reinterpret_cast<Symbol *>(makeThreadLocal<SymbolUnion>());
+          memset(sym, 0, sizeof(Symbol));
+        }
+        *it->slot = sym;
+      }
+    }
+  });
+}
+
 // This variant of addSymbol is used by BinaryFile::parse to check duplicate
 // symbol errors.
 Symbol *SymbolTable::addAndCheckDuplicate(const Defined &newSym) {
@@ -110,10 +163,12 @@ Symbol *SymbolTable::addAndCheckDuplicate(const Defined &newSym) {
 }
 
 Symbol *SymbolTable::find(StringRef name) {
-  auto it = symMap.find(CachedHashStringRef(name));
-  if (it == symMap.end())
+  CachedHashStringRef key(name);
+  SymMap &map = getSymMap(key);
+  auto it = map.find(key);
+  if (it == map.end() || it->second->partition == 0)
     return nullptr;
-  return symVector[it->second];
+  return it->second;
 }
 
 // A version script/dynamic list is only meaningful for a Defined symbol.
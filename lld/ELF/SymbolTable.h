@@ -44,6 +44,18 @@ public:
 
   Symbol *insert(StringRef name);
 
+  // Same as insert(name), where sym is the entry for name's stem found by
+  // reserveSymbols. This saves a hash table lookup.
+  Symbol *insert(StringRef name, Symbol *sym);
+
+  // For each pair of a symbol name and a location in lists, find or create the
+  // entry for the name and store it to the location. This is done in parallel.
+  // A created entry is not visible to find() and getSymbols() until it is
+  // passed to insert(name, sym), so the symbol order is the same as if
+  // insert(name) had been called instead.
+  void reserveSymbols(
+      ArrayRef<SmallVector<std::pair<StringRef, Symbol **>, 0>> lists);
+
   template <typename T> Symbol *addSymbol(const T &newSym) {
     Symbol *sym = insert(newSym.getName());
     sym->resolve(newSym);
@@ -91,10 +103,21 @@ private:
   void assignWildcardVersion(SymbolVersion ver, uint16_t versionId,
                              bool includeNonDefault);
 
-  // Global symbols and a map from symbol name to the index. The order is not
+  // The map from symbol names to symbols is sharded by the upper bits of the
+  // name hash so that reserveSymbols can fill the shards concurrently.
+  static constexpr unsigned symMapShardBits = 6;
+  using SymMap = llvm::DenseMap<llvm::CachedHashStringRef, Symbol *>;
+  SymMap &getSymMap(llvm::CachedHashStringRef name) {
+    return symMaps[name.hash() >> (32 - symMapShardBits)];
+  }
+
+  // Global symbols and a map from symbol name to the symbol. The order is not
   // defined. We can use an arbitrary order, but it has to be deterministic even
   // when cross linking.
-  llvm::DenseMap<llvm::CachedHashStringRef, int> symMap;
+  //
+  // An entry created by reserveSymbols has a zero partition until its name is
+  // inserted, at which point the symbol is initialized and added to symVector.
+  SymMap symMaps[1 << symMapShardBits];
   SmallVector<Symbol *, 0> symVector;
 
   // A map from demangled symbol names to their symbol objects.
@@ -9,6 +9,7 @@
 #include "Writer.h"
 #include "AArch64ErrataFix.h"
 #include "ARMErrataFix.h"
+#include "BPSectionOrderer.h"
 #include "CallGraphSort.h"
 #include "Config.h"
 #include "InputFiles.h"
@@ -27,6 +28,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/BLAKE3.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Parallel.h"
 #include "llvm/Support/RandomNumberGenerator.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -1038,6 +1040,17 @@ static void maybeShuffle(DenseMap<const InputSectionBase *, int> &order) {
 // Builds section order for handling --symbol-ordering-file.
 static DenseMap<const InputSectionBase *, int> buildSectionOrder() {
   DenseMap<const InputSectionBase *, int> sectionOrder;
+  if (config->bpStartupFunctionSort || config->bpFunctionOrderForCompression ||
+      config->bpDataOrderForCompression) {
+    TimeTraceScope timeScope("Balanced partitioning section order");
+    return runBalancedPartitioning(
+        config->bpStartupFunctionSort ? config->irpgoProfilePath : "",
+        config->bpFunctionOrderForCompression,
+        config->bpDataOrderForCompression,
+        config->bpCompressionSortStartupFunctions,
+        config->bpVerboseSectionOrderer);
+  }
+
   // Use the rarely used option --call-graph-ordering-file to sort sections.
   if (!config->callGraphProfile.empty())
     return computeCallGraphProfileOrder();
@@ -1643,6 +1656,25 @@ static void removeUnusedSyntheticSections() {
   });
 }
 
+// With -z hugepage-hot-text, make .text.hot start at a huge page boundary and
+// start the next executable section at the following huge page boundary, so
+// that hot code is packed into huge pages of its own. The alignment raises
+// p_align of the PT_LOAD containing .text.hot, which keeps its file offsets
+// congruent to its addresses modulo the huge page size. That is what
+// transparent huge pages need for file-backed text, so no remapping at startup
+// is required.
+static void alignHotTextToHugePages(ArrayRef<OutputSection *> sections) {
+  constexpr uint32_t hugePageSize = 2 * 1024 * 1024;
+  auto *it = llvm::find_if(sections, [](OutputSection *sec) {
+    return sec->name == ".text.hot" && (sec->flags & SHF_EXECINSTR);
+  });
+  if (it == sections.end())
+    return;
+  (*it)->addralign = std::max((*it)->addralign, hugePageSize);
+  if (++it != sections.end() && ((*it)->flags & SHF_EXECINSTR))
+    (*it)->addralign = std::max((*it)->addralign, hugePageSize);
+}
+
 // Create output section objects and add them to OutputSections.
 template <class ELFT> void Writer<ELFT>::finalizeSections() {
   if (!config->relocatable) {
@@ -1846,6 +1878,9 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
       osec->shName = in.shStrTab->addString(osec->name);
     }
 
+  if (config->zHugepageHotText)
+    alignHotTextToHugePages(outputSections);
+
   // Prefer command line supplied address over other constraints.
   for (OutputSection *sec : outputSections) {
     auto i = config->sectionStartMap.find(sec->name);
@@ -2757,10 +2792,81 @@ template <class ELFT> void Writer<ELFT>::writeTrapInstr() {
   }
 }
 
+// Returns the name of the --incremental-cache entry holding the content of
+// osec, or an empty string if the content is not cacheable.
+//
+// The name is derived from everything OutputSection::writeTo reads for an
+// output section made of regular input sections: the section's address, size
+// and filler, the layout and contents of its input sections and, for each
+// relocation, the value that relocateAlloc would apply. Synthetic sections,
+// BYTE()-family commands and target-specific rewrites that look beyond a
+// relocation's value make a section uncacheable.
+template <class ELFT>
+static std::string getSectionCacheKey(OutputSection &osec) {
+  if (!(osec.flags & SHF_ALLOC) || osec.type == SHT_NOBITS ||
+      osec.compressed.shards || config->emitRelocs)
+    return "";
+  if (config->emachine != EM_X86_64 && config->emachine != EM_386 &&
+      config->emachine != EM_AARCH64)
+    return "";
+  for (SectionCommand *cmd : osec.commands)
+    if (isa<ByteCommand>(cmd))
+      return "";
+
+  SmallVector<InputSection *, 0> storage;
+  ArrayRef<InputSection *> sections = getInputSections(osec, storage);
+  std::array<uint8_t, 4> filler = osec.getFiller();
+  SmallVector<uint64_t, 0> desc = {config->emachine, osec.addr, osec.size,
+                                   osec.type, read32le(filler.data())};
+  for (InputSection *isec : sections) {
+    if (isa<SyntheticSection>(isec) || isec->compressed ||
+        isStaticRelSecType(isec->type) || isec->type == SHT_GROUP ||
+        isec->getFile<ELFT>()->splitStack ||
+        (config->emachine == EM_X86_64 && isec->jumpInstrMod))
+      return "";
+    desc.append({isec->outSecOff, isec->getSize(), isec->nopFiller,
+                 isec->type == SHT_NOBITS ? 0 : xxh3_64bits(isec->content())});
+
+    uint64_t secAddr = osec.addr + isec->outSecOff;
+    for (const Relocation &rel : isec->relocs())
+      desc.append({rel.type, rel.expr, rel.offset, uint64_t(rel.addend),
+                   isec->getRelocTargetVA(isec->file, rel.type, rel.addend,
+                                          secAddr + rel.offset, *rel.sym,
+                                          rel.expr),
+                   rel.sym->getVA(), rel.sym->isPreemptible});
+  }
+
+  return getIncrementalCacheKey(
+      "sec-", ArrayRef(reinterpret_cast<const uint8_t *>(desc.data()),
+                       desc.size() * sizeof(uint64_t)));
+}
+
 // Write section contents to a mmap'ed file.
 template <class ELFT> void Writer<ELFT>::writeSections() {
   llvm::TimeTraceScope timeScope("Write sections");
 
+  // With --incremental-cache, look up the contents of the non-relocation
+  // sections in the cache. Cache hits are copied instead of written.
+  size_t numSections = outputSections.size();
+  SmallVector<std::string, 0> cacheKeys;
+  SmallVector<std::unique_ptr<MemoryBuffer>, 0> cached;
+  if (!config->incrementalCacheDir.empty()) {
+    llvm::TimeTraceScope timeScope("Read incremental cache");
+    cacheKeys.resize(numSections);
+    cached.resize(numSections);
+    parallelFor(0, numSections, [&](size_t i) {
+      OutputSection &osec = *outputSections[i];
+      if (isStaticRelSecType(osec.type))
+        return;
+      cacheKeys[i] = getSectionCacheKey<ELFT>(osec);
+      if (cacheKeys[i].empty())
+        return;
+      std::unique_ptr<MemoryBuffer> mb = readIncrementalCacheEntry(cacheKeys[i]);
+      if (mb && mb->getBufferSize() == osec.size)
+        cached[i] = std::move(mb);
+    });
+  }
+
   {
     // In -r or --emit-relocs mode, write the relocation sections first as in
     // ELf_Rel targets we might find out that we need to modify the relocated
@@ -2772,9 +2878,40 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
   }
   {
     parallel::TaskGroup tg;
-    for (OutputSection *sec : outputSections)
-      if (!isStaticRelSecType(sec->type))
-        sec->writeTo<ELFT>(Out::bufferStart + sec->offset, tg);
+    for (size_t i = 0; i != numSections; ++i) {
+      OutputSection *sec = outputSections[i];
+      if (isStaticRelSecType(sec->type))
+        continue;
+      if (!cached.empty() && cached[i]) {
+        const MemoryBuffer &mb = *cached[i];
+        tg.spawn([=, &mb] {
+          memcpy(Out::bufferStart + sec->offset, mb.getBufferStart(),
+                 mb.getBufferSize());
+        });
+        continue;
+      }
+      sec->writeTo<ELFT>(Out::bufferStart + sec->offset, tg);
+    }
+  }
+
+  // Store the sections that were not found in the cache. Skip this if writing
+  // reported an error, as the output is going to be discarded.
+  if (!cacheKeys.empty() && !errorCount()) {
+    llvm::TimeTraceScope timeScope("Write incremental cache");
+    std::atomic<size_t> numHits{0};
+    parallelFor(0, numSections, [&](size_t i) {
+      if (cached[i]) {
+        ++numHits;
+        return;
+      }
+      if (cacheKeys[i].empty())
+        return;
+      OutputSection &osec = *outputSections[i];
+      writeIncrementalCacheEntry(
+          cacheKeys[i], ArrayRef(Out::bufferStart + osec.offset, osec.size));
+    });
+    log("incremental cache: reused " + Twine(numHits) + " of " +
+        Twine(numSections) + " output sections");
   }
 
   // Finally, check that all dynamic relocation addends were written correctly.
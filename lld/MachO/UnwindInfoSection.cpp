@@ -468,11 +468,13 @@ void UnwindInfoSectionImpl::finalize() {
   relocateCompactUnwind(cuEntries);
 
   // Rather than sort & fold the 32-byte entries directly, we create a
-  // vector of indices to entries and sort & fold that instead.
+  // vector of indices to entries and sort & fold that instead. Ties are broken
+  // by index so that the parallel sort produces a deterministic order.
   cuIndices.resize(cuEntries.size());
   std::iota(cuIndices.begin(), cuIndices.end(), 0);
-  llvm::sort(cuIndices, [&](size_t a, size_t b) {
-    return cuEntries[a].functionAddress < cuEntries[b].functionAddress;
+  parallelSort(cuIndices, [&](size_t a, size_t b) {
+    return std::make_pair(cuEntries[a].functionAddress, a) <
+           std::make_pair(cuEntries[b].functionAddress, b);
   });
 
   // Record the ending boundary before we fold the entries.
@@ -0,0 +1,90 @@
+# REQUIRES: x86
+## Test balanced partitioning section ordering for compression, and the
+## diagnostics for its options.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 a.s -o a.o
+
+# RUN: ld.lld --bp-compression-sort=both --verbose-bp-section-orderer a.o \
+# RUN:   -o out 2>&1 | FileCheck %s --check-prefix=BOTH
+# BOTH:      Ordered {{[1-9][0-9]*}} sections using balanced partitioning:
+# BOTH-NEXT:   Functions for startup: 0
+# BOTH-NEXT:   Functions for compression: {{[1-9][0-9]*}}
+# BOTH-NEXT:   Duplicate functions: {{[0-9]+}}
+# BOTH-NEXT:   Data for compression: {{[1-9][0-9]*}}
+# BOTH-NEXT:   Duplicate data: {{[0-9]+}}
+
+## Every function is still in the output, and the ordering is deterministic.
+# RUN: llvm-nm -n out | FileCheck %s --check-prefix=SYMS
+# SYMS-DAG: T f1
+# SYMS-DAG: T f2
+# SYMS-DAG: T f3
+# SYMS-DAG: T f4
+# SYMS-DAG: D d1
+# SYMS-DAG: D d2
+# RUN: ld.lld --bp-compression-sort=both a.o -o out2
+# RUN: cmp out out2
+
+# RUN: ld.lld --bp-compression-sort=function --verbose-bp-section-orderer \
+# RUN:   a.o -o /dev/null 2>&1 | FileCheck %s --check-prefix=FUNCTION
+# FUNCTION: Data for compression: 0
+
+# RUN: not ld.lld --bp-startup-sort=function a.o -o /dev/null 2>&1 | \
+# RUN:   FileCheck %s --check-prefix=NO-PROFILE
+# NO-PROFILE: error: --bp-startup-sort=function must be used with --irpgo-profile
+
+# RUN: not ld.lld --bp-compression-sort-startup-functions a.o -o /dev/null \
+# RUN:   2>&1 | FileCheck %s --check-prefix=NO-PROFILE-STARTUP
+# NO-PROFILE-STARTUP: error: --bp-compression-sort-startup-functions must be used with --irpgo-profile
+
+# RUN: not ld.lld --bp-compression-sort=bad a.o -o /dev/null 2>&1 | \
+# RUN:   FileCheck %s --check-prefix=BAD
+# BAD: error: unknown --bp-compression-sort= value: bad
+
+# RUN: echo f1 > order.txt
+# RUN: not ld.lld --bp-compression-sort=function --symbol-ordering-file=order.txt \
+# RUN:   a.o -o /dev/null 2>&1 | FileCheck %s --check-prefix=ORDER
+# ORDER: error: --symbol-ordering-file and --bp-*-sort may not be used together
+
+#--- a.s
+.globl _start
+_start:
+  ret
+
+.section .text.f1,"ax",@progbits
+.globl f1
+f1:
+  movl $1, %eax
+  addl $2, %eax
+  ret
+
+.section .text.f2,"ax",@progbits
+.globl f2
+f2:
+  movq $1, %rax
+  imulq $3, %rax
+  ret
+
+.section .text.f3,"ax",@progbits
+.globl f3
+f3:
+  movl $1, %eax
+  addl $3, %eax
+  ret
+
+.section .text.f4,"ax",@progbits
+.globl f4
+f4:
+  movq $1, %rax
+  imulq $5, %rax
+  ret
+
+.section .data.d1,"aw",@progbits
+.globl d1
+d1:
+  .quad 1, 2, 3, 4
+
+.section .data.d2,"aw",@progbits
+.globl d2
+d2:
+  .quad 5, 6, 7, 8
@@ -0,0 +1,69 @@
+# REQUIRES: x86
+## Test that marking with several threads keeps exactly the sections that
+## serial marking keeps. _start references 2000 sections, which is enough for
+## the worklist to be scanned in parallel rounds. Those sections reach more
+## sections, mergeable string pieces and a shared library.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: %python gen.py > many.s
+# RUN: llvm-mc -filetype=obj -triple=x86_64 many.s -o many.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 shared.s -o shared.o
+# RUN: ld.lld -shared -soname=shared.so shared.o -o shared.so
+
+# RUN: ld.lld --gc-sections --as-needed --threads=1 --print-gc-sections \
+# RUN:   many.o shared.so -o serial > serial.txt
+# RUN: ld.lld --gc-sections --as-needed --threads=4 --print-gc-sections \
+# RUN:   many.o shared.so -o parallel > parallel.txt
+# RUN: cmp serial parallel
+# RUN: cmp serial.txt parallel.txt
+
+# RUN: FileCheck %s --check-prefix=GC < parallel.txt
+# RUN: llvm-nm parallel | FileCheck %s --check-prefix=SYMS
+# RUN: llvm-readelf -d parallel | FileCheck %s --check-prefix=DYN
+
+# GC-DAG: removing unused section many.o:(.text.dead0)
+# GC-DAG: removing unused section many.o:(.text.dead1999)
+
+# SYMS-DAG: t f0
+# SYMS-DAG: t f1999
+# SYMS-DAG: t h0
+# SYMS-DAG: t h1999
+# SYMS-NOT: dead
+
+# DYN: (NEEDED) Shared library: [shared.so]
+
+#--- gen.py
+N = 2000
+print('.globl _start')
+print('.section .text._start,"ax",@progbits')
+print('_start:')
+for i in range(N):
+    print(f'  call f{i}')
+print('  ret')
+for i in range(N):
+    print(f'.section .text.f{i},"ax",@progbits')
+    print(f'f{i}:')
+    print(f'  call h{i}')
+    if i % 2 == 0:
+        print(f'  leaq .Lstr{i}(%rip), %rax')
+    if i == N - 1:
+        print('  call shared_fn')
+    print('  ret')
+    print(f'.section .text.h{i},"ax",@progbits')
+    print(f'h{i}:')
+    print('  ret')
+    print(f'.section .text.dead{i},"ax",@progbits')
+    print(f'dead{i}:')
+    print(f'  call h{i}')
+    print(f'  leaq .Lstr{i}(%rip), %rax')
+    print('  ret')
+print('.section .rodata.str1.1,"aMS",@progbits,1')
+for i in range(N):
+    print(f'.Lstr{i}:')
+    print(f'  .asciz "string{i}"')
+
+#--- shared.s
+.globl shared_fn
+.type shared_fn,@function
+shared_fn:
+  ret
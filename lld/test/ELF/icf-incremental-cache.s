@@ -0,0 +1,76 @@
+# REQUIRES: x86
+## Test that ICF seeded from the summary saved in --incremental-cache folds
+## the same sections as ICF from scratch.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 a.s -o a.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b.s -o b.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b2.s -o b2.o
+
+# RUN: ld.lld --icf=all --print-icf-sections a.o b.o -o ref | \
+# RUN:   FileCheck %s --check-prefix=FOLD
+# RUN: ld.lld --icf=all --print-icf-sections --incremental-cache=cache \
+# RUN:   --verbose a.o b.o -o out1 2>&1 | FileCheck %s --check-prefix=FOLD
+# RUN: ld.lld --icf=all --print-icf-sections --incremental-cache=cache \
+# RUN:   --verbose a.o b.o -o out2 2>&1 | \
+# RUN:   FileCheck %s --check-prefixes=FOLD,SUMMARY
+# RUN: cmp ref out1
+# RUN: cmp ref out2
+
+# SUMMARY-DAG: ICF summary: reused classes of {{[1-9][0-9]*}} of {{[0-9]+}} sections
+# FOLD-DAG: removing identical section b.o:(.text.f2)
+# FOLD-DAG: removing identical section b.o:(.text.g2)
+
+## After f2 changes, neither f2 nor g2, which calls it, is folded any more.
+# RUN: ld.lld --icf=all --print-icf-sections a.o b2.o -o ref2 | \
+# RUN:   FileCheck %s --check-prefix=CHANGED --allow-empty
+# RUN: ld.lld --icf=all --print-icf-sections --incremental-cache=cache \
+# RUN:   a.o b2.o -o out3 | FileCheck %s --check-prefix=CHANGED --allow-empty
+# RUN: cmp ref2 out3
+
+# CHANGED-NOT: removing identical section
+
+#--- a.s
+.globl _start
+_start:
+  call g1
+  call g2
+  ret
+
+.section .text.f1,"ax",@progbits
+.globl f1
+f1:
+  movl $1, %eax
+  ret
+
+.section .text.g1,"ax",@progbits
+.globl g1
+g1:
+  call f1
+  ret
+
+#--- b.s
+.section .text.f2,"ax",@progbits
+.globl f2
+f2:
+  movl $1, %eax
+  ret
+
+.section .text.g2,"ax",@progbits
+.globl g2
+g2:
+  call f2
+  ret
+
+#--- b2.s
+.section .text.f2,"ax",@progbits
+.globl f2
+f2:
+  movl $2, %eax
+  ret
+
+.section .text.g2,"ax",@progbits
+.globl g2
+g2:
+  call f2
+  ret
@@ -0,0 +1,55 @@
+# REQUIRES: x86, zlib
+## Test that --incremental-cache reuses compressed debug section shards, and
+## that the output is the same as without the cache.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 a.s -o a.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b.s -o b.o
+
+# RUN: ld.lld --compress-debug-sections=zlib a.o -o ref
+# RUN: ld.lld --compress-debug-sections=zlib --incremental-cache=cache a.o \
+# RUN:   -o out1
+# RUN: cmp ref out1
+# RUN: ls cache | FileCheck %s --check-prefix=ENTRIES
+# ENTRIES: zlib-
+
+## The shards are read back from the cache.
+# RUN: ld.lld --compress-debug-sections=zlib --incremental-cache=cache a.o \
+# RUN:   -o out2
+# RUN: cmp ref out2
+
+## A different compression level does not use the shards of another level.
+# RUN: ld.lld --compress-sections=.debug_str=zlib:9 a.o -o ref-9
+# RUN: ld.lld --compress-sections=.debug_str=zlib:9 --incremental-cache=cache \
+# RUN:   a.o -o out3
+# RUN: cmp ref-9 out3
+# RUN: ls cache | FileCheck %s --check-prefix=LEVEL
+# LEVEL: zlib-9-
+
+## Changed debug info is compressed again.
+# RUN: ld.lld --compress-debug-sections=zlib b.o -o ref-b
+# RUN: ld.lld --compress-debug-sections=zlib --incremental-cache=cache b.o \
+# RUN:   -o out4
+# RUN: cmp ref-b out4
+# RUN: llvm-readelf -S out4 | FileCheck %s --check-prefix=SEC
+# SEC: .debug_str {{.*}} MSC
+
+#--- a.s
+.globl _start
+_start:
+  ret
+
+.section .debug_str,"MS",@progbits,1
+.asciz "unchanged string"
+.fill 4096, 1, 0x61
+.byte 0
+
+#--- b.s
+.globl _start
+_start:
+  ret
+
+.section .debug_str,"MS",@progbits,1
+.asciz "changed string"
+.fill 4096, 1, 0x62
+.byte 0
@@ -0,0 +1,61 @@
+# REQUIRES: x86
+## Test that --incremental-cache reuses the contents of unchanged output
+## sections, and that the output is the same as without the cache.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 a.s -o a.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b.s -o b.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 b2.s -o b2.o
+
+# RUN: ld.lld a.o b.o -o ref
+# RUN: ld.lld --incremental-cache=cache --verbose a.o b.o -o out1 2>&1 | \
+# RUN:   FileCheck %s --check-prefix=MISS
+# RUN: cmp ref out1
+# RUN: ld.lld --incremental-cache=cache --verbose a.o b.o -o out2 2>&1 | \
+# RUN:   FileCheck %s --check-prefix=HIT
+# RUN: cmp ref out2
+
+# MISS: incremental cache: reused 0 of {{[0-9]+}} output sections
+# HIT: incremental cache: reused {{[1-9][0-9]*}} of {{[0-9]+}} output sections
+
+## A changed input section, and a relocation whose target moved, are not
+## served from the cache.
+# RUN: ld.lld a.o b2.o -o ref2
+# RUN: ld.lld --incremental-cache=cache a.o b2.o -o out3
+# RUN: cmp ref2 out3
+
+## An unusable cache directory is only a warning, and the link goes ahead
+## without the cache.
+# RUN: touch not-a-dir
+# RUN: ld.lld --incremental-cache=not-a-dir/cache a.o b2.o -o out4 2>&1 | \
+# RUN:   FileCheck %s --check-prefix=NODIR
+# RUN: cmp ref2 out4
+# NODIR: warning: cannot create incremental cache directory not-a-dir/cache
+
+# RUN: not ld.lld -r --incremental-cache=cache a.o -o /dev/null 2>&1 | \
+# RUN:   FileCheck %s --check-prefix=RELOCATABLE
+# RELOCATABLE: error: -r and --incremental-cache may not be used together
+
+#--- a.s
+.globl _start
+_start:
+  call foo
+  movq data(%rip), %rax
+  ret
+
+.data
+data:
+  .quad foo
+
+#--- b.s
+.globl foo
+foo:
+  ret
+
+#--- b2.s
+.globl foo
+  nop
+  nop
+foo:
+  xorl %eax, %eax
+  ret
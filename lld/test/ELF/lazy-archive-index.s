@@ -0,0 +1,70 @@
+# REQUIRES: x86
+## Test that --lazy-archive-index extracts the same archive members as the
+## default path, using the names in the archive symbol table.
+
+# RUN: rm -rf %t && split-file %s %t && cd %t
+# RUN: llvm-mc -filetype=obj -triple=x86_64 main.s -o main.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 foo.s -o foo.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 bar.s -o bar.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 unused.s -o unused.o
+# RUN: llvm-mc -filetype=obj -triple=x86_64 nosym.s -o nosym.o
+# RUN: llvm-ar rc lib.a foo.o bar.o unused.o nosym.o
+# RUN: llvm-ar rcS noindex.a foo.o bar.o unused.o nosym.o
+
+## Only foo.o and bar.o, which it references, are extracted.
+# RUN: ld.lld --lazy-archive-index --trace main.o lib.a -o lazy | \
+# RUN:   FileCheck %s --check-prefix=TRACE
+# TRACE:      main.o
+# TRACE-NEXT: lib.a(foo.o)
+# TRACE-NEXT: lib.a(bar.o)
+# TRACE-NOT:  {{.}}
+
+# RUN: ld.lld main.o lib.a -o default
+# RUN: cmp default lazy
+# RUN: llvm-nm lazy | FileCheck %s --check-prefix=SYMS
+# SYMS-NOT: unused
+# SYMS:     T bar
+# SYMS-NOT: unused
+# SYMS:     T foo
+# SYMS-NOT: unused
+
+## The last of --lazy-archive-index and --no-lazy-archive-index wins.
+# RUN: ld.lld --lazy-archive-index --no-lazy-archive-index main.o lib.a -o no
+# RUN: cmp default no
+
+## An archive without a symbol table uses the existing scanning path.
+# RUN: ld.lld --lazy-archive-index --trace main.o noindex.a -o noindex | \
+# RUN:   FileCheck %s --check-prefix=NOINDEX
+# NOINDEX:      main.o
+# NOINDEX-NEXT: noindex.a(foo.o)
+# NOINDEX-NEXT: noindex.a(bar.o)
+# RUN: cmp default noindex
+
+## A member is still extracted for a symbol that is only named by -u.
+# RUN: ld.lld --lazy-archive-index --trace -u unused main.o lib.a -o /dev/null | \
+# RUN:   FileCheck %s --check-prefix=UNDEF
+# UNDEF: lib.a(unused.o)
+
+#--- main.s
+.globl _start
+_start:
+  call foo
+
+#--- foo.s
+.globl foo
+foo:
+  call bar
+
+#--- bar.s
+.globl bar
+bar:
+  ret
+
+#--- unused.s
+.globl unused
+unused:
+  ret
+
+#--- nosym.s
+local:
+  ret
@@ -0,0 +1,55 @@
+; REQUIRES: x86
+;; --lto-cache-partitions caches the object of every full LTO partition in the
+;; --thinlto-cache-dir directory, and later links take them from there.
+
+; RUN: rm -rf %t && split-file %s %t && cd %t
+; RUN: llvm-as -o a.bc a.ll
+; RUN: llvm-mc -filetype=obj -triple=x86_64-unknown-linux-gnu -o tampered.o tampered.s
+
+;; With two partitions the first link adds two entries.
+; RUN: ld.lld --lto-partitions=2 --lto-cache-partitions --thinlto-cache-dir=cache \
+; RUN:   -shared -o out.so a.bc
+; RUN: ls cache | count 2
+; RUN: llvm-nm --defined-only out.so | FileCheck %s
+
+;; Without changes, the second link hits both entries and adds no new ones.
+; RUN: ld.lld --lto-partitions=2 --lto-cache-partitions --thinlto-cache-dir=cache \
+; RUN:   -shared -o out.so a.bc
+; RUN: ls cache | count 2
+; RUN: llvm-nm --defined-only out.so | FileCheck %s
+
+;; Replace both entries with an object that only defines a weak symbol. Since
+;; neither partition is code generated again, none of the functions from a.bc
+;; are left in the output.
+; RUN: %python -c "import glob, shutil; [shutil.copy('tampered.o', f) for f in glob.glob('cache/llvmcache-*')]"
+; RUN: ld.lld --lto-partitions=2 --lto-cache-partitions --thinlto-cache-dir=cache \
+; RUN:   -shared -o out.so a.bc
+; RUN: llvm-nm --defined-only out.so | FileCheck %s --check-prefix=TAMPERED
+
+; CHECK-DAG: T large
+; CHECK-DAG: T small
+
+; TAMPERED:     W tampered
+; TAMPERED-NOT: large
+; TAMPERED-NOT: small
+
+;--- a.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @large(i32 %x) {
+  %a = add i32 %x, 1
+  %b = mul i32 %a, %x
+  %c = sdiv i32 %b, 3
+  ret i32 %c
+}
+
+define void @small() {
+  ret void
+}
+
+;--- tampered.s
+.weak tampered
+.type tampered,@function
+tampered:
+  ret
@@ -0,0 +1,51 @@
+; REQUIRES: x86
+;; --lto-cost-balanced-partitions balances the codegen partitions by
+;; instruction count: the large function gets a partition to itself and the
+;; small functions share the other one.
+
+; RUN: rm -rf %t && mkdir %t && cd %t
+; RUN: llvm-as -o a.bc %s
+; RUN: ld.lld --lto-O0 --lto-partitions=2 --lto-cost-balanced-partitions \
+; RUN:   -save-temps -shared -o out.so a.bc
+; RUN: llvm-nm --defined-only out.so.lto.o | FileCheck %s --check-prefix=PART0
+; RUN: llvm-nm --defined-only out.so.lto.1.o | FileCheck %s --check-prefix=PART1
+
+; PART0:     T large
+; PART0-NOT: small
+
+; PART1-DAG: T small1
+; PART1-DAG: T small2
+; PART1-DAG: T small3
+; PART1-DAG: T small4
+; PART1-NOT: large
+
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @large(i32 %x) {
+  %a = add i32 %x, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = add i32 %c, 4
+  %e = add i32 %d, 5
+  %f = add i32 %e, 6
+  %g = add i32 %f, 7
+  %h = add i32 %g, 8
+  ret i32 %h
+}
+
+define void @small1() {
+  ret void
+}
+
+define void @small2() {
+  ret void
+}
+
+define void @small3() {
+  ret void
+}
+
+define void @small4() {
+  ret void
+}
@@ -0,0 +1,36 @@
+; REQUIRES: x86
+;; Test that --thinlto-distributor= hands the backend compiles to an external
+;; program. llvm/test/tools/llvm-lto2/thinlto-distributor.ll covers the jobs
+;; file and the native objects.
+
+; RUN: rm -rf %t && split-file %s %t && cd %t
+; RUN: opt -module-summary main.ll -o main.bc
+; RUN: opt -module-summary foo.ll -o foo.bc
+
+; RUN: not ld.lld main.bc foo.bc -o out --thinlto-distributor=%python \
+; RUN:   --thinlto-distributor-arg=-c --thinlto-distributor-arg='exit(3)' \
+; RUN:   2>&1 | FileCheck %s --check-prefix=FAIL
+; FAIL: error: ThinLTO distributor '{{.*}}' failed with exit code 3
+
+; RUN: not ld.lld main.bc foo.bc -o out --thinlto-distributor=%python \
+; RUN:   --thinlto-index-only 2>&1 | FileCheck %s --check-prefix=INDEX-ONLY
+; INDEX-ONLY: error: --thinlto-distributor= may not be used with --thinlto-index-only
+
+;--- main.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @foo()
+
+define void @_start() {
+  call void @foo()
+  ret void
+}
+
+;--- foo.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @foo() {
+  ret void
+}
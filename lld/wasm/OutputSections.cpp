@@ -53,10 +53,14 @@ void CodeSection::finalizeContents() {
   os.flush();
   bodySize = codeSectionHeader.size();
 
+  // Computing the compressed size of a function requires evaluating each of
+  // its relocations, which is independent across functions.
+  parallelForEach(functions,
+                  [](InputFunction *func) { func->calculateSize(); });
+
   for (InputFunction *func : functions) {
     func->outputSec = this;
     func->outSecOff = bodySize;
-    func->calculateSize();
     // All functions should have a non-empty body at this point
     assert(func->getSize());
     bodySize += func->getSize();
@@ -227,6 +227,15 @@ public:
 
   void LogUUIDAndPaths(Log *log, const char *prefix_cstr);
 
+  /// Preload the symbols of all modules in this list.
+  ///
+  /// The modules are preloaded in parallel on the debugger's thread pool.
+  /// Executables are started first so their symbols, which are usually needed
+  /// first, are available as early as possible.
+  ///
+  /// \see Module::PreloadSymbols()
+  void PreloadSymbols() const;
+
   std::recursive_mutex &GetMutex() const { return m_modules_mutex; }
 
   size_t GetIndexForModule(const Module *module) const;
@@ -26,6 +26,7 @@
 #include "lldb/lldb-types.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 
@@ -901,9 +902,11 @@ protected:
     }
 
   private:
-    typedef std::map<size_t, ValueObject *> ChildrenMap;
+    // Containers can have millions of children, of which usually only a
+    // small window is ever materialized; keep the per-child overhead small.
+    typedef llvm::DenseMap<size_t, ValueObject *> ChildrenMap;
     typedef ChildrenMap::iterator ChildrenIterator;
-    typedef ChildrenMap::value_type ChildrenPair;
+    typedef std::pair<size_t, ValueObject *> ChildrenPair;
     std::recursive_mutex m_mutex;
     ChildrenMap m_children;
     size_t m_children_count = 0;
@@ -17,6 +17,8 @@
 #include "lldb/lldb-forward.h"
 #include "lldb/lldb-private-enumerations.h"
 
+#include "llvm/ADT/DenseMap.h"
+
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -139,8 +141,8 @@ protected:
   lldb::SyntheticChildrenSP m_synth_sp;
   std::unique_ptr<SyntheticChildrenFrontEnd> m_synth_filter_up;
 
-  typedef std::map<uint32_t, ValueObject *> ByIndexMap;
-  typedef std::map<const char *, uint32_t> NameToIndexMap;
+  typedef llvm::DenseMap<uint32_t, ValueObject *> ByIndexMap;
+  typedef llvm::DenseMap<const char *, uint32_t> NameToIndexMap;
   typedef std::vector<lldb::ValueObjectSP> SyntheticChildrenCache;
 
   typedef ByIndexMap::iterator ByIndexIterator;
@@ -612,6 +612,22 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Defers preloading of symbols for modules created by GetOrCreateModule.
+  ///
+  /// While an instance is alive, modules created by GetOrCreateModule are
+  /// remembered instead of having their symbols preloaded one after the
+  /// other. When the last instance goes away, all of them are preloaded in
+  /// parallel. Dynamic loaders use this when they add many shared libraries
+  /// at once, before notifying the target about them.
+  class DeferredSymbolPreload {
+  public:
+    DeferredSymbolPreload(Target &target);
+    ~DeferredSymbolPreload();
+
+  private:
+    Target &m_target;
+  };
+
   // Settings accessors
 
   static TargetProperties &GetGlobalProperties();
@@ -1552,6 +1568,10 @@ protected:
   std::string m_label;
   ModuleList m_images; ///< The list of images for this process (shared
                        /// libraries and anything dynamically loaded).
+  /// Modules whose symbol preloading was deferred by DeferredSymbolPreload.
+  ModuleList m_deferred_preload_modules;
+  uint32_t m_deferred_preload_count = 0;
+  std::mutex m_deferred_preload_mutex;
   SectionLoadHistory m_section_load_history;
   BreakpointList m_breakpoint_list;
   BreakpointList m_internal_breakpoint_list;
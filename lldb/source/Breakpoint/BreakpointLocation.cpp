@@ -18,7 +18,11 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/TypeSystem.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadSpec.h"
@@ -26,6 +30,8 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/StreamString.h"
 
+#include <limits>
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -223,6 +229,155 @@ const char *BreakpointLocation::GetConditionText(size_t *hash) const {
       .GetConditionText(hash);
 }
 
+/// Try to evaluate a condition of the form "<variable path>" or
+/// "<variable path> <comparison> <integer literal>" by reading the variable
+/// directly, the way "frame variable" does, instead of running the expression
+/// parser. Conditions like "i == 42" on hot breakpoints are very common and
+/// compiling them into an expression on every hit is expensive.
+///
+/// \return
+///     The value of the condition, or std::nullopt if it isn't that simple
+///     or can't be evaluated this way, in which case the caller must use the
+///     expression parser.
+static std::optional<bool> EvaluateSimpleCondition(llvm::StringRef condition,
+                                                   ExecutionContext &exe_ctx) {
+  StackFrame *frame = exe_ctx.GetFramePtr();
+  if (!frame)
+    return std::nullopt;
+
+  condition = condition.trim();
+  if (condition.empty() ||
+      !(llvm::isAlpha(condition[0]) || condition[0] == '_'))
+    return std::nullopt;
+
+  // Split off the variable path, which may contain member accesses and
+  // constant array subscripts.
+  size_t pos = 0;
+  while (pos < condition.size()) {
+    char c = condition[pos];
+    if (llvm::isAlnum(c) || c == '_' || c == '.' || c == '[' || c == ']')
+      ++pos;
+    else if (condition.substr(pos).starts_with("->"))
+      pos += 2;
+    else
+      break;
+  }
+  llvm::StringRef var_path = condition.take_front(pos);
+  llvm::StringRef rest = condition.drop_front(pos).trim();
+
+  llvm::StringRef op;
+  for (llvm::StringRef candidate : {"==", "!=", "<=", ">=", "<", ">"}) {
+    if (rest.consume_front(candidate)) {
+      op = candidate;
+      break;
+    }
+  }
+  if (op.empty() && !rest.empty())
+    return std::nullopt;
+
+  int64_t signed_literal = 0;
+  uint64_t unsigned_literal = 0;
+  bool literal_is_negative = false;
+  if (!op.empty()) {
+    rest = rest.trim();
+    if (!rest.getAsInteger(0, unsigned_literal))
+      signed_literal = static_cast<int64_t>(unsigned_literal);
+    else if (!rest.getAsInteger(0, signed_literal))
+      literal_is_negative = true;
+    else
+      return std::nullopt;
+  }
+
+  // The expression parser resolves the leading name with the language's
+  // lookup rules, which "frame variable" doesn't implement. Only go ahead if
+  // exactly one variable in scope has that name, and if it isn't a global
+  // that a member of "this" or "self" could hide.
+  ConstString root_name(var_path.take_until(
+      [](char c) { return c == '.' || c == '-' || c == '['; }));
+  VariableListSP var_list_sp = frame->GetInScopeVariableList(true);
+  if (!var_list_sp)
+    return std::nullopt;
+  VariableSP root_var_sp;
+  for (const VariableSP &candidate : *var_list_sp) {
+    if (!candidate || candidate->GetName() != root_name)
+      continue;
+    if (root_var_sp)
+      return std::nullopt;
+    root_var_sp = candidate;
+  }
+  if (!root_var_sp)
+    return std::nullopt;
+  ValueType root_scope = root_var_sp->GetScope();
+  if (root_scope != eValueTypeVariableLocal &&
+      root_scope != eValueTypeVariableArgument) {
+    SymbolContext sc =
+        frame->GetSymbolContext(eSymbolContextFunction | eSymbolContextBlock);
+    if (!sc.GetInstanceVariableName().empty())
+      return std::nullopt;
+  }
+
+  VariableSP var_sp;
+  Status error;
+  ValueObjectSP value_sp = frame->GetValueForVariableExpressionPath(
+      var_path, eNoDynamicValues,
+      StackFrame::eExpressionPathOptionsNoSyntheticChildren |
+          StackFrame::eExpressionPathOptionsNoFragileObjcIvar,
+      var_sp, error);
+  if (!value_sp || error.Fail() || var_sp != root_var_sp)
+    return std::nullopt;
+
+  CompilerType type = value_sp->GetCompilerType();
+  bool is_signed = false;
+  if (type.IsPointerType()) {
+    // Pointers can only be compared against a null pointer constant.
+    if (!op.empty() && (unsigned_literal != 0 || (op != "==" && op != "!=")))
+      return std::nullopt;
+  } else if (!type.IsIntegerOrEnumerationType(is_signed) ||
+             type.IsScopedEnumerationType()) {
+    return std::nullopt;
+  }
+  // Values wider than the literal can't be read as a 64-bit integer.
+  std::optional<uint64_t> byte_size = value_sp->GetByteSize();
+  if (!byte_size || *byte_size > sizeof(uint64_t))
+    return std::nullopt;
+  // The usual arithmetic conversions would turn a negative literal into a
+  // large unsigned value. A literal that doesn't fit in int may also have an
+  // unsigned type (hex and octal literals do as soon as they exceed the signed
+  // type of their size), which makes a comparison with a signed value
+  // unsigned. Only literals of type int compare the same way as the 64-bit
+  // comparison below; leave the rest to the expression parser.
+  if (literal_is_negative && !is_signed)
+    return std::nullopt;
+  if (literal_is_negative
+          ? signed_literal < std::numeric_limits<int>::min()
+          : unsigned_literal > uint64_t(std::numeric_limits<int>::max()))
+    return std::nullopt;
+
+  bool success = false;
+  int cmp;
+  if (is_signed) {
+    const int64_t value = value_sp->GetValueAsSigned(0, &success);
+    cmp = value < signed_literal ? -1 : (value > signed_literal ? 1 : 0);
+  } else {
+    const uint64_t value = value_sp->GetValueAsUnsigned(0, &success);
+    cmp = value < unsigned_literal ? -1 : (value > unsigned_literal ? 1 : 0);
+  }
+  if (!success)
+    return std::nullopt;
+
+  if (op.empty() || op == "!=")
+    return cmp != 0;
+  if (op == "==")
+    return cmp == 0;
+  if (op == "<")
+    return cmp < 0;
+  if (op == "<=")
+    return cmp <= 0;
+  if (op == ">")
+    return cmp > 0;
+  return cmp >= 0;
+}
+
 bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
                                            Status &error) {
   Log *log = GetLog(LLDBLog::Breakpoints);
@@ -239,6 +394,19 @@ bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
 
   error.Clear();
 
+  // Simple conditions in C family languages don't need the expression parser.
+  CompileUnit *cond_cu = m_address.CalculateSymbolContextCompileUnit();
+  if (cond_cu && Language::LanguageIsCFamily(cond_cu->GetLanguage())) {
+    if (std::optional<bool> result =
+            EvaluateSimpleCondition(condition_text, exe_ctx)) {
+      LLDB_LOGF(log,
+                "Condition evaluated without the expression parser, result is "
+                "%s.",
+                *result ? "true" : "false");
+      return *result;
+    }
+  }
+
   DiagnosticManager diagnostics;
 
   if (condition_hash != m_condition_hash || !m_user_expression_sp ||
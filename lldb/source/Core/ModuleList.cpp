@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Core/ModuleList.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
@@ -34,6 +35,7 @@
 #include "clang/Driver/Driver.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -650,6 +652,28 @@ void ModuleList::Dump(Stream *s) const {
     module_sp->Dump(s);
 }
 
+void ModuleList::PreloadSymbols() const {
+  std::vector<ModuleSP> modules;
+  {
+    std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    modules.assign(m_modules.begin(), m_modules.end());
+  }
+  if (modules.empty())
+    return;
+
+  std::stable_partition(modules.begin(), modules.end(),
+                        [](const ModuleSP &module_sp) {
+                          ObjectFile *objfile = module_sp->GetObjectFile();
+                          return objfile && objfile->GetType() ==
+                                                ObjectFile::eTypeExecutable;
+                        });
+
+  llvm::ThreadPoolTaskGroup task_group(Debugger::GetThreadPool());
+  for (const ModuleSP &module_sp : modules)
+    task_group.async([module_sp] { module_sp->PreloadSymbols(); });
+  task_group.wait();
+}
+
 void ModuleList::LogUUIDAndPaths(Log *log, const char *prefix_cstr) {
   if (log != nullptr) {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
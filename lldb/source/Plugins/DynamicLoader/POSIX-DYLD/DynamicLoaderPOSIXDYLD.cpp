@@ -437,6 +437,8 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
       E = m_rendezvous.end();
       m_initial_modules_added = true;
     }
+    std::optional<Target::DeferredSymbolPreload> deferred_preload;
+    deferred_preload.emplace(m_process->GetTarget());
     for (; I != E; ++I) {
       // Don't load a duplicate copy of ld.so if we have already loaded it
       // earlier in LoadInterpreterModule. If we instead loaded then unloaded it
@@ -465,6 +467,9 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
       loaded_modules.AppendIfNeeded(module_sp);
       new_modules.Append(module_sp);
     }
+    // Preload the symbols of the new modules before breakpoints are resolved
+    // in them.
+    deferred_preload.reset();
     m_process->GetTarget().ModulesDidLoad(new_modules);
   }
 
@@ -660,19 +665,24 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
-  for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
-    ModuleSP module_sp =
-        LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
-    if (module_sp.get()) {
-      LLDB_LOG(log, "LoadAllCurrentModules loading module: {0}",
-               I->file_spec.GetFilename());
-      module_list.Append(module_sp);
-    } else {
-      Log *log = GetLog(LLDBLog::DynamicLoader);
-      LLDB_LOGF(
-          log,
-          "DynamicLoaderPOSIXDYLD::%s failed loading module %s at 0x%" PRIx64,
-          __FUNCTION__, I->file_spec.GetPath().c_str(), I->base_addr);
+  {
+    // Preload the symbols of all modules in parallel once they are created,
+    // instead of one after the other as each of them is loaded.
+    Target::DeferredSymbolPreload deferred_preload(m_process->GetTarget());
+    for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
+      ModuleSP module_sp =
+          LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
+      if (module_sp.get()) {
+        LLDB_LOG(log, "LoadAllCurrentModules loading module: {0}",
+                 I->file_spec.GetFilename());
+        module_list.Append(module_sp);
+      } else {
+        Log *log = GetLog(LLDBLog::DynamicLoader);
+        LLDB_LOGF(log,
+                  "DynamicLoaderPOSIXDYLD::%s failed loading module %s at "
+                  "0x%" PRIx64,
+                  __FUNCTION__, I->file_spec.GetPath().c_str(), I->base_addr);
+      }
     }
   }
 
@@ -167,6 +167,12 @@ public:
     const uint32_t idx = ePropertyUseGPacketForReading;
     return GetPropertyAtIndexAs<bool>(idx, true);
   }
+
+  uint64_t GetJThreadsInfoMaxThreads() const {
+    const uint32_t idx = ePropertyJThreadsInfoMaxThreads;
+    return GetPropertyAtIndexAs<uint64_t>(
+        idx, g_processgdbremote_properties[idx].default_uint_value);
+  }
 };
 
 } // namespace
@@ -1177,6 +1183,8 @@ Status ProcessGDBRemote::WillResume() {
   m_continue_S_tids.clear();
   m_jstopinfo_sp.reset();
   m_jthreadsinfo_sp.reset();
+  m_jstopinfo_index.clear();
+  m_jthreadsinfo_index.clear();
   return Status();
 }
 
@@ -1560,35 +1568,40 @@ void ProcessGDBRemote::SetThreadPc(const ThreadSP &thread_sp, uint64_t index) {
   }
 }
 
-bool ProcessGDBRemote::GetThreadStopInfoFromJSON(
-    ThreadGDBRemote *thread, const StructuredData::ObjectSP &thread_infos_sp) {
-  // See if we got thread stop infos for all threads via the "jThreadsInfo"
-  // packet
-  if (thread_infos_sp) {
-    StructuredData::Array *thread_infos = thread_infos_sp->GetAsArray();
-    if (thread_infos) {
-      lldb::tid_t tid;
-      const size_t n = thread_infos->GetSize();
-      for (size_t i = 0; i < n; ++i) {
-        StructuredData::Dictionary *thread_dict =
-            thread_infos->GetItemAtIndex(i)->GetAsDictionary();
-        if (thread_dict) {
-          if (thread_dict->GetValueForKeyAsInteger<lldb::tid_t>(
-                  "tid", tid, LLDB_INVALID_THREAD_ID)) {
-            if (tid == thread->GetID())
-              return (bool)SetThreadStopInfo(thread_dict);
-          }
-        }
-      }
-    }
+void ProcessGDBRemote::IndexThreadInfos(
+    const StructuredData::ObjectSP &thread_infos_sp, ThreadInfoIndex &index) {
+  index.clear();
+  if (!thread_infos_sp)
+    return;
+  StructuredData::Array *thread_infos = thread_infos_sp->GetAsArray();
+  if (!thread_infos)
+    return;
+  const size_t n = thread_infos->GetSize();
+  index.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    StructuredData::Dictionary *thread_dict =
+        thread_infos->GetItemAtIndex(i)->GetAsDictionary();
+    lldb::tid_t tid;
+    if (thread_dict && thread_dict->GetValueForKeyAsInteger<lldb::tid_t>(
+                           "tid", tid, LLDB_INVALID_THREAD_ID))
+      index.try_emplace(tid, thread_dict);
   }
-  return false;
+}
+
+bool ProcessGDBRemote::GetThreadStopInfoFromJSON(
+    ThreadGDBRemote *thread, const ThreadInfoIndex &thread_infos) {
+  // See if we got thread stop infos for this thread via the "jThreadsInfo"
+  // packet or the "jstopinfo" stop reply key.
+  auto it = thread_infos.find(thread->GetID());
+  if (it == thread_infos.end())
+    return false;
+  return (bool)SetThreadStopInfo(it->second);
 }
 
 bool ProcessGDBRemote::CalculateThreadStopInfo(ThreadGDBRemote *thread) {
   // See if we got thread stop infos for all threads via the "jThreadsInfo"
   // packet
-  if (GetThreadStopInfoFromJSON(thread, m_jthreadsinfo_sp))
+  if (GetThreadStopInfoFromJSON(thread, m_jthreadsinfo_index))
     return true;
 
   // See if we got thread stop info for any threads valid stop info reasons
@@ -1598,7 +1611,7 @@ bool ProcessGDBRemote::CalculateThreadStopInfo(ThreadGDBRemote *thread) {
     // that have stop reasons, and if there is no entry for a thread, then it
     // has no stop reason.
     thread->GetRegisterContext()->InvalidateIfNeeded(true);
-    if (!GetThreadStopInfoFromJSON(thread, m_jstopinfo_sp)) {
+    if (!GetThreadStopInfoFromJSON(thread, m_jstopinfo_index)) {
       // If a thread is stopped at a breakpoint site, set that as the stop
       // reason even if it hasn't executed the breakpoint instruction yet.
       // We will silently step over the breakpoint when we resume execution
@@ -2198,6 +2211,7 @@ StateType ProcessGDBRemote::SetThreadStopInfo(StringExtractor &stop_packet) {
         // This JSON contains thread IDs and thread stop info for all threads.
         // It doesn't contain expedited registers, memory or queue info.
         m_jstopinfo_sp = StructuredData::ParseJSON(json);
+        IndexThreadInfos(m_jstopinfo_sp, m_jstopinfo_index);
       } else if (key.compare("hexname") == 0) {
         StringExtractor name_extractor(value);
         std::string name;
@@ -2542,7 +2556,22 @@ void ProcessGDBRemote::WillPublicStop() {
   // runtime queue information (iOS and MacOSX only), and more. Expediting
   // memory will help stack backtracing be much faster. Expediting registers
   // will make sure we don't have to read the thread registers for GPRs.
+  //
+  // With many threads the full info of every thread is far more than the
+  // stop needs, so skip it and let each thread fetch its stop info and
+  // registers on demand.
+  const uint64_t max_threads =
+      GetGlobalPluginProperties().GetJThreadsInfoMaxThreads();
+  if (max_threads && m_thread_ids.size() > max_threads) {
+    LLDB_LOG(GetLog(GDBRLog::Thread),
+             "skipping jThreadsInfo for {0} threads, fetching thread info on "
+             "demand",
+             m_thread_ids.size());
+    return;
+  }
+
   m_jthreadsinfo_sp = m_gdb_comm.GetThreadsInfo();
+  IndexThreadInfos(m_jthreadsinfo_sp, m_jthreadsinfo_index);
 
   if (m_jthreadsinfo_sp) {
     // Now set the stop info for each thread and also expedite any registers
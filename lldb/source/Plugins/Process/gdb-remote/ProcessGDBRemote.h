@@ -280,6 +280,13 @@ protected:
                                               // registers and memory for all
                                               // threads if "jThreadsInfo"
                                               // packet is supported
+  /// Thread info dictionaries of m_jstopinfo_sp and m_jthreadsinfo_sp by
+  /// thread ID, so that looking up the stop info of each thread doesn't scan
+  /// the info of all other threads.
+  typedef llvm::DenseMap<lldb::tid_t, StructuredData::Dictionary *>
+      ThreadInfoIndex;
+  ThreadInfoIndex m_jstopinfo_index;
+  ThreadInfoIndex m_jthreadsinfo_index;
   tid_collection m_continue_c_tids;           // 'c' for continue
   tid_sig_collection m_continue_C_tids;       // 'C' for continue with signal
   tid_collection m_continue_s_tids;           // 's' for step
@@ -358,9 +365,11 @@ protected:
 
   lldb::StateType SetThreadStopInfo(StringExtractor &stop_packet);
 
-  bool
-  GetThreadStopInfoFromJSON(ThreadGDBRemote *thread,
-                            const StructuredData::ObjectSP &thread_infos_sp);
+  bool GetThreadStopInfoFromJSON(ThreadGDBRemote *thread,
+                                 const ThreadInfoIndex &thread_infos);
+
+  static void IndexThreadInfos(const StructuredData::ObjectSP &thread_infos_sp,
+                               ThreadInfoIndex &index);
 
   lldb::ThreadSP SetThreadStopInfo(StructuredData::Dictionary *thread_dict);
 
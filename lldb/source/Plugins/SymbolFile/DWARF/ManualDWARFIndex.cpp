@@ -84,13 +84,22 @@ void ManualDWARFIndex::Index() {
   // caused us to load the unit's DIEs.
   std::vector<std::optional<DWARFUnit::ScopedExtractDIEs>> clear_cu_dies(
       units_to_index.size());
+  // Units whose .dwo file index was loaded from the index cache. These don't
+  // need their DIEs extracted or indexed again.
+  std::vector<uint8_t> from_cache(units_to_index.size(), 0);
   auto parser_fn = [&](size_t cu_idx) {
-    IndexUnit(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]);
+    if (!from_cache[cu_idx]) {
+      IndexUnit(*units_to_index[cu_idx], dwp_dwarf, sets[cu_idx]);
+      SaveDwoToCache(*units_to_index[cu_idx], sets[cu_idx]);
+    }
     progress.Increment();
   };
 
   auto extract_fn = [&](size_t cu_idx) {
-    clear_cu_dies[cu_idx] = units_to_index[cu_idx]->ExtractDIEsScoped();
+    if (LoadDwoFromCache(*units_to_index[cu_idx], sets[cu_idx]))
+      from_cache[cu_idx] = 1;
+    else
+      clear_cu_dies[cu_idx] = units_to_index[cu_idx]->ExtractDIEsScoped();
     progress.Increment();
   };
 
@@ -735,3 +744,95 @@ void ManualDWARFIndex::SaveToCache() {
       m_dwarf->SetDebugInfoIndexWasSavedToCache();
   }
 }
+
+/// Return the .dwo symbol file for \a unit if its index can be cached
+/// separately from the main module, or nullptr otherwise. Split units that
+/// live in a .dwp file are covered by the module's own index cache.
+static SymbolFileDWARFDwo *GetCacheableDwo(DWARFUnit &unit,
+                                           SymbolFileDWARFDwo *dwp) {
+  if (!unit.GetDWOId())
+    return nullptr;
+  SymbolFileDWARFDwo *dwo = unit.GetDwoSymbolFile();
+  if (!dwo || dwo == dwp || !dwo->GetObjectFile())
+    return nullptr;
+  return dwo;
+}
+
+std::string ManualDWARFIndex::GetDwoCacheKey(DWARFUnit &unit,
+                                             SymbolFileDWARFDwo &dwo) {
+  std::string key;
+  llvm::raw_string_ostream strm(key);
+  ObjectFile *objfile = dwo.GetObjectFile();
+  strm << objfile->GetFileSpec().GetFilename() << "-dwo-index-"
+       << llvm::format_hex(unit.GetDWOId().value_or(0), 18) << "-"
+       << llvm::format_hex(objfile->GetCacheHash(), 10);
+  return strm.str();
+}
+
+bool ManualDWARFIndex::LoadDwoFromCache(DWARFUnit &unit, IndexSet &set) {
+  DataFileCache *cache = Module::GetIndexCache();
+  if (!cache)
+    return false;
+  SymbolFileDWARFDwo *dwo =
+      GetCacheableDwo(unit, m_dwarf->GetDwpSymbolFile().get());
+  if (!dwo)
+    return false;
+  ObjectFile *objfile = dwo->GetObjectFile();
+  const std::string key = GetDwoCacheKey(unit, *dwo);
+  std::unique_ptr<llvm::MemoryBuffer> mem_buffer_up =
+      cache->GetCachedData(key);
+  if (!mem_buffer_up)
+    return false;
+  DataExtractor data(mem_buffer_up->getBufferStart(),
+                     mem_buffer_up->getBufferSize(),
+                     endian::InlHostByteOrder(),
+                     objfile->GetAddressByteSize());
+  lldb::offset_t offset = 0;
+  CacheSignature signature;
+  if (!signature.Decode(data, &offset))
+    return false;
+  if (CacheSignature(objfile) != signature) {
+    cache->RemoveCacheFile(key);
+    return false;
+  }
+  IndexSet cached;
+  if (!cached.Decode(data, &offset))
+    return false;
+  // The DIERefs were encoded with the file index the .dwo had when the cache
+  // was written. That index is derived from the skeleton unit in the main
+  // executable, which can change when the executable is relinked.
+  const std::optional<uint64_t> file_index = dwo->GetFileIndex();
+  set.function_basenames.AppendWithFileIndex(cached.function_basenames,
+                                             file_index);
+  set.function_fullnames.AppendWithFileIndex(cached.function_fullnames,
+                                             file_index);
+  set.function_methods.AppendWithFileIndex(cached.function_methods,
+                                           file_index);
+  set.function_selectors.AppendWithFileIndex(cached.function_selectors,
+                                             file_index);
+  set.objc_class_selectors.AppendWithFileIndex(cached.objc_class_selectors,
+                                               file_index);
+  set.globals.AppendWithFileIndex(cached.globals, file_index);
+  set.types.AppendWithFileIndex(cached.types, file_index);
+  set.namespaces.AppendWithFileIndex(cached.namespaces, file_index);
+  return true;
+}
+
+void ManualDWARFIndex::SaveDwoToCache(DWARFUnit &unit, const IndexSet &set) {
+  DataFileCache *cache = Module::GetIndexCache();
+  if (!cache)
+    return; // Caching is not enabled.
+  SymbolFileDWARFDwo *dwo =
+      GetCacheableDwo(unit, m_dwarf->GetDwpSymbolFile().get());
+  if (!dwo)
+    return;
+  ObjectFile *objfile = dwo->GetObjectFile();
+  DataEncoder file(endian::InlHostByteOrder(), objfile->GetAddressByteSize());
+  // Encode will return false if the object file doesn't have anything to make
+  // a signature from.
+  CacheSignature signature(objfile);
+  if (!signature.Encode(file))
+    return;
+  set.Encode(file);
+  cache->SetCachedData(GetDwoCacheKey(unit, *dwo), file.GetData());
+}
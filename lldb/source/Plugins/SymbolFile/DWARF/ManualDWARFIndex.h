@@ -160,6 +160,23 @@ private:
   ///   false if the symbol table wasn't cached or was out of date.
   bool LoadFromCache();
 
+  /// Get the index cache key for the .dwo file referenced by \a unit.
+  ///
+  /// The key only depends on the .dwo file itself, so a cached .dwo index
+  /// stays valid when the main executable is relinked.
+  std::string GetDwoCacheKey(DWARFUnit &unit, SymbolFileDWARFDwo &dwo);
+
+  /// Load the index entries for the .dwo file of the skeleton unit \a unit
+  /// from the index cache into \a set.
+  ///
+  /// \return
+  ///   True if the entries were found in the cache and are up to date.
+  bool LoadDwoFromCache(DWARFUnit &unit, IndexSet &set);
+
+  /// Save the index entries \a set for the .dwo file of the skeleton unit
+  /// \a unit into the index cache.
+  void SaveDwoToCache(DWARFUnit &unit, const IndexSet &set);
+
   void IndexUnit(DWARFUnit &unit, SymbolFileDWARFDwo *dwp, IndexSet &set);
 
   static void IndexUnitImpl(DWARFUnit &unit,
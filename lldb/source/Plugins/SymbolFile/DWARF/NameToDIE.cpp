@@ -92,6 +92,16 @@ void NameToDIE::Append(const NameToDIE &other) {
   }
 }
 
+void NameToDIE::AppendWithFileIndex(const NameToDIE &other,
+                                    std::optional<uint32_t> file_index) {
+  const uint32_t size = other.m_map.GetSize();
+  for (uint32_t i = 0; i < size; ++i) {
+    const DIERef &ref = other.m_map.GetValueRefAtIndexUnchecked(i);
+    m_map.Append(other.m_map.GetCStringAtIndexUnchecked(i),
+                 DIERef(file_index, ref.section(), ref.die_offset()));
+  }
+}
+
 constexpr llvm::StringLiteral kIdentifierNameToDIE("N2DI");
 
 bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
@@ -32,6 +32,12 @@ public:
 
   void Append(const NameToDIE &other);
 
+  /// Append all entries from \a other, rewriting the file index of every
+  /// DIERef to \a file_index. Used when entries were produced for a .dwo file
+  /// whose file index in the current debug session may have changed.
+  void AppendWithFileIndex(const NameToDIE &other,
+                           std::optional<uint32_t> file_index);
+
   void Finalize();
 
   bool Find(ConstString name,
@@ -3081,6 +3081,18 @@ SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext(const DWARFDIE &die) {
     }
 
     const DWARFDeclContext die_dwarf_decl_ctx = die.GetDWARFDeclContext();
+
+    // Classes and structures resolve to each other, so use one tag for both.
+    const dw_tag_t cache_tag = IsStructOrClassTag(tag) ? DW_TAG_class_type : tag;
+    std::string cache_key =
+        llvm::formatv("{0}:{1}:{2}{3}", cache_tag, static_cast<int>(language),
+                      die_dwarf_decl_ctx.GetQualifiedName(),
+                      template_params.GetStringRef())
+            .str();
+    auto cached = m_definition_type_cache.find(cache_key);
+    if (cached != m_definition_type_cache.end())
+      return cached->second;
+
     m_index->GetFullyQualifiedType(die_dwarf_decl_ctx, [&](DWARFDIE type_die) {
       // Make sure type_die's language matches the type system we are
       // looking for. We don't want to find a "Foo" type from Java if we
@@ -3147,6 +3159,8 @@ SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext(const DWARFDIE &die) {
       type_sp = resolved_type->shared_from_this();
       return false;
     });
+    if (type_sp)
+      m_definition_type_cache[cache_key] = type_sp;
   }
   return type_sp;
 }
@@ -532,6 +532,11 @@ protected:
   DIEToTypePtr m_die_to_type;
   DIEToVariableSP m_die_to_variable_sp;
   CompilerTypeToDIE m_forward_decl_compiler_type_to_die;
+  /// Definitions found by FindDefinitionTypeForDWARFDeclContext, keyed by the
+  /// tag, language and fully qualified name of the declaration. Every compile
+  /// unit that uses a type such as std::string carries its own declaration of
+  /// it, and without this each of them repeats the same index lookup.
+  llvm::StringMap<lldb::TypeSP> m_definition_type_cache;
   llvm::DenseMap<dw_offset_t, std::unique_ptr<SupportFileList>>
       m_type_unit_support_files;
   std::vector<uint32_t> m_lldb_cu_to_dwarf_unit;
@@ -1687,6 +1687,24 @@ void Target::NotifyModulesRemoved(lldb_private::ModuleList &module_list) {
   ModulesDidUnload(module_list, false);
 }
 
+Target::DeferredSymbolPreload::DeferredSymbolPreload(Target &target)
+    : m_target(target) {
+  std::lock_guard<std::mutex> guard(m_target.m_deferred_preload_mutex);
+  ++m_target.m_deferred_preload_count;
+}
+
+Target::DeferredSymbolPreload::~DeferredSymbolPreload() {
+  ModuleList modules;
+  {
+    std::lock_guard<std::mutex> guard(m_target.m_deferred_preload_mutex);
+    if (--m_target.m_deferred_preload_count)
+      return;
+    modules.Swap(m_target.m_deferred_preload_modules);
+  }
+  // Preload outside of the lock so other modules can be created meanwhile.
+  modules.PreloadSymbols();
+}
+
 void Target::ModulesDidLoad(ModuleList &module_list) {
   const size_t num_images = module_list.GetSize();
   if (m_valid && num_images) {
@@ -2313,8 +2331,15 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
 
         // Preload symbols outside of any lock, so hopefully we can do this for
         // each library in parallel.
-        if (GetPreloadSymbols())
-          module_sp->PreloadSymbols();
+        if (GetPreloadSymbols()) {
+          std::unique_lock<std::mutex> lock(m_deferred_preload_mutex);
+          if (m_deferred_preload_count) {
+            m_deferred_preload_modules.AppendIfNeeded(module_sp);
+          } else {
+            lock.unlock();
+            module_sp->PreloadSymbols();
+          }
+        }
         llvm::SmallVector<ModuleSP, 1> replaced_modules;
         for (ModuleSP &old_module_sp : old_modules) {
           if (m_images.GetIndexForModule(old_module_sp.get()) !=
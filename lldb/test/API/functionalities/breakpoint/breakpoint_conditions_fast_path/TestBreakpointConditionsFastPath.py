@@ -0,0 +1,94 @@
+"""
+Test that simple breakpoint conditions, which are evaluated without the
+expression parser, follow the language's lookup and conversion rules.
+"""
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class BreakpointConditionsFastPathTestCase(TestBase):
+    def launch_with_condition(self, pattern, condition):
+        self.build()
+        target = self.createTestTarget()
+        bkpt = target.BreakpointCreateBySourceRegex(
+            pattern, lldb.SBFileSpec("main.cpp")
+        )
+        self.assertTrue(bkpt.IsValid() and bkpt.GetNumLocations() == 1)
+        bkpt.SetCondition(condition)
+        end_bkpt = target.BreakpointCreateBySourceRegex(
+            "Break at the end", lldb.SBFileSpec("main.cpp")
+        )
+        self.assertTrue(end_bkpt.IsValid())
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        return process, bkpt, end_bkpt
+
+    def test_implicit_member_hides_global(self):
+        """A member accessed through an implicit 'this' hides the global."""
+        process, bkpt, _ = self.launch_with_condition(
+            "Break in member function", "global_value == 100"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, bkpt)
+        self.assertEqual(len(threads), 1)
+
+    def test_shadowed_local(self):
+        """The innermost of several locals with the same name is used."""
+        process, bkpt, _ = self.launch_with_condition(
+            "Break in inner scope", "shadow == 30"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, bkpt)
+        self.assertEqual(len(threads), 1)
+        frame = threads[0].GetFrameAtIndex(0)
+        self.assertEqual(frame.FindVariable("i").GetValueAsSigned(), 3)
+
+    def test_unsigned_comparison(self):
+        """A negative literal is converted to the unsigned type."""
+        process, _, end_bkpt = self.launch_with_condition(
+            "Break for conversions", "small > -1"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, end_bkpt)
+        self.assertEqual(len(threads), 1)
+
+    def test_signed_against_unsigned_literal(self):
+        """A signed value compared with an unsigned literal is converted."""
+        process, _, end_bkpt = self.launch_with_condition(
+            "Break for conversions", "negative < 0xffffffffffffffff"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, end_bkpt)
+        self.assertEqual(len(threads), 1)
+
+    def test_hex_literal_above_int_max(self):
+        """A hex literal that doesn't fit in int is unsigned int in C."""
+        process, _, end_bkpt = self.launch_with_condition(
+            "Break for conversions", "negative < 0x80000000"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, end_bkpt)
+        self.assertEqual(len(threads), 1)
+
+    def test_octal_literal_above_int_max(self):
+        """An octal literal that doesn't fit in int is unsigned int in C."""
+        process, _, end_bkpt = self.launch_with_condition(
+            "Break for conversions", "negative < 020000000000"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, end_bkpt)
+        self.assertEqual(len(threads), 1)
+
+    def test_decimal_literal_above_int_max(self):
+        """A decimal literal that doesn't fit in int is long, so it is signed."""
+        process, bkpt, _ = self.launch_with_condition(
+            "Break for conversions", "negative < 2147483648"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, bkpt)
+        self.assertEqual(len(threads), 1)
+
+    def test_simple_condition(self):
+        """A condition the fast path can evaluate still stops."""
+        process, bkpt, _ = self.launch_with_condition(
+            "Break for conversions", "negative < 0"
+        )
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, bkpt)
+        self.assertEqual(len(threads), 1)
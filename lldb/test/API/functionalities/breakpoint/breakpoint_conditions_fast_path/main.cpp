@@ -0,0 +1,31 @@
+int global_value = 5;
+
+struct Counter {
+  int global_value = 100;
+  int count = 0;
+
+  void tick() {
+    ++count; // Break in member function.
+  }
+};
+
+static void use(int) {}
+
+int main() {
+  Counter counter;
+  counter.tick();
+
+  for (int i = 0; i < 10; ++i) {
+    int shadow = i;
+    {
+      int shadow = 10 * i;
+      use(shadow); // Break in inner scope.
+    }
+    use(shadow);
+  }
+
+  unsigned int small = 1;
+  int negative = -1;
+  use(small + negative); // Break for conversions.
+  return 0; // Break at the end.
+}
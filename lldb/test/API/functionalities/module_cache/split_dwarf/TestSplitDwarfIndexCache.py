@@ -0,0 +1,72 @@
+"""
+Test that the manual DWARF index caches the entries of each .dwo file, and
+that they are used when the index of the main executable is not cached.
+"""
+
+import glob
+import os
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class SplitDwarfIndexCacheTestCase(TestBase):
+    NO_DEBUG_INFO_TESTCASE = True
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.cache_dir = os.path.join(self.getBuildDir(), "lldb-module-cache")
+        self.runCmd(
+            'settings set symbols.lldb-index-cache-path "%s"' % self.cache_dir
+        )
+        self.runCmd("settings set symbols.enable-lldb-index-cache true")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear symbols.enable-lldb-index-cache")
+        )
+        self.build()
+
+    def get_cache_files(self, pattern):
+        return glob.glob(os.path.join(self.cache_dir, "llvmcache-" + pattern))
+
+    def check_lookups(self):
+        """Create a target, look up names from both .dwo files and return the
+        target."""
+        target = self.dbg.CreateTarget(self.getBuildArtifact("a.out"))
+        self.assertTrue(target, VALID_TARGET)
+        functions = target.FindFunctions("foo")
+        self.assertEqual(functions.GetSize(), 1)
+        self.assertEqual(
+            functions[0].GetCompileUnit().GetFileSpec().GetFilename(), "foo.c"
+        )
+        self.assertEqual(target.FindGlobalVariables("foo_global", 1).GetSize(), 1)
+        self.assertEqual(target.FindFunctions("main").GetSize(), 1)
+        return target
+
+    @skipUnlessPlatform(["linux"])
+    def test(self):
+        target = self.check_lookups()
+        main_dwo = self.get_cache_files("*main.dwo-dwo-index-*")
+        foo_dwo = self.get_cache_files("*foo.dwo-dwo-index-*")
+        self.assertEqual(len(main_dwo), 1)
+        self.assertEqual(len(foo_dwo), 1)
+        dwo_mtimes = [os.path.getmtime(f) for f in main_dwo + foo_dwo]
+
+        # Drop the index cache of the main executable, as a relink would, and
+        # make sure the module is loaded again rather than reused.
+        self.dbg.DeleteTarget(target)
+        lldb.SBDebugger.MemoryPressureDetected()
+        for f in self.get_cache_files("a.out-*dwarf-index*"):
+            os.remove(f)
+
+        # The lookups still find the names from the cached .dwo entries, and
+        # those entries were not rewritten.
+        target = self.check_lookups()
+        self.assertEqual(
+            [os.path.getmtime(f) for f in main_dwo + foo_dwo], dwo_mtimes
+        )
+        bkpt = target.BreakpointCreateByName("foo")
+        self.assertEqual(bkpt.GetNumLocations(), 1)
+        line_entry = bkpt.GetLocationAtIndex(0).GetAddress().GetLineEntry()
+        self.assertEqual(line_entry.GetFileSpec().GetFilename(), "foo.c")
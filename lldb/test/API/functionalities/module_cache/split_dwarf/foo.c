@@ -0,0 +1,5 @@
+int foo_global = 42;
+
+int foo(int x) {
+  return x + foo_global;
+}
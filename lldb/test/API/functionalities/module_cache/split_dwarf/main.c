@@ -0,0 +1,5 @@
+int foo(int x);
+
+int main(int argc, char **argv) {
+  return foo(argc);
+}
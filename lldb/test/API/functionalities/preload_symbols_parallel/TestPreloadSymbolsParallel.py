@@ -0,0 +1,58 @@
+"""
+Test that with target.preload-symbols enabled, the symbols of all shared
+libraries added by the dynamic loader are preloaded, and that breakpoints in
+them still resolve once they are.
+"""
+
+import json
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class PreloadSymbolsParallelTestCase(TestBase):
+    NO_DEBUG_INFO_TESTCASE = True
+
+    @skipUnlessPlatform(["linux", "freebsd", "netbsd"])
+    def test(self):
+        self.build()
+        self.runCmd("settings set target.preload-symbols true")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.preload-symbols")
+        )
+
+        target, process, _, _ = lldbutil.run_to_source_breakpoint(
+            self,
+            "// Break in main",
+            lldb.SBFileSpec("main.c"),
+            extra_images=["_a", "_b", "_c", "_d"],
+        )
+
+        # Every library was preloaded when it was added, before anything
+        # looked up a symbol in it.
+        stream = lldb.SBStream()
+        target.GetStatistics().GetAsJSON(stream)
+        modules = json.loads(stream.GetData())["modules"]
+        for lib in ["lib_a.so", "lib_b.so", "lib_c.so", "lib_d.so"]:
+            stats = [m for m in modules if m["path"].endswith(lib)]
+            self.assertEqual(len(stats), 1, lib)
+            self.assertGreater(stats[0]["symbolTableParseTime"], 0, lib)
+
+        # Breakpoints set after the libraries were loaded resolve in each of
+        # them, in the right order.
+        for name in "abcd":
+            bkpt = target.BreakpointCreateBySourceRegex(
+                "// Break in " + name, lldb.SBFileSpec(name + ".c")
+            )
+            self.assertEqual(bkpt.GetNumLocations(), 1)
+        for name in "abcd":
+            process.Continue()
+            thread = lldbutil.get_stopped_thread(
+                process, lldb.eStopReasonBreakpoint
+            )
+            self.assertIsNotNone(thread)
+            self.assertEqual(
+                thread.GetFrameAtIndex(0).GetFunctionName(), name + "_func"
+            )
@@ -0,0 +1 @@
+int a_func(int x) { return x + 1; } // Break in a
@@ -0,0 +1 @@
+int b_func(int x) { return x + 1; } // Break in b
@@ -0,0 +1 @@
+int c_func(int x) { return x + 1; } // Break in c
@@ -0,0 +1 @@
+int d_func(int x) { return x + 1; } // Break in d
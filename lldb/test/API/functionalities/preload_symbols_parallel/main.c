@@ -0,0 +1,13 @@
+int a_func(int x);
+int b_func(int x);
+int c_func(int x);
+int d_func(int x);
+
+int main(int argc, char **argv) {
+  int x = argc; // Break in main
+  x = a_func(x);
+  x = b_func(x);
+  x = c_func(x);
+  x = d_func(x);
+  return x;
+}
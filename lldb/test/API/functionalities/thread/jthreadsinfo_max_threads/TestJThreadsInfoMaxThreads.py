@@ -0,0 +1,50 @@
+"""
+Test that the stop info and backtraces of every thread are correct when
+jThreadsInfo is skipped because the process has more threads than
+plugin.process.gdb-remote.jthreadsinfo-max-threads.
+"""
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class JThreadsInfoMaxThreadsTestCase(TestBase):
+    NO_DEBUG_INFO_TESTCASE = True
+
+    def check_threads(self, max_threads, expect_jthreadsinfo):
+        self.build()
+        setting = "plugin.process.gdb-remote.jthreadsinfo-max-threads"
+        self.runCmd("settings set %s %d" % (setting, max_threads))
+        self.addTearDownHook(lambda: self.runCmd("settings clear " + setting))
+        log = self.getBuildArtifact("packets.log")
+        self.runCmd("log enable -f %s gdb-remote packets" % log)
+
+        _, process, thread, _ = lldbutil.run_to_source_breakpoint(
+            self, "// Break here", lldb.SBFileSpec("main.cpp")
+        )
+        # The main thread and the eight workers.
+        self.assertEqual(process.GetNumThreads(), 9)
+        self.assertStopReason(thread.GetStopReason(), lldb.eStopReasonBreakpoint)
+        for t in process:
+            self.assertGreater(t.GetNumFrames(), 0)
+            if t.GetThreadID() != thread.GetThreadID():
+                self.assertNotEqual(t.GetStopReason(), lldb.eStopReasonBreakpoint)
+
+        self.runCmd("log disable gdb-remote packets")
+        with open(log) as f:
+            self.assertEqual("$jThreadsInfo" in f.read(), expect_jthreadsinfo)
+
+    @skipIfWindows
+    @skipIfRemote
+    def test_below_limit(self):
+        """All threads are described by jThreadsInfo."""
+        self.check_threads(1024, True)
+
+    @skipIfWindows
+    @skipIfRemote
+    def test_above_limit(self):
+        """Thread info is fetched on demand."""
+        self.check_threads(4, False)
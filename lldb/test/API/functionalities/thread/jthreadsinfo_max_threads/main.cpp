@@ -0,0 +1,26 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static constexpr int num_workers = 8;
+static std::atomic<int> num_started(0);
+static std::atomic<bool> done(false);
+
+static void worker() {
+  ++num_started;
+  while (!done)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+int main() {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_workers; ++i)
+    threads.emplace_back(worker);
+  while (num_started != num_workers)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  done = true; // Break here
+  for (std::thread &t : threads)
+    t.join();
+  return 0;
+}
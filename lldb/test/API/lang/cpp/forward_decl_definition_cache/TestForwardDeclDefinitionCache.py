@@ -0,0 +1,42 @@
+"""
+Test that forward declarations of the same type in several compile units are
+all completed from its definition, and that different template
+specializations are not mixed up.
+"""
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class ForwardDeclDefinitionCacheTestCase(TestBase):
+    def test(self):
+        self.build()
+        lldbutil.run_to_source_breakpoint(
+            self, "// Break here", lldb.SBFileSpec("main.cpp")
+        )
+
+        # a.cpp and b.cpp each only declare Shared and Box. Completing their
+        # declarations must find the definitions in main.cpp, the second time
+        # through the cached lookup.
+        for users in ["a_users", "b_users"]:
+            self.expect_expr(
+                "*%s.shared" % users,
+                result_type="Shared",
+                result_children=[ValueCheck(name="value", value="1")],
+            )
+            self.expect_expr(
+                "*%s.int_box" % users,
+                result_type="Box<int>",
+                result_children=[
+                    ValueCheck(name="contents", type="int", value="2")
+                ],
+            )
+            self.expect_expr(
+                "*%s.float_box" % users,
+                result_type="Box<float>",
+                result_children=[
+                    ValueCheck(name="contents", type="float", value="3.5")
+                ],
+            )
@@ -0,0 +1,5 @@
+#include "shared.h"
+
+Users a_users;
+
+Users *get_a_users() { return &a_users; }
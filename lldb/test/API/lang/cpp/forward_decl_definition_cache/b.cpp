@@ -0,0 +1,5 @@
+#include "shared.h"
+
+Users b_users;
+
+Users *get_b_users() { return &b_users; }
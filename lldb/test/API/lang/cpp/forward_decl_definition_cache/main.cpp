@@ -0,0 +1,24 @@
+#include "shared.h"
+
+struct Shared {
+  int value = 1;
+};
+
+template <typename T> struct Box {
+  T contents;
+};
+
+Users *get_a_users();
+Users *get_b_users();
+
+int main() {
+  Shared shared;
+  Box<int> int_box{2};
+  Box<float> float_box{3.5f};
+  for (Users *users : {get_a_users(), get_b_users()}) {
+    users->shared = &shared;
+    users->int_box = &int_box;
+    users->float_box = &float_box;
+  }
+  return 0; // Break here
+}
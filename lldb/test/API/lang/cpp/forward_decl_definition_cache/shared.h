@@ -0,0 +1,8 @@
+struct Shared;
+template <typename T> struct Box;
+
+struct Users {
+  Shared *shared;
+  Box<int> *int_box;
+  Box<float> *float_box;
+};
@@ -0,0 +1,106 @@
+//===- ADT.cpp - Benchmarks for the most frequently used containers -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the operations on DenseMap, SmallVector and StringMap that
+// dominate their use in the optimizer and code generator, so that regressions
+// in their implementation show up outside of whole-compiler measurements.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FormatVariadic.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+// Pointer-like keys, spread the way heap allocated IR objects are.
+std::vector<uintptr_t> makePointerKeys(size_t NumKeys) {
+  std::vector<uintptr_t> Keys;
+  Keys.reserve(NumKeys);
+  for (size_t I = 0; I < NumKeys; ++I)
+    Keys.push_back(0x10000 + I * 48);
+  return Keys;
+}
+
+std::vector<std::string> makeStringKeys(size_t NumKeys) {
+  std::vector<std::string> Keys;
+  Keys.reserve(NumKeys);
+  for (size_t I = 0; I < NumKeys; ++I)
+    Keys.push_back(formatv("_ZN4llvm6detail{0}E", I));
+  return Keys;
+}
+} // namespace
+
+static void BM_DenseMapInsert(benchmark::State &State) {
+  std::vector<uintptr_t> Keys = makePointerKeys(State.range(0));
+  for (auto _ : State) {
+    DenseMap<uintptr_t, unsigned> Map;
+    for (uintptr_t Key : Keys)
+      Map.try_emplace(Key, 0);
+    benchmark::DoNotOptimize(Map);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapInsert)->Range(16, 1 << 16);
+
+static void BM_DenseMapLookup(benchmark::State &State) {
+  std::vector<uintptr_t> Keys = makePointerKeys(State.range(0));
+  DenseMap<uintptr_t, unsigned> Map;
+  for (uintptr_t Key : Keys)
+    Map.try_emplace(Key, 0);
+  for (auto _ : State) {
+    for (uintptr_t Key : Keys)
+      benchmark::DoNotOptimize(Map.find(Key));
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_DenseMapLookup)->Range(16, 1 << 16);
+
+static void BM_SmallVectorPushBack(benchmark::State &State) {
+  const size_t Size = State.range(0);
+  for (auto _ : State) {
+    SmallVector<unsigned, 8> Vec;
+    for (size_t I = 0; I < Size; ++I)
+      Vec.push_back(I);
+    benchmark::DoNotOptimize(Vec.data());
+  }
+  State.SetItemsProcessed(State.iterations() * Size);
+}
+BENCHMARK(BM_SmallVectorPushBack)->Range(4, 1 << 12);
+
+static void BM_StringMapInsert(benchmark::State &State) {
+  std::vector<std::string> Keys = makeStringKeys(State.range(0));
+  for (auto _ : State) {
+    StringMap<unsigned> Map;
+    for (const std::string &Key : Keys)
+      Map.try_emplace(Key, 0);
+    benchmark::DoNotOptimize(Map);
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_StringMapInsert)->Range(16, 1 << 16);
+
+static void BM_StringMapLookup(benchmark::State &State) {
+  std::vector<std::string> Keys = makeStringKeys(State.range(0));
+  StringMap<unsigned> Map;
+  for (const std::string &Key : Keys)
+    Map.try_emplace(Key, 0);
+  for (auto _ : State) {
+    for (const std::string &Key : Keys)
+      benchmark::DoNotOptimize(Map.find(Key));
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_StringMapLookup)->Range(16, 1 << 16);
+
+BENCHMARK_MAIN();
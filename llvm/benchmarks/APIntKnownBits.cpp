@@ -0,0 +1,124 @@
+//===- APIntKnownBits.cpp - Benchmarks for APInt and KnownBits ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures APInt arithmetic and the KnownBits transfer functions used by
+// ValueTracking and the combiners, for widths that fit in a single word and
+// for widths that need a heap allocation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/APInt.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/KnownBits.h"
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+std::vector<APInt> makeValues(unsigned BitWidth, size_t NumValues) {
+  std::vector<APInt> Values;
+  Values.reserve(NumValues);
+  uint64_t Seed = 0x9E3779B97F4A7C15ULL;
+  for (size_t I = 0; I < NumValues; ++I) {
+    SmallVector<uint64_t, 4> Words;
+    for (unsigned W = 0; W < APInt::getNumWords(BitWidth); ++W) {
+      Seed ^= Seed << 13;
+      Seed ^= Seed >> 7;
+      Seed ^= Seed << 17;
+      Words.push_back(Seed);
+    }
+    Values.emplace_back(BitWidth, Words);
+  }
+  return Values;
+}
+
+// Leaves roughly half of the bits unknown.
+std::vector<KnownBits> makeKnownBits(unsigned BitWidth, size_t NumValues) {
+  std::vector<APInt> Masks = makeValues(BitWidth, NumValues);
+  std::vector<APInt> Values = makeValues(BitWidth, NumValues + 1);
+  std::vector<KnownBits> Known;
+  Known.reserve(NumValues);
+  for (size_t I = 0; I < NumValues; ++I) {
+    KnownBits K(BitWidth);
+    K.One = Values[I] & Masks[I];
+    K.Zero = ~Values[I] & Masks[I];
+    Known.push_back(std::move(K));
+  }
+  return Known;
+}
+
+constexpr size_t NumValues = 1024;
+} // namespace
+
+static void BM_APIntMul(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0), NumValues);
+  for (auto _ : State) {
+    for (size_t I = 0; I + 1 < Values.size(); ++I)
+      benchmark::DoNotOptimize(Values[I] * Values[I + 1]);
+  }
+  State.SetItemsProcessed(State.iterations() * (Values.size() - 1));
+}
+BENCHMARK(BM_APIntMul)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_APIntUDiv(benchmark::State &State) {
+  std::vector<APInt> Values = makeValues(State.range(0), NumValues);
+  for (APInt &V : Values)
+    V.setBit(0);
+  for (auto _ : State) {
+    for (size_t I = 0; I + 1 < Values.size(); ++I)
+      benchmark::DoNotOptimize(Values[I].udiv(Values[I + 1]));
+  }
+  State.SetItemsProcessed(State.iterations() * (Values.size() - 1));
+}
+BENCHMARK(BM_APIntUDiv)->Arg(32)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_KnownBitsAdd(benchmark::State &State) {
+  std::vector<KnownBits> Known = makeKnownBits(State.range(0), NumValues);
+  for (auto _ : State) {
+    for (size_t I = 0; I + 1 < Known.size(); ++I)
+      benchmark::DoNotOptimize(KnownBits::computeForAddSub(
+          /*Add=*/true, /*NSW=*/false, /*NUW=*/false, Known[I],
+          Known[I + 1]));
+  }
+  State.SetItemsProcessed(State.iterations() * (Known.size() - 1));
+}
+BENCHMARK(BM_KnownBitsAdd)->Arg(32)->Arg(64)->Arg(128);
+
+static void BM_KnownBitsMul(benchmark::State &State) {
+  std::vector<KnownBits> Known = makeKnownBits(State.range(0), NumValues);
+  for (auto _ : State) {
+    for (size_t I = 0; I + 1 < Known.size(); ++I)
+      benchmark::DoNotOptimize(KnownBits::mul(Known[I], Known[I + 1]));
+  }
+  State.SetItemsProcessed(State.iterations() * (Known.size() - 1));
+}
+BENCHMARK(BM_KnownBitsMul)->Arg(32)->Arg(64)->Arg(128);
+
+static void BM_KnownBitsShl(benchmark::State &State) {
+  const unsigned BitWidth = State.range(0);
+  std::vector<KnownBits> Known = makeKnownBits(BitWidth, NumValues);
+  // Shift amounts that are in range and known except for their top bit.
+  std::vector<KnownBits> Amounts;
+  for (size_t I = 0; I < NumValues; ++I) {
+    KnownBits Amount(BitWidth);
+    Amount.One = APInt(BitWidth, I % BitWidth);
+    Amount.Zero = ~Amount.One;
+    Amount.Zero.clearBit(Log2_32(BitWidth) - 1);
+    Amount.One.clearBit(Log2_32(BitWidth) - 1);
+    Amounts.push_back(std::move(Amount));
+  }
+  for (auto _ : State) {
+    for (size_t I = 0; I < Known.size(); ++I)
+      benchmark::DoNotOptimize(KnownBits::shl(Known[I], Amounts[I]));
+  }
+  State.SetItemsProcessed(State.iterations() * Known.size());
+}
+BENCHMARK(BM_KnownBitsShl)->Arg(32)->Arg(64)->Arg(128);
+
+BENCHMARK_MAIN();
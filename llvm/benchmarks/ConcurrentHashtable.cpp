@@ -0,0 +1,117 @@
+//===- ConcurrentHashtable.cpp - ConcurrentHashTableByPtr benchmarks ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Compares parallel insertion and lookup of strings in ConcurrentHashTableByPtr
+// with a StringMap guarded by a single mutex, which is what parallel tools
+// otherwise tend to use.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/ConcurrentHashtable.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/PerThreadBumpPtrAllocator.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+using namespace parallel;
+
+namespace {
+// Refers to the benchmark's own copy of the key, so that entries don't need
+// to be destroyed.
+class String {
+public:
+  StringRef getKey() const { return Data; }
+
+  template <typename AllocatorTy>
+  static String *create(StringRef Key, AllocatorTy &Allocator) {
+    String *Result = Allocator.template Allocate<String>();
+    new (Result) String(Key);
+    return Result;
+  }
+
+protected:
+  String(StringRef Key) : Data(Key) {}
+
+  StringRef Data;
+};
+
+using StringTable =
+    ConcurrentHashTableByPtr<StringRef, String, PerThreadBumpPtrAllocator>;
+
+// Every key is inserted twice, so that half of the insertions find an
+// existing entry, as when uniquing names across compile units.
+std::vector<std::string> makeKeys(size_t NumKeys) {
+  std::vector<std::string> Keys;
+  Keys.reserve(2 * NumKeys);
+  for (size_t I = 0; I < 2 * NumKeys; ++I)
+    Keys.push_back(formatv("_ZN4llvm6detail{0}E", I % NumKeys));
+  return Keys;
+}
+} // namespace
+
+static void BM_ConcurrentHashTableInsert(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0));
+  for (auto _ : State) {
+    PerThreadBumpPtrAllocator Allocator;
+    StringTable Table(Allocator, Keys.size() / 2);
+    parallelFor(0, Keys.size(), [&](size_t I) {
+      benchmark::DoNotOptimize(Table.insert(Keys[I]));
+    });
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_ConcurrentHashTableInsert)->Range(1 << 12, 1 << 20);
+
+static void BM_LockedStringMapInsert(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0));
+  for (auto _ : State) {
+    std::mutex Lock;
+    StringMap<char> Map;
+    parallelFor(0, Keys.size(), [&](size_t I) {
+      std::lock_guard<std::mutex> Guard(Lock);
+      benchmark::DoNotOptimize(Map.try_emplace(Keys[I]));
+    });
+  }
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_LockedStringMapInsert)->Range(1 << 12, 1 << 20);
+
+static void BM_ConcurrentHashTableFind(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0));
+  PerThreadBumpPtrAllocator Allocator;
+  StringTable Table(Allocator, Keys.size() / 2);
+  parallelFor(0, Keys.size(), [&](size_t I) { Table.insert(Keys[I]); });
+  for (auto _ : State)
+    parallelFor(0, Keys.size(), [&](size_t I) {
+      benchmark::DoNotOptimize(Table.find(Keys[I]));
+    });
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_ConcurrentHashTableFind)->Range(1 << 12, 1 << 20);
+
+static void BM_LockedStringMapFind(benchmark::State &State) {
+  std::vector<std::string> Keys = makeKeys(State.range(0));
+  std::mutex Lock;
+  StringMap<char> Map;
+  for (const std::string &Key : Keys)
+    Map.try_emplace(Key);
+  for (auto _ : State)
+    parallelFor(0, Keys.size(), [&](size_t I) {
+      std::lock_guard<std::mutex> Guard(Lock);
+      benchmark::DoNotOptimize(Map.find(Keys[I]));
+    });
+  State.SetItemsProcessed(State.iterations() * Keys.size());
+}
+BENCHMARK(BM_LockedStringMapFind)->Range(1 << 12, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+//===- DominatorTree.cpp - Benchmarks for dominator tree construction -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures building the dominator and post-dominator trees of a function with
+// a branchy CFG that contains forward edges and loop back edges, which is the
+// analysis most often recomputed by the optimization pipeline.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+// Creates a function with NumBlocks blocks. Every block conditionally branches
+// to its successor and to another block, which is a back edge for every third
+// block and a forward edge otherwise.
+Function *makeFunction(Module &M, unsigned NumBlocks) {
+  LLVMContext &Ctx = M.getContext();
+  auto *FnTy = FunctionType::get(Type::getVoidTy(Ctx), {Type::getInt1Ty(Ctx)},
+                                 /*isVarArg=*/false);
+  Function *F = Function::Create(FnTy, Function::ExternalLinkage, "f", M);
+  // The last block is the exit block.
+  std::vector<BasicBlock *> Blocks;
+  for (unsigned I = 0; I <= NumBlocks; ++I)
+    Blocks.push_back(BasicBlock::Create(Ctx, "", F));
+
+  IRBuilder<> Builder(Ctx);
+  ReturnInst::Create(Ctx, Blocks.back());
+  uint64_t Seed = 0x9E3779B97F4A7C15ULL;
+  for (unsigned I = 0; I < NumBlocks; ++I) {
+    Builder.SetInsertPoint(Blocks[I]);
+    Seed ^= Seed << 13;
+    Seed ^= Seed >> 7;
+    Seed ^= Seed << 17;
+    BasicBlock *Other;
+    // Back edges never target the entry block, which must not have
+    // predecessors.
+    if (I % 3 == 2)
+      Other = Blocks[1 + Seed % I];
+    else
+      Other = Blocks[I + 1 + Seed % (NumBlocks - I)];
+    Builder.CreateCondBr(F->getArg(0), Blocks[I + 1], Other);
+  }
+  return F;
+}
+} // namespace
+
+static void BM_DominatorTreeRecalculate(benchmark::State &State) {
+  LLVMContext Ctx;
+  Module M("dominators", Ctx);
+  Function *F = makeFunction(M, State.range(0));
+  DominatorTree DT;
+  for (auto _ : State) {
+    DT.recalculate(*F);
+    benchmark::DoNotOptimize(DT.getRoot());
+  }
+  State.SetItemsProcessed(State.iterations() * F->size());
+}
+BENCHMARK(BM_DominatorTreeRecalculate)->Range(64, 1 << 14);
+
+static void BM_PostDominatorTreeRecalculate(benchmark::State &State) {
+  LLVMContext Ctx;
+  Module M("postdominators", Ctx);
+  Function *F = makeFunction(M, State.range(0));
+  PostDominatorTree PDT;
+  for (auto _ : State) {
+    PDT.recalculate(*F);
+    benchmark::DoNotOptimize(PDT.getRoot());
+  }
+  State.SetItemsProcessed(State.iterations() * F->size());
+}
+BENCHMARK(BM_PostDominatorTreeRecalculate)->Range(64, 1 << 14);
+
+BENCHMARK_MAIN();
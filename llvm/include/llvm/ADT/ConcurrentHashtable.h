@@ -223,6 +223,45 @@ public:
     return {};
   }
 
+  /// Look up the entry for \p Key without inserting it. This may be called
+  /// concurrently with insertions.
+  ///
+  /// \returns the entry or nullptr if \p Key is not in the table.
+  KeyDataTy *find(const KeyTy &Key) {
+    // Calculate bucket index.
+    uint64_t Hash = Info::getHashValue(Key);
+    Bucket &CurBucket = BucketsArray[getBucketIdx(Hash)];
+    uint32_t ExtHashBits = getExtHashBits(Hash);
+
+#if LLVM_ENABLE_THREADS
+    // Lock bucket. It may be rehashed by a concurrent insertion.
+    std::lock_guard<std::mutex> Lock(CurBucket.Guard);
+#endif
+
+    HashesPtr BucketHashes = CurBucket.Hashes;
+    DataPtr BucketEntries = CurBucket.Entries;
+    uint32_t CurEntryIdx = getStartIdx(ExtHashBits, CurBucket.Size);
+
+    // Buckets are never full, so the probe ends at an empty slot if the key
+    // isn't there.
+    while (true) {
+      uint32_t CurEntryHashBits = BucketHashes[CurEntryIdx];
+
+      if (CurEntryHashBits == 0 && BucketEntries[CurEntryIdx] == nullptr)
+        return nullptr;
+
+      if (CurEntryHashBits == ExtHashBits) {
+        // Hash matched. Check value for equality.
+        KeyDataTy *EntryData = BucketEntries[CurEntryIdx];
+        if (Info::isEqual(Info::getKey(*EntryData), Key))
+          return EntryData;
+      }
+
+      CurEntryIdx++;
+      CurEntryIdx &= (CurBucket.Size - 1);
+    }
+  }
+
   /// Print information about current state of hash table structures.
   void printStatistic(raw_ostream &OS) {
     OS << "\n--- HashTable statistic:\n";
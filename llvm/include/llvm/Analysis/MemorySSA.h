@@ -1085,6 +1085,15 @@ public:
     return getClobberingMemoryAccess(MA, Loc, BAA);
   }
 
+  /// Computes the clobbering access of each of \p Accesses and stores them,
+  /// in the same order, in \p Clobbers. If the batch contains MemoryUses, all
+  /// uses of the function are optimized up front by
+  /// MemorySSA::ensureOptimizedUses(), which shares a single walk over the
+  /// dominator tree between them instead of walking upwards from each use.
+  void getClobberingMemoryAccesses(ArrayRef<MemoryAccess *> Accesses,
+                                   SmallVectorImpl<MemoryAccess *> &Clobbers,
+                                   BatchAAResults &AA);
+
   /// Given a memory access, invalidate anything this walker knows about
   /// that access.
   /// This API is used by walkers that store information to perform basic cache
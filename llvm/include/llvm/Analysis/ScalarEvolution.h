@@ -2063,6 +2063,12 @@ private:
   /// pointer.
   bool checkValidity(const SCEV *S) const;
 
+  /// Return true if the SCEV nodes allocated so far exceed the budget set by
+  /// -scalar-evolution-max-node-memory. Once over budget, values without an
+  /// existing SCEV are modelled as SCEVUnknown and no new backedge-taken
+  /// counts are computed.
+  bool isOverNodeMemoryBudget() const;
+
   /// Return true if `ExtendOpTy`({`Start`,+,`Step`}) can be proved to be
   /// equal to {`ExtendOpTy`(`Start`),+,`ExtendOpTy`(`Step`)}.  This is
   /// equivalent to proving no signed (resp. unsigned) wrap in
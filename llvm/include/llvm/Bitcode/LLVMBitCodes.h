@@ -319,6 +319,10 @@ enum GlobalValueSummarySymtabCodes {
   //  numver x version]
   FS_COMBINED_ALLOC_INFO = 29,
   FS_STACK_IDS = 30,
+  // Hash of the definition of a function or variable, for keying the ThinLTO
+  // cache on imported definitions.
+  // [valueid, hash]
+  FS_PERMODULE_BODY_HASH = 31,
 };
 
 enum MetadataCodes {
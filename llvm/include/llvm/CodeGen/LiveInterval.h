@@ -272,16 +272,17 @@ namespace llvm {
       assert(I != end());
       if (Pos >= endIndex())
         return end();
-      while (I->end <= Pos) ++I;
+      // Most callers only step over a few segments. Long skips through large
+      // ranges switch to an exponential search.
+      for (unsigned Steps = 0; I->end <= Pos; ++I)
+        if (++Steps == 8)
+          return gallopTo(I, Pos);
       return I;
     }
 
     const_iterator advanceTo(const_iterator I, SlotIndex Pos) const {
-      assert(I != end());
-      if (Pos >= endIndex())
-        return end();
-      while (I->end <= Pos) ++I;
-      return I;
+      return const_cast<LiveRange *>(this)->advanceTo(const_cast<iterator>(I),
+                                                       Pos);
     }
 
     /// find - Return an iterator pointing to the first segment that ends after
@@ -673,6 +674,8 @@ namespace llvm {
 
   private:
     friend class LiveRangeUpdater;
+    /// Slow path of advanceTo() for when \p Pos is far ahead of \p I.
+    iterator gallopTo(iterator I, SlotIndex Pos);
     void addSegmentToSet(Segment S);
     void markValNoForDeletion(VNInfo *V);
   };
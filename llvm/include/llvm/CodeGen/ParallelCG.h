@@ -32,12 +32,15 @@ class raw_pwrite_stream;
 ///
 /// Writes bitcode for individual partitions into output streams in BCOSs, if
 /// BCOSs is not empty.
+///
+/// If BalanceByCost is true, partitions are balanced by estimated codegen cost
+/// and hot call chains are kept together; see SplitModule.
 void splitCodeGen(
     Module &M, ArrayRef<raw_pwrite_stream *> OSs,
     ArrayRef<llvm::raw_pwrite_stream *> BCOSs,
     const std::function<std::unique_ptr<TargetMachine>()> &TMFactory,
     CodeGenFileType FileType = CodeGenFileType::ObjectFile,
-    bool PreserveLocals = false);
+    bool PreserveLocals = false, bool BalanceByCost = false);
 
 } // namespace llvm
 
@@ -3,6 +3,7 @@
 
 #include "DWPStringPool.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -83,7 +84,8 @@ Error handleSection(
     std::vector<StringRef> &CurTypesSection,
     std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
     StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
-    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength);
+    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength,
+    const DenseMap<const char *, StringRef> *Decompressed = nullptr);
 
 Expected<InfoSectionUnitHeader> parseInfoSectionUnitHeader(StringRef Info);
 
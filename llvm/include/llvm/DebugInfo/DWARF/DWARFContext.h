@@ -231,6 +231,10 @@ public:
     return unit_iterator_range(DWOUnits.begin(), DWOUnits.end());
   }
 
+  /// Returns true if this context was created to be used from multiple
+  /// threads.
+  bool isThreadSafe() const { return State->isThreadSafe(); }
+
   /// Get the number of compile units in this context.
   unsigned getNumCompileUnits() {
     return State->getNormalUnits().getNumInfoUnits();
@@ -42,6 +42,8 @@ public:
   size_t GetNumCategories() const { return Aggregation.size(); }
   void Report(StringRef s, std::function<void()> detailCallback);
   void EnumerateResults(std::function<void(StringRef, unsigned)> handleCounts);
+  /// Add the counts collected by \p Other to this aggregator.
+  void Merge(const OutputCategoryAggregator &Other);
 };
 
 /// A class that verifies DWARF debug information given a DWARF Context.
@@ -171,6 +173,12 @@ private:
   unsigned verifyUnitSection(const DWARFSection &S);
   unsigned verifyUnits(const DWARFUnitVector &Units);
 
+  /// Verifies the contents of \p Units on multiple threads. Used by
+  /// verifyUnits() when the DWARFContext is thread safe. The output of each
+  /// unit is buffered and printed in unit order, so it is identical to that
+  /// of a serial run.
+  unsigned verifyUnitsInParallel(const DWARFUnitVector &Units);
+
   unsigned verifyIndex(StringRef Name, DWARFSectionKind SectionKind,
                        StringRef Index);
 
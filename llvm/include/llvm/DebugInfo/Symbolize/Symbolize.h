@@ -62,6 +62,10 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    /// If set, debug info of ELF binaries with a build ID is converted to
+    /// GSYM on first use and cached in this directory. Later lookups are
+    /// answered from the cached file without parsing DWARF.
+    std::string GsymCacheDirectory;
     size_t MaxCacheSize =
         sizeof(size_t) == 4
             ? 512 * 1024 * 1024 /* 512 MiB */
@@ -170,6 +174,12 @@ private:
   createModuleInfo(const ObjectFile *Obj, std::unique_ptr<DIContext> Context,
                    StringRef ModuleName);
 
+  /// Returns a DIContext for \p DbgObj backed by the GSYM cache, converting
+  /// its DWARF if the cache has no entry for the build ID of \p Obj yet.
+  /// Returns nullptr if the GSYM cache cannot be used for this binary.
+  std::unique_ptr<DIContext> createGsymContext(const ObjectFile &Obj,
+                                               const ObjectFile &DbgObj);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
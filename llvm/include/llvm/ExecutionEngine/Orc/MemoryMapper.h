@@ -129,6 +129,9 @@ public:
     ExecutorAddr Initialize;
     ExecutorAddr Deinitialize;
     ExecutorAddr Release;
+    // Optional. If set, initialize requests that are issued while another
+    // one is in flight are queued and sent to the executor together.
+    ExecutorAddr InitializeBatch;
   };
 
   SharedMemoryMapper(ExecutorProcessControl &EPC, SymbolAddrs SAs,
@@ -159,6 +162,17 @@ private:
     size_t Size;
   };
 
+  struct PendingInitialize {
+    ExecutorAddr Reservation;
+    tpctypes::SharedMemoryFinalizeRequest FR;
+    OnInitializedFunction OnInitialized;
+  };
+
+  void sendInitialize(ExecutorAddr Reservation,
+                      tpctypes::SharedMemoryFinalizeRequest FR,
+                      OnInitializedFunction OnInitialized);
+  void sendPendingInitializes();
+
   ExecutorProcessControl &EPC;
   SymbolAddrs SAs;
 
@@ -166,6 +180,10 @@ private:
 
   std::map<ExecutorAddr, Reservation> Reservations;
 
+  // Initialize requests waiting for the one in flight to complete.
+  bool InitializeInFlight = false;
+  std::vector<PendingInitialize> PendingInitializes;
+
   size_t PageSize;
 };
 
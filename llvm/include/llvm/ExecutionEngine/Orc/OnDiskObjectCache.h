@@ -0,0 +1,72 @@
+//===- OnDiskObjectCache.h - Persistent object cache for ORC ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that persists compiled objects in a directory, so that they
+// can be reused by later JIT sessions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/Error.h"
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace orc {
+
+class JITTargetMachineBuilder;
+
+/// An ObjectCache that stores compiled objects as files in a directory.
+///
+/// Objects are keyed by a hash of the module's bitcode together with the
+/// target configuration that the objects are compiled for (triple, CPU,
+/// features, optimization level, relocation and code models, and the
+/// TargetOptions that affect code generation), plus an optional
+/// client-provided key for anything else that does. A cached object is
+/// therefore only reused for an identical module compiled in the same way,
+/// e.g. by a later run of the same program.
+///
+/// The cache is safe to use from concurrent compile threads, e.g. with a
+/// ConcurrentIRCompiler, and from several processes sharing the directory:
+/// entries are written to a temporary file first and then renamed into place.
+class OnDiskObjectCache : public ObjectCache {
+public:
+  /// Create a cache that stores objects in CacheDir, creating the directory if
+  /// needed. JTMB must describe the target that modules are compiled for.
+  static Expected<std::unique_ptr<OnDiskObjectCache>>
+  Create(StringRef CacheDir, const JITTargetMachineBuilder &JTMB,
+         StringRef ExtraKey = "");
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+private:
+  OnDiskObjectCache(StringRef CacheDir, std::string TargetKey)
+      : CacheDir(CacheDir), TargetKey(std::move(TargetKey)) {}
+
+  std::string computeEntryPath(const Module &M);
+
+  SmallString<128> CacheDir;
+  std::string TargetKey;
+
+  // Paths computed by getObject for modules that missed in the cache, so that
+  // notifyObjectCompiled doesn't have to hash the module again.
+  std::mutex PendingPathsMutex;
+  DenseMap<const Module *, std::string> PendingPaths;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_ONDISKOBJECTCACHE_H
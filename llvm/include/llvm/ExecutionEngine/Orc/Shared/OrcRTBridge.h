@@ -34,6 +34,7 @@ extern const char *SimpleExecutorMemoryManagerDeallocateWrapperName;
 extern const char *ExecutorSharedMemoryMapperServiceInstanceName;
 extern const char *ExecutorSharedMemoryMapperServiceReserveWrapperName;
 extern const char *ExecutorSharedMemoryMapperServiceInitializeWrapperName;
+extern const char *ExecutorSharedMemoryMapperServiceInitializeBatchWrapperName;
 extern const char *ExecutorSharedMemoryMapperServiceDeinitializeWrapperName;
 extern const char *ExecutorSharedMemoryMapperServiceReleaseWrapperName;
 
@@ -76,6 +77,11 @@ using SPSExecutorSharedMemoryMapperServiceInitializeSignature =
     shared::SPSExpected<shared::SPSExecutorAddr>(
         shared::SPSExecutorAddr, shared::SPSExecutorAddr,
         shared::SPSSharedMemoryFinalizeRequest);
+using SPSExecutorSharedMemoryMapperServiceInitializeBatchSignature =
+    shared::SPSExpected<shared::SPSSequence<shared::SPSExecutorAddr>>(
+        shared::SPSExecutorAddr,
+        shared::SPSSequence<shared::SPSTuple<
+            shared::SPSExecutorAddr, shared::SPSSharedMemoryFinalizeRequest>>);
 using SPSExecutorSharedMemoryMapperServiceDeinitializeSignature =
     shared::SPSError(shared::SPSExecutorAddr,
                      shared::SPSSequence<shared::SPSExecutorAddr>);
@@ -17,12 +17,30 @@
 #include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/Speculation.h"
 
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace llvm {
 
 namespace orc {
 
 // Provides common code.
 class SpeculateQuery {
+  // Names of the functions of the module queried last, by GUID and by PGO
+  // name GUID, to resolve the profiled targets of indirect calls. Copies of a
+  // query share it, since the speculation layer may run them concurrently.
+  struct FunctionsByGUIDCache {
+    std::mutex Lock;
+    const Module *M = nullptr;
+    std::string ModuleID;
+    DenseMap<uint64_t, std::string> Names;
+  };
+  std::shared_ptr<FunctionsByGUIDCache> FunctionsByGUID =
+      std::make_shared<FunctionsByGUIDCache>();
+
+  const Function *findFunctionByGUID(const Module &M, uint64_t GUID);
+
 protected:
   void findCalles(const BasicBlock *, DenseSet<StringRef> &);
   bool isStraightLine(const Function &F);
@@ -31,7 +49,10 @@ public:
   using ResultTy = std::optional<DenseMap<StringRef, DenseSet<StringRef>>>;
 };
 
-// Direct calls in high frequency basic blocks are extracted.
+// Direct calls in high frequency basic blocks are extracted, along with the
+// targets of indirect calls that have value profile data. If the module
+// carries PGO profile data, block frequencies follow it, and callees with a
+// zero entry count are skipped.
 class BlockFreqQuery : public SpeculateQuery {
   size_t numBBToGet(size_t);
 
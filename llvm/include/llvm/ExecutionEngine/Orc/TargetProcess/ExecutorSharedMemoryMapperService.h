@@ -33,6 +33,13 @@ public:
   Expected<ExecutorAddr> initialize(ExecutorAddr Reservation,
                                     tpctypes::SharedMemoryFinalizeRequest &FR);
 
+  /// Initialize several allocations at once. Either all of the allocations
+  /// are initialized, or none are and an error is returned.
+  Expected<std::vector<ExecutorAddr>> initializeBatch(
+      std::vector<
+          std::pair<ExecutorAddr, tpctypes::SharedMemoryFinalizeRequest>>
+          &Requests);
+
   Error deinitialize(const std::vector<ExecutorAddr> &Bases);
   Error release(const std::vector<ExecutorAddr> &Bases);
 
@@ -60,6 +67,9 @@ private:
   static llvm::orc::shared::CWrapperFunctionResult
   initializeWrapper(const char *ArgData, size_t ArgSize);
 
+  static llvm::orc::shared::CWrapperFunctionResult
+  initializeBatchWrapper(const char *ArgData, size_t ArgSize);
+
   static llvm::orc::shared::CWrapperFunctionResult
   deinitializeWrapper(const char *ArgData, size_t ArgSize);
 
@@ -510,6 +510,12 @@ private:
   /// GUID includes the module level id in the hash.
   GlobalValue::GUID OriginalName = 0;
 
+  /// A hash of the IR definition (the function body or variable initializer)
+  /// together with the metadata it references, or 0 if not computed. Used to
+  /// key the ThinLTO cache on the definitions a module imports rather than on
+  /// the whole modules they come from.
+  uint64_t BodyHash = 0;
+
   /// Path of module IR containing value's definition, used to locate
   /// module during importing.
   ///
@@ -542,6 +548,11 @@ public:
   /// Initialize the original name hash in this summary.
   void setOriginalName(GlobalValue::GUID Name) { OriginalName = Name; }
 
+  /// Returns the hash of the definition, or 0 if it was not computed.
+  uint64_t getBodyHash() const { return BodyHash; }
+
+  void setBodyHash(uint64_t Hash) { BodyHash = Hash; }
+
   /// Which kind of summary subclass this is.
   SummaryKind getSummaryKind() const { return Kind; }
 
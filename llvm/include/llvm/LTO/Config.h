@@ -88,6 +88,30 @@ struct Config {
   /// want to know a priori all possible output files.
   bool AlwaysEmitRegularLTOObj = false;
 
+  /// When code generating a regular LTO module in parallel, balance the
+  /// partitions by estimated codegen cost weighted by profile entry counts and
+  /// keep hot call chains in the same partition, instead of splitting by
+  /// symbol name hashes.
+  bool CostBalancedPartitions = false;
+
+  /// Link each regular LTO module into the combined module as soon as it is
+  /// added, even if it has a summary, so that its lazily loaded IR and
+  /// metadata loader are released immediately instead of being kept alive
+  /// until the whole-program liveness analysis has run. Dead globals in such
+  /// modules are then only removed by the optimization pipeline.
+  bool StreamRegularLTOLinking = false;
+
+  /// Key the ThinLTO cache entry of a module on the hashes of the definitions
+  /// it imports, as recorded in the summaries by -module-summary-body-hashes,
+  /// instead of on the hashes of the whole modules they are imported from.
+  /// Modules whose summaries lack the hashes are still keyed by module hash.
+  bool CacheKeyUseBodyHashes = false;
+
+  /// Also use the cache passed to LTO::run for the native objects of the
+  /// regular LTO module. Each partition is keyed on its optimized IR, so an
+  /// unchanged partition is not code generated again.
+  bool CacheRegularLTOPartitions = false;
+
   /// Allows non-imported definitions to get the potentially more constraining
   /// visibility from the prevailing definition. FromPrevailing is the default
   /// because it works for many binary formats. ELF can use the more optimized
@@ -171,6 +195,12 @@ struct Config {
   /// Specific thinLTO modules to compile.
   std::vector<std::string> ThinLTOModulesToCompile;
 
+  /// If nonzero, the in-process ThinLTO backend only starts a backend job if
+  /// the estimated memory use of the running jobs, including the new one,
+  /// stays within this many bytes. A job that exceeds the budget on its own
+  /// runs by itself.
+  uint64_t ThinLTOMemoryBudget = 0;
+
   /// Time trace enabled.
   bool TimeTraceEnabled = false;
 
@@ -15,6 +15,7 @@
 #ifndef LLVM_LTO_LTO_H
 #define LLVM_LTO_LTO_H
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Bitcode/BitcodeReader.h"
@@ -73,6 +74,12 @@ void computeLTOCacheKey(
     const std::set<GlobalValue::GUID> &CfiFunctionDefs = {},
     const std::set<GlobalValue::GUID> &CfiFunctionDecls = {});
 
+/// Computes a unique hash for a partition of the regular LTO module that is
+/// code generated as \p Task from the optimized IR serialized in \p Bitcode.
+/// The hash is produced in \p Key.
+void computeLTOPartitionCacheKey(SmallString<40> &Key, const lto::Config &Conf,
+                                 unsigned Task, StringRef Bitcode);
+
 namespace lto {
 
 StringLiteral getThinLTODefaultCPU(const Triple &TheTriple);
@@ -237,6 +244,61 @@ ThinBackend createWriteIndexesThinBackend(std::string OldPrefix,
                                           raw_fd_ostream *LinkedObjectsFile,
                                           IndexWriteCallback OnWrite);
 
+/// The interface used by the distributed ThinLTO backend to run backend
+/// compiles outside of the current process, for example on a build farm.
+class ThinBackendExecutor {
+public:
+  /// A module that a backend compile imports from.
+  struct Import {
+    /// The module identifier recorded in the summary index.
+    std::string ModuleID;
+    /// The file holding the module's bitcode. This differs from ModuleID if
+    /// the module is not a file on disk (e.g. an archive member), in which case
+    /// it has been written out to the backend's work directory.
+    std::string Path;
+  };
+
+  /// A single backend compile.
+  struct Job {
+    unsigned Task;
+    /// The module to compile, as for Import.
+    std::string ModuleID;
+    std::string ModulePath;
+    /// The individual summary index (the part of the combined index that the
+    /// module needs) written for this compile.
+    std::string SummaryIndexPath;
+    /// The modules whose definitions are imported.
+    std::vector<Import> Imports;
+    /// Where the compile must write the native object file.
+    std::string NativeObjectPath;
+  };
+
+  virtual ~ThinBackendExecutor() = default;
+
+  /// Runs \p Jobs and returns once each of them has either written its native
+  /// object file or failed. Jobs are independent and may run in any order.
+  virtual Error execute(const Config &Conf, ArrayRef<Job> Jobs) = 0;
+};
+
+/// Returns an executor that describes the jobs in a JSON file and runs
+/// \p Program with \p Args followed by the path of that file. The program is
+/// expected to run the backend compiles, in whatever way it likes, and to exit
+/// with status 0 if all of them succeeded.
+std::unique_ptr<ThinBackendExecutor>
+createExternalThinBackendExecutor(std::string Program,
+                                  std::vector<std::string> Args);
+
+/// This ThinBackend hands the individual backend jobs to \p Executor instead
+/// of running them in-process. For each module it writes the individual
+/// summary index to a uniquely named directory in \p WorkDir and, once the
+/// executor returns, adds the native object files to the link through AddStream
+/// (or the cache, if one is given). The directory and the files the backend
+/// wrote to it are removed when the backend finishes.
+ThinBackend
+createDistributedThinBackend(std::shared_ptr<ThinBackendExecutor> Executor,
+                             std::string WorkDir,
+                             IndexWriteCallback OnWrite = nullptr);
+
 /// This class implements a resolution-based interface to LLVM's LTO
 /// functionality. It supports regular LTO, parallel LTO code generation and
 /// ThinLTO. You can use it from a linker in the following way:
@@ -332,6 +394,11 @@ private:
     };
     std::vector<AddedModule> ModsWithSummaries;
     bool EmptyCombinedModule = true;
+
+    // The compile units listed in the combined module's llvm.dbg.cu, and the
+    // number of its operands that have already been checked for duplicates.
+    DenseSet<const MDNode *> CompileUnits;
+    unsigned NumCheckedCompileUnits = 0;
   } RegularLTO;
 
   using ModuleMapType = MapVector<StringRef, BitcodeModule>;
@@ -426,11 +493,12 @@ private:
                 const SymbolResolution *&ResI, const SymbolResolution *ResE);
   Error linkRegularLTO(RegularLTOState::AddedModule Mod,
                        bool LivenessFromIndex);
+  void dropDuplicateCompileUnits();
 
   Error addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
                    const SymbolResolution *&ResI, const SymbolResolution *ResE);
 
-  Error runRegularLTO(AddStreamFn AddStream);
+  Error runRegularLTO(AddStreamFn AddStream, FileCache Cache);
   Error runThinLTO(AddStreamFn AddStream, FileCache Cache,
                    const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols);
 
@@ -108,6 +108,15 @@ public:
     FirstReturnInst = true;
   }
 
+  /// Reset the state that is tied to the MCInsts of a single code region.
+  /// Unlike clear(), this keeps the descriptors that only depend on the opcode
+  /// and scheduling class, so that they can be reused by the next region.
+  void clearRegionState() {
+    VariantDescriptors.clear();
+    FirstCallInst = true;
+    FirstReturnInst = true;
+  }
+
   /// Set a callback which is invoked to retrieve a recycled mca::Instruction
   /// or null if there isn't any.
   void setInstRecycleCallback(InstRecycleCallback CB) { InstRecycleCB = CB; }
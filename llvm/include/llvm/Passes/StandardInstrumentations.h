@@ -28,6 +28,7 @@
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Transforms/IPO/SampleProfileProbe.h"
 
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -464,6 +465,20 @@ public:
   void registerCallbacks(PassInstrumentationCallbacks &PIC);
 };
 
+/// Reports function passes that invalidated analyses even though the
+/// function's structural hash is the same after the pass as before it. Such
+/// passes are candidates for returning a more precise PreservedAnalyses, which
+/// avoids recomputing e.g. the dominator tree. Enabled with
+/// -report-spurious-invalidation.
+class SpuriousInvalidationReporter {
+  // Hash of the function each running pass was started on, or std::nullopt
+  // if the pass isn't a function pass.
+  SmallVector<std::optional<uint64_t>, 8> HashesBefore;
+
+public:
+  void registerCallbacks(PassInstrumentationCallbacks &PIC);
+};
+
 /// This class implements --time-trace functionality for new pass manager.
 /// It provides the pass-instrumentation callbacks that measure the pass
 /// execution time. They collect time tracing info by TimeProfiler.
@@ -594,6 +609,7 @@ class StandardInstrumentations {
   PrintCrashIRInstrumentation PrintCrashIR;
   IRChangedTester ChangeTester;
   VerifyInstrumentation Verify;
+  SpuriousInvalidationReporter SpuriousInvalidation;
 
   bool VerifyEach;
 
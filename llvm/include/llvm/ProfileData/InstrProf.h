@@ -174,6 +174,18 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
 }
 
+/// Return the name of the runtime's thread-local counter bias variable, used
+/// when every thread increments its own copy of the counters.
+inline StringRef getInstrProfThreadCounterBiasVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_THREAD_COUNTER_BIAS_VAR);
+}
+
+/// Return the name of the runtime function that sets up the counter copy of
+/// the calling thread and returns its bias.
+inline StringRef getInstrProfInitThreadCountersFuncName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_INIT_THREAD_COUNTERS_FUNC);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
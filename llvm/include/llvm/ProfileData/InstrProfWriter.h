@@ -125,6 +125,15 @@ public:
   void mergeRecordsFromWriter(InstrProfWriter &&IPW,
                               function_ref<void(Error)> Warn);
 
+  /// Move the function records of \p IPW whose names hash into shard \p Shard
+  /// of \p NumShards into this writer, merging them with existing records.
+  /// Functions not yet present here are taken over wholesale. Writers merging
+  /// distinct shards of the same \p IPW may run concurrently. Only function
+  /// records are touched; use mergeRecordsFromWriter for the remaining data.
+  void mergeFunctionShardFromWriter(InstrProfWriter &IPW, unsigned Shard,
+                                    unsigned NumShards,
+                                    function_ref<void(Error)> Warn);
+
   /// Write the profile to \c OS
   Error write(raw_fd_ostream &OS);
 
@@ -374,6 +374,11 @@ public:
                       : sampleprof_error::success;
   }
 
+  /// Make room for \p N more call targets.
+  void reserveCallTargets(size_t N) {
+    CallTargets.reserve(CallTargets.size() + N);
+  }
+
   /// Remove called function from the call target map. Return the target sample
   /// count of the called function.
   uint64_t removeCalledTarget(FunctionId F) {
@@ -790,6 +795,20 @@ public:
         Func, Num, Weight);
   }
 
+  /// Return the body sample record at \p Loc, creating an empty one if
+  /// needed. Profile readers see locations in increasing order, for which the
+  /// end() insertion hint makes this constant time.
+  SampleRecord &getOrCreateBodySample(const LineLocation &Loc) {
+    return BodySamples.try_emplace(BodySamples.end(), Loc)->second;
+  }
+
+  /// Return the inlined callee samples at profile location \p Loc, creating
+  /// an empty map if needed. Like getOrCreateBodySample, this is constant time
+  /// for locations seen in increasing order.
+  FunctionSamplesMap &getOrCreateCallsiteSamples(const LineLocation &Loc) {
+    return CallsiteSamples.try_emplace(CallsiteSamples.end(), Loc)->second;
+  }
+
   sampleprof_error addSampleRecord(LineLocation Location,
                                    const SampleRecord &SampleRecord,
                                    uint64_t Weight = 1) {
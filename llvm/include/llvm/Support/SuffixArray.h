@@ -0,0 +1,56 @@
+//===- llvm/Support/SuffixArray.h - Suffix array for substrings -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// A compact alternative to SuffixTree for finding repeated substrings.
+//
+// A suffix array lists the start indices of all suffixes of a string in
+// lexicographic order. Together with the array of longest common prefixes of
+// neighbouring suffixes (the LCP array), it describes every internal node of
+// the corresponding suffix tree as an interval of suffixes, while only needing
+// a few integers per element of the input.
+//
+// As with SuffixTree, a "string" is a vector of unsigned integers, and the last
+// element is expected to be unique so that every suffix is a leaf.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_SUFFIXARRAY_H
+#define LLVM_SUPPORT_SUFFIXARRAY_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/SuffixTree.h"
+#include <vector>
+
+namespace llvm {
+class SuffixArray {
+public:
+  /// Each element is an integer representing an instruction in the module.
+  ArrayRef<unsigned> Str;
+
+private:
+  /// The start indices of the suffixes of \p Str, in lexicographic order.
+  std::vector<unsigned> SA;
+
+  /// LCP[I] is the length of the longest common prefix of the suffixes
+  /// starting at SA[I - 1] and SA[I]. LCP[0] is 0.
+  std::vector<unsigned> LCP;
+
+public:
+  /// Construct a suffix array from a sequence of unsigned integers.
+  ///
+  /// \param Str The string to construct the suffix array for.
+  SuffixArray(ArrayRef<unsigned> Str);
+
+  /// Return the repeated substrings that iterating over a SuffixTree of the
+  /// same string visits: for each internal node of at least \p MinLength
+  /// elements, the start indices of the leaves directly below it, if there are
+  /// at least two of them.
+  std::vector<SuffixTree::RepeatedSubstring>
+  getRepeatedSubstrings(unsigned MinLength = 2) const;
+};
+} // namespace llvm
+
+#endif // LLVM_SUPPORT_SUFFIXARRAY_H
@@ -32,10 +32,15 @@ class Module;
 ///   module.
 /// - Internal symbols defined in module-level inline asm should be visible to
 ///   each partition.
+///
+/// If BalanceByCost is true, partitions are balanced by estimated codegen cost
+/// (instruction count weighted by profile entry counts) instead of by symbol
+/// name hashes, and functions connected by hot call edges are placed in the
+/// same partition where that does not unbalance the split.
 void SplitModule(
     Module &M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals = false);
+    bool PreserveLocals = false, bool BalanceByCost = false);
 
 } // end namespace llvm
 
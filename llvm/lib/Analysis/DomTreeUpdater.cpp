@@ -13,6 +13,7 @@
 
 #include "llvm/Analysis/DomTreeUpdater.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/PostDominators.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Instructions.h"
@@ -21,6 +22,12 @@
 #include <functional>
 #include <utility>
 
+#define DEBUG_TYPE "dom-tree-updater"
+
+STATISTIC(NumRecalculations,
+          "Number of full dominator tree recalculations requested through "
+          "DomTreeUpdater");
+
 namespace llvm {
 
 bool DomTreeUpdater::isUpdateValid(
@@ -118,6 +125,7 @@ bool DomTreeUpdater::forceFlushDeletedBB() {
 }
 
 void DomTreeUpdater::recalculate(Function &F) {
+  ++NumRecalculations;
 
   if (Strategy == UpdateStrategy::Eager) {
     if (DT)
@@ -16,6 +16,7 @@
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/IVDescriptors.h"
 #include "llvm/Analysis/LoopIterator.h"
 #include "llvm/Analysis/LoopNestAnalysis.h"
@@ -39,6 +40,11 @@
 #include "llvm/Support/raw_ostream.h"
 using namespace llvm;
 
+#define DEBUG_TYPE "loops"
+
+STATISTIC(NumLoopAnalysisRuns,
+          "Number of LoopInfos computed from scratch by the analysis");
+
 // Explicitly instantiate methods in LoopInfoImpl.h for IR-level Loops.
 template class llvm::LoopBase<BasicBlock, Loop>;
 template class llvm::LoopInfoBase<BasicBlock, Loop>;
@@ -961,6 +967,7 @@ LoopInfo LoopAnalysis::run(Function &F, FunctionAnalysisManager &AM) {
   // point it may prove worthwhile to use a freelist and recycle LoopInfo
   // objects. I don't want to add that kind of complexity until the scope of
   // the problem is better understood.
+  ++NumLoopAnalysisRuns;
   LoopInfo LI;
   LI.analyze(AM.getResult<DominatorTreeAnalysis>(F));
   return LI;
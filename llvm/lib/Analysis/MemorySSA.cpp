@@ -2444,6 +2444,17 @@ void MemorySSAWrapperPass::print(raw_ostream &OS, const Module *M) const {
 
 MemorySSAWalker::MemorySSAWalker(MemorySSA *M) : MSSA(M) {}
 
+void MemorySSAWalker::getClobberingMemoryAccesses(
+    ArrayRef<MemoryAccess *> Accesses,
+    SmallVectorImpl<MemoryAccess *> &Clobbers, BatchAAResults &AA) {
+  if (any_of(Accesses,
+             [](const MemoryAccess *MA) { return isa<MemoryUse>(MA); }))
+    MSSA->ensureOptimizedUses();
+  Clobbers.reserve(Clobbers.size() + Accesses.size());
+  for (MemoryAccess *MA : Accesses)
+    Clobbers.push_back(getClobberingMemoryAccess(MA, AA));
+}
+
 /// Walk the use-def chains starting at \p StartingAccess and find
 /// the MemoryAccess that actually clobbers Loc.
 ///
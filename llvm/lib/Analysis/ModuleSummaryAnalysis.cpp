@@ -19,6 +19,7 @@
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/BranchProbabilityInfo.h"
@@ -33,6 +34,7 @@
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalAlias.h"
@@ -42,6 +44,7 @@
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Metadata.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/ModuleSlotTracker.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
 #include "llvm/IR/Use.h"
 #include "llvm/IR/User.h"
@@ -52,6 +55,7 @@
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
@@ -81,10 +85,153 @@ static cl::opt<std::string> ModuleSummaryDotFile(
     "module-summary-dot-file", cl::Hidden, cl::value_desc("filename"),
     cl::desc("File to emit dot graph of new summary into"));
 
+static cl::opt<bool> ModuleSummaryBodyHashes(
+    "module-summary-body-hashes", cl::Hidden,
+    cl::desc("Record a hash of each function body and variable initializer "
+             "in the summary, allowing the ThinLTO cache to be keyed on the "
+             "imported definitions rather than whole modules"));
+
 extern cl::opt<bool> ScalePartialSampleProfileWorkingSetSize;
 
 extern cl::opt<unsigned> MaxNumVTableAnnotations;
 
+// Returns a hash of the definition of GO that does not depend on the rest of
+// the module. This is the printed IR of the definition followed by the printed
+// IR of every metadata node it transitively references, where metadata slot
+// numbers are replaced with numbers local to GO in order of first use.
+// DICompileUnit operands are not followed, so that adding an unrelated type or
+// global to a translation unit does not change the hash of every function in
+// it. MDNodes maps module metadata slots to nodes.
+static uint64_t
+computeBodyHash(const GlobalObject &GO, ModuleSlotTracker &MST,
+                const DenseMap<unsigned, const MDNode *> &MDNodes) {
+  std::string Buf;
+  raw_string_ostream BufOS(Buf);
+  GO.print(BufOS, MST);
+
+  std::string Canonical;
+  raw_string_ostream OS(Canonical);
+  DenseMap<const MDNode *, unsigned> LocalIds;
+  std::vector<const MDNode *> Worklist;
+  // Copy Text to OS, renumbering slot references. Inside string literals '!'
+  // has no special meaning; AsmWriter escapes any '"' within them.
+  auto Append = [&](StringRef Text, bool FollowRefs) {
+    bool InString = false;
+    for (size_t I = 0, E = Text.size(); I != E; ++I) {
+      char C = Text[I];
+      OS << C;
+      if (C == '"')
+        InString = !InString;
+      if (InString || C != '!' || I + 1 == E || !isDigit(Text[I + 1]))
+        continue;
+      size_t End = I + 1;
+      while (End != E && isDigit(Text[End]))
+        ++End;
+      unsigned Slot;
+      Text.slice(I + 1, End).getAsInteger(10, Slot);
+      const MDNode *N = MDNodes.lookup(Slot);
+      auto [It, Inserted] = LocalIds.try_emplace(N, LocalIds.size());
+      if (Inserted && N && FollowRefs)
+        Worklist.push_back(N);
+      OS << It->second;
+      I = End - 1;
+    }
+  };
+
+  Append(Buf, /*FollowRefs=*/true);
+  for (size_t I = 0; I != Worklist.size(); ++I) {
+    const MDNode *N = Worklist[I];
+    Buf.clear();
+    N->print(BufOS, MST, GO.getParent());
+    OS << '\n';
+    Append(Buf, /*FollowRefs=*/!isa<DICompileUnit>(N));
+  }
+
+  // The printed IR only refers to attribute groups by their module-wide #N
+  // slot, which can stay the same when the attributes change, so hash the
+  // attributes of the definition and of its call sites themselves.
+  auto AppendAttrs = [&](const AttributeList &Attrs) {
+    for (unsigned Index : Attrs.indexes())
+      OS << ' ' << Index << '=' << Attrs.getAsString(Index);
+    OS << '\n';
+  };
+  if (const auto *F = dyn_cast<Function>(&GO)) {
+    AppendAttrs(F->getAttributes());
+    for (const BasicBlock &BB : *F)
+      for (const Instruction &I : BB)
+        if (const auto *CB = dyn_cast<CallBase>(&I))
+          AppendAttrs(CB->getAttributes());
+  } else if (const auto *GV = dyn_cast<GlobalVariable>(&GO)) {
+    OS << GV->getAttributes().getAsString() << '\n';
+  }
+
+  // Importing the definition also copies the declarations of the globals it
+  // refers to, so include the properties of those declarations.
+  SmallPtrSet<const Value *, 32> Visited;
+  SmallVector<const Value *, 32> Constants;
+  std::vector<const GlobalValue *> Refs;
+  auto Visit = [&](const Value *V) {
+    if (isa<Constant>(V) && Visited.insert(V).second)
+      Constants.push_back(V);
+  };
+  if (const auto *F = dyn_cast<Function>(&GO)) {
+    for (const BasicBlock &BB : *F)
+      for (const Instruction &I : BB)
+        for (const Value *Op : I.operands())
+          Visit(Op);
+  } else if (const auto *GV = dyn_cast<GlobalVariable>(&GO)) {
+    Visit(GV->getInitializer());
+  }
+  while (!Constants.empty()) {
+    const Value *V = Constants.pop_back_val();
+    if (const auto *Ref = dyn_cast<GlobalValue>(V)) {
+      if (Ref != &GO)
+        Refs.push_back(Ref);
+      continue;
+    }
+    for (const Value *Op : cast<User>(V)->operands())
+      Visit(Op);
+  }
+  llvm::sort(Refs, [](const GlobalValue *L, const GlobalValue *R) {
+    return L->getName() < R->getName();
+  });
+  for (const GlobalValue *Ref : Refs) {
+    OS << '\n' << Ref->getName() << ' ' << *Ref->getValueType() << ' '
+       << Ref->getVisibility() << ' ' << Ref->isDSOLocal() << ' '
+       << (unsigned)Ref->getUnnamedAddr() << ' ' << Ref->isThreadLocal();
+    if (const auto *F = dyn_cast<Function>(Ref)) {
+      AttributeList Attrs = F->getAttributes();
+      for (unsigned Index : Attrs.indexes())
+        OS << ' ' << Attrs.getAsString(Index);
+    } else if (const auto *GV = dyn_cast<GlobalVariable>(Ref)) {
+      OS << ' ' << GV->isConstant() << ' '
+         << GV->getAlign().valueOrOne().value();
+    }
+  }
+  return xxh3_64bits(Canonical);
+}
+
+// Record body hashes for the definitions in M that have a summary.
+static void computeBodyHashes(const Module &M, ModuleSummaryIndex &Index) {
+  ModuleSlotTracker MST(&M);
+  ModuleSlotTracker::MachineMDNodeListType MDList;
+  MST.getMachine();
+  MST.collectMDNodes(MDList, 0, std::numeric_limits<unsigned>::max());
+  DenseMap<unsigned, const MDNode *> MDNodes(MDList.begin(), MDList.end());
+
+  auto Record = [&](const GlobalObject &GO) {
+    if (GO.isDeclaration() || !GO.hasName())
+      return;
+    ValueInfo VI = Index.getValueInfo(GO.getGUID());
+    if (VI && VI.getSummaryList().size() == 1)
+      VI.getSummaryList()[0]->setBodyHash(computeBodyHash(GO, MST, MDNodes));
+  };
+  for (const Function &F : M)
+    Record(F);
+  for (const GlobalVariable &GV : M.globals())
+    Record(GV);
+}
+
 // Walk through the operands of a given User via worklist iteration and populate
 // the set of GlobalValue references encountered. Invoked either on an
 // Instruction or a GlobalVariable (which walks its initializer).
@@ -1073,6 +1220,9 @@ ModuleSummaryIndex llvm::buildModuleSummaryIndex(
     }
   }
 
+  if (IsThinLTO && ModuleSummaryBodyHashes)
+    computeBodyHashes(M, Index);
+
   if (!ModuleSummaryDotFile.empty()) {
     std::error_code EC;
     raw_fd_ostream OSDot(ModuleSummaryDotFile, EC, sys::fs::OpenFlags::OF_Text);
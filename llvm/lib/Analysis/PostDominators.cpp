@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Analysis/PostDominators.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/PassManager.h"
@@ -22,6 +23,10 @@ using namespace llvm;
 
 #define DEBUG_TYPE "postdomtree"
 
+STATISTIC(NumPostDomTreeAnalysisRuns,
+          "Number of post-dominator trees computed from scratch by the "
+          "analysis");
+
 #ifdef EXPENSIVE_CHECKS
 static constexpr bool ExpensiveChecksEnabled = true;
 #else
@@ -97,6 +102,7 @@ AnalysisKey PostDominatorTreeAnalysis::Key;
 
 PostDominatorTree PostDominatorTreeAnalysis::run(Function &F,
                                                  FunctionAnalysisManager &) {
+  ++NumPostDomTreeAnalysisRuns;
   PostDominatorTree PDT(F);
   return PDT;
 }
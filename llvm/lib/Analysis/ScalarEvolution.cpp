@@ -168,6 +168,12 @@ static cl::opt<bool> VerifyIR(
     cl::desc("Verify IR correctness when making sensitive SCEV queries (slow)"),
     cl::init(false));
 
+static cl::opt<unsigned> MaxNodeMemoryMB(
+    "scalar-evolution-max-node-memory", cl::Hidden,
+    cl::desc("Maximum memory in MiB used for SCEV nodes of a function, after "
+             "which new values are treated as opaque (0 = unlimited)"),
+    cl::init(0));
+
 static cl::opt<unsigned> MulOpsInlineThreshold(
     "scev-mulops-inline-threshold", cl::Hidden,
     cl::desc("Threshold for inlining multiplication operands into a SCEV"),
@@ -4507,6 +4513,12 @@ const SCEV *ScalarEvolution::getCouldNotCompute() {
   return CouldNotCompute.get();
 }
 
+bool ScalarEvolution::isOverNodeMemoryBudget() const {
+  return MaxNodeMemoryMB &&
+         SCEVAllocator.getBytesAllocated() >
+             static_cast<size_t>(MaxNodeMemoryMB) * 1024 * 1024;
+}
+
 bool ScalarEvolution::checkValidity(const SCEV *S) const {
   bool ContainsNulls = SCEVExprContains(S, [](const SCEV *S) {
     auto *SU = dyn_cast<SCEVUnknown>(S);
@@ -4568,6 +4580,18 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
 
   if (const SCEV *S = getExistingSCEV(V))
     return S;
+  // The allocator never shrinks, so once over budget every later query for V
+  // also lands here and gets the same SCEV. Constants are still folded and
+  // unreachable instructions still map to poison, as in createSCEV, because
+  // callers rely on both.
+  if (isOverNodeMemoryBudget()) {
+    if (auto *CI = dyn_cast<ConstantInt>(V))
+      return getConstant(CI);
+    if (auto *I = dyn_cast<Instruction>(V))
+      if (!DT.isReachableFromEntry(I->getParent()))
+        return getUnknown(PoisonValue::get(V->getType()));
+    return getUnknown(V);
+  }
   return createSCEVIter(V);
 }
 
@@ -8344,6 +8368,9 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
       BackedgeTakenCounts.insert({L, BackedgeTakenInfo()});
   if (!Pair.second)
     return Pair.first->second;
+  // Leave the CouldNotCompute entry in place when over the memory budget.
+  if (isOverNodeMemoryBudget())
+    return Pair.first->second;
 
   // computeBackedgeTakenCount may allocate memory for its result. Inserting it
   // into the BackedgeTakenCounts map transfers ownership. Otherwise, the result
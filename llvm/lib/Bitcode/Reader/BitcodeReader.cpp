@@ -72,6 +72,7 @@
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/ModRef.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 #include <algorithm>
@@ -101,6 +102,11 @@ static cl::opt<bool> ExpandConstantExprs(
     cl::desc(
         "Expand constant expressions to instructions for testing purposes"));
 
+static cl::opt<bool> ParallelDecodeFunctionBodies(
+    "bitcode-parallel-decode", cl::init(false), cl::Hidden,
+    cl::desc("When materializing a whole module, decode the records of all "
+             "function blocks in parallel before building the IR"));
+
 /// Load bitcode directly into RemoveDIs format (use debug records instead
 /// of debug intrinsics). UNSET is treated as FALSE, so the default action
 /// is to do nothing. Individual tools can override this to incrementally add
@@ -658,6 +664,32 @@ class BitcodeReader : public BitcodeReaderBase, public GVMaterializer {
   /// where to find deferred function body in the stream.
   DenseMap<Function*, uint64_t> DeferredFunctionInfo;
 
+  /// The records of a function block, decoded ahead of time by
+  /// predecodeFunctionBodies so that parseFunctionBody only has to replay
+  /// them. Nested blocks are not decoded; only their position is recorded, and
+  /// they are read from the stream as usual when they are reached.
+  struct DecodedFunctionBlock {
+    struct Item {
+      BitstreamEntry Entry;
+      /// For records, the record code; for sub-blocks, the bit position just
+      /// past the block ID.
+      uint64_t CodeOrBitNo;
+      /// The end of the record's operands in Ops.
+      unsigned OpsEnd;
+    };
+    SmallVector<Item, 0> Items;
+    SmallVector<uint64_t, 0> Ops;
+    unsigned NextItem = 0;
+    unsigned NextOp = 0;
+
+    static Expected<std::unique_ptr<DecodedFunctionBlock>>
+    decode(BitstreamCursor Stream, uint64_t BitNo);
+    Expected<BitstreamEntry> advance(BitstreamCursor &Stream);
+    Expected<unsigned> readRecord(SmallVectorImpl<uint64_t> &Record);
+  };
+  DenseMap<Function *, std::unique_ptr<DecodedFunctionBlock>>
+      DecodedFunctionBlocks;
+
   /// When Metadata block is initially scanned when parsing the module, we may
   /// choose to defer parsing of the metadata. This vector contains info about
   /// which Metadata blocks are deferred.
@@ -894,6 +926,7 @@ private:
   Error parseGlobalValueSymbolTable();
   Error parseConstants();
   Error rememberAndSkipFunctionBodies();
+  void predecodeFunctionBodies();
   Error rememberAndSkipFunctionBody();
   /// Save the positions of the Metadata blocks and skip parsing the blocks.
   Error rememberAndSkipMetadata();
@@ -4779,10 +4812,118 @@ Error BitcodeReader::propagateAttributeTypes(CallBase *CB,
   return Error::success();
 }
 
+Expected<std::unique_ptr<BitcodeReader::DecodedFunctionBlock>>
+BitcodeReader::DecodedFunctionBlock::decode(BitstreamCursor Stream,
+                                            uint64_t BitNo) {
+  if (Error JumpFailed = Stream.JumpToBit(BitNo))
+    return std::move(JumpFailed);
+  if (Error Err = Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
+    return std::move(Err);
+
+  auto Block = std::make_unique<DecodedFunctionBlock>();
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Stream.advance();
+    if (!MaybeEntry)
+      return MaybeEntry.takeError();
+    BitstreamEntry Entry = MaybeEntry.get();
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+      return ::error("Malformed block");
+    case BitstreamEntry::EndBlock:
+      Block->Items.push_back({Entry, 0, unsigned(Block->Ops.size())});
+      return std::move(Block);
+    case BitstreamEntry::SubBlock:
+      Block->Items.push_back(
+          {Entry, Stream.GetCurrentBitNo(), unsigned(Block->Ops.size())});
+      if (Error Err = Stream.SkipBlock())
+        return std::move(Err);
+      break;
+    case BitstreamEntry::Record: {
+      Expected<unsigned> MaybeBitCode = Stream.readRecord(Entry.ID, Block->Ops);
+      if (!MaybeBitCode)
+        return MaybeBitCode.takeError();
+      Block->Items.push_back(
+          {Entry, MaybeBitCode.get(), unsigned(Block->Ops.size())});
+      break;
+    }
+    }
+  }
+}
+
+Expected<BitstreamEntry>
+BitcodeReader::DecodedFunctionBlock::advance(BitstreamCursor &Stream) {
+  assert(NextItem < Items.size() && "Read past the end of the block");
+  const Item &I = Items[NextItem];
+  // Position the stream at the nested block so that it can be entered or
+  // skipped exactly as if it had just been reached by Stream.advance().
+  if (I.Entry.Kind == BitstreamEntry::SubBlock)
+    if (Error JumpFailed = Stream.JumpToBit(I.CodeOrBitNo))
+      return std::move(JumpFailed);
+  // Records are consumed by readRecord.
+  if (I.Entry.Kind != BitstreamEntry::Record)
+    ++NextItem;
+  return I.Entry;
+}
+
+Expected<unsigned> BitcodeReader::DecodedFunctionBlock::readRecord(
+    SmallVectorImpl<uint64_t> &Record) {
+  const Item &I = Items[NextItem++];
+  assert(I.Entry.Kind == BitstreamEntry::Record && "Not at a record");
+  Record.append(Ops.begin() + NextOp, Ops.begin() + I.OpsEnd);
+  NextOp = I.OpsEnd;
+  return I.CodeOrBitNo;
+}
+
+/// Decode the records of the function blocks of all functions still to be
+/// materialized on all available threads. LLVMContext is not thread-safe, so
+/// only the bitstream is read here; the IR is still built serially by
+/// parseFunctionBody, which replays the decoded records. Functions whose block
+/// fails to decode are left to parseFunctionBody to diagnose.
+void BitcodeReader::predecodeFunctionBodies() {
+  SmallVector<std::pair<Function *, uint64_t>, 0> Work;
+  for (Function &F : *TheModule) {
+    if (!F.isMaterializable())
+      continue;
+    auto DFII = DeferredFunctionInfo.find(&F);
+    if (DFII != DeferredFunctionInfo.end() && DFII->second)
+      Work.push_back({&F, DFII->second});
+  }
+  if (Work.size() < 2)
+    return;
+
+  std::vector<std::unique_ptr<DecodedFunctionBlock>> Blocks(Work.size());
+  parallelFor(0, Work.size(), [&](size_t I) {
+    // Each task works on its own copy of the cursor. The block info and the
+    // abbreviations inherited from the module block are only read.
+    Expected<std::unique_ptr<DecodedFunctionBlock>> BlockOrErr =
+        DecodedFunctionBlock::decode(Stream, Work[I].second);
+    if (BlockOrErr)
+      Blocks[I] = std::move(*BlockOrErr);
+    else
+      consumeError(BlockOrErr.takeError());
+  });
+
+  for (size_t I = 0, E = Work.size(); I != E; ++I)
+    if (Blocks[I])
+      DecodedFunctionBlocks[Work[I].first] = std::move(Blocks[I]);
+}
+
 /// Lazily parse the specified function body block.
 Error BitcodeReader::parseFunctionBody(Function *F) {
-  if (Error Err = Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
-    return Err;
+  // If the records of this block were decoded ahead of time, replay them
+  // instead of reading the stream. The stream is then only used for nested
+  // blocks, so the function block itself is never entered.
+  std::unique_ptr<DecodedFunctionBlock> Decoded;
+  auto DFBI = DecodedFunctionBlocks.find(F);
+  if (DFBI != DecodedFunctionBlocks.end()) {
+    Decoded = std::move(DFBI->second);
+    DecodedFunctionBlocks.erase(DFBI);
+  }
+
+  if (!Decoded)
+    if (Error Err = Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
+      return Err;
 
   // Unexpected unresolved metadata when parsing function.
   if (MDLoader->hasFwdRefs())
@@ -4828,7 +4969,8 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
   SmallVector<uint64_t, 64> Record;
 
   while (true) {
-    Expected<llvm::BitstreamEntry> MaybeEntry = Stream.advance();
+    Expected<llvm::BitstreamEntry> MaybeEntry =
+        Decoded ? Decoded->advance(Stream) : Stream.advance();
     if (!MaybeEntry)
       return MaybeEntry.takeError();
     llvm::BitstreamEntry Entry = MaybeEntry.get();
@@ -4880,7 +5022,9 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
     Record.clear();
     Instruction *I = nullptr;
     unsigned ResTypeID = InvalidTypeID;
-    Expected<unsigned> MaybeBitCode = Stream.readRecord(Entry.ID, Record);
+    Expected<unsigned> MaybeBitCode =
+        Decoded ? Decoded->readRecord(Record)
+                : Stream.readRecord(Entry.ID, Record);
     if (!MaybeBitCode)
       return MaybeBitCode.takeError();
     switch (unsigned BitCode = MaybeBitCode.get()) {
@@ -6986,6 +7130,9 @@ Error BitcodeReader::materializeModule() {
   // Promise to materialize all forward references.
   WillMaterializeAllForwardRefs = true;
 
+  if (ParallelDecodeFunctionBodies)
+    predecodeFunctionBodies();
+
   // Iterate over the module, deserializing any functions that are still on
   // disk.
   for (Function &F : *TheModule) {
@@ -7331,8 +7478,17 @@ std::vector<FunctionSummary::EdgeTy>
 ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
                                               bool IsOldProfileFormat,
                                               bool HasProfile, bool HasRelBF) {
+  // Each edge takes one record element for the callee plus the ones for its
+  // profile information. Reserve exactly the number of edges: the combined
+  // index of a large program keeps hundreds of millions of them alive during
+  // the thin link.
+  size_t Stride = 1;
+  if (IsOldProfileFormat)
+    Stride += HasProfile ? 2 : 1;
+  else if (HasProfile || HasRelBF)
+    Stride += 1;
   std::vector<FunctionSummary::EdgeTy> Ret;
-  Ret.reserve(Record.size());
+  Ret.reserve(Record.size() / Stride);
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     bool HasTailCall = false;
@@ -7717,6 +7873,13 @@ Error ModuleSummaryIndexBitcodeReader::parseEntireSummary(unsigned ID) {
       TheIndex.addGlobalValueSummary(std::get<0>(GUID), std::move(VS));
       break;
     }
+    // FS_PERMODULE_BODY_HASH: [valueid, hash]
+    case bitc::FS_PERMODULE_BODY_HASH: {
+      ValueInfo VI = std::get<0>(getValueInfoFromValueId(Record[0]));
+      if (GlobalValueSummary *S = TheIndex.findSummaryInModule(VI, ModulePath))
+        S->setBodyHash(Record[1]);
+      break;
+    }
     // FS_COMBINED is legacy and does not have support for the tail call flag.
     // FS_COMBINED: [valueid, modid, flags, instcount, fflags, numrefs,
     //               numrefs x valueid, n x (valueid)]
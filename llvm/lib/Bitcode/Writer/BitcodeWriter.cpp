@@ -4440,6 +4440,20 @@ void ModuleBitcodeWriterBase::writePerModuleGlobalValueSummary() {
     writeModuleLevelReferences(G, NameVals, FSModRefsAbbrev,
                                FSModVTableRefsAbbrev);
 
+  // Emit the definition hashes recorded with -module-summary-body-hashes.
+  auto WriteBodyHash = [&](const GlobalObject &GO) {
+    ValueInfo VI = Index->getValueInfo(GO.getGUID());
+    if (!VI || VI.getSummaryList().empty())
+      return;
+    if (uint64_t Hash = VI.getSummaryList()[0]->getBodyHash())
+      Stream.EmitRecord(bitc::FS_PERMODULE_BODY_HASH,
+                        ArrayRef<uint64_t>{VE.getValueID(&GO), Hash});
+  };
+  for (const Function &F : M)
+    WriteBodyHash(F);
+  for (const GlobalVariable &G : M.globals())
+    WriteBodyHash(G);
+
   for (const GlobalAlias &A : M.aliases()) {
     auto *Aliasee = A.getAliaseeObject();
     // Skip ifunc and nameless functions which don't have an entry in the
@@ -4866,6 +4880,7 @@ void ModuleBitcodeWriter::write() {
 
   // Emit function bodies.
   DenseMap<const Function *, uint64_t> FunctionToBitcodeIndex;
+  FunctionToBitcodeIndex.reserve(M.size());
   for (const Function &F : M)
     if (!F.isDeclaration())
       writeFunction(F, FunctionToBitcodeIndex);
@@ -49,7 +49,9 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
 #include "llvm/Target/TargetMachine.h"
@@ -80,6 +82,13 @@ static cl::opt<bool>
                            cl::desc("Generate DWARF4 type units."),
                            cl::init(false));
 
+static cl::opt<std::string> ExternalTypeSignaturesFile(
+    "dwarf-external-type-signatures", cl::Hidden,
+    cl::desc("File listing the type signatures, one hexadecimal value per "
+             "line, of types defined in full by another unit. Such types are "
+             "emitted as declarations only."),
+    cl::value_desc("filename"));
+
 static cl::opt<bool> SplitDwarfCrossCuReferences(
     "split-dwarf-cross-cu-references", cl::Hidden,
     cl::desc("Enable cross-cu references in DWO files"), cl::init(false));
@@ -401,6 +410,9 @@ DwarfDebug::DwarfDebug(AsmPrinter *A)
                        A->TM.getTargetTriple().isOSBinFormatWasm()) &&
                       GenerateDwarfTypeUnits;
 
+  if (!ExternalTypeSignaturesFile.empty())
+    loadExternalTypeSignatures(ExternalTypeSignaturesFile);
+
   TheAccelTableKind = computeAccelTableKind(
       DwarfVersion, GenerateTypeUnits, DebuggerTuning, A->TM.getTargetTriple());
 
@@ -3446,6 +3458,30 @@ uint64_t DwarfDebug::makeTypeSignature(StringRef Identifier) {
   return Result.high();
 }
 
+void DwarfDebug::loadExternalTypeSignatures(StringRef Filename) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(Filename, /*IsText=*/true);
+  if (!MBOrErr)
+    report_fatal_error("cannot read external type signatures from '" +
+                       Filename + "': " + MBOrErr.getError().message());
+  for (line_iterator I(**MBOrErr, /*SkipBlanks=*/true, '#'); !I.is_at_eof();
+       ++I) {
+    uint64_t Signature;
+    if (I->trim().getAsInteger(16, Signature))
+      report_fatal_error("invalid type signature '" + *I + "' in '" +
+                         Filename + "'");
+    ExternalTypeSignatures.insert(Signature);
+  }
+}
+
+bool DwarfDebug::isExternallyDefinedType(const DICompositeType *CTy) const {
+  if (ExternalTypeSignatures.empty() || CTy->isForwardDecl())
+    return false;
+  MDString *TypeId = CTy->getRawIdentifier();
+  return TypeId &&
+         ExternalTypeSignatures.count(makeTypeSignature(TypeId->getString()));
+}
+
 void DwarfDebug::addDwarfTypeUnitType(DwarfCompileUnit &CU,
                                       StringRef Identifier, DIE &RefDie,
                                       const DICompositeType *CTy) {
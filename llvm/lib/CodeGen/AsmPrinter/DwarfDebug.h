@@ -438,6 +438,10 @@ class DwarfDebug : public DebugHandlerBase {
   /// Generate DWARF v4 type units.
   bool GenerateTypeUnits;
 
+  /// Signatures of the types whose full definition is emitted by another
+  /// unit, see -dwarf-external-type-signatures.
+  DenseSet<uint64_t> ExternalTypeSignatures;
+
   /// Emit a .debug_macro section instead of .debug_macinfo.
   bool UseDebugMacroSection;
 
@@ -694,6 +698,9 @@ private:
   /// Emit the reference to the section.
   void emitSectionReference(const DwarfCompileUnit &CU);
 
+  /// Read the signatures listed in \p Filename into ExternalTypeSignatures.
+  void loadExternalTypeSignatures(StringRef Filename);
+
 protected:
   /// Gather pre-function debug information.
   void beginFunctionImpl(const MachineFunction *MF) override;
@@ -789,6 +796,10 @@ public:
   /// Returns whether to generate DWARF v4 type units.
   bool generateTypeUnits() const { return GenerateTypeUnits; }
 
+  /// Returns whether \p CTy is a type whose full definition is emitted by
+  /// another unit, so that this unit only needs a declaration of it.
+  bool isExternallyDefinedType(const DICompositeType *CTy) const;
+
   // Experimental DWARF5 features.
 
   /// Returns what kind (if any) of accelerator tables to emit.
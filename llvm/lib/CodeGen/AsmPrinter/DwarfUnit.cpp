@@ -584,6 +584,14 @@ DIE *DwarfUnit::createTypeDIE(const DIScope *Context, DIE &ContextDIE,
   };
 
   if (auto *CTy = dyn_cast<DICompositeType>(Ty)) {
+    if (DD->isExternallyDefinedType(CTy)) {
+      // Another unit emits the definition; a declaration is enough here.
+      StringRef Name = CTy->getName();
+      if (!Name.empty())
+        addString(TyDIE, dwarf::DW_AT_name, Name);
+      addFlag(TyDIE, dwarf::DW_AT_declaration);
+      return &TyDIE;
+    }
     if (DD->generateTypeUnits() && !Ty->isForwardDecl() &&
         (Ty->getRawName() || CTy->getRawIdentifier())) {
       // Skip updating the accelerator tables since this is not the full type.
@@ -352,6 +352,21 @@ LiveRange::iterator LiveRange::find(SlotIndex Pos) {
                                [&](const Segment &X) { return X.end <= Pos; });
 }
 
+LiveRange::iterator LiveRange::gallopTo(iterator I, SlotIndex Pos) {
+  // I ends at or before Pos, and some segment ends after it. Double the step
+  // until a segment ending after Pos is found, then binary search the last
+  // step.
+  size_t Step = 1;
+  size_t Remaining = end() - I;
+  while (Step < Remaining && I[Step].end <= Pos) {
+    I += Step;
+    Remaining -= Step;
+    Step *= 2;
+  }
+  return std::partition_point(I, I + std::min(Step + 1, Remaining),
+                              [&](const Segment &X) { return X.end <= Pos; });
+}
+
 VNInfo *LiveRange::createDeadDef(SlotIndex Def, VNInfo::Allocator &VNIAlloc) {
   // Use the segment set, if it is available.
   if (segmentSet != nullptr)
@@ -72,6 +72,7 @@
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/SuffixArray.h"
 #include "llvm/Support/SuffixTree.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
@@ -116,6 +117,11 @@ static cl::opt<unsigned> OutlinerReruns(
     cl::desc(
         "Number of times to rerun the outliner after the initial outline"));
 
+static cl::opt<bool> OutlinerUseSuffixArray(
+    "outliner-use-suffix-array", cl::init(false), cl::Hidden,
+    cl::desc("Find repeated sequences with a suffix array instead of a suffix "
+             "tree, which needs much less memory on large modules"));
+
 static cl::opt<unsigned> OutlinerBenefitThreshold(
     "outliner-benefit-threshold", cl::init(1), cl::Hidden,
     cl::desc(
@@ -576,15 +582,24 @@ void MachineOutliner::emitOutlinedFunctionRemark(OutlinedFunction &OF) {
 void MachineOutliner::findCandidates(
     InstructionMapper &Mapper, std::vector<OutlinedFunction> &FunctionList) {
   FunctionList.clear();
-  SuffixTree ST(Mapper.UnsignedVec);
 
   // First, find all of the repeated substrings in the tree of minimum length
-  // 2.
+  // 2. Only the result is kept, so the tree or array is released before the
+  // candidates are evaluated.
+  std::vector<SuffixTree::RepeatedSubstring> RepeatedSubstrings;
+  if (OutlinerUseSuffixArray) {
+    RepeatedSubstrings =
+        SuffixArray(Mapper.UnsignedVec).getRepeatedSubstrings();
+  } else {
+    SuffixTree ST(Mapper.UnsignedVec);
+    for (SuffixTree::RepeatedSubstring &RS : ST)
+      RepeatedSubstrings.push_back(std::move(RS));
+  }
   std::vector<Candidate> CandidatesForRepeatedSeq;
   LLVM_DEBUG(dbgs() << "*** Discarding overlapping candidates *** \n");
   LLVM_DEBUG(
       dbgs() << "Searching for overlaps in all repeated sequences...\n");
-  for (SuffixTree::RepeatedSubstring &RS : ST) {
+  for (SuffixTree::RepeatedSubstring &RS : RepeatedSubstrings) {
     CandidatesForRepeatedSeq.clear();
     unsigned StringLen = RS.Length;
     LLVM_DEBUG(dbgs() << "  Sequence length: " << StringLen << "\n");
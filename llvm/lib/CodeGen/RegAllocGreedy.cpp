@@ -81,6 +81,8 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumOverSelectionBudget,
+          "Number of functions that exhausted the selection budget");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -127,6 +129,14 @@ static cl::opt<unsigned long> GrowRegionComplexityBudget(
              "limit its budget and bail out once we reach the limit."),
     cl::init(10000), cl::Hidden);
 
+static cl::opt<unsigned> GreedySelectionBudget(
+    "greedy-selection-budget",
+    cl::desc("Number of live range selections per function after which the "
+             "greedy allocator stops evicting and splitting, and spills the "
+             "remaining live ranges that are not assigned right away "
+             "(0 = unlimited)"),
+    cl::init(0), cl::Hidden);
+
 static cl::opt<bool> GreedyRegClassPriorityTrumpsGlobalness(
     "greedy-regclass-priority-trumps-globalness",
     cl::desc("Change the greedy register allocator's live range priority "
@@ -2147,6 +2157,21 @@ MCRegister RAGreedy::selectOrSplit(const LiveInterval &VirtReg,
   LLVMContext &Ctx = MF->getFunction().getContext();
   SmallVirtRegSet FixedRegisters;
   RecoloringStack RecolorStack;
+  if (GreedySelectionBudget && ++NumSelections == GreedySelectionBudget + 1) {
+    ++NumOverSelectionBudget;
+    using namespace ore;
+    ORE->emit([&]() {
+      DebugLoc Loc;
+      if (auto *SP = MF->getFunction().getSubprogram())
+        Loc = DILocation::get(SP->getContext(), SP->getLine(), 1, SP);
+      return MachineOptimizationRemarkMissed(DEBUG_TYPE, "SelectionBudget", Loc,
+                                             &MF->front())
+             << "selection budget of "
+             << NV("SelectionBudget", GreedySelectionBudget.getValue())
+             << " exhausted; spilling the remaining live ranges instead of "
+                "evicting or splitting";
+    });
+  }
   MCRegister Reg =
       selectOrSplitImpl(VirtReg, NewVRegs, FixedRegisters, RecolorStack);
   if (Reg == ~0U && (CutOffInfo != CO_None)) {
@@ -2407,6 +2432,10 @@ void RAGreedy::tryHintsRecoloring() {
   }
 }
 
+bool RAGreedy::isOverSelectionBudget() const {
+  return GreedySelectionBudget && NumSelections > GreedySelectionBudget;
+}
+
 MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
                                        SmallVectorImpl<Register> &NewVRegs,
                                        SmallVirtRegSet &FixedRegisters,
@@ -2440,10 +2469,16 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
   LLVM_DEBUG(dbgs() << StageName[Stage] << " Cascade "
                     << ExtraInfo->getCascade(VirtReg.reg()) << '\n');
 
+  // Once the selection budget is used up, spill ranges that did not fit right
+  // away rather than evicting or splitting for them. Ranges that cannot be
+  // spilled still go through the full process.
+  bool SpillOnly =
+      isOverSelectionBudget() && Stage < RS_Done && VirtReg.isSpillable();
+
   // Try to evict a less worthy live range, but only for ranges from the primary
   // queue. The RS_Split ranges already failed to do this, and they should not
   // get a second chance until they have been split.
-  if (Stage != RS_Split)
+  if (Stage != RS_Split && !SpillOnly)
     if (Register PhysReg =
             tryEvict(VirtReg, Order, NewVRegs, CostPerUseLimit,
                      FixedRegisters)) {
@@ -2463,14 +2498,14 @@ MCRegister RAGreedy::selectOrSplitImpl(const LiveInterval &VirtReg,
   // The first time we see a live range, don't try to split or spill.
   // Wait until the second time, when all smaller ranges have been allocated.
   // This gives a better picture of the interference to split around.
-  if (Stage < RS_Split) {
+  if (Stage < RS_Split && !SpillOnly) {
     ExtraInfo->setStage(VirtReg, RS_Split);
     LLVM_DEBUG(dbgs() << "wait for second round\n");
     NewVRegs.push_back(VirtReg.reg());
     return 0;
   }
 
-  if (Stage < RS_Spill) {
+  if (Stage < RS_Spill && !SpillOnly) {
     // Try splitting VirtReg or interferences.
     unsigned NewVRegSizeBefore = NewVRegs.size();
     Register PhysReg = trySplit(VirtReg, Order, NewVRegs, FixedRegisters);
@@ -2767,6 +2802,7 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   IntfCache.init(MF, Matrix->getLiveUnions(), Indexes, LIS, TRI);
   GlobalCand.resize(32);  // This will grow as needed.
   SetOfBrokenHints.clear();
+  NumSelections = 0;
 
   allocatePhysRegs();
   tryHintsRecoloring();
@@ -280,6 +280,10 @@ private:
 
   bool ReverseLocalAssignment = false;
 
+  /// Number of selectOrSplit() queries made for the current function, checked
+  /// against -greedy-selection-budget.
+  unsigned NumSelections = 0;
+
 public:
   RAGreedy(const RegClassFilterFunc F = allocateAllRegClasses);
 
@@ -312,6 +316,7 @@ public:
   static char ID;
 
 private:
+  bool isOverSelectionBudget() const;
   MCRegister selectOrSplitImpl(const LiveInterval &,
                                SmallVectorImpl<Register> &, SmallVirtRegSet &,
                                RecoloringStack &, unsigned = 0);
@@ -1404,11 +1404,20 @@ void DWARFLinkerImpl::cleanupDataAfterDWARFOutputIsWritten() {
 }
 
 void DWARFLinkerImpl::writeCompileUnitsToTheOutput() {
+  // Statistics are computed from the section sizes after the output is
+  // written, so the contents have to stay alive in that case.
+  bool ReleaseContents = !GlobalData.getOptions().Statistics;
+
   // Enumerate all sections and store them into the final emitter.
   forEachObjectSectionsSet([&](OutputSections &Sections) {
     Sections.forEach([&](std::shared_ptr<SectionDescriptor> OutSection) {
       // Emit section content.
       SectionHandler(OutSection);
+
+      // The handler has copied the data out; drop it now instead of keeping
+      // the output of every unit alive until the link is finished.
+      if (ReleaseContents)
+        OutSection->clearSectionContent();
     });
   });
 }
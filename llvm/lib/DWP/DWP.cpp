@@ -20,7 +20,9 @@
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include <limits>
+#include <optional>
 
 using namespace llvm;
 using namespace llvm::object;
@@ -333,7 +335,16 @@ static Error createError(StringRef Name, Error E) {
 
 static Error
 handleCompressedSection(std::deque<SmallString<32>> &UncompressedSections,
-                        SectionRef Sec, StringRef Name, StringRef &Contents) {
+                        SectionRef Sec, StringRef Name, StringRef &Contents,
+                        const DenseMap<const char *, StringRef> *Decompressed =
+                            nullptr) {
+  if (Decompressed) {
+    auto It = Decompressed->find(Contents.data());
+    if (It != Decompressed->end()) {
+      Contents = It->second;
+      return Error::success();
+    }
+  }
   auto *Obj = dyn_cast<ELFObjectFileBase>(Sec.getObject());
   if (!Obj ||
       !(static_cast<ELFSectionRef>(Sec).getFlags() & ELF::SHF_COMPRESSED))
@@ -354,6 +365,32 @@ handleCompressedSection(std::deque<SmallString<32>> &UncompressedSections,
   return Error::success();
 }
 
+// Decompresses \p Sec ahead of handleSection(), which then picks up the result
+// from \p Decompressed. Anything that fails here is left for handleSection()
+// to diagnose.
+static void
+decompressSectionEarly(std::deque<SmallString<32>> &UncompressedSections,
+                       DenseMap<const char *, StringRef> &Decompressed,
+                       SectionRef Sec) {
+  if (Sec.isBSS() || Sec.isVirtual())
+    return;
+  Expected<StringRef> NameOrErr = Sec.getName();
+  Expected<StringRef> ContentsOrErr = Sec.getContents();
+  if (!NameOrErr || !ContentsOrErr) {
+    consumeError(NameOrErr.takeError());
+    consumeError(ContentsOrErr.takeError());
+    return;
+  }
+  StringRef Contents = *ContentsOrErr;
+  if (Error E = handleCompressedSection(UncompressedSections, Sec, *NameOrErr,
+                                        Contents)) {
+    consumeError(std::move(E));
+    return;
+  }
+  if (Contents.data() != ContentsOrErr->data())
+    Decompressed[ContentsOrErr->data()] = Contents;
+}
+
 namespace llvm {
 // Parse and return the header of an info section compile/type unit.
 Expected<InfoSectionUnitHeader> parseInfoSectionUnitHeader(StringRef Info) {
@@ -541,7 +578,8 @@ Error handleSection(
     std::vector<StringRef> &CurTypesSection,
     std::vector<StringRef> &CurInfoSection, StringRef &AbbrevSection,
     StringRef &CurCUIndexSection, StringRef &CurTUIndexSection,
-    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength) {
+    std::vector<std::pair<DWARFSectionKind, uint32_t>> &SectionLength,
+    const DenseMap<const char *, StringRef> *Decompressed) {
   if (Section.isBSS())
     return Error::success();
 
@@ -559,7 +597,7 @@ Error handleSection(
   StringRef Contents = *ContentsOrErr;
 
   if (auto Err = handleCompressedSection(UncompressedSections, Section, Name,
-                                         Contents))
+                                         Contents, Decompressed))
     return Err;
 
   Name = Name.substr(Name.find_first_not_of("._"));
@@ -638,17 +676,46 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
 
   std::deque<SmallString<32>> UncompressedSections;
 
-  for (const auto &Input : Inputs) {
-    auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
-    if (!ErrOrObj) {
-      return handleErrors(ErrOrObj.takeError(),
-                          [&](std::unique_ptr<ECError> EC) -> Error {
-                            return createFileError(Input, Error(std::move(EC)));
-                          });
+  // Open the inputs and decompress their sections concurrently. The merge
+  // below stays serial because it emits the contributions in input order.
+  struct LoadedInput {
+    std::optional<Expected<OwningBinary<object::ObjectFile>>> Binary;
+    std::deque<SmallString<32>> UncompressedSections;
+    DenseMap<const char *, StringRef> Decompressed;
+  };
+  std::vector<LoadedInput> Loaded(Inputs.size());
+  parallelFor(0, Inputs.size(), [&](size_t I) {
+    LoadedInput &L = Loaded[I];
+    L.Binary.emplace(object::ObjectFile::createObjectFile(Inputs[I]));
+    if (!*L.Binary)
+      return;
+    for (const SectionRef &Section : (*L.Binary)->getBinary()->sections())
+      decompressSectionEarly(L.UncompressedSections, L.Decompressed, Section);
+  });
+
+  Error OpenErr = Error::success();
+  for (size_t I = 0, E = Inputs.size(); I != E; ++I) {
+    Expected<OwningBinary<object::ObjectFile>> &ErrOrObj = *Loaded[I].Binary;
+    if (ErrOrObj) {
+      Objects.push_back(std::move(*ErrOrObj));
+      continue;
     }
+    Error Err = handleErrors(ErrOrObj.takeError(),
+                             [&](std::unique_ptr<ECError> EC) -> Error {
+                               return createFileError(Inputs[I],
+                                                      Error(std::move(EC)));
+                             });
+    if (OpenErr)
+      consumeError(std::move(Err));
+    else
+      OpenErr = std::move(Err);
+  }
+  if (OpenErr)
+    return OpenErr;
 
-    auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+  for (size_t I = 0, E = Inputs.size(); I != E; ++I) {
+    const std::string &Input = Inputs[I];
+    auto &Obj = *Objects[I].getBinary();
 
     UnitIndexEntry CurEntry = {};
 
@@ -672,7 +739,7 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs,
               UncompressedSections, ContributionOffsets, CurEntry,
               CurStrSection, CurStrOffsetSection, CurTypesSection,
               CurInfoSection, AbbrevSection, CurCUIndexSection,
-              CurTUIndexSection, SectionLength))
+              CurTUIndexSection, SectionLength, &Loaded[I].Decompressed))
         return Err;
 
     if (CurInfoSection.empty())
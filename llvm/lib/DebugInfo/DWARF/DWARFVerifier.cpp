@@ -32,6 +32,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -405,6 +406,10 @@ bool DWARFVerifier::handleDebugAbbrev() {
 }
 
 unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
+  if (DCtx.isThreadSafe() && Units.size() > 1 &&
+      parallel::strategy.compute_thread_count() > 1)
+    return verifyUnitsInParallel(Units);
+
   unsigned NumDebugInfoErrors = 0;
   ReferenceMap CrossUnitReferences;
 
@@ -433,6 +438,64 @@ unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
   return NumDebugInfoErrors;
 }
 
+unsigned DWARFVerifier::verifyUnitsInParallel(const DWARFUnitVector &Units) {
+  // The abbreviation sets of all units are parsed lazily into one shared
+  // table, so look them up before extracting the units concurrently. Once
+  // every unit is extracted, verifying a unit only reads the DIEs of others.
+  for (const auto &Unit : Units)
+    Unit->getAbbreviations();
+  parallelForEach(Units, [](const std::unique_ptr<DWARFUnit> &Unit) {
+    // getNumDIEs() extracts all DIEs of the unit.
+    Unit->getNumDIEs();
+    Unit->getBaseAddress();
+  });
+
+  struct UnitResult {
+    std::string Output;
+    unsigned NumErrors = 0;
+    ReferenceMap CrossUnitReferences;
+    OutputCategoryAggregator ErrorCategory;
+  };
+  std::vector<UnitResult> Results(Units.size());
+  parallelFor(0, Units.size(), [&](size_t I) {
+    DWARFUnit &Unit = *Units[I];
+    UnitResult &Result = Results[I];
+    raw_string_ostream UnitOS(Result.Output);
+    DWARFVerifier UnitVerifier(UnitOS, DCtx, DumpOpts);
+
+    UnitOS << "Verifying unit: " << I + 1 << " / " << Units.getNumUnits();
+    if (const char *Name = Unit.getUnitDIE(true).getShortName())
+      UnitOS << ", \"" << Name << '\"';
+    UnitOS << '\n';
+    ReferenceMap UnitLocalReferences;
+    Result.NumErrors += UnitVerifier.verifyUnitContents(
+        Unit, UnitLocalReferences, Result.CrossUnitReferences);
+    Result.NumErrors += UnitVerifier.verifyDebugInfoReferences(
+        UnitLocalReferences, [&](uint64_t Offset) { return &Unit; });
+    Result.ErrorCategory = std::move(UnitVerifier.ErrorCategory);
+  });
+
+  unsigned NumDebugInfoErrors = 0;
+  ReferenceMap CrossUnitReferences;
+  for (UnitResult &Result : Results) {
+    OS << Result.Output;
+    NumDebugInfoErrors += Result.NumErrors;
+    for (const auto &[Offset, Referrers] : Result.CrossUnitReferences)
+      CrossUnitReferences[Offset].insert(Referrers.begin(), Referrers.end());
+    ErrorCategory.Merge(Result.ErrorCategory);
+  }
+  OS.flush();
+
+  NumDebugInfoErrors += verifyDebugInfoReferences(
+      CrossUnitReferences, [&](uint64_t Offset) -> DWARFUnit * {
+        if (DWARFUnit *U = Units.getUnitForOffset(Offset))
+          return U;
+        return nullptr;
+      });
+
+  return NumDebugInfoErrors;
+}
+
 unsigned DWARFVerifier::verifyUnitSection(const DWARFSection &S) {
   const DWARFObject &DObj = DCtx.getDWARFObj();
   DWARFDataExtractor DebugInfoData(DObj, S, DCtx.isLittleEndian(), 0);
@@ -2028,6 +2091,11 @@ void OutputCategoryAggregator::EnumerateResults(
   }
 }
 
+void OutputCategoryAggregator::Merge(const OutputCategoryAggregator &Other) {
+  for (const auto &[Name, Count] : Other.Aggregation)
+    Aggregation[Name] += Count;
+}
+
 void DWARFVerifier::summarize() {
   if (DumpOpts.ShowAggregateErrors && ErrorCategory.GetNumCategories()) {
     error() << "Aggregated error counts:\n";
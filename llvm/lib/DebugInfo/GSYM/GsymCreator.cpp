@@ -11,6 +11,7 @@
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
@@ -227,7 +228,7 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
   if (!IsSegment) {
     if (NumBefore > 1) {
       // Sort function infos so we can emit sorted functions.
-      llvm::sort(Funcs);
+      llvm::parallelSort(Funcs.begin(), Funcs.end());
       std::vector<FunctionInfo> FinalizedFuncs;
       FinalizedFuncs.reserve(Funcs.size());
       FinalizedFuncs.emplace_back(std::move(Funcs.front()));
@@ -299,6 +300,10 @@ llvm::Error GsymCreator::finalize(OutputAggregator &Out) {
     }
     Out << "Pruned " << NumBefore - Funcs.size() << " functions, ended with "
         << Funcs.size() << " total\n";
+
+    // Encode the function infos up front, in parallel, so that encode() only
+    // has to copy the bytes when saving in native byte order.
+    parallelForEach(Funcs, [](FunctionInfo &FI) { FI.cacheEncoding(); });
   }
   return Error::success();
 }
@@ -346,6 +351,9 @@ void GsymCreator::forEachFunctionInfo(
     std::function<bool(FunctionInfo &)> const &Callback) {
   std::lock_guard<std::mutex> Guard(Mutex);
   for (auto &FI : Funcs) {
+    // The callback may modify the function info, which invalidates any
+    // encoding cached by finalize().
+    FI.EncodingCache.clear();
     if (!Callback(FI))
       break;
   }
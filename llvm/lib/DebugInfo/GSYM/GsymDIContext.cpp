@@ -0,0 +1,113 @@
+//===-- GsymDIContext.cpp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/GSYM/GsymDIContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/Support/Path.h"
+
+using namespace llvm;
+using namespace llvm::gsym;
+
+GsymDIContext::GsymDIContext(std::unique_ptr<GsymReader> Reader)
+    : DIContext(CK_GSYM), Reader(std::move(Reader)) {}
+
+GsymDIContext::~GsymDIContext() = default;
+
+void GsymDIContext::dump(raw_ostream &OS, DIDumpOptions DumpOpts) {}
+
+// Fill in the file and function name of \p LineInfo from \p Location, as
+// requested by \p Specifier.
+static void fillLineInfo(DILineInfo &LineInfo, const SourceLocation &Location,
+                         DILineInfoSpecifier Specifier) {
+  if (Specifier.FNKind != DINameKind::None && !Location.Name.empty())
+    LineInfo.FunctionName = Location.Name.str();
+
+  switch (Specifier.FLIKind) {
+  case DILineInfoSpecifier::FileLineInfoKind::None:
+    return;
+  case DILineInfoSpecifier::FileLineInfoKind::BaseNameOnly:
+    if (!Location.Base.empty())
+      LineInfo.FileName = Location.Base.str();
+    break;
+  case DILineInfoSpecifier::FileLineInfoKind::RawValue:
+  case DILineInfoSpecifier::FileLineInfoKind::RelativeFilePath:
+  case DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath: {
+    // GSYM only keeps the directory and base name of each file.
+    SmallString<128> Path(Location.Dir);
+    sys::path::append(Path, Location.Base);
+    if (!Path.empty())
+      LineInfo.FileName = std::string(Path);
+    break;
+  }
+  }
+  LineInfo.Line = Location.Line;
+}
+
+DILineInfo
+GsymDIContext::getLineInfoForAddress(object::SectionedAddress Address,
+                                     DILineInfoSpecifier Specifier) {
+  DILineInfo LineInfo;
+  Expected<LookupResult> Result = Reader->lookup(Address.Address);
+  if (!Result) {
+    consumeError(Result.takeError());
+    return LineInfo;
+  }
+
+  // The deepest inlined function comes first.
+  if (!Result->Locations.empty()) {
+    fillLineInfo(LineInfo, Result->Locations.front(), Specifier);
+  } else if (Specifier.FNKind != DINameKind::None) {
+    LineInfo.FunctionName = Result->FuncName.str();
+  }
+  LineInfo.StartAddress = Result->FuncRange.start();
+  return LineInfo;
+}
+
+DILineInfo
+GsymDIContext::getLineInfoForDataAddress(object::SectionedAddress Address) {
+  // GSYM does not record data symbols.
+  return DILineInfo();
+}
+
+DILineInfoTable
+GsymDIContext::getLineInfoForAddressRange(object::SectionedAddress Address,
+                                          uint64_t Size,
+                                          DILineInfoSpecifier Specifier) {
+  // Range queries are used by JIT listeners and llvm-rtdyld only.
+  return DILineInfoTable();
+}
+
+DIInliningInfo
+GsymDIContext::getInliningInfoForAddress(object::SectionedAddress Address,
+                                         DILineInfoSpecifier Specifier) {
+  DIInliningInfo InlineInfo;
+  Expected<LookupResult> Result = Reader->lookup(Address.Address);
+  if (!Result) {
+    consumeError(Result.takeError());
+    return InlineInfo;
+  }
+
+  for (const SourceLocation &Location : Result->Locations) {
+    DILineInfo LineInfo;
+    fillLineInfo(LineInfo, Location, Specifier);
+    InlineInfo.addFrame(LineInfo);
+  }
+  if (InlineInfo.getNumberOfFrames() == 0) {
+    DILineInfo LineInfo;
+    if (Specifier.FNKind != DINameKind::None)
+      LineInfo.FunctionName = Result->FuncName.str();
+    InlineInfo.addFrame(LineInfo);
+  }
+  return InlineInfo;
+}
+
+std::vector<DILocal>
+GsymDIContext::getLocalsForAddress(object::SectionedAddress Address) {
+  // GSYM does not record local variables.
+  return {};
+}
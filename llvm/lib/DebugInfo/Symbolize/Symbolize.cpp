@@ -13,8 +13,15 @@
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/DebugInfo/BTF/BTFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/GSYM/DwarfTransformer.h"
+#include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymDIContext.h"
+#include "llvm/DebugInfo/GSYM/GsymReader.h"
+#include "llvm/DebugInfo/GSYM/ObjectFileTransformer.h"
+#include "llvm/DebugInfo/GSYM/OutputAggregator.h"
 #include "llvm/DebugInfo/PDB/PDB.h"
 #include "llvm/DebugInfo/PDB/PDBContext.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableObjectFile.h"
@@ -31,6 +38,8 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/WithColor.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
@@ -599,6 +608,81 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
   return InsertResult.first->second.get();
 }
 
+// Convert the DWARF and symbol table of \p Obj to GSYM and save it to \p Path.
+static Error convertToGsym(const ObjectFile &Obj, StringRef Path) {
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
+      Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr,
+      /*DWPName=*/"", WithColor::defaultErrorHandler,
+      WithColor::defaultWarningHandler, /*ThreadSafe=*/true);
+
+  gsym::GsymCreator Gsym(/*Quiet=*/true);
+  AddressRanges TextRanges;
+  for (const SectionRef &Sect : Obj.sections()) {
+    if (!Sect.isText() || Sect.getSize() == 0)
+      continue;
+    TextRanges.insert(
+        AddressRange(Sect.getAddress(), Sect.getAddress() + Sect.getSize()));
+  }
+  if (!TextRanges.empty())
+    Gsym.SetValidTextRanges(TextRanges);
+
+  gsym::OutputAggregator Out(nullptr);
+  gsym::DwarfTransformer DT(*DICtx, Gsym);
+  if (Error Err = DT.convert(hardware_concurrency().compute_thread_count(), Out))
+    return Err;
+  if (Error Err = gsym::ObjectFileTransformer::convert(Obj, Out, Gsym))
+    return Err;
+  if (Error Err = Gsym.finalize(Out))
+    return Err;
+
+  // Write to a temporary file first so that concurrent symbolizers never see
+  // a partially written cache entry.
+  SmallString<128> TempPath;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + "-%%%%%%%%.tmp", TempPath))
+    return errorCodeToError(EC);
+  llvm::endianness Endian = Obj.isLittleEndian() ? llvm::endianness::little
+                                                 : llvm::endianness::big;
+  if (Error Err = Gsym.save(TempPath, Endian)) {
+    sys::fs::remove(TempPath);
+    return Err;
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    return errorCodeToError(EC);
+  }
+  return Error::success();
+}
+
+std::unique_ptr<DIContext>
+LLVMSymbolizer::createGsymContext(const ObjectFile &Obj,
+                                  const ObjectFile &DbgObj) {
+  BuildIDRef BuildID = getBuildID(&Obj);
+  if (BuildID.empty() || !DbgObj.hasDebugInfo())
+    return nullptr;
+
+  SmallString<128> Path(Opts.GsymCacheDirectory);
+  sys::path::append(Path, toHex(BuildID, /*LowerCase=*/true) + ".gsym");
+
+  Expected<gsym::GsymReader> ReaderOrErr = gsym::GsymReader::openFile(Path);
+  if (!ReaderOrErr) {
+    consumeError(ReaderOrErr.takeError());
+    if (sys::fs::create_directories(Opts.GsymCacheDirectory))
+      return nullptr;
+    if (Error Err = convertToGsym(DbgObj, Path)) {
+      consumeError(std::move(Err));
+      return nullptr;
+    }
+    ReaderOrErr = gsym::GsymReader::openFile(Path);
+    if (!ReaderOrErr) {
+      consumeError(ReaderOrErr.takeError());
+      return nullptr;
+    }
+  }
+  return std::make_unique<gsym::GsymDIContext>(
+      std::make_unique<gsym::GsymReader>(std::move(*ReaderOrErr)));
+}
+
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   std::string BinaryName = ModuleName;
@@ -656,6 +740,8 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       Context.reset(new PDBContext(*CoffObject, std::move(Session)));
     }
   }
+  if (!Context && !Opts.GsymCacheDirectory.empty())
+    Context = createGsymContext(*Objects.first, *Objects.second);
   if (!Context)
     Context = DWARFContext::create(
         *Objects.second, DWARFContext::ProcessDebugRelocations::Process,
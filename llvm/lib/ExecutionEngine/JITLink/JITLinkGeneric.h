@@ -14,6 +14,7 @@
 #define LIB_EXECUTIONENGINE_JITLINK_JITLINKGENERIC_H
 
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/Support/Parallel.h"
 
 #define DEBUG_TYPE "jitlink"
 
@@ -132,14 +133,17 @@ private:
   Error fixUpBlocks(LinkGraph &G) const override {
     LLVM_DEBUG(dbgs() << "Fixing up blocks:\n");
 
+    // Fixups only write to the content of the block that they belong to, and
+    // only read the graph otherwise, so distinct blocks can be fixed up
+    // concurrently. Collect the blocks up front, copying the content of
+    // no-alloc blocks into the graph's allocator (which isn't thread-safe)
+    // while doing so.
+    SmallVector<std::pair<Block *, bool>, 0> Blocks;
+    size_t NumRelocations = 0;
     for (auto &Sec : G.sections()) {
       bool NoAllocSection = Sec.getMemLifetime() == orc::MemLifetime::NoAlloc;
 
       for (auto *B : Sec.blocks()) {
-        LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
-
-        // Copy Block data and apply fixups.
-        LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
         assert((!B->isZeroFill() || all_of(B->edges(),
                                            [](const Edge &E) {
                                              return E.getKind() ==
@@ -153,25 +157,49 @@ private:
         if (NoAllocSection)
           (void)B->getMutableContent(G);
 
-        for (auto &E : B->edges()) {
+        Blocks.push_back({B, NoAllocSection});
+        NumRelocations += B->edges_size();
+      }
+    }
+
+    // Spreading the work over threads only pays off for large graphs.
+    constexpr size_t MinRelocationsForParallelFixups = 16384;
+    bool RunInParallel = NumRelocations >= MinRelocationsForParallelFixups;
+    LLVM_DEBUG(RunInParallel = false);
 
-          // Skip non-relocation edges.
-          if (!E.isRelocation())
-            continue;
+    if (RunInParallel)
+      return parallelForEachError(Blocks, [&](std::pair<Block *, bool> &P) {
+        return fixUpBlock(G, *P.first, P.second);
+      });
 
-          // If B is a block in a Standard or Finalize section then make sure
-          // that no edges point to symbols in NoAlloc sections.
-          assert((NoAllocSection || !E.getTarget().isDefined() ||
-                  E.getTarget().getBlock().getSection().getMemLifetime() !=
-                      orc::MemLifetime::NoAlloc) &&
-                 "Block in allocated section has edge pointing to no-alloc "
-                 "section");
+    for (auto &[B, NoAllocSection] : Blocks)
+      if (auto Err = fixUpBlock(G, *B, NoAllocSection))
+        return Err;
 
-          // Dispatch to LinkerImpl for fixup.
-          if (auto Err = impl().applyFixup(G, *B, E))
-            return Err;
-        }
-      }
+    return Error::success();
+  }
+
+  Error fixUpBlock(LinkGraph &G, Block &B, bool NoAllocSection) const {
+    LLVM_DEBUG(dbgs() << "  " << B << ":\n");
+    LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
+
+    for (auto &E : B.edges()) {
+
+      // Skip non-relocation edges.
+      if (!E.isRelocation())
+        continue;
+
+      // If B is a block in a Standard or Finalize section then make sure that
+      // no edges point to symbols in NoAlloc sections.
+      assert((NoAllocSection || !E.getTarget().isDefined() ||
+              E.getTarget().getBlock().getSection().getMemLifetime() !=
+                  orc::MemLifetime::NoAlloc) &&
+             "Block in allocated section has edge pointing to no-alloc "
+             "section");
+
+      // Dispatch to LinkerImpl for fixup.
+      if (auto Err = impl().applyFixup(G, B, E))
+        return Err;
     }
 
     return Error::success();
@@ -351,6 +351,35 @@ void SharedMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
     FR.Segments.push_back(SegReq);
   }
 
+  // Without batching support in the executor, send every request on its own.
+  if (!SAs.InitializeBatch) {
+    sendInitialize(Reservation->first, std::move(FR), std::move(OnInitialized));
+    return;
+  }
+
+  // Otherwise keep at most one request in flight, and queue the ones that
+  // arrive in the meantime so that they can share a single round trip.
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (InitializeInFlight) {
+      PendingInitializes.push_back(
+          {Reservation->first, std::move(FR), std::move(OnInitialized)});
+      return;
+    }
+    InitializeInFlight = true;
+  }
+
+  sendInitialize(Reservation->first, std::move(FR),
+                 [this, OnInitialized = std::move(OnInitialized)](
+                     Expected<ExecutorAddr> Result) mutable {
+                   sendPendingInitializes();
+                   OnInitialized(std::move(Result));
+                 });
+}
+
+void SharedMemoryMapper::sendInitialize(
+    ExecutorAddr Reservation, tpctypes::SharedMemoryFinalizeRequest FR,
+    OnInitializedFunction OnInitialized) {
   EPC.callSPSWrapperAsync<
       rt::SPSExecutorSharedMemoryMapperServiceInitializeSignature>(
       SAs.Initialize,
@@ -363,7 +392,60 @@ void SharedMemoryMapper::initialize(MemoryMapper::AllocInfo &AI,
 
         OnInitialized(std::move(Result));
       },
-      SAs.Instance, Reservation->first, std::move(FR));
+      SAs.Instance, Reservation, std::move(FR));
+}
+
+void SharedMemoryMapper::sendPendingInitializes() {
+  std::vector<PendingInitialize> Batch;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (PendingInitializes.empty()) {
+      InitializeInFlight = false;
+      return;
+    }
+    std::swap(Batch, PendingInitializes);
+  }
+
+  std::vector<std::pair<ExecutorAddr, tpctypes::SharedMemoryFinalizeRequest>>
+      Requests;
+  std::vector<OnInitializedFunction> Callbacks;
+  Requests.reserve(Batch.size());
+  Callbacks.reserve(Batch.size());
+  for (auto &P : Batch) {
+    Requests.push_back({P.Reservation, std::move(P.FR)});
+    Callbacks.push_back(std::move(P.OnInitialized));
+  }
+
+  EPC.callSPSWrapperAsync<
+      rt::SPSExecutorSharedMemoryMapperServiceInitializeBatchSignature>(
+      SAs.InitializeBatch,
+      [this, Callbacks = std::move(Callbacks)](
+          Error SerializationErr,
+          Expected<std::vector<ExecutorAddr>> Result) mutable {
+        // Requests queued while this batch was in flight go out next.
+        sendPendingInitializes();
+
+        if (SerializationErr) {
+          cantFail(Result.takeError());
+          Result = std::move(SerializationErr);
+        }
+
+        if (!Result) {
+          // The executor rolls back failed batches, so every request in the
+          // batch fails with the same error.
+          std::string ErrMsg = toString(Result.takeError());
+          for (auto &OnInitialized : Callbacks)
+            OnInitialized(
+                make_error<StringError>(ErrMsg, inconvertibleErrorCode()));
+          return;
+        }
+
+        assert(Result->size() == Callbacks.size() &&
+               "Wrong number of results for batch");
+        for (size_t I = 0; I != Callbacks.size(); ++I)
+          Callbacks[I]((*Result)[I]);
+      },
+      SAs.Instance, Requests);
 }
 
 void SharedMemoryMapper::deinitialize(
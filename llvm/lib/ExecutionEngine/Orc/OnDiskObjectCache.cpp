@@ -0,0 +1,155 @@
+//===------- OnDiskObjectCache.cpp - Persistent object cache for ORC ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace orc {
+
+/// Writes the TargetOptions that affect the generated object code to \p OS.
+static void writeTargetOptionsKey(raw_ostream &OS, const TargetOptions &Opts) {
+  auto Flag = [&](bool B) { OS << (B ? '1' : '0'); };
+  Flag(Opts.UnsafeFPMath);
+  Flag(Opts.NoInfsFPMath);
+  Flag(Opts.NoNaNsFPMath);
+  Flag(Opts.NoTrappingFPMath);
+  Flag(Opts.NoSignedZerosFPMath);
+  Flag(Opts.ApproxFuncFPMath);
+  Flag(Opts.HonorSignDependentRoundingFPMathOption);
+  Flag(Opts.NoZerosInBSS);
+  Flag(Opts.GuaranteedTailCallOpt);
+  Flag(Opts.EnableFastISel);
+  Flag(Opts.EnableGlobalISel);
+  Flag(Opts.UseInitArray);
+  Flag(Opts.FunctionSections);
+  Flag(Opts.DataSections);
+  Flag(Opts.UniqueSectionNames);
+  Flag(Opts.TrapUnreachable);
+  Flag(Opts.NoTrapAfterNoreturn);
+  Flag(Opts.EmulatedTLS);
+  Flag(Opts.EnableTLSDESC);
+  Flag(Opts.EnableIPRA);
+  Flag(Opts.EnableMachineOutliner);
+  Flag(Opts.EmitAddrsig);
+  OS << '\0' << Opts.TLSSize << '\0' << Opts.LoopAlignment << '\0'
+     << static_cast<int>(Opts.FloatABIType) << '\0'
+     << static_cast<int>(Opts.AllowFPOpFusion) << '\0'
+     << static_cast<int>(Opts.ThreadModel) << '\0'
+     << static_cast<int>(Opts.EABIVersion) << '\0'
+     << static_cast<int>(Opts.ExceptionModel) << '\0'
+     << static_cast<int>(Opts.BBSections) << '\0'
+     << static_cast<int>(Opts.SwiftAsyncFramePointer) << '\0'
+     << Opts.getRawFPDenormalMode() << '\0'
+     << Opts.getRawFP32DenormalMode() << '\0'
+     << Opts.MCOptions.ABIName << '\0';
+}
+
+Expected<std::unique_ptr<OnDiskObjectCache>>
+OnDiskObjectCache::Create(StringRef CacheDir,
+                          const JITTargetMachineBuilder &JTMB,
+                          StringRef ExtraKey) {
+  if (auto EC = sys::fs::create_directories(CacheDir))
+    return createFileError(CacheDir, EC);
+
+  // Everything that affects the generated code, other than the module itself,
+  // goes into the target key.
+  std::string TargetKey;
+  raw_string_ostream OS(TargetKey);
+  OS << JTMB.getTargetTriple().str() << '\0' << JTMB.getCPU() << '\0'
+     << JTMB.getFeatures().getString() << '\0'
+     << static_cast<int>(JTMB.getCodeGenOptLevel()) << '\0';
+  if (JTMB.getRelocationModel())
+    OS << static_cast<int>(*JTMB.getRelocationModel());
+  OS << '\0';
+  if (JTMB.getCodeModel())
+    OS << static_cast<int>(*JTMB.getCodeModel());
+  OS << '\0';
+  writeTargetOptionsKey(OS, JTMB.getOptions());
+  OS << ExtraKey;
+  OS.flush();
+
+  return std::unique_ptr<OnDiskObjectCache>(
+      new OnDiskObjectCache(CacheDir, std::move(TargetKey)));
+}
+
+std::string OnDiskObjectCache::computeEntryPath(const Module &M) {
+  SmallVector<char, 0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(TargetKey);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, "obj-" + toHex(Hasher.result()) + ".o");
+  return std::string(Path);
+}
+
+std::unique_ptr<MemoryBuffer> OnDiskObjectCache::getObject(const Module *M) {
+  std::string Path = computeEntryPath(*M);
+
+  auto Buffer = MemoryBuffer::getFile(Path, /*IsText=*/false,
+                                      /*RequiresNullTerminator=*/false);
+  if (Buffer)
+    return std::move(*Buffer);
+
+  // Remember the path for the object that is about to be compiled.
+  std::lock_guard<std::mutex> Lock(PendingPathsMutex);
+  PendingPaths[M] = std::move(Path);
+  return nullptr;
+}
+
+void OnDiskObjectCache::notifyObjectCompiled(const Module *M,
+                                             MemoryBufferRef Obj) {
+  std::string Path;
+  {
+    std::lock_guard<std::mutex> Lock(PendingPathsMutex);
+    auto I = PendingPaths.find(M);
+    if (I != PendingPaths.end()) {
+      Path = std::move(I->second);
+      PendingPaths.erase(I);
+    }
+  }
+  if (Path.empty())
+    Path = computeEntryPath(*M);
+
+  // Write the object to a temporary file and move it into place, so that
+  // concurrent readers never observe a partially written entry. Failing to
+  // populate the cache is not an error: the object will just be compiled
+  // again next time.
+  int FD;
+  SmallString<128> TempPath;
+  if (sys::fs::createUniqueFile(Path + ".tmp-%%%%%%%%", FD, TempPath))
+    return;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Obj.getBuffer();
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return;
+    }
+  }
+  if (sys::fs::rename(TempPath, Path))
+    sys::fs::remove(TempPath);
+}
+
+} // end namespace orc
+} // end namespace llvm
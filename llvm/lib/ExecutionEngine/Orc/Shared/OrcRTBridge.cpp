@@ -34,6 +34,8 @@ const char *ExecutorSharedMemoryMapperServiceReserveWrapperName =
     "__llvm_orc_ExecutorSharedMemoryMapperService_Reserve";
 const char *ExecutorSharedMemoryMapperServiceInitializeWrapperName =
     "__llvm_orc_ExecutorSharedMemoryMapperService_Initialize";
+const char *ExecutorSharedMemoryMapperServiceInitializeBatchWrapperName =
+    "__llvm_orc_ExecutorSharedMemoryMapperService_InitializeBatch";
 const char *ExecutorSharedMemoryMapperServiceDeinitializeWrapperName =
     "__llvm_orc_ExecutorSharedMemoryMapperService_Deinitialize";
 const char *ExecutorSharedMemoryMapperServiceReleaseWrapperName =
@@ -16,6 +16,7 @@
 #include "llvm/Analysis/CFG.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/ProfileData/InstrProf.h"
 #include "llvm/Support/ErrorHandling.h"
 
 #include <algorithm>
@@ -26,9 +27,12 @@ SmallVector<const BasicBlock *, 8> findBBwithCalls(const Function &F,
                                                    bool IndirectCall = false) {
   SmallVector<const BasicBlock *, 8> BBs;
 
+  // Indirect calls with value profile data have known likely targets.
   auto findCallInst = [&IndirectCall](const Instruction &I) {
     if (auto Call = dyn_cast<CallBase>(&I))
-      return Call->isIndirectCall() ? IndirectCall : true;
+      return Call->isIndirectCall()
+                 ? IndirectCall || I.getMetadata(LLVMContext::MD_prof)
+                 : true;
     else
       return false;
   };
@@ -47,15 +51,67 @@ SmallVector<const BasicBlock *, 8> findBBwithCalls(const Function &F,
 namespace llvm {
 namespace orc {
 
-// Collect direct calls only
+const Function *SpeculateQuery::findFunctionByGUID(const Module &M,
+                                                   uint64_t GUID) {
+  std::lock_guard<std::mutex> Lock(FunctionsByGUID->Lock);
+  // The speculation layer queries all the functions of a module in a row, so
+  // the map is only rebuilt when it moves on to the next module.
+  if (FunctionsByGUID->M != &M ||
+      FunctionsByGUID->ModuleID != M.getModuleIdentifier()) {
+    FunctionsByGUID->M = &M;
+    FunctionsByGUID->ModuleID = M.getModuleIdentifier();
+    FunctionsByGUID->Names.clear();
+    for (const Function &F : M) {
+      std::string Name = F.getName().str();
+      FunctionsByGUID->Names[F.getGUID()] = Name;
+      FunctionsByGUID->Names[GlobalValue::getGUID(getPGOFuncName(F))] = Name;
+    }
+  }
+  auto It = FunctionsByGUID->Names.find(GUID);
+  if (It == FunctionsByGUID->Names.end())
+    return nullptr;
+  return M.getFunction(It->second);
+}
+
+// Collect direct calls, and the targets of indirect calls recorded by value
+// profiling in an earlier run. Callees that the profile says were never
+// entered are not worth speculating on.
 void SpeculateQuery::findCalles(const BasicBlock *BB,
                                 DenseSet<StringRef> &CallesNames) {
   assert(BB != nullptr && "Traversing Null BB to find calls?");
 
-  auto getCalledFunction = [&CallesNames](const CallBase *Call) {
+  auto addCallee = [&CallesNames](const Function *Callee) {
+    if (auto EntryCount = Callee->getEntryCount())
+      if (EntryCount->getCount() == 0)
+        return;
+    CallesNames.insert(Callee->getName());
+  };
+
+  auto addProfiledTargets = [&](const CallBase *Call) {
+    constexpr uint32_t MaxNumTargets = 4;
+    uint32_t NumTargets;
+    uint64_t TotalCount;
+    auto Targets = getValueProfDataFromInst(*Call, IPVK_IndirectCallTarget,
+                                            MaxNumTargets, NumTargets,
+                                            TotalCount);
+    if (!Targets)
+      return;
+
+    for (uint32_t I = 0; I != NumTargets; ++I) {
+      if (Targets[I].Count == 0)
+        continue;
+      if (const Function *Target =
+              findFunctionByGUID(*BB->getModule(), Targets[I].Value))
+        addCallee(Target);
+    }
+  };
+
+  auto getCalledFunction = [&](const CallBase *Call) {
     auto CalledValue = Call->getCalledOperand()->stripPointerCasts();
     if (auto DirectCall = dyn_cast<Function>(CalledValue))
-      CallesNames.insert(DirectCall->getName());
+      addCallee(DirectCall);
+    else
+      addProfiledTargets(Call);
   };
   for (auto &I : BB->instructionsWithoutDebug())
     if (auto CI = dyn_cast<CallInst>(&I))
@@ -116,7 +172,9 @@ BlockFreqQuery::ResultTy BlockFreqQuery::operator()(Function &F) {
   for (size_t i = 0; i < Topk; i++)
     findCalles(BBFreqs[i].first, Calles);
 
-  assert(!Calles.empty() && "Running Analysis on Function with no calls?");
+  // All the calls may have gone to callees that the profile says are cold.
+  if (Calles.empty())
+    return std::nullopt;
 
   CallerAndCalles.insert({F.getName(), std::move(Calles)});
 
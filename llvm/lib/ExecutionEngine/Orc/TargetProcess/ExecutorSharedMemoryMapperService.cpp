@@ -203,6 +203,26 @@ Expected<ExecutorAddr> ExecutorSharedMemoryMapperService::initialize(
 #endif
 }
 
+Expected<std::vector<ExecutorAddr>>
+ExecutorSharedMemoryMapperService::initializeBatch(
+    std::vector<std::pair<ExecutorAddr, tpctypes::SharedMemoryFinalizeRequest>>
+        &Requests) {
+  std::vector<ExecutorAddr> Bases;
+  Bases.reserve(Requests.size());
+
+  for (auto &[Reservation, FR] : Requests) {
+    auto Base = initialize(Reservation, FR);
+    if (!Base) {
+      // Roll back the allocations that were already initialized so that the
+      // caller doesn't have to track partially applied batches.
+      return joinErrors(Base.takeError(), deinitialize(Bases));
+    }
+    Bases.push_back(*Base);
+  }
+
+  return Bases;
+}
+
 Error ExecutorSharedMemoryMapperService::deinitialize(
     const std::vector<ExecutorAddr> &Bases) {
   Error AllErr = Error::success();
@@ -316,6 +336,8 @@ void ExecutorSharedMemoryMapperService::addBootstrapSymbols(
       ExecutorAddr::fromPtr(&reserveWrapper);
   M[rt::ExecutorSharedMemoryMapperServiceInitializeWrapperName] =
       ExecutorAddr::fromPtr(&initializeWrapper);
+  M[rt::ExecutorSharedMemoryMapperServiceInitializeBatchWrapperName] =
+      ExecutorAddr::fromPtr(&initializeBatchWrapper);
   M[rt::ExecutorSharedMemoryMapperServiceDeinitializeWrapperName] =
       ExecutorAddr::fromPtr(&deinitializeWrapper);
   M[rt::ExecutorSharedMemoryMapperServiceReleaseWrapperName] =
@@ -344,6 +366,17 @@ ExecutorSharedMemoryMapperService::initializeWrapper(const char *ArgData,
           .release();
 }
 
+llvm::orc::shared::CWrapperFunctionResult
+ExecutorSharedMemoryMapperService::initializeBatchWrapper(const char *ArgData,
+                                                          size_t ArgSize) {
+  return shared::WrapperFunction<
+             rt::SPSExecutorSharedMemoryMapperServiceInitializeBatchSignature>::
+      handle(ArgData, ArgSize,
+             shared::makeMethodWrapperHandler(
+                 &ExecutorSharedMemoryMapperService::initializeBatch))
+          .release();
+}
+
 llvm::orc::shared::CWrapperFunctionResult
 ExecutorSharedMemoryMapperService::deinitializeWrapper(const char *ArgData,
                                                        size_t ArgSize) {
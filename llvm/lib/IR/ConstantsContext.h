@@ -18,6 +18,7 @@
 #include "llvm/ADT/DenseMapInfo.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/Constant.h"
@@ -551,15 +552,24 @@ public:
   using LookupKeyHashed = std::pair<unsigned, LookupKey>;
 
 private:
+  /// A constant together with its hash. Computing the hash of a constant
+  /// means collecting and hashing all of its operands, so it is stored to keep
+  /// rehashing cheap and to reject mismatching buckets without comparing
+  /// operands.
+  struct Entry {
+    ConstantClass *CP;
+    unsigned Hash;
+  };
+
   struct MapInfo {
     using ConstantClassInfo = DenseMapInfo<ConstantClass *>;
 
-    static inline ConstantClass *getEmptyKey() {
-      return ConstantClassInfo::getEmptyKey();
+    static inline Entry getEmptyKey() {
+      return {ConstantClassInfo::getEmptyKey(), 0};
     }
 
-    static inline ConstantClass *getTombstoneKey() {
-      return ConstantClassInfo::getTombstoneKey();
+    static inline Entry getTombstoneKey() {
+      return {ConstantClassInfo::getTombstoneKey(), 0};
     }
 
     static unsigned getHashValue(const ConstantClass *CP) {
@@ -567,8 +577,10 @@ private:
       return getHashValue(LookupKey(CP->getType(), ValType(CP, Storage)));
     }
 
-    static bool isEqual(const ConstantClass *LHS, const ConstantClass *RHS) {
-      return LHS == RHS;
+    static unsigned getHashValue(const Entry &E) { return E.Hash; }
+
+    static bool isEqual(const Entry &LHS, const Entry &RHS) {
+      return LHS.CP == RHS.CP;
     }
 
     static unsigned getHashValue(const LookupKey &Val) {
@@ -580,31 +592,37 @@ private:
     }
 
     static bool isEqual(const LookupKey &LHS, const ConstantClass *RHS) {
-      if (RHS == getEmptyKey() || RHS == getTombstoneKey())
-        return false;
       if (LHS.first != RHS->getType())
         return false;
       return LHS.second == RHS;
     }
 
-    static bool isEqual(const LookupKeyHashed &LHS, const ConstantClass *RHS) {
-      return isEqual(LHS.second, RHS);
+    static bool isEqual(const LookupKeyHashed &LHS, const Entry &RHS) {
+      if (RHS.CP == getEmptyKey().CP || RHS.CP == getTombstoneKey().CP)
+        return false;
+      if (LHS.first != RHS.Hash)
+        return false;
+      return isEqual(LHS.second, RHS.CP);
     }
   };
 
 public:
-  using MapTy = DenseSet<ConstantClass *, MapInfo>;
+  using MapTy = DenseSet<Entry, MapInfo>;
+  using iterator = mapped_iterator<typename MapTy::iterator,
+                                   ConstantClass *(*)(const Entry &)>;
 
 private:
   MapTy Map;
 
+  static ConstantClass *getConstant(const Entry &E) { return E.CP; }
+
 public:
-  typename MapTy::iterator begin() { return Map.begin(); }
-  typename MapTy::iterator end() { return Map.end(); }
+  iterator begin() { return iterator(Map.begin(), getConstant); }
+  iterator end() { return iterator(Map.end(), getConstant); }
 
   void freeConstants() {
     for (auto &I : Map)
-      deleteConstant(I);
+      deleteConstant(I.CP);
   }
 
 private:
@@ -612,7 +630,7 @@ private:
     ConstantClass *Result = V.create(Ty);
 
     assert(Result->getType() == Ty && "Type specified is not correct!");
-    Map.insert_as(Result, HashKey);
+    Map.insert({Result, HashKey.first});
 
     return Result;
   }
@@ -630,7 +648,7 @@ public:
     if (I == Map.end())
       Result = create(Ty, V, Lookup);
     else
-      Result = *I;
+      Result = I->CP;
     assert(Result && "Unexpected nullptr");
 
     return Result;
@@ -638,9 +656,9 @@ public:
 
   /// Remove this constant from the map
   void remove(ConstantClass *CP) {
-    typename MapTy::iterator I = Map.find(CP);
+    typename MapTy::iterator I = Map.find({CP, MapInfo::getHashValue(CP)});
     assert(I != Map.end() && "Constant not found in constant table!");
-    assert(*I == CP && "Didn't find correct element?");
+    assert(I->CP == CP && "Didn't find correct element?");
     Map.erase(I);
   }
 
@@ -654,7 +672,7 @@ public:
 
     auto ItMap = Map.find_as(Lookup);
     if (ItMap != Map.end())
-      return *ItMap;
+      return ItMap->CP;
 
     // Update to the new value.  Optimize for the case when we have a single
     // operand that we're changing, but handle bulk updates efficiently.
@@ -668,7 +686,7 @@ public:
         if (CP->getOperand(I) == From)
           CP->setOperand(I, To);
     }
-    Map.insert_as(CP, Lookup);
+    Map.insert({CP, Lookup.first});
     return nullptr;
   }
 
@@ -679,7 +697,7 @@ public:
 
 template <> inline void ConstantUniqueMap<InlineAsm>::freeConstants() {
   for (auto &I : Map)
-    delete I;
+    delete I.CP;
 }
 
 } // end namespace llvm
@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/IR/Dominators.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/CFG.h"
@@ -37,6 +38,11 @@ class Value;
 } // namespace llvm
 using namespace llvm;
 
+#define DEBUG_TYPE "domtree"
+
+STATISTIC(NumDomTreeAnalysisRuns,
+          "Number of dominator trees computed from scratch by the analysis");
+
 bool llvm::VerifyDomInfo = false;
 static cl::opt<bool, true>
     VerifyDomInfoX("verify-dom-info", cl::location(VerifyDomInfo), cl::Hidden,
@@ -370,6 +376,7 @@ Instruction *DominatorTree::findNearestCommonDominator(Instruction *I1,
 
 DominatorTree DominatorTreeAnalysis::run(Function &F,
                                          FunctionAnalysisManager &) {
+  ++NumDomTreeAnalysisRuns;
   DominatorTree DT;
   DT.recalculate(F);
   return DT;
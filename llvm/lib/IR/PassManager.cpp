@@ -110,6 +110,10 @@ PreservedAnalyses ModuleToFunctionPassAdaptor::run(Module &M,
   PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(M);
 
   PreservedAnalyses PA = PreservedAnalyses::all();
+  // Functions are visited one at a time. Even function-local passes create and
+  // unique constants, types and metadata in the shared LLVMContext, update
+  // use-lists of globals, and query analyses via the shared FAM, none of which
+  // is synchronized. For parallelism, split the module instead (e.g. ThinLTO).
   for (Function &F : M) {
     if (F.isDeclaration())
       continue;
@@ -38,9 +38,12 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Program.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/ThreadPool.h"
@@ -56,6 +59,7 @@
 #include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include "llvm/Transforms/Utils/SplitModule.h"
 
+#include <condition_variable>
 #include <optional>
 #include <set>
 
@@ -83,30 +87,15 @@ extern cl::opt<bool> SupportsHotColdNew;
 extern cl::opt<bool> EnableMemProfContextDisambiguation;
 } // namespace llvm
 
-// Computes a unique hash for the Module considering the current list of
-// export/import and other global analysis results.
-// The hash is produced in \p Key.
-void llvm::computeLTOCacheKey(
-    SmallString<40> &Key, const Config &Conf, const ModuleSummaryIndex &Index,
-    StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
-    const FunctionImporter::ExportSetTy &ExportList,
-    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
-    const GVSummaryMapTy &DefinedGlobals,
-    const std::set<GlobalValue::GUID> &CfiFunctionDefs,
-    const std::set<GlobalValue::GUID> &CfiFunctionDecls) {
-  // Compute the unique hash for this entry.
-  // This is based on the current compiler version, the module itself, the
-  // export list, the hash for every single module in the import list, the
-  // list of ResolvedODR for the module, and the list of preserved symbols.
-  SHA1 Hasher;
-
+// Hash the compiler revision and the parts of the LTO configuration that
+// affect code generation into \p Hasher.
+static void addConfigToCacheKey(SHA1 &Hasher, const Config &Conf) {
   // Start with the compiler revision
   Hasher.update(LLVM_VERSION_STRING);
 #ifdef LLVM_REVISION
   Hasher.update(LLVM_REVISION);
 #endif
 
-  // Include the parts of the LTO configuration that affect code generation.
   auto AddString = [&](StringRef Str) {
     Hasher.update(Str);
     Hasher.update(ArrayRef<uint8_t>{0});
@@ -116,11 +105,8 @@ void llvm::computeLTOCacheKey(
     support::endian::write32le(Data, I);
     Hasher.update(Data);
   };
-  auto AddUint64 = [&](uint64_t I) {
-    uint8_t Data[8];
-    support::endian::write64le(Data, I);
-    Hasher.update(Data);
-  };
+
+  // Include the parts of the LTO configuration that affect code generation.
   AddString(Conf.CPU);
   // FIXME: Hash more of Options. For now all clients initialize Options from
   // command-line flags (which is unsupported in production), but may set
@@ -151,6 +137,42 @@ void llvm::computeLTOCacheKey(
   AddString(Conf.OverrideTriple);
   AddString(Conf.DefaultTriple);
   AddString(Conf.DwoDir);
+}
+
+// Computes a unique hash for the Module considering the current list of
+// export/import and other global analysis results.
+// The hash is produced in \p Key.
+void llvm::computeLTOCacheKey(
+    SmallString<40> &Key, const Config &Conf, const ModuleSummaryIndex &Index,
+    StringRef ModuleID, const FunctionImporter::ImportMapTy &ImportList,
+    const FunctionImporter::ExportSetTy &ExportList,
+    const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+    const GVSummaryMapTy &DefinedGlobals,
+    const std::set<GlobalValue::GUID> &CfiFunctionDefs,
+    const std::set<GlobalValue::GUID> &CfiFunctionDecls) {
+  // Compute the unique hash for this entry.
+  // This is based on the current compiler version, the module itself, the
+  // export list, the hash for every single module in the import list, the
+  // list of ResolvedODR for the module, and the list of preserved symbols.
+  SHA1 Hasher;
+
+  addConfigToCacheKey(Hasher, Conf);
+
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  auto AddUnsigned = [&](unsigned I) {
+    uint8_t Data[4];
+    support::endian::write32le(Data, I);
+    Hasher.update(Data);
+  };
+  auto AddUint64 = [&](uint64_t I) {
+    uint8_t Data[8];
+    support::endian::write64le(Data, I);
+    Hasher.update(Data);
+  };
+  AddUnsigned(Conf.CacheKeyUseBodyHashes);
 
   // Include the hash for the current module
   auto ModHash = Index.getModuleHash(ModuleID);
@@ -199,8 +221,34 @@ void llvm::computeLTOCacheKey(
              [](const ImportModule &Lhs, const ImportModule &Rhs) -> bool {
                return Lhs.getHash() < Rhs.getHash();
              });
+  // Returns the hash of the imported definition of GUID in module ModuleID, or
+  // 0 if there is none.
+  auto GetBodyHash = [&](GlobalValue::GUID GUID, StringRef ModuleID) {
+    GlobalValueSummary *S = Index.findSummaryInModule(GUID, ModuleID);
+    if (!S)
+      return uint64_t(0);
+    if (auto *AS = dyn_cast<AliasSummary>(S))
+      return AS->hasAliasee() ? AS->getAliasee().getBodyHash() : 0;
+    return S->getBodyHash();
+  };
+
+  // With Conf.CacheKeyUseBodyHashes, the definitions imported from a module
+  // whose summaries have body hashes are hashed individually, so that changes
+  // to the rest of that module do not change the key. Sort them by GUID to be
+  // independent of module name and module order.
+  std::vector<std::pair<uint64_t, uint64_t>> ImportedBodies;
   std::vector<uint64_t> ImportedGUIDs;
   for (const ImportModule &Entry : ImportModulesVector) {
+    if (Conf.CacheKeyUseBodyHashes &&
+        all_of(Entry.getFunctions(), [&](GlobalValue::GUID GUID) {
+          return GetBodyHash(GUID, Entry.getIdentifier()) != 0;
+        })) {
+      for (GlobalValue::GUID GUID : Entry.getFunctions())
+        ImportedBodies.emplace_back(GUID,
+                                    GetBodyHash(GUID, Entry.getIdentifier()));
+      continue;
+    }
+
     auto ModHash = Entry.getHash();
     Hasher.update(ArrayRef<uint8_t>((uint8_t *)&ModHash[0], sizeof(ModHash)));
 
@@ -213,6 +261,12 @@ void llvm::computeLTOCacheKey(
     for (auto &GUID : ImportedGUIDs)
       AddUint64(GUID);
   }
+  llvm::sort(ImportedBodies);
+  AddUint64(ImportedBodies.size());
+  for (auto [GUID, BodyHash] : ImportedBodies) {
+    AddUint64(GUID);
+    AddUint64(BodyHash);
+  }
 
   // Include the hash for the resolved ODR.
   for (auto &Entry : ResolvedODR) {
@@ -352,6 +406,24 @@ void llvm::computeLTOCacheKey(
   Key = toHex(Hasher.result());
 }
 
+// Computes a unique hash for a partition of the regular LTO module, which is
+// code generated as \p Task from the optimized IR in \p Bitcode.
+void llvm::computeLTOPartitionCacheKey(SmallString<40> &Key, const Config &Conf,
+                                       unsigned Task, StringRef Bitcode) {
+  SHA1 Hasher;
+  addConfigToCacheKey(Hasher, Conf);
+
+  // The task number is part of the names of split DWARF files.
+  uint8_t Data[4];
+  support::endian::write32le(Data, Task);
+  Hasher.update(Data);
+  Hasher.update(Conf.SplitDwarfFile);
+  Hasher.update(ArrayRef<uint8_t>{0});
+  Hasher.update(Bitcode);
+
+  Key = toHex(Hasher.result());
+}
+
 static void thinLTOResolvePrevailingGUID(
     const Config &C, ValueInfo VI,
     DenseSet<GlobalValueSummary *> &GlobalInvolvedWithAlias,
@@ -764,15 +836,20 @@ Error LTO::addModule(InputFile &Input, unsigned ModI,
   if (!ModOrErr)
     return ModOrErr.takeError();
 
-  if (!LTOInfo->HasSummary)
-    return linkRegularLTO(std::move(*ModOrErr), /*LivenessFromIndex=*/false);
+  if (LTOInfo->HasSummary) {
+    // Regular LTO module summaries are added to a dummy module that represents
+    // the combined regular LTO module.
+    if (Error Err = BM.readSummary(ThinLTO.CombinedIndex, ""))
+      return Err;
+    // Unless streaming, defer linking until liveness has been computed from
+    // the combined index, so that dead globals are never materialized.
+    if (!Conf.StreamRegularLTOLinking) {
+      RegularLTO.ModsWithSummaries.push_back(std::move(*ModOrErr));
+      return Error::success();
+    }
+  }
 
-  // Regular LTO module summaries are added to a dummy module that represents
-  // the combined regular LTO module.
-  if (Error Err = BM.readSummary(ThinLTO.CombinedIndex, ""))
-    return Err;
-  RegularLTO.ModsWithSummaries.push_back(std::move(*ModOrErr));
-  return Error::success();
+  return linkRegularLTO(std::move(*ModOrErr), /*LivenessFromIndex=*/false);
 }
 
 // Checks whether the given global value is in a non-prevailing comdat
@@ -996,8 +1073,42 @@ Error LTO::linkRegularLTO(RegularLTOState::AddedModule Mod,
     Keep.push_back(GV);
   }
 
-  return RegularLTO.Mover->move(std::move(Mod.M), Keep, nullptr,
-                                /* IsPerformingImport */ false);
+  // The mover takes ownership of the source module and destroys it, along
+  // with its materializer, once its globals have been moved.
+  if (Error Err = RegularLTO.Mover->move(std::move(Mod.M), Keep, nullptr,
+                                         /* IsPerformingImport */ false))
+    return Err;
+  dropDuplicateCompileUnits();
+  return Error::success();
+}
+
+// Remove compile units that were appended to the combined module's llvm.dbg.cu
+// more than once. Only the operands added since the last call are checked, so
+// the cost of linking a module does not grow with the size of the link.
+void LTO::dropDuplicateCompileUnits() {
+  NamedMDNode *CUs =
+      RegularLTO.CombinedModule->getNamedMetadata("llvm.dbg.cu");
+  if (!CUs)
+    return;
+
+  bool HasDuplicates = false;
+  for (unsigned I = RegularLTO.NumCheckedCompileUnits,
+                E = CUs->getNumOperands();
+       I != E; ++I)
+    if (!RegularLTO.CompileUnits.insert(CUs->getOperand(I)).second)
+      HasDuplicates = true;
+
+  if (HasDuplicates) {
+    SmallVector<MDNode *, 0> Unique;
+    DenseSet<const MDNode *> Seen;
+    for (MDNode *CU : CUs->operands())
+      if (Seen.insert(CU).second)
+        Unique.push_back(CU);
+    CUs->clearOperands();
+    for (MDNode *CU : Unique)
+      CUs->addOperand(CU);
+  }
+  RegularLTO.NumCheckedCompileUnits = CUs->getNumOperands();
 }
 
 // Add a ThinLTO module to the link.
@@ -1177,7 +1288,8 @@ Error LTO::run(AddStreamFn AddStream, FileCache Cache) {
   if (SupportsHotColdNew)
     ThinLTO.CombinedIndex.setWithSupportsHotColdNew();
 
-  Error Result = runRegularLTO(AddStream);
+  Error Result = runRegularLTO(
+      AddStream, Conf.CacheRegularLTOPartitions ? Cache : FileCache());
   if (!Result)
     // This will reset the GlobalResolutions optional once done with it to
     // reduce peak memory before importing.
@@ -1220,7 +1332,7 @@ void lto::updateMemProfAttributes(Module &Mod,
   }
 }
 
-Error LTO::runRegularLTO(AddStreamFn AddStream) {
+Error LTO::runRegularLTO(AddStreamFn AddStream, FileCache Cache) {
   // Setup optimization remarks.
   auto DiagFileOrErr = lto::setupLLVMOptimizationRemarks(
       RegularLTO.CombinedModule->getContext(), Conf.RemarksFilename,
@@ -1345,7 +1457,7 @@ Error LTO::runRegularLTO(AddStreamFn AddStream) {
   if (!RegularLTO.EmptyCombinedModule || Conf.AlwaysEmitRegularLTOObj) {
     if (Error Err =
             backend(Conf, AddStream, RegularLTO.ParallelCodeGenParallelismLevel,
-                    *RegularLTO.CombinedModule, ThinLTO.CombinedIndex))
+                    *RegularLTO.CombinedModule, ThinLTO.CombinedIndex, Cache))
       return Err;
   }
 
@@ -1428,6 +1540,16 @@ class InProcessThinBackend : public ThinBackendProc {
 
   bool ShouldEmitIndexFiles;
 
+  // State for Conf.ThinLTOMemoryBudget. A job's memory use is estimated as its
+  // weight (the instruction count of the functions it defines and imports)
+  // times BytesPerInst, which is refined from the heap usage measured as jobs
+  // finish.
+  std::mutex BudgetMu;
+  std::condition_variable BudgetCV;
+  uint64_t RunningWeight = 0;
+  uint64_t BytesPerInst = 1024;
+  size_t BaselineMallocUsage = 0;
+
 public:
   InProcessThinBackend(
       const Config &Conf, ModuleSummaryIndex &CombinedIndex,
@@ -1445,6 +1567,52 @@ public:
     for (auto &Name : CombinedIndex.cfiFunctionDecls())
       CfiFunctionDecls.insert(
           GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
+    if (Conf.ThinLTOMemoryBudget)
+      BaselineMallocUsage = sys::Process::GetMallocUsage();
+  }
+
+  uint64_t getJobWeight(const GVSummaryMapTy &DefinedGlobals,
+                        const FunctionImporter::ImportMapTy &ImportList) {
+    uint64_t Weight = 1;
+    for (const auto &GS : DefinedGlobals)
+      if (auto *FS = dyn_cast<FunctionSummary>(GS.second))
+        Weight += FS->instCount();
+    for (const auto &ILI : ImportList)
+      for (GlobalValue::GUID GUID : ILI.second)
+        if (auto *FS = dyn_cast_or_null<FunctionSummary>(
+                CombinedIndex.findSummaryInModule(GUID, ILI.first)))
+          Weight += FS->instCount();
+    return Weight;
+  }
+
+  // Wait until a job of the given weight fits in the memory budget.
+  void acquireMemory(uint64_t Weight) {
+    std::unique_lock<std::mutex> L(BudgetMu);
+    BudgetCV.wait(L, [&] {
+      return RunningWeight == 0 || (RunningWeight + Weight) * BytesPerInst <=
+                                       Conf.ThinLTOMemoryBudget;
+    });
+    RunningWeight += Weight;
+  }
+
+  void releaseMemory(uint64_t Weight) {
+    {
+      std::lock_guard<std::mutex> L(BudgetMu);
+      RunningWeight -= Weight;
+    }
+    BudgetCV.notify_all();
+  }
+
+  // Called when a job has finished code generation but still holds its module,
+  // which is close to its peak memory use. Attribute the heap growth since the
+  // backend was created to the running jobs by weight.
+  void sampleMemoryUsage() {
+    size_t Usage = sys::Process::GetMallocUsage();
+    std::lock_guard<std::mutex> L(BudgetMu);
+    if (RunningWeight == 0 || Usage <= BaselineMallocUsage)
+      return;
+    uint64_t Sample = (Usage - BaselineMallocUsage) / RunningWeight;
+    BytesPerInst = std::max<uint64_t>(1, (BytesPerInst * 3 + Sample) / 4);
   }
 
   Error runThinLTOBackendThread(
@@ -1461,8 +1629,11 @@ public:
       if (!MOrErr)
         return MOrErr.takeError();
 
-      return thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
-                         ImportList, DefinedGlobals, &ModuleMap);
+      Error E = thinBackend(Conf, Task, AddStream, **MOrErr, CombinedIndex,
+                            ImportList, DefinedGlobals, &ModuleMap);
+      if (Conf.ThinLTOMemoryBudget)
+        sampleMemoryUsage();
+      return E;
     };
 
     auto ModuleID = BM.getModuleIdentifier();
@@ -1515,9 +1686,16 @@ public:
           if (LLVM_ENABLE_THREADS && Conf.TimeTraceEnabled)
             timeTraceProfilerInitialize(Conf.TimeTraceGranularity,
                                         "thin backend");
+          uint64_t Weight = 0;
+          if (Conf.ThinLTOMemoryBudget) {
+            Weight = getJobWeight(DefinedGlobals, ImportList);
+            acquireMemory(Weight);
+          }
           Error E = runThinLTOBackendThread(
               AddStream, Cache, Task, BM, CombinedIndex, ImportList, ExportList,
               ResolvedODR, DefinedGlobals, ModuleMap);
+          if (Conf.ThinLTOMemoryBudget)
+            releaseMemory(Weight);
           if (E) {
             std::unique_lock<std::mutex> L(ErrMu);
             if (Err)
@@ -1666,6 +1844,293 @@ ThinBackend lto::createWriteIndexesThinBackend(
       };
 }
 
+namespace {
+class ExternalThinBackendExecutor : public ThinBackendExecutor {
+  std::string Program;
+  std::vector<std::string> Args;
+
+public:
+  ExternalThinBackendExecutor(std::string Program,
+                              std::vector<std::string> Args)
+      : Program(std::move(Program)), Args(std::move(Args)) {}
+
+  Error execute(const Config &Conf, ArrayRef<Job> Jobs) override {
+    SmallString<128> JobsPath;
+    int FD;
+    if (std::error_code EC =
+            sys::fs::createTemporaryFile("thinlto-jobs", "json", FD, JobsPath))
+      return errorCodeToError(EC);
+    auto RemoveJobsFile =
+        make_scope_exit([&] { sys::fs::remove(JobsPath); });
+    {
+      raw_fd_ostream OS(FD, /*shouldClose=*/true);
+      json::OStream J(OS, /*IndentSize=*/2);
+      J.object([&] {
+        J.attribute("version", 1);
+        J.attributeObject("common", [&] {
+          J.attribute("cpu", Conf.CPU);
+          J.attributeArray("mattrs", [&] {
+            for (const std::string &A : Conf.MAttrs)
+              J.value(A);
+          });
+          J.attribute("opt_level", Conf.OptLevel);
+        });
+        J.attributeArray("jobs", [&] {
+          for (const Job &JB : Jobs)
+            J.object([&] {
+              J.attribute("task", JB.Task);
+              J.attribute("module_id", JB.ModuleID);
+              J.attribute("module", JB.ModulePath);
+              J.attribute("summary_index", JB.SummaryIndexPath);
+              J.attributeArray("imports", [&] {
+                for (const Import &I : JB.Imports)
+                  J.object([&] {
+                    J.attribute("module_id", I.ModuleID);
+                    J.attribute("module", I.Path);
+                  });
+              });
+              J.attribute("output", JB.NativeObjectPath);
+            });
+        });
+      });
+      OS.close();
+      if (OS.has_error())
+        return errorCodeToError(OS.error());
+    }
+
+    SmallVector<StringRef, 8> Argv;
+    Argv.push_back(Program);
+    for (const std::string &A : Args)
+      Argv.push_back(A);
+    Argv.push_back(JobsPath);
+    std::string ErrMsg;
+    int RC = sys::ExecuteAndWait(Program, Argv, /*Env=*/std::nullopt,
+                                 /*Redirects=*/{}, /*SecondsToWait=*/0,
+                                 /*MemoryLimit=*/0, &ErrMsg);
+    if (RC < 0)
+      return createStringError(inconvertibleErrorCode(),
+                               "could not run ThinLTO distributor '" + Program +
+                                   "': " + ErrMsg);
+    if (RC != 0)
+      return createStringError(inconvertibleErrorCode(),
+                               "ThinLTO distributor '" + Program +
+                                   "' failed with exit code " + Twine(RC));
+    return Error::success();
+  }
+};
+
+class DistributedThinBackend : public ThinBackendProc {
+  std::shared_ptr<ThinBackendExecutor> Executor;
+  std::string WorkDir;
+  // A directory in WorkDir that only this backend writes to, so that links
+  // sharing an output directory do not overwrite or remove each other's files.
+  // Created on first use.
+  SmallString<128> TempDir;
+  AddStreamFn AddStream;
+  FileCache Cache;
+  std::set<GlobalValue::GUID> CfiFunctionDefs;
+  std::set<GlobalValue::GUID> CfiFunctionDecls;
+
+  std::vector<ThinBackendExecutor::Job> Jobs;
+  std::vector<AddStreamFn> JobStreams;
+  // Files in WorkDir holding the bitcode of modules that are not files on
+  // disk, keyed by module identifier.
+  StringMap<std::string> StagedModules;
+
+public:
+  DistributedThinBackend(
+      const Config &Conf, ModuleSummaryIndex &CombinedIndex,
+      const DenseMap<StringRef, GVSummaryMapTy> &ModuleToDefinedGVSummaries,
+      std::shared_ptr<ThinBackendExecutor> Executor, std::string WorkDir,
+      AddStreamFn AddStream, FileCache Cache, lto::IndexWriteCallback OnWrite)
+      : ThinBackendProc(Conf, CombinedIndex, ModuleToDefinedGVSummaries,
+                        OnWrite, /*ShouldEmitImportsFiles=*/false),
+        Executor(std::move(Executor)), WorkDir(std::move(WorkDir)),
+        AddStream(std::move(AddStream)), Cache(std::move(Cache)) {
+    for (auto &Name : CombinedIndex.cfiFunctionDefs())
+      CfiFunctionDefs.insert(
+          GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
+    for (auto &Name : CombinedIndex.cfiFunctionDecls())
+      CfiFunctionDecls.insert(
+          GlobalValue::getGUID(GlobalValue::dropLLVMManglingEscape(Name)));
+  }
+
+  ~DistributedThinBackend() override {
+    for (const ThinBackendExecutor::Job &J : Jobs) {
+      sys::fs::remove(J.SummaryIndexPath);
+      sys::fs::remove(J.NativeObjectPath);
+    }
+    for (const auto &Staged : StagedModules)
+      sys::fs::remove(Staged.second);
+    if (!TempDir.empty())
+      sys::fs::remove(TempDir);
+  }
+
+  Expected<StringRef> getTempDir() {
+    if (TempDir.empty()) {
+      SmallString<128> Prefix(WorkDir);
+      sys::path::append(Prefix, "thinlto");
+      if (std::error_code EC = sys::fs::createUniqueDirectory(Prefix, TempDir))
+        return createFileError(Prefix, EC);
+    }
+    return TempDir.str();
+  }
+
+  // Returns the path of a file holding the bitcode of module ModuleID. Modules
+  // that are not files on disk are written to TempDir.
+  Expected<std::string> getModuleFile(StringRef ModuleID, BitcodeModule BM) {
+    if (sys::fs::is_regular_file(ModuleID))
+      return ModuleID.str();
+    auto [It, Inserted] = StagedModules.try_emplace(ModuleID);
+    if (!Inserted)
+      return It->second;
+
+    Expected<StringRef> DirOrErr = getTempDir();
+    if (!DirOrErr) {
+      StagedModules.erase(It);
+      return DirOrErr.takeError();
+    }
+    SmallString<128> Path(*DirOrErr);
+    sys::path::append(Path, "module." + Twine(StagedModules.size()) + ".bc");
+    It->second = std::string(Path);
+    LTOLLVMContext Ctx(Conf);
+    Expected<std::unique_ptr<Module>> MOrErr = BM.parseModule(Ctx);
+    if (!MOrErr)
+      return MOrErr.takeError();
+    std::error_code EC;
+    raw_fd_ostream OS(Path, EC, sys::fs::OpenFlags::OF_None);
+    if (EC)
+      return errorCodeToError(EC);
+    WriteBitcodeToFile(**MOrErr, OS);
+    return It->second;
+  }
+
+  Error start(
+      unsigned Task, BitcodeModule BM,
+      const FunctionImporter::ImportMapTy &ImportList,
+      const FunctionImporter::ExportSetTy &ExportList,
+      const std::map<GlobalValue::GUID, GlobalValue::LinkageTypes> &ResolvedODR,
+      MapVector<StringRef, BitcodeModule> &ModuleMap) override {
+    StringRef ModulePath = BM.getModuleIdentifier();
+    assert(ModuleToDefinedGVSummaries.count(ModulePath));
+    const GVSummaryMapTy &DefinedGlobals =
+        ModuleToDefinedGVSummaries.find(ModulePath)->second;
+
+    AddStreamFn Stream = AddStream;
+    if (Cache && CombinedIndex.modulePaths().count(ModulePath) &&
+        !all_of(CombinedIndex.getModuleHash(ModulePath),
+                [](uint32_t V) { return V == 0; })) {
+      SmallString<40> Key;
+      computeLTOCacheKey(Key, Conf, CombinedIndex, ModulePath, ImportList,
+                         ExportList, ResolvedODR, DefinedGlobals,
+                         CfiFunctionDefs, CfiFunctionDecls);
+      Expected<AddStreamFn> CacheAddStreamOrErr =
+          Cache(Task, Key, ModulePath);
+      if (Error Err = CacheAddStreamOrErr.takeError())
+        return Err;
+      // A cache hit has already added the object file to the link.
+      Stream = std::move(*CacheAddStreamOrErr);
+      if (!Stream) {
+        if (OnWrite)
+          OnWrite(std::string(ModulePath));
+        return Error::success();
+      }
+    }
+
+    ThinBackendExecutor::Job J;
+    J.Task = Task;
+    J.ModuleID = ModulePath.str();
+    Expected<std::string> FileOrErr = getModuleFile(ModulePath, BM);
+    if (!FileOrErr)
+      return FileOrErr.takeError();
+    J.ModulePath = std::move(*FileOrErr);
+
+    Expected<StringRef> DirOrErr = getTempDir();
+    if (!DirOrErr)
+      return DirOrErr.takeError();
+    SmallString<128> Base(*DirOrErr);
+    sys::path::append(Base, sys::path::filename(ModulePath) + "." +
+                                Twine(Task));
+    J.SummaryIndexPath = (Base + ".thinlto.bc").str();
+    J.NativeObjectPath = (Base + ".native.o").str();
+
+    std::map<std::string, GVSummaryMapTy> ModuleToSummariesForIndex;
+    gatherImportedSummariesForModule(ModulePath, ModuleToDefinedGVSummaries,
+                                     ImportList, ModuleToSummariesForIndex);
+    std::error_code EC;
+    raw_fd_ostream OS(J.SummaryIndexPath, EC, sys::fs::OpenFlags::OF_None);
+    if (EC)
+      return errorCodeToError(EC);
+    writeIndexToFile(CombinedIndex, OS, &ModuleToSummariesForIndex);
+
+    for (const auto &ILI : ModuleToSummariesForIndex) {
+      if (ILI.first == ModulePath)
+        continue;
+      auto It = ModuleMap.find(ILI.first);
+      if (It == ModuleMap.end()) {
+        J.Imports.push_back({ILI.first, ILI.first});
+        continue;
+      }
+      Expected<std::string> ImportFileOrErr =
+          getModuleFile(ILI.first, It->second);
+      if (!ImportFileOrErr)
+        return ImportFileOrErr.takeError();
+      J.Imports.push_back({ILI.first, std::move(*ImportFileOrErr)});
+    }
+
+    Jobs.push_back(std::move(J));
+    JobStreams.push_back(std::move(Stream));
+    if (OnWrite)
+      OnWrite(std::string(ModulePath));
+    return Error::success();
+  }
+
+  Error wait() override {
+    if (Jobs.empty())
+      return Error::success();
+    if (Error E = Executor->execute(Conf, Jobs))
+      return E;
+
+    for (auto [J, Stream] : zip(Jobs, JobStreams)) {
+      ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+          MemoryBuffer::getFile(J.NativeObjectPath);
+      if (!MBOrErr)
+        return createFileError(J.NativeObjectPath, MBOrErr.getError());
+      Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+          Stream(J.Task, J.ModuleID);
+      if (!StreamOrErr)
+        return StreamOrErr.takeError();
+      *(*StreamOrErr)->OS << (*MBOrErr)->getBuffer();
+    }
+    return Error::success();
+  }
+
+  // The jobs only run once all of them have been collected, so there is no
+  // benefit in starting modules out of order.
+  unsigned getThreadCount() override { return 1; }
+};
+} // end anonymous namespace
+
+std::unique_ptr<ThinBackendExecutor>
+lto::createExternalThinBackendExecutor(std::string Program,
+                                       std::vector<std::string> Args) {
+  return std::make_unique<ExternalThinBackendExecutor>(std::move(Program),
+                                                       std::move(Args));
+}
+
+ThinBackend lto::createDistributedThinBackend(
+    std::shared_ptr<ThinBackendExecutor> Executor, std::string WorkDir,
+    IndexWriteCallback OnWrite) {
+  return
+      [=](const Config &Conf, ModuleSummaryIndex &CombinedIndex,
+          const DenseMap<StringRef, GVSummaryMapTy> &ModuleToDefinedGVSummaries,
+          AddStreamFn AddStream, FileCache Cache) {
+        return std::make_unique<DistributedThinBackend>(
+            Conf, CombinedIndex, ModuleToDefinedGVSummaries, Executor, WorkDir,
+            AddStream, Cache, OnWrite);
+      };
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   LLVM_DEBUG(dbgs() << "Running ThinLTO\n");
@@ -427,14 +427,31 @@ static void codegen(const Config &Conf, TargetMachine *TM,
     DwoOut->keep();
 }
 
-static void splitCodeGen(const Config &C, TargetMachine *TM,
+// Looks up the native object for the partition serialized in \p BC in \p Cache.
+// Returns the stream to code generate it into, or null if it was found in the
+// cache and no code generation is needed.
+static Expected<AddStreamFn> lookupPartitionInCache(const Config &C,
+                                                    FileCache &Cache,
+                                                    AddStreamFn AddStream,
+                                                    unsigned Task,
+                                                    StringRef BC) {
+  if (!Cache)
+    return AddStream;
+  SmallString<40> Key;
+  computeLTOPartitionCacheKey(Key, C, Task, BC);
+  return Cache(Task, Key, "ld-temp.o");
+}
+
+static Error splitCodeGen(const Config &C, TargetMachine *TM,
                          AddStreamFn AddStream,
                          unsigned ParallelCodeGenParallelismLevel, Module &Mod,
-                         const ModuleSummaryIndex &CombinedIndex) {
+                         const ModuleSummaryIndex &CombinedIndex,
+                         FileCache &Cache) {
   DefaultThreadPool CodegenThreadPool(
       heavyweight_hardware_concurrency(ParallelCodeGenParallelismLevel));
   unsigned ThreadCount = 0;
   const Target *T = &TM->getTarget();
+  Error Err = Error::success();
 
   const auto HandleModulePartition =
       [&](std::unique_ptr<Module> MPart) {
@@ -448,9 +465,21 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
         raw_svector_ostream BCOS(BC);
         WriteBitcodeToFile(*MPart, BCOS);
 
+        unsigned Task = ThreadCount++;
+        Expected<AddStreamFn> PartitionAddStreamOrErr =
+            lookupPartitionInCache(C, Cache, AddStream, Task, BC);
+        if (!PartitionAddStreamOrErr) {
+          Err = joinErrors(std::move(Err), PartitionAddStreamOrErr.takeError());
+          return;
+        }
+        AddStreamFn PartitionAddStream = std::move(*PartitionAddStreamOrErr);
+        if (!PartitionAddStream)
+          return;
+
         // Enqueue the task
         CodegenThreadPool.async(
-            [&](const SmallString<0> &BC, unsigned ThreadId) {
+            [&](const SmallString<0> &BC, unsigned ThreadId,
+                const AddStreamFn &AddStream) {
               LTOLLVMContext Ctx(C);
               Expected<std::unique_ptr<Module>> MOrErr =
                   parseBitcodeFile(MemoryBufferRef(BC.str(), "ld-temp.o"), Ctx);
@@ -466,20 +495,21 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
             },
             // Pass BC using std::move to ensure that it get moved rather than
             // copied into the thread's context.
-            std::move(BC), ThreadCount++);
+            std::move(BC), Task, std::move(PartitionAddStream));
       };
 
   // Try target-specific module splitting first, then fallback to the default.
   if (!TM->splitModule(Mod, ParallelCodeGenParallelismLevel,
                        HandleModulePartition)) {
     SplitModule(Mod, ParallelCodeGenParallelismLevel, HandleModulePartition,
-                false);
+                false, C.CostBalancedPartitions);
   }
 
   // Because the inner lambda (which runs in a worker thread) captures our local
   // variables, we need to wait for the worker threads to terminate before we
   // can leave the function scope.
   CodegenThreadPool.wait();
+  return Err;
 }
 
 static Expected<const Target *> initAndLookupTarget(const Config &C,
@@ -509,7 +539,7 @@ Error lto::finalizeOptimizationRemarks(
 
 Error lto::backend(const Config &C, AddStreamFn AddStream,
                    unsigned ParallelCodeGenParallelismLevel, Module &Mod,
-                   ModuleSummaryIndex &CombinedIndex) {
+                   ModuleSummaryIndex &CombinedIndex, FileCache Cache) {
   Expected<const Target *> TOrErr = initAndLookupTarget(C, Mod);
   if (!TOrErr)
     return TOrErr.takeError();
@@ -525,12 +555,23 @@ Error lto::backend(const Config &C, AddStreamFn AddStream,
   }
 
   if (ParallelCodeGenParallelismLevel == 1) {
+    if (Cache) {
+      SmallString<0> BC;
+      raw_svector_ostream BCOS(BC);
+      WriteBitcodeToFile(Mod, BCOS);
+      Expected<AddStreamFn> AddStreamOrErr =
+          lookupPartitionInCache(C, Cache, AddStream, 0, BC);
+      if (!AddStreamOrErr)
+        return AddStreamOrErr.takeError();
+      AddStream = std::move(*AddStreamOrErr);
+      if (!AddStream)
+        return Error::success();
+    }
     codegen(C, TM.get(), AddStream, 0, Mod, CombinedIndex);
-  } else {
-    splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel, Mod,
-                 CombinedIndex);
+    return Error::success();
   }
-  return Error::success();
+  return splitCodeGen(C, TM.get(), AddStream, ParallelCodeGenParallelismLevel,
+                      Mod, CombinedIndex, Cache);
 }
 
 static void dropDeadSymbols(Module &Mod, const GVSummaryMapTy &DefinedGlobals,
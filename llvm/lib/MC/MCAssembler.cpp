@@ -591,22 +591,24 @@ static void writeFragment(raw_ostream &OS, const MCAssembler &Asm,
     const MCFillFragment &FF = cast<MCFillFragment>(F);
     uint64_t V = FF.getValue();
     unsigned VSize = FF.getValueSize();
-    const unsigned MaxChunkSize = 16;
+    const unsigned MaxChunkSize = 4096;
     char Data[MaxChunkSize];
-    assert(0 < VSize && VSize <= MaxChunkSize && "Illegal fragment fill size");
+    assert(0 < VSize && VSize <= 16 && "Illegal fragment fill size");
     // Duplicate V into Data as byte vector to reduce number of
     // writes done. As such, do endian conversion here.
     for (unsigned I = 0; I != VSize; ++I) {
       unsigned index = Endian == llvm::endianness::little ? I : (VSize - I - 1);
       Data[I] = uint8_t(V >> (index * 8));
     }
-    for (unsigned I = VSize; I < MaxChunkSize; ++I)
-      Data[I] = Data[I - VSize];
 
-    // Set to largest multiple of VSize in Data.
-    const unsigned NumPerChunk = MaxChunkSize / VSize;
+    // Set to largest multiple of VSize in Data, but don't replicate V further
+    // than the fragment needs so that small fills stay cheap.
+    const unsigned NumPerChunk = std::max<uint64_t>(
+        1, std::min<uint64_t>(FragmentSize, MaxChunkSize) / VSize);
     // Set ChunkSize to largest multiple of VSize in Data
     const unsigned ChunkSize = VSize * NumPerChunk;
+    for (unsigned I = VSize; I < ChunkSize; ++I)
+      Data[I] = Data[I - VSize];
 
     // Do copies by chunk.
     StringRef Ref(Data, ChunkSize);
@@ -847,15 +849,9 @@ void MCAssembler::layout(MCAsmLayout &Layout) {
   }
 
   // Layout until everything fits.
-  while (layoutOnce(Layout)) {
+  while (layoutOnce(Layout))
     if (getContext().hadError())
       return;
-    // Size of fragments in one section can depend on the size of fragments in
-    // another. If any fragment has changed size, we have to re-layout (and
-    // as a result possibly further relax) all.
-    for (MCSection &Sec : *this)
-      Sec.setHasLayout(false);
-  }
 
   DEBUG_WITH_TYPE("mc-dump", {
       errs() << "assembler backend - post-relaxation\n--\n";
@@ -1229,11 +1225,28 @@ bool MCAssembler::relaxFragment(MCAsmLayout &Layout, MCFragment &F) {
 bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
   ++stats::RelaxationSteps;
 
+  // Relax every fragment against the layout from the start of this step, and
+  // only invalidate the layouts that may have changed once all are done. A
+  // section's layout only depends on the sizes of its own fragments, unless it
+  // contains fill or org fragments whose size is computed from expressions
+  // that may refer to other sections.
   bool Changed = false;
-  for (MCSection &Sec : *this)
-    for (MCFragment &Frag : Sec)
+  SmallVector<MCSection *, 16> Stale;
+  for (MCSection &Sec : *this) {
+    bool NeedsRelayout = false;
+    for (MCFragment &Frag : Sec) {
       if (relaxFragment(Layout, Frag))
-        Changed = true;
+        Changed = NeedsRelayout = true;
+      else if (Frag.getKind() == MCFragment::FT_Fill ||
+               Frag.getKind() == MCFragment::FT_Org)
+        NeedsRelayout = true;
+    }
+    if (NeedsRelayout)
+      Stale.push_back(&Sec);
+  }
+  if (Changed)
+    for (MCSection *Sec : Stale)
+      Sec->setHasLayout(false);
   return Changed;
 }
 
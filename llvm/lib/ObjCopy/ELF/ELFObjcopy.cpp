@@ -31,6 +31,7 @@
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -39,6 +40,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -220,6 +222,11 @@ Error Object::compressOrDecompressSections(const CommonConfig &Config) {
   // because it would mutate the sections array.
   SmallVector<std::pair<SectionBase *, std::function<SectionBase *()>>, 0>
       ToReplace;
+  // Sections to compress. Compression is by far the most expensive part of
+  // --compress-debug-sections, so it is done in parallel below, before the
+  // compressed sections are added to the object.
+  SmallVector<std::pair<SectionBase *, DebugCompressionType>, 0> ToCompress;
+  SmallVector<std::optional<CompressedSection>, 0> Compressed;
   for (SectionBase &Sec : sections()) {
     std::optional<DebugCompressionType> CType;
     for (auto &[Matcher, T] : Config.compressSections)
@@ -247,13 +254,20 @@ Error Object::compressOrDecompressSections(const CommonConfig &Config) {
         ToReplace.emplace_back(
             &Sec, [=] { return &addSection<DecompressedSection>(*CS); });
     } else if (*CType != DebugCompressionType::None) {
-      ToReplace.emplace_back(&Sec, [=, S = &Sec] {
-        return &addSection<CompressedSection>(
-            CompressedSection(*S, *CType, Is64Bits));
+      size_t I = ToCompress.size();
+      ToCompress.emplace_back(&Sec, *CType);
+      ToReplace.emplace_back(&Sec, [this, I, &Compressed] {
+        return &addSection<CompressedSection>(std::move(*Compressed[I]));
       });
     }
   }
 
+  Compressed.resize(ToCompress.size());
+  parallelFor(0, ToCompress.size(), [&](size_t I) {
+    Compressed[I].emplace(*ToCompress[I].first, ToCompress[I].second,
+                          Is64Bits);
+  });
+
   DenseMap<SectionBase *, SectionBase *> FromTo;
   for (auto [S, Func] : ToReplace)
     FromTo[S] = Func();
@@ -20,11 +20,13 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <optional>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -2078,11 +2080,34 @@ template <class ELFT> void ELFWriter<ELFT>::writeShdrs() {
 }
 
 template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
+  // Each section is written to its own range of the output buffer, so write
+  // the expensive ones (e.g. decompressed debug sections) in parallel first
+  // and report the first error in section order.
+  SmallVector<const SectionBase *, 0> Expensive;
+  for (const SectionBase &Sec : Obj.sections())
+    if (Sec.ParentSegment == nullptr && Sec.isExpensiveToWrite())
+      Expensive.push_back(&Sec);
+  if (!Expensive.empty()) {
+    std::vector<std::optional<Error>> Errs(Expensive.size());
+    parallelFor(0, Expensive.size(), [&](size_t I) {
+      Errs[I].emplace(Expensive[I]->accept(*SecWriter));
+    });
+    Error Err = Error::success();
+    for (std::optional<Error> &E : Errs) {
+      if (Err)
+        consumeError(std::move(*E));
+      else
+        Err = std::move(*E);
+    }
+    if (Err)
+      return Err;
+  }
+
   for (SectionBase &Sec : Obj.sections())
     // Segments are responsible for writing their contents, so only write the
     // section data if the section is not in a segment. Note that this renders
     // sections in segments effectively immutable.
-    if (Sec.ParentSegment == nullptr)
+    if (Sec.ParentSegment == nullptr && !Sec.isExpensiveToWrite())
       if (Error Err = Sec.accept(*SecWriter))
         return Err;
 
@@ -549,6 +549,9 @@ public:
   virtual void
   replaceSectionReferences(const DenseMap<SectionBase *, SectionBase *> &);
   virtual bool hasContents() const { return false; }
+  // Whether writing the contents is costly enough (e.g. it decompresses data)
+  // that the writer should write such sections in parallel.
+  virtual bool isExpensiveToWrite() const { return false; }
   // Notify the section that it is subject to removal.
   virtual void onRemove();
 
@@ -695,6 +698,7 @@ public:
     Flags = OriginalFlags = (Flags & ~ELF::SHF_COMPRESSED);
   }
 
+  bool isExpensiveToWrite() const override { return true; }
   Error accept(SectionVisitor &Visitor) const override;
   Error accept(MutableSectionVisitor &Visitor) override;
 };
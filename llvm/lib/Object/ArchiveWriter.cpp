@@ -31,12 +31,14 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <cerrno>
 #include <map>
+#include <optional>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -704,10 +706,28 @@ bool isImportDescriptor(StringRef Name) {
           Name.ends_with(NullThunkDataSuffix));
 }
 
-static Expected<std::vector<unsigned>> getSymbols(SymbolicFile *Obj,
-                                                  uint16_t Index,
-                                                  raw_ostream &SymNames,
-                                                  SymMap *SymMap) {
+// Print the names of the archive symbols of Obj to Names, each terminated by
+// '\0'. This only reads Obj, so it can run for several members in parallel.
+static Error getSymbolNames(SymbolicFile *Obj, std::string &Names) {
+  if (Obj == nullptr)
+    return Error::success();
+
+  raw_string_ostream NameStream(Names);
+  for (const object::BasicSymbolRef &S : Obj->symbols()) {
+    if (!isArchiveSymbol(S))
+      continue;
+    if (Error E = S.printName(NameStream))
+      return E;
+    NameStream << '\0';
+  }
+  return Error::success();
+}
+
+// Add the symbol names collected by getSymbolNames() for member Obj to
+// SymNames and SymMap.
+static std::vector<unsigned> getSymbols(SymbolicFile *Obj, StringRef Names,
+                                        uint16_t Index, raw_ostream &SymNames,
+                                        SymMap *SymMap) {
   std::vector<unsigned> Ret;
 
   if (Obj == nullptr)
@@ -717,35 +737,39 @@ static Expected<std::vector<unsigned>> getSymbols(SymbolicFile *Obj,
   if (SymMap)
     Map = SymMap->UseECMap && isECObject(*Obj) ? &SymMap->ECMap : &SymMap->Map;
 
-  for (const object::BasicSymbolRef &S : Obj->symbols()) {
-    if (!isArchiveSymbol(S))
-      continue;
+  while (!Names.empty()) {
+    auto [Name, Rest] = Names.split('\0');
+    Names = Rest;
     if (Map) {
-      std::string Name;
-      raw_string_ostream NameStream(Name);
-      if (Error E = S.printName(NameStream))
-        return std::move(E);
-      if (Map->find(Name) != Map->end())
+      if (Map->find(Name.str()) != Map->end())
         continue; // ignore duplicated symbol
-      (*Map)[Name] = Index;
+      (*Map)[Name.str()] = Index;
       if (Map == &SymMap->Map) {
         Ret.push_back(SymNames.tell());
         SymNames << Name << '\0';
         // If EC is enabled, then the import descriptors are NOT put into EC
         // objects so we need to copy them to the EC map manually.
         if (SymMap->UseECMap && isImportDescriptor(Name))
-          SymMap->ECMap[Name] = Index;
+          SymMap->ECMap[Name.str()] = Index;
       }
     } else {
       Ret.push_back(SymNames.tell());
-      if (Error E = S.printName(SymNames))
-        return std::move(E);
-      SymNames << '\0';
+      SymNames << Name << '\0';
     }
   }
   return Ret;
 }
 
+static Expected<std::vector<unsigned>> getSymbols(SymbolicFile *Obj,
+                                                  uint16_t Index,
+                                                  raw_ostream &SymNames,
+                                                  SymMap *SymMap) {
+  std::string Names;
+  if (Error E = getSymbolNames(Obj, Names))
+    return std::move(E);
+  return getSymbols(Obj, Names, Index, SymNames, SymMap);
+}
+
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, bool Deterministic,
@@ -816,14 +840,48 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
   }
 
   std::vector<std::unique_ptr<SymbolicFile>> SymFiles;
+  std::vector<std::string> SymNamesPerMember;
 
   if (NeedSymbols != SymtabWritingMode::NoSymtab || isAIXBigArchive(Kind)) {
-    for (const NewArchiveMember &M : NewMembers) {
+    // Reading the members and their symbol names is independent per member,
+    // so do it in parallel. Bitcode members share Context, which is not
+    // thread-safe, so they are read serially afterwards. Errors are reported
+    // for the first failing member, as if the members were read in order.
+    bool CollectNames = NeedSymbols != SymtabWritingMode::NoSymtab;
+    SymFiles.resize(NewMembers.size());
+    SymNamesPerMember.resize(NewMembers.size());
+    std::vector<std::optional<Error>> Errs(NewMembers.size());
+    auto IsBitcode = [&](size_t I) {
+      return identify_magic(NewMembers[I].Buf->getBuffer()) ==
+             file_magic::bitcode;
+    };
+    auto ReadMember = [&](size_t I) {
       Expected<std::unique_ptr<SymbolicFile>> SymFileOrErr =
-          getSymbolicFile(M.Buf->getMemBufferRef(), Context);
-      if (!SymFileOrErr)
-        return createFileError(M.MemberName, SymFileOrErr.takeError());
-      SymFiles.push_back(std::move(*SymFileOrErr));
+          getSymbolicFile(NewMembers[I].Buf->getMemBufferRef(), Context);
+      if (!SymFileOrErr) {
+        Errs[I].emplace(SymFileOrErr.takeError());
+        return;
+      }
+      SymFiles[I] = std::move(*SymFileOrErr);
+      if (CollectNames)
+        if (Error E = getSymbolNames(SymFiles[I].get(), SymNamesPerMember[I]))
+          Errs[I].emplace(std::move(E));
+    };
+    parallelFor(0, NewMembers.size(), [&](size_t I) {
+      if (!IsBitcode(I))
+        ReadMember(I);
+    });
+    for (size_t I = 0, E = NewMembers.size(); I != E; ++I)
+      if (IsBitcode(I))
+        ReadMember(I);
+
+    for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+      if (!Errs[I])
+        continue;
+      for (size_t J = I + 1; J != E; ++J)
+        if (Errs[J])
+          consumeError(std::move(*Errs[J]));
+      return createFileError(NewMembers[I].MemberName, std::move(*Errs[I]));
     }
   }
 
@@ -933,11 +991,10 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
 
     std::vector<unsigned> Symbols;
     if (NeedSymbols != SymtabWritingMode::NoSymtab) {
-      Expected<std::vector<unsigned>> SymbolsOrErr =
-          getSymbols(CurSymFile.get(), Index + 1, SymNames, SymMap);
-      if (!SymbolsOrErr)
-        return createFileError(M->MemberName, SymbolsOrErr.takeError());
-      Symbols = std::move(*SymbolsOrErr);
+      Symbols = getSymbols(CurSymFile.get(), SymNamesPerMember[Index],
+                           Index + 1, SymNames, SymMap);
+      SymNamesPerMember[Index].clear();
+      SymNamesPerMember[Index].shrink_to_fit();
       if (CurSymFile)
         HasObject = true;
     }
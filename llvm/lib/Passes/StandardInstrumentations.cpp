@@ -49,6 +49,11 @@
 
 using namespace llvm;
 
+static cl::opt<bool> ReportSpuriousInvalidation(
+    "report-spurious-invalidation", cl::Hidden, cl::init(false),
+    cl::desc("Report function passes that invalidate analyses without "
+             "changing the function's structural hash"));
+
 static cl::opt<bool> VerifyAnalysisInvalidation("verify-analysis-invalidation",
                                                 cl::Hidden,
 #ifdef EXPENSIVE_CHECKS
@@ -1556,6 +1561,35 @@ void InLineChangePrinter::registerCallbacks(PassInstrumentationCallbacks &PIC) {
     TextChangeReporter<IRDataT<EmptyData>>::registerRequiredCallbacks(PIC);
 }
 
+void SpuriousInvalidationReporter::registerCallbacks(
+    PassInstrumentationCallbacks &PIC) {
+  if (!ReportSpuriousInvalidation)
+    return;
+
+  PIC.registerBeforeNonSkippedPassCallback([this](StringRef P, Any IR) {
+    const auto *F = unwrapIR<Function>(IR);
+    if (F && !isIgnored(P))
+      HashesBefore.push_back(StructuralHash(*F, /*DetailedHash=*/true));
+    else
+      HashesBefore.push_back(std::nullopt);
+  });
+  PIC.registerAfterPassCallback(
+      [this](StringRef P, Any IR, const PreservedAnalyses &PassPA) {
+        std::optional<uint64_t> HashBefore = HashesBefore.pop_back_val();
+        if (!HashBefore || PassPA.areAllPreserved())
+          return;
+        const auto *F = unwrapIR<Function>(IR);
+        if (*HashBefore == StructuralHash(*F, /*DetailedHash=*/true))
+          dbgs() << "Spurious invalidation: " << P
+                 << " invalidated analyses of unchanged function @"
+                 << F->getName() << "\n";
+      });
+  PIC.registerAfterPassInvalidatedCallback(
+      [this](StringRef P, const PreservedAnalyses &) {
+        HashesBefore.pop_back();
+      });
+}
+
 TimeProfilingPassesHandler::TimeProfilingPassesHandler() {}
 
 void TimeProfilingPassesHandler::registerCallbacks(
@@ -2515,6 +2549,7 @@ void StandardInstrumentations::registerCallbacks(
   PseudoProbeVerification.registerCallbacks(PIC);
   if (VerifyEach)
     Verify.registerCallbacks(PIC);
+  SpuriousInvalidation.registerCallbacks(PIC);
   PrintChangedDiff.registerCallbacks(PIC);
   WebsiteChangeReporter.registerCallbacks(PIC);
   ChangeTester.registerCallbacks(PIC);
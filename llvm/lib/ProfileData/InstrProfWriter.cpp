@@ -26,6 +26,7 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/OnDiskHashTable.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdint>
 #include <memory>
@@ -410,6 +411,28 @@ void InstrProfWriter::mergeRecordsFromWriter(InstrProfWriter &&IPW,
   }
 }
 
+void InstrProfWriter::mergeFunctionShardFromWriter(
+    InstrProfWriter &IPW, unsigned Shard, unsigned NumShards,
+    function_ref<void(Error)> Warn) {
+  assert(Shard < NumShards && "Shard out of range");
+  for (auto &I : IPW.FunctionData) {
+    uint32_t FullHash = StringMap<ProfilingData>::hash(I.getKey());
+    if (FullHash % NumShards != Shard)
+      continue;
+    ProfilingData &Src = I.getValue();
+    auto [Where, Inserted] =
+        FunctionData.try_emplace_with_hash(I.getKey(), FullHash);
+    if (Inserted) {
+      // Records in a writer are already sorted, so they can be moved as is.
+      Where->second = std::move(Src);
+    } else {
+      for (auto &Func : Src)
+        addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
+    }
+    Src.clear();
+  }
+}
+
 bool InstrProfWriter::shouldEncodeData(const ProfilingData &PD) {
   if (!Sparse)
     return true;
@@ -844,11 +867,24 @@ Error InstrProfWriter::writeImpl(ProfOStream &OS) {
   InfoObj->CSSummaryBuilder = &CSISB;
 
   // Populate the hash table generator.
+  // Scanning the counters for sparse output and sorting dominate for large
+  // merged profiles, so both are done in parallel.
   SmallVector<std::pair<StringRef, const ProfilingData *>> OrderedData;
+  OrderedData.reserve(FunctionData.size());
   for (const auto &I : FunctionData)
-    if (shouldEncodeData(I.getValue()))
-      OrderedData.emplace_back((I.getKey()), &I.getValue());
-  llvm::sort(OrderedData, less_first());
+    OrderedData.emplace_back((I.getKey()), &I.getValue());
+  if (Sparse) {
+    SmallVector<char, 0> Encode(OrderedData.size());
+    parallelFor(0, OrderedData.size(), [&](size_t I) {
+      Encode[I] = shouldEncodeData(*OrderedData[I].second);
+    });
+    size_t Kept = 0;
+    for (size_t I = 0, E = OrderedData.size(); I != E; ++I)
+      if (Encode[I])
+        OrderedData[Kept++] = OrderedData[I];
+    OrderedData.truncate(Kept);
+  }
+  parallelSort(OrderedData, less_first());
   for (const auto &I : OrderedData)
     Generator.insert(I.first, I.second);
 
@@ -604,6 +604,10 @@ SampleProfileReaderBinary::readProfile(FunctionSamples &FProfile) {
     // Here we handle FS discriminators:
     uint32_t DiscriminatorVal = (*Discriminator) & getDiscriminatorMask();
 
+    // Records are written in location order, so look each one up only once.
+    SampleRecord &Record = FProfile.getOrCreateBodySample(
+        LineLocation(*LineOffset, DiscriminatorVal));
+    Record.reserveCallTargets(*NumCalls);
     for (uint32_t J = 0; J < *NumCalls; ++J) {
       auto CalledFunction(readStringFromTable());
       if (std::error_code EC = CalledFunction.getError())
@@ -613,11 +617,10 @@ SampleProfileReaderBinary::readProfile(FunctionSamples &FProfile) {
       if (std::error_code EC = CalledFunctionSamples.getError())
         return EC;
 
-      FProfile.addCalledTargetSamples(*LineOffset, DiscriminatorVal,
-                                      *CalledFunction, *CalledFunctionSamples);
+      Record.addCalledTarget(*CalledFunction, *CalledFunctionSamples);
     }
 
-    FProfile.addBodySamples(*LineOffset, DiscriminatorVal, *NumSamples);
+    Record.addSamples(*NumSamples);
   }
 
   // Read all the samples for inlined function calls.
@@ -641,7 +644,7 @@ SampleProfileReaderBinary::readProfile(FunctionSamples &FProfile) {
     // Here we handle FS discriminators:
     uint32_t DiscriminatorVal = (*Discriminator) & getDiscriminatorMask();
 
-    FunctionSamples &CalleeProfile = FProfile.functionSamplesAt(
+    FunctionSamples &CalleeProfile = FProfile.getOrCreateCallsiteSamples(
         LineLocation(*LineOffset, DiscriminatorVal))[*FName];
     CalleeProfile.setFunction(*FName);
     if (std::error_code EC = readProfile(CalleeProfile))
@@ -9,8 +9,10 @@
 #include "llvm/Support/Parallel.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Threading.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <future>
@@ -235,17 +237,24 @@ void llvm::parallelFor(size_t Begin, size_t End,
     if (TaskSize == 0)
       TaskSize = 1;
 
+    // Rather than queueing a task per chunk, start at most one task per
+    // thread and let the tasks claim chunks from a shared counter. The load
+    // is still balanced dynamically, but every worker goes through the
+    // executor's queue lock only once instead of once per chunk.
+    size_t NumChunks = divideCeil(NumItems, TaskSize);
+    size_t NumTasks = std::min<size_t>(NumChunks, parallel::getThreadCount());
+    std::atomic<size_t> NextChunk{0};
     parallel::TaskGroup TG;
-    for (; Begin + TaskSize < End; Begin += TaskSize) {
-      TG.spawn([=, &Fn] {
-        for (size_t I = Begin, E = Begin + TaskSize; I != E; ++I)
-          Fn(I);
-      });
-    }
-    if (Begin != End) {
-      TG.spawn([=, &Fn] {
-        for (size_t I = Begin; I != End; ++I)
-          Fn(I);
+    for (size_t T = 0; T != NumTasks; ++T) {
+      TG.spawn([=, &NextChunk, &Fn] {
+        for (size_t Chunk = NextChunk.fetch_add(1, std::memory_order_relaxed);
+             Chunk < NumChunks;
+             Chunk = NextChunk.fetch_add(1, std::memory_order_relaxed)) {
+          size_t I = Begin + Chunk * TaskSize;
+          size_t E = std::min(I + TaskSize, End);
+          for (; I != E; ++I)
+            Fn(I);
+        }
       });
     }
     return;
@@ -0,0 +1,89 @@
+//===- llvm/Support/SuffixArray.cpp - Implement Suffix Array ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the Suffix Array class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SuffixArray.h"
+#include "llvm/ADT/STLExtras.h"
+#include <numeric>
+
+using namespace llvm;
+
+SuffixArray::SuffixArray(ArrayRef<unsigned> Str) : Str(Str) {
+  unsigned N = Str.size();
+  SA.resize(N);
+  LCP.assign(N, 0);
+  if (N == 0)
+    return;
+
+  // Sort the suffixes by prefix doubling: after the round for K, Rank orders
+  // the suffixes by their first 2 * K elements.
+  std::vector<unsigned> Rank(N), NewRank(N);
+  std::iota(SA.begin(), SA.end(), 0);
+  llvm::sort(SA, [&](unsigned L, unsigned R) { return Str[L] < Str[R]; });
+  for (unsigned I = 1; I < N; ++I)
+    Rank[SA[I]] = Rank[SA[I - 1]] + (Str[SA[I - 1]] != Str[SA[I]]);
+
+  for (unsigned K = 1; Rank[SA[N - 1]] != N - 1 && K < N; K *= 2) {
+    // Suffixes shorter than K sort before everything they are a prefix of.
+    auto Key = [&](unsigned I) {
+      return std::make_pair(Rank[I], I + K < N ? Rank[I + K] + 1 : 0);
+    };
+    llvm::sort(SA, [&](unsigned L, unsigned R) { return Key(L) < Key(R); });
+    NewRank[SA[0]] = 0;
+    for (unsigned I = 1; I < N; ++I)
+      NewRank[SA[I]] = NewRank[SA[I - 1]] + (Key(SA[I - 1]) != Key(SA[I]));
+    Rank.swap(NewRank);
+  }
+
+  // Compute the LCP array with Kasai's algorithm, reusing Rank as the inverse
+  // of SA.
+  for (unsigned Len = 0, I = 0; I < N; ++I) {
+    if (Rank[I] == 0) {
+      Len = 0;
+      continue;
+    }
+    unsigned J = SA[Rank[I] - 1];
+    while (I + Len < N && J + Len < N && Str[I + Len] == Str[J + Len])
+      ++Len;
+    LCP[Rank[I]] = Len;
+    if (Len)
+      --Len;
+  }
+}
+
+std::vector<SuffixTree::RepeatedSubstring>
+SuffixArray::getRepeatedSubstrings(unsigned MinLength) const {
+  std::vector<SuffixTree::RepeatedSubstring> Result;
+
+  // Walk the LCP intervals bottom-up. Each interval is an internal node of the
+  // suffix tree whose string has length Length. A suffix is a leaf directly
+  // below the deepest interval that contains it, i.e. the one whose length is
+  // the longest prefix it shares with either neighbour.
+  SmallVector<SuffixTree::RepeatedSubstring> Stack;
+  Stack.push_back({0, {}});
+  for (unsigned I = 0, N = SA.size(); I < N; ++I) {
+    unsigned NextLCP = I + 1 < N ? LCP[I + 1] : 0;
+    if (NextLCP > Stack.back().Length)
+      Stack.push_back({NextLCP, {}});
+    Stack.back().StartIndices.push_back(SA[I]);
+
+    // Close the intervals that end at this suffix.
+    while (Stack.back().Length > NextLCP) {
+      SuffixTree::RepeatedSubstring RS = Stack.pop_back_val();
+      if (RS.Length >= MinLength && RS.StartIndices.size() >= 2)
+        Result.push_back(std::move(RS));
+      // The closed interval may be nested in one that started before it.
+      if (Stack.back().Length < NextLCP)
+        Stack.push_back({NextLCP, {}});
+    }
+  }
+  return Result;
+}
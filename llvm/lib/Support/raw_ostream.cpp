@@ -857,6 +857,12 @@ size_t raw_fd_ostream::preferred_buffer_size() const {
   // the complexity.
   if (S_ISCHR(statbuf.st_mode) && is_displayed())
     return 0;
+  // For regular files the block size (typically 4KiB) is only a lower bound.
+  // Large outputs are often produced through many small writes, so a bigger
+  // buffer saves most of the write(2) calls at little memory cost. Large
+  // writes into an empty buffer still bypass it.
+  if (S_ISREG(statbuf.st_mode))
+    return std::max<size_t>(statbuf.st_blksize, 64 * 1024);
   // Return the preferred block size.
   return statbuf.st_blksize;
 #endif
@@ -3244,6 +3244,23 @@ std::vector<Record *> RecordKeeper::getAllDerivedDefinitions(
     ClassRecs.push_back(Class);
   }
 
+  // If the definitions of the first class are already cached, filter those
+  // rather than scanning every def. The cached vector is sorted, so the
+  // result needs no further sorting.
+  if (ClassNames.size() > 1) {
+    auto It = ClassRecordsMap.find(ClassNames[0]);
+    if (It != ClassRecordsMap.end()) {
+      ArrayRef<Record *> Rest = ArrayRef(ClassRecs).drop_front();
+      for (Record *Def : It->second) {
+        if (all_of(Rest, [Def](const Record *Class) {
+              return Def->isSubClassOf(Class);
+            }))
+          Defs.push_back(Def);
+      }
+      return Defs;
+    }
+  }
+
   for (const auto &OneDef : getDefs()) {
     if (all_of(ClassRecs, [&OneDef](const Record *Class) {
                             return OneDef.second->isSubClassOf(Class);
@@ -55,9 +55,11 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO.h"
 #include "llvm/Transforms/Utils/Local.h"
+#include <atomic>
 #include <cassert>
 #include <iterator>
 #include <map>
@@ -410,31 +412,32 @@ bool llvm::thinLTOPropagateFunctionAttrs(
     return false;
 
   DenseMap<ValueInfo, FunctionSummary *> CachedPrevailingSummary;
-  bool Changed = false;
 
-  auto PropagateAttributes = [&](std::vector<ValueInfo> &SCCNodes) {
+  // Runs concurrently for independent SCCs, so it only reads
+  // CachedPrevailingSummary, which is filled in beforehand. Returns whether
+  // any flag was propagated.
+  auto PropagateAttributes = [&](const std::vector<ValueInfo> &SCCNodes) {
     // Assume we can propagate unless we discover otherwise
     FunctionSummary::FFlags InferredFlags;
     InferredFlags.NoRecurse = (SCCNodes.size() == 1);
     InferredFlags.NoUnwind = true;
 
     for (auto &V : SCCNodes) {
-      FunctionSummary *CallerSummary =
-          calculatePrevailingSummary(V, CachedPrevailingSummary, IsPrevailing);
+      FunctionSummary *CallerSummary = CachedPrevailingSummary.lookup(V);
 
       // Function summaries can fail to contain information such as declarations
       if (!CallerSummary)
-        return;
+        return false;
 
       if (CallerSummary->fflags().MayThrow)
         InferredFlags.NoUnwind = false;
 
       for (const auto &Callee : CallerSummary->calls()) {
-        FunctionSummary *CalleeSummary = calculatePrevailingSummary(
-            Callee.first, CachedPrevailingSummary, IsPrevailing);
+        FunctionSummary *CalleeSummary =
+            CachedPrevailingSummary.lookup(Callee.first);
 
         if (!CalleeSummary)
-          return;
+          return false;
 
         if (!CalleeSummary->fflags().NoRecurse)
           InferredFlags.NoRecurse = false;
@@ -447,41 +450,94 @@ bool llvm::thinLTOPropagateFunctionAttrs(
       }
     }
 
-    if (InferredFlags.NoUnwind || InferredFlags.NoRecurse) {
-      Changed = true;
-      for (auto &V : SCCNodes) {
-        if (InferredFlags.NoRecurse) {
-          LLVM_DEBUG(dbgs() << "ThinLTO FunctionAttrs: Propagated NoRecurse to "
-                            << V.name() << "\n");
-          ++NumThinLinkNoRecurse;
-        }
+    if (!InferredFlags.NoUnwind && !InferredFlags.NoRecurse)
+      return false;
 
-        if (InferredFlags.NoUnwind) {
-          LLVM_DEBUG(dbgs() << "ThinLTO FunctionAttrs: Propagated NoUnwind to "
-                            << V.name() << "\n");
-          ++NumThinLinkNoUnwind;
-        }
+    for (auto &V : SCCNodes) {
+      if (InferredFlags.NoRecurse) {
+        LLVM_DEBUG(dbgs() << "ThinLTO FunctionAttrs: Propagated NoRecurse to "
+                          << V.name() << "\n");
+        ++NumThinLinkNoRecurse;
+      }
 
-        for (const auto &S : V.getSummaryList()) {
-          if (auto *FS = dyn_cast<FunctionSummary>(S.get())) {
-            if (InferredFlags.NoRecurse)
-              FS->setNoRecurse();
+      if (InferredFlags.NoUnwind) {
+        LLVM_DEBUG(dbgs() << "ThinLTO FunctionAttrs: Propagated NoUnwind to "
+                          << V.name() << "\n");
+        ++NumThinLinkNoUnwind;
+      }
 
-            if (InferredFlags.NoUnwind)
-              FS->setNoUnwind();
-          }
+      for (const auto &S : V.getSummaryList()) {
+        if (auto *FS = dyn_cast<FunctionSummary>(S.get())) {
+          if (InferredFlags.NoRecurse)
+            FS->setNoRecurse();
+
+          if (InferredFlags.NoUnwind)
+            FS->setNoUnwind();
         }
       }
     }
+    return true;
   };
 
-  // Call propagation functions on each SCC in the Index
+  // Call propagation functions on each SCC in the Index. The SCCs are visited
+  // bottom-up, and an SCC reads the flags written by the SCCs owning the
+  // summaries it looks at. Give every SCC a level above that of each earlier
+  // SCC it reads from, and below that of each later SCC that writes what it
+  // reads, and propagate the SCCs of one level in parallel. This produces the
+  // same flags as visiting the SCCs one at a time.
+  std::vector<std::vector<ValueInfo>> SCCs;
+  std::vector<unsigned> Levels;
+  DenseMap<const FunctionSummary *, unsigned> OwningSCC;
+  DenseMap<const FunctionSummary *, SmallVector<unsigned, 1>> EarlierReaders;
+  unsigned MaxLevel = 0;
   for (scc_iterator<ModuleSummaryIndex *> I = scc_begin(&Index); !I.isAtEnd();
        ++I) {
-    std::vector<ValueInfo> Nodes(*I);
-    PropagateAttributes(Nodes);
+    unsigned Idx = SCCs.size();
+    const std::vector<ValueInfo> &Nodes = SCCs.emplace_back(*I);
+    unsigned Level = 0;
+    for (const ValueInfo &V : Nodes)
+      for (const auto &S : V.getSummaryList())
+        if (auto *FS = dyn_cast<FunctionSummary>(S.get())) {
+          OwningSCC[FS] = Idx;
+          auto It = EarlierReaders.find(FS);
+          if (It == EarlierReaders.end())
+            continue;
+          for (unsigned Reader : It->second)
+            Level = std::max(Level, Levels[Reader] + 1);
+          EarlierReaders.erase(It);
+        }
+
+    auto AddRead = [&](FunctionSummary *FS) {
+      if (!FS)
+        return;
+      auto It = OwningSCC.find(FS);
+      if (It == OwningSCC.end())
+        EarlierReaders[FS].push_back(Idx);
+      else if (It->second != Idx)
+        Level = std::max(Level, Levels[It->second] + 1);
+    };
+    for (const ValueInfo &V : Nodes) {
+      FunctionSummary *CallerSummary =
+          calculatePrevailingSummary(V, CachedPrevailingSummary, IsPrevailing);
+      AddRead(CallerSummary);
+      if (CallerSummary)
+        for (const auto &Callee : CallerSummary->calls())
+          AddRead(calculatePrevailingSummary(
+              Callee.first, CachedPrevailingSummary, IsPrevailing));
+    }
+    Levels.push_back(Level);
+    MaxLevel = std::max(MaxLevel, Level);
   }
-  return Changed;
+
+  std::vector<std::vector<unsigned>> SCCsByLevel(MaxLevel + 1);
+  for (unsigned Idx = 0, E = SCCs.size(); Idx != E; ++Idx)
+    SCCsByLevel[Levels[Idx]].push_back(Idx);
+  std::vector<char> SCCChanged(SCCs.size());
+  for (const std::vector<unsigned> &LevelSCCs : SCCsByLevel)
+    parallelForEach(LevelSCCs, [&](unsigned Idx) {
+      SCCChanged[Idx] = PropagateAttributes(SCCs[Idx]);
+    });
+  return llvm::is_contained(SCCChanged, true);
 }
 
 namespace {
@@ -38,6 +38,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -46,6 +47,7 @@
 #include "llvm/Transforms/Utils/ValueMapper.h"
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <system_error>
@@ -80,6 +82,10 @@ static cl::opt<int> ImportCutoff(
     "import-cutoff", cl::init(-1), cl::Hidden, cl::value_desc("N"),
     cl::desc("Only import first N functions if N>=0 (default -1)"));
 
+static cl::opt<bool> UseCalleeSelectionCache(
+    "import-callee-selection-cache", cl::init(true), cl::Hidden,
+    cl::desc("Memoize callee selection across the modules of a thin link"));
+
 static cl::opt<bool>
     ForceImportAll("force-import-all", cl::init(false), cl::Hidden,
                    cl::desc("Import functions with noinline attribute"));
@@ -288,6 +294,106 @@ selectCallee(const ModuleSummaryIndex &Index,
 
 namespace {
 
+/// A memo of selectCallee results shared by the import computations of the
+/// modules in one group of a thin link; it is not thread-safe. Which candidate
+/// selectCallee picks for a GUID only depends on the threshold, unless the
+/// summary list holds one of several locals with the same GUID, whose
+/// eligibility depends on the caller's module; such GUIDs bypass the cache.
+/// For every other GUID, the candidates are qualified once, and only those
+/// selected at some threshold are kept, in decreasing order of the minimum
+/// threshold at which they are selected.
+class CalleeSelectionCache {
+  struct Candidate {
+    unsigned MinThreshold;
+    const GlobalValueSummary *Summary;
+  };
+
+  struct Selection {
+    bool DependsOnCaller = false;
+    SmallVector<Candidate, 1> Candidates;
+    /// selectCallee reports the failure of the last summary in the list when
+    /// no candidate is selected. This is its threshold independent reason, or
+    /// None if it is only rejected for its size below LastMinThreshold and
+    /// for being noinline above it.
+    FunctionImporter::ImportFailureReason LastReason{};
+    unsigned LastMinThreshold = 0;
+  };
+
+  const ModuleSummaryIndex &Index;
+  DenseMap<GlobalValue::GUID, std::unique_ptr<Selection>> Selections;
+
+  std::unique_ptr<Selection> computeSelection(ValueInfo VI) const {
+    auto Sel = std::make_unique<Selection>();
+    auto CalleeSummaryList = VI.getSummaryList();
+    if (CalleeSummaryList.size() > 1 &&
+        llvm::any_of(CalleeSummaryList, [](const auto &SummaryPtr) {
+          auto *Summary =
+              dyn_cast<FunctionSummary>(SummaryPtr->getBaseObject());
+          return Summary && GlobalValue::isLocalLinkage(Summary->linkage());
+        })) {
+      Sel->DependsOnCaller = true;
+      return Sel;
+    }
+
+    // There are no locals the caller module could matter for, so any module
+    // path qualifies the candidates the same way.
+    for (auto QualifiedValue :
+         qualifyCalleeCandidates(Index, CalleeSummaryList, "")) {
+      Sel->LastReason = QualifiedValue.first;
+      if (Sel->LastReason != FunctionImporter::ImportFailureReason::None)
+        continue;
+      auto *Summary =
+          cast<FunctionSummary>(QualifiedValue.second->getBaseObject());
+      Sel->LastMinThreshold =
+          Summary->fflags().AlwaysInline || ForceImportAll
+              ? 0
+              : Summary->instCount();
+      if (Summary->fflags().NoInline && !ForceImportAll)
+        continue;
+      // A candidate that needs at least the threshold of an earlier one is
+      // never selected.
+      if (Sel->Candidates.empty() ||
+          Sel->LastMinThreshold < Sel->Candidates.back().MinThreshold)
+        Sel->Candidates.push_back({Sel->LastMinThreshold, Summary});
+    }
+    return Sel;
+  }
+
+  const Selection &getSelection(ValueInfo VI) {
+    std::unique_ptr<Selection> &Sel = Selections[VI.getGUID()];
+    if (!Sel)
+      Sel = computeSelection(VI);
+    return *Sel;
+  }
+
+public:
+  CalleeSelectionCache(const ModuleSummaryIndex &Index) : Index(Index) {}
+
+  /// Equivalent to selectCallee for the summaries of \p VI.
+  const GlobalValueSummary *
+  select(ValueInfo VI, unsigned Threshold, StringRef CallerModulePath,
+         FunctionImporter::ImportFailureReason &Reason) {
+    const Selection &Sel = getSelection(VI);
+    if (Sel.DependsOnCaller)
+      return selectCallee(Index, VI.getSummaryList(), Threshold,
+                          CallerModulePath, Reason);
+
+    for (const Candidate &C : Sel.Candidates)
+      if (C.MinThreshold <= Threshold)
+        return C.Summary;
+
+    if (VI.getSummaryList().empty())
+      return nullptr;
+    if (Sel.LastReason != FunctionImporter::ImportFailureReason::None)
+      Reason = Sel.LastReason;
+    else if (Threshold < Sel.LastMinThreshold)
+      Reason = FunctionImporter::ImportFailureReason::TooLarge;
+    else
+      Reason = FunctionImporter::ImportFailureReason::NoInline;
+    return nullptr;
+  }
+};
+
 using EdgeInfo = std::tuple<const FunctionSummary *, unsigned /* Threshold */>;
 
 } // anonymous namespace
@@ -407,13 +513,16 @@ protected:
       IsPrevailing;
   const ModuleSummaryIndex &Index;
   DenseMap<StringRef, FunctionImporter::ExportSetTy> *const ExportLists;
+  CalleeSelectionCache *const SelectionCache;
 
   ModuleImportsManager(
       function_ref<bool(GlobalValue::GUID, const GlobalValueSummary *)>
           IsPrevailing,
       const ModuleSummaryIndex &Index,
-      DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists = nullptr)
-      : IsPrevailing(IsPrevailing), Index(Index), ExportLists(ExportLists) {}
+      DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists = nullptr,
+      CalleeSelectionCache *SelectionCache = nullptr)
+      : IsPrevailing(IsPrevailing), Index(Index), ExportLists(ExportLists),
+        SelectionCache(SelectionCache) {}
 
 public:
   virtual ~ModuleImportsManager() = default;
@@ -431,7 +540,8 @@ public:
              IsPrevailing,
          const ModuleSummaryIndex &Index,
          DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists =
-             nullptr);
+             nullptr,
+         CalleeSelectionCache *SelectionCache = nullptr);
 };
 
 /// A ModuleImportsManager that operates based on a workload definition (see
@@ -558,8 +668,10 @@ public:
       function_ref<bool(GlobalValue::GUID, const GlobalValueSummary *)>
           IsPrevailing,
       const ModuleSummaryIndex &Index,
-      DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists)
-      : ModuleImportsManager(IsPrevailing, Index, ExportLists) {
+      DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists,
+      CalleeSelectionCache *SelectionCache)
+      : ModuleImportsManager(IsPrevailing, Index, ExportLists,
+                             SelectionCache) {
     // Since the workload def uses names, we need a quick lookup
     // name->ValueInfo.
     StringMap<ValueInfo> NameToValueInfo;
@@ -645,15 +757,16 @@ std::unique_ptr<ModuleImportsManager> ModuleImportsManager::create(
     function_ref<bool(GlobalValue::GUID, const GlobalValueSummary *)>
         IsPrevailing,
     const ModuleSummaryIndex &Index,
-    DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists) {
+    DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists,
+    CalleeSelectionCache *SelectionCache) {
   if (WorkloadDefinitions.empty()) {
     LLVM_DEBUG(dbgs() << "[Workload] Using the regular imports manager.\n");
-    return std::unique_ptr<ModuleImportsManager>(
-        new ModuleImportsManager(IsPrevailing, Index, ExportLists));
+    return std::unique_ptr<ModuleImportsManager>(new ModuleImportsManager(
+        IsPrevailing, Index, ExportLists, SelectionCache));
   }
   LLVM_DEBUG(dbgs() << "[Workload] Using the contextual imports manager.\n");
-  return std::make_unique<WorkloadImportsManager>(IsPrevailing, Index,
-                                                  ExportLists);
+  return std::make_unique<WorkloadImportsManager>(
+      IsPrevailing, Index, ExportLists, SelectionCache);
 }
 
 static const char *
@@ -690,7 +803,8 @@ static void computeImportForFunction(
     SmallVectorImpl<EdgeInfo> &Worklist, GlobalsImporter &GVImporter,
     FunctionImporter::ImportMapTy &ImportList,
     DenseMap<StringRef, FunctionImporter::ExportSetTy> *ExportLists,
-    FunctionImporter::ImportThresholdsTy &ImportThresholds) {
+    FunctionImporter::ImportThresholdsTy &ImportThresholds,
+    CalleeSelectionCache *SelectionCache) {
   GVImporter.onImportingSummary(Summary);
   static int ImportCount = 0;
   for (const auto &Edge : Summary.calls()) {
@@ -769,8 +883,12 @@ static void computeImportForFunction(
       }
 
       FunctionImporter::ImportFailureReason Reason{};
-      CalleeSummary = selectCallee(Index, VI.getSummaryList(), NewThreshold,
-                                   Summary.modulePath(), Reason);
+      CalleeSummary =
+          SelectionCache
+              ? SelectionCache->select(VI, NewThreshold, Summary.modulePath(),
+                                       Reason)
+              : selectCallee(Index, VI.getSummaryList(), NewThreshold,
+                             Summary.modulePath(), Reason);
       if (!CalleeSummary) {
         // Update with new larger threshold if this was a retry (otherwise
         // we would have already inserted with NewThreshold above). Also
@@ -883,7 +1001,8 @@ void ModuleImportsManager::computeImportForModule(
     LLVM_DEBUG(dbgs() << "Initialize import for " << VI << "\n");
     computeImportForFunction(*FuncSummary, Index, ImportInstrLimit,
                              DefinedGVSummaries, IsPrevailing, Worklist, GVI,
-                             ImportList, ExportLists, ImportThresholds);
+                             ImportList, ExportLists, ImportThresholds,
+                             SelectionCache);
   }
 
   // Process the newly imported functions and add callees to the worklist.
@@ -895,7 +1014,7 @@ void ModuleImportsManager::computeImportForModule(
     if (auto *FS = dyn_cast<FunctionSummary>(Summary))
       computeImportForFunction(*FS, Index, Threshold, DefinedGVSummaries,
                                IsPrevailing, Worklist, GVI, ImportList,
-                               ExportLists, ImportThresholds);
+                               ExportLists, ImportThresholds, SelectionCache);
   }
 
   // Print stats about functions considered but rejected for importing
@@ -996,15 +1115,54 @@ void llvm::ComputeCrossModuleImport(
         isPrevailing,
     DenseMap<StringRef, FunctionImporter::ImportMapTy> &ImportLists,
     DenseMap<StringRef, FunctionImporter::ExportSetTy> &ExportLists) {
-  auto MIS = ModuleImportsManager::create(isPrevailing, Index, &ExportLists);
   // For each module that has function defined, compute the import/export lists.
+  // The import lists of different modules are independent, so they are
+  // computed in parallel by groups of modules. Each group records the exports
+  // it causes separately, and the groups are merged in order afterwards, so
+  // the result does not depend on the number of threads. The workload imports
+  // manager scans the whole index when it is created, and -import-cutoff
+  // counts imports across all modules in order, so use a single group for
+  // them.
+  std::vector<std::pair<StringRef, const GVSummaryMapTy *>> Modules;
   for (const auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first];
-    LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first << "'\n");
-    MIS->computeImportForModule(DefinedGVSummaries.second,
-                                DefinedGVSummaries.first, ImportList);
+    Modules.emplace_back(DefinedGVSummaries.first, &DefinedGVSummaries.second);
+    ImportLists[DefinedGVSummaries.first];
   }
+  std::vector<FunctionImporter::ImportMapTy *> ModuleImportLists;
+  for (const auto &Module : Modules)
+    ModuleImportLists.push_back(&ImportLists.find(Module.first)->second);
+
+  const size_t ModulesPerGroup =
+      WorkloadDefinitions.empty() && ImportCutoff < 0
+          ? 64
+          : std::max<size_t>(Modules.size(), 1);
+  std::vector<DenseMap<StringRef, FunctionImporter::ExportSetTy>> GroupExports(
+      divideCeil(Modules.size(), ModulesPerGroup));
+  parallelFor(0, GroupExports.size(), [&](size_t Group) {
+    // Many modules import the same callees, so the callee selection is
+    // memoized across the modules of a group. Each group has its own cache
+    // rather than sharing one between the threads: it is looked up for every
+    // call edge visited, which a shared cache would have to lock, while each
+    // callee is still qualified at most once per 64 modules instead of once
+    // per importing module.
+    std::optional<CalleeSelectionCache> SelectionCache;
+    if (UseCalleeSelectionCache)
+      SelectionCache.emplace(Index);
+    auto MIS = ModuleImportsManager::create(
+        isPrevailing, Index, &GroupExports[Group],
+        SelectionCache ? &*SelectionCache : nullptr);
+    for (size_t I = Group * ModulesPerGroup,
+                E = std::min(I + ModulesPerGroup, Modules.size());
+         I != E; ++I) {
+      LLVM_DEBUG(dbgs() << "Computing import for Module '" << Modules[I].first
+                        << "'\n");
+      MIS->computeImportForModule(*Modules[I].second, Modules[I].first,
+                                  *ModuleImportLists[I]);
+    }
+  });
+  for (auto &Exports : GroupExports)
+    for (auto &ELI : Exports)
+      ExportLists[ELI.first].insert(ELI.second.begin(), ELI.second.end());
 
   // When computing imports we only added the variables and functions being
   // imported to the export list. We also need to mark any references and calls
@@ -15,8 +15,9 @@
 #ifndef LLVM_LIB_TRANSFORMS_INSTCOMBINE_INSTCOMBINEINTERNAL_H
 #define LLVM_LIB_TRANSFORMS_INSTCOMBINE_INSTCOMBINEINTERNAL_H
 
-#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Analysis/InstructionSimplify.h"
 #include "llvm/Analysis/TargetFolder.h"
 #include "llvm/Analysis/ValueTracking.h"
@@ -74,6 +75,10 @@ public:
 
   virtual ~InstCombinerImpl() = default;
 
+  /// If non-null, run() counts the successful combines here, keyed by the
+  /// opcode (or intrinsic) name of the visited instruction.
+  StringMap<unsigned> *FoldCounts = nullptr;
+
   /// Perform early cleanup and prepare the InstCombine worklist.
   bool prepareWorklist(Function &F,
                        ReversePostOrderTraversal<BasicBlock *> &RPOT);
@@ -138,6 +138,11 @@ static cl::opt<unsigned> MaxSinkNumUsers(
     "instcombine-max-sink-users", cl::init(32),
     cl::desc("Maximum number of undroppable users for instruction sinking"));
 
+static cl::opt<bool> ReportFolds(
+    "instcombine-report-folds", cl::Hidden, cl::init(false),
+    cl::desc("Print, for every function changed by instcombine, the number of "
+             "combines per opcode in each iteration"));
+
 static cl::opt<unsigned>
 MaxArraySize("instcombine-maxarray-size", cl::init(1024),
              cl::desc("Maximum array size considered when doing a combine"));
@@ -4953,6 +4958,14 @@ void InstCombinerImpl::tryToSinkInstructionDbgVariableRecords(
   }
 }
 
+/// Returns the name under which combines of \p I are reported by
+/// -instcombine-report-folds.
+static StringRef getFoldName(const Instruction &I) {
+  if (const auto *II = dyn_cast<IntrinsicInst>(&I))
+    return Intrinsic::getBaseName(II->getIntrinsicID());
+  return I.getOpcodeName();
+}
+
 bool InstCombinerImpl::run() {
   while (!Worklist.isEmpty()) {
     // Walk deferred instructions in reverse order, and push them to the
@@ -5075,8 +5088,12 @@ bool InstCombinerImpl::run() {
     LLVM_DEBUG(raw_string_ostream SS(OrigI); I->print(SS); OrigI = SS.str(););
     LLVM_DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
+    // The instruction may be erased by the visit, so take its name first.
+    StringRef FoldName = FoldCounts ? getFoldName(*I) : StringRef();
     if (Instruction *Result = visit(*I)) {
       ++NumCombined;
+      if (FoldCounts)
+        ++(*FoldCounts)[FoldName];
       // Should we replace the old instruction with a new one?
       if (Result != I) {
         LLVM_DEBUG(dbgs() << "IC: Old = " << *I << '\n'
@@ -5328,6 +5345,29 @@ bool InstCombinerImpl::prepareWorklist(
   return MadeIRChange;
 }
 
+/// Print the combines made in \p F, most frequent first. Combines that only
+/// happen after the first iteration were missed by the worklist and are the
+/// reason for the additional iterations.
+static void reportFolds(Function &F,
+                        ArrayRef<StringMap<unsigned>> FoldsPerIteration) {
+  dbgs() << "IC: " << F.getName() << ": " << FoldsPerIteration.size()
+         << " iteration(s)\n";
+  for (const auto &[Idx, Folds] : enumerate(FoldsPerIteration)) {
+    if (Folds.empty())
+      continue;
+    SmallVector<std::pair<StringRef, unsigned>, 16> Sorted;
+    for (const auto &Entry : Folds)
+      Sorted.emplace_back(Entry.getKey(), Entry.getValue());
+    llvm::sort(Sorted, [](const auto &LHS, const auto &RHS) {
+      return std::tie(RHS.second, LHS.first) < std::tie(LHS.second, RHS.first);
+    });
+    dbgs() << "  iteration " << Idx + 1 << ":";
+    for (const auto &[Name, Count] : Sorted)
+      dbgs() << ' ' << Name << '=' << Count;
+    dbgs() << '\n';
+  }
+}
+
 static bool combineInstructionsOverFunction(
     Function &F, InstructionWorklist &Worklist, AliasAnalysis *AA,
     AssumptionCache &AC, TargetLibraryInfo &TLI, TargetTransformInfo &TTI,
@@ -5354,6 +5394,9 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
+  // Per-iteration combine counts for -instcombine-report-folds.
+  SmallVector<StringMap<unsigned>, 2> FoldsPerIteration;
+
   // Iterate while there is work to do.
   unsigned Iteration = 0;
   while (true) {
@@ -5373,6 +5416,8 @@ static bool combineInstructionsOverFunction(
     InstCombinerImpl IC(Worklist, Builder, F.hasMinSize(), AA, AC, TLI, TTI, DT,
                         ORE, BFI, BPI, PSI, DL, LI);
     IC.MaxArraySizeForCombine = MaxArraySize;
+    if (ReportFolds)
+      IC.FoldCounts = &FoldsPerIteration.emplace_back();
     bool MadeChangeInThisIteration = IC.prepareWorklist(F, RPOT);
     MadeChangeInThisIteration |= IC.run();
     if (!MadeChangeInThisIteration)
@@ -5396,6 +5441,9 @@ static bool combineInstructionsOverFunction(
   else
     ++NumFourOrMoreIterations;
 
+  if (ReportFolds && MadeIRChange)
+    reportFolds(F, FoldsPerIteration);
+
   return MadeIRChange;
 }
 
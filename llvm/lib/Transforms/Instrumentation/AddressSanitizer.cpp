@@ -43,6 +43,7 @@
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Dominators.h"
 #include "llvm/IR/EHPersonalities.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalAlias.h"
@@ -393,6 +394,12 @@ static cl::opt<bool> ClOptStack(
     "asan-opt-stack", cl::desc("Don't instrument scalar stack variables"),
     cl::Hidden, cl::init(false));
 
+static cl::opt<bool> ClOptDominating(
+    "asan-opt-dominating",
+    cl::desc("Don't instrument accesses dominated by an instrumented access "
+             "to the same address in functions without calls"),
+    cl::Hidden, cl::init(false));
+
 static cl::opt<bool> ClDynamicAllocaStack(
     "asan-stack-dynamic-alloca",
     cl::desc("Use dynamic alloca to represent stack variables"), cl::Hidden,
@@ -458,6 +465,8 @@ STATISTIC(NumOptimizedAccessesToGlobalVar,
           "Number of optimized accesses to global vars");
 STATISTIC(NumOptimizedAccessesToStackVar,
           "Number of optimized accesses to stack vars");
+STATISTIC(NumOptimizedDominatedAccesses,
+          "Number of optimized accesses dominated by an instrumented access");
 
 namespace {
 
@@ -806,6 +815,8 @@ private:
   void initializeCallbacks(Module &M, const TargetLibraryInfo *TLI);
 
   bool LooksLikeCodeInBug11395(Instruction *I);
+  void removeDominatedOperands(
+      Function &F, SmallVectorImpl<InterestingMemoryOperand> &Operands);
   bool GlobalIsLinkerInitialized(GlobalVariable *G);
   bool isSafeAccess(ObjectSizeOffsetVisitor &ObjSizeVis, Value *Addr,
                     TypeSize TypeStoreSize) const;
@@ -2984,6 +2995,9 @@ bool AddressSanitizer::instrumentFunction(Function &F,
   SmallVector<Instruction *, 8> NoReturnCalls;
   SmallVector<BasicBlock *, 16> AllBlocks;
   SmallVector<Instruction *, 16> PointerComparisonsOrSubtracts;
+  // Whether some instruction that may change the shadow memory between two
+  // accesses, or that we did not look at, exists in the function.
+  bool MayChangeShadow = false;
 
   // Fill the set of memory operations to instrument.
   for (auto &BB : F) {
@@ -3031,14 +3045,22 @@ bool AddressSanitizer::instrumentFunction(Function &F,
           TempsToInstrument.clear();
           if (CB->doesNotReturn())
             NoReturnCalls.push_back(CB);
+          if (!isa<DbgInfoIntrinsic>(CB))
+            MayChangeShadow = true;
         }
         if (CallInst *CI = dyn_cast<CallInst>(&Inst))
           maybeMarkSanitizerLibraryCallNoBuiltin(CI, TLI);
       }
-      if (NumInsnsPerBB >= ClMaxInsnsToInstrumentPerBB) break;
+      if (NumInsnsPerBB >= ClMaxInsnsToInstrumentPerBB) {
+        MayChangeShadow = true;
+        break;
+      }
     }
   }
 
+  if (ClOpt && ClOptDominating && !MayChangeShadow && !Recover)
+    removeDominatedOperands(F, OperandsToInstrument);
+
   bool UseCalls = (InstrumentationWithCallsThreshold >= 0 &&
                    OperandsToInstrument.size() + IntrinToInstrument.size() >
                        (unsigned)InstrumentationWithCallsThreshold);
@@ -3085,6 +3107,60 @@ bool AddressSanitizer::instrumentFunction(Function &F,
   return FunctionModified;
 }
 
+// Without calls nothing can poison memory after it has been checked, so an
+// access that is dominated by a checked access of at least the same size to
+// the same address can't fail once the first one succeeded. Since we don't
+// recover, the first access reports any error before the second one is
+// reached. This extends the same temp optimization above across blocks.
+void AddressSanitizer::removeDominatedOperands(
+    Function &F, SmallVectorImpl<InterestingMemoryOperand> &Operands) {
+  DenseMap<Value *, SmallVector<size_t, 2>> OperandsByPtr;
+  for (size_t I = 0, E = Operands.size(); I != E; ++I) {
+    InterestingMemoryOperand &Operand = Operands[I];
+    if (Operand.MaybeMask || Operand.MaybeEVL || Operand.MaybeStride ||
+        Operand.TypeStoreSize.isScalable())
+      continue;
+    OperandsByPtr[Operand.getPtr()].push_back(I);
+  }
+
+  DominatorTree DT;
+  bool DTComputed = false;
+  SmallVector<bool, 16> Redundant(Operands.size(), false);
+  for (auto &[Ptr, Indices] : OperandsByPtr) {
+    if (Indices.size() < 2)
+      continue;
+    if (!DTComputed) {
+      DT.recalculate(F);
+      DTComputed = true;
+    }
+    for (size_t I : Indices) {
+      InterestingMemoryOperand &Operand = Operands[I];
+      for (size_t J : Indices) {
+        // Only rely on operands that will be instrumented.
+        if (I == J || Redundant[J])
+          continue;
+        InterestingMemoryOperand &Dominating = Operands[J];
+        if (Dominating.TypeStoreSize.getFixedValue() <
+                Operand.TypeStoreSize.getFixedValue() ||
+            Dominating.getInsn() == Operand.getInsn() ||
+            !DT.dominates(Dominating.getInsn(), Operand.getInsn()))
+          continue;
+        Redundant[I] = true;
+        NumOptimizedDominatedAccesses++;
+        break;
+      }
+    }
+  }
+  if (!DTComputed)
+    return;
+
+  size_t Out = 0;
+  for (size_t I = 0, E = Operands.size(); I != E; ++I)
+    if (!Redundant[I])
+      Operands[Out++] = Operands[I];
+  Operands.truncate(Out);
+}
+
 // Workaround for bug 11395: we don't want to instrument stack in functions
 // with large assembly blobs (32-bit only), otherwise reg alloc may crash.
 // FIXME: remove once the bug 11395 is fixed.
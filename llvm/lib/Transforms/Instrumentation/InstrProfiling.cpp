@@ -38,6 +38,7 @@
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/InitializePasses.h"
@@ -48,6 +49,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/Instrumentation/PGOInstrumentation.h"
@@ -99,6 +101,13 @@ cl::opt<bool>
                              cl::desc("Enable relocating counters at runtime."),
                              cl::init(false));
 
+cl::opt<bool> ThreadLocalCounters(
+    "instrprof-thread-local-counters",
+    cl::desc("Address profile counters through a thread-local bias so that "
+             "every thread updates its own copy of the counters, which the "
+             "runtime adds up when the profile is written"),
+    cl::init(false));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -131,6 +140,24 @@ cl::opt<bool> AtomicFirstCounter(
              "the entry counter)"),
     cl::init(false));
 
+cl::opt<bool> SampledInstr(
+    "sampled-instrumentation",
+    cl::desc("Only perform the profile updates during a burst of every "
+             "sampling period, tracked by a thread-local countdown"),
+    cl::init(false));
+
+cl::opt<unsigned> SampledInstrPeriod(
+    "sampled-instr-period",
+    cl::desc("The number of profile updates in one sampling period "
+             "(default: 65536)"),
+    cl::init(65536));
+
+cl::opt<unsigned> SampledInstrBurstDuration(
+    "sampled-instr-burst-duration",
+    cl::desc("The number of consecutive profile updates performed at the "
+             "start of each sampling period (default: 200)"),
+    cl::init(200));
+
 // If the option is not specified, the default behavior about whether
 // counter promotion is done depends on how instrumentaiton lowering
 // pipeline is setup, i.e., the default value of true of this option
@@ -228,6 +255,9 @@ private:
   /// If runtime relocation is enabled, this maps functions to the load
   /// instruction that produces the profile relocation bias.
   DenseMap<const Function *, LoadInst *> FunctionToProfileBiasMap;
+  /// If thread-local counters are enabled, this maps functions to the load
+  /// instruction that produces the bias of the current thread's counters.
+  DenseMap<const Function *, LoadInst *> FunctionToThreadBiasMap;
   std::vector<GlobalValue *> CompilerUsedVars;
   std::vector<GlobalValue *> UsedVars;
   std::vector<GlobalVariable *> ReferencedNames;
@@ -252,6 +282,17 @@ private:
   /// Returns true if relocating counters at runtime is enabled.
   bool isRuntimeCounterRelocationEnabled() const;
 
+  /// Returns true if every thread updates its own copy of the counters.
+  bool isThreadLocalCountersEnabled() const;
+
+  /// Guard the profile update \p I so that it only executes during the burst
+  /// of each sampling period.
+  void doSampling(Instruction *I);
+
+  /// Make \p BiasLI, the load of the thread-local counter bias, call into the
+  /// runtime to set up the counters of the thread on first use.
+  void insertThreadCountersInit(LoadInst *BiasLI);
+
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
@@ -282,6 +323,9 @@ private:
   /// acts on.
   Value *getCounterAddress(InstrProfCntrInstBase *I);
 
+  /// Get the runtime counter relocation bias variable, defining it if needed.
+  GlobalVariable *getOrCreateCounterBiasVar();
+
   /// Get the region counters for an increment, creating them if necessary.
   ///
   /// If the counter array doesn't yet exist, the profile data variables
@@ -618,9 +662,68 @@ PreservedAnalyses InstrProfilingLoweringPass::run(Module &M,
   return PreservedAnalyses::none();
 }
 
+void InstrLowerer::doSampling(Instruction *I) {
+  // The sampling variable counts the profile updates of the current thread
+  // and wraps around at the end of each period:
+  //   if (__llvm_profile_sampling < BurstDuration)
+  //     <profile update>;
+  //   __llvm_profile_sampling = (__llvm_profile_sampling + 1) % Period;
+  // The variable is shared by every module linked together, so it always has
+  // the same type, whatever period each module was built with.
+  uint64_t Period = SampledInstrPeriod;
+  uint64_t Burst = SampledInstrBurstDuration;
+  LLVMContext &Ctx = M.getContext();
+  IntegerType *SamplingTy = Type::getInt32Ty(Ctx);
+  auto *SamplingVar =
+      M.getGlobalVariable(INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_SAMPLING_VAR));
+  if (!SamplingVar) {
+    SamplingVar = new GlobalVariable(
+        M, SamplingTy, false, GlobalValue::LinkOnceODRLinkage,
+        Constant::getNullValue(SamplingTy),
+        INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_SAMPLING_VAR), nullptr,
+        GlobalValue::GeneralDynamicTLSModel);
+    SamplingVar->setVisibility(GlobalVariable::HiddenVisibility);
+    if (TT.supportsCOMDAT())
+      SamplingVar->setComdat(M.getOrInsertComdat(SamplingVar->getName()));
+  }
+
+  IRBuilder<> Builder(I);
+  Value *Count = Builder.CreateLoad(SamplingTy, SamplingVar);
+  Value *InBurst =
+      Builder.CreateICmpULT(Count, ConstantInt::get(SamplingTy, Burst));
+  MDNode *Weights = MDBuilder(Ctx).createBranchWeights(Burst, Period - Burst);
+  Instruction *ThenTerm =
+      SplitBlockAndInsertIfThen(InBurst, I, /*Unreachable=*/false, Weights);
+  // I is now the first instruction of the continuation block.
+  Builder.SetInsertPoint(I);
+  Value *Next = Builder.CreateAdd(Count, ConstantInt::get(SamplingTy, 1));
+  if (isPowerOf2_64(Period)) {
+    Next = Builder.CreateAnd(Next, ConstantInt::get(SamplingTy, Period - 1));
+  } else {
+    Value *Wrap =
+        Builder.CreateICmpUGE(Next, ConstantInt::get(SamplingTy, Period));
+    Next = Builder.CreateSelect(Wrap, ConstantInt::get(SamplingTy, 0), Next);
+  }
+  Builder.CreateStore(Next, SamplingVar);
+  I->moveBefore(ThenTerm);
+}
+
 bool InstrLowerer::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
+
+  // Do this before lowering since it splits blocks.
+  if (SampledInstr) {
+    SmallVector<Instruction *> ToSample;
+    for (BasicBlock &BB : *F)
+      for (Instruction &I : BB)
+        if (isa<InstrProfCntrInstBase>(&I) ||
+            isa<InstrProfMCDCTVBitmapUpdate>(&I))
+          ToSample.push_back(&I);
+    for (Instruction *I : ToSample)
+      doSampling(I);
+  }
+
   for (BasicBlock &BB : *F) {
     for (Instruction &Instr : llvm::make_early_inc_range(BB)) {
       if (auto *IPIS = dyn_cast<InstrProfIncrementInstStep>(&Instr)) {
@@ -652,6 +755,9 @@ bool InstrLowerer::lowerIntrinsics(Function *F) {
     return false;
 
   promoteCounterLoadStores(F);
+  // This changes the CFG, so it has to come after the lowering loop above.
+  if (LoadInst *BiasLI = FunctionToThreadBiasMap.lookup(F))
+    insertThreadCountersInit(BiasLI);
   return true;
 }
 
@@ -667,6 +773,35 @@ bool InstrLowerer::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+bool InstrLowerer::isThreadLocalCountersEnabled() const {
+  return ThreadLocalCounters;
+}
+
+void InstrLowerer::insertThreadCountersInit(LoadInst *BiasLI) {
+  // A zero bias means the runtime has not set up the counters of the current
+  // thread yet; this happens once per thread.
+  Type *Int64Ty = BiasLI->getType();
+  IRBuilder<> Builder(BiasLI->getNextNode());
+  auto *NeedsInit =
+      cast<Instruction>(Builder.CreateICmpEQ(BiasLI, Builder.getInt64(0)));
+  Instruction *InitTerm = SplitBlockAndInsertIfThen(
+      NeedsInit, NeedsInit->getNextNode(), /*Unreachable=*/false,
+      MDBuilder(M.getContext()).createUnlikelyBranchWeights());
+  Builder.SetInsertPoint(InitTerm);
+  FunctionCallee InitFn = M.getOrInsertFunction(
+      getInstrProfInitThreadCountersFuncName(), Int64Ty);
+  CallInst *NewBias = Builder.CreateCall(InitFn);
+
+  BasicBlock *Tail = InitTerm->getSuccessor(0);
+  Builder.SetInsertPoint(Tail, Tail->begin());
+  PHINode *Bias = Builder.CreatePHI(Int64Ty, 2);
+  BiasLI->replaceUsesWithIf(Bias, [&](Use &U) {
+    return U.getUser() != NeedsInit && U.getUser() != Bias;
+  });
+  Bias->addIncoming(BiasLI, NeedsInit->getParent());
+  Bias->addIncoming(NewBias, InitTerm->getParent());
+}
+
 bool InstrLowerer::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -732,6 +867,11 @@ static bool containsProfilingIntrinsics(Module &M) {
 }
 
 bool InstrLowerer::lower() {
+  if (SampledInstr && (SampledInstrBurstDuration == 0 ||
+                       SampledInstrBurstDuration >= SampledInstrPeriod))
+    report_fatal_error("-sampled-instr-burst-duration must be positive and "
+                       "smaller than -sampled-instr-period");
+
   bool MadeChange = false;
   bool NeedsRuntimeHook = needsRuntimeHookUnconditionally(TT);
   if (NeedsRuntimeHook)
@@ -895,36 +1035,72 @@ Value *InstrLowerer::getCounterAddress(InstrProfCntrInstBase *I) {
   auto *Addr = Builder.CreateConstInBoundsGEP2_32(
       Counters->getValueType(), Counters, 0, I->getIndex()->getZExtValue());
 
-  if (!isRuntimeCounterRelocationEnabled())
+  // Timestamps are not accumulated, so they always live in the shared
+  // counters even when every thread has its own copy of the rest.
+  bool UseThreadBias =
+      isThreadLocalCountersEnabled() && !isa<InstrProfTimestampInst>(I);
+  if (!isRuntimeCounterRelocationEnabled() && !UseThreadBias)
     return Addr;
 
   Type *Int64Ty = Type::getInt64Ty(M.getContext());
   Function *Fn = I->getParent()->getParent();
+  if (UseThreadBias) {
+    // In continuous mode the runtime folds the thread counters into the
+    // relocated section, so the relocation bias must still be defined.
+    if (isRuntimeCounterRelocationEnabled())
+      getOrCreateCounterBiasVar();
+    LoadInst *&BiasLI = FunctionToThreadBiasMap[Fn];
+    if (!BiasLI) {
+      // The variable is defined by the runtime, which also initializes it
+      // through insertThreadCountersInit(). The load is placed after the
+      // allocas so that splitting the block there keeps them static.
+      auto *Bias = M.getGlobalVariable(getInstrProfThreadCounterBiasVarName());
+      if (!Bias) {
+        Bias = new GlobalVariable(
+            M, Int64Ty, false, GlobalValue::ExternalLinkage, nullptr,
+            getInstrProfThreadCounterBiasVarName(), nullptr,
+            GlobalValue::GeneralDynamicTLSModel);
+        Bias->setVisibility(GlobalVariable::HiddenVisibility);
+      }
+      BasicBlock &EntryBB = Fn->getEntryBlock();
+      IRBuilder<> EntryBuilder(&EntryBB, EntryBB.getFirstNonPHIOrDbgOrAlloca());
+      BiasLI = EntryBuilder.CreateLoad(Int64Ty, Bias);
+    }
+    auto *Add =
+        Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty), BiasLI);
+    return Builder.CreateIntToPtr(Add, Addr->getType());
+  }
+
   LoadInst *&BiasLI = FunctionToProfileBiasMap[Fn];
   if (!BiasLI) {
     IRBuilder<> EntryBuilder(&Fn->getEntryBlock().front());
-    auto *Bias = M.getGlobalVariable(getInstrProfCounterBiasVarName());
-    if (!Bias) {
-      // Compiler must define this variable when runtime counter relocation
-      // is being used. Runtime has a weak external reference that is used
-      // to check whether that's the case or not.
-      Bias = new GlobalVariable(
-          M, Int64Ty, false, GlobalValue::LinkOnceODRLinkage,
-          Constant::getNullValue(Int64Ty), getInstrProfCounterBiasVarName());
-      Bias->setVisibility(GlobalVariable::HiddenVisibility);
-      // A definition that's weak (linkonce_odr) without being in a COMDAT
-      // section wouldn't lead to link errors, but it would lead to a dead
-      // data word from every TU but one. Putting it in COMDAT ensures there
-      // will be exactly one data slot in the link.
-      if (TT.supportsCOMDAT())
-        Bias->setComdat(M.getOrInsertComdat(Bias->getName()));
-    }
-    BiasLI = EntryBuilder.CreateLoad(Int64Ty, Bias);
+    BiasLI = EntryBuilder.CreateLoad(Int64Ty, getOrCreateCounterBiasVar());
   }
   auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty), BiasLI);
   return Builder.CreateIntToPtr(Add, Addr->getType());
 }
 
+GlobalVariable *InstrLowerer::getOrCreateCounterBiasVar() {
+  auto *Bias = M.getGlobalVariable(getInstrProfCounterBiasVarName());
+  if (Bias)
+    return Bias;
+  // Compiler must define this variable when runtime counter relocation
+  // is being used. Runtime has a weak external reference that is used
+  // to check whether that's the case or not.
+  Type *Int64Ty = Type::getInt64Ty(M.getContext());
+  Bias = new GlobalVariable(M, Int64Ty, false, GlobalValue::LinkOnceODRLinkage,
+                            Constant::getNullValue(Int64Ty),
+                            getInstrProfCounterBiasVarName());
+  Bias->setVisibility(GlobalVariable::HiddenVisibility);
+  // A definition that's weak (linkonce_odr) without being in a COMDAT
+  // section wouldn't lead to link errors, but it would lead to a dead
+  // data word from every TU but one. Putting it in COMDAT ensures there
+  // will be exactly one data slot in the link.
+  if (TT.supportsCOMDAT())
+    Bias->setComdat(M.getOrInsertComdat(Bias->getName()));
+  return Bias;
+}
+
 Value *InstrLowerer::getBitmapAddress(InstrProfMCDCTVBitmapUpdate *I) {
   auto *Bitmaps = getOrCreateRegionBitmaps(I);
   IRBuilder<> Builder(I);
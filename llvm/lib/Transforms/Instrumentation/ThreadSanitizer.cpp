@@ -20,6 +20,7 @@
 
 #include "llvm/Transforms/Instrumentation/ThreadSanitizer.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
@@ -81,6 +82,16 @@ static cl::opt<bool> ClCompoundReadBeforeWrite(
     "tsan-compound-read-before-write", cl::init(false),
     cl::desc("Emit special compound instrumentation for reads-before-writes"),
     cl::Hidden);
+static cl::opt<bool> ClMergeAdjacentAccesses(
+    "tsan-merge-adjacent-accesses", cl::init(false),
+    cl::desc("Instrument adjacent accesses within a basic block with a single "
+             "range check"),
+    cl::Hidden);
+static cl::opt<unsigned> ClMergeMaxRangeSize(
+    "tsan-merge-max-range-size", cl::init(64),
+    cl::desc("Maximum size in bytes of a range check formed by merging "
+             "adjacent accesses"),
+    cl::Hidden);
 
 STATISTIC(NumInstrumentedReads, "Number of instrumented reads");
 STATISTIC(NumInstrumentedWrites, "Number of instrumented writes");
@@ -93,6 +104,7 @@ STATISTIC(NumOmittedReadsFromConstantGlobals,
           "Number of reads from constant globals");
 STATISTIC(NumOmittedReadsFromVtable, "Number of vtable reads");
 STATISTIC(NumOmittedNonCaptured, "Number of accesses ignored due to capturing");
+STATISTIC(NumMergedAccesses, "Number of accesses merged into range checks");
 
 const char kTsanModuleCtorName[] = "tsan.module_ctor";
 const char kTsanInitName[] = "__tsan_init";
@@ -124,11 +136,18 @@ private:
     // Instrumentation emitted for this instruction is for a compounded set of
     // read and write operations in the same basic block.
     static constexpr unsigned kCompoundRW = (1U << 0);
+    // Instrumentation emitted for this instruction is a single range check
+    // covering RangeSize bytes at RangeBase + RangeOffset, that replaces the
+    // instrumentation of several adjacent accesses.
+    static constexpr unsigned kRange = (1U << 1);
 
     explicit InstructionInfo(Instruction *Inst) : Inst(Inst) {}
 
     Instruction *Inst;
     unsigned Flags = 0;
+    Value *RangeBase = nullptr;
+    int64_t RangeOffset = 0;
+    uint64_t RangeSize = 0;
   };
 
   void initialize(Module &M, const TargetLibraryInfo &TLI);
@@ -138,6 +157,8 @@ private:
   void chooseInstructionsToInstrument(SmallVectorImpl<Instruction *> &Local,
                                       SmallVectorImpl<InstructionInfo> &All,
                                       const DataLayout &DL);
+  void mergeAdjacentAccesses(SmallVectorImpl<InstructionInfo> &All,
+                             size_t Begin, const DataLayout &DL);
   bool addrPointsToConstantData(Value *Addr);
   int getMemoryAccessFuncIndex(Type *OrigTy, Value *Addr, const DataLayout &DL);
   void InsertRuntimeIgnores(Function &F);
@@ -168,6 +189,8 @@ private:
   FunctionCallee TsanAtomicSignalFence;
   FunctionCallee TsanVptrUpdate;
   FunctionCallee TsanVptrLoad;
+  FunctionCallee TsanReadRange;
+  FunctionCallee TsanWriteRange;
   FunctionCallee MemmoveFn, MemcpyFn, MemsetFn;
 };
 
@@ -320,6 +343,14 @@ void ThreadSanitizer::initialize(Module &M, const TargetLibraryInfo &TLI) {
                             IRB.getPtrTy(), IRB.getPtrTy());
   TsanVptrLoad = M.getOrInsertFunction("__tsan_vptr_read", Attr,
                                        IRB.getVoidTy(), IRB.getPtrTy());
+  if (ClMergeAdjacentAccesses) {
+    TsanReadRange = M.getOrInsertFunction("__tsan_read_range", Attr,
+                                          IRB.getVoidTy(), IRB.getPtrTy(),
+                                          IntptrTy);
+    TsanWriteRange = M.getOrInsertFunction("__tsan_write_range", Attr,
+                                           IRB.getVoidTy(), IRB.getPtrTy(),
+                                           IntptrTy);
+  }
   TsanAtomicThreadFence = M.getOrInsertFunction(
       "__tsan_atomic_thread_fence",
       TLI.getAttrList(&Ctx, {0}, /*Signed=*/true, /*Ret=*/false, Attr),
@@ -413,6 +444,7 @@ void ThreadSanitizer::chooseInstructionsToInstrument(
     SmallVectorImpl<Instruction *> &Local,
     SmallVectorImpl<InstructionInfo> &All, const DataLayout &DL) {
   DenseMap<Value *, size_t> WriteTargets; // Map of addresses to index in All
+  const size_t Begin = All.size();
   // Iterate from the end.
   for (Instruction *I : reverse(Local)) {
     const bool IsWrite = isa<StoreInst>(*I);
@@ -464,6 +496,88 @@ void ThreadSanitizer::chooseInstructionsToInstrument(
     }
   }
   Local.clear();
+  if (ClMergeAdjacentAccesses)
+    mergeAdjacentAccesses(All, Begin, DL);
+}
+
+// Replaces the instrumentation of reads (or writes) of adjacent or
+// overlapping bytes, relative to the same base pointer, with a single range
+// check emitted before the first of them. The entries of All starting at
+// Begin are within the same basic block without calls in between, in reverse
+// program order.
+void ThreadSanitizer::mergeAdjacentAccesses(
+    SmallVectorImpl<InstructionInfo> &All, size_t Begin,
+    const DataLayout &DL) {
+  struct Candidate {
+    size_t Idx;
+    int64_t Offset;
+    uint64_t Size;
+  };
+  MapVector<std::pair<Value *, bool>, SmallVector<Candidate, 4>> Groups;
+  for (size_t I = Begin; I < All.size(); ++I) {
+    Instruction *Inst = All[I].Inst;
+    if (All[I].Flags || isVtableAccess(Inst))
+      continue;
+    const bool IsWrite = isa<StoreInst>(*Inst);
+    if (ClDistinguishVolatile && (IsWrite ? cast<StoreInst>(Inst)->isVolatile()
+                                          : cast<LoadInst>(Inst)->isVolatile()))
+      continue;
+    Value *Addr = getLoadStorePointerOperand(Inst);
+    if (Addr->isSwiftError())
+      continue;
+    const TypeSize Size = DL.getTypeStoreSize(getLoadStoreType(Inst));
+    if (Size.isScalable())
+      continue;
+    int64_t Offset = 0;
+    Value *Base = GetPointerBaseWithConstantOffset(Addr, Offset, DL);
+    Groups[{Base, IsWrite}].push_back({I, Offset, Size.getFixedValue()});
+  }
+
+  SmallVector<bool, 16> Merged(All.size() - Begin, false);
+  bool Changed = false;
+  for (auto &[Key, Candidates] : Groups) {
+    if (Candidates.size() < 2)
+      continue;
+    llvm::stable_sort(Candidates, [](const Candidate &A, const Candidate &B) {
+      return A.Offset < B.Offset;
+    });
+    for (size_t RunBegin = 0; RunBegin < Candidates.size();) {
+      const int64_t Lo = Candidates[RunBegin].Offset;
+      int64_t Hi = Lo + Candidates[RunBegin].Size;
+      size_t First = Candidates[RunBegin].Idx;
+      size_t RunEnd = RunBegin + 1;
+      for (; RunEnd < Candidates.size(); ++RunEnd) {
+        const Candidate &C = Candidates[RunEnd];
+        const int64_t End = std::max<int64_t>(Hi, C.Offset + C.Size);
+        if (C.Offset > Hi || uint64_t(End - Lo) > ClMergeMaxRangeSize)
+          break;
+        Hi = End;
+        // The highest index is the first access in program order.
+        First = std::max(First, C.Idx);
+      }
+      if (RunEnd - RunBegin >= 2) {
+        for (size_t I = RunBegin; I < RunEnd; ++I)
+          Merged[Candidates[I].Idx - Begin] = true;
+        InstructionInfo &Range = All[First];
+        Range.Flags |= InstructionInfo::kRange;
+        Range.RangeBase = Key.first;
+        Range.RangeOffset = Lo;
+        Range.RangeSize = Hi - Lo;
+        Merged[First - Begin] = false;
+        NumMergedAccesses += RunEnd - RunBegin;
+        Changed = true;
+      }
+      RunBegin = RunEnd;
+    }
+  }
+  if (!Changed)
+    return;
+
+  size_t Out = Begin;
+  for (size_t I = Begin; I < All.size(); ++I)
+    if (!Merged[I - Begin])
+      All[Out++] = All[I];
+  All.truncate(Out);
 }
 
 static bool isTsanAtomic(const Instruction *I) {
@@ -597,6 +711,18 @@ bool ThreadSanitizer::instrumentLoadOrStore(const InstructionInfo &II,
   if (Addr->isSwiftError())
     return false;
 
+  if (II.Flags & InstructionInfo::kRange) {
+    Value *RangeAddr = IRB.CreatePtrAdd(
+        II.RangeBase, ConstantInt::get(IntptrTy, II.RangeOffset));
+    IRB.CreateCall(IsWrite ? TsanWriteRange : TsanReadRange,
+                   {RangeAddr, ConstantInt::get(IntptrTy, II.RangeSize)});
+    if (IsWrite)
+      NumInstrumentedWrites++;
+    else
+      NumInstrumentedReads++;
+    return true;
+  }
+
   int Idx = getMemoryAccessFuncIndex(OrigTy, Addr, DL);
   if (Idx < 0)
     return false;
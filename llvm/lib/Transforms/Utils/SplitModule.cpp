@@ -26,10 +26,13 @@
 #include "llvm/IR/GlobalObject.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
+#include "llvm/Support/BranchProbability.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -54,6 +57,7 @@ namespace {
 using ClusterMapType = EquivalenceClasses<const GlobalValue *>;
 using ComdatMembersType = DenseMap<const Comdat *, const GlobalValue *>;
 using ClusterIDMapType = DenseMap<const GlobalValue *, unsigned>;
+using CostMapType = DenseMap<const GlobalValue *, uint64_t>;
 
 } // end anonymous namespace
 
@@ -96,12 +100,108 @@ static const GlobalObject *getGVPartitioningRoot(const GlobalValue *GV) {
   return GO;
 }
 
+// The hottest function in the module is treated as this many times more
+// expensive to code generate than its instruction count alone suggests; hot
+// code is never optimized for size and gets the full backend pipeline.
+static constexpr uint64_t HotCostScale = 3;
+
+// A call edge is kept within a single partition if its estimated execution
+// count is at least this fraction of the module's maximum entry count.
+static constexpr uint64_t HotEdgeDivisor = 100;
+
+static uint64_t getMaxEntryCount(const Module &M) {
+  uint64_t MaxCount = 0;
+  for (const Function &F : M)
+    if (auto Count = F.getEntryCount())
+      MaxCount = std::max(MaxCount, Count->getCount());
+  return MaxCount;
+}
+
+// Estimate the cost of code generating GV: its instruction count, scaled up by
+// its entry count relative to the hottest function in the module.
+static uint64_t getCodeGenCost(const GlobalValue &GV, uint64_t MaxCount) {
+  const auto *F = dyn_cast<Function>(&GV);
+  if (!F)
+    return 1;
+  uint64_t Cost = std::max<uint64_t>(F->getInstructionCount(), 1);
+  if (MaxCount)
+    if (auto Count = F->getEntryCount())
+      Cost += BranchProbability::getBranchProbability(
+                  std::min(Count->getCount(), MaxCount), MaxCount)
+                  .scale(Cost * HotCostScale);
+  return Cost;
+}
+
+// Merge the clusters of callers and callees connected by hot call edges, as
+// long as the merged cluster does not grow beyond an even share of the total
+// cost. Hotter edges are considered first so that they win the budget.
+static void clusterHotCallEdges(Module &M, ClusterMapType &GVtoClusterMap,
+                                CostMapType &ClusterCost, uint64_t MaxCount,
+                                uint64_t CostLimit) {
+  if (!MaxCount)
+    return;
+
+  struct CallEdge {
+    const Function *Caller;
+    const Function *Callee;
+    uint64_t Count;
+  };
+  SmallVector<CallEdge, 0> Edges;
+  uint64_t HotThreshold = std::max<uint64_t>(MaxCount / HotEdgeDivisor, 1);
+  for (const Function &F : M) {
+    auto CallerCount = F.getEntryCount();
+    if (F.isDeclaration() || !CallerCount ||
+        CallerCount->getCount() < HotThreshold)
+      continue;
+    for (const Instruction &I : instructions(F)) {
+      const auto *CB = dyn_cast<CallBase>(&I);
+      if (!CB)
+        continue;
+      const Function *Callee = CB->getCalledFunction();
+      if (!Callee || Callee == &F || Callee->isDeclaration())
+        continue;
+      auto CalleeCount = Callee->getEntryCount();
+      if (!CalleeCount)
+        continue;
+      // Without block frequencies, the smaller of the two entry counts is an
+      // upper bound on the number of times the edge is taken.
+      uint64_t Count =
+          std::min(CallerCount->getCount(), CalleeCount->getCount());
+      if (Count >= HotThreshold)
+        Edges.push_back({&F, Callee, Count});
+    }
+  }
+
+  llvm::stable_sort(Edges, [](const CallEdge &A, const CallEdge &B) {
+    return A.Count > B.Count;
+  });
+
+  for (const CallEdge &E : Edges) {
+    const GlobalValue *L1 = GVtoClusterMap.getLeaderValue(E.Caller);
+    const GlobalValue *L2 = GVtoClusterMap.getLeaderValue(E.Callee);
+    if (L1 == L2)
+      continue;
+    uint64_t Cost = ClusterCost[L1] + ClusterCost[L2];
+    if (Cost > CostLimit)
+      continue;
+    LLVM_DEBUG(dbgs() << "Hot edge " << E.Caller->getName() << " -> "
+                      << E.Callee->getName() << " (" << E.Count << ")\n");
+    const GlobalValue *Leader = *GVtoClusterMap.unionSets(L1, L2);
+    ClusterCost.erase(L1);
+    ClusterCost.erase(L2);
+    ClusterCost[Leader] = Cost;
+  }
+}
+
 // Find partitions for module in the way that no locals need to be
 // globalized.
 // Try to balance pack those partitions into N files since this roughly equals
-// thread balancing for the backend codegen step.
+// thread balancing for the backend codegen step. If BalanceByCost is set,
+// every definition is assigned here, clusters are weighted by their estimated
+// codegen cost rather than by their number of members, and hot call chains are
+// kept together.
 static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
-                           unsigned N) {
+                           unsigned N, bool BalanceByCost) {
   // At this point module should have the proper mix of globals and locals.
   // As we attempt to partition this module, we must not change any
   // locals to globals.
@@ -109,13 +209,19 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   ClusterMapType GVtoClusterMap;
   ComdatMembersType ComdatMembers;
 
-  auto recordGVSet = [&GVtoClusterMap, &ComdatMembers](GlobalValue &GV) {
+  auto recordGVSet = [&GVtoClusterMap, &ComdatMembers,
+                      BalanceByCost](GlobalValue &GV) {
     if (GV.isDeclaration())
       return;
 
     if (!GV.hasName())
       GV.setName("__llvmsplit_unnamed");
 
+    // In cost-balanced mode nothing is left to the MD5-based partitioning, so
+    // every definition needs a cluster of its own to start with.
+    if (BalanceByCost)
+      GVtoClusterMap.insert(&GV);
+
     // Comdat groups must not be partitioned. For comdat groups that contain
     // locals, record all their members here so we can keep them together.
     // Comdat groups that only contain external globals are already handled by
@@ -150,26 +256,49 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M.functions(), recordGVSet);
   llvm::for_each(M.globals(), recordGVSet);
   llvm::for_each(M.aliases(), recordGVSet);
+  // Keep ifuncs with their resolvers, which would otherwise be separated by
+  // the MD5-based fallback once the resolver is placed explicitly.
+  if (BalanceByCost)
+    llvm::for_each(M.ifuncs(), recordGVSet);
+
+  CostMapType ClusterCost;
+  if (BalanceByCost) {
+    uint64_t MaxCount = getMaxEntryCount(M);
+    uint64_t TotalCost = 0;
+    for (ClusterMapType::iterator I = GVtoClusterMap.begin(),
+                                  E = GVtoClusterMap.end();
+         I != E; ++I) {
+      if (!I->isLeader())
+        continue;
+      uint64_t &Cost = ClusterCost[I->getData()];
+      for (ClusterMapType::member_iterator MI = GVtoClusterMap.member_begin(I);
+           MI != GVtoClusterMap.member_end(); ++MI)
+        Cost += getCodeGenCost(**MI, MaxCount);
+      TotalCost += Cost;
+    }
+    clusterHotCallEdges(M, GVtoClusterMap, ClusterCost, MaxCount,
+                        TotalCost / N);
+  }
 
-  // Assigned all GVs to merged clusters while balancing number of objects in
-  // each.
-  auto CompareClusters = [](const std::pair<unsigned, unsigned> &a,
-                            const std::pair<unsigned, unsigned> &b) {
+  // Assigned all GVs to merged clusters while balancing number of objects (or
+  // estimated cost) in each.
+  auto CompareClusters = [](const std::pair<unsigned, uint64_t> &a,
+                            const std::pair<unsigned, uint64_t> &b) {
     if (a.second || b.second)
       return a.second > b.second;
     else
       return a.first > b.first;
   };
 
-  std::priority_queue<std::pair<unsigned, unsigned>,
-                      std::vector<std::pair<unsigned, unsigned>>,
+  std::priority_queue<std::pair<unsigned, uint64_t>,
+                      std::vector<std::pair<unsigned, uint64_t>>,
                       decltype(CompareClusters)>
       BalancinQueue(CompareClusters);
   // Pre-populate priority queue with N slot blanks.
   for (unsigned i = 0; i < N; ++i)
     BalancinQueue.push(std::make_pair(i, 0));
 
-  using SortType = std::pair<unsigned, ClusterMapType::iterator>;
+  using SortType = std::pair<uint64_t, ClusterMapType::iterator>;
 
   SmallVector<SortType, 64> Sets;
   SmallPtrSet<const GlobalValue *, 32> Visited;
@@ -179,9 +308,11 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
   for (ClusterMapType::iterator I = GVtoClusterMap.begin(),
                                 E = GVtoClusterMap.end(); I != E; ++I)
     if (I->isLeader())
-      Sets.push_back(
-          std::make_pair(std::distance(GVtoClusterMap.member_begin(I),
-                                       GVtoClusterMap.member_end()), I));
+      Sets.push_back(std::make_pair(
+          BalanceByCost ? ClusterCost.lookup(I->getData())
+                        : std::distance(GVtoClusterMap.member_begin(I),
+                                        GVtoClusterMap.member_end()),
+          I));
 
   llvm::sort(Sets, [](const SortType &a, const SortType &b) {
     if (a.first == b.first)
@@ -192,7 +323,7 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
 
   for (auto &I : Sets) {
     unsigned CurrentClusterID = BalancinQueue.top().first;
-    unsigned CurrentClusterSize = BalancinQueue.top().second;
+    uint64_t CurrentClusterSize = BalancinQueue.top().second;
     BalancinQueue.pop();
 
     LLVM_DEBUG(dbgs() << "Root[" << CurrentClusterID << "] cluster_size("
@@ -208,8 +339,11 @@ static void findPartitions(Module &M, ClusterIDMapType &ClusterIDMap,
                         << ((*MI)->hasLocalLinkage() ? " l " : " e ") << "\n");
       Visited.insert(*MI);
       ClusterIDMap[*MI] = CurrentClusterID;
-      CurrentClusterSize++;
+      if (!BalanceByCost)
+        CurrentClusterSize++;
     }
+    if (BalanceByCost)
+      CurrentClusterSize += I.first;
     // Add this set size to the number of entries in this cluster.
     BalancinQueue.push(std::make_pair(CurrentClusterID, CurrentClusterSize));
   }
@@ -251,7 +385,7 @@ static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
 void llvm::SplitModule(
     Module &M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals) {
+    bool PreserveLocals, bool BalanceByCost) {
   if (!PreserveLocals) {
     for (Function &F : M)
       externalize(&F);
@@ -266,7 +400,7 @@ void llvm::SplitModule(
   // This performs splitting without a need for externalization, which might not
   // always be possible.
   ClusterIDMapType ClusterIDMap;
-  findPartitions(M, ClusterIDMap, N);
+  findPartitions(M, ClusterIDMap, N, BalanceByCost);
 
   // FIXME: We should be able to reuse M as the last partition instead of
   // cloning it. Note that the callers at the moment expect the module to
@@ -2040,21 +2040,30 @@ public:
         // variant.
         const SCEV *Cond = SE->getSCEV(MemRuntimeCheckCond);
         if (SE->isLoopInvariant(Cond, OuterLoop)) {
-          // It seems reasonable to assume that we can reduce the effective
-          // cost of the checks even when we know nothing about the trip
-          // count. Assume that the outer loop executes at least twice.
-          unsigned BestTripCount = 2;
-
-          // If exact trip count is known use that.
-          if (unsigned SmallTC = SE->getSmallConstantTripCount(OuterLoop))
-            BestTripCount = SmallTC;
-          else if (LoopVectorizeWithBlockFrequency) {
-            // Else use profile data if available.
-            if (auto EstimatedTC = getLoopEstimatedTripCount(OuterLoop))
-              BestTripCount = *EstimatedTC;
-          }
+          // LICM hoists the checks out of every enclosing loop they are
+          // invariant in, so spread their cost over the combined trip count
+          // of all of those loops, not just the immediately enclosing one.
+          unsigned BestTripCount = 1;
+          for (Loop *Outer = OuterLoop;
+               Outer && SE->isLoopInvariant(Cond, Outer);
+               Outer = Outer->getParentLoop()) {
+            // It seems reasonable to assume that we can reduce the effective
+            // cost of the checks even when we know nothing about the trip
+            // count. Assume that the outer loop executes at least twice.
+            unsigned OuterTripCount = 2;
+
+            // If exact trip count is known use that.
+            if (unsigned SmallTC = SE->getSmallConstantTripCount(Outer))
+              OuterTripCount = SmallTC;
+            else if (LoopVectorizeWithBlockFrequency) {
+              // Else use profile data if available.
+              if (auto EstimatedTC = getLoopEstimatedTripCount(Outer))
+                OuterTripCount = *EstimatedTC;
+            }
 
-          BestTripCount = std::max(BestTripCount, 1U);
+            BestTripCount = SaturatingMultiply(BestTripCount,
+                                               std::max(OuterTripCount, 1U));
+          }
           InstructionCost NewMemCheckCost = MemCheckCost / BestTripCount;
 
           // Let's ensure the cost is always at least 1.
@@ -7180,6 +7189,23 @@ LoopVectorizationPlanner::planInVPlanNativePath(ElementCount UserVF) {
                           << "overriding computed VF.\n");
         VF = ElementCount::getFixed(4);
       }
+
+      // The VF above only depends on the register width. Don't let it exceed
+      // the expected trip count of the outer loop, or the vector loop would
+      // never be entered and only the scalar epilogue would run.
+      std::optional<unsigned> ExpectedTC =
+          getSmallBestKnownTC(*PSE.getSE(), OrigLoop);
+      if (!VPlanBuildStressTest && ExpectedTC &&
+          *ExpectedTC < VF.getKnownMinValue()) {
+        if (*ExpectedTC < 2) {
+          LLVM_DEBUG(dbgs() << "LV: Not vectorizing. Outer loop trip count "
+                            << *ExpectedTC << " is too small.\n");
+          return VectorizationFactor::Disabled();
+        }
+        VF = ElementCount::get(llvm::bit_floor(*ExpectedTC), VF.isScalable());
+        LLVM_DEBUG(dbgs() << "LV: VF clamped to " << VF
+                          << " by the outer loop trip count.\n");
+      }
     } else if (UserVF.isScalable() && !TTI.supportsScalableVectors() &&
                !ForceTargetSupportsScalableVectors) {
       LLVM_DEBUG(dbgs() << "LV: Not vectorizing. Scalable VF requested, but "
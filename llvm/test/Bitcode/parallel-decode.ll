@@ -0,0 +1,88 @@
+; Test that decoding function blocks in parallel with -bitcode-parallel-decode
+; produces the same module as the serial reader, including function-local
+; constants, metadata, value symbol tables and use-list orders.
+
+; RUN: llvm-as -preserve-bc-uselistorder %s -o %t.bc
+; RUN: llvm-dis -preserve-ll-uselistorder %t.bc -o %t.serial.ll
+; RUN: llvm-dis -preserve-ll-uselistorder -bitcode-parallel-decode %t.bc \
+; RUN:   -o %t.parallel.ll
+; RUN: diff %t.serial.ll %t.parallel.ll
+; RUN: FileCheck %s < %t.parallel.ll
+
+; CHECK: define i32 @sum(ptr %p, i32 %n)
+; CHECK: define internal float @select
+; CHECK: define void @switch
+; CHECK: define i64 @uses
+
+@g = global [4 x i32] [i32 1, i32 2, i32 3, i32 4]
+
+define i32 @sum(ptr %p, i32 %n) !dbg !6 {
+entry:
+  %cmp = icmp sgt i32 %n, 0, !dbg !9
+  br i1 %cmp, label %loop, label %exit
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %acc = phi i32 [ 0, %entry ], [ %acc.next, %loop ]
+  %gep = getelementptr inbounds i32, ptr %p, i32 %i
+  %v = load i32, ptr %gep, align 4, !tbaa !10
+  %acc.next = add nsw i32 %acc, %v
+  %i.next = add nuw nsw i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop, !prof !14
+
+exit:
+  %r = phi i32 [ 0, %entry ], [ %acc.next, %loop ]
+  ret i32 %r
+}
+
+define internal float @select(i1 %c, float %a) {
+  %x = fmul fast float %a, 3.500000e+00
+  %y = fadd float %x, 0x3FB99999A0000000
+  %s = select i1 %c, float %x, float %y
+  ret float %s
+}
+
+define void @switch(i32 %x, ptr %out) {
+  switch i32 %x, label %default [
+    i32 0, label %zero
+    i32 7, label %seven
+  ]
+
+zero:
+  store i32 ptrtoint (ptr @g to i32), ptr %out
+  br label %default
+
+seven:
+  %e = extractvalue { i32, i64 } { i32 5, i64 6 }, 1
+  store i64 %e, ptr %out
+  br label %default
+
+default:
+  ret void
+}
+
+define i64 @uses(i64 %a, i64 %b) {
+  %m = mul i64 %a, %b
+  %u1 = add i64 %m, 1
+  %u2 = add i64 %m, 2
+  %u3 = add i64 %u1, %u2
+  ret i64 %u3
+}
+
+!llvm.dbg.cu = !{!0}
+!llvm.module.flags = !{!3, !4}
+
+!0 = distinct !DICompileUnit(language: DW_LANG_C99, file: !1, producer: "clang", isOptimized: true, runtimeVersion: 0, emissionKind: FullDebug, enums: !2)
+!1 = !DIFile(filename: "sum.c", directory: "/tmp")
+!2 = !{}
+!3 = !{i32 2, !"Debug Info Version", i32 3}
+!4 = !{i32 7, !"Dwarf Version", i32 5}
+!5 = !DISubroutineType(types: !2)
+!6 = distinct !DISubprogram(name: "sum", scope: !1, file: !1, line: 1, type: !5, scopeLine: 1, spFlags: DISPFlagDefinition | DISPFlagOptimized, unit: !0, retainedNodes: !2)
+!9 = !DILocation(line: 2, column: 3, scope: !6)
+!10 = !{!11, !11, i64 0}
+!11 = !{!"int", !12, i64 0}
+!12 = !{!"omnipotent char", !13, i64 0}
+!13 = !{!"Simple C/C++ TBAA"}
+!14 = !{!"branch_weights", i32 1, i32 99}
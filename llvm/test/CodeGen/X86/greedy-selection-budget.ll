@@ -0,0 +1,69 @@
+; RUN: llc -mtriple=x86_64-unknown-linux-gnu -verify-machineinstrs \
+; RUN:   -greedy-selection-budget=4 -pass-remarks-missed=regalloc \
+; RUN:   -o /dev/null < %s 2>&1 | FileCheck %s
+; RUN: llc -mtriple=x86_64-unknown-linux-gnu -verify-machineinstrs \
+; RUN:   -pass-remarks-missed=regalloc -o /dev/null < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=UNLIMITED --allow-empty
+
+;; Sixteen values live across a call need far more than four selections.
+;; Once the budget is used up the allocator spills the remaining ranges
+;; instead of evicting or splitting, and the result must still verify.
+
+; CHECK:          remark: {{.*}} selection budget of 4 exhausted; spilling the remaining live ranges instead of evicting or splitting
+; CHECK-NOT:      selection budget
+
+; UNLIMITED-NOT:  selection budget
+
+define i32 @pressure(ptr %p) {
+  %p0 = getelementptr inbounds i32, ptr %p, i64 0
+  %v0 = load volatile i32, ptr %p0, align 4
+  %p1 = getelementptr inbounds i32, ptr %p, i64 1
+  %v1 = load volatile i32, ptr %p1, align 4
+  %p2 = getelementptr inbounds i32, ptr %p, i64 2
+  %v2 = load volatile i32, ptr %p2, align 4
+  %p3 = getelementptr inbounds i32, ptr %p, i64 3
+  %v3 = load volatile i32, ptr %p3, align 4
+  %p4 = getelementptr inbounds i32, ptr %p, i64 4
+  %v4 = load volatile i32, ptr %p4, align 4
+  %p5 = getelementptr inbounds i32, ptr %p, i64 5
+  %v5 = load volatile i32, ptr %p5, align 4
+  %p6 = getelementptr inbounds i32, ptr %p, i64 6
+  %v6 = load volatile i32, ptr %p6, align 4
+  %p7 = getelementptr inbounds i32, ptr %p, i64 7
+  %v7 = load volatile i32, ptr %p7, align 4
+  %p8 = getelementptr inbounds i32, ptr %p, i64 8
+  %v8 = load volatile i32, ptr %p8, align 4
+  %p9 = getelementptr inbounds i32, ptr %p, i64 9
+  %v9 = load volatile i32, ptr %p9, align 4
+  %p10 = getelementptr inbounds i32, ptr %p, i64 10
+  %v10 = load volatile i32, ptr %p10, align 4
+  %p11 = getelementptr inbounds i32, ptr %p, i64 11
+  %v11 = load volatile i32, ptr %p11, align 4
+  %p12 = getelementptr inbounds i32, ptr %p, i64 12
+  %v12 = load volatile i32, ptr %p12, align 4
+  %p13 = getelementptr inbounds i32, ptr %p, i64 13
+  %v13 = load volatile i32, ptr %p13, align 4
+  %p14 = getelementptr inbounds i32, ptr %p, i64 14
+  %v14 = load volatile i32, ptr %p14, align 4
+  %p15 = getelementptr inbounds i32, ptr %p, i64 15
+  %v15 = load volatile i32, ptr %p15, align 4
+  call void @clobber()
+  %s1 = add i32 %v0, %v1
+  %s2 = add i32 %s1, %v2
+  %s3 = add i32 %s2, %v3
+  %s4 = add i32 %s3, %v4
+  %s5 = add i32 %s4, %v5
+  %s6 = add i32 %s5, %v6
+  %s7 = add i32 %s6, %v7
+  %s8 = add i32 %s7, %v8
+  %s9 = add i32 %s8, %v9
+  %s10 = add i32 %s9, %v10
+  %s11 = add i32 %s10, %v11
+  %s12 = add i32 %s11, %v12
+  %s13 = add i32 %s12, %v13
+  %s14 = add i32 %s13, %v14
+  %s15 = add i32 %s14, %v15
+  ret i32 %s15
+}
+
+declare void @clobber()
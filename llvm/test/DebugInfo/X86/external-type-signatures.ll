@@ -0,0 +1,58 @@
+; RUN: rm -rf %t && split-file %s %t && cd %t
+; RUN: llc -mtriple=x86_64-unknown-linux-gnu -filetype=obj \
+; RUN:   -dwarf-external-type-signatures=sigs.txt -o out.o input.ll
+; RUN: llvm-dwarfdump --debug-info out.o | FileCheck %s
+; RUN: not llc -mtriple=x86_64-unknown-linux-gnu -filetype=obj \
+; RUN:   -dwarf-external-type-signatures=bad.txt -o /dev/null input.ll 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=BAD
+
+;; sigs.txt lists the signature of _ZTS3Foo, the MD5-based value type units
+;; use for it. Foo is emitted as a declaration only. Bar is not listed and is
+;; still emitted in full.
+
+; CHECK:      DW_TAG_structure_type
+; CHECK-NEXT:   DW_AT_name ("Foo")
+; CHECK-NEXT:   DW_AT_declaration (true)
+; CHECK-NOT:  DW_TAG_member
+; CHECK:      DW_TAG_structure_type
+; CHECK-NEXT:   DW_AT_name ("Bar")
+; CHECK:        DW_TAG_member
+; CHECK-NEXT:     DW_AT_name ("b")
+
+; BAD: invalid type signature 'not-a-number' in 'bad.txt'
+
+;--- sigs.txt
+# Types defined in full by another unit.
+
+675d23e4f33235f2
+
+;--- bad.txt
+675d23e4f33235f2
+not-a-number
+
+;--- input.ll
+%struct.Foo = type { i32 }
+%struct.Bar = type { i32 }
+
+@foo = global %struct.Foo zeroinitializer, align 4, !dbg !0
+@bar = global %struct.Bar zeroinitializer, align 4, !dbg !5
+
+!llvm.dbg.cu = !{!2}
+!llvm.module.flags = !{!13, !14}
+
+!0 = !DIGlobalVariableExpression(var: !1, expr: !DIExpression())
+!1 = distinct !DIGlobalVariable(name: "foo", scope: !2, file: !3, line: 1, type: !7, isLocal: false, isDefinition: true)
+!2 = distinct !DICompileUnit(language: DW_LANG_C_plus_plus_14, file: !3, producer: "clang", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, globals: !4)
+!3 = !DIFile(filename: "t.cpp", directory: "/tmp")
+!4 = !{!0, !5}
+!5 = !DIGlobalVariableExpression(var: !6, expr: !DIExpression())
+!6 = distinct !DIGlobalVariable(name: "bar", scope: !2, file: !3, line: 2, type: !10, isLocal: false, isDefinition: true)
+!7 = distinct !DICompositeType(tag: DW_TAG_structure_type, name: "Foo", file: !3, line: 1, size: 32, flags: DIFlagTypePassByValue, elements: !8, identifier: "_ZTS3Foo")
+!8 = !{!9}
+!9 = !DIDerivedType(tag: DW_TAG_member, name: "a", scope: !7, file: !3, line: 1, baseType: !12, size: 32)
+!10 = distinct !DICompositeType(tag: DW_TAG_structure_type, name: "Bar", file: !3, line: 2, size: 32, flags: DIFlagTypePassByValue, elements: !11, identifier: "_ZTS3Bar")
+!11 = !{!15}
+!12 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!13 = !{i32 7, !"Dwarf Version", i32 5}
+!14 = !{i32 2, !"Debug Info Version", i32 3}
+!15 = !DIDerivedType(tag: DW_TAG_member, name: "b", scope: !10, file: !3, line: 2, baseType: !12, size: 32)
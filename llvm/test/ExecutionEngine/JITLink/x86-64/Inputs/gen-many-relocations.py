@@ -0,0 +1,32 @@
+# Emit an x86-64 ELF assembly file with 20000 absolute and 2000 PC-relative
+# relocations spread over many blocks, with jitlink-check lines verifying a
+# sample of them.
+N = 2000
+M = 10
+
+print('.text')
+print('.globl main')
+print('.type main,@function')
+print('main:')
+print('  xorl %eax, %eax')
+print('  retq')
+
+for i in range(N):
+    print(f'.section .text.f{i},"ax",@progbits')
+    print(f'.globl f{i}')
+    print(f'.type f{i},@function')
+    print(f'f{i}:')
+    print(f'  leaq p{i}(%rip), %rax')
+    print('  retq')
+
+for i in range(N):
+    print(f'.section .data.p{i},"aw",@progbits')
+    print(f'.globl p{i}')
+    print('.p2align 3')
+    print(f'p{i}:')
+    for j in range(M):
+        print(f'  .quad f{(i + j) % N} + {j}')
+    if i % 97 == 0:
+        for j in range(M):
+            print(f'# jitlink-check: *{{8}}(p{i} + {8 * j}) = f{(i + j) % N} + {j}')
+        print(f'# jitlink-check: decode_operand(f{i}, 4) = p{i} - next_pc(f{i})')
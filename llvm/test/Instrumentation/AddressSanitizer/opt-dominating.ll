@@ -0,0 +1,92 @@
+; Test that -asan-opt-dominating skips checks dominated by a check of the
+; same address, and only in functions without calls.
+; RUN: opt < %s -passes=asan -asan-instrumentation-with-call-threshold=0 \
+; RUN:   -asan-opt-dominating -S | FileCheck %s --check-prefixes=CHECK,OPT
+; RUN: opt < %s -passes=asan -asan-instrumentation-with-call-threshold=0 \
+; RUN:   -S | FileCheck %s --check-prefixes=CHECK,NOOPT
+; RUN: opt < %s -passes=asan -asan-instrumentation-with-call-threshold=0 \
+; RUN:   -asan-opt-dominating -asan-recover -S \
+; RUN:   | FileCheck %s --check-prefix=RECOVER
+
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-i128:128-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @f()
+
+define void @dominated(ptr %p, i1 %c) sanitize_address {
+; CHECK-LABEL: @dominated(
+; CHECK: call void @__asan_load4(
+; CHECK: then:
+; OPT-NOT: call void @__asan_store4(
+; NOOPT: call void @__asan_store4(
+; CHECK: ret void
+; RECOVER-LABEL: @dominated(
+; RECOVER: call void @__asan_load4_noabort(
+; RECOVER: call void @__asan_store4_noabort(
+entry:
+  %a = load i32, ptr %p, align 4
+  br i1 %c, label %then, label %exit
+
+then:
+  store i32 %a, ptr %p, align 4
+  br label %exit
+
+exit:
+  ret void
+}
+
+; A narrower check does not cover a wider access.
+define void @wider(ptr %p, i1 %c) sanitize_address {
+; CHECK-LABEL: @wider(
+; CHECK: call void @__asan_load1(
+; CHECK: then:
+; CHECK: call void @__asan_store4(
+entry:
+  %a = load i8, ptr %p, align 1
+  br i1 %c, label %then, label %exit
+
+then:
+  store i32 0, ptr %p, align 4
+  br label %exit
+
+exit:
+  ret void
+}
+
+; An access on one side of a branch does not dominate the join.
+define void @not_dominated(ptr %p, i1 %c) sanitize_address {
+; CHECK-LABEL: @not_dominated(
+; CHECK: then:
+; CHECK: call void @__asan_store4(
+; CHECK: exit:
+; CHECK: call void @__asan_load4(
+entry:
+  br i1 %c, label %then, label %exit
+
+then:
+  store i32 0, ptr %p, align 4
+  br label %exit
+
+exit:
+  %a = load i32, ptr %p, align 4
+  ret void
+}
+
+; A call may poison the memory again.
+define void @with_call(ptr %p, i1 %c) sanitize_address {
+; CHECK-LABEL: @with_call(
+; CHECK: call void @__asan_load4(
+; CHECK: then:
+; CHECK: call void @__asan_store4(
+entry:
+  %a = load i32, ptr %p, align 4
+  br i1 %c, label %then, label %exit
+
+then:
+  call void @f()
+  store i32 %a, ptr %p, align 4
+  br label %exit
+
+exit:
+  ret void
+}
@@ -0,0 +1,65 @@
+;; With -instrprof-thread-local-counters, counters are addressed through the
+;; thread-local bias, which is loaded once per function after the allocas and
+;; set up by the runtime when it is still zero.
+; RUN: opt < %s -passes=instrprof -instrprof-thread-local-counters -S \
+; RUN:   | FileCheck %s
+
+target triple = "x86_64-unknown-linux-gnu"
+
+@__profn_foo = private constant [3 x i8] c"foo"
+
+; CHECK: @__llvm_profile_thread_counter_bias = external hidden thread_local global i64
+
+define void @foo(i1 %c) {
+; CHECK-LABEL: define void @foo(
+; CHECK-NEXT:  entry:
+; CHECK-NEXT:    %a = alloca i32
+; CHECK-NEXT:    [[BIAS:%.*]] = load i64, ptr @__llvm_profile_thread_counter_bias
+; CHECK-NEXT:    [[ISZERO:%.*]] = icmp eq i64 [[BIAS]], 0
+; CHECK-NEXT:    br i1 [[ISZERO]], label %[[INIT:[^ ,]+]], label %[[TAIL:[^ ,]+]], !prof
+; CHECK:       [[INIT]]:
+; CHECK-NEXT:    [[NEWBIAS:%.*]] = call i64 @__llvm_profile_init_thread_counters()
+; CHECK-NEXT:    br label %[[TAIL]]
+; CHECK:       [[TAIL]]:
+; CHECK-NEXT:    [[PHI:%.*]] = phi i64 [ [[BIAS]], %entry ], [ [[NEWBIAS]], %[[INIT]] ]
+; CHECK-NEXT:    [[ADD:%.*]] = add i64 ptrtoint (ptr @__profc_foo to i64), [[PHI]]
+; CHECK-NEXT:    [[ADDR:%.*]] = inttoptr i64 [[ADD]] to ptr
+; CHECK-NEXT:    [[COUNT:%.*]] = load i64, ptr [[ADDR]]
+; CHECK-NEXT:    [[INC:%.*]] = add i64 [[COUNT]], 1
+; CHECK-NEXT:    store i64 [[INC]], ptr [[ADDR]]
+; CHECK-NEXT:    br i1 %c, label %then, label %exit
+; CHECK:       then:
+; CHECK-NEXT:    [[ADD1:%.*]] = add i64 ptrtoint (ptr getelementptr inbounds ({{.*}}@__profc_foo, {{.*}}) to i64), [[PHI]]
+; CHECK-NEXT:    [[ADDR1:%.*]] = inttoptr i64 [[ADD1]] to ptr
+; CHECK-NEXT:    [[COUNT1:%.*]] = load i64, ptr [[ADDR1]]
+; CHECK-NEXT:    [[INC1:%.*]] = add i64 [[COUNT1]], 1
+; CHECK-NEXT:    store i64 [[INC1]], ptr [[ADDR1]]
+; CHECK-NEXT:    br label %exit
+entry:
+  %a = alloca i32
+  call void @llvm.instrprof.increment(ptr @__profn_foo, i64 0, i32 2, i32 0)
+  br i1 %c, label %then, label %exit
+
+then:
+  call void @llvm.instrprof.increment(ptr @__profn_foo, i64 0, i32 2, i32 1)
+  br label %exit
+
+exit:
+  ret void
+}
+
+;; Timestamps are not accumulated and stay in the shared counters.
+@__profn_bar = private constant [3 x i8] c"bar"
+
+define void @bar() {
+; CHECK-LABEL: define void @bar(
+; CHECK-NEXT:  entry:
+; CHECK-NEXT:    call void @__llvm_profile_set_timestamp(ptr @__profc_bar)
+; CHECK-NEXT:    ret void
+entry:
+  call void @llvm.instrprof.timestamp(ptr @__profn_bar, i64 0, i32 1, i32 0)
+  ret void
+}
+
+declare void @llvm.instrprof.increment(ptr, i64, i32, i32)
+declare void @llvm.instrprof.timestamp(ptr, i64, i32, i32)
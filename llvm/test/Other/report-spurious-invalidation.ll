@@ -0,0 +1,24 @@
+; RUN: opt -disable-output -report-spurious-invalidation \
+; RUN:   -passes='function(invalidate<all>,instcombine)' %s 2>&1 \
+; RUN:   | FileCheck %s
+; RUN: opt -disable-output -passes='function(invalidate<all>,instcombine)' \
+; RUN:   %s 2>&1 | FileCheck %s --check-prefix=DISABLED --allow-empty
+
+; invalidate<all> never changes the function but invalidates everything, so
+; it is reported for both functions. instcombine folds the add in @changed
+; and preserves everything in @unchanged, so it is never reported.
+
+; CHECK:     Spurious invalidation: InvalidateAllAnalysesPass invalidated analyses of unchanged function @unchanged
+; CHECK:     Spurious invalidation: InvalidateAllAnalysesPass invalidated analyses of unchanged function @changed
+; CHECK-NOT: Spurious invalidation
+
+; DISABLED-NOT: Spurious invalidation
+
+define void @unchanged() {
+  ret void
+}
+
+define i32 @changed(i32 %x) {
+  %a = add i32 %x, 0
+  ret i32 %a
+}
@@ -0,0 +1,71 @@
+;; The memoized callee selection makes the same import decisions as running
+;; selectCallee for every call edge: @f has a copy too large to import and a
+;; small one, and it is reached from @main directly and, at a lower threshold,
+;; through @g.
+
+; RUN: rm -rf %t && split-file %s %t && cd %t
+; RUN: mkdir on off
+; RUN: opt -module-summary main.ll -o on/main.bc
+; RUN: opt -module-summary a.ll -o on/a.bc
+; RUN: opt -module-summary b.ll -o on/b.bc
+; RUN: cp on/*.bc off
+
+; RUN: cd %t/on && llvm-lto2 run main.bc a.bc b.bc -o out \
+; RUN:   -thinlto-distributed-indexes -thinlto-emit-imports \
+; RUN:   -import-instr-limit=5 -r=main.bc,main,px -r=main.bc,f, \
+; RUN:   -r=main.bc,g, -r=a.bc,f,px -r=a.bc,g,px -r=b.bc,f,
+; RUN: cd %t/off && llvm-lto2 run main.bc a.bc b.bc -o out \
+; RUN:   -thinlto-distributed-indexes -thinlto-emit-imports \
+; RUN:   -import-instr-limit=5 -import-callee-selection-cache=false \
+; RUN:   -r=main.bc,main,px -r=main.bc,f, -r=main.bc,g, -r=a.bc,f,px \
+; RUN:   -r=a.bc,g,px -r=b.bc,f,
+; RUN: cd %t
+; RUN: diff on/main.bc.imports off/main.bc.imports
+; RUN: diff on/a.bc.imports off/a.bc.imports
+; RUN: diff on/b.bc.imports off/b.bc.imports
+; RUN: FileCheck %s < on/main.bc.imports
+
+;; Both @f, through its small copy, and @g are imported into main.bc.
+; CHECK-DAG: a.bc
+; CHECK-DAG: b.bc
+
+;--- main.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare i32 @f()
+declare i32 @g()
+
+define i32 @main() {
+  %a = call i32 @f()
+  %b = call i32 @g()
+  %r = add i32 %a, %b
+  ret i32 %r
+}
+
+;--- a.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define linkonce_odr i32 @f() {
+  %a = add i32 1, 1
+  %b = add i32 %a, 1
+  %c = add i32 %b, 1
+  %d = add i32 %c, 1
+  %e = add i32 %d, 1
+  %g = add i32 %e, 1
+  ret i32 %g
+}
+
+define i32 @g() {
+  %r = call i32 @f()
+  ret i32 %r
+}
+
+;--- b.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define linkonce_odr i32 @f() {
+  ret i32 1
+}
@@ -0,0 +1,27 @@
+; RUN: opt -passes=instcombine -instcombine-report-folds -disable-output %s \
+; RUN:   2>&1 | FileCheck %s
+
+;; Combines are counted per opcode, or per intrinsic for intrinsic calls, and
+;; listed most frequent first. The second iteration only verifies the fixpoint
+;; and makes no combines, so it has no line of its own. Functions that
+;; instcombine does not change are not reported.
+
+; CHECK:      IC: folds: 2 iteration(s)
+; CHECK-NEXT:   iteration 1: add=2 llvm.umax=1 mul=1
+; CHECK-NOT:  IC:
+
+define i32 @folds(i32 %x, i32 %y) {
+  %a = add i32 %x, 0
+  %b = mul i32 %a, 1
+  %c = add i32 %y, 0
+  %m = call i32 @llvm.umax.i32(i32 %c, i32 %c)
+  %d = add i32 %b, %m
+  ret i32 %d
+}
+
+define i32 @unchanged(i32 %x, i32 %y) {
+  %a = add i32 %x, %y
+  ret i32 %a
+}
+
+declare i32 @llvm.umax.i32(i32, i32)
@@ -0,0 +1,110 @@
+; REQUIRES: asserts
+; RUN: opt -passes=loop-vectorize -enable-vplan-native-path \
+; RUN:   -mtriple=x86_64-unknown-linux-gnu -mattr=+avx2 \
+; RUN:   -debug-only=loop-vectorize -disable-output < %s 2>&1 | FileCheck %s
+
+; Without an explicit width, the VPlan-native path picks VF 8 for i32 on
+; AVX2. The VF must be clamped to the trip count of the outer loop, and
+; outer loops that run fewer than two iterations are not vectorized.
+
+; CHECK-LABEL: LV: Checking a loop in 'outer_tc_100'
+; CHECK:       LV: VPlan computed VF 8.
+; CHECK-NOT:   LV: VF clamped
+; CHECK:       LV: Using VF 8 to build VPlans.
+
+; CHECK-LABEL: LV: Checking a loop in 'outer_tc_6'
+; CHECK:       LV: VPlan computed VF 8.
+; CHECK-NEXT:  LV: VF clamped to 4 by the outer loop trip count.
+; CHECK-NEXT:  LV: Using VF 4 to build VPlans.
+
+; CHECK-LABEL: LV: Checking a loop in 'outer_tc_1'
+; CHECK:       LV: VPlan computed VF 8.
+; CHECK-NEXT:  LV: Not vectorizing. Outer loop trip count 1 is too small.
+; CHECK-NOT:   LV: Using VF
+
+define void @outer_tc_100(ptr %a) {
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  %p = getelementptr inbounds i32, ptr %a, i64 %i
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %v = load i32, ptr %p, align 4
+  %j.trunc = trunc i64 %j to i32
+  %add = add i32 %v, %j.trunc
+  store i32 %add, ptr %p, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.done = icmp eq i64 %j.next, 16
+  br i1 %inner.done, label %outer.latch, label %inner
+
+outer.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.done = icmp eq i64 %i.next, 100
+  br i1 %outer.done, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+define void @outer_tc_6(ptr %a) {
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  %p = getelementptr inbounds i32, ptr %a, i64 %i
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %v = load i32, ptr %p, align 4
+  %j.trunc = trunc i64 %j to i32
+  %add = add i32 %v, %j.trunc
+  store i32 %add, ptr %p, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.done = icmp eq i64 %j.next, 16
+  br i1 %inner.done, label %outer.latch, label %inner
+
+outer.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.done = icmp eq i64 %i.next, 6
+  br i1 %outer.done, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+define void @outer_tc_1(ptr %a) {
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  %p = getelementptr inbounds i32, ptr %a, i64 %i
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %v = load i32, ptr %p, align 4
+  %j.trunc = trunc i64 %j to i32
+  %add = add i32 %v, %j.trunc
+  store i32 %add, ptr %p, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.done = icmp eq i64 %j.next, 16
+  br i1 %inner.done, label %outer.latch, label %inner
+
+outer.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.done = icmp eq i64 %i.next, 1
+  br i1 %outer.done, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+!0 = distinct !{!0, !1}
+!1 = !{!"llvm.loop.vectorize.enable", i1 true}
@@ -0,0 +1,134 @@
+; REQUIRES: asserts
+; RUN: opt -passes=loop-vectorize -mtriple=x86_64-unknown-linux-gnu \
+; RUN:   -mattr=+avx2 -debug-only=loop-vectorize -disable-output < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=DEBUG
+; RUN: opt -passes=loop-vectorize -mtriple=x86_64-unknown-linux-gnu \
+; RUN:   -mattr=+avx2 -S < %s | FileCheck %s
+
+; The memory checks of the 16-iteration inner loop are invariant in both
+; enclosing loops, so LICM hoists them out of the whole nest. Their cost is
+; spread over the product of the two outer trip counts, 2 * 100, and not
+; just over the 2 iterations of the immediately enclosing loop.
+
+; DEBUG-LABEL: LV: Checking a loop in 'invariant_in_nest'
+; DEBUG:       We expect runtime memory checks to be hoisted out of the outer loop. Cost reduced from [[#COST:]] to [[#max(div(COST,200),1)]]
+
+; CHECK-LABEL: define void @invariant_in_nest(
+; CHECK:       vector.memcheck:
+; CHECK:       vector.body:
+
+; Here the checks depend on the induction variable of the middle loop and
+; cannot be hoisted at all. Their full cost still makes the inner loop
+; unprofitable to vectorize.
+
+; DEBUG-LABEL: LV: Checking a loop in 'variant_in_middle'
+; DEBUG-NOT:   We expect runtime memory checks to be hoisted
+; DEBUG:       LV: Vectorization is not beneficial: expected trip count < minimum profitable VF (16 <
+
+; CHECK-LABEL: define void @variant_in_middle(
+; CHECK-NOT:   vector.body:
+; CHECK:       ret void
+
+define void @invariant_in_nest(ptr %a, ptr %b, ptr %c, ptr %d, ptr %e, ptr %f, ptr %g) {
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  br label %middle
+
+middle:
+  %k = phi i64 [ 0, %outer ], [ %k.next, %middle.latch ]
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %middle ], [ %j.next, %inner ]
+  %b.gep = getelementptr inbounds i32, ptr %b, i64 %j
+  %b.val = load i32, ptr %b.gep, align 4
+  %c.gep = getelementptr inbounds i32, ptr %c, i64 %j
+  %c.val = load i32, ptr %c.gep, align 4
+  %sum.c = add i32 %b.val, %c.val
+  %d.gep = getelementptr inbounds i32, ptr %d, i64 %j
+  %d.val = load i32, ptr %d.gep, align 4
+  %sum.d = add i32 %sum.c, %d.val
+  %e.gep = getelementptr inbounds i32, ptr %e, i64 %j
+  %e.val = load i32, ptr %e.gep, align 4
+  %sum.e = add i32 %sum.d, %e.val
+  %f.gep = getelementptr inbounds i32, ptr %f, i64 %j
+  %f.val = load i32, ptr %f.gep, align 4
+  %sum.f = add i32 %sum.e, %f.val
+  %g.gep = getelementptr inbounds i32, ptr %g, i64 %j
+  %g.val = load i32, ptr %g.gep, align 4
+  %sum.g = add i32 %sum.f, %g.val
+  %a.gep = getelementptr inbounds i32, ptr %a, i64 %j
+  store i32 %sum.g, ptr %a.gep, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.done = icmp eq i64 %j.next, 16
+  br i1 %inner.done, label %middle.latch, label %inner
+
+middle.latch:
+  %k.next = add nuw nsw i64 %k, 1
+  %middle.done = icmp eq i64 %k.next, 2
+  br i1 %middle.done, label %outer.latch, label %middle
+
+outer.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.done = icmp eq i64 %i.next, 100
+  br i1 %outer.done, label %exit, label %outer
+
+exit:
+  ret void
+}
+
+define void @variant_in_middle(ptr %a, ptr %b, ptr %c, ptr %d, ptr %e, ptr %f, ptr %g) {
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  br label %middle
+
+middle:
+  %k = phi i64 [ 0, %outer ], [ %k.next, %middle.latch ]
+  %row = shl nuw nsw i64 %k, 4
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %middle ], [ %j.next, %inner ]
+  %idx = add nuw nsw i64 %row, %j
+  %b.gep = getelementptr inbounds i32, ptr %b, i64 %idx
+  %b.val = load i32, ptr %b.gep, align 4
+  %c.gep = getelementptr inbounds i32, ptr %c, i64 %idx
+  %c.val = load i32, ptr %c.gep, align 4
+  %sum.c = add i32 %b.val, %c.val
+  %d.gep = getelementptr inbounds i32, ptr %d, i64 %idx
+  %d.val = load i32, ptr %d.gep, align 4
+  %sum.d = add i32 %sum.c, %d.val
+  %e.gep = getelementptr inbounds i32, ptr %e, i64 %idx
+  %e.val = load i32, ptr %e.gep, align 4
+  %sum.e = add i32 %sum.d, %e.val
+  %f.gep = getelementptr inbounds i32, ptr %f, i64 %idx
+  %f.val = load i32, ptr %f.gep, align 4
+  %sum.f = add i32 %sum.e, %f.val
+  %g.gep = getelementptr inbounds i32, ptr %g, i64 %idx
+  %g.val = load i32, ptr %g.gep, align 4
+  %sum.g = add i32 %sum.f, %g.val
+  %a.gep = getelementptr inbounds i32, ptr %a, i64 %idx
+  store i32 %sum.g, ptr %a.gep, align 4
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.done = icmp eq i64 %j.next, 16
+  br i1 %inner.done, label %middle.latch, label %inner
+
+middle.latch:
+  %k.next = add nuw nsw i64 %k, 1
+  %middle.done = icmp eq i64 %k.next, 16
+  br i1 %middle.done, label %outer.latch, label %middle
+
+outer.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.done = icmp eq i64 %i.next, 16
+  br i1 %outer.done, label %exit, label %outer
+
+exit:
+  ret void
+}
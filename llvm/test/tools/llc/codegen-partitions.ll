@@ -0,0 +1,34 @@
+; REQUIRES: x86-registered-target
+; RUN: rm -rf %t && mkdir %t
+; RUN: llc -mtriple=x86_64-unknown-linux-gnu -codegen-partitions=2 %s \
+; RUN:   -o %t/out.s -pass-remarks-output=%t/remarks.yaml
+; RUN: cat %t/out.s %t/out.s.1 > %t/all.s
+; RUN: FileCheck %s --check-prefix=DEFS < %t/all.s
+; RUN: FileCheck %s --check-prefix=LOCAL < %t/all.s
+; RUN: cat %t/remarks.yaml %t/remarks.yaml.1 | FileCheck %s --check-prefix=REMARKS
+
+;; Every function is emitted exactly once across the partitions, and the
+;; internal function stays local to the partition of its caller.
+; DEFS-DAG: {{^}}helper:
+; DEFS-DAG: {{^}}f1:
+; DEFS-DAG: {{^}}f2:
+; LOCAL-NOT: .globl helper
+
+;; Each partition writes its own remarks file.
+; REMARKS-DAG: Function: f1
+; REMARKS-DAG: Function: f2
+
+define internal i32 @helper(i32 %x) noinline {
+  %r = mul i32 %x, 3
+  ret i32 %r
+}
+
+define i32 @f1(i32 %x) {
+  %r = call i32 @helper(i32 %x)
+  ret i32 %r
+}
+
+define i32 @f2(i32 %x) {
+  %r = add i32 %x, 1
+  ret i32 %r
+}
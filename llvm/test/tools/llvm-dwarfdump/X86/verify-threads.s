@@ -0,0 +1,102 @@
+# Test that --verify-threads verifies units concurrently but reports them in
+# unit order, with the same output and error counts as a serial run.
+
+# REQUIRES: x86-registered-target
+
+# RUN: llvm-mc -filetype=obj -triple=x86_64 %s -o %t.o
+# RUN: not llvm-dwarfdump --verify %t.o > %t.serial
+# RUN: not llvm-dwarfdump --verify --verify-threads=4 %t.o > %t.parallel
+# RUN: diff %t.serial %t.parallel
+# RUN: not llvm-dwarfdump --verify --verify-threads=0 %t.o > %t.all
+# RUN: diff %t.serial %t.all
+# RUN: FileCheck %s < %t.parallel
+
+# CHECK:      Verifying unit: 1 / 3, "a.c"
+# CHECK-NEXT: Verifying unit: 2 / 3, "b.c"
+# CHECK-NEXT: Verifying unit: 3 / 3, "c.c"
+# CHECK-NEXT: error: DW_FORM_ref4 CU offset 0x00001000 is invalid (must be less than CU size of 0x{{[0-9a-f]+}}):
+
+## The aggregated error counts are merged from all units.
+# CHECK:      error: Aggregated error counts:
+# CHECK-NEXT: error: Invalid CU offset occurred 1 time(s).
+# CHECK:      Errors detected.
+
+  .section .debug_abbrev,"",@progbits
+  .byte 1                       # Abbreviation code
+  .byte 0x11                    # DW_TAG_compile_unit
+  .byte 1                       # DW_CHILDREN_yes
+  .byte 0x03                    # DW_AT_name
+  .byte 0x08                    # DW_FORM_string
+  .byte 0, 0
+  .byte 2                       # Abbreviation code
+  .byte 0x24                    # DW_TAG_base_type
+  .byte 0                       # DW_CHILDREN_no
+  .byte 0x03                    # DW_AT_name
+  .byte 0x08                    # DW_FORM_string
+  .byte 0x3e                    # DW_AT_encoding
+  .byte 0x0b                    # DW_FORM_data1
+  .byte 0x0b                    # DW_AT_byte_size
+  .byte 0x0b                    # DW_FORM_data1
+  .byte 0, 0
+  .byte 3                       # Abbreviation code
+  .byte 0x34                    # DW_TAG_variable
+  .byte 0                       # DW_CHILDREN_no
+  .byte 0x03                    # DW_AT_name
+  .byte 0x08                    # DW_FORM_string
+  .byte 0x49                    # DW_AT_type
+  .byte 0x13                    # DW_FORM_ref4
+  .byte 0, 0
+  .byte 0
+
+  .section .debug_info,"",@progbits
+.Lcu1:
+  .long .Lcu1_end - .Lcu1_version # Length of Unit
+.Lcu1_version:
+  .short 4                      # DWARF version number
+  .long .debug_abbrev           # Offset Into Abbrev. Section
+  .byte 8                       # Address Size
+  .byte 1                       # DW_TAG_compile_unit
+  .asciz "a.c"                  # DW_AT_name
+.Lcu1_int:
+  .byte 2                       # DW_TAG_base_type
+  .asciz "int"                  # DW_AT_name
+  .byte 5                       # DW_AT_encoding (DW_ATE_signed)
+  .byte 4                       # DW_AT_byte_size
+  .byte 3                       # DW_TAG_variable
+  .asciz "a"                    # DW_AT_name
+  .long .Lcu1_int - .Lcu1       # DW_AT_type
+  .byte 0                       # End Of Children Mark
+.Lcu1_end:
+
+.Lcu2:
+  .long .Lcu2_end - .Lcu2_version # Length of Unit
+.Lcu2_version:
+  .short 4                      # DWARF version number
+  .long .debug_abbrev           # Offset Into Abbrev. Section
+  .byte 8                       # Address Size
+  .byte 1                       # DW_TAG_compile_unit
+  .asciz "b.c"                  # DW_AT_name
+.Lcu2_int:
+  .byte 2                       # DW_TAG_base_type
+  .asciz "int"                  # DW_AT_name
+  .byte 5                       # DW_AT_encoding (DW_ATE_signed)
+  .byte 4                       # DW_AT_byte_size
+  .byte 3                       # DW_TAG_variable
+  .asciz "b"                    # DW_AT_name
+  .long .Lcu2_int - .Lcu2       # DW_AT_type
+  .byte 0                       # End Of Children Mark
+.Lcu2_end:
+
+.Lcu3:
+  .long .Lcu3_end - .Lcu3_version # Length of Unit
+.Lcu3_version:
+  .short 4                      # DWARF version number
+  .long .debug_abbrev           # Offset Into Abbrev. Section
+  .byte 8                       # Address Size
+  .byte 1                       # DW_TAG_compile_unit
+  .asciz "c.c"                  # DW_AT_name
+  .byte 3                       # DW_TAG_variable
+  .asciz "c"                    # DW_AT_name
+  .long 0x1000                  # DW_AT_type (invalid)
+  .byte 0                       # End Of Children Mark
+.Lcu3_end:
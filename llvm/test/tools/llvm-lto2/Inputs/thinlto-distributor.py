@@ -0,0 +1,21 @@
+# A minimal ThinLTO distributor for testing -thinlto-distributor.
+#
+# Usage: thinlto-distributor.py <llc> <jobs copy> <jobs file>
+#
+# Copies the jobs file so that the test can check it, then compiles each
+# module locally with llc. The summary index and imports are not used, so
+# imported definitions remain undefined references in the native objects.
+
+import json
+import shutil
+import subprocess
+import sys
+
+llc, jobs_copy, jobs_file = sys.argv[1:]
+shutil.copyfile(jobs_file, jobs_copy)
+with open(jobs_file) as f:
+    jobs = json.load(f)
+for job in jobs["jobs"]:
+    subprocess.check_call(
+        [llc, "-filetype=obj", job["module"], "-o", job["output"]]
+    )
@@ -0,0 +1,148 @@
+; REQUIRES: x86-registered-target
+; RUN: rm -rf %t && split-file %s %t && cd %t
+
+;; The summaries record a hash for each definition.
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes foo.ll \
+; RUN:   -o foo.bc
+; RUN: llvm-bcanalyzer -dump foo.bc | FileCheck %s --check-prefix=BCA
+; BCA: <PERMODULE_BODY_HASH
+
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes main.ll \
+; RUN:   -o main.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 2
+
+;; Changing a function that main.bc does not import only invalidates the
+;; entry for foo.bc.
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes \
+; RUN:   foo-bar-changed.ll -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 3
+
+;; Changing the imported function invalidates both entries.
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes \
+; RUN:   foo-foo-changed.ll -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 5
+; RUN: llvm-nm out.1 | FileCheck %s --check-prefix=MAIN
+; MAIN: T main
+
+;; Without -cache-key-body-hashes, changing bar invalidates both entries, and
+;; the two schemes do not share entries.
+; RUN: rm -rf cache
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes foo.ll \
+; RUN:   -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -r=main.bc,main,px -r=main.bc,foo, -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 2
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 4
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes \
+; RUN:   foo-bar-changed.ll -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -r=main.bc,main,px -r=main.bc,foo, -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 6
+
+;; Without body hashes in the summary, the module hash is used.
+; RUN: rm -rf cache
+; RUN: opt -module-hash -module-summary foo.ll -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 2
+; RUN: opt -module-hash -module-summary foo-bar-changed.ll -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 4
+
+;; Changing only an attribute of the imported function invalidates both
+;; entries, even though it is still printed as the same attribute group #0.
+; RUN: rm -rf cache
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes foo.ll \
+; RUN:   -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 2
+; RUN: opt -module-hash -module-summary -module-summary-body-hashes \
+; RUN:   foo-attr-changed.ll -o foo.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -cache-dir cache \
+; RUN:   -cache-key-body-hashes -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -r=foo.bc,bar,px
+; RUN: ls cache | count 4
+
+;--- main.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare i32 @foo()
+
+define i32 @main() {
+  %r = call i32 @foo()
+  ret i32 %r
+}
+
+;--- foo.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @foo() #0 {
+  ret i32 1
+}
+
+define i32 @bar() {
+  ret i32 2
+}
+
+attributes #0 = { "frame-pointer"="none" }
+
+;--- foo-bar-changed.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @foo() #0 {
+  ret i32 1
+}
+
+define i32 @bar() {
+  ret i32 3
+}
+
+attributes #0 = { "frame-pointer"="none" }
+
+;--- foo-foo-changed.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @foo() #0 {
+  ret i32 4
+}
+
+define i32 @bar() {
+  ret i32 2
+}
+
+attributes #0 = { "frame-pointer"="none" }
+
+;--- foo-attr-changed.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @foo() #0 {
+  ret i32 1
+}
+
+define i32 @bar() {
+  ret i32 2
+}
+
+attributes #0 = { "frame-pointer"="all" }
@@ -0,0 +1,50 @@
+; REQUIRES: x86-registered-target
+; RUN: rm -rf %t.cache && mkdir %t.cache
+; RUN: llvm-as %s -o %t.bc
+
+;; The first link code generates the partition and adds it to the cache.
+; RUN: llvm-lto2 run %t.bc -o %t.o -r=%t.bc,foo,px -cache-dir %t.cache \
+; RUN:   -cache-regular-lto-partitions
+; RUN: ls %t.cache | count 1
+; RUN: llvm-nm %t.o.0 | FileCheck %s
+
+;; The second link reuses the cached object.
+; RUN: rm %t.o.0
+; RUN: llvm-lto2 run %t.bc -o %t.o -r=%t.bc,foo,px -cache-dir %t.cache \
+; RUN:   -cache-regular-lto-partitions
+; RUN: ls %t.cache | count 1
+; RUN: llvm-nm %t.o.0 | FileCheck %s
+
+;; Replace the cached object with one that defines another symbol. The next
+;; link must pick it up from the cache instead of code generating again.
+; RUN: echo '.globl tampered; tampered: ret' | \
+; RUN:   llvm-mc -filetype=obj -triple=x86_64-unknown-linux-gnu -o %t.tampered.o
+; RUN: %python -c "import glob, shutil; [shutil.copy(r'%t.tampered.o', f) for f in glob.glob(r'%t.cache/llvmcache-*')]"
+; RUN: rm %t.o.0
+; RUN: llvm-lto2 run %t.bc -o %t.o -r=%t.bc,foo,px -cache-dir %t.cache \
+; RUN:   -cache-regular-lto-partitions
+; RUN: llvm-nm %t.o.0 | FileCheck %s --check-prefix=TAMPERED
+
+;; Without the option the regular LTO object is not cached.
+; RUN: rm -rf %t.cache && mkdir %t.cache
+; RUN: llvm-lto2 run %t.bc -o %t.o -r=%t.bc,foo,px -cache-dir %t.cache
+; RUN: ls %t.cache | count 0
+
+;; A cache entry that cannot be read is reported as an error.
+; RUN: llvm-lto2 run %t.bc -o %t.o -r=%t.bc,foo,px -cache-dir %t.cache \
+; RUN:   -cache-regular-lto-partitions
+; RUN: %python -c "import glob, os; [(os.remove(f), os.mkdir(f)) for f in glob.glob(r'%t.cache/llvmcache-*')]"
+; RUN: not llvm-lto2 run %t.bc -o %t.o -r=%t.bc,foo,px -cache-dir %t.cache \
+; RUN:   -cache-regular-lto-partitions 2>&1 | FileCheck %s --check-prefix=ERR
+
+; CHECK: T foo
+; TAMPERED:     T tampered
+; TAMPERED-NOT: foo
+; ERR: Failed to open cache file {{.*}}llvmcache-
+
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @foo() {
+  ret void
+}
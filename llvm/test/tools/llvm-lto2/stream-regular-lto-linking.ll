@@ -0,0 +1,61 @@
+; REQUIRES: x86-registered-target
+; RUN: rm -rf %t && split-file %s %t && cd %t
+; RUN: opt -module-summary a.ll -o a.bc
+; RUN: opt -module-summary b.ll -o b.bc
+
+;; By default, regular LTO modules with a summary are linked after liveness
+;; has been computed from the combined index, so the dead global is never
+;; linked into the combined module.
+; RUN: llvm-lto2 run a.bc b.bc -o default -save-temps -r=a.bc,foo,px \
+; RUN:   -r=a.bc,bar, -r=a.bc,dead,p -r=b.bc,bar,px
+; RUN: llvm-dis default.0.0.preopt.bc -o - | \
+; RUN:   FileCheck %s --check-prefix=PREOPT --implicit-check-not=@dead
+; RUN: llvm-nm default.0 | FileCheck %s --check-prefix=NM
+
+;; With -stream-regular-lto-linking each module is linked as soon as it is
+;; added. The dead global reaches the combined module and is only removed by
+;; the optimization pipeline.
+; RUN: llvm-lto2 run a.bc b.bc -o stream -save-temps -r=a.bc,foo,px \
+; RUN:   -r=a.bc,bar, -r=a.bc,dead,p -r=b.bc,bar,px -stream-regular-lto-linking
+; RUN: llvm-dis stream.0.0.preopt.bc -o - | \
+; RUN:   FileCheck %s --check-prefixes=PREOPT,STREAM
+; RUN: llvm-nm stream.0 | FileCheck %s --check-prefix=NM
+
+; PREOPT-DAG: define void @foo()
+; PREOPT-DAG: define void @bar()
+; STREAM-DAG: @dead
+
+; NM-NOT: dead
+; NM:     T bar
+; NM-NOT: dead
+; NM:     T foo
+; NM-NOT: dead
+
+;--- a.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @bar()
+
+define void @foo() {
+  call void @bar()
+  ret void
+}
+
+define void @dead() {
+  ret void
+}
+
+!llvm.module.flags = !{!0}
+!0 = !{i32 1, !"ThinLTO", i32 0}
+
+;--- b.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @bar() {
+  ret void
+}
+
+!llvm.module.flags = !{!0}
+!0 = !{i32 1, !"ThinLTO", i32 0}
@@ -0,0 +1,75 @@
+; REQUIRES: x86-registered-target
+; RUN: rm -rf %t && split-file %s %t && cd %t
+; RUN: opt -module-summary main.ll -o main.bc
+; RUN: opt -module-summary foo.ll -o foo.bc
+
+;; The distributor receives one job per module and its native objects are
+;; added to the link. Another link's file in the same directory is left alone.
+; RUN: echo other > main.bc.1.thinlto.bc
+; RUN: llvm-lto2 run main.bc foo.bc -o out -r=main.bc,main,px -r=main.bc,foo, \
+; RUN:   -r=foo.bc,foo,px -thinlto-distributor=%python \
+; RUN:   -thinlto-distributor-arg %S/Inputs/thinlto-distributor.py \
+; RUN:   -thinlto-distributor-arg llc -thinlto-distributor-arg jobs.json
+; RUN: FileCheck %s --check-prefix=JOBS < jobs.json
+; RUN: llvm-nm out.1 | FileCheck %s --check-prefix=MAIN
+; RUN: llvm-nm out.2 | FileCheck %s --check-prefix=FOO
+
+; JOBS:      "version": 1,
+; JOBS:      "cpu": "",
+; JOBS:      "opt_level": 2
+; JOBS:      "jobs": [
+; JOBS:          "task": 1,
+; JOBS-NEXT:     "module_id": "main.bc",
+; JOBS-NEXT:     "module": "main.bc",
+; JOBS-NEXT:     "summary_index": "{{.*}}thinlto-{{.*}}main.bc.1.thinlto.bc",
+; JOBS-NEXT:     "imports": [
+; JOBS-NEXT:       {
+; JOBS-NEXT:         "module_id": "foo.bc",
+; JOBS-NEXT:         "module": "foo.bc"
+; JOBS-NEXT:       }
+; JOBS-NEXT:     ],
+; JOBS-NEXT:     "output": "{{.*}}thinlto-{{.*}}main.bc.1.native.o"
+; JOBS:          "task": 2,
+; JOBS-NEXT:     "module_id": "foo.bc",
+
+; MAIN: T main
+; FOO:  T foo
+
+;; The temporary directory with the index and native object files is removed
+;; afterwards, but not files this link did not create.
+; RUN: not ls -d thinlto-*
+; RUN: FileCheck %s --check-prefix=OTHER < main.bc.1.thinlto.bc
+; OTHER: other
+
+;; A failing distributor is reported as an error.
+; RUN: not llvm-lto2 run main.bc foo.bc -o out -r=main.bc,main,px \
+; RUN:   -r=main.bc,foo, -r=foo.bc,foo,px -thinlto-distributor=%python \
+; RUN:   -thinlto-distributor-arg -c -thinlto-distributor-arg "exit(3)" \
+; RUN:   2>&1 | FileCheck %s --check-prefix=FAIL
+; FAIL: ThinLTO distributor '{{.*}}' failed with exit code 3
+
+;; A distributor that does not exist is reported as an error.
+; RUN: not llvm-lto2 run main.bc foo.bc -o out -r=main.bc,main,px \
+; RUN:   -r=main.bc,foo, -r=foo.bc,foo,px \
+; RUN:   -thinlto-distributor=%t/does-not-exist 2>&1 | \
+; RUN:   FileCheck %s --check-prefix=MISSING
+; MISSING: could not run ThinLTO distributor '{{.*}}does-not-exist'
+
+;--- main.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+declare void @foo()
+
+define void @main() {
+  call void @foo()
+  ret void
+}
+
+;--- foo.ll
+target datalayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @foo() {
+  ret void
+}
@@ -0,0 +1,101 @@
+; Test that -balance-by-cost balances partitions by instruction count rather
+; than by the number of globals, and keeps hot call edges in one partition.
+
+; RUN: rm -rf %t && split-file %s %t && cd %t
+
+;; The large function has a partition to itself and the small functions share
+;; the other one.
+; RUN: llvm-split -j2 -balance-by-cost -o size size.ll
+; RUN: llvm-dis -o - size0 | FileCheck %s --check-prefix=SIZE0
+; RUN: llvm-dis -o - size1 | FileCheck %s --check-prefix=SIZE1
+
+; SIZE0:     define i32 @large
+; SIZE0-NOT: define
+
+; SIZE1-DAG: define void @small1
+; SIZE1-DAG: define void @small2
+; SIZE1-DAG: define void @small3
+; SIZE1-DAG: define void @small4
+; SIZE1-NOT: define i32 @large
+
+;; Without the hot edge, cost balancing alone would place hot_caller and
+;; hot_callee in different partitions.
+; RUN: llvm-split -j2 -balance-by-cost -o hot hot.ll
+; RUN: llvm-dis -o - hot0 | FileCheck %s --check-prefix=HOT0
+; RUN: llvm-dis -o - hot1 | FileCheck %s --check-prefix=HOT1
+
+; HOT0-DAG:  define void @hot_caller
+; HOT0-DAG:  define void @hot_callee
+; HOT0-NOT:  define i32 @cold
+
+; HOT1-DAG:  define i32 @cold1
+; HOT1-DAG:  define i32 @cold2
+; HOT1-NOT:  define void @hot
+
+;--- size.ll
+define i32 @large(i32 %x) {
+  %a = add i32 %x, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = add i32 %c, 4
+  %e = add i32 %d, 5
+  %f = add i32 %e, 6
+  %g = add i32 %f, 7
+  %h = add i32 %g, 8
+  ret i32 %h
+}
+
+define void @small1() {
+  ret void
+}
+
+define void @small2() {
+  ret void
+}
+
+define void @small3() {
+  ret void
+}
+
+define void @small4() {
+  ret void
+}
+
+;--- hot.ll
+define void @hot_caller() !prof !0 {
+  call void @hot_callee()
+  ret void
+}
+
+define void @hot_callee() !prof !0 {
+  ret void
+}
+
+define i32 @cold1(i32 %x) {
+  %a = add i32 %x, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = add i32 %c, 4
+  %e = add i32 %d, 5
+  %f = add i32 %e, 6
+  %g = add i32 %f, 7
+  %h = add i32 %g, 8
+  %i = add i32 %h, 9
+  %j = add i32 %i, 10
+  ret i32 %j
+}
+
+define i32 @cold2(i32 %x) {
+  %a = add i32 %x, 1
+  %b = add i32 %a, 2
+  %c = add i32 %b, 3
+  %d = add i32 %c, 4
+  %e = add i32 %d, 5
+  %f = add i32 %e, 6
+  %g = add i32 %f, 7
+  %h = add i32 %g, 8
+  %i = add i32 %h, 9
+  ret i32 %i
+}
+
+!0 = !{!"function_entry_count", i64 1000}
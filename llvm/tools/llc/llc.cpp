@@ -16,6 +16,8 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/CodeGen/LinkAllAsmWriterComponents.h"
 #include "llvm/CodeGen/LinkAllCodegenComponents.h"
@@ -47,6 +49,7 @@
 #include "llvm/Support/PluginLoader.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
@@ -56,6 +59,7 @@
 #include "llvm/TargetParser/SubtargetFeature.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include <memory>
 #include <optional>
 using namespace llvm;
@@ -98,6 +102,13 @@ static cl::opt<std::string>
                   cl::desc("Specify time trace file destination"),
                   cl::value_desc("filename"));
 
+static cl::opt<unsigned> CodeGenPartitions(
+    "codegen-partitions",
+    cl::desc("Split the module into this many partitions and generate code "
+             "for them in parallel. Partition N > 0 is written to "
+             "<output>.N; the outputs must be linked together"),
+    cl::value_desc("N"), cl::init(1));
+
 static cl::opt<std::string>
     BinutilsVersion("binutils-version", cl::Hidden,
                     cl::desc("Produced object files can use all ELF features "
@@ -392,13 +403,17 @@ int main(int argc, char **argv) {
   // Set a diagnostic handler that doesn't exit on the first error
   Context.setDiagnosticHandler(std::make_unique<LLCDiagnosticHandler>());
 
-  Expected<std::unique_ptr<ToolOutputFile>> RemarksFileOrErr =
-      setupLLVMOptimizationRemarks(Context, RemarksFilename, RemarksPasses,
-                                   RemarksFormat, RemarksWithHotness,
-                                   RemarksHotnessThreshold);
-  if (Error E = RemarksFileOrErr.takeError())
-    reportError(std::move(E), RemarksFilename);
-  std::unique_ptr<ToolOutputFile> RemarksFile = std::move(*RemarksFileOrErr);
+  // With -codegen-partitions, each partition sets up its own remarks file.
+  std::unique_ptr<ToolOutputFile> RemarksFile;
+  if (CodeGenPartitions <= 1) {
+    Expected<std::unique_ptr<ToolOutputFile>> RemarksFileOrErr =
+        setupLLVMOptimizationRemarks(Context, RemarksFilename, RemarksPasses,
+                                     RemarksFormat, RemarksWithHotness,
+                                     RemarksHotnessThreshold);
+    if (Error E = RemarksFileOrErr.takeError())
+      reportError(std::move(E), RemarksFilename);
+    RemarksFile = std::move(*RemarksFileOrErr);
+  }
 
   if (InputLanguage != "" && InputLanguage != "ir" && InputLanguage != "mir")
     reportError("input language must be '', 'IR' or 'MIR'");
@@ -443,6 +458,117 @@ static bool addPass(PassManagerBase &PM, const char *argv0,
   return false;
 }
 
+/// Generates code for \p M in CodeGenPartitions parallel partitions. The
+/// first partition is written to \p Out and partition N to "<output>.N".
+/// Each partition is compiled in its own LLVMContext with the same diagnostic
+/// handler as the main context, and partition N > 0 writes its remarks to
+/// "<remarks>.N".
+static int compileModulePartitioned(const char *Argv0, Module &M,
+                                    const Target *TheTarget,
+                                    const Triple &TheTriple, StringRef CPUStr,
+                                    StringRef FeaturesStr,
+                                    const TargetOptions &Options,
+                                    std::optional<Reloc::Model> RM,
+                                    CodeModel::Model CM, CodeGenOptLevel OLvl,
+                                    const TargetLibraryInfoImpl &TLII,
+                                    ToolOutputFile &Out) {
+  if (!getRunPassNames().empty() || !SplitDwarfOutputFile.empty() ||
+      CompileTwice || DisableSimplifyLibCalls || EnableNewPassManager ||
+      !PassPipeline.empty()) {
+    WithColor::error(errs(), Argv0)
+        << "-codegen-partitions cannot be combined with -run-pass, "
+           "-split-dwarf-output, -compile-twice, -disable-simplify-libcalls "
+           "or the new pass manager\n";
+    return 1;
+  }
+  if (Out.outputFilename() == "-") {
+    WithColor::error(errs(), Argv0)
+        << "-codegen-partitions requires an output file\n";
+    return 1;
+  }
+
+  sys::fs::OpenFlags OpenFlags = sys::fs::OF_None;
+  if (codegen::getFileType() == CodeGenFileType::AssemblyFile)
+    OpenFlags |= sys::fs::OF_TextWithCRLF;
+  std::vector<std::unique_ptr<ToolOutputFile>> PartitionOuts;
+  std::vector<raw_pwrite_stream *> OSs{&Out.os()};
+  for (unsigned I = 1; I != CodeGenPartitions; ++I) {
+    std::string Name = (Out.outputFilename() + "." + Twine(I)).str();
+    std::error_code EC;
+    PartitionOuts.push_back(
+        std::make_unique<ToolOutputFile>(Name, EC, OpenFlags));
+    if (EC)
+      reportError(EC.message(), Name);
+    OSs.push_back(&PartitionOuts.back()->os());
+  }
+
+  // Keep local symbols local so that the partitions can be linked together
+  // without clashes. Serialize the partitions on this thread; the module's
+  // context is not thread-safe.
+  std::vector<SmallString<0>> Partitions;
+  SplitModule(
+      M, CodeGenPartitions,
+      [&](std::unique_ptr<Module> MPart) {
+        raw_svector_ostream BCOS(Partitions.emplace_back());
+        WriteBitcodeToFile(*MPart, BCOS);
+      },
+      /*PreserveLocals=*/true);
+
+  std::optional<uint64_t> LDT = codegen::getExplicitLargeDataThreshold();
+  std::vector<std::unique_ptr<ToolOutputFile>> RemarksFiles(Partitions.size());
+  std::vector<char> Failed(Partitions.size());
+  DefaultThreadPool Pool(hardware_concurrency(CodeGenPartitions));
+  for (unsigned I = 0, E = Partitions.size(); I != E; ++I) {
+    Pool.async([&, I]() {
+      LLVMContext Ctx;
+      Ctx.setDiscardValueNames(DiscardValueNames);
+      Ctx.setDiagnosticHandler(std::make_unique<LLCDiagnosticHandler>());
+      std::string RemarksName = RemarksFilename;
+      if (I != 0 && !RemarksName.empty())
+        RemarksName = (RemarksName + "." + Twine(I)).str();
+      Expected<std::unique_ptr<ToolOutputFile>> RemarksFileOrErr =
+          setupLLVMOptimizationRemarks(Ctx, RemarksName, RemarksPasses,
+                                       RemarksFormat, RemarksWithHotness,
+                                       RemarksHotnessThreshold);
+      if (Error E = RemarksFileOrErr.takeError())
+        reportError(std::move(E), RemarksName);
+      RemarksFiles[I] = std::move(*RemarksFileOrErr);
+
+      Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
+          MemoryBufferRef(Partitions[I].str(), "<split-module>"), Ctx);
+      if (!MOrErr)
+        reportError(MOrErr.takeError(), "<split-module>");
+      std::unique_ptr<Module> MPart = std::move(*MOrErr);
+
+      std::unique_ptr<TargetMachine> TM(TheTarget->createTargetMachine(
+          TheTriple.getTriple(), CPUStr, FeaturesStr, Options, RM, CM, OLvl));
+      assert(TM && "Could not allocate target machine!");
+      if (LDT)
+        TM->setLargeDataThreshold(*LDT);
+
+      legacy::PassManager PM;
+      PM.add(new TargetLibraryInfoWrapperPass(TLII));
+      if (TM->addPassesToEmitFile(PM, *OSs[I], nullptr,
+                                  codegen::getFileType(), NoVerify))
+        reportError("target does not support generation of this file type");
+      PM.run(*MPart);
+      Failed[I] = Ctx.getDiagHandlerPtr()->HasErrors;
+    });
+  }
+  Pool.wait();
+
+  if (llvm::is_contained(Failed, true))
+    return 1;
+
+  Out.keep();
+  for (auto &PartitionOut : PartitionOuts)
+    PartitionOut->keep();
+  for (auto &RemarksFile : RemarksFiles)
+    if (RemarksFile)
+      RemarksFile->keep();
+  return 0;
+}
+
 static int compileModule(char **argv, LLVMContext &Context) {
   // Load the module to be compiled...
   SMDiagnostic Err;
@@ -647,6 +773,18 @@ static int compileModule(char **argv, LLVMContext &Context) {
     WithColor::warning(errs(), argv[0])
         << ": warning: ignoring -mc-relax-all because filetype != obj";
 
+  if (CodeGenPartitions > 1) {
+    if (MIR) {
+      WithColor::error(errs(), argv[0])
+          << "-codegen-partitions does not support MIR input\n";
+      return 1;
+    }
+    return compileModulePartitioned(argv[0], *M, TheTarget, TheTriple, CPUStr,
+                                    FeaturesStr, Target->Options, RM,
+                                    Target->getCodeModel(), OLvl, TLII,
+                                    *Out);
+  }
+
   if (EnableNewPassManager || !PassPipeline.empty()) {
     return compileModuleWithNewPM(argv[0], std::move(M), std::move(MIR),
                                   std::move(Target), std::move(Out),
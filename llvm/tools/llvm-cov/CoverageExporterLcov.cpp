@@ -41,6 +41,8 @@
 
 #include "CoverageExporterLcov.h"
 #include "CoverageReport.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace llvm;
 
@@ -198,11 +200,47 @@ void renderFile(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
 void renderFiles(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
                  ArrayRef<std::string> SourceFiles,
                  ArrayRef<FileCoverageSummary> FileReports,
-                 bool ExportSummaryOnly, bool SkipFunctions,
-                 bool SkipBranches) {
-  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
-    renderFile(OS, Coverage, SourceFiles[I], FileReports[I], ExportSummaryOnly,
-               SkipFunctions, SkipBranches);
+                 const CoverageViewOptions &Options) {
+  ThreadPoolStrategy S = hardware_concurrency(Options.NumThreads);
+  if (Options.NumThreads == 0) {
+    // If NumThreads is not specified, create one thread for each input, up to
+    // the number of hardware cores.
+    S = heavyweight_hardware_concurrency(SourceFiles.size());
+    S.Limit = true;
+  }
+  unsigned ThreadCount = S.compute_thread_count();
+  if (ThreadCount <= 1 || SourceFiles.size() <= 1) {
+    for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
+      renderFile(OS, Coverage, SourceFiles[I], FileReports[I],
+                 Options.ExportSummaryOnly, Options.SkipFunctions,
+                 Options.SkipBranches);
+    return;
+  }
+
+  // Render the files in batches, each file into its own buffer, and write the
+  // buffers out in input order once the batch is done. The output is the same
+  // as when rendering serially, and only the coverage data and text of one
+  // batch of files is live at a time.
+  DefaultThreadPool Pool(S);
+  const size_t BatchSize = 4 * ThreadCount;
+  std::vector<std::string> Buffers(BatchSize);
+  for (size_t Begin = 0, E = SourceFiles.size(); Begin < E;
+       Begin += BatchSize) {
+    size_t End = std::min(Begin + BatchSize, E);
+    for (size_t I = Begin; I < End; ++I) {
+      Pool.async([&, I] {
+        std::string &Buffer = Buffers[I - Begin];
+        Buffer.clear();
+        raw_string_ostream BufferOS(Buffer);
+        renderFile(BufferOS, Coverage, SourceFiles[I], FileReports[I],
+                   Options.ExportSummaryOnly, Options.SkipFunctions,
+                   Options.SkipBranches);
+      });
+    }
+    Pool.wait();
+    for (size_t I = Begin; I < End; ++I)
+      OS << Buffers[I - Begin];
+  }
 }
 
 } // end anonymous namespace
@@ -220,6 +258,5 @@ void CoverageExporterLcov::renderRoot(ArrayRef<std::string> SourceFiles) {
   FileCoverageSummary Totals = FileCoverageSummary("Totals");
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
-  renderFiles(OS, Coverage, SourceFiles, FileReports, Options.ExportSummaryOnly,
-              Options.SkipFunctions, Options.SkipBranches);
+  renderFiles(OS, Coverage, SourceFiles, FileReports, Options);
 }
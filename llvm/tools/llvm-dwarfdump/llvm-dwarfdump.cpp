@@ -30,6 +30,7 @@
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/TargetSelect.h"
@@ -302,6 +303,11 @@ static opt<std::string> JsonErrSummaryFile(
     desc("Output JSON-formatted error summary to the specified file. "
          "(Implies --verify)"),
     value_desc("filename.json"), cat(DwarfDumpCategory));
+static opt<unsigned> VerifyThreads(
+    "verify-threads", init(1),
+    desc("Number of threads to verify units with (0 = all cores). Output is "
+         "reported in unit order."),
+    value_desc("n"), cat(DwarfDumpCategory));
 static opt<bool> Quiet("quiet", desc("Use with -verify to not emit to STDOUT."),
                        cat(DwarfDumpCategory));
 static opt<bool> DumpUUID("uuid", desc("Show the UUID for each architecture."),
@@ -771,11 +777,14 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
     Result = false;
     WithColor::defaultErrorHandler(std::move(E));
   };
+  // Units are only verified concurrently with a thread-safe context.
+  bool ThreadSafe = Verify && VerifyThreads != 1;
   if (auto *Obj = dyn_cast<ObjectFile>(BinOrErr->get())) {
     if (filterArch(*Obj)) {
       std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
           *Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
-          RecoverableErrorHandler);
+          RecoverableErrorHandler, WithColor::defaultWarningHandler,
+          ThreadSafe);
       DICtx->setParseCUTUIndexManually(ManuallyGenerateUnitIndex);
       if (!HandleObj(*Obj, *DICtx, Filename, OS))
         Result = false;
@@ -789,7 +798,8 @@ static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
         if (filterArch(Obj)) {
           std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(
               Obj, DWARFContext::ProcessDebugRelocations::Process, nullptr, "",
-              RecoverableErrorHandler);
+              RecoverableErrorHandler, WithColor::defaultWarningHandler,
+              ThreadSafe);
           if (!HandleObj(Obj, *DICtx, ObjName, OS))
             Result = false;
         }
@@ -847,6 +857,9 @@ int main(int argc, char **argv) {
     Verify = true;
   }
 
+  if (Verify && VerifyThreads != 1)
+    parallel::strategy = hardware_concurrency(VerifyThreads);
+
   std::error_code EC;
   ToolOutputFile OutputFile(OutputFilename, EC, sys::fs::OF_TextWithCRLF);
   error("unable to open output file " + OutputFilename, EC);
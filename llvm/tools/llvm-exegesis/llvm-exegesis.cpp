@@ -27,6 +27,7 @@
 #include "lib/TargetSelect.h"
 #include "lib/ValidationEvent.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/MC/MCInstBuilder.h"
 #include "llvm/MC/MCObjectFileInfo.h"
@@ -41,6 +42,7 @@
 #include "llvm/Support/Format.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/TargetParser/Host.h"
@@ -107,6 +109,13 @@ static cl::opt<Benchmark::RepetitionModeE> RepetitionMode(
                    "Middle half loop mode")),
     cl::init(Benchmark::Duplicate));
 
+static cl::opt<bool> ResumeBenchmarks(
+    "resume-benchmarks",
+    cl::desc("Keep the results already in --benchmarks-file, skip the "
+             "configurations they cover and append the remaining ones, so "
+             "that an interrupted run can be continued"),
+    cl::cat(BenchmarkOptions), cl::init(false));
+
 static cl::opt<bool> BenchmarkMeasurementsPrintProgress(
     "measurements-print-progress",
     cl::desc("Produce progress indicator when performing measurements"),
@@ -381,20 +390,81 @@ generateSnippets(const LLVMState &State, unsigned Opcode,
   return Benchmarks;
 }
 
+// Returns a string that identifies the measurement of a configuration on a
+// given CPU, used to find the configurations that were already measured when
+// resuming a run.
+static std::string getResumeKey(StringRef CpuName, Benchmark::ModeE Mode,
+                                const BenchmarkKey &Key) {
+  std::string Result;
+  raw_string_ostream OS(Result);
+  OS << CpuName << '\0' << static_cast<unsigned>(Mode) << '\0' << Key.Config;
+  for (const MCInst &Inst : Key.Instructions)
+    OS << '\0' << Inst;
+  return Result;
+}
+
+// Reads the benchmarks that were already written to BenchmarkFile and returns
+// their resume keys. A run that was interrupted while writing a result leaves
+// an incomplete document at the end of the file, which is removed so that the
+// results of the resumed run are appended after the last complete one.
+static StringSet<> readMeasuredConfigurations(const LLVMState &State) {
+  StringSet<> Measured;
+  if (!sys::fs::exists(BenchmarkFile))
+    return Measured;
+  auto Buffer = ExitOnFileError(
+      BenchmarkFile,
+      errorOrToExpected(MemoryBuffer::getFile(BenchmarkFile, /*IsText=*/true)));
+  // Every result written by Benchmark::writeYamlTo ends with "...".
+  StringRef Contents = Buffer->getBuffer();
+  size_t CompleteSize = 0;
+  for (StringRef EndMarker : {"\n...\n", "\n...\r\n"}) {
+    size_t Pos = Contents.rfind(EndMarker);
+    if (Pos != StringRef::npos)
+      CompleteSize = std::max(CompleteSize, Pos + EndMarker.size());
+  }
+  if (CompleteSize != Contents.size()) {
+    errs() << "llvm-exegesis: discarding an incomplete result at the end of "
+           << BenchmarkFile << '\n';
+    int FD;
+    ExitOnFileError(BenchmarkFile,
+                    errorCodeToError(sys::fs::openFileForReadWrite(
+                        BenchmarkFile, FD, sys::fs::CD_OpenExisting,
+                        sys::fs::OF_None)));
+    std::error_code EC = sys::fs::resize_file(FD, CompleteSize);
+    sys::Process::SafelyCloseFileDescriptor(FD);
+    ExitOnFileError(BenchmarkFile, errorCodeToError(EC));
+  }
+  std::vector<Benchmark> Benchmarks = ExitOnFileError(
+      BenchmarkFile,
+      Benchmark::readYamls(State,
+                           MemoryBufferRef(Contents.take_front(CompleteSize),
+                                           BenchmarkFile)));
+  for (const Benchmark &B : Benchmarks)
+    Measured.insert(getResumeKey(B.CpuName, B.Mode, B.Key));
+  return Measured;
+}
+
 static void runBenchmarkConfigurations(
     const LLVMState &State, ArrayRef<BenchmarkCode> Configurations,
     ArrayRef<std::unique_ptr<const SnippetRepetitor>> Repetitors,
     const BenchmarkRunner &Runner) {
   assert(!Configurations.empty() && "Don't have any configurations to run.");
+  StringSet<> Measured;
   std::optional<raw_fd_ostream> FileOstr;
   if (BenchmarkFile != "-") {
+    if (ResumeBenchmarks)
+      Measured = readMeasuredConfigurations(State);
     int ResultFD = 0;
-    // Create output file or open existing file and truncate it, once.
-    ExitOnErr(errorCodeToError(openFileForWrite(BenchmarkFile, ResultFD,
-                                                sys::fs::CD_CreateAlways,
-                                                sys::fs::OF_TextWithCRLF)));
+    // Create output file or open existing file and truncate it, once. When
+    // resuming, append to the results that are already there instead.
+    ExitOnErr(errorCodeToError(openFileForWrite(
+        BenchmarkFile, ResultFD,
+        ResumeBenchmarks ? sys::fs::CD_OpenAlways : sys::fs::CD_CreateAlways,
+        ResumeBenchmarks ? sys::fs::OF_TextWithCRLF | sys::fs::OF_Append
+                         : sys::fs::OF_TextWithCRLF)));
     FileOstr.emplace(ResultFD, true /*shouldClose*/);
   }
+  const std::string CpuName(State.getTargetMachine().getTargetCPU());
   raw_ostream &Ostr = FileOstr ? *FileOstr : outs();
 
   std::optional<ProgressMeter<>> Meter;
@@ -408,6 +478,9 @@ static void runBenchmarkConfigurations(
 
   for (const BenchmarkCode &Conf : Configurations) {
     ProgressMeter<>::ProgressMeterStep MeterStep(Meter ? &*Meter : nullptr);
+    if (!Measured.empty() &&
+        Measured.contains(getResumeKey(CpuName, BenchmarkMode, Conf.Key)))
+      continue;
     SmallVector<Benchmark, 2> AllResults;
 
     for (const std::unique_ptr<const SnippetRepetitor> &Repetitor :
@@ -452,10 +525,21 @@ static void runBenchmarkConfigurations(
       Result.Measurements.clear();
 
     ExitOnFileError(BenchmarkFile, Result.writeYamlTo(State, Ostr));
+    // Write every result out as soon as it exists, so that an interrupted run
+    // loses as little as possible and can be resumed.
+    Ostr.flush();
   }
 }
 
 void benchmarkMain() {
+  // Resuming reads the results back from the file, standard output can't be
+  // resumed.
+  if (ResumeBenchmarks && (BenchmarkFile.empty() || BenchmarkFile == "-")) {
+    ExitOnErr.setBanner("llvm-exegesis: ");
+    ExitWithError("--resume-benchmarks requires --benchmarks-file to be set "
+                  "to a file");
+  }
+
   if (BenchmarkPhaseSelector == BenchmarkPhaseSelectorE::Measure &&
       !UseDummyPerfCounters) {
 #ifndef HAVE_LIBPFM
@@ -22,6 +22,7 @@
 #include "llvm/Support/LLVMDriver.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/Signals.h"
@@ -152,6 +153,8 @@ static void parseArgs(int argc, char **argv) {
                    << "' value invalid for uint argument!\n";
       std::exit(1);
     }
+    if (NumThreads > 0)
+      llvm::parallel::strategy = llvm::hardware_concurrency(NumThreads);
   }
 
   if (const llvm::opt::Arg *A = Args.getLastArg(OPT_segment_size_EQ)) {
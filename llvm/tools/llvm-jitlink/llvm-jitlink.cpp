@@ -630,6 +630,13 @@ createSharedMemoryManager(SimpleRemoteEPC &SREPC) {
             rt::ExecutorSharedMemoryMapperServiceReleaseWrapperName}}))
     return std::move(Err);
 
+  // Batched initialization is optional: older executors don't provide it.
+  auto &BootstrapSymbols = SREPC.getBootstrapSymbolsMap();
+  auto I = BootstrapSymbols.find(
+      rt::ExecutorSharedMemoryMapperServiceInitializeBatchWrapperName);
+  if (I != BootstrapSymbols.end())
+    SAs.InitializeBatch = I->second;
+
 #ifdef _WIN32
   size_t SlabSize = 1024 * 1024;
 #else
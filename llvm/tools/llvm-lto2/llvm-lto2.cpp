@@ -25,6 +25,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/PluginLoader.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Threading.h"
@@ -56,6 +57,20 @@ static cl::opt<std::string> OutputFilename("o", cl::Required,
 static cl::opt<std::string> CacheDir("cache-dir", cl::desc("Cache Directory"),
                                      cl::value_desc("directory"));
 
+static cl::opt<bool> CacheKeyBodyHashes(
+    "cache-key-body-hashes",
+    cl::desc("Key cache entries on the summary hashes of imported definitions "
+             "rather than of whole modules"));
+
+static cl::opt<bool> CacheRegularLTOPartitions(
+    "cache-regular-lto-partitions",
+    cl::desc("Also cache the native objects of the regular LTO module"));
+
+static cl::opt<bool> StreamRegularLTOLinking(
+    "stream-regular-lto-linking",
+    cl::desc("Link regular LTO modules as soon as they are added, without "
+             "waiting for summary-based dead stripping"));
+
 static cl::opt<std::string> OptPipeline("opt-pipeline",
                                         cl::desc("Optimizer Pipeline"),
                                         cl::value_desc("pipeline"));
@@ -97,12 +112,28 @@ static cl::opt<bool>
                                 "specified with -thinlto-emit-indexes or "
                                 "-thinlto-distributed-indexes"));
 
+static cl::opt<std::string> ThinLTODistributor(
+    "thinlto-distributor",
+    cl::desc("Run the ThinLTO backend compiles by passing a JSON description "
+             "of them to this program instead of running them in-process"),
+    cl::value_desc("path"));
+
+static cl::list<std::string> ThinLTODistributorArgs(
+    "thinlto-distributor-arg",
+    cl::desc("An argument to pass to the -thinlto-distributor program"));
+
 // Default to using all available threads in the system, but using only one
 // thread per core (no SMT).
 // Use -thinlto-threads=all to use hardware_concurrency() instead, which means
 // to use all hardware threads or cores in the system.
 static cl::opt<std::string> Threads("thinlto-threads");
 
+static cl::opt<uint64_t> ThinLTOMemoryBudget(
+    "thinlto-memory-budget",
+    cl::desc("Only start ThinLTO backend jobs while their estimated memory use "
+             "stays within this many MiB"),
+    cl::init(0));
+
 static cl::list<std::string> SymbolResolutions(
     "r",
     cl::desc("Specify a symbol resolution: filename,symbolname,resolution\n"
@@ -291,6 +322,10 @@ static int run(int argc, char **argv) {
   Conf.CodeModel = codegen::getExplicitCodeModel();
 
   Conf.DebugPassManager = DebugPassManager;
+  Conf.CacheKeyUseBodyHashes = CacheKeyBodyHashes;
+  Conf.StreamRegularLTOLinking = StreamRegularLTOLinking;
+  Conf.CacheRegularLTOPartitions = CacheRegularLTOPartitions;
+  Conf.ThinLTOMemoryBudget = ThinLTOMemoryBudget << 20;
 
   if (SaveTemps && !SelectSaveTemps.empty()) {
     llvm::errs() << "-save-temps cannot be specified with -select-save-temps\n";
@@ -352,7 +387,13 @@ static int run(int argc, char **argv) {
                                             ThinLTOEmitImports,
                                             /*LinkedObjectsFile=*/nullptr,
                                             /*OnWrite=*/{});
-  else
+  else if (!ThinLTODistributor.empty()) {
+    StringRef WorkDir = sys::path::parent_path(OutputFilename);
+    Backend = createDistributedThinBackend(
+        createExternalThinBackendExecutor(ThinLTODistributor,
+                                          ThinLTODistributorArgs),
+        WorkDir.empty() ? "." : WorkDir.str());
+  } else
     Backend = createInProcessThinBackend(
         llvm::heavyweight_hardware_concurrency(Threads),
         /* OnWrite */ {}, ThinLTOEmitIndexes, ThinLTOEmitImports);
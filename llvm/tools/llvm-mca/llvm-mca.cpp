@@ -600,7 +600,7 @@ int main(int argc, char **argv) {
     if (Region->empty())
       continue;
 
-    IB.clear();
+    IB.clearRegionState();
 
     // Lower the MCInst sequence into an mca::Instruction sequence.
     ArrayRef<MCInst> Insts = Region->getInstructions();
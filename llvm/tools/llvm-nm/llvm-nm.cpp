@@ -46,6 +46,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
@@ -89,6 +90,13 @@ enum OutputFormatTy { bsd, sysv, posix, darwin, just_symbols };
 enum class BitModeTy { Bit32, Bit64, Bit32_64, Any };
 } // namespace
 
+// Owns the symbol names that can not be referenced directly from the object
+// file, such as versioned names or names synthesized from Mach-O dyld info.
+// Names are only copied here when needed so that dumping a large object does
+// not duplicate its whole string table.
+static BumpPtrAllocator NameAllocator;
+static StringSaver NameSaver(NameAllocator);
+
 static bool ArchiveMap;
 static BitModeTy BitMode;
 static bool DebugSyms;
@@ -219,7 +227,8 @@ struct NMSymbol {
   uint64_t Address;
   uint64_t Size;
   char TypeChar;
-  std::string Name;
+  // Points either into the object file's string table or into NameSaver.
+  StringRef Name;
   StringRef SectionName;
   StringRef TypeName;
   BasicSymbolRef Sym;
@@ -780,7 +789,7 @@ static void printSymbolList(SymbolicFile &Obj,
     if (!S.shouldPrint())
       continue;
 
-    std::string Name = S.Name;
+    std::string Name = S.Name.str();
     MachOObjectFile *MachO = dyn_cast<MachOObjectFile>(&Obj);
     if (Demangle)
       Name = demangle(Name);
@@ -862,6 +871,7 @@ static void printSymbolList(SymbolicFile &Obj,
   }
 
   SymbolList.clear();
+  NameAllocator.Reset();
 }
 
 static char getSymbolNMTypeChar(ELFObjectFileBase &Obj,
@@ -1276,7 +1286,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
         S.Address = Entry.address() + BaseSegmentAddress;
         S.Size = 0;
         S.TypeChar = '\0';
-        S.Name = Entry.name().str();
+        S.Name = NameSaver.save(Entry.name());
         // There is no symbol in the nlist symbol table for this so we set
         // Sym effectivly to null and the rest of code in here must test for
         // it and not do things like Sym.getFlags() for it.
@@ -1370,9 +1380,9 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
           U.Size = 0;
           U.TypeChar = 'U';
           if (Entry.otherName().empty())
-            U.Name = Entry.name().str();
+            U.Name = NameSaver.save(Entry.name());
           else
-            U.Name = Entry.otherName().str();
+            U.Name = NameSaver.save(Entry.otherName());
           // Again there is no symbol in the nlist symbol table for this so
           // we set Sym effectivly to null and the rest of code in here must
           // test for it and not do things like Sym.getFlags() for it.
@@ -1404,7 +1414,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       EOS.flush();
       const char *Q = ExportsNameBuffer.c_str();
       for (unsigned K = 0; K < ExportsAdded; K++) {
-        SymbolList[I].Name = Q;
+        SymbolList[I].Name = NameSaver.save(Q);
         Q += strlen(Q) + 1;
         if (SymbolList[I].TypeChar == 'I') {
           SymbolList[I].IndirectName = Q;
@@ -1443,7 +1453,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
         B.NSect = 0;
         B.NDesc = 0;
         MachO::SET_LIBRARY_ORDINAL(B.NDesc, Entry.ordinal());
-        B.Name = Entry.symbolName().str();
+        B.Name = NameSaver.save(Entry.symbolName());
         SymbolList.push_back(B);
         BOS << Entry.symbolName();
         BOS << '\0';
@@ -1457,7 +1467,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       BOS.flush();
       const char *Q = BindsNameBuffer.c_str();
       for (unsigned K = 0; K < BindsAdded; K++) {
-        SymbolList[I].Name = Q;
+        SymbolList[I].Name = NameSaver.save(Q);
         Q += strlen(Q) + 1;
         if (SymbolList[I].TypeChar == 'I') {
           SymbolList[I].IndirectName = Q;
@@ -1488,7 +1498,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       if (!found) {
         LastSymbolName = Entry.symbolName();
         NMSymbol L = {};
-        L.Name = Entry.symbolName().str();
+        L.Name = NameSaver.save(Entry.symbolName());
         L.Address = 0;
         L.Size = 0;
         L.TypeChar = 'U';
@@ -1516,7 +1526,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       LOS.flush();
       const char *Q = LazysNameBuffer.c_str();
       for (unsigned K = 0; K < LazysAdded; K++) {
-        SymbolList[I].Name = Q;
+        SymbolList[I].Name = NameSaver.save(Q);
         Q += strlen(Q) + 1;
         if (SymbolList[I].TypeChar == 'I') {
           SymbolList[I].IndirectName = Q;
@@ -1549,7 +1559,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       if (!found) {
         LastSymbolName = Entry.symbolName();
         NMSymbol W = {};
-        W.Name = Entry.symbolName().str();
+        W.Name = NameSaver.save(Entry.symbolName());
         W.Address = 0;
         W.Size = 0;
         W.TypeChar = 'U';
@@ -1584,7 +1594,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       WOS.flush();
       const char *Q = WeaksNameBuffer.c_str();
       for (unsigned K = 0; K < WeaksAdded; K++) {
-        SymbolList[I].Name = Q;
+        SymbolList[I].Name = NameSaver.save(Q);
         Q += strlen(Q) + 1;
         if (SymbolList[I].TypeChar == 'I') {
           SymbolList[I].IndirectName = Q;
@@ -1672,7 +1682,7 @@ static void dumpSymbolsFromDLInfoMachO(MachOObjectFile &MachO,
       FOS.flush();
       const char *Q = FunctionStartsNameBuffer.c_str();
       for (unsigned K = 0; K < FunctionStartsAdded; K++) {
-        SymbolList[I].Name = Q;
+        SymbolList[I].Name = NameSaver.save(Q);
         Q += strlen(Q) + 1;
         if (SymbolList[I].TypeChar == 'I') {
           SymbolList[I].IndirectName = Q;
@@ -1757,7 +1767,7 @@ static void getXCOFFExports(XCOFFObjectFile *XCOFFObj,
       SymName = SymName.substr(14);
 
     NMSymbol S = {};
-    S.Name = SymName.str();
+    S.Name = NameSaver.save(SymName);
     S.Sym = Sym;
 
     if (HasVisibilityAttr) {
@@ -1869,17 +1879,35 @@ static bool getSymbolNamesFromObject(SymbolicFile &Obj,
       S.TypeName = getNMTypeName(Obj, Sym);
       S.TypeChar = getNMSectionTagAndName(Obj, Sym, S.SectionName);
 
-      raw_string_ostream OS(S.Name);
-      if (Error E = Sym.printName(OS)) {
-        if (MachO) {
-          OS << "bad string index";
-          consumeError(std::move(E));
+      bool HasVersion =
+          !SymbolVersions.empty() && !SymbolVersions[I].Name.empty();
+      const auto *ObjFile = dyn_cast<ObjectFile>(&Obj);
+      if (ObjFile && !HasVersion && !ExportSymbols) {
+        // Object file symbol names live in the (mapped) file itself, which
+        // outlives the symbol list, so refer to them without copying.
+        Expected<StringRef> NameOrErr = SymbolRef(Sym).getName();
+        if (NameOrErr) {
+          S.Name = *NameOrErr;
+        } else if (MachO) {
+          S.Name = "bad string index";
+          consumeError(NameOrErr.takeError());
         } else
-          error(std::move(E), Obj.getFileName());
+          error(NameOrErr.takeError(), Obj.getFileName());
+      } else {
+        SmallString<128> NameBuf;
+        raw_svector_ostream OS(NameBuf);
+        if (Error E = Sym.printName(OS)) {
+          if (MachO) {
+            OS << "bad string index";
+            consumeError(std::move(E));
+          } else
+            error(std::move(E), Obj.getFileName());
+        }
+        if (HasVersion)
+          OS << (SymbolVersions[I].IsVerDef ? "@@" : "@")
+             << SymbolVersions[I].Name;
+        S.Name = NameSaver.save(NameBuf.str());
       }
-      if (!SymbolVersions.empty() && !SymbolVersions[I].Name.empty())
-        S.Name +=
-            (SymbolVersions[I].IsVerDef ? "@@" : "@") + SymbolVersions[I].Name;
 
       S.Sym = Sym;
       if (S.initializeFlags(Obj))
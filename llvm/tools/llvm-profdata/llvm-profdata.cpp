@@ -13,6 +13,7 @@
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/ProfileData/InstrProfCorrelator.h"
@@ -250,6 +251,12 @@ cl::opt<std::string> FuncNameNegativeFilter(
     "no-function", cl::init(""),
     cl::sub(MergeSubcommand),
     cl::desc("Exclude functions matching the filter from the output."));
+cl::opt<std::string> FuncListFilename(
+    "function-list", cl::init(""), cl::sub(MergeSubcommand),
+    cl::desc("Only keep the functions named in the given file, one name per "
+             "line. This emits a slice of the profile holding, e.g., only the "
+             "functions of one module, which is much cheaper for the compiler "
+             "to load than the full profile."));
 
 cl::opt<FailureMode>
     FailMode("failure-mode", cl::init(failIfAnyAreInvalid),
@@ -800,6 +807,15 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   }
 }
 
+/// Report a writer error once per error code.
+static void warnWriterError(WriterContext *WC, Error E) {
+  auto [ErrorCode, Msg] = InstrProfError::take(std::move(E));
+  std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
+  bool firstTime = WC->WriterErrorCodes.insert(ErrorCode).second;
+  if (firstTime)
+    warn(toString(make_error<InstrProfError>(ErrorCode, Msg)));
+}
+
 /// Merge the \p Src writer context into \p Dst.
 static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   for (auto &ErrorPair : Src->Errors)
@@ -810,14 +826,21 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
     exitWithError(std::move(E));
 
   Dst->Writer.mergeRecordsFromWriter(std::move(Src->Writer), [&](Error E) {
-    auto [ErrorCode, Msg] = InstrProfError::take(std::move(E));
-    std::unique_lock<std::mutex> ErrGuard{Dst->ErrLock};
-    bool firstTime = Dst->WriterErrorCodes.insert(ErrorCode).second;
-    if (firstTime)
-      warn(toString(make_error<InstrProfError>(ErrorCode, Msg)));
+    warnWriterError(Dst, std::move(E));
   });
 }
 
+/// Merge the function records in shard \p Shard of \p NumShards of every
+/// context in \p Srcs into \p Dst.
+static void mergeFunctionShard(WriterContext *Dst,
+                               ArrayRef<std::unique_ptr<WriterContext>> Srcs,
+                               unsigned Shard, unsigned NumShards) {
+  for (const std::unique_ptr<WriterContext> &Src : Srcs)
+    Dst->Writer.mergeFunctionShardFromWriter(
+        Src->Writer, Shard, NumShards,
+        [&](Error E) { warnWriterError(Dst, std::move(E)); });
+}
+
 static StringRef
 getFuncName(const StringMap<InstrProfWriter::ProfilingData>::value_type &Val) {
   return Val.first();
@@ -832,9 +855,26 @@ template <typename T>
 static void filterFunctions(T &ProfileMap) {
   bool hasFilter = !FuncNameFilter.empty();
   bool hasNegativeFilter = !FuncNameNegativeFilter.empty();
-  if (!hasFilter && !hasNegativeFilter)
+  bool hasListFilter = !FuncListFilename.empty();
+  if (!hasFilter && !hasNegativeFilter && !hasListFilter)
     return;
 
+  // Names given with -function-list. MD5 profiles are matched by the hash of
+  // the listed names.
+  StringSet<> ListedNames;
+  if (hasListFilter) {
+    auto BufOrError = MemoryBuffer::getFileOrSTDIN(FuncListFilename);
+    if (!BufOrError)
+      exitWithErrorCode(BufOrError.getError(), FuncListFilename);
+    for (line_iterator LineIt(**BufOrError, /*SkipBlanks=*/true, '#');
+         !LineIt.is_at_eof(); ++LineIt) {
+      StringRef Name = LineIt->trim();
+      ListedNames.insert(Name);
+      if (FunctionSamples::UseMD5)
+        ListedNames.insert(std::to_string(llvm::MD5Hash(Name)));
+    }
+  }
+
   // If filter starts with '?' it is MSVC mangled name, not a regex.
   llvm::Regex ProbablyMSVCMangledName("[?@$_0-9A-Za-z]+");
   if (hasFilter && FuncNameFilter[0] == '?' &&
@@ -866,7 +906,8 @@ static void filterFunctions(T &ProfileMap) {
          (NegativePattern.match(FuncName) ||
           (FunctionSamples::UseMD5 && NegativeMD5Name == FuncName))) ||
         (hasFilter && !(Pattern.match(FuncName) ||
-                        (FunctionSamples::UseMD5 && MD5Name == FuncName))))
+                        (FunctionSamples::UseMD5 && MD5Name == FuncName))) ||
+        (hasListFilter && !ListedNames.contains(FuncName)))
       ProfileMap.erase(Tmp);
   }
 
@@ -961,7 +1002,24 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
     }
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
+    // Merge the function records, which make up the bulk of the data, by
+    // partitioning them on the function name hash. Every shard is merged by a
+    // single task, so the records are moved into place without copies or
+    // locking instead of being funneled through lg(NumThreads) merge steps.
+    unsigned NumShards = NumThreads;
+    SmallVector<std::unique_ptr<WriterContext>, 4> Shards;
+    for (unsigned I = 0; I < NumShards; ++I) {
+      Shards.emplace_back(std::make_unique<WriterContext>(
+          OutputSparse, ErrorLock, WriterErrorCodes));
+      Pool.async(mergeFunctionShard, Shards[I].get(), ArrayRef(Contexts), I,
+                 NumShards);
+    }
+    Pool.wait();
+    for (std::unique_ptr<WriterContext> &WC : Contexts)
+      WC->Writer.getProfileData().clear();
+
+    // Merge the rest of the writer contexts together (~ lg(NumThreads) serial
+    // steps).
     unsigned Mid = Contexts.size() / 2;
     unsigned End = Contexts.size();
     assert(Mid > 0 && "Expected more than one context");
@@ -978,6 +1036,12 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
       End = Mid;
       Mid /= 2;
     } while (Mid > 0);
+
+    // The shards hold disjoint sets of functions, so this only moves them.
+    for (std::unique_ptr<WriterContext> &Shard : Shards)
+      Contexts[0]->Writer.mergeFunctionShardFromWriter(
+          Shard->Writer, 0, 1,
+          [&](Error E) { warnWriterError(Contexts[0].get(), std::move(E)); });
   }
 
   // Handle deferred errors encountered during merging. If the number of errors
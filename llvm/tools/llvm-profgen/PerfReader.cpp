@@ -11,6 +11,8 @@
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 
 #define DEBUG_TYPE "perf-reader"
@@ -42,6 +44,11 @@ static cl::opt<bool>
 cl::opt<bool> ShowDetailedWarning("show-detailed-warning",
                                   cl::desc("Show detailed warning message."));
 
+static cl::opt<unsigned> UnwindThreads(
+    "unwind-threads", cl::init(1),
+    cl::desc("Number of threads used to unwind hybrid samples. Only takes "
+             "effect for binaries with pseudo probes (default: 1)."));
+
 extern cl::opt<std::string> PerfTraceFilename;
 extern cl::opt<bool> ShowDisassemblyOnly;
 extern cl::opt<bool> ShowSourceLocations;
@@ -515,11 +522,66 @@ static std::string getContextKeyStr(ContextKey *K,
   }
 }
 
+void VirtualUnwinder::mergeStats(const VirtualUnwinder &Other) {
+  NumTotalBranches += Other.NumTotalBranches;
+  NumExtCallBranch += Other.NumExtCallBranch;
+  NumMissingExternalFrame += Other.NumMissingExternalFrame;
+  NumMismatchedProEpiBranch += Other.NumMismatchedProEpiBranch;
+  NumMismatchedExtCallBranch += Other.NumMismatchedExtCallBranch;
+  NumUnpairedExtAddr += Other.NumUnpairedExtAddr;
+  NumPairedExtAddr += Other.NumPairedExtAddr;
+  UntrackedCallsites.insert(Other.UntrackedCallsites.begin(),
+                            Other.UntrackedCallsites.end());
+}
+
+void HybridPerfReader::unwindSamplesInParallel(VirtualUnwinder &Unwinder) {
+  std::vector<const AggregatedCounter::value_type *> Samples;
+  Samples.reserve(AggregatedSamples.size());
+  for (const auto &Item : AggregatedSamples)
+    Samples.push_back(&Item);
+
+  unsigned NumChunks = std::min<size_t>(UnwindThreads, Samples.size());
+  std::vector<ContextSampleCounterMap> Counters(NumChunks);
+  std::vector<VirtualUnwinder> Unwinders;
+  Unwinders.reserve(NumChunks);
+  for (unsigned I = 0; I < NumChunks; ++I)
+    Unwinders.emplace_back(&Counters[I], Binary);
+
+  {
+    DefaultThreadPool Pool(hardware_concurrency(NumChunks));
+    for (unsigned I = 0; I < NumChunks; ++I) {
+      Pool.async([&, I] {
+        size_t Begin = Samples.size() * I / NumChunks;
+        size_t End = Samples.size() * (I + 1) / NumChunks;
+        for (size_t J = Begin; J < End; ++J)
+          Unwinders[I].unwind(Samples[J]->first.getPtr(), Samples[J]->second);
+      });
+    }
+    Pool.wait();
+  }
+
+  for (unsigned I = 0; I < NumChunks; ++I) {
+    Unwinder.mergeStats(Unwinders[I]);
+    for (auto &[Key, Counter] : Counters[I]) {
+      auto [It, Inserted] = SampleCounters.try_emplace(Key, std::move(Counter));
+      if (!Inserted)
+        It->second.merge(Counter);
+    }
+    Counters[I].clear();
+  }
+}
+
 void HybridPerfReader::unwindSamples() {
   VirtualUnwinder Unwinder(&SampleCounters, Binary);
-  for (const auto &Item : AggregatedSamples) {
-    const PerfSample *Sample = Item.first.getPtr();
-    Unwinder.unwind(Sample, Item.second);
+  // With pseudo probes the unwinder only reads precomputed binary state; the
+  // DWARF path symbolizes through caches that are not thread safe.
+  if (UnwindThreads > 1 && Binary->usePseudoProbes()) {
+    unwindSamplesInParallel(Unwinder);
+  } else {
+    for (const auto &Item : AggregatedSamples) {
+      const PerfSample *Sample = Item.first.getPtr();
+      Unwinder.unwind(Sample, Item.second);
+    }
   }
 
   // Warn about untracked frames due to missing probes.
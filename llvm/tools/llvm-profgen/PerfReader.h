@@ -409,6 +409,12 @@ struct SampleCounter {
   void recordBranchCount(uint64_t Source, uint64_t Target, uint64_t Repeat) {
     BranchCounter[{Source, Target}] += Repeat;
   }
+  void merge(const SampleCounter &Other) {
+    for (const auto &[Range, Count] : Other.RangeCounter)
+      RangeCounter[Range] += Count;
+    for (const auto &[Branch, Count] : Other.BranchCounter)
+      BranchCounter[Branch] += Count;
+  }
 };
 
 // Sample counter with context to support context-sensitive profile
@@ -477,6 +483,8 @@ public:
       : CtxCounterMap(Counter), Binary(B) {}
   bool unwind(const PerfSample *Sample, uint64_t Repeat);
   std::set<uint64_t> &getUntrackedCallsites() { return UntrackedCallsites; }
+  // Accumulate the statistics of an unwinder that ran on other samples.
+  void mergeStats(const VirtualUnwinder &Other);
 
   uint64_t NumTotalBranches = 0;
   uint64_t NumExtCallBranch = 0;
@@ -708,6 +716,9 @@ public:
 private:
   // Unwind the hybrid samples after aggregration
   void unwindSamples();
+  // Unwind the samples with one unwinder and counter map per thread, and merge
+  // the results into SampleCounters.
+  void unwindSamplesInParallel(VirtualUnwinder &Unwinder);
 };
 
 /*
@@ -189,21 +189,19 @@ void ArgumentCounter::collect(const Remark &Remark) {
   // Early return if we don't have a value
   if (!GroupByKey)
     return;
-  auto GroupVal = *GroupByKey;
-  CountByKeysMap.insert({GroupVal, Row});
-  for (auto [Key, Idx] : ArgumentSetIdxMap) {
-    auto Count = getValForKey(Key, Remark);
-    CountByKeysMap[GroupVal][Idx] += Count;
-  }
+  // Look the group up once rather than once per argument key.
+  SmallVectorImpl<unsigned> &Counts =
+      CountByKeysMap.try_emplace(std::move(*GroupByKey), std::move(Row))
+          .first->second;
+  for (auto [Key, Idx] : ArgumentSetIdxMap)
+    Counts[Idx] += getValForKey(Key, Remark);
 }
 
 void RemarkCounter::collect(const Remark &Remark) {
   std::optional<std::string> Key = getGroupByKey(Remark);
   if (!Key.has_value())
     return;
-  auto Iter = CountedByRemarksMap.insert({*Key, 1});
-  if (!Iter.second)
-    Iter.first->second += 1;
+  ++CountedByRemarksMap[std::move(*Key)];
 }
 
 Error ArgumentCounter::print(StringRef OutputFileName) {
@@ -259,6 +259,45 @@ TEST(ConcurrentHashTableTest, AddStringEntriesParallel) {
               std::string::npos);
 }
 
+TEST(ConcurrentHashTableTest, FindStringEntriesParallel) {
+  PerThreadBumpPtrAllocator Allocator;
+  const size_t NumElements = 20000;
+  ConcurrentHashTableByPtr<std::string, String, PerThreadBumpPtrAllocator,
+                           ConcurrentHashTableInfoByPtr<
+                               std::string, String, PerThreadBumpPtrAllocator>>
+      HashTable(Allocator, 100);
+
+  // Insert the even elements while looking up all of them.
+  parallelFor(0, NumElements, [&](size_t I) {
+    std::string StringForElement = formatv("{0}", I);
+    if (I % 2 == 0) {
+      std::pair<String *, bool> Entry = HashTable.insert(StringForElement);
+      EXPECT_TRUE(Entry.second);
+      EXPECT_EQ(HashTable.find(StringForElement), Entry.first);
+    } else {
+      EXPECT_EQ(HashTable.find(StringForElement), nullptr);
+    }
+  });
+
+  // Check that lookups find exactly the inserted elements and do not
+  // allocate.
+  parallelFor(0, NumElements, [&](size_t I) {
+    BumpPtrAllocator &ThreadLocalAllocator =
+        Allocator.getThreadLocalAllocator();
+    size_t AllocatedBytesAtStart = ThreadLocalAllocator.getBytesAllocated();
+    std::string StringForElement = formatv("{0}", I);
+    String *Entry = HashTable.find(StringForElement);
+    if (I % 2 == 0) {
+      ASSERT_NE(Entry, nullptr);
+      EXPECT_TRUE(Entry->getKey() == StringForElement);
+    } else {
+      EXPECT_EQ(Entry, nullptr);
+    }
+    EXPECT_TRUE(ThreadLocalAllocator.getBytesAllocated() ==
+                AllocatedBytesAtStart);
+  });
+}
+
 TEST(ConcurrentHashTableTest, AddStringEntriesParallelWithResize) {
   PerThreadBumpPtrAllocator Allocator;
   const size_t NumElements = 20000;
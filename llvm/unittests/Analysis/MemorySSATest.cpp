@@ -784,6 +784,36 @@ TEST_F(MemorySSATest, WalkerInvariantLoadOpt) {
   EXPECT_EQ(LoadClobber, MSSA.getLiveOnEntryDef());
 }
 
+TEST_F(MemorySSATest, WalkerBatchedClobbers) {
+  F = Function::Create(FunctionType::get(B.getVoidTy(), {}, false),
+                       GlobalValue::ExternalLinkage, "F", &M);
+  B.SetInsertPoint(BasicBlock::Create(C, "", F));
+  Type *Int8 = Type::getInt8Ty(C);
+  Constant *One = ConstantInt::get(Int8, 1);
+  Value *AllocA = B.CreateAlloca(Int8, One, "a");
+  Value *AllocB = B.CreateAlloca(Int8, One, "b");
+
+  Instruction *StoreA = B.CreateStore(One, AllocA);
+  Instruction *StoreB = B.CreateStore(One, AllocB);
+  Instruction *LoadA = B.CreateLoad(Int8, AllocA);
+  Instruction *LoadB = B.CreateLoad(Int8, AllocB);
+
+  setupAnalyses();
+  MemorySSA &MSSA = *Analyses->MSSA;
+  MemorySSAWalker *Walker = Analyses->Walker;
+
+  SmallVector<MemoryAccess *, 4> Clobbers;
+  BatchAAResults BAA(Analyses->AA);
+  Walker->getClobberingMemoryAccesses(
+      {MSSA.getMemoryAccess(LoadA), MSSA.getMemoryAccess(LoadB),
+       MSSA.getMemoryAccess(StoreB)},
+      Clobbers, BAA);
+  ASSERT_EQ(Clobbers.size(), 3u);
+  EXPECT_EQ(Clobbers[0], MSSA.getMemoryAccess(StoreA));
+  EXPECT_EQ(Clobbers[1], MSSA.getMemoryAccess(StoreB));
+  EXPECT_EQ(Clobbers[2], MSSA.getLiveOnEntryDef());
+}
+
 // Test loads get reoptimized properly by the walker.
 TEST_F(MemorySSATest, WalkerReopt) {
   F = Function::Create(FunctionType::get(B.getVoidTy(), {}, false),
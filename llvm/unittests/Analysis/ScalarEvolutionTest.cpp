@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/LoopInfo.h"
@@ -21,6 +22,7 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
 
@@ -1589,4 +1591,44 @@ TEST_F(ScalarEvolutionsTest, ApplyLoopGuards) {
   });
 }
 
+TEST_F(ScalarEvolutionsTest, NodeMemoryBudget) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define i32 @f(i32 %a, i32 %b) { "
+      "entry: "
+      "  %add = add i32 %a, %b "
+      "  ret i32 %add "
+      "dead: "
+      "  %dead.add = add i32 %a, 1 "
+      "  ret i32 %dead.add "
+      "} ",
+      Err, C);
+  ASSERT_TRUE(M && "Could not parse module?");
+
+  auto *Opt = static_cast<cl::opt<unsigned> *>(
+      cl::getRegisteredOptions()["scalar-evolution-max-node-memory"]);
+  ASSERT_NE(Opt, nullptr);
+  Opt->setValue(1);
+  auto ResetOpt = make_scope_exit([&] { Opt->setValue(0); });
+
+  runWithSE(*M, "f", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    // Allocate well over 1 MiB of SCEV nodes.
+    Type *I64 = Type::getInt64Ty(C);
+    for (uint64_t I = 0; I != 100000; ++I)
+      SE.getConstant(I64, I);
+
+    Instruction *Add = getInstructionByName(F, "add");
+    EXPECT_EQ(SE.getSCEV(Add), SE.getUnknown(Add));
+
+    // Constants are still folded.
+    EXPECT_TRUE(isa<SCEVConstant>(SE.getSCEV(ConstantInt::get(I64, 42))));
+
+    // Unreachable instructions are still poison.
+    Instruction *DeadAdd = getInstructionByName(F, "dead.add");
+    EXPECT_EQ(SE.getSCEV(DeadAdd),
+              SE.getUnknown(PoisonValue::get(DeadAdd->getType())));
+  });
+}
+
 }  // end namespace llvm
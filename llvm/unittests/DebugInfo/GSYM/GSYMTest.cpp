@@ -15,6 +15,7 @@
 #include "llvm/DebugInfo/GSYM/FileWriter.h"
 #include "llvm/DebugInfo/GSYM/FunctionInfo.h"
 #include "llvm/DebugInfo/GSYM/GsymCreator.h"
+#include "llvm/DebugInfo/GSYM/GsymDIContext.h"
 #include "llvm/DebugInfo/GSYM/GsymReader.h"
 #include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/InlineInfo.h"
@@ -1280,6 +1281,70 @@ TEST(GSYMTest, TestGsymLookups) {
     testing::ElementsAre(SourceLocation{"main", "/tmp", "main.c", 8, 32}));
 }
 
+TEST(GSYMTest, TestGsymDIContext) {
+  // Verify that GsymDIContext turns GSYM lookups into DIContext answers.
+  GsymCreator GC;
+  FunctionInfo FI(0x1000, 0x100, GC.insertString("main"));
+  FI.OptLineTable = LineTable();
+  const uint32_t MainFileIndex = GC.insertFile("/tmp/main.c");
+  const uint32_t FooFileIndex = GC.insertFile("/tmp/foo.h");
+  FI.OptLineTable->push(LineEntry(0x1000, MainFileIndex, 5));
+  FI.OptLineTable->push(LineEntry(0x1010, FooFileIndex, 10));
+  FI.OptLineTable->push(LineEntry(0x1020, MainFileIndex, 8));
+  FI.Inline = InlineInfo();
+  FI.Inline->Name = GC.insertString("inline1");
+  FI.Inline->CallFile = MainFileIndex;
+  FI.Inline->CallLine = 6;
+  FI.Inline->Ranges.insert(AddressRange(0x1010, 0x1020));
+  GC.addFunctionInfo(std::move(FI));
+  OutputAggregator Null(nullptr);
+  Error FinalizeErr = GC.finalize(Null);
+  ASSERT_FALSE(FinalizeErr);
+  SmallString<512> Str;
+  raw_svector_ostream OutStrm(Str);
+  FileWriter FW(OutStrm, llvm::endianness::native);
+  llvm::Error Err = GC.encode(FW);
+  ASSERT_FALSE((bool)Err);
+  Expected<GsymReader> GR = GsymReader::copyBuffer(OutStrm.str());
+  ASSERT_TRUE(bool(GR));
+  GsymDIContext Ctx(std::make_unique<GsymReader>(std::move(*GR)));
+
+  DILineInfoSpecifier Spec(
+      DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath,
+      DINameKind::LinkageName);
+  DILineInfo LI = Ctx.getLineInfoForAddress({0x1000}, Spec);
+  EXPECT_EQ(LI.FunctionName, "main");
+  EXPECT_EQ(LI.FileName, "/tmp/main.c");
+  EXPECT_EQ(LI.Line, 5u);
+  EXPECT_EQ(LI.StartAddress, 0x1000u);
+
+  LI = Ctx.getLineInfoForAddress({0x1010}, Spec);
+  EXPECT_EQ(LI.FunctionName, "inline1");
+  EXPECT_EQ(LI.FileName, "/tmp/foo.h");
+  EXPECT_EQ(LI.Line, 10u);
+
+  DIInliningInfo II = Ctx.getInliningInfoForAddress({0x1010}, Spec);
+  ASSERT_EQ(II.getNumberOfFrames(), 2u);
+  EXPECT_EQ(II.getFrame(0).FunctionName, "inline1");
+  EXPECT_EQ(II.getFrame(0).Line, 10u);
+  EXPECT_EQ(II.getFrame(1).FunctionName, "main");
+  EXPECT_EQ(II.getFrame(1).FileName, "/tmp/main.c");
+  EXPECT_EQ(II.getFrame(1).Line, 6u);
+
+  DILineInfoSpecifier BaseNameSpec(
+      DILineInfoSpecifier::FileLineInfoKind::BaseNameOnly, DINameKind::None);
+  LI = Ctx.getLineInfoForAddress({0x1020}, BaseNameSpec);
+  EXPECT_EQ(LI.FunctionName, DILineInfo::BadString);
+  EXPECT_EQ(LI.FileName, "main.c");
+  EXPECT_EQ(LI.Line, 8u);
+
+  // Addresses outside of any function have no information.
+  LI = Ctx.getLineInfoForAddress({0x2000}, Spec);
+  EXPECT_EQ(LI.FunctionName, DILineInfo::BadString);
+  EXPECT_EQ(LI.Line, 0u);
+  EXPECT_EQ(Ctx.getInliningInfoForAddress({0x2000}, Spec).getNumberOfFrames(),
+            0u);
+}
 
 TEST(GSYMTest, TestDWARFFunctionWithAddresses) {
   // Create a single compile unit with a single function and make sure it gets
@@ -0,0 +1,89 @@
+//===- OnDiskObjectCacheTest.cpp - Unit tests for OnDiskObjectCache -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/OnDiskObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Testing/Support/Error.h"
+#include "llvm/Testing/Support/SupportHelpers.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+using llvm::unittest::TempDir;
+
+namespace {
+
+class OnDiskObjectCacheTest : public testing::Test {
+protected:
+  std::unique_ptr<OnDiskObjectCache>
+  createCache(const JITTargetMachineBuilder &JTMB, StringRef ExtraKey = "") {
+    auto Cache = OnDiskObjectCache::Create(Dir.path(), JTMB, ExtraKey);
+    EXPECT_THAT_EXPECTED(Cache, Succeeded());
+    return Cache ? std::move(*Cache) : nullptr;
+  }
+
+  TempDir Dir{"orc-object-cache", /*Unique=*/true};
+  LLVMContext Ctx;
+  Module M{"test", Ctx};
+  JITTargetMachineBuilder JTMB{Triple("x86_64-unknown-linux-gnu")};
+};
+
+TEST_F(OnDiskObjectCacheTest, StoreAndReuse) {
+  auto Cache = createCache(JTMB);
+  ASSERT_TRUE(Cache);
+  EXPECT_EQ(Cache->getObject(&M), nullptr);
+
+  auto Obj = MemoryBuffer::getMemBuffer("object");
+  Cache->notifyObjectCompiled(&M, Obj->getMemBufferRef());
+
+  // A new cache on the same directory, e.g. in a later session, finds it.
+  auto Cache2 = createCache(JTMB);
+  ASSERT_TRUE(Cache2);
+  std::unique_ptr<MemoryBuffer> Cached = Cache2->getObject(&M);
+  ASSERT_NE(Cached, nullptr);
+  EXPECT_EQ(Cached->getBuffer(), "object");
+}
+
+TEST_F(OnDiskObjectCacheTest, TargetOptionsAreKeyed) {
+  auto Cache = createCache(JTMB);
+  ASSERT_TRUE(Cache);
+  EXPECT_EQ(Cache->getObject(&M), nullptr);
+  auto Obj = MemoryBuffer::getMemBuffer("object");
+  Cache->notifyObjectCompiled(&M, Obj->getMemBufferRef());
+
+  auto ExpectMiss = [&](const JITTargetMachineBuilder &Other) {
+    auto OtherCache = createCache(Other);
+    ASSERT_TRUE(OtherCache);
+    EXPECT_EQ(OtherCache->getObject(&M), nullptr);
+  };
+
+  JITTargetMachineBuilder EmulatedTLS = JTMB;
+  EmulatedTLS.getOptions().EmulatedTLS = !JTMB.getOptions().EmulatedTLS;
+  ExpectMiss(EmulatedTLS);
+
+  JITTargetMachineBuilder FloatABI = JTMB;
+  FloatABI.getOptions().FloatABIType = FloatABI::Hard;
+  ExpectMiss(FloatABI);
+
+  JITTargetMachineBuilder Exceptions = JTMB;
+  Exceptions.getOptions().ExceptionModel = ExceptionHandling::SjLj;
+  ExpectMiss(Exceptions);
+
+  JITTargetMachineBuilder OptLevel = JTMB;
+  OptLevel.setCodeGenOptLevel(CodeGenOptLevel::Aggressive);
+  ExpectMiss(OptLevel);
+
+  auto ExtraKeyCache = createCache(JTMB, "extra");
+  ASSERT_TRUE(ExtraKeyCache);
+  EXPECT_EQ(ExtraKeyCache->getObject(&M), nullptr);
+}
+
+} // namespace
@@ -130,4 +130,45 @@ TEST(SharedMemoryMapperTest, MemReserveInitializeDeinitializeRelease) {
   cantFail(SelfEPC->disconnect());
 }
 
+TEST(SharedMemoryMapperTest, InitializeBatch) {
+  int InitializeCounter = 0;
+  int DeinitializeCounter = 0;
+
+  ExecutorSharedMemoryMapperService MapperService;
+
+  auto PageSize = cantFail(sys::Process::getPageSize());
+  auto Reservation = cantFail(MapperService.reserve(2 * PageSize));
+  ExecutorAddr ReservationAddr = Reservation.first;
+
+  std::vector<std::pair<ExecutorAddr, tpctypes::SharedMemoryFinalizeRequest>>
+      Requests;
+  for (unsigned I = 0; I != 2; ++I) {
+    tpctypes::SharedMemoryFinalizeRequest FR;
+    FR.Segments.push_back({{MemProt::Read | MemProt::Write, false},
+                           ReservationAddr + I * PageSize,
+                           static_cast<uint64_t>(PageSize)});
+    FR.Actions.push_back(
+        {cantFail(WrapperFunctionCall::Create<SPSArgList<SPSExecutorAddr>>(
+             ExecutorAddr::fromPtr(incrementWrapper),
+             ExecutorAddr::fromPtr(&InitializeCounter))),
+         cantFail(WrapperFunctionCall::Create<SPSArgList<SPSExecutorAddr>>(
+             ExecutorAddr::fromPtr(incrementWrapper),
+             ExecutorAddr::fromPtr(&DeinitializeCounter)))});
+    Requests.push_back({ReservationAddr, std::move(FR)});
+  }
+
+  auto Bases = MapperService.initializeBatch(Requests);
+  EXPECT_THAT_EXPECTED(Bases, Succeeded());
+  ASSERT_EQ(Bases->size(), 2U);
+  EXPECT_EQ((*Bases)[0], ReservationAddr);
+  EXPECT_EQ((*Bases)[1], ReservationAddr + PageSize);
+  EXPECT_EQ(InitializeCounter, 2);
+  EXPECT_EQ(DeinitializeCounter, 0);
+
+  EXPECT_THAT_ERROR(MapperService.deinitialize(*Bases), Succeeded());
+  EXPECT_EQ(DeinitializeCounter, 2);
+
+  EXPECT_THAT_ERROR(MapperService.release({ReservationAddr}), Succeeded());
+}
+
 #endif
@@ -0,0 +1,94 @@
+//===------ SpeculateAnalysesTest.cpp - Unit tests for SpeculateQuery -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/SpeculateAnalyses.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+namespace {
+
+// @caller calls @hot and @cold directly, and @target through a pointer whose
+// value profile records it as the only target.
+std::unique_ptr<Module> parseModule(LLVMContext &Ctx, StringRef Name) {
+  std::string IR = formatv(R"(
+    define void @hot() !prof !0 {
+      ret void
+    }
+    define void @cold() !prof !1 {
+      ret void
+    }
+    define void @target() {
+      ret void
+    }
+    define void @caller(ptr %fp) {
+      call void @hot()
+      call void @cold()
+      call void %fp(), !prof !2
+      ret void
+    }
+    define void @indirect_only(ptr %fp) {
+      call void %fp(), !prof !2
+      ret void
+    }
+    !0 = !{{!"function_entry_count", i64 10}
+    !1 = !{{!"function_entry_count", i64 0}
+    !2 = !{{!"VP", i32 0, i64 100, i64 {0}, i64 100}
+  )",
+                           GlobalValue::getGUID("target"));
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Ctx);
+  if (M)
+    M->setModuleIdentifier(Name);
+  return M;
+}
+
+TEST(SpeculateAnalysesTest, BlockFreqQueryUsesProfile) {
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M = parseModule(Ctx, "M1");
+  ASSERT_TRUE(M);
+
+  BlockFreqQuery Query;
+  BlockFreqQuery::ResultTy Result = Query(*M->getFunction("caller"));
+  ASSERT_TRUE(Result);
+  const DenseSet<StringRef> &Calles = Result->lookup("caller");
+  EXPECT_TRUE(Calles.contains("hot"));
+  EXPECT_TRUE(Calles.contains("target"));
+  EXPECT_FALSE(Calles.contains("cold"));
+}
+
+TEST(SpeculateAnalysesTest, FunctionsByGUIDFollowsModule) {
+  LLVMContext Ctx;
+  std::unique_ptr<Module> M1 = parseModule(Ctx, "M1");
+  std::unique_ptr<Module> M2 = parseModule(Ctx, "M2");
+  ASSERT_TRUE(M1 && M2);
+
+  // Copies of the query share the functions by GUID of the last module.
+  BlockFreqQuery Query;
+  BlockFreqQuery Copy = Query;
+  for (Module *M : {M1.get(), M2.get(), M1.get()}) {
+    for (BlockFreqQuery *Q : {&Query, &Copy}) {
+      BlockFreqQuery::ResultTy Result = (*Q)(*M->getFunction("indirect_only"));
+      ASSERT_TRUE(Result);
+      EXPECT_TRUE(Result->lookup("indirect_only").contains("target"));
+    }
+  }
+
+  // Once a target is gone, it is no longer reported.
+  M2->getFunction("target")->setName("renamed");
+  BlockFreqQuery::ResultTy Result = Query(*M2->getFunction("indirect_only"));
+  EXPECT_FALSE(Result);
+}
+
+} // namespace
@@ -257,6 +257,58 @@ TEST_F(InstrProfTest, test_writer_merge) {
   ASSERT_EQ(0U, R->Counts[1]);
 }
 
+TEST_F(InstrProfTest, test_merge_function_shards) {
+  InstrProfWriter Src1, Src2;
+  Src1.addRecord({"func1", 0x1234, {1, 2}}, Err);
+  Src1.addRecord({"func2", 0x1234, {3}}, Err);
+  Src2.addRecord({"func1", 0x1234, {10, 20}}, Err);
+  Src2.addRecord({"func3", 0x1234, {4}}, Err);
+  Src2.addRecord({"func4", 0x5678, {5}}, Err);
+
+  // Every shard only takes the functions hashing into it.
+  const unsigned NumShards = 3;
+  InstrProfWriter Shards[NumShards];
+  for (unsigned I = 0; I < NumShards; ++I) {
+    Shards[I].mergeFunctionShardFromWriter(Src1, I, NumShards, Err);
+    Shards[I].mergeFunctionShardFromWriter(Src2, I, NumShards, Err);
+    for (const auto &F : Shards[I].getProfileData())
+      EXPECT_EQ(StringMap<InstrProfWriter::ProfilingData>::hash(F.getKey()) %
+                    NumShards,
+                I);
+  }
+
+  // The records were moved out of the sources.
+  for (InstrProfWriter *Src : {&Src1, &Src2})
+    for (const auto &F : Src->getProfileData())
+      EXPECT_TRUE(F.getValue().empty());
+
+  for (InstrProfWriter &Shard : Shards)
+    Writer.mergeFunctionShardFromWriter(Shard, 0, 1, Err);
+  EXPECT_EQ(4U, Writer.getProfileData().size());
+
+  auto Profile = Writer.writeBuffer();
+  readProfile(std::move(Profile));
+
+  Expected<InstrProfRecord> R = Reader->getInstrProfRecord("func1", 0x1234);
+  EXPECT_THAT_ERROR(R.takeError(), Succeeded());
+  ASSERT_EQ(2U, R->Counts.size());
+  ASSERT_EQ(11U, R->Counts[0]);
+  ASSERT_EQ(22U, R->Counts[1]);
+
+  R = Reader->getInstrProfRecord("func2", 0x1234);
+  EXPECT_THAT_ERROR(R.takeError(), Succeeded());
+  ASSERT_EQ(1U, R->Counts.size());
+  ASSERT_EQ(3U, R->Counts[0]);
+
+  R = Reader->getInstrProfRecord("func3", 0x1234);
+  EXPECT_THAT_ERROR(R.takeError(), Succeeded());
+  ASSERT_EQ(4U, R->Counts[0]);
+
+  R = Reader->getInstrProfRecord("func4", 0x5678);
+  EXPECT_THAT_ERROR(R.takeError(), Succeeded());
+  ASSERT_EQ(5U, R->Counts[0]);
+}
+
 TEST_F(InstrProfTest, test_merge_temporal_prof_traces_truncated) {
   uint64_t ReservoirSize = 10;
   uint64_t MaxTraceLength = 2;
@@ -0,0 +1,66 @@
+//===- unittests/Support/SuffixArrayTest.cpp - suffix array tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SuffixArray.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/SuffixTree.h"
+#include "gtest/gtest.h"
+#include <set>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+using Repeats = std::set<std::pair<unsigned, std::vector<unsigned>>>;
+
+// Returns the repeated substrings with sorted start indices, so that results of
+// the suffix array and the suffix tree can be compared.
+template <typename RangeT> Repeats canonicalize(RangeT &&Range) {
+  Repeats Result;
+  for (SuffixTree::RepeatedSubstring &RS : Range) {
+    std::vector<unsigned> Starts(RS.StartIndices.begin(),
+                                 RS.StartIndices.end());
+    llvm::sort(Starts);
+    Result.insert({RS.Length, Starts});
+  }
+  return Result;
+}
+
+// Each example vector has a unique element at the end to represent the end of
+// the string
+
+TEST(SuffixArrayTest, TestSingleRepetition) {
+  std::vector<unsigned> Data = {1, 2, 1, 2, 3};
+  Repeats Expected = {{2u, {0u, 2u}}};
+  EXPECT_EQ(canonicalize(SuffixArray(Data).getRepeatedSubstrings()), Expected);
+}
+
+TEST(SuffixArrayTest, TestLongerRepetition) {
+  std::vector<unsigned> Data = {1, 2, 3, 1, 2, 3, 4};
+  Repeats Expected = {{3u, {0u, 3u}}, {2u, {1u, 4u}}};
+  EXPECT_EQ(canonicalize(SuffixArray(Data).getRepeatedSubstrings()), Expected);
+}
+
+// Tests that the suffix array reports exactly what iterating over the suffix
+// tree of the same string does.
+TEST(SuffixArrayTest, TestMatchesSuffixTree) {
+  std::vector<std::vector<unsigned>> Inputs = {
+      {1, 1, 1, 1, 1, 1, 2},
+      {1, 1, 2, 1, 1, 3},
+      {1, 2, 1, 2, 1, 2, 1, 3, 1, 2, 1, 2, 4},
+      {3, 1, 2, 3, 1, 2, 3, 1, 1, 2, 3, 2, 1, 3, 1, 2, 5},
+  };
+  for (const std::vector<unsigned> &Data : Inputs) {
+    SuffixTree ST(Data);
+    EXPECT_EQ(canonicalize(SuffixArray(Data).getRepeatedSubstrings()),
+              canonicalize(ST));
+  }
+}
+
+} // namespace
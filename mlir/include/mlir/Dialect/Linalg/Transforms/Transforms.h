@@ -1190,6 +1190,31 @@ struct BlockPackMatmulOptions {
   bool rhsTransposeInnerBlocks = true;
 };
 
+/// Target parameters used by the analytical model that selects matmul block
+/// factors when none are provided.
+struct BlockPackMatmulTargetInfo {
+  /// Width of the target vector registers in bits.
+  int64_t vectorBitWidth = 256;
+
+  /// Number of architectural vector registers.
+  int64_t numVectorRegisters = 16;
+
+  /// Size of the L1 data cache in bytes.
+  int64_t l1CacheBytes = 32 * 1024;
+};
+
+/// Compute minor block factors (mb, nb, kb) for `linalgOp` such that the
+/// resulting inner blocks map onto a register-blocked microkernel:
+///   - nb spans two vector registers worth of elements,
+///   - mb is the number of rows whose nb-wide accumulators fit into the vector
+///     register file, leaving registers for the operand loads,
+///   - kb is the depth for which the mb x kb and kb x nb operand blocks fit
+///     into half of the L1 cache, rounded to a multiple of the vector length.
+/// Return std::nullopt if the element type is not an integer or float type.
+std::optional<SmallVector<int64_t, 3>>
+computeBlockPackMatmulFactors(linalg::LinalgOp linalgOp,
+                              const BlockPackMatmulTargetInfo &targetInfo = {});
+
 /// Function type which is used to control matmul packing.
 /// It is expected to return valid packing configuration for each operation.
 /// Lack of packing options indicates that no valid configuration could be
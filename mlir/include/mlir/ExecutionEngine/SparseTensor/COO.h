@@ -17,6 +17,7 @@
 #include <cassert>
 #include <cinttypes>
 #include <functional>
+#include <thread>
 #include <vector>
 
 namespace mlir {
@@ -129,15 +130,70 @@ public:
 
   /// Sorts elements lexicographically by coordinates. If a coordinate
   /// is mapped to multiple values, then the relative order of those
-  /// values is unspecified.
+  /// values is unspecified. Large tensors are sorted with multiple threads.
   void sort() {
     if (isSorted)
       return;
-    std::sort(elements.begin(), elements.end(), getElementLT());
+    const uint64_t nse = elements.size();
+    const uint64_t numThreads = std::thread::hardware_concurrency();
+    const uint64_t numChunks =
+        std::min(numThreads, nse / kMinParallelSortChunkSize);
+    if (numChunks < 2)
+      std::sort(elements.begin(), elements.end(), getElementLT());
+    else
+      parallelSort(numChunks);
     isSorted = true;
   }
 
 private:
+  /// The minimum number of elements sorted by each thread of a parallel
+  /// sort. Below this, the cost of spawning threads outweighs the gains.
+  static constexpr uint64_t kMinParallelSortChunkSize = 1 << 16;
+
+  /// Sorts the elements by splitting them into `numChunks` chunks that are
+  /// sorted concurrently, and then merging neighboring chunks pairwise, again
+  /// concurrently, until a single sorted range remains.
+  void parallelSort(uint64_t numChunks) {
+    const ElementLT<V> lt = getElementLT();
+    const auto begin = elements.begin();
+    const uint64_t nse = elements.size();
+    std::vector<uint64_t> bounds;
+    bounds.reserve(numChunks + 1);
+    for (uint64_t c = 0; c <= numChunks; ++c)
+      bounds.push_back(c * nse / numChunks);
+
+    // Runs `fn(j)` for each `j` in `[0, n)`, one per thread, using the
+    // current thread for the last one.
+    auto runConcurrently = [](uint64_t n, auto fn) {
+      std::vector<std::thread> threads;
+      threads.reserve(n - 1);
+      for (uint64_t j = 0; j + 1 < n; ++j)
+        threads.emplace_back(fn, j);
+      fn(n - 1);
+      for (std::thread &t : threads)
+        t.join();
+    };
+
+    runConcurrently(numChunks, [&](uint64_t c) {
+      std::sort(begin + bounds[c], begin + bounds[c + 1], lt);
+    });
+    while (bounds.size() > 2) {
+      const uint64_t numMerges = (bounds.size() - 1) / 2;
+      runConcurrently(numMerges, [&](uint64_t m) {
+        std::inplace_merge(begin + bounds[2 * m], begin + bounds[2 * m + 1],
+                           begin + bounds[2 * m + 2], lt);
+      });
+      // Drop the boundaries between the chunks that were just merged.
+      std::vector<uint64_t> merged;
+      merged.reserve(numMerges + 2);
+      for (uint64_t b = 0; b < bounds.size(); b += 2)
+        merged.push_back(bounds[b]);
+      if (merged.back() != nse)
+        merged.push_back(nse);
+      bounds = std::move(merged);
+    }
+  }
+
   const std::vector<uint64_t> dimSizes; // per-dimension sizes
   std::vector<Element<V>> elements;     // all COO elements
   std::vector<uint64_t> coordinates;    // shared coordinate pool
@@ -892,6 +892,15 @@ public:
   int getPropertiesStorageSize() const {
     return ((int)propertiesStorageSize) * 8;
   }
+
+  /// Returns the number of bytes used by the allocation of this operation,
+  /// i.e. the operation itself, its results, operands, successors, regions and
+  /// properties. This doesn't include the blocks nested within its regions, or
+  /// contents of the properties and attributes that live outside of the
+  /// operation. Once the operands have been reallocated out-of-line, the size
+  /// of the inline operand storage is no longer known and the out-of-line
+  /// storage is counted instead.
+  size_t getAllocationSize();
   /// Returns the properties storage.
   OpaqueProperties getPropertiesStorage() {
     if (propertiesStorageSize)
@@ -1111,6 +1111,9 @@ public:
   /// Return the number of operands held in the storage.
   unsigned size() { return numOperands; }
 
+  /// Return the number of operands the storage can hold without reallocating.
+  unsigned getCapacity() { return capacity; }
+
 private:
   /// Resize the storage to the given size. Returns the array containing the new
   /// operands.
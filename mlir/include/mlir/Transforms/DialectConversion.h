@@ -424,6 +424,13 @@ private:
     cachedMultiConversions.clear();
   }
 
+  /// Look up a previously computed conversion of the given type, appending the
+  /// converted types to `results` on success. Returns std::nullopt if the type
+  /// hasn't been converted yet. The caller is responsible for holding
+  /// `cacheMutex` when multi-threading is enabled.
+  std::optional<LogicalResult>
+  lookupCachedConversion(Type t, SmallVectorImpl<Type> &results) const;
+
   /// The set of registered conversion functions.
   SmallVector<ConversionCallbackFn, 4> conversions;
 
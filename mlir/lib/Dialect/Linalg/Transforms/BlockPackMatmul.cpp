@@ -12,6 +12,7 @@
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/TypeSwitch.h"
@@ -134,6 +135,34 @@ transposePackedMatmul(RewriterBase &rewriter, linalg::LinalgOp linalgOp,
   return packTransposedMatmul;
 }
 
+std::optional<SmallVector<int64_t, 3>> linalg::computeBlockPackMatmulFactors(
+    linalg::LinalgOp linalgOp, const BlockPackMatmulTargetInfo &targetInfo) {
+  if (linalgOp.getNumDpsInputs() < 1)
+    return std::nullopt;
+  Type elementType =
+      getElementTypeOrSelf(linalgOp.getDpsInputOperand(0)->get().getType());
+  if (!elementType.isIntOrFloat())
+    return std::nullopt;
+  int64_t elementBits = elementType.getIntOrFloatBitWidth();
+  int64_t elementBytes = std::max<int64_t>(1, elementBits / 8);
+  int64_t vectorLength =
+      std::max<int64_t>(1, targetInfo.vectorBitWidth / elementBits);
+
+  // Each row of the output block is accumulated in two vector registers. Keep
+  // two registers for the RHS loads and one for the LHS broadcast.
+  constexpr int64_t kAccRegsPerRow = 2;
+  int64_t nb = kAccRegsPerRow * vectorLength;
+  int64_t mb = std::max<int64_t>(
+      1, (targetInfo.numVectorRegisters - kAccRegsPerRow - 1) / kAccRegsPerRow);
+
+  // Keep the LHS and RHS blocks resident in half of the L1 cache, leaving the
+  // other half for the output block and the streamed-in data.
+  int64_t kb = targetInfo.l1CacheBytes / 2 / ((mb + nb) * elementBytes);
+  kb = std::max(vectorLength, kb / vectorLength * vectorLength);
+
+  return SmallVector<int64_t, 3>{mb, nb, kb};
+}
+
 /// Pack a matmul operation into blocked 4D layout.
 FailureOr<PackResult>
 linalg::blockPackMatmul(RewriterBase &rewriter, linalg::LinalgOp linalgOp,
@@ -285,9 +314,17 @@ struct LinalgBlockPackMatmul
     RewritePatternSet patterns(&getContext());
 
     ControlBlockPackMatmulFn controlFn =
-        [&](linalg::LinalgOp op) -> BlockPackMatmulOptions {
+        [&](linalg::LinalgOp op) -> std::optional<BlockPackMatmulOptions> {
       BlockPackMatmulOptions options;
       options.blockFactors = SmallVector<int64_t>{*blockFactors};
+      // Fall back to the analytical model when no block factors are given.
+      if (options.blockFactors.empty()) {
+        std::optional<SmallVector<int64_t, 3>> factors =
+            computeBlockPackMatmulFactors(op);
+        if (!factors)
+          return std::nullopt;
+        options.blockFactors = std::move(*factors);
+      }
       options.allowPadding = allowPadding;
       options.mnkPaddedSizesNextMultipleOf =
           SmallVector<int64_t>{*mnkPaddedSizesNextMultipleOf};
@@ -104,11 +104,13 @@ LogicalResult transform::detail::parseTransformModuleFromFile(
                StringAttr::get(context, transformFileName), 0, 0))
            << "failed to open transform file: " << errorMessage;
   }
-  // Tell sourceMgr about this buffer, the parser will pick it up.
-  llvm::SourceMgr sourceMgr;
-  sourceMgr.AddNewSourceBuffer(std::move(memoryBuffer), llvm::SMLoc());
-  transformModule =
-      OwningOpRef<ModuleOp>(parseSourceFile<ModuleOp>(sourceMgr, context));
+  // Tell sourceMgr about this buffer, the parser will pick it up. The source
+  // manager is shared so that bytecode resources can refer to the buffer
+  // directly instead of being copied.
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  sourceMgr->AddNewSourceBuffer(std::move(memoryBuffer), llvm::SMLoc());
+  transformModule = OwningOpRef<ModuleOp>(
+      parseSourceFile<ModuleOp>(sourceMgr, ParserConfig(context)));
   if (!transformModule) {
     // Failed to parse the transform module.
     // Don't need to emit an error here as the parsing should have already done
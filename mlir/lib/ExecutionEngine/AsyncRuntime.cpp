@@ -13,17 +13,21 @@
 
 #include "mlir/ExecutionEngine/AsyncRuntime.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
 #include "llvm/ADT/StringMap.h"
-#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir::runtime;
 
@@ -38,6 +42,166 @@ namespace {
 // Forward declare class defined below.
 class RefCounted;
 
+// -------------------------------------------------------------------------- //
+// A work-stealing scheduler for async tasks. Every worker thread owns a deque
+// of tasks. Tasks spawned from a worker thread are pushed to and popped from
+// the back of its own deque, so the most recently spawned (and cache-hot) task
+// runs first and workers don't contend on a shared queue. Idle workers steal
+// the oldest tasks from the front of other deques. Tasks submitted from
+// threads outside of the scheduler go to a shared injection queue.
+// -------------------------------------------------------------------------- //
+
+class WorkStealingScheduler {
+public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingScheduler(unsigned numWorkers)
+      : numWorkers(std::max(1u, numWorkers)),
+        queues(new TaskQueue[this->numWorkers]) {
+    workers.reserve(this->numWorkers);
+    for (unsigned i = 0; i < this->numWorkers; ++i)
+      workers.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ~WorkStealingScheduler() {
+    wait();
+    {
+      std::unique_lock<std::mutex> lock(sleepMu);
+      stop = true;
+    }
+    sleepCv.notify_all();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  // Schedules `task` for asynchronous execution.
+  void async(Task task) {
+    pendingTasks.fetch_add(1, std::memory_order_relaxed);
+    TaskQueue &queue =
+        currentScheduler == this ? queues[currentWorker] : injectionQueue;
+    {
+      std::unique_lock<std::mutex> lock(queue.mu);
+      queue.tasks.push_back(std::move(task));
+    }
+    queuedTasks.fetch_add(1);
+    // Only take the sleep mutex if a worker may be waiting for work. Paired
+    // with the sequentially consistent accesses in `workerLoop`, either the
+    // sleeping worker sees the queued task, or we see the sleeping worker.
+    if (numSleeping.load() > 0) {
+      { std::unique_lock<std::mutex> lock(sleepMu); }
+      sleepCv.notify_one();
+    }
+  }
+
+  // Blocks until all scheduled tasks have completed.
+  void wait() {
+    std::unique_lock<std::mutex> lock(doneMu);
+    doneCv.wait(lock, [this] { return pendingTasks.load() == 0; });
+  }
+
+  unsigned getMaxConcurrency() const { return numWorkers; }
+
+private:
+  struct TaskQueue {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  static std::optional<Task> popBack(TaskQueue &queue) {
+    std::unique_lock<std::mutex> lock(queue.mu);
+    if (queue.tasks.empty())
+      return std::nullopt;
+    Task task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return task;
+  }
+
+  static std::optional<Task> popFront(TaskQueue &queue) {
+    std::unique_lock<std::mutex> lock(queue.mu);
+    if (queue.tasks.empty())
+      return std::nullopt;
+    Task task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return task;
+  }
+
+  // Finds a task for the given worker: first in its own deque, then in the
+  // injection queue, and finally by stealing from the other workers.
+  std::optional<Task> findTask(unsigned worker) {
+    if (queuedTasks.load(std::memory_order_relaxed) == 0)
+      return std::nullopt;
+    std::optional<Task> task = popBack(queues[worker]);
+    if (!task)
+      task = popFront(injectionQueue);
+    for (unsigned i = 1; !task && i < numWorkers; ++i)
+      task = popFront(queues[(worker + i) % numWorkers]);
+    if (task)
+      queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    return task;
+  }
+
+  void runTask(Task &task) {
+    task();
+    if (pendingTasks.fetch_sub(1) == 1) {
+      std::unique_lock<std::mutex> lock(doneMu);
+      doneCv.notify_all();
+    }
+  }
+
+  void workerLoop(unsigned worker) {
+    currentScheduler = this;
+    currentWorker = worker;
+    while (true) {
+      // Spin for a little while before going to sleep, since fine-grained
+      // tasks tend to arrive in quick succession.
+      std::optional<Task> task;
+      for (int spin = 0; spin < 64 && !task; ++spin) {
+        task = findTask(worker);
+        if (!task)
+          std::this_thread::yield();
+      }
+      if (task) {
+        runTask(*task);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepMu);
+      numSleeping.fetch_add(1);
+      sleepCv.wait(lock, [this] { return stop || queuedTasks.load() > 0; });
+      numSleeping.fetch_sub(1);
+      if (stop && queuedTasks.load() == 0)
+        return;
+    }
+  }
+
+  // The scheduler and the worker index of the current thread, if it is a
+  // worker thread.
+  static thread_local WorkStealingScheduler *currentScheduler;
+  static thread_local unsigned currentWorker;
+
+  const unsigned numWorkers;
+  std::unique_ptr<TaskQueue[]> queues;
+  TaskQueue injectionQueue;
+  std::vector<std::thread> workers;
+
+  // Number of tasks that were scheduled but have not completed yet.
+  std::atomic<int64_t> pendingTasks{0};
+  // Number of tasks sitting in one of the queues.
+  std::atomic<int64_t> queuedTasks{0};
+
+  std::mutex doneMu;
+  std::condition_variable doneCv;
+
+  std::atomic<unsigned> numSleeping{0};
+  std::mutex sleepMu;
+  std::condition_variable sleepCv;
+  bool stop = false;
+};
+
+thread_local WorkStealingScheduler *WorkStealingScheduler::currentScheduler =
+    nullptr;
+thread_local unsigned WorkStealingScheduler::currentWorker = 0;
+
 // -------------------------------------------------------------------------- //
 // AsyncRuntime orchestrates all async operations and Async runtime API is built
 // on top of the default runtime instance.
@@ -45,7 +209,9 @@ class RefCounted;
 
 class AsyncRuntime {
 public:
-  AsyncRuntime() : numRefCountedObjects(0) {}
+  AsyncRuntime()
+      : numRefCountedObjects(0),
+        threadPool(llvm::hardware_concurrency().compute_thread_count()) {}
 
   ~AsyncRuntime() {
     threadPool.wait(); // wait for the completion of all async tasks
@@ -57,7 +223,7 @@ public:
     return numRefCountedObjects.load(std::memory_order_relaxed);
   }
 
-  llvm::ThreadPoolInterface &getThreadPool() { return threadPool; }
+  WorkStealingScheduler &getThreadPool() { return threadPool; }
 
 private:
   friend class RefCounted;
@@ -72,7 +238,7 @@ private:
   }
 
   std::atomic<int64_t> numRefCountedObjects;
-  llvm::DefaultThreadPool threadPool;
+  WorkStealingScheduler threadPool;
 };
 
 // -------------------------------------------------------------------------- //
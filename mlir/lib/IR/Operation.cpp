@@ -152,6 +152,21 @@ Operation *Operation::create(Location location, OperationName name,
   return op;
 }
 
+/// Return the number of bytes used by the allocation of this operation. This
+/// mirrors the size computation in `Operation::create`.
+size_t Operation::getAllocationSize() {
+  // Erasing operands keeps the inline storage, so count its capacity rather
+  // than the current number of operands.
+  unsigned numOperandSlots =
+      hasOperandStorage ? getOperandStorage().getCapacity() : 0;
+  size_t byteSize =
+      totalSizeToAlloc<detail::OperandStorage, detail::OpProperties,
+                       BlockOperand, Region, OpOperand>(
+          hasOperandStorage ? 1 : 0, getPropertiesStorageSize(),
+          getNumSuccessors(), getNumRegions(), numOperandSlots);
+  return byteSize + llvm::alignTo(prefixAllocSize(), alignof(Operation));
+}
+
 Operation::Operation(Location location, OperationName name, unsigned numResults,
                      unsigned numSuccessors, unsigned numRegions,
                      int fullPropertiesStorageSize, DictionaryAttr attributes,
@@ -132,20 +132,25 @@ LogicalResult PatternApplicator::matchAndRewrite(
     function_ref<bool(const Pattern &)> canApply,
     function_ref<void(const Pattern &)> onFailure,
     function_ref<LogicalResult(const Pattern &)> onSuccess) {
+  // Check to see if there are patterns matching this specific operation type.
+  MutableArrayRef<const RewritePattern *> opPatterns;
+  auto patternIt = patterns.find(op->getName());
+  if (patternIt != patterns.end())
+    opPatterns = patternIt->second;
+
+  // Most operations visited by a driver have no candidate patterns at all, so
+  // bail out before setting up any of the matching state.
+  const PDLByteCode *bytecode = frozenPatternList.getPDLByteCode();
+  if (!bytecode && opPatterns.empty() && anyOpPatterns.empty())
+    return failure();
+
   // Before checking native patterns, first match against the bytecode. This
   // won't automatically perform any rewrites so there is no need to worry about
   // conflicts.
   SmallVector<PDLByteCode::MatchResult, 4> pdlMatches;
-  const PDLByteCode *bytecode = frozenPatternList.getPDLByteCode();
   if (bytecode)
     bytecode->match(op, rewriter, pdlMatches, *mutableByteCodeState);
 
-  // Check to see if there are patterns matching this specific operation type.
-  MutableArrayRef<const RewritePattern *> opPatterns;
-  auto patternIt = patterns.find(op->getName());
-  if (patternIt != patterns.end())
-    opPatterns = patternIt->second;
-
   // Process the patterns for that match the specific operation type, and any
   // operation type in an interleaved fashion.
   unsigned opIt = 0, opE = opPatterns.size();
@@ -11,7 +11,10 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/ThreadLocalCache.h"
 #include "mlir/Support/TypeID.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -113,11 +116,11 @@ public:
   /// use. The provided shard number is required to be a valid power of 2. The
   /// destructor function is used to destroy any allocated storage instances.
   ParametricStorageUniquer(function_ref<void(BaseStorage *)> destructorFn,
-                           size_t numShards = 8)
+                           size_t numShards = getDefaultNumShards())
       : shards(new std::atomic<Shard *>[numShards]), numShards(numShards),
-        destructorFn(destructorFn) {
-    assert(llvm::isPowerOf2_64(numShards) &&
-           "the number of shards is required to be a power of 2");
+        shardShift(32 - llvm::Log2_64(numShards)), destructorFn(destructorFn) {
+    assert(llvm::isPowerOf2_64(numShards) && numShards > 1 &&
+           "the number of shards is required to be a power of 2 above 1");
     for (size_t i = 0; i < numShards; i++)
       shards[i].store(nullptr, std::memory_order_relaxed);
   }
@@ -175,10 +178,26 @@ public:
   }
 
 private:
+  /// Return the default number of shards, which scales with the number of
+  /// hardware threads so that contention stays low on large machines. Shards
+  /// are allocated lazily, so unused shards only cost a pointer.
+  static size_t getDefaultNumShards() {
+    static const size_t numShards = [] {
+      unsigned numThreads = llvm::hardware_concurrency().compute_thread_count();
+      return std::clamp<size_t>(llvm::PowerOf2Ceil(numThreads), 8, 256);
+    }();
+    return numShards;
+  }
+
   /// Return the shard used for the given hash value.
   Shard &getShard(unsigned hashValue) {
-    // Get a shard number from the provided hashvalue.
-    unsigned shardNum = hashValue & (numShards - 1);
+    // Get a shard number from the high bits of the provided hash value. The
+    // low bits select the bucket within the shard's hash set, and using them
+    // here as well would leave most of the buckets of each set unused. Mix
+    // the hash first (Fibonacci hashing), since weak hashes of small keys
+    // often leave the high bits zero.
+    unsigned shardNum =
+        static_cast<uint32_t>(hashValue * 0x9E3779B9u) >> shardShift;
 
     // Try to acquire an already initialized shard.
     Shard *shard = shards[shardNum].load(std::memory_order_acquire);
@@ -207,6 +226,9 @@ private:
   /// The number of available shards.
   size_t numShards;
 
+  /// The amount by which a hash value is shifted to compute its shard.
+  unsigned shardShift;
+
   /// Function to used to destruct any allocated storage instances.
   function_ref<void(BaseStorage *)> destructorFn;
 
@@ -77,19 +77,23 @@ mlir::mlirQueryMain(int argc, char **argv, MLIRContext &context,
     return mlir::failure();
   }
 
-  auto sourceMgr = llvm::SourceMgr();
-  auto bufferId = sourceMgr.AddNewSourceBuffer(std::move(file), SMLoc());
+  // Keep the source manager in a shared pointer so that resources in bytecode
+  // inputs can reference the file buffer directly instead of being copied.
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  auto bufferId = sourceMgr->AddNewSourceBuffer(std::move(file), SMLoc());
 
   context.allowUnregisteredDialects(allowUnregisteredDialects);
 
   // Parse the input MLIR file.
+  ParserConfig parserConfig(&context);
   OwningOpRef<Operation *> opRef =
-      noImplicitModule ? parseSourceFile(sourceMgr, &context)
-                       : parseSourceFile<mlir::ModuleOp>(sourceMgr, &context);
+      noImplicitModule
+          ? parseSourceFile(sourceMgr, parserConfig)
+          : parseSourceFile<mlir::ModuleOp>(sourceMgr, parserConfig);
   if (!opRef)
     return mlir::failure();
 
-  mlir::query::QuerySession qs(opRef.get(), sourceMgr, bufferId,
+  mlir::query::QuerySession qs(opRef.get(), *sourceMgr, bufferId,
                                matcherRegistry);
   if (!commands.empty()) {
     for (auto &command : commands) {
@@ -3042,6 +3042,23 @@ void TypeConverter::SignatureConversion::remapInput(unsigned origInputNo,
       InputMapping{origInputNo, /*size=*/0, replacementValue};
 }
 
+std::optional<LogicalResult>
+TypeConverter::lookupCachedConversion(Type t,
+                                      SmallVectorImpl<Type> &results) const {
+  auto existingIt = cachedDirectConversions.find(t);
+  if (existingIt != cachedDirectConversions.end()) {
+    if (existingIt->second)
+      results.push_back(existingIt->second);
+    return success(existingIt->second != nullptr);
+  }
+  auto multiIt = cachedMultiConversions.find(t);
+  if (multiIt != cachedMultiConversions.end()) {
+    results.append(multiIt->second.begin(), multiIt->second.end());
+    return success();
+  }
+  return std::nullopt;
+}
+
 LogicalResult TypeConverter::convertType(Type t,
                                          SmallVectorImpl<Type> &results) const {
   {
@@ -3049,17 +3066,9 @@ LogicalResult TypeConverter::convertType(Type t,
                                                          std::defer_lock);
     if (t.getContext()->isMultithreadingEnabled())
       cacheReadLock.lock();
-    auto existingIt = cachedDirectConversions.find(t);
-    if (existingIt != cachedDirectConversions.end()) {
-      if (existingIt->second)
-        results.push_back(existingIt->second);
-      return success(existingIt->second != nullptr);
-    }
-    auto multiIt = cachedMultiConversions.find(t);
-    if (multiIt != cachedMultiConversions.end()) {
-      results.append(multiIt->second.begin(), multiIt->second.end());
-      return success();
-    }
+    if (std::optional<LogicalResult> cached =
+            lookupCachedConversion(t, results))
+      return *cached;
   }
   // Walk the added converters in reverse order to apply the most recently
   // registered first.
@@ -3100,7 +3109,30 @@ Type TypeConverter::convertType(Type t) const {
 LogicalResult
 TypeConverter::convertTypes(TypeRange types,
                             SmallVectorImpl<Type> &results) const {
-  for (Type type : types)
+  if (types.empty())
+    return success();
+
+  // Resolve the leading types that were already converted under a single
+  // acquisition of the cache lock, which is the common case when converting
+  // the operand or result types of an operation.
+  size_t numCached = 0;
+  {
+    std::shared_lock<decltype(cacheMutex)> cacheReadLock(cacheMutex,
+                                                         std::defer_lock);
+    if (types.front().getContext()->isMultithreadingEnabled())
+      cacheReadLock.lock();
+    for (Type type : types) {
+      std::optional<LogicalResult> cached =
+          lookupCachedConversion(type, results);
+      if (!cached)
+        break;
+      if (failed(*cached))
+        return failure();
+      ++numCached;
+    }
+  }
+
+  for (Type type : types.drop_front(numCached))
     if (failed(convertType(type, results)))
       return failure();
   return success();
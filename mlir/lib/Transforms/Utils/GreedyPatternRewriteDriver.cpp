@@ -194,7 +194,8 @@ static void logSuccessfulFolding(Operation *op) {
 /// This class maintains a vector of operations and a mapping of operations to
 /// positions in the vector, so that operations can be removed efficiently at
 /// random. When an operation is removed, it is replaced with nullptr. Such
-/// nullptr are skipped when pop'ing elements.
+/// nullptr are skipped when pop'ing elements. The vector never ends with a
+/// nullptr, so that checking for emptiness does not have to scan it.
 class Worklist {
 public:
   Worklist();
@@ -220,6 +221,9 @@ public:
   void reverse();
 
 protected:
+  /// Remove all trailing nullptr from `list`.
+  void trimTrailingNulls();
+
   /// The worklist of operations.
   std::vector<Operation *> list;
 
@@ -235,9 +239,8 @@ void Worklist::clear() {
 }
 
 bool Worklist::empty() const {
-  // Skip all nullptr.
-  return !llvm::any_of(list,
-                       [](Operation *op) { return static_cast<bool>(op); });
+  assert((list.empty() || list.back()) && "expected no trailing nullptr");
+  return list.empty();
 }
 
 void Worklist::push(Operation *op) {
@@ -250,15 +253,10 @@ void Worklist::push(Operation *op) {
 
 Operation *Worklist::pop() {
   assert(!empty() && "cannot pop from empty worklist");
-  // Skip and remove all trailing nullptr.
-  while (!list.back())
-    list.pop_back();
   Operation *op = list.back();
   list.pop_back();
   map.erase(op);
-  // Cleanup: Remove all trailing nullptr.
-  while (!list.empty() && !list.back())
-    list.pop_back();
+  trimTrailingNulls();
   return op;
 }
 
@@ -269,13 +267,21 @@ void Worklist::remove(Operation *op) {
     assert(list[it->second] == op && "malformed worklist data structure");
     list[it->second] = nullptr;
     map.erase(it);
+    trimTrailingNulls();
   }
 }
 
+void Worklist::trimTrailingNulls() {
+  while (!list.empty() && !list.back())
+    list.pop_back();
+}
+
 void Worklist::reverse() {
   std::reverse(list.begin(), list.end());
+  trimTrailingNulls();
   for (size_t i = 0, e = list.size(); i != e; ++i)
-    map[list[i]] = i;
+    if (list[i])
+      map[list[i]] = i;
 }
 
 #ifdef MLIR_GREEDY_REWRITE_RANDOMIZER_SEED
@@ -301,6 +307,7 @@ public:
         map[list[i]] = i;
       map.erase(op);
     } while (!op);
+    trimTrailingNulls();
     return op;
   }
 
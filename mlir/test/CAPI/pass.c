@@ -152,7 +152,8 @@ void testPrintPassPipeline(void) {
 
   // Print the top level pass manager
   //      CHECK: Top-level: any(
-  // CHECK-SAME:   builtin.module(func.func(print-op-stats{json=false}))
+  // CHECK-SAME:   builtin.module(func.func(
+  // CHECK-SAME:     print-op-stats{json=false memory=false}))
   // CHECK-SAME: )
   fprintf(stderr, "Top-level: ");
   mlirPrintPassPipeline(mlirPassManagerGetAsOpPassManager(pm), printToStderr,
@@ -160,13 +161,15 @@ void testPrintPassPipeline(void) {
   fprintf(stderr, "\n");
 
   // Print the pipeline nested one level down
-  // CHECK: Nested Module: builtin.module(func.func(print-op-stats{json=false}))
+  //      CHECK: Nested Module: builtin.module(func.func(
+  // CHECK-SAME:   print-op-stats{json=false memory=false}))
   fprintf(stderr, "Nested Module: ");
   mlirPrintPassPipeline(nestedModulePm, printToStderr, NULL);
   fprintf(stderr, "\n");
 
   // Print the pipeline nested two levels down
-  // CHECK: Nested Module>Func: func.func(print-op-stats{json=false})
+  //      CHECK: Nested Module>Func: func.func(
+  // CHECK-SAME:   print-op-stats{json=false memory=false})
   fprintf(stderr, "Nested Module>Func: ");
   mlirPrintPassPipeline(nestedFuncPm, printToStderr, NULL);
   fprintf(stderr, "\n");
@@ -205,7 +208,8 @@ void testParsePassPipeline(void) {
     exit(EXIT_FAILURE);
   }
 
-  // CHECK: Round-trip: builtin.module(func.func(print-op-stats{json=false}))
+  //      CHECK: Round-trip: builtin.module(func.func(
+  // CHECK-SAME:   print-op-stats{json=false memory=false}))
   fprintf(stderr, "Round-trip: ");
   mlirPrintPassPipeline(mlirPassManagerGetAsOpPassManager(pm), printToStderr,
                         NULL);
@@ -221,8 +225,8 @@ void testParsePassPipeline(void) {
     exit(EXIT_FAILURE);
   }
   //      CHECK: Appended: builtin.module(
-  // CHECK-SAME:   func.func(print-op-stats{json=false}),
-  // CHECK-SAME:   func.func(print-op-stats{json=false})
+  // CHECK-SAME:   func.func(print-op-stats{json=false memory=false}),
+  // CHECK-SAME:   func.func(print-op-stats{json=false memory=false})
   // CHECK-SAME: )
   fprintf(stderr, "Appended: ");
   mlirPrintPassPipeline(mlirPassManagerGetAsOpPassManager(pm), printToStderr,
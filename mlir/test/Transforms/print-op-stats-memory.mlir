@@ -0,0 +1,24 @@
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(print-op-stats{memory=true})' -o /dev/null 2>&1 | FileCheck %s
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(print-op-stats{json=true memory=true})' -o /dev/null 2>&1 | FileCheck %s --check-prefix=JSON
+
+// The allocated bytes depend on the host, so only their presence is checked.
+
+// CHECK-LABEL: Operations encountered:
+// CHECK:       arith.addf , 2 , {{[1-9][0-9]*$}}
+// CHECK:       builtin.module , 1 , {{[1-9][0-9]*$}}
+// CHECK:       func.func , 1 , {{[1-9][0-9]*$}}
+// CHECK:       func.return , 1 , {{[1-9][0-9]*$}}
+// CHECK:       Total operation bytes: {{[1-9][0-9]*$}}
+
+// JSON: {
+// JSON-NEXT: "arith.addf" : { "count" : 2, "bytes" : {{[1-9][0-9]*}} },
+// JSON-NEXT: "builtin.module" : { "count" : 1, "bytes" : {{[1-9][0-9]*}} },
+// JSON-NEXT: "func.func" : { "count" : 1, "bytes" : {{[1-9][0-9]*}} },
+// JSON-NEXT: "func.return" : { "count" : 1, "bytes" : {{[1-9][0-9]*}} }
+// JSON-NEXT: }
+
+func.func @main(%arg0: f32) -> f32 {
+  %0 = arith.addf %arg0, %arg0 : f32
+  %1 = arith.addf %0, %arg0 : f32
+  return %1 : f32
+}
@@ -0,0 +1,57 @@
+//===- COOTest.cpp - Tests for the sparse tensor runtime's COO ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/SparseTensor/COO.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace mlir::sparse_tensor;
+
+namespace {
+
+/// Builds a `rows` x `cols` COO with every coordinate set once, added in a
+/// shuffled order. The value of each element is its row-major position.
+SparseTensorCOO<uint64_t> buildShuffledCOO(uint64_t rows, uint64_t cols) {
+  std::vector<uint64_t> order(rows * cols);
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937_64 rng(42);
+  std::shuffle(order.begin(), order.end(), rng);
+  SparseTensorCOO<uint64_t> coo({rows, cols}, order.size());
+  for (uint64_t pos : order)
+    coo.add({pos / cols, pos % cols}, pos);
+  return coo;
+}
+
+void expectSortedCOO(const SparseTensorCOO<uint64_t> &coo, uint64_t cols) {
+  const auto &elements = coo.getElements();
+  for (uint64_t pos = 0, e = elements.size(); pos < e; ++pos) {
+    ASSERT_EQ(elements[pos].coords[0], pos / cols);
+    ASSERT_EQ(elements[pos].coords[1], pos % cols);
+    ASSERT_EQ(elements[pos].value, pos);
+  }
+}
+
+} // namespace
+
+TEST(SparseTensorCOO, sortSmall) {
+  SparseTensorCOO<uint64_t> coo = buildShuffledCOO(37, 41);
+  coo.sort();
+  expectSortedCOO(coo, 41);
+}
+
+// Large enough to be sorted in parallel chunks on machines with more than one
+// hardware thread. The number of elements is not a multiple of the number of
+// chunks, and an odd number of chunks leaves one unmerged in a round.
+TEST(SparseTensorCOO, sortLarge) {
+  SparseTensorCOO<uint64_t> coo = buildShuffledCOO(263, 1009);
+  coo.sort();
+  expectSortedCOO(coo, 1009);
+}
@@ -0,0 +1,84 @@
+//===- AsyncRuntime.cpp -----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/AsyncRuntime.h"
+
+#include "gmock/gmock.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace ::mlir::runtime;
+
+namespace {
+// A binary tree of tasks: every task spawns its children from the worker
+// thread that runs it, and the last task to finish emplaces the token.
+struct TaskTree {
+  std::atomic<int64_t> numRun{0};
+  std::atomic<int64_t> numPending{0};
+  int depth = 0;
+  AsyncToken *done = nullptr;
+};
+
+struct TreeTask {
+  TaskTree *tree;
+  int level;
+};
+
+void runTreeTask(void *handle) {
+  TreeTask *task = static_cast<TreeTask *>(handle);
+  TaskTree *tree = task->tree;
+  tree->numRun.fetch_add(1);
+  if (task->level + 1 < tree->depth) {
+    tree->numPending.fetch_add(2);
+    for (int i = 0; i < 2; ++i)
+      mlirAsyncRuntimeExecute(new TreeTask{tree, task->level + 1},
+                              runTreeTask);
+  }
+  delete task;
+  // The tree may be destroyed as soon as the token is ready.
+  AsyncToken *done = tree->done;
+  if (tree->numPending.fetch_sub(1) == 1)
+    mlirAsyncRuntimeEmplaceToken(done);
+}
+
+void emplaceToken(void *handle) {
+  mlirAsyncRuntimeEmplaceToken(static_cast<AsyncToken *>(handle));
+}
+} // namespace
+
+TEST(AsyncRuntime, hasWorkerThreads) {
+  EXPECT_GT(mlirAsyncRuntimGetNumWorkerThreads(), 0);
+}
+
+TEST(AsyncRuntime, tasksSpawnedFromWorkers) {
+  for (int iteration = 0; iteration < 20; ++iteration) {
+    TaskTree tree;
+    tree.depth = 13;
+    tree.done = mlirAsyncRuntimeCreateToken();
+    tree.numPending = 1;
+    mlirAsyncRuntimeExecute(new TreeTask{&tree, 0}, runTreeTask);
+    mlirAsyncRuntimeAwaitToken(tree.done);
+    EXPECT_FALSE(mlirAsyncRuntimeIsTokenError(tree.done));
+    mlirAsyncRuntimeDropRef(tree.done, 1);
+    EXPECT_EQ(tree.numRun.load(), (int64_t(1) << tree.depth) - 1);
+  }
+}
+
+TEST(AsyncRuntime, tasksSubmittedFromOutside) {
+  std::vector<AsyncToken *> tokens;
+  for (int i = 0; i < 1000; ++i) {
+    tokens.push_back(mlirAsyncRuntimeCreateToken());
+    mlirAsyncRuntimeExecute(tokens.back(), emplaceToken);
+  }
+  for (AsyncToken *token : tokens) {
+    mlirAsyncRuntimeAwaitToken(token);
+    EXPECT_FALSE(mlirAsyncRuntimeIsTokenError(token));
+    mlirAsyncRuntimeDropRef(token, 1);
+  }
+}
@@ -313,4 +313,39 @@ TEST(OperationEquivalenceTest, HashWorksWithFlags) {
   op2->destroy();
 }
 
+TEST(OperationAllocationSizeTest, CountsTrailingObjects) {
+  MLIRContext context;
+  Builder builder(&context);
+
+  Operation *base = createOp(&context);
+  size_t baseSize = base->getAllocationSize();
+  EXPECT_GE(baseSize, sizeof(Operation));
+
+  // Each operand and region adds one trailing object to the allocation.
+  Operation *def =
+      createOp(&context, /*operands=*/std::nullopt, builder.getIntegerType(16));
+  Value operand = def->getResult(0);
+  Operation *withOperands = createOp(&context, {operand, operand});
+  EXPECT_EQ(withOperands->getAllocationSize(),
+            baseSize + 2 * sizeof(OpOperand));
+
+  Operation *withRegions = createOp(&context, /*operands=*/std::nullopt,
+                                    /*resultTypes=*/std::nullopt,
+                                    /*numRegions=*/3);
+  EXPECT_EQ(withRegions->getAllocationSize(), baseSize + 3 * sizeof(Region));
+
+  // Results are allocated in front of the operation.
+  EXPECT_GT(def->getAllocationSize(), baseSize);
+
+  // Erasing operands does not shrink the inline operand storage.
+  withOperands->eraseOperand(1);
+  EXPECT_EQ(withOperands->getAllocationSize(),
+            baseSize + 2 * sizeof(OpOperand));
+
+  withRegions->destroy();
+  withOperands->destroy();
+  def->destroy();
+  base->destroy();
+}
+
 } // namespace
@@ -8,6 +8,7 @@
 
 #include "mlir/Support/StorageUniquer.h"
 #include "gmock/gmock.h"
+#include <vector>
 
 using namespace mlir;
 
@@ -58,3 +59,26 @@ TEST(StorageUniquerTest, NonTrivialDestructor) {
 
   EXPECT_TRUE(wasDestructed);
 }
+
+TEST(StorageUniquerTest, WeakHashes) {
+  /// A storage whose hash is its small integer key, so that the high bits of
+  /// every hash value are zero.
+  struct IntStorage : public SimpleStorage<IntStorage, unsigned> {
+    using Base::Base;
+    static llvm::hash_code hashKey(const KeyTy &key) {
+      return llvm::hash_code(std::get<0>(key));
+    }
+  };
+
+  StorageUniquer uniquer;
+  uniquer.registerParametricStorageType<IntStorage>();
+  std::vector<IntStorage *> storages;
+  for (unsigned i = 0; i != 4096; ++i)
+    storages.push_back(IntStorage::get(uniquer, i));
+
+  // Every key is uniqued to its own instance.
+  for (unsigned i = 0; i != 4096; ++i) {
+    EXPECT_EQ(IntStorage::get(uniquer, i), storages[i]);
+    EXPECT_EQ(std::get<0>(storages[i]->key), i);
+  }
+}
@@ -70,6 +70,14 @@ private:
   getOrCreateObjFile(const __tgt_device_image &Image, LLVMContext &Ctx,
                      const std::string &ComputeUnitKind);
 
+  /// Return the path of the file caching the JITed image of \p Image for
+  /// \p ComputeUnitKind, or an empty string if caching is disabled.
+  std::string getCachePath(const __tgt_device_image &Image,
+                           const std::string &ComputeUnitKind);
+
+  /// Store the JITed image \p ImageMB in the cache file \p Path.
+  void writeToCache(StringRef Path, const MemoryBuffer &ImageMB);
+
   /// Run backend, which contains optimization and code generation.
   Expected<std::unique_ptr<MemoryBuffer>>
   backend(Module &M, const std::string &ComputeUnitKind, unsigned OptLevel);
@@ -110,6 +118,7 @@ private:
       StringEnvar("LIBOMPTARGET_JIT_PRE_OPT_IR_MODULE");
   StringEnvar PostOptIRModuleFileName =
       StringEnvar("LIBOMPTARGET_JIT_POST_OPT_IR_MODULE");
+  StringEnvar CacheDirName = StringEnvar("LIBOMPTARGET_JIT_CACHE_DIR");
   UInt32Envar JITOptLevel = UInt32Envar("LIBOMPTARGET_JIT_OPT_LEVEL", 3);
   BoolEnvar JITSkipOpt = BoolEnvar("LIBOMPTARGET_JIT_SKIP_OPT", false);
 };
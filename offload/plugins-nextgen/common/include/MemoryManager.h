@@ -16,12 +16,14 @@
 #include <cassert>
 #include <functional>
 #include <list>
+#include <map>
 #include <mutex>
 #include <set>
 #include <unordered_map>
 #include <vector>
 
 #include "Shared/Debug.h"
+#include "Shared/EnvironmentVar.h"
 #include "Shared/Utils.h"
 #include "omptarget.h"
 
@@ -128,18 +130,49 @@ class MemoryManagerTy {
   /// The reference to a device allocator
   DeviceAllocatorTy &DeviceAllocator;
 
+  /// The kind of memory requested from the device allocator
+  const TargetAllocTy Kind;
+
   /// The threshold to manage memory using memory manager. If the request size
   /// is larger than \p SizeThreshold, the allocation will not be managed by the
   /// memory manager.
   size_t SizeThreshold = 1U << 13;
 
+  /// The maximum number of bytes of freed allocations larger than
+  /// \p SizeThreshold that are kept for reuse. Zero disables the cache of
+  /// large allocations.
+  size_t LargeRetention = 0;
+
+  /// Large allocations are rounded up to a size class, so that a freed block
+  /// can be reused by requests of slightly different sizes. A freed block is
+  /// kept in \p LargeFreeBlocks, keyed by its size class, as long as the
+  /// total size of the cached blocks stays within \p LargeRetention.
+  std::multimap<size_t, void *> LargeFreeBlocks;
+  /// The size class of every large allocation obtained from the device that
+  /// has not been returned to it.
+  std::unordered_map<void *, size_t> LargeBlockSizes;
+  /// The total size of the blocks in \p LargeFreeBlocks.
+  size_t LargeCachedBytes = 0;
+  /// The mutex for the large allocation cache.
+  std::mutex LargeLock;
+
+  /// Round \p Size up to a size class. There are four size classes per power
+  /// of two, which bounds the wasted memory to a quarter of the request.
+  static size_t roundUpToSizeClass(size_t Size) {
+    const size_t F = floorToPowerOfTwo(Size);
+    const size_t Step = F >= 4 ? F / 4 : 1;
+    return (Size + Step - 1) / Step * Step;
+  }
+
   /// Request memory from target device
   void *allocateOnDevice(size_t Size, void *HstPtr) const {
-    return DeviceAllocator.allocate(Size, HstPtr, TARGET_ALLOC_DEVICE);
+    return DeviceAllocator.allocate(Size, HstPtr, Kind);
   }
 
   /// Deallocate data on device
-  int deleteOnDevice(void *Ptr) const { return DeviceAllocator.free(Ptr); }
+  int deleteOnDevice(void *Ptr) const {
+    return DeviceAllocator.free(Ptr, Kind);
+  }
 
   /// This function is called when it tries to allocate memory on device but the
   /// device returns out of memory. It will first free all memory in the
@@ -167,10 +200,74 @@ class MemoryManagerTy {
         PtrToNodeTable.erase(P);
     }
 
+    // Deallocate all cached large allocations
+    trimLargeFreeBlocks();
+
     // Try allocate memory again
     return allocateOnDevice(Size, HstPtr);
   }
 
+  /// Return all cached large allocations to the device.
+  void trimLargeFreeBlocks() {
+    std::lock_guard<std::mutex> LG(LargeLock);
+    for (auto &[Size, Ptr] : LargeFreeBlocks) {
+      deleteOnDevice(Ptr);
+      LargeBlockSizes.erase(Ptr);
+    }
+    LargeFreeBlocks.clear();
+    LargeCachedBytes = 0;
+  }
+
+  /// Allocate a block larger than \p SizeThreshold, reusing a cached block of
+  /// the same size class if there is one.
+  void *allocateLarge(size_t Size, void *HstPtr) {
+    const size_t ClassSize = roundUpToSizeClass(Size);
+    {
+      std::lock_guard<std::mutex> LG(LargeLock);
+      auto Itr = LargeFreeBlocks.find(ClassSize);
+      if (Itr != LargeFreeBlocks.end()) {
+        void *TgtPtr = Itr->second;
+        LargeFreeBlocks.erase(Itr);
+        LargeCachedBytes -= ClassSize;
+        DP("Reuse cached large block " DPxMOD " of size %zu.\n",
+           DPxPTR(TgtPtr), ClassSize);
+        return TgtPtr;
+      }
+    }
+
+    void *TgtPtr = allocateOrFreeAndAllocateOnDevice(ClassSize, HstPtr);
+    if (TgtPtr == nullptr)
+      return nullptr;
+
+    std::lock_guard<std::mutex> LG(LargeLock);
+    LargeBlockSizes.emplace(TgtPtr, ClassSize);
+    return TgtPtr;
+  }
+
+  /// Cache the large block \p TgtPtr if it is one and the retention limit
+  /// allows it, or return it to the device otherwise. Returns false if
+  /// \p TgtPtr is not a large block managed by the memory manager.
+  bool freeLarge(void *TgtPtr, int &Res) {
+    std::lock_guard<std::mutex> LG(LargeLock);
+    auto Itr = LargeBlockSizes.find(TgtPtr);
+    if (Itr == LargeBlockSizes.end())
+      return false;
+
+    const size_t ClassSize = Itr->second;
+    if (LargeCachedBytes + ClassSize <= LargeRetention) {
+      LargeFreeBlocks.emplace(ClassSize, TgtPtr);
+      LargeCachedBytes += ClassSize;
+      Res = OFFLOAD_SUCCESS;
+      return true;
+    }
+
+    DP("Large block cache is full. Delete " DPxMOD " on device.\n",
+       DPxPTR(TgtPtr));
+    LargeBlockSizes.erase(Itr);
+    Res = deleteOnDevice(TgtPtr);
+    return true;
+  }
+
   /// The goal is to allocate memory on the device. It first tries to
   /// allocate directly on the device. If a \p nullptr is returned, it might
   /// be because the device is OOM. In that case, it will free all unused
@@ -194,10 +291,15 @@ class MemoryManagerTy {
 
 public:
   /// Constructor. If \p Threshold is non-zero, then the default threshold will
-  /// be overwritten by \p Threshold.
-  MemoryManagerTy(DeviceAllocatorTy &DeviceAllocator, size_t Threshold = 0)
+  /// be overwritten by \p Threshold. \p Kind selects the kind of memory that
+  /// is managed, e.g., device memory or pinned host memory. Up to
+  /// \p Retention bytes of freed allocations above the threshold are cached.
+  MemoryManagerTy(DeviceAllocatorTy &DeviceAllocator, size_t Threshold = 0,
+                  TargetAllocTy Kind = TARGET_ALLOC_DEVICE,
+                  size_t Retention = 0)
       : FreeLists(NumBuckets), FreeListLocks(NumBuckets),
-        DeviceAllocator(DeviceAllocator) {
+        DeviceAllocator(DeviceAllocator), Kind(Kind),
+        LargeRetention(Retention) {
     if (Threshold)
       SizeThreshold = Threshold;
   }
@@ -209,6 +311,7 @@ public:
       assert(Itr->second.Ptr && "nullptr in map table");
       deleteOnDevice(Itr->second.Ptr);
     }
+    trimLargeFreeBlocks();
   }
 
   /// Allocate memory of size \p Size from target device. \p HstPtr is used to
@@ -222,8 +325,11 @@ public:
     DP("MemoryManagerTy::allocate: size %zu with host pointer " DPxMOD ".\n",
        Size, DPxPTR(HstPtr));
 
-    // If the size is greater than the threshold, allocate it directly from
-    // device.
+    // If the size is greater than the threshold, allocate it from the cache
+    // of large allocations if it is enabled, or directly from device.
+    if (Size > SizeThreshold && LargeRetention)
+      return allocateLarge(Size, HstPtr);
+
     if (Size > SizeThreshold) {
       DP("%zu is greater than the threshold %zu. Allocate it directly from "
          "device\n",
@@ -299,6 +405,10 @@ public:
     }
 
     // The memory is not managed by the manager
+    int Res;
+    if (P == nullptr && LargeRetention && freeLarge(TgtPtr, Res))
+      return Res;
+
     if (P == nullptr) {
       DP("Cannot find its node. Delete it on device directly.\n");
       return deleteOnDevice(TgtPtr);
@@ -337,6 +447,15 @@ public:
 
     return std::make_pair(Threshold, true);
   }
+
+  /// Get the number of bytes of freed large allocations to keep for reuse
+  /// from the environment variable \p LIBOMPTARGET_MEMORY_MANAGER_RETENTION .
+  /// Returns zero, which disables the cache, if it is not set.
+  static size_t getRetentionFromEnv() {
+    static UInt64Envar MemoryManagerRetention(
+        "LIBOMPTARGET_MEMORY_MANAGER_RETENTION", 0);
+    return MemoryManagerRetention.get();
+  }
 };
 
 // GCC still cannot handle the static data member like Clang so we still need
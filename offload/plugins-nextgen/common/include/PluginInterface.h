@@ -890,6 +890,11 @@ private:
   /// Pointer to the memory manager or nullptr if not available.
   MemoryManagerTy *MemoryManager;
 
+  /// Pointer to the memory manager of pinned host allocations or nullptr if
+  /// not available. Pinning host memory is much more expensive than
+  /// allocating device memory, so reusing small host buffers pays off.
+  MemoryManagerTy *HostMemoryManager;
+
   /// Environment variables defined by the OpenMP standard.
   Int32Envar OMP_TeamLimit;
   Int32Envar OMP_NumTeams;
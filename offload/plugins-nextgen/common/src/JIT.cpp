@@ -19,6 +19,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/LLVMRemarkStreamer.h"
 #include "llvm/IR/LegacyPassManager.h"
@@ -28,7 +29,10 @@
 #include "llvm/Object/IRObjectFile.h"
 #include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/TimeProfiler.h"
@@ -276,6 +280,57 @@ JITEngine::getOrCreateObjFile(const __tgt_device_image &Image, LLVMContext &Ctx,
   return backend(*Mod, ComputeUnitKind, JITOptLevel);
 }
 
+std::string JITEngine::getCachePath(const __tgt_device_image &Image,
+                                    const std::string &ComputeUnitKind) {
+  // Images are only reused if they were produced from the same bitcode by the
+  // same JIT configuration.
+  if (!CacheDirName.isPresent() || ReplacementObjectFileName.isPresent() ||
+      ReplacementModuleFileName.isPresent() ||
+      PreOptIRModuleFileName.isPresent() || PostOptIRModuleFileName.isPresent())
+    return "";
+
+  SHA1 Hasher;
+  Hasher.update(LLVM_VERSION_STRING);
+  Hasher.update(TT.str());
+  Hasher.update(ComputeUnitKind);
+  Hasher.update(std::to_string(JITOptLevel.get()));
+  Hasher.update(JITSkipOpt.get() ? "skip-opt" : "opt");
+  Hasher.update(
+      StringRef(reinterpret_cast<const char *>(Image.ImageStart),
+                target::getPtrDiff(Image.ImageEnd, Image.ImageStart)));
+
+  SmallString<128> Path(CacheDirName.get());
+  sys::path::append(Path, "jit-" + toHex(Hasher.result()) + ".img");
+  return std::string(Path);
+}
+
+void JITEngine::writeToCache(StringRef Path, const MemoryBuffer &ImageMB) {
+  // Failing to populate the cache is not an error, the image is just JITed
+  // again next time. Write to a temporary file first so that concurrent
+  // processes never read a partially written image.
+  if (sys::fs::create_directories(sys::path::parent_path(Path)))
+    return;
+
+  int FD;
+  SmallString<128> TempPath;
+  if (sys::fs::createUniqueFile(Path + ".tmp-%%%%%%%%", FD, TempPath))
+    return;
+
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << ImageMB.getBuffer();
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return;
+    }
+  }
+
+  if (sys::fs::rename(TempPath, Path))
+    sys::fs::remove(TempPath);
+}
+
 Expected<const __tgt_device_image *>
 JITEngine::compile(const __tgt_device_image &Image,
                    const std::string &ComputeUnitKind,
@@ -287,23 +342,41 @@ JITEngine::compile(const __tgt_device_image &Image,
   if (__tgt_device_image *JITedImage = CUI.TgtImageMap.lookup(&Image))
     return JITedImage;
 
-  auto ObjMBOrErr = getOrCreateObjFile(Image, CUI.Context, ComputeUnitKind);
-  if (!ObjMBOrErr)
-    return ObjMBOrErr.takeError();
+  // Check if an earlier run left the JITed image in the cache directory.
+  std::string CachePath = getCachePath(Image, ComputeUnitKind);
+  std::unique_ptr<MemoryBuffer> ImageMB;
+  if (!CachePath.empty()) {
+    auto MBOrErr = MemoryBuffer::getFile(CachePath, /*IsText=*/false,
+                                         /*RequiresNullTerminator=*/false);
+    if (MBOrErr) {
+      DP("Loaded JITed image from %s\n", CachePath.c_str());
+      ImageMB = std::move(*MBOrErr);
+    }
+  }
+
+  if (!ImageMB) {
+    auto ObjMBOrErr = getOrCreateObjFile(Image, CUI.Context, ComputeUnitKind);
+    if (!ObjMBOrErr)
+      return ObjMBOrErr.takeError();
 
-  auto ImageMBOrErr = PostProcessing(std::move(*ObjMBOrErr));
-  if (!ImageMBOrErr)
-    return ImageMBOrErr.takeError();
+    auto ImageMBOrErr = PostProcessing(std::move(*ObjMBOrErr));
+    if (!ImageMBOrErr)
+      return ImageMBOrErr.takeError();
+
+    ImageMB = std::move(*ImageMBOrErr);
+    if (!CachePath.empty())
+      writeToCache(CachePath, *ImageMB);
+  }
 
-  CUI.JITImages.push_back(std::move(*ImageMBOrErr));
+  CUI.JITImages.push_back(std::move(ImageMB));
   __tgt_device_image *&JITedImage = CUI.TgtImageMap[&Image];
   JITedImage = new __tgt_device_image();
   *JITedImage = Image;
 
-  auto &ImageMB = CUI.JITImages.back();
+  auto &JITImageMB = CUI.JITImages.back();
 
-  JITedImage->ImageStart = const_cast<char *>(ImageMB->getBufferStart());
-  JITedImage->ImageEnd = const_cast<char *>(ImageMB->getBufferEnd());
+  JITedImage->ImageStart = const_cast<char *>(JITImageMB->getBufferStart());
+  JITedImage->ImageEnd = const_cast<char *>(JITImageMB->getBufferEnd());
 
   return JITedImage;
 }
@@ -712,7 +712,8 @@ uint64_t GenericKernelTy::getNumBlocks(GenericDeviceTy &GenericDevice,
 GenericDeviceTy::GenericDeviceTy(GenericPluginTy &Plugin, int32_t DeviceId,
                                  int32_t NumDevices,
                                  const llvm::omp::GV &OMPGridValues)
-    : Plugin(Plugin), MemoryManager(nullptr), OMP_TeamLimit("OMP_TEAM_LIMIT"),
+    : Plugin(Plugin), MemoryManager(nullptr), HostMemoryManager(nullptr),
+      OMP_TeamLimit("OMP_TEAM_LIMIT"),
       OMP_NumTeams("OMP_NUM_TEAMS"),
       OMP_TeamsThreadLimit("OMP_TEAMS_THREAD_LIMIT"),
       OMPX_DebugKind("LIBOMPTARGET_DEVICE_RTL_DEBUG"),
@@ -790,8 +791,13 @@ Error GenericDeviceTy::init(GenericPluginTy &Plugin) {
 
   // Enable the memory manager if required.
   auto [ThresholdMM, EnableMM] = MemoryManagerTy::getSizeThresholdFromEnv();
-  if (EnableMM)
-    MemoryManager = new MemoryManagerTy(*this, ThresholdMM);
+  if (EnableMM) {
+    size_t RetentionMM = MemoryManagerTy::getRetentionFromEnv();
+    MemoryManager = new MemoryManagerTy(*this, ThresholdMM, TARGET_ALLOC_DEVICE,
+                                        RetentionMM);
+    HostMemoryManager = new MemoryManagerTy(*this, ThresholdMM,
+                                            TARGET_ALLOC_HOST, RetentionMM);
+  }
 
   return Plugin::success();
 }
@@ -836,6 +842,9 @@ Error GenericDeviceTy::deinit(GenericPluginTy &Plugin) {
   if (MemoryManager)
     delete MemoryManager;
   MemoryManager = nullptr;
+  if (HostMemoryManager)
+    delete HostMemoryManager;
+  HostMemoryManager = nullptr;
 
   RecordReplayTy &RecordReplay = Plugin.getRecordReplay();
   if (RecordReplay.isRecordingOrReplaying())
@@ -1320,6 +1329,13 @@ Expected<void *> GenericDeviceTy::dataAlloc(int64_t Size, void *HostPtr,
     }
     [[fallthrough]];
   case TARGET_ALLOC_HOST:
+    if (Kind == TARGET_ALLOC_HOST && HostMemoryManager) {
+      Alloc = HostMemoryManager->allocate(Size, HostPtr);
+      if (!Alloc)
+        return Plugin::error("Failed to allocate from host memory manager");
+      break;
+    }
+    [[fallthrough]];
   case TARGET_ALLOC_SHARED:
     Alloc = allocate(Size, HostPtr, Kind);
     if (!Alloc)
@@ -1360,6 +1376,15 @@ Error GenericDeviceTy::dataDelete(void *TgtPtr, TargetAllocTy Kind) {
     }
     [[fallthrough]];
   case TARGET_ALLOC_HOST:
+    if (Kind == TARGET_ALLOC_HOST && HostMemoryManager) {
+      Res = HostMemoryManager->free(TgtPtr);
+      if (Res)
+        return Plugin::error(
+            "Failure to deallocate host pointer %p via host memory manager",
+            TgtPtr);
+      break;
+    }
+    [[fallthrough]];
   case TARGET_ALLOC_SHARED:
     Res = free(TgtPtr, Kind);
     if (Res)
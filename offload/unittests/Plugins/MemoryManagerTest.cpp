@@ -0,0 +1,147 @@
+//===------- unittests/Plugins/MemoryManagerTest.cpp - Memory manager -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "MemoryManager.h"
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <unordered_map>
+
+namespace {
+
+// Allocator that records every request made by the memory manager.
+class MockAllocatorTy final : public DeviceAllocatorTy {
+public:
+  void *allocate(size_t Size, void *HstPtr, TargetAllocTy Kind) override {
+    LastKind = Kind;
+    if (FailNext) {
+      FailNext = false;
+      return nullptr;
+    }
+    ++NumAllocs;
+    void *Ptr = std::malloc(Size);
+    Live.emplace(Ptr, Size);
+    return Ptr;
+  }
+
+  int free(void *TgtPtr, TargetAllocTy Kind) override {
+    ++NumFrees;
+    Live.erase(TgtPtr);
+    std::free(TgtPtr);
+    return OFFLOAD_SUCCESS;
+  }
+
+  size_t NumAllocs = 0;
+  size_t NumFrees = 0;
+  bool FailNext = false;
+  TargetAllocTy LastKind = TARGET_ALLOC_DEFAULT;
+  std::unordered_map<void *, size_t> Live;
+};
+
+constexpr size_t Threshold = 1U << 13;
+
+TEST(MemoryManagerTest, SmallAllocationsAreReused) {
+  MockAllocatorTy Allocator;
+  MemoryManagerTy MM(Allocator, Threshold, TARGET_ALLOC_HOST);
+
+  void *A = MM.allocate(64, nullptr);
+  ASSERT_NE(A, nullptr);
+  EXPECT_EQ(Allocator.LastKind, TARGET_ALLOC_HOST);
+  EXPECT_EQ(MM.free(A), OFFLOAD_SUCCESS);
+  EXPECT_EQ(MM.allocate(64, nullptr), A);
+  EXPECT_EQ(Allocator.NumAllocs, 1U);
+  EXPECT_EQ(Allocator.NumFrees, 0U);
+}
+
+TEST(MemoryManagerTest, LargeAllocationsWithoutRetention) {
+  MockAllocatorTy Allocator;
+  MemoryManagerTy MM(Allocator, Threshold);
+
+  void *A = MM.allocate(1 << 16, nullptr);
+  ASSERT_NE(A, nullptr);
+  EXPECT_EQ(MM.free(A), OFFLOAD_SUCCESS);
+  EXPECT_EQ(Allocator.NumFrees, 1U);
+  EXPECT_NE(MM.allocate(1 << 16, nullptr), nullptr);
+  EXPECT_EQ(Allocator.NumAllocs, 2U);
+}
+
+TEST(MemoryManagerTest, LargeAllocationsShareSizeClasses) {
+  MockAllocatorTy Allocator;
+  MemoryManagerTy MM(Allocator, Threshold, TARGET_ALLOC_DEVICE, 1 << 20);
+
+  // 100000 bytes are rounded up to the size class 7 * 2^14 = 114688.
+  void *A = MM.allocate(100000, nullptr);
+  ASSERT_NE(A, nullptr);
+  EXPECT_EQ(Allocator.Live[A], 114688U);
+  EXPECT_EQ(MM.free(A), OFFLOAD_SUCCESS);
+  EXPECT_EQ(Allocator.NumFrees, 0U);
+
+  // A request in the same size class reuses the cached block.
+  EXPECT_EQ(MM.allocate(110000, nullptr), A);
+  EXPECT_EQ(Allocator.NumAllocs, 1U);
+
+  // The next size class, 2^17, needs a new block.
+  void *B = MM.allocate(120000, nullptr);
+  ASSERT_NE(B, nullptr);
+  EXPECT_NE(B, A);
+  EXPECT_EQ(Allocator.Live[B], 131072U);
+  EXPECT_EQ(Allocator.NumAllocs, 2U);
+}
+
+TEST(MemoryManagerTest, LargeRetentionLimit) {
+  MockAllocatorTy Allocator;
+  MemoryManagerTy MM(Allocator, Threshold, TARGET_ALLOC_DEVICE, 100000);
+
+  void *A = MM.allocate(1 << 16, nullptr);
+  void *B = MM.allocate(1 << 16, nullptr);
+  ASSERT_NE(A, nullptr);
+  ASSERT_NE(B, nullptr);
+
+  // The first block fits in the retention limit, the second one does not and
+  // is returned to the device.
+  EXPECT_EQ(MM.free(A), OFFLOAD_SUCCESS);
+  EXPECT_EQ(Allocator.NumFrees, 0U);
+  EXPECT_EQ(MM.free(B), OFFLOAD_SUCCESS);
+  EXPECT_EQ(Allocator.NumFrees, 1U);
+  EXPECT_EQ(Allocator.Live.count(B), 0U);
+  EXPECT_EQ(Allocator.Live.count(A), 1U);
+}
+
+TEST(MemoryManagerTest, TrimCachedBlocksOnFailure) {
+  MockAllocatorTy Allocator;
+  MemoryManagerTy MM(Allocator, Threshold, TARGET_ALLOC_DEVICE, 1 << 20);
+
+  void *Large = MM.allocate(1 << 16, nullptr);
+  void *Small = MM.allocate(64, nullptr);
+  ASSERT_NE(Large, nullptr);
+  ASSERT_NE(Small, nullptr);
+  EXPECT_EQ(MM.free(Large), OFFLOAD_SUCCESS);
+  EXPECT_EQ(MM.free(Small), OFFLOAD_SUCCESS);
+  EXPECT_EQ(Allocator.NumFrees, 0U);
+
+  // When the device runs out of memory, the cached large block and the small
+  // free lists are released before the allocation is retried.
+  Allocator.FailNext = true;
+  EXPECT_NE(MM.allocate(1 << 18, nullptr), nullptr);
+  EXPECT_EQ(Allocator.NumFrees, 2U);
+  EXPECT_EQ(Allocator.Live.count(Large), 0U);
+  EXPECT_EQ(Allocator.Live.count(Small), 0U);
+}
+
+TEST(MemoryManagerTest, DestructorReleasesCachedBlocks) {
+  MockAllocatorTy Allocator;
+  {
+    MemoryManagerTy MM(Allocator, Threshold, TARGET_ALLOC_DEVICE, 1 << 20);
+    EXPECT_EQ(MM.free(MM.allocate(1 << 16, nullptr)), OFFLOAD_SUCCESS);
+    EXPECT_EQ(MM.free(MM.allocate(64, nullptr)), OFFLOAD_SUCCESS);
+    EXPECT_EQ(Allocator.Live.size(), 2U);
+  }
+  EXPECT_TRUE(Allocator.Live.empty());
+}
+
+} // namespace
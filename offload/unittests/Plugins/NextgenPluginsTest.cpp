@@ -63,6 +63,27 @@ TEST(NextgenPluginsTest, PluginAlloc) {
             __tgt_rtl_data_delete(DEVICE_ID, device_ptr, TARGET_ALLOC_DEFAULT));
 }
 
+// Test that small pinned host allocations are pooled
+TEST(NextgenPluginsTest, PluginHostAllocReuse) {
+  int64_t var_size = 64;
+
+  // Init plugin and device
+  EXPECT_EQ(OFFLOAD_SUCCESS, init_test_device(DEVICE_ID));
+
+  void *host_ptr =
+      __tgt_rtl_data_alloc(DEVICE_ID, var_size, nullptr, TARGET_ALLOC_HOST);
+  EXPECT_NE(host_ptr, nullptr);
+  EXPECT_EQ(OFFLOAD_SUCCESS,
+            __tgt_rtl_data_delete(DEVICE_ID, host_ptr, TARGET_ALLOC_HOST));
+
+  // The freed buffer is kept by the host memory manager and handed out again
+  void *reused_ptr =
+      __tgt_rtl_data_alloc(DEVICE_ID, var_size, nullptr, TARGET_ALLOC_HOST);
+  EXPECT_EQ(reused_ptr, host_ptr);
+  EXPECT_EQ(OFFLOAD_SUCCESS,
+            __tgt_rtl_data_delete(DEVICE_ID, reused_ptr, TARGET_ALLOC_HOST));
+}
+
 // Test async GPU allocation and R/W
 TEST(NextgenPluginsTest, PluginAsyncAlloc) {
   int32_t test_value = 47;
@@ -1379,6 +1379,22 @@ static void __kmp_stg_print_task_stealing(kmp_str_buf_t *buffer,
   __kmp_stg_print_int(buffer, name, __kmp_task_stealing_constraint);
 } // __kmp_stg_print_task_stealing
 
+// KMP_TASK_STEAL_LOCAL_TRIES: when a thread without a recent victim picks a
+// random thread to steal tasks from, the number of times it retries a pick
+// outside its own NUMA domain (or socket) before accepting it. Between 0 and
+// 64, default 4; 0 picks victims uniformly at random.
+static void __kmp_stg_parse_task_steal_local_tries(char const *name,
+                                                   char const *value,
+                                                   void *data) {
+  __kmp_stg_parse_int(name, value, 0, 64, &__kmp_task_steal_local_tries);
+} // __kmp_stg_parse_task_steal_local_tries
+
+static void __kmp_stg_print_task_steal_local_tries(kmp_str_buf_t *buffer,
+                                                   char const *name,
+                                                   void *data) {
+  __kmp_stg_print_int(buffer, name, __kmp_task_steal_local_tries);
+} // __kmp_stg_print_task_steal_local_tries
+
 static void __kmp_stg_parse_max_active_levels(char const *name,
                                               char const *value, void *data) {
   kmp_uint64 tmp_dflt = 0;
@@ -5547,6 +5563,8 @@ static kmp_setting_t __kmp_stg_table[] = {
      0},
     {"KMP_TASK_STEALING_CONSTRAINT", __kmp_stg_parse_task_stealing,
      __kmp_stg_print_task_stealing, NULL, 0, 0},
+    {"KMP_TASK_STEAL_LOCAL_TRIES", __kmp_stg_parse_task_steal_local_tries,
+     __kmp_stg_print_task_steal_local_tries, NULL, 0, 0},
     {"OMP_MAX_ACTIVE_LEVELS", __kmp_stg_parse_max_active_levels,
      __kmp_stg_print_max_active_levels, NULL, 0, 0},
     {"OMP_DEFAULT_DEVICE", __kmp_stg_parse_default_device,
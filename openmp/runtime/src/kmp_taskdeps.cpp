@@ -57,8 +57,11 @@ static inline kmp_depnode_t *__kmp_node_ref(kmp_depnode_t *node) {
 
 enum { KMP_DEPHASH_OTHER_SIZE = 97, KMP_DEPHASH_MASTER_SIZE = 997 };
 
-size_t sizes[] = {997, 2003, 4001, 8191, 16001, 32003, 64007, 131071, 270029};
-const size_t MAX_GEN = 8;
+// Tasks that create millions of dependent children on distinct addresses
+// need large tables, or the bucket chains grow without bound.
+size_t sizes[] = {997,    2003,   4001,   8191,    16001,   32003,   64007,
+                  131071, 270029, 524287, 1048573, 2097143, 4194301, 8388593};
+const size_t MAX_GEN = sizeof(sizes) / sizeof(sizes[0]);
 
 static inline size_t __kmp_dephash_hash(kmp_intptr_t addr, size_t hsize) {
   // TODO alternate to try: set = (((Addr64)(addrUsefulBits * 9.618)) %
@@ -164,10 +167,21 @@ static kmp_dephash_entry *__kmp_dephash_find(kmp_info_t *thread,
   }
   size_t bucket = __kmp_dephash_hash(addr, h->size);
 
-  kmp_dephash_entry_t *entry;
-  for (entry = h->buckets[bucket]; entry; entry = entry->next_in_bucket)
+  kmp_dephash_entry_t *entry, *prev = NULL;
+  for (entry = h->buckets[bucket]; entry; entry = entry->next_in_bucket) {
     if (entry->addr == addr)
       break;
+    prev = entry;
+  }
+
+  if (entry != NULL && prev != NULL) {
+    // Move the entry to the front of its bucket: dependent tasks tend to be
+    // created in chains on the same addresses, so it is likely to be looked
+    // up again soon.
+    prev->next_in_bucket = entry->next_in_bucket;
+    entry->next_in_bucket = h->buckets[bucket];
+    h->buckets[bucket] = entry;
+  }
 
   if (entry == NULL) {
 // create entry. This is only done by one thread so no locking required
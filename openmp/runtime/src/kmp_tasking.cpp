@@ -3225,6 +3225,23 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_is_local_steal_victim: check whether a thief and a victim are bound
+// within the same NUMA domain, or the same socket if NUMA domains are not
+// known. Threads whose locality is unknown are considered local to anybody.
+static inline bool __kmp_is_local_steal_victim(kmp_info_t *thief,
+                                               kmp_info_t *victim) {
+#if KMP_AFFINITY_SUPPORTED
+  static const kmp_hw_t types[] = {KMP_HW_NUMA, KMP_HW_SOCKET};
+  for (kmp_hw_t type : types) {
+    int thief_id = thief->th.th_topology_ids.ids[type];
+    int victim_id = victim->th.th_topology_ids.ids[type];
+    if (thief_id >= 0 && victim_id >= 0)
+      return thief_id == victim_id;
+  }
+#endif
+  return true;
+}
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -3425,6 +3442,7 @@ static inline int __kmp_execute_tasks_template(
           asleep = 0;
         } else if (!new_victim) { // no recent steals and we haven't already
           // used a new victim; select a random thread
+          int local_tries = __kmp_task_steal_local_tries;
           do { // Find a different thread to steal work from.
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
@@ -3435,6 +3453,15 @@ static inline int __kmp_execute_tasks_template(
             }
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
+            // Prefer victims in the thief's NUMA domain, since stealing across
+            // sockets moves the task's data too. A bounded number of retries
+            // biases the choice without starving remote victims.
+            if (local_tries > 0 &&
+                !__kmp_is_local_steal_victim(thread, other_thread)) {
+              --local_tries;
+              asleep = 1;
+              continue;
+            }
             // There is a slight chance that __kmp_enable_tasking() did not wake
             // up all threads waiting at the barrier.  If victim is sleeping,
             // then wake it up. Since we were going to pay the cache miss
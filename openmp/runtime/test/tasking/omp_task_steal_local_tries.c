@@ -0,0 +1,44 @@
+// RUN: %libomp-compile
+// RUN: env KMP_SETTINGS=1 KMP_TASK_STEAL_LOCAL_TRIES=2 %libomp-run 2>&1 \
+// RUN:   | FileCheck %s
+// RUN: env KMP_TASK_STEAL_LOCAL_TRIES=0 %libomp-run
+// RUN: env OMP_PROC_BIND=spread OMP_PLACES=cores %libomp-run
+// RUN: env OMP_PROC_BIND=close OMP_PLACES=threads \
+// RUN:   KMP_TASK_STEAL_LOCAL_TRIES=64 %libomp-run
+// CHECK: KMP_TASK_STEAL_LOCAL_TRIES=2
+
+/*
+ * Test that preferring NUMA-local victims when stealing tasks does not lose
+ * tasks: the tasks are all created by one thread, so every other thread gets
+ * its work by stealing.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "omp_testsuite.h"
+
+#define NUM_TASKS 10000
+
+int main() {
+  int executed = 0;
+#pragma omp parallel
+  {
+#pragma omp single
+    {
+      int i;
+      for (i = 0; i < NUM_TASKS; ++i) {
+#pragma omp task shared(executed)
+        {
+#pragma omp atomic
+          ++executed;
+        }
+      }
+    }
+  }
+  if (executed != NUM_TASKS) {
+    fprintf(stderr, "executed %d tasks, expected %d\n", executed, NUM_TASKS);
+    return EXIT_FAILURE;
+  }
+  printf("passed\n");
+  return EXIT_SUCCESS;
+}
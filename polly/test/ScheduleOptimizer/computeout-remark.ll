@@ -0,0 +1,49 @@
+; RUN: opt %loadNPMPolly -polly-process-unprofitable '-passes=polly-opt-isl' \
+; RUN:   -polly-schedule-computeout=1 -pass-remarks-analysis=polly-opt-isl \
+; RUN:   -disable-output < %s 2>&1 | FileCheck %s --check-prefix=REMARK
+; RUN: opt %loadNPMPolly -polly-process-unprofitable '-passes=polly-opt-isl' \
+; RUN:   -polly-schedule-computeout=100000 -pass-remarks-analysis=polly-opt-isl \
+; RUN:   -disable-output < %s 2>&1 | FileCheck %s --check-prefix=NO-REMARK --allow-empty
+; RUN: opt %loadNPMPolly -polly-process-unprofitable '-passes=polly-opt-isl' \
+; RUN:   -polly-schedule-computeout=1 -stats -disable-output < %s 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; With a quota of a single operation the isl scheduler gives up. The original
+; schedule is kept, and this is reported with a remark and a statistic. The
+; SCoP is not counted as rescheduled.
+
+; REMARK: remark: {{.*}}maximal number of operations exceeded during scheduling; keeping the original schedule (use -polly-schedule-computeout to raise the limit)
+
+; NO-REMARK-NOT: maximal number of operations exceeded
+
+; STATS:     1 polly-opt-isl - Number of scops for which the scheduler exceeded its quota
+; STATS-NOT: Number of scops rescheduled
+
+define void @f(ptr %A) {
+entry:
+  br label %for.i
+
+for.i:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %for.i.latch ]
+  br label %for.j
+
+for.j:
+  %j = phi i64 [ 0, %for.i ], [ %j.next, %for.j ]
+  %src = getelementptr inbounds [1024 x double], ptr %A, i64 %i, i64 %j
+  %val = load double, ptr %src, align 8
+  %add = fadd double %val, 1.0
+  %dst = getelementptr inbounds [1024 x double], ptr %A, i64 %j, i64 %i
+  store double %add, ptr %dst, align 8
+  %j.next = add nuw nsw i64 %j, 1
+  %j.done = icmp eq i64 %j.next, 1024
+  br i1 %j.done, label %for.i.latch, label %for.j
+
+for.i.latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %i.done = icmp eq i64 %i.next, 1024
+  br i1 %i.done, label %exit, label %for.i
+
+exit:
+  ret void
+}